@@ -0,0 +1,281 @@
+/*---------------------------------------------------------------------------*
+  Project:  TwlSDK - FX - demos - batch-1
+  File:     main.c
+
+  Copyright 2007-2008 Nintendo. All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law. They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Date::            $
+  $Rev:$
+  $Author:$
+ *---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*
+  Demo that compares the array versions of the matrix and vector functions
+  (MTX_MultVec43Array, MTX_Concat43Array, MTX_Concat44Array, VEC_NormalizeArray)
+  and the batched divider/sqrt functions (FX_DivArray, FX_SqrtArray, FX_DivSqrtArray)
+  with calling the single-element functions in a loop, and checks that the
+  results are bit-identical.
+  The number of ARM9 cycles saved per element is also displayed.
+ *---------------------------------------------------------------------------*/
+
+#include <nitro.h>
+
+#define VEC_NUM     2048
+#define MTX_NUM     256
+
+// Number of ARM9 cycles per OS tick
+#define CYCLES_PER_TICK ((HW_CPU_CLOCK_ARM9 / OS_SYSTEM_CLOCK) * 64)
+
+static VecFx32 gVecSrc[VEC_NUM];
+static VecFx32 gVecRef[VEC_NUM];
+static VecFx32 gVecOut[VEC_NUM];
+static MtxFx43 gMtx43A[MTX_NUM];
+static MtxFx43 gMtx43B[MTX_NUM];
+static MtxFx43 gMtx43Ref[MTX_NUM];
+static MtxFx43 gMtx43Out[MTX_NUM];
+static MtxFx44 gMtx44A[MTX_NUM];
+static MtxFx44 gMtx44B[MTX_NUM];
+static MtxFx44 gMtx44Ref[MTX_NUM];
+static MtxFx44 gMtx44Out[MTX_NUM];
+static fx32 gNumer[VEC_NUM];
+static fx32 gDenom[VEC_NUM];
+static fx32 gQuotRef[VEC_NUM];
+static fx32 gQuotOut[VEC_NUM];
+static fx32 gSqrtRef[VEC_NUM];
+static fx32 gSqrtOut[VEC_NUM];
+
+/*---------------------------------------------------------------------------*
+  Name:         FillRandom
+
+  Description:  Fills a buffer with random fx32 values.
+                Values stay within a range typical of coordinates so that
+                normalization does not overflow.
+
+  Arguments:    context: Random number context
+                buf:     Buffer to fill
+                size:    Size of buf in bytes
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void FillRandom(MATHRandContext32 *context, void *buf, u32 size)
+{
+    fx32   *p = (fx32 *)buf;
+    u32     i;
+    for (i = 0; i < size / sizeof(fx32); ++i)
+    {
+        p[i] = (fx32)MATH_Rand32(context, 0x100000) - 0x80000 + 1;
+    }
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         PrintResult
+
+  Description:  Prints one line of the benchmark result.
+
+  Arguments:    name:    Name of the measured function
+                num:     Number of elements processed
+                t1:      Time taken by the single-element loop
+                t2:      Time taken by the array version
+                ok:      Whether the results were identical
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void PrintResult(const char *name, int num, OSTick t1, OSTick t2, BOOL ok)
+{
+    OS_TPrintf("%-20s %5d  loop %6lld us  array %6lld us  saved %4d cycles/elem %s\n", name, num,
+               OS_TicksToMicroSeconds(t1), OS_TicksToMicroSeconds(t2),
+               (int)(((s64)t1 - (s64)t2) * CYCLES_PER_TICK / num), ok ? "" : "[**NG**]");
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         IsSameArray
+
+  Description:  Compares two fx32 arrays.
+
+  Arguments:    a:       Array to compare
+                b:       Array to compare
+                num:     Number of elements
+
+  Returns:      TRUE if the contents match.
+ *---------------------------------------------------------------------------*/
+static BOOL IsSameArray(const fx32 *a, const fx32 *b, int num)
+{
+    int     i;
+    for (i = 0; i < num; ++i)
+    {
+        if (a[i] != b[i])
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NitroMain
+
+  Description:  Runs the benchmark.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NitroMain(void)
+{
+    MATHRandContext32 context;
+    MtxFx43 m;
+    OSTick  begin, t1, t2;
+    BOOL    ok;
+    BOOL    result = TRUE;
+    int     i;
+
+    OS_Init();
+    OS_InitTick();
+    FX_Init();
+
+    MATH_InitRand32(&context, 0x12345678);
+    FillRandom(&context, gVecSrc, sizeof(gVecSrc));
+    FillRandom(&context, &m, sizeof(m));
+    FillRandom(&context, gMtx43A, sizeof(gMtx43A));
+    FillRandom(&context, gMtx43B, sizeof(gMtx43B));
+    FillRandom(&context, gMtx44A, sizeof(gMtx44A));
+    FillRandom(&context, gMtx44B, sizeof(gMtx44B));
+    FillRandom(&context, gNumer, sizeof(gNumer));
+    FillRandom(&context, gDenom, sizeof(gDenom));
+    for (i = 0; i < VEC_NUM; ++i)
+    {
+        if (gDenom[i] == 0)
+        {
+            gDenom[i] = FX32_ONE;
+        }
+    }
+
+    OS_TPrintf("\n------FX array functions---------\n\n");
+
+    /* MTX_MultVec43 */
+    begin = OS_GetTick();
+    for (i = 0; i < VEC_NUM; ++i)
+    {
+        MTX_MultVec43(&gVecSrc[i], &m, &gVecRef[i]);
+    }
+    t1 = OS_GetTick() - begin;
+    begin = OS_GetTick();
+    MTX_MultVec43Array(gVecSrc, &m, gVecOut, VEC_NUM);
+    t2 = OS_GetTick() - begin;
+    ok = TRUE;
+    for (i = 0; i < VEC_NUM; ++i)
+    {
+        ok = ok && (gVecRef[i].x == gVecOut[i].x) && (gVecRef[i].y == gVecOut[i].y) &&
+            (gVecRef[i].z == gVecOut[i].z);
+    }
+    PrintResult("MTX_MultVec43Array", VEC_NUM, t1, t2, ok);
+    result = result && ok;
+
+    /* MTX_Concat43 */
+    begin = OS_GetTick();
+    for (i = 0; i < MTX_NUM; ++i)
+    {
+        MTX_Concat43(&gMtx43A[i], &gMtx43B[i], &gMtx43Ref[i]);
+    }
+    t1 = OS_GetTick() - begin;
+    begin = OS_GetTick();
+    MTX_Concat43Array(gMtx43A, gMtx43B, gMtx43Out, MTX_NUM);
+    t2 = OS_GetTick() - begin;
+    ok = TRUE;
+    for (i = 0; i < MTX_NUM * 12; ++i)
+    {
+        ok = ok && (gMtx43Ref[i / 12].a[i % 12] == gMtx43Out[i / 12].a[i % 12]);
+    }
+    PrintResult("MTX_Concat43Array", MTX_NUM, t1, t2, ok);
+    result = result && ok;
+
+    /* MTX_Concat44 */
+    begin = OS_GetTick();
+    for (i = 0; i < MTX_NUM; ++i)
+    {
+        MTX_Concat44(&gMtx44A[i], &gMtx44B[i], &gMtx44Ref[i]);
+    }
+    t1 = OS_GetTick() - begin;
+    begin = OS_GetTick();
+    MTX_Concat44Array(gMtx44A, gMtx44B, gMtx44Out, MTX_NUM);
+    t2 = OS_GetTick() - begin;
+    ok = TRUE;
+    for (i = 0; i < MTX_NUM * 16; ++i)
+    {
+        ok = ok && (gMtx44Ref[i / 16].a[i % 16] == gMtx44Out[i / 16].a[i % 16]);
+    }
+    PrintResult("MTX_Concat44Array", MTX_NUM, t1, t2, ok);
+    result = result && ok;
+
+    /* VEC_Normalize */
+    begin = OS_GetTick();
+    for (i = 0; i < VEC_NUM; ++i)
+    {
+        VEC_Normalize(&gVecSrc[i], &gVecRef[i]);
+    }
+    t1 = OS_GetTick() - begin;
+    begin = OS_GetTick();
+    VEC_NormalizeArray(gVecSrc, gVecOut, VEC_NUM);
+    t2 = OS_GetTick() - begin;
+    ok = TRUE;
+    for (i = 0; i < VEC_NUM; ++i)
+    {
+        ok = ok && (gVecRef[i].x == gVecOut[i].x) && (gVecRef[i].y == gVecOut[i].y) &&
+            (gVecRef[i].z == gVecOut[i].z);
+    }
+    PrintResult("VEC_NormalizeArray", VEC_NUM, t1, t2, ok);
+    result = result && ok;
+
+    /* FX_Div */
+    begin = OS_GetTick();
+    for (i = 0; i < VEC_NUM; ++i)
+    {
+        gQuotRef[i] = FX_Div(gNumer[i], gDenom[i]);
+    }
+    t1 = OS_GetTick() - begin;
+    begin = OS_GetTick();
+    FX_DivArray(gNumer, gDenom, gQuotOut, VEC_NUM);
+    t2 = OS_GetTick() - begin;
+    ok = IsSameArray(gQuotRef, gQuotOut, VEC_NUM);
+    PrintResult("FX_DivArray", VEC_NUM, t1, t2, ok);
+    result = result && ok;
+
+    /* FX_Sqrt (negative inputs included) */
+    begin = OS_GetTick();
+    for (i = 0; i < VEC_NUM; ++i)
+    {
+        gSqrtRef[i] = FX_Sqrt(gNumer[i]);
+    }
+    t1 = OS_GetTick() - begin;
+    begin = OS_GetTick();
+    FX_SqrtArray(gNumer, gSqrtOut, VEC_NUM);
+    t2 = OS_GetTick() - begin;
+    ok = IsSameArray(gSqrtRef, gSqrtOut, VEC_NUM);
+    PrintResult("FX_SqrtArray", VEC_NUM, t1, t2, ok);
+    result = result && ok;
+
+    /* FX_Div and FX_Sqrt together: the two units work in parallel */
+    begin = OS_GetTick();
+    for (i = 0; i < VEC_NUM; ++i)
+    {
+        gQuotRef[i] = FX_Div(gNumer[i], gDenom[i]);
+        gSqrtRef[i] = FX_Sqrt(gDenom[i]);
+    }
+    t1 = OS_GetTick() - begin;
+    begin = OS_GetTick();
+    FX_DivSqrtArray(gNumer, gDenom, gQuotOut, VEC_NUM, gDenom, gSqrtOut, VEC_NUM);
+    t2 = OS_GetTick() - begin;
+    ok = IsSameArray(gQuotRef, gQuotOut, VEC_NUM) && IsSameArray(gSqrtRef, gSqrtOut, VEC_NUM);
+    PrintResult("FX_DivSqrtArray", VEC_NUM, t1, t2, ok);
+    result = result && ok;
+
+    OS_TPrintf("\n" "++++++++++++++++++++++++++++++++++++++++\n" "Test %s\n",
+               result ? "Finish" : "Failed");
+
+    OS_Terminate();
+}
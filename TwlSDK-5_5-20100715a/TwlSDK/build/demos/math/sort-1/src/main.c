@@ -0,0 +1,409 @@
+/*---------------------------------------------------------------------------*
+  Project:  TwlSDK - demos - math - sort-1
+  File:     main.c
+
+  Copyright 2007-2008 Nintendo. All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law. They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Date::            $
+  $Rev:$
+  $Author:$
+ *---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*
+  Demo that compares the processing time of MATH_QSort with the
+  type-specialized sorts (MATH_IntroSort, MATH_RadixSort16/32, MATH_PartialSort)
+  Each result is also checked: keys in order, every (key, value) pair kept,
+  equal keys in input order for the radix sorts, and the k smallest keys
+  first for MATH_PartialSort.
+ *---------------------------------------------------------------------------*/
+
+#include    <nitro.h>
+
+static void VBlankIntr(void);
+static void DisplayInit(void);
+static void FillScreen(u16 col);
+static BOOL SortTest(void);
+
+/*---------------------------------------------------------------------------*
+    Constant Definitions
+ *---------------------------------------------------------------------------*/
+#define DATA_NUM_MAX    4096
+#define PARTIAL_NUM     32
+
+typedef enum
+{
+    INPUT_RANDOM,                      // Random 32-bit keys
+    INPUT_DEPTH,                       // Random keys in a 16-bit range (typical depth values)
+    INPUT_SORTED,                      // Already sorted
+    INPUT_REVERSED,                    // Sorted in reverse order
+    INPUT_FEW_UNIQUE,                  // Only a few distinct keys
+    INPUT_MAX
+}
+InputType;
+
+static const char *sInputName[INPUT_MAX] = {
+    "random", "depth16", "sorted", "reversed", "few-uniq"
+};
+
+static const u32 sDataNum[] = { 64, 256, 1024, 4096 };
+
+/*---------------------------------------------------------------------------*
+    Variable Definitions
+ *---------------------------------------------------------------------------*/
+static MATHSortItem gSource[DATA_NUM_MAX];
+static MATHSortItem gData[DATA_NUM_MAX];
+static u32 gWorkBuf[(DATA_NUM_MAX * sizeof(MATHSortItem) +
+                     MATH_RADIX_SORT_BUCKET_NUM * sizeof(u32)) / sizeof(u32)];
+static u32 gQSortBuf[(32 + 1) * 2];
+static u32 gFound[DATA_NUM_MAX / 32];
+
+/*---------------------------------------------------------------------------*
+    Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*
+  Name:         NitroMain
+
+  Description:  Initialization and main loop.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NitroMain(void)
+{
+    // Various types of initialization
+    OS_Init();
+    OS_InitTick();
+
+    DisplayInit();
+
+    if (SortTest())
+    {
+        // Success
+        OS_TPrintf("------ Test Succeeded ------\n");
+        FillScreen(GX_RGB(0, 31, 0));
+    }
+    else
+    {
+        // Failed
+        OS_TPrintf("****** Test Failed ******\n");
+        FillScreen(GX_RGB(31, 0, 0));
+    }
+
+    // Main loop
+    while (TRUE)
+    {
+        // Waiting for the V-Blank
+        OS_WaitVBlankIntr();
+    }
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         VBlankIntr
+
+  Description:  V-Blank interrupt vector.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void VBlankIntr(void)
+{
+    // sets the IRQ check flag
+    OS_SetIrqCheckFlag(OS_IE_V_BLANK);
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         DisplayInit
+
+  Description:  Graphics Initialization
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void DisplayInit(void)
+{
+
+    GX_Init();
+    FX_Init();
+
+    GX_DispOff();
+    GXS_DispOff();
+
+    GX_SetDispSelect(GX_DISP_SELECT_SUB_MAIN);
+
+    OS_SetIrqFunction(OS_IE_V_BLANK, VBlankIntr);
+    (void)OS_EnableIrqMask(OS_IE_V_BLANK);
+    (void)GX_VBlankIntr(TRUE);         // To generate V-Blank interrupt request
+    (void)OS_EnableIrq();
+
+
+    GX_SetBankForLCDC(GX_VRAM_LCDC_ALL);
+    MI_CpuClearFast((void *)HW_LCDC_VRAM, HW_LCDC_VRAM_SIZE);
+
+    MI_CpuFillFast((void *)HW_OAM, 192, HW_OAM_SIZE);   // Clear OAM
+    MI_CpuClearFast((void *)HW_PLTT, HW_PLTT_SIZE);     // Clear the standard palette
+
+    MI_CpuFillFast((void *)HW_DB_OAM, 192, HW_DB_OAM_SIZE);     // Clear OAM
+    MI_CpuClearFast((void *)HW_DB_PLTT, HW_DB_PLTT_SIZE);       // Clear the standard palette
+    MI_DmaFill32(3, (void *)HW_LCDC_VRAM_C, 0x7FFF7FFF, 256 * 192 * sizeof(u16));
+
+
+    GX_SetBankForOBJ(GX_VRAM_OBJ_256_AB);       // Set VRAM-A,B for OBJ
+
+    GX_SetGraphicsMode(GX_DISPMODE_VRAM_C,      // VRAM mode
+                       (GXBGMode)0,    // Dummy
+                       (GXBG0As)0);    // Dummy
+
+    GX_SetVisiblePlane(GX_PLANEMASK_OBJ);       // Make OBJs visible
+    GX_SetOBJVRamModeBmp(GX_OBJVRAMMODE_BMP_1D_128K);   // 2D mapping OBJ
+
+    OS_WaitVBlankIntr();               // Waiting for the end of the V-Blank interrupt
+    GX_DispOn();
+
+}
+
+
+/*---------------------------------------------------------------------------*
+  Name:         FillScreen
+
+  Description:  Fills the screen
+
+  Arguments:    col: FillColor
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void FillScreen(u16 col)
+{
+    MI_CpuFill16((void *)HW_LCDC_VRAM_C, col, 256 * 192 * 2);
+}
+
+/* Comparison function for MATH_QSort */
+static s32 CompareItem(void *elem1, void *elem2)
+{
+    u32     a = ((MATHSortItem *)elem1)->key;
+    u32     b = ((MATHSortItem *)elem2)->key;
+    return (a > b) ? +1 : ((a < b) ? -1 : 0);
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         MakeInput
+
+  Description:  Creates the input data for the benchmark.
+
+  Arguments:    type:     Type of input data
+                num:      Number of data items
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void MakeInput(InputType type, u32 num)
+{
+    MATHRandContext32 context;
+    u32     i;
+
+    MATH_InitRand32(&context, 0x12345678);
+    for (i = 0; i < num; i++)
+    {
+        u32     key;
+        switch (type)
+        {
+        case INPUT_RANDOM:
+            key = MATH_Rand32(&context, 0);
+            break;
+        case INPUT_DEPTH:
+            key = MATH_Rand32(&context, 0x10000);
+            break;
+        case INPUT_SORTED:
+            key = i;
+            break;
+        case INPUT_REVERSED:
+            key = num - i;
+            break;
+        default:
+            key = MATH_Rand32(&context, 4);
+            break;
+        }
+        gSource[i].key = key;
+        gSource[i].value = i;
+    }
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         IsPermutation
+
+  Description:  Checks that gData holds every item of gSource once, each key
+                still paired with its value.
+                The value of each item of gSource is its index.
+
+  Arguments:    num:      Number of data items
+
+  Returns:      TRUE if no item was lost, duplicated or changed.
+ *---------------------------------------------------------------------------*/
+static BOOL IsPermutation(u32 num)
+{
+    u32     i;
+
+    MI_CpuClear32(gFound, sizeof(gFound));
+    for (i = 0; i < num; i++)
+    {
+        u32     value = gData[i].value;
+
+        if (value >= num || (gFound[value / 32] & (1U << (value % 32))) != 0)
+        {
+            return FALSE;
+        }
+        if (gData[i].key != gSource[value].key)
+        {
+            return FALSE;
+        }
+        gFound[value / 32] |= 1U << (value % 32);
+    }
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         IsSorted
+
+  Description:  Checks that the first num items of gData are in ascending order.
+
+  Arguments:    num:      Number of data items to check
+                stable:   If TRUE, also checks that items with the same key
+                          keep the order of gSource (ascending values).
+
+  Returns:      TRUE if sorted.
+ *---------------------------------------------------------------------------*/
+static BOOL IsSorted(u32 num, BOOL stable)
+{
+    u32     i;
+
+    for (i = 1; i < num; i++)
+    {
+        if (gData[i - 1].key > gData[i].key)
+        {
+            return FALSE;
+        }
+        if (stable && gData[i - 1].key == gData[i].key && gData[i - 1].value > gData[i].value)
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         IsPartialSorted
+
+  Description:  Checks the result of MATH_PartialSort: the first k items of gData
+                are in ascending order, and no remaining item has a smaller key
+                than the k-th item.
+
+  Arguments:    num:      Number of data items
+                k:        Number of items obtained
+
+  Returns:      TRUE if the first k items are the k smallest, in order.
+ *---------------------------------------------------------------------------*/
+static BOOL IsPartialSorted(u32 num, u32 k)
+{
+    u32     i;
+
+    k = MATH_MIN(num, k);
+    if (!IsSorted(k, FALSE))
+    {
+        return FALSE;
+    }
+    for (i = k; i < num; i++)
+    {
+        if (gData[i].key < gData[k - 1].key)
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         SortTest
+
+  Description:  Measures and verifies each sort for every input type and size.
+
+  Arguments:    None.
+
+  Returns:      TRUE if test succeeds.
+ *---------------------------------------------------------------------------*/
+static BOOL SortTest(void)
+{
+    BOOL    flag = TRUE;
+    int     type;
+    u32     n;
+
+    OS_TPrintf("%-9s %5s %9s %9s %9s %9s %9s (us)\n",
+               "input", "num", "QSort", "Intro", "Radix16", "Radix32", "Partial");
+
+    for (type = 0; type < INPUT_MAX; type++)
+    {
+        for (n = 0; n < sizeof(sDataNum) / sizeof(sDataNum[0]); n++)
+        {
+            u32     num = sDataNum[n];
+            OSTick  t[5];
+            OSTick  begin;
+            BOOL    ok = TRUE;
+
+            MakeInput((InputType)type, num);
+
+            MI_CpuCopy32(gSource, gData, num * sizeof(MATHSortItem));
+            begin = OS_GetTick();
+            MATH_QSort(gData, num, sizeof(MATHSortItem), CompareItem, gQSortBuf);
+            t[0] = OS_GetTick() - begin;
+            ok = ok && IsSorted(num, FALSE) && IsPermutation(num);
+
+            MI_CpuCopy32(gSource, gData, num * sizeof(MATHSortItem));
+            begin = OS_GetTick();
+            MATH_IntroSort(gData, num);
+            t[1] = OS_GetTick() - begin;
+            ok = ok && IsSorted(num, FALSE) && IsPermutation(num);
+
+            // MATH_RadixSort16 is only meaningful for keys that fit in 16 bits
+            t[2] = 0;
+            if (type != INPUT_RANDOM)
+            {
+                MI_CpuCopy32(gSource, gData, num * sizeof(MATHSortItem));
+                begin = OS_GetTick();
+                MATH_RadixSort16(gData, num, gWorkBuf);
+                t[2] = OS_GetTick() - begin;
+                ok = ok && IsSorted(num, TRUE) && IsPermutation(num);
+            }
+
+            MI_CpuCopy32(gSource, gData, num * sizeof(MATHSortItem));
+            begin = OS_GetTick();
+            MATH_RadixSort32(gData, num, gWorkBuf);
+            t[3] = OS_GetTick() - begin;
+            ok = ok && IsSorted(num, TRUE) && IsPermutation(num);
+
+            MI_CpuCopy32(gSource, gData, num * sizeof(MATHSortItem));
+            begin = OS_GetTick();
+            MATH_PartialSort(gData, num, PARTIAL_NUM);
+            t[4] = OS_GetTick() - begin;
+            ok = ok && IsPartialSorted(num, PARTIAL_NUM) && IsPermutation(num);
+
+            OS_TPrintf("%-9s %5d %9lld %9lld %9lld %9lld %9lld %s\n",
+                       sInputName[type], num,
+                       OS_TicksToMicroSeconds(t[0]), OS_TicksToMicroSeconds(t[1]),
+                       OS_TicksToMicroSeconds(t[2]), OS_TicksToMicroSeconds(t[3]),
+                       OS_TicksToMicroSeconds(t[4]), ok ? "" : "[**NG**]");
+            flag = flag && ok;
+        }
+    }
+
+    return flag;
+}
+
+/*---------------------------------------------------------------------------*
+  End of file
+ *---------------------------------------------------------------------------*/
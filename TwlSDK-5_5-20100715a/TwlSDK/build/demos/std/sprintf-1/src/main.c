@@ -0,0 +1,117 @@
+/*---------------------------------------------------------------------------*
+  Project:  TwlSDK - STD - demos - sprintf-1
+  File:     main.c
+
+  Copyright 2007-2008 Nintendo. All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law. They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Date::            $
+  $Rev:$
+  $Author:$
+ *---------------------------------------------------------------------------*/
+
+#include <nitro.h>
+
+#define LOOP_COUNT  1000
+
+/* Formats typical of a debug display (each takes four int arguments) */
+static const char *sFormats[] = {
+    "FPS %2d  CPU %3d%%  OBJ %4d/%4d",
+    "pos (%6d, %6d, %6d) rot %04x",
+    "HP %5u/%5u MP %3u  LV %-3d",
+    "frame=%u tick=%08x addr=%p %X",
+};
+
+/*---------------------------------------------------------------------------*
+  Name:         FormatWithString
+
+  Description:  Formats the sample arguments with STD_TVSNPrintf.
+
+  Arguments:    dst: The buffer that will store the result
+                len: Buffer length
+                fmt: Format control string
+
+  Returns:      Identical to STD_TVSNPrintf.
+ *---------------------------------------------------------------------------*/
+static int FormatWithString(char *dst, size_t len, const char *fmt, ...)
+{
+    int     ret;
+    va_list vlist;
+    va_start(vlist, fmt);
+    ret = STD_TVSNPrintf(dst, len, fmt, vlist);
+    va_end(vlist);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NitroMain
+
+  Description:  Measures STD_TVSNPrintf and STD_TVSNPrintfCompiled and checks that
+                both produce the same output.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NitroMain(void)
+{
+    int     i;
+    BOOL    result = TRUE;
+
+    OS_Init();
+    OS_InitTick();
+    OS_InitThread();
+
+    (void)OS_EnableIrqMask(OS_IE_V_BLANK);
+    (void)OS_EnableIrq();
+
+    OS_TPrintf("\n------STD_TVSNPrintf / STD_TVSNPrintfCompiled---------\n\n");
+
+    for (i = 0; i < sizeof(sFormats) / sizeof(*sFormats); i++)
+    {
+        STDFormatSpec spec[8];
+        STDCompiledFormat compiled;
+        char    buf1[64];
+        char    buf2[64];
+        OSTick  begin, t1, t2;
+        int     n;
+        int     len1 = 0, len2 = 0;
+
+        (void)STD_CompileFormat(&compiled, sFormats[i], spec, sizeof(spec) / sizeof(*spec));
+
+        begin = OS_GetTick();
+        for (n = 0; n < LOOP_COUNT; n++)
+        {
+            len1 = FormatWithString(buf1, sizeof(buf1), sFormats[i],
+                                    60 - n % 3, 12345 + n, -128, n * 7);
+        }
+        t1 = OS_GetTick() - begin;
+
+        begin = OS_GetTick();
+        for (n = 0; n < LOOP_COUNT; n++)
+        {
+            len2 = STD_TSNPrintfCompiled(buf2, sizeof(buf2), &compiled,
+                                         60 - n % 3, 12345 + n, -128, n * 7);
+        }
+        t2 = OS_GetTick() - begin;
+
+        if ((len1 != len2) || (STD_CompareString(buf1, buf2) != 0))
+        {
+            OS_TPrintf("[**NG**] ");
+            result = FALSE;
+        }
+        OS_TPrintf("\"%s\"\n  string %lld us, compiled %lld us (%d times)\n", buf1,
+                   OS_TicksToMicroSeconds(t1), OS_TicksToMicroSeconds(t2), LOOP_COUNT);
+    }
+
+    OS_TPrintf("\n" "++++++++++++++++++++++++++++++++++++++++\n" "Test %s\n",
+               result ? "Finish" : "Failed");
+
+    OS_Terminate();
+
+}
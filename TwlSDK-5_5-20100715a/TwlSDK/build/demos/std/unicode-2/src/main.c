@@ -0,0 +1,229 @@
+/*---------------------------------------------------------------------------*
+  Project:  TwlSDK - STD - demos - unicode-2
+  File:     main.c
+
+  Copyright 2007-2008 Nintendo. All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law. They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Date::            $
+  $Rev:$
+  $Author:$
+ *---------------------------------------------------------------------------*/
+
+#include <nitro.h>
+
+#define TEXT_SIZE       (32 * 1024)    // Size of the ShiftJIS test text in bytes
+#define CHUNK_SIZE      256            // Size of each piece passed to STD_ConvertStream
+
+/* Lines typical of a text dump: mostly ASCII, with some kanji and half-width kana */
+static const char *sLines[] = {
+    "[SAVE] slot=0 size=0x4000 crc=0x1234ABCD result=OK\n",
+    "\x83\x5A\x81\x5B\x83\x75\x83\x66\x81\x5B\x83\x5E\x82\xF0\x8F\x91\x82\xAB\x8D\x9E\x82\xDD\x82\xDC\x82\xB5\x82\xBD\n",
+    "player_name=\xB6\xDE\xD9\xCC\xDE level=12 gold=3400\n",
+    "\x8E\xA9\x95\xAA\x82\xCC\x83\x8C\x83\x52\x81\x5B\x83\x68: 00:12:34.56\n",
+};
+
+static char gSjis[TEXT_SIZE];
+static char gSjisOut[TEXT_SIZE];
+static u16 gUnicode[TEXT_SIZE];
+static u16 gUnicodeOut[TEXT_SIZE];
+static u8 gUtf8[TEXT_SIZE * 3];
+
+/*---------------------------------------------------------------------------*
+  Name:         MakeText
+
+  Description:  Fills gSjis with the sample lines.
+
+  Arguments:    None.
+
+  Returns:      Length of the text in bytes.
+ *---------------------------------------------------------------------------*/
+static int MakeText(void)
+{
+    int     len = 0;
+    int     i = 0;
+    for (;;)
+    {
+        const char *line = sLines[i++ % (sizeof(sLines) / sizeof(*sLines))];
+        int     n = STD_GetStringLength(line);
+        if (len + n > TEXT_SIZE)
+        {
+            break;
+        }
+        MI_CpuCopy8(line, &gSjis[len], (u32)n);
+        len += n;
+    }
+    return len;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         IsSameBytes
+
+  Description:  Compares two buffers.
+
+  Arguments:    a:            Buffer to compare
+                b:            Buffer to compare
+                len:          Number of bytes to compare
+
+  Returns:      TRUE if the contents match.
+ *---------------------------------------------------------------------------*/
+static BOOL IsSameBytes(const void *a, const void *b, int len)
+{
+    int     i;
+    for (i = 0; i < len; ++i)
+    {
+        if (((const u8 *)a)[i] != ((const u8 *)b)[i])
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         ConvertByStream
+
+  Description:  Converts the whole of src with STD_ConvertStream, CHUNK_SIZE bytes at a time.
+
+  Arguments:    src_encoding: Conversion source encoding
+                dst_encoding: Conversion destination encoding
+                dst:          Conversion destination buffer
+                dst_size:     Size of dst in bytes
+                src:          Conversion source buffer
+                src_size:     Size of src in bytes
+
+  Returns:      Number of bytes stored, or -1 on failure.
+ *---------------------------------------------------------------------------*/
+static int ConvertByStream(STDEncoding src_encoding, STDEncoding dst_encoding,
+                           void *dst, int dst_size, const void *src, int src_size)
+{
+    STDConvertContext context;
+    int     src_pos = 0;
+    int     dst_pos = 0;
+    int     dst_len;
+
+    STD_InitConvertContext(&context, src_encoding, dst_encoding);
+    while (src_pos < src_size)
+    {
+        int     src_len = MATH_MIN(CHUNK_SIZE, src_size - src_pos);
+        dst_len = dst_size - dst_pos;
+        if ((STD_ConvertStream(&context, (u8 *)dst + dst_pos, &dst_len,
+                               (const u8 *)src + src_pos, &src_len) != STD_RESULT_SUCCESS) ||
+            (src_len == 0))
+        {
+            return -1;
+        }
+        src_pos += src_len;
+        dst_pos += dst_len;
+    }
+    dst_len = dst_size - dst_pos;
+    if (STD_FlushConvertStream(&context, (u8 *)dst + dst_pos, &dst_len) != STD_RESULT_SUCCESS)
+    {
+        return -1;
+    }
+    return dst_pos + dst_len;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NitroMain
+
+  Description:  Measures STD_ConvertStream against STD_ConvertStringSjisToUnicode and
+                STD_ConvertStringUnicodeToSjis and checks that the results match.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NitroMain(void)
+{
+    BOOL    result = TRUE;
+    int     sjis_len;
+    int     unicode_len;
+    int     stream_len;
+    int     utf8_len;
+    int     src_len;
+    OSTick  begin, t1, t2;
+
+    OS_Init();
+    OS_InitTick();
+    OS_InitThread();
+
+    (void)OS_EnableIrqMask(OS_IE_V_BLANK);
+    (void)OS_EnableIrq();
+
+    sjis_len = MakeText();
+
+    OS_TPrintf("\n------STD_ConvertStream (%d bytes of ShiftJIS text)---------\n\n", sjis_len);
+
+    /* ShiftJIS -> UTF-16 */
+    src_len = sjis_len;
+    unicode_len = TEXT_SIZE;
+    begin = OS_GetTick();
+    (void)STD_ConvertStringSjisToUnicode(gUnicode, &unicode_len, gSjis, &src_len, NULL);
+    t1 = OS_GetTick() - begin;
+
+    begin = OS_GetTick();
+    stream_len = ConvertByStream(STD_ENCODING_SJIS, STD_ENCODING_UTF16,
+                                 gUnicodeOut, sizeof(gUnicodeOut), gSjis, sjis_len);
+    t2 = OS_GetTick() - begin;
+
+    if ((stream_len != unicode_len * (int)sizeof(u16)) ||
+        !IsSameBytes(gUnicode, gUnicodeOut, stream_len))
+    {
+        OS_TPrintf("[**NG**] ");
+        result = FALSE;
+    }
+    OS_TPrintf("SJIS  -> UTF-16: string %lld us, stream %lld us\n",
+               OS_TicksToMicroSeconds(t1), OS_TicksToMicroSeconds(t2));
+
+    /* UTF-16 -> ShiftJIS */
+    src_len = unicode_len;
+    sjis_len = TEXT_SIZE;
+    begin = OS_GetTick();
+    (void)STD_ConvertStringUnicodeToSjis(gSjisOut, &sjis_len, gUnicode, &src_len, NULL);
+    t1 = OS_GetTick() - begin;
+
+    begin = OS_GetTick();
+    stream_len = ConvertByStream(STD_ENCODING_UTF16, STD_ENCODING_SJIS,
+                                 gSjisOut, sizeof(gSjisOut), gUnicode, unicode_len * (int)sizeof(u16));
+    t2 = OS_GetTick() - begin;
+
+    if ((stream_len != sjis_len) || !IsSameBytes(gSjis, gSjisOut, sjis_len))
+    {
+        OS_TPrintf("[**NG**] ");
+        result = FALSE;
+    }
+    OS_TPrintf("UTF-16 -> SJIS : string %lld us, stream %lld us\n",
+               OS_TicksToMicroSeconds(t1), OS_TicksToMicroSeconds(t2));
+
+    /* ShiftJIS -> UTF-8 -> UTF-16 */
+    begin = OS_GetTick();
+    utf8_len = ConvertByStream(STD_ENCODING_SJIS, STD_ENCODING_UTF8,
+                               gUtf8, sizeof(gUtf8), gSjis, sjis_len);
+    t1 = OS_GetTick() - begin;
+
+    begin = OS_GetTick();
+    stream_len = ConvertByStream(STD_ENCODING_UTF8, STD_ENCODING_UTF16,
+                                 gUnicodeOut, sizeof(gUnicodeOut), gUtf8, utf8_len);
+    t2 = OS_GetTick() - begin;
+
+    if ((utf8_len < 0) || (stream_len != unicode_len * (int)sizeof(u16)) ||
+        !IsSameBytes(gUnicode, gUnicodeOut, stream_len))
+    {
+        OS_TPrintf("[**NG**] ");
+        result = FALSE;
+    }
+    OS_TPrintf("SJIS  -> UTF-8 : stream %lld us (%d bytes)\n", OS_TicksToMicroSeconds(t1), utf8_len);
+    OS_TPrintf("UTF-8 -> UTF-16: stream %lld us\n", OS_TicksToMicroSeconds(t2));
+
+    OS_TPrintf("\n" "++++++++++++++++++++++++++++++++++++++++\n" "Test %s\n",
+               result ? "Finish" : "Failed");
+
+    OS_Terminate();
+
+}
@@ -334,3 +334,70 @@ s32 FX_ModS32(s32 a, s32 b)
     CP_SetDiv32_32((u32)a, (u32)b);
     return CP_GetDivRemainder32();
 }
+
+
+/*---------------------------------------------------------------------------*
+  Name:         FX_DivSqrtArray
+
+  Description:  Performs arrays of divisions and square roots using the divider
+                and the sqrt unit at the same time.
+                The next request is set as soon as each result is read, so the
+                conversion of the previous result and the other unit's work
+                overlap with the calculation.
+                The results are identical to FX_Div and FX_Sqrt.
+
+  Arguments:    numer        an array of numerators in fx32 format
+                denom        an array of denominators in fx32 format
+                quot         an array that receives the quotients in fx32 format
+                             OK if quot == numer or quot == denom.
+                divNum       number of divisions
+                src          an array of values in fx32 format
+                sqrtDst      an array that receives the square roots in fx32 format
+                             OK if sqrtDst == src.
+                sqrtNum      number of square roots
+
+  Returns:      none
+ *---------------------------------------------------------------------------*/
+void FX_DivSqrtArray(const fx32 *numer, const fx32 *denom, fx32 *quot, u32 divNum,
+                     const fx32 *src, fx32 *sqrtDst, u32 sqrtNum)
+{
+    u32     i = 0;
+    u32     j = 0;
+
+    SDK_ASSERT(divNum == 0 || (numer != NULL && denom != NULL && quot != NULL));
+    SDK_ASSERT(sqrtNum == 0 || (src != NULL && sqrtDst != NULL));
+
+    // Start the first request on each unit
+    if (divNum > 0)
+    {
+        FX_DivAsync(numer[0], denom[0]);
+    }
+    if (sqrtNum > 0)
+    {
+        FX_SqrtAsync(src[0]);
+    }
+
+    while (i < divNum || j < sqrtNum)
+    {
+        if (i < divNum)
+        {
+            s64     r = CP_GetDivResult64();
+            if (++i < divNum)
+            {
+                FX_DIVISION_BY_ZERO(numer[i], denom[i]);
+                CP_SetDivImm64_32((u64)numer[i] << 32, (u32)denom[i]);
+            }
+            quot[i - 1] = (fx32)((r + FX_DIV_1_2) >> FX_DIV_SHIFT);
+        }
+        if (j < sqrtNum)
+        {
+            u32     r = CP_GetSqrtResult32();
+            if (++j < sqrtNum)
+            {
+                fx32    x = src[j];
+                CP_SetSqrtImm64((x > 0) ? (u64)x << 32 : 0);
+            }
+            sqrtDst[j - 1] = (fx32)((r + FX_SQRT_1_2) >> FX_SQRT_SHIFT);
+        }
+    }
+}
@@ -461,6 +461,159 @@ void MTX_MultVec43(const VecFx32 *vec, const MtxFx43 *m, VecFx32 *dst)
 }
 
 
+/*---------------------------------------------------------------------------*
+  Name:         MTX_MultVec43Array_
+
+  Description:  Multiplies an array of vectors by a 4x3 matrix.
+                The result of each element is identical to MTX_MultVec43.
+                64-bit products are accumulated with SMULL/SMLAL, and the
+                three columns are computed in parallel in registers.
+
+  Arguments:    vec          a pointer to the source vectors
+                m            a pointer to a 4x3 matrix
+                dst          a pointer to the result vectors
+                             OK if dst == vec.
+                num          number of vectors
+
+  Returns:      none
+ *---------------------------------------------------------------------------*/
+asm void MTX_MultVec43Array_(register const VecFx32 *vec, register const MtxFx43 *m,
+                             register VecFx32 *dst, register u32 num)
+{
+    cmp   r3, #0
+    bxeq  lr
+    stmfd sp!, {r4-r11, lr}
+
+@00:
+    // x * row 0
+    ldr   r4, [r0, #0]
+    ldr   r5, [r1, #0]
+    ldr   r6, [r1, #4]
+    smull r7, r8, r4, r5
+    ldr   r5, [r1, #8]
+    smull r9, r10, r4, r6
+    smull r11, lr, r4, r5
+    // y * row 1
+    ldr   r4, [r0, #4]
+    ldr   r5, [r1, #12]
+    ldr   r6, [r1, #16]
+    smlal r7, r8, r4, r5
+    ldr   r5, [r1, #20]
+    smlal r9, r10, r4, r6
+    smlal r11, lr, r4, r5
+    // z * row 2
+    ldr   r4, [r0, #8]
+    ldr   r5, [r1, #24]
+    ldr   r6, [r1, #28]
+    smlal r7, r8, r4, r5
+    ldr   r5, [r1, #32]
+    smlal r9, r10, r4, r6
+    smlal r11, lr, r4, r5
+    // >> FX32_SHIFT
+    mov   r7, r7, lsr #12
+    orr   r7, r7, r8, lsl #20
+    mov   r9, r9, lsr #12
+    orr   r9, r9, r10, lsl #20
+    mov   r11, r11, lsr #12
+    orr   r11, r11, lr, lsl #20
+    // + row 3
+    ldr   r4, [r1, #36]
+    ldr   r5, [r1, #40]
+    ldr   r6, [r1, #44]
+    add   r7, r7, r4
+    add   r9, r9, r5
+    add   r11, r11, r6
+    stmia r2!, {r7, r9, r11}
+
+    add   r0, r0, #12
+    subs  r3, r3, #1
+    bne   @00
+
+    ldmfd sp!, {r4-r11, lr}
+    bx    lr
+}
+
+
+/*---------------------------------------------------------------------------*
+  Name:         MTX_Concat43Array_
+
+  Description:  Concatenates pairs of 4x3 matrices.
+                ab[i] = a[i] x b[i]
+                The result of each element is identical to MTX_Concat43.
+
+  Arguments:    a            a pointer to the array of left-hand matrices
+                b            a pointer to the array of right-hand matrices
+                ab           a pointer to the array of resultant matrices
+                             OK if ab == a. ab must not overlap b.
+                num          number of matrix pairs
+
+  Returns:      none
+ *---------------------------------------------------------------------------*/
+asm void MTX_Concat43Array_(register const MtxFx43 *a, register const MtxFx43 *b,
+                            register MtxFx43 *ab, register u32 num)
+{
+    cmp   r3, #0
+    bxeq  lr
+    stmfd sp!, {r4-r11, lr}
+
+@10:
+    mov   r12, #4                      // rows per matrix
+
+@11:
+    // a->_i0 * b row 0
+    ldr   r4, [r0, #0]
+    ldr   r5, [r1, #0]
+    ldr   r6, [r1, #4]
+    smull r7, r8, r4, r5
+    ldr   r5, [r1, #8]
+    smull r9, r10, r4, r6
+    smull r11, lr, r4, r5
+    // a->_i1 * b row 1
+    ldr   r4, [r0, #4]
+    ldr   r5, [r1, #12]
+    ldr   r6, [r1, #16]
+    smlal r7, r8, r4, r5
+    ldr   r5, [r1, #20]
+    smlal r9, r10, r4, r6
+    smlal r11, lr, r4, r5
+    // a->_i2 * b row 2
+    ldr   r4, [r0, #8]
+    ldr   r5, [r1, #24]
+    ldr   r6, [r1, #28]
+    smlal r7, r8, r4, r5
+    ldr   r5, [r1, #32]
+    smlal r9, r10, r4, r6
+    smlal r11, lr, r4, r5
+    // >> FX32_SHIFT
+    mov   r7, r7, lsr #12
+    orr   r7, r7, r8, lsl #20
+    mov   r9, r9, lsr #12
+    orr   r9, r9, r10, lsl #20
+    mov   r11, r11, lsr #12
+    orr   r11, r11, lr, lsl #20
+    // + b row 3 for the last row only
+    cmp   r12, #1
+    ldreq r4, [r1, #36]
+    ldreq r5, [r1, #40]
+    ldreq r6, [r1, #44]
+    addeq r7, r7, r4
+    addeq r9, r9, r5
+    addeq r11, r11, r6
+    stmia r2!, {r7, r9, r11}
+
+    add   r0, r0, #12
+    subs  r12, r12, #1
+    bne   @11
+
+    add   r1, r1, #48
+    subs  r3, r3, #1
+    bne   @10
+
+    ldmfd sp!, {r4-r11, lr}
+    bx    lr
+}
+
+
 /*---------------------------------------------------------------------------*
   Name:         MTX_LookAt
 
@@ -482,6 +482,102 @@ void MTX_Concat44(const MtxFx44 *a, const MtxFx44 *b, MtxFx44 *ab)
     }
 }
 
+/*---------------------------------------------------------------------------*
+  Name:         MTX_Concat44Array_
+
+  Description:  Concatenates pairs of 4x4 matrices.
+                ab[i] = a[i] x b[i]
+                The result of each element is identical to MTX_Concat44.
+                Each row is computed two columns at a time so that the 64-bit
+                accumulators of SMULL/SMLAL stay in registers.
+
+  Arguments:    a            a pointer to the array of left-hand matrices
+                b            a pointer to the array of right-hand matrices
+                ab           a pointer to the array of resultant matrices
+                             OK if ab == a. ab must not overlap b.
+                num          number of matrix pairs
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+asm void MTX_Concat44Array_(register const MtxFx44 *a, register const MtxFx44 *b,
+                            register MtxFx44 *ab, register u32 num)
+{
+    cmp   r3, #0
+    bxeq  lr
+    stmfd sp!, {r4-r11, lr}
+
+@20:
+    mov   r12, #4                      // rows per matrix
+
+@21:
+    // columns 0 and 1
+    ldr   r4, [r0, #0]
+    ldr   r5, [r1, #0]
+    ldr   r6, [r1, #4]
+    smull r7, r8, r4, r5
+    smull r9, r10, r4, r6
+    ldr   r4, [r0, #4]
+    ldr   r5, [r1, #16]
+    ldr   r6, [r1, #20]
+    smlal r7, r8, r4, r5
+    smlal r9, r10, r4, r6
+    ldr   r4, [r0, #8]
+    ldr   r5, [r1, #32]
+    ldr   r6, [r1, #36]
+    smlal r7, r8, r4, r5
+    smlal r9, r10, r4, r6
+    ldr   r4, [r0, #12]
+    ldr   r5, [r1, #48]
+    ldr   r6, [r1, #52]
+    smlal r7, r8, r4, r5
+    smlal r9, r10, r4, r6
+    mov   r11, r7, lsr #12             // >> FX32_SHIFT
+    orr   r11, r11, r8, lsl #20
+    mov   lr, r9, lsr #12
+    orr   lr, lr, r10, lsl #20
+
+    // columns 2 and 3
+    ldr   r4, [r0, #0]
+    ldr   r5, [r1, #8]
+    ldr   r6, [r1, #12]
+    smull r7, r8, r4, r5
+    smull r9, r10, r4, r6
+    ldr   r4, [r0, #4]
+    ldr   r5, [r1, #24]
+    ldr   r6, [r1, #28]
+    smlal r7, r8, r4, r5
+    smlal r9, r10, r4, r6
+    ldr   r4, [r0, #8]
+    ldr   r5, [r1, #40]
+    ldr   r6, [r1, #44]
+    smlal r7, r8, r4, r5
+    smlal r9, r10, r4, r6
+    ldr   r4, [r0, #12]
+    ldr   r5, [r1, #56]
+    ldr   r6, [r1, #60]
+    smlal r7, r8, r4, r5
+    smlal r9, r10, r4, r6
+    mov   r7, r7, lsr #12              // >> FX32_SHIFT
+    orr   r7, r7, r8, lsl #20
+    mov   r9, r9, lsr #12
+    orr   r9, r9, r10, lsl #20
+
+    // The row of a has been read completely, so ab == a is safe here
+    stmia r2!, {r11, lr}
+    stmia r2!, {r7, r9}
+
+    add   r0, r0, #16
+    subs  r12, r12, #1
+    bne   @21
+
+    add   r1, r1, #64
+    subs  r3, r3, #1
+    bne   @20
+
+    ldmfd sp!, {r4-r11, lr}
+    bx    lr
+}
+
 /*---------------------------------------------------------------------------*
   Name:         MTX_FrustumW
 
@@ -334,6 +334,81 @@ void VEC_Normalize(const VecFx32 *pSrc, VecFx32 *pDst)
 }
 
 
+/*---------------------------------------------------------------------------*
+  Name:         VEC_NormalizeArray
+
+  Description:  Normalizes an array of vectors.
+                The result of each element is identical to VEC_Normalize.
+                The squared length of the next vector is computed while the
+                divider and the sqrt unit work on the current one, and the
+                current one is scaled while they work on the next, so the CPU
+                rarely waits for the units.
+
+  Arguments:    pSrc         a pointer to the source vectors
+                pDst         a pointer to the normalized vectors
+                             OK if pDst == pSrc.
+                num          number of vectors
+  
+  Returns:      none
+ *---------------------------------------------------------------------------*/
+void VEC_NormalizeArray(const VecFx32 *pSrc, VecFx32 *pDst, u32 num)
+{
+    fx64    t;
+
+    SDK_ASSERT(num == 0 || (pSrc != NULL && pDst != NULL));
+    SDK_ASSERT(!CP_IsDivBusy() && !CP_IsSqrtBusy());
+
+    if (num == 0)
+    {
+        return;
+    }
+
+    t = (fx64)pSrc->x * pSrc->x;
+    t += (fx64)pSrc->y * pSrc->y;
+    t += (fx64)pSrc->z * pSrc->z;      // in s39.24 format
+    SDK_TASSERTMSG(t > 0, "*pSrc is (0, 0, 0)");
+
+    SDK_WARNING(1LL << (FX32_SHIFT + FX32_SHIFT + FX64C_SHIFT) >= (u64)t, "*pSrc is too large!");
+
+    CP_SetDiv64_64(1LL << (FX32_SHIFT + FX32_SHIFT + FX64C_SHIFT), (u64)t);
+    CP_SetSqrt64((u64)(t << 2));
+
+    for (; num > 0; --num, ++pSrc, ++pDst)
+    {
+        s32     sqrt;
+        fx32    x = pSrc->x;
+        fx32    y = pSrc->y;
+        fx32    z = pSrc->z;
+
+        // Squared length of the next vector, while the units are busy
+        if (num > 1)
+        {
+            t = (fx64)pSrc[1].x * pSrc[1].x;
+            t += (fx64)pSrc[1].y * pSrc[1].y;
+            t += (fx64)pSrc[1].z * pSrc[1].z;
+            SDK_TASSERTMSG(t > 0, "*pSrc is (0, 0, 0)");
+            SDK_WARNING(1LL << (FX32_SHIFT + FX32_SHIFT + FX64C_SHIFT) >= (u64)t, "*pSrc is too large!");
+        }
+
+        sqrt = (s32)CP_GetSqrtResult32();       // in s18.13 format
+        {
+            fx64    inv = CP_GetDivResult64();  // in s31.32 format(fx64c)
+
+            // Start the next vector before scaling the current one
+            if (num > 1)
+            {
+                CP_SetDivImm64_64(1LL << (FX32_SHIFT + FX32_SHIFT + FX64C_SHIFT), (u64)t);
+                CP_SetSqrtImm64((u64)(t << 2));
+            }
+            inv = inv * sqrt;          // in s18.45 format
+            pDst->x = (fx32)((inv * x + (1LL << (32 + FX32_SHIFT))) >> (32 + FX32_SHIFT + 1));
+            pDst->y = (fx32)((inv * y + (1LL << (32 + FX32_SHIFT))) >> (32 + FX32_SHIFT + 1));
+            pDst->z = (fx32)((inv * z + (1LL << (32 + FX32_SHIFT))) >> (32 + FX32_SHIFT + 1));
+        }
+    }
+}
+
+
 /*---------------------------------------------------------------------------*
   Name:         VEC_Fx16Normalize
 
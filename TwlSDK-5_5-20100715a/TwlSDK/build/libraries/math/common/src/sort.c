@@ -0,0 +1,434 @@
+/*---------------------------------------------------------------------------*
+  Project:  TwlSDK - MATH -
+  File:     sort.c
+
+  Copyright 2003-2008 Nintendo. All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law. They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Date::            $
+  $Rev:$
+  $Author:$
+ *---------------------------------------------------------------------------*/
+
+#include <nitro.h>
+
+// Upper limit of the number of pending ranges for MATH_IntroSort.
+// The smaller range is always processed first, so this is enough for 2^32 elements.
+#define MATHi_INTRO_SORT_STACK_NUM  32
+
+/* ------------------------------------------- *
+ * Internal functions
+ * ------------------------------------------- */
+// Sorting is always performed in ARM mode because of the loop-heavy processing
+#include <nitro/code32.h>
+
+/*---------------------------------------------------------------------------*
+  Name:         MATHi_SiftDown
+
+  Description:  Moves the root element down to its correct position in a max-heap.
+
+  Arguments:    heap:     Start of the heap
+                root:     Index of the element to move down
+                num:      Number of elements in the heap
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void MATHi_SiftDown(MATHSortItem *heap, u32 root, u32 num)
+{
+    MATHSortItem tmp = heap[root];
+    u32     child;
+
+    while ((child = root * 2 + 1) < num)
+    {
+        if ((child + 1 < num) && (heap[child + 1].key > heap[child].key))
+        {
+            ++child;
+        }
+        if (heap[child].key <= tmp.key)
+        {
+            break;
+        }
+        heap[root] = heap[child];
+        root = child;
+    }
+    heap[root] = tmp;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         MATHi_SortHeap
+
+  Description:  Sorts a max-heap in ascending order.
+
+  Arguments:    heap:     Start of the heap
+                num:      Number of elements in the heap
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void MATHi_SortHeap(MATHSortItem *heap, u32 num)
+{
+    while (num > 1)
+    {
+        MATHSortItem tmp;
+
+        --num;
+        tmp = heap[0];
+        heap[0] = heap[num];
+        heap[num] = tmp;
+        MATHi_SiftDown(heap, 0, num);
+    }
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         MATHi_HeapSort
+
+  Description:  Sorts with a heapsort. Used when quicksort recursion becomes too deep.
+
+  Arguments:    items:    Pointer to the data to sort
+                num:      Number of data items to sort
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void MATHi_HeapSort(MATHSortItem *items, u32 num)
+{
+    u32     i;
+
+    for (i = num / 2; i > 0; --i)
+    {
+        MATHi_SiftDown(items, i - 1, num);
+    }
+    MATHi_SortHeap(items, num);
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         MATHi_InsertionSort
+
+  Description:  Sorts with an insertion sort.
+                Fast for small ranges or for data that is almost sorted.
+
+  Arguments:    items:    Pointer to the data to sort
+                num:      Number of data items to sort
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void MATHi_InsertionSort(MATHSortItem *items, u32 num)
+{
+    MATHSortItem *end = items + num;
+    MATHSortItem *p;
+
+    for (p = items + 1; p < end; ++p)
+    {
+        if (p->key < p[-1].key)
+        {
+            MATHSortItem tmp = *p;
+            MATHSortItem *q = p;
+
+            do
+            {
+                *q = q[-1];
+                --q;
+            }
+            while ((q > items) && (tmp.key < q[-1].key));
+            *q = tmp;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         MATHi_RadixSort
+
+  Description:  Performs an LSD radix sort 8 bits at a time.
+
+  Arguments:    items:    Pointer to the data to sort
+                num:      Number of data items to sort
+                workBuf:  Work buffer of MATH_RadixSortBufferSize(num) bytes
+                bits:     Number of valid bits in the key (a multiple of 8)
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void MATHi_RadixSort(MATHSortItem *items, u32 num, void *workBuf, u32 bits)
+{
+    MATHSortItem *src = items;
+    MATHSortItem *dst = (MATHSortItem *)workBuf;
+    u32    *count = (u32 *)(dst + num);
+    u32     shift;
+
+    SDK_NULL_ASSERT(items);
+    SDK_NULL_ASSERT(workBuf);
+    SDK_ALIGN4_ASSERT(workBuf);
+
+    if (num <= 1)
+    {
+        return;
+    }
+
+    for (shift = 0; shift < bits; shift += 8)
+    {
+        u32     i;
+        u32     sum;
+
+        MI_CpuClear32(count, MATH_RADIX_SORT_BUCKET_NUM * sizeof(u32));
+        for (i = 0; i < num; ++i)
+        {
+            ++count[(src[i].key >> shift) & 0xFF];
+        }
+
+        // Skip the pass if every key has the same value in this digit.
+        // This often happens with the upper bytes of depth values.
+        if (count[(src[0].key >> shift) & 0xFF] == num)
+        {
+            continue;
+        }
+
+        // Convert the counts into the start position of each bucket
+        sum = 0;
+        for (i = 0; i < MATH_RADIX_SORT_BUCKET_NUM; ++i)
+        {
+            u32     n = count[i];
+            count[i] = sum;
+            sum += n;
+        }
+
+        for (i = 0; i < num; ++i)
+        {
+            dst[count[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+
+        {
+            MATHSortItem *tmp = src;
+            src = dst;
+            dst = tmp;
+        }
+    }
+
+    // If the result is in the work buffer, write it back
+    if (src != items)
+    {
+        MI_CpuCopy32(src, items, num * sizeof(MATHSortItem));
+    }
+}
+
+/* ------------------------------------------- *
+ * External functions
+ * ------------------------------------------- */
+/*---------------------------------------------------------------------------*
+  Name:         MATH_RadixSort16
+
+  Description:  Sorts by the lower 16 bits of the key with an LSD radix sort.
+                The sort is stable, and processing time is proportional to num.
+                The upper 16 bits of the key are ignored.
+
+  Arguments:    items:    Pointer to the data to sort
+                num:      Number of data items to sort
+                workBuf:  Work buffer of MATH_RadixSortBufferSize(num) bytes. Must be 4-byte aligned.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void MATH_RadixSort16(MATHSortItem *items, u32 num, void *workBuf)
+{
+    MATHi_RadixSort(items, num, workBuf, 16);
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         MATH_RadixSort32
+
+  Description:  Sorts by the whole 32-bit key with an LSD radix sort.
+                The sort is stable, and processing time is proportional to num.
+                Passes over bytes that are identical in every key are skipped.
+
+  Arguments:    items:    Pointer to the data to sort
+                num:      Number of data items to sort
+                workBuf:  Work buffer of MATH_RadixSortBufferSize(num) bytes. Must be 4-byte aligned.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void MATH_RadixSort32(MATHSortItem *items, u32 num, void *workBuf)
+{
+    MATHi_RadixSort(items, num, workBuf, 32);
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         MATH_IntroSort
+
+  Description:  Sorts by key with an introsort.
+                Quicksort with a median-of-three pivot is used, and ranges that recurse too deeply
+                switch to heapsort, so the worst case is O(n log n).
+                Small ranges are finished with an insertion sort.
+                No work buffer is required. The sort is not stable.
+
+  Arguments:    items:    Pointer to the data to sort
+                num:      Number of data items to sort
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void MATH_IntroSort(MATHSortItem *items, u32 num)
+{
+    MATHSortItem *stackLo[MATHi_INTRO_SORT_STACK_NUM];
+    MATHSortItem *stackHi[MATHi_INTRO_SORT_STACK_NUM];
+    u8      stackDepth[MATHi_INTRO_SORT_STACK_NUM];
+    int     sp = 0;
+    MATHSortItem *lo;
+    MATHSortItem *hi;
+    int     depth;
+
+    SDK_ASSERT((items != NULL) || (num == 0));
+
+    if (num <= 1)
+    {
+        return;
+    }
+
+    lo = items;
+    hi = items + num - 1;
+    depth = MATH_ILog2(num) * 2;
+
+    for (;;)
+    {
+        // Partition until the range is small enough for the final insertion sort
+        while (hi - lo >= MATH_SORT_INSERTION_THRESHOLD)
+        {
+            MATHSortItem *mid;
+            MATHSortItem *i;
+            MATHSortItem *j;
+            MATHSortItem tmp;
+            u32     pivot;
+
+            if (depth == 0)
+            {
+                // Too many bad pivots; guarantee O(n log n) with heapsort
+                MATHi_HeapSort(lo, (u32)(hi - lo + 1));
+                break;
+            }
+            --depth;
+
+            // Median of three: sort lo, mid, hi so that they also act as sentinels
+            mid = lo + ((hi - lo) >> 1);
+            if (mid->key < lo->key)
+            {
+                tmp = *mid; *mid = *lo; *lo = tmp;
+            }
+            if (hi->key < mid->key)
+            {
+                tmp = *hi; *hi = *mid; *mid = tmp;
+                if (mid->key < lo->key)
+                {
+                    tmp = *mid; *mid = *lo; *lo = tmp;
+                }
+            }
+            pivot = mid->key;
+
+            i = lo + 1;
+            j = hi - 1;
+            for (;;)
+            {
+                while (i->key < pivot)
+                {
+                    ++i;
+                }
+                while (j->key > pivot)
+                {
+                    --j;
+                }
+                if (i >= j)
+                {
+                    break;
+                }
+                tmp = *i; *i = *j; *j = tmp;
+                ++i;
+                --j;
+            }
+            if (i == j)
+            {
+                // This element is equal to the pivot and is already in place
+                ++i;
+                --j;
+            }
+
+            // [lo, j] <= pivot <= [i, hi]
+            // Push the larger range and continue with the smaller one to limit stack usage
+            SDK_ASSERT(sp < MATHi_INTRO_SORT_STACK_NUM);
+            if (j - lo > hi - i)
+            {
+                stackLo[sp] = lo;
+                stackHi[sp] = j;
+                stackDepth[sp] = (u8)depth;
+                ++sp;
+                lo = i;
+            }
+            else
+            {
+                stackLo[sp] = i;
+                stackHi[sp] = hi;
+                stackDepth[sp] = (u8)depth;
+                ++sp;
+                hi = j;
+            }
+        }
+
+        if (sp == 0)
+        {
+            break;
+        }
+        --sp;
+        lo = stackLo[sp];
+        hi = stackHi[sp];
+        depth = stackDepth[sp];
+    }
+
+    // Every remaining unsorted range is small and already in its final region
+    MATHi_InsertionSort(items, num);
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         MATH_PartialSort
+
+  Description:  Moves the k items with the smallest keys to the start of the array in ascending order.
+                The order of the remaining items is undefined.
+                Processing time is O(n log k), so this is faster than a full sort when only the
+                first few entries (for example, the nearest objects) are needed.
+
+  Arguments:    items:    Pointer to the data to sort
+                num:      Number of data items
+                k:        Number of items to obtain. If larger than num, all items are sorted.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void MATH_PartialSort(MATHSortItem *items, u32 num, u32 k)
+{
+    u32     i;
+
+    SDK_ASSERT((items != NULL) || (num == 0));
+
+    if (k >= num)
+    {
+        MATH_IntroSort(items, num);
+        return;
+    }
+    if (k == 0)
+    {
+        return;
+    }
+
+    // Keep the k smallest items in a max-heap at the start of the array
+    for (i = k / 2; i > 0; --i)
+    {
+        MATHi_SiftDown(items, i - 1, k);
+    }
+    for (i = k; i < num; ++i)
+    {
+        if (items[i].key < items[0].key)
+        {
+            MATHSortItem tmp = items[i];
+            items[i] = items[0];
+            items[0] = tmp;
+            MATHi_SiftDown(items, 0, k);
+        }
+    }
+    MATHi_SortHeap(items, k);
+}
+
+#include <nitro/codereset.h>
@@ -19,6 +19,42 @@
 #include <nitro.h>
 
 
+/*---------------------------------------------------------------------------*/
+/* Constants */
+
+/* Format flags */
+enum
+{
+    flag_blank = 000001,               /* ' ' */
+    flag_plus = 000002,                /* '+' */
+    flag_sharp = 000004,               /* '#' */
+    flag_minus = 000010,               /* '-' */
+    flag_zero = 000020,                /* '0' */
+    flag_l1 = 000040,                  /* "l" */
+    flag_h1 = 000100,                  /* "h" */
+    flag_l2 = 000200,                  /* "ll" */
+    flag_h2 = 000400,                  /* "hh" */
+    flag_width_arg = 001000,           /* '*' for width */
+    flag_precision_arg = 002000,       /* '*' for precision */
+    flag_unsigned = 010000,            /* 'o', 'u', ... */
+    flag_end
+};
+
+/* Two-digit decimal table, used to convert integers two digits per division */
+static const char digit_pairs[200] = {
+    '0', '0', '0', '1', '0', '2', '0', '3', '0', '4', '0', '5', '0', '6', '0', '7', '0', '8', '0', '9',
+    '1', '0', '1', '1', '1', '2', '1', '3', '1', '4', '1', '5', '1', '6', '1', '7', '1', '8', '1', '9',
+    '2', '0', '2', '1', '2', '2', '2', '3', '2', '4', '2', '5', '2', '6', '2', '7', '2', '8', '2', '9',
+    '3', '0', '3', '1', '3', '2', '3', '3', '3', '4', '3', '5', '3', '6', '3', '7', '3', '8', '3', '9',
+    '4', '0', '4', '1', '4', '2', '4', '3', '4', '4', '4', '5', '4', '6', '4', '7', '4', '8', '4', '9',
+    '5', '0', '5', '1', '5', '2', '5', '3', '5', '4', '5', '5', '5', '6', '5', '7', '5', '8', '5', '9',
+    '6', '0', '6', '1', '6', '2', '6', '3', '6', '4', '6', '5', '6', '6', '6', '7', '6', '8', '6', '9',
+    '7', '0', '7', '1', '7', '2', '7', '3', '7', '4', '7', '5', '7', '6', '7', '7', '7', '8', '7', '9',
+    '8', '0', '8', '1', '8', '2', '8', '3', '8', '4', '8', '5', '8', '6', '8', '7', '8', '8', '8', '9',
+    '9', '0', '9', '1', '9', '2', '9', '3', '9', '4', '9', '5', '9', '6', '9', '7', '9', '8', '9', '9',
+};
+
+
 /*---------------------------------------------------------------------------*/
 /* Functions */
 
@@ -66,95 +102,181 @@ static void string_put_string(dst_string * p, const char *s, int n)
     }
 }
 
-/*---------------------------------------------------------------------------*
-  Name:         STD_TSPrintf
-
-  Description:  With the exception of the format of the arguments, identical to STD_TVSNPrintf.
-
-  Arguments:    dst: The buffer that will store the result
-                fmt: Format control string
-
-  Returns:      Identical to STD_VSNPrintf.
- *---------------------------------------------------------------------------*/
-SDK_WEAK_SYMBOL int STD_TSPrintf(char *dst, const char *fmt, ...)
+/* Outputs a string that was stored in reverse order (as integer conversion does) */
+static void string_put_reversed(dst_string * p, const char *s, int n)
 {
-    int     ret;
-    va_list vlist;
-    va_start(vlist, fmt);
-    ret = STD_TVSNPrintf(dst, 0x7FFFFFFF, fmt, vlist);
-    va_end(vlist);
-    return ret;
+    if (n > 0)
+    {
+        size_t  i, k = p->len;
+        if (k > (size_t) n)
+            k = (size_t) n;
+        for (i = 0; i < k; ++i)
+            p->cur[i] = s[n - 1 - i];
+        p->len -= k;
+        p->cur += n;
+    }
 }
 
 /*---------------------------------------------------------------------------*
-  Name:         STD_TVSPrintf
+  Name:         STDi_ScanFormatLiteral
 
-  Description:  With the exception of the format of the arguments, identical to STD_TVSNPrintf.
+  Description:  Finds the end of the literal run that starts at the specified position.
+                Shift JIS characters are skipped as pairs so that a trail byte is never
+                mistaken for '%'.
 
-  Arguments:    dst: The buffer that will store the result
-                fmt: Format control string
-                vlist: Parameters
+  Arguments:    s: Position in the format string
 
-  Returns:      Identical to STD_VSNPrintf.
+  Returns:      Position of the next '%' or of the terminating '\0'.
  *---------------------------------------------------------------------------*/
-SDK_WEAK_SYMBOL int STD_TVSPrintf(char *dst, const char *fmt, va_list vlist)
+static const char *STDi_ScanFormatLiteral(const char *s)
 {
-    return STD_TVSNPrintf(dst, 0x7FFFFFFF, fmt, vlist);
+    while (*s && (*s != '%'))
+    {
+        if ((unsigned int)(((unsigned char)*s ^ 0x20) - 0xA1) < 0x3C)
+        {
+            /* Shift JIS character */
+            ++s;
+            if (*s)
+                ++s;
+        }
+        else
+        {
+            /* normal ASCII character */
+            ++s;
+        }
+    }
+    return s;
+}
+
+/* Outputs the literal run at s while scanning it, and returns the position of the next '%' or '\0' */
+static const char *string_put_literal(dst_string * p, const char *s)
+{
+    char   *cur = p->cur;
+    size_t  k = p->len;
+    char    c;
+
+    while (((c = *s) != '\0') && (c != '%'))
+    {
+        if ((unsigned int)(((unsigned char)c ^ 0x20) - 0xA1) < 0x3C)
+        {
+            /* Shift JIS character */
+            if (k > 0)
+                *cur = c, --k;
+            ++cur, ++s;
+            if ((c = *s) == '\0')
+                break;
+        }
+        if (k > 0)
+            *cur = c, --k;
+        ++cur, ++s;
+    }
+    p->cur = cur;
+    p->len = k;
+    return s;
 }
 
 /*---------------------------------------------------------------------------*
-  Name:         STD_TSNPrintf
+  Name:         STDi_ParseFormatSpec
 
-  Description:  With the exception of the format of the arguments, identical to STD_TVSNPrintf.
+  Description:  Parses one conversion specification.
+                Width and precision specified with '*' are only marked with flags,
+                because they are taken from the arguments at output time.
 
-  Arguments:    dst: The buffer that will store the result
-                len: Buffer length
-                fmt: Format control string
- 
-  Returns:      Identical to STD_VSNPrintf.
+  Arguments:    s: Position of '%' in the format string
+                spec: Parse result
+
+  Returns:      None.
  *---------------------------------------------------------------------------*/
-SDK_WEAK_SYMBOL int STD_TSNPrintf(char *dst, size_t len, const char *fmt, ...)
+static void STDi_ParseFormatSpec(const char *s, STDFormatSpec *spec)
 {
-    int     ret;
-    va_list vlist;
-    va_start(vlist, fmt);
-    ret = STD_TVSNPrintf(dst, len, fmt, vlist);
-    va_end(vlist);
-    return ret;
+    int     flag = 0, width = 0, precision = -1;
+
+    spec->conv = s;
+    /* flags */
+    for (;;)
+    {
+        switch (*++s)
+        {
+        case '+':
+            if (s[-1] != ' ')
+                break;
+            flag |= flag_plus;
+            continue;
+        case ' ':
+            flag |= flag_blank;
+            continue;
+        case '-':
+            flag |= flag_minus;
+            continue;
+        case '0':
+            flag |= flag_zero;
+            continue;
+        }
+        break;
+    }
+    /* width */
+    if (*s == '*')
+    {
+        ++s, flag |= flag_width_arg;
+    }
+    else
+    {
+        while ((*s >= '0') && (*s <= '9'))
+            width = (width * 10) + *s++ - '0';
+    }
+    /* precision */
+    if (*s == '.')
+    {
+        ++s, precision = 0;
+        if (*s == '*')
+        {
+            ++s, flag |= flag_precision_arg;
+        }
+        else
+        {
+            while ((*s >= '0') && (*s <= '9'))
+                precision = (precision * 10) + *s++ - '0';
+        }
+    }
+    /* Options */
+    switch (*s)
+    {
+    case 'h':
+        if (*++s != 'h')
+            flag |= flag_h1;
+        else
+            ++s, flag |= flag_h2;
+        break;
+    case 'l':
+        if (*++s != 'l')
+            flag |= flag_l1;
+        else
+            ++s, flag |= flag_l2;
+        break;
+    }
+
+    spec->type = s;
+    spec->flag = flag;
+    spec->width = width;
+    spec->precision = precision;
 }
 
 /*---------------------------------------------------------------------------*
-  Name:         STD_TVSNPrintf
+  Name:         STDi_VSNPrintfCore
 
-  Description:  sprintf redone to save on size.
-                Supports basic format specifications.
-                %([-+# ]?)([0-9]*)(\.?)([0-9]*)([l|ll|h||hh]?)([diouxXpncs%])
-
-  Note:         To match the behavior of CodeWarrior's MSL sprintf(), '+' and '#' are disabled.
-                
-                { // example
-                  char buf[5];
-                  sprintf(buf, "%-i\n", 45);  // "45"  (OK)
-                  sprintf(buf, "%0i\n", 45);  // "45"  (OK)
-                  sprintf(buf, "% i\n", 45);  // " 45" (OK)
-                  sprintf(buf, "%+i\n", 45);  // "%+i" ("+45" expected)
-                  sprintf(buf, "%#x\n", 45);  // "%#x" ("0x2d" expected)
-                  // but, this works correctly!
-                  sprintf(buf, "% +i\n", 45); // "+45" (OK)
-                }
+  Description:  Common output processing for STD_TVSNPrintf and STD_TVSNPrintfCompiled.
 
   Arguments:    dst: The buffer that will store the result
                 len: Buffer length
                 fmt: Format control string
+                compiled: Specification list created by STD_CompileFormat.
+                          If NULL, fmt is parsed while outputting.
                 vlist: Parameters
 
-  Returns:      Returns the number of characters (exclusive of '\0') when the format string is output correctly.
-                When the buffer size is sufficient, all text is output and a terminator is provided.
-                When the buffer size is not enough, termination occurs at dst[len-1].
-                Nothing happens when len is 0.
-
+  Returns:      Identical to STD_TVSNPrintf.
  *---------------------------------------------------------------------------*/
-SDK_WEAK_SYMBOL int STD_TVSNPrintf(char *dst, size_t len, const char *fmt, va_list vlist)
+static int STDi_VSNPrintfCore(char *dst, size_t len, const char *fmt,
+                              const STDFormatSpec *compiled, va_list vlist)
 {
     char    buf[24];
     int     n_buf;
@@ -162,109 +284,50 @@ SDK_WEAK_SYMBOL int STD_TVSNPrintf(char *dst, size_t len, const char *fmt, va_li
     int     n_prefix;
 
     const char *s = fmt;
+    STDFormatSpec parsed;
 
     dst_string str;
     str.len = len, str.cur = str.base = dst;
 
-    while (*s)
+    for (;;)
     {
-        if ((unsigned int)(((unsigned char)*s ^ 0x20) - 0xA1) < 0x3C)
+        const STDFormatSpec *spec;
+
+        /* Copy the literal run in one pass */
+        if (compiled)
         {
-            /* Shift JIS character */
-            string_put_char(&str, *s++);
-            if (*s)
-                string_put_char(&str, *s++);
+            spec = compiled++;
+            string_put_string(&str, s, spec->conv - s);
+            if (!*spec->conv)
+                break;
         }
-        else if (*s != '%')
+        else
         {
-            /* normal ASCII character */
-            string_put_char(&str, *s++);
+            s = string_put_literal(&str, s);
+            if (!*s)
+                break;
+            STDi_ParseFormatSpec(s, &parsed);
+            spec = &parsed;
         }
-        else
+
+        /* output with format */
         {
-            /* output with format */
-            enum
-            {
-                flag_blank = 000001,   /* ' ' */
-                flag_plus = 000002,    /* '+' */
-                flag_sharp = 000004,   /* '#' */
-                flag_minus = 000010,   /* '-' */
-                flag_zero = 000020,    /* '0' */
-                flag_l1 = 000040,      /* "l" */
-                flag_h1 = 000100,      /* "h" */
-                flag_l2 = 000200,      /* "ll" */
-                flag_h2 = 000400,      /* "hh" */
-                flag_unsigned = 010000, /* 'o', 'u', ... */
-                flag_end
-            };
-            int     flag = 0, width = 0, precision = -1, radix = 10;
+            int     flag = spec->flag, width = spec->width, precision = spec->precision, radix = 10;
             char    hex_char = 'a' - 10;
-            const char *p_start = s;
-            /* flags */
-            for (;;)
-            {
-                switch (*++s)
-                {
-                case '+':
-                    if (s[-1] != ' ')
-                        break;
-                    flag |= flag_plus;
-                    continue;
-                case ' ':
-                    flag |= flag_blank;
-                    continue;
-                case '-':
-                    flag |= flag_minus;
-                    continue;
-                case '0':
-                    flag |= flag_zero;
-                    continue;
-                }
-                break;
-            }
-            /* width */
-            if (*s == '*')
+            const char *p_start = spec->conv;
+
+            s = spec->type;
+            if (flag & flag_width_arg)
             {
-                ++s, width = va_arg(vlist, int);
+                width = va_arg(vlist, int);
                 if (width < 0)
                     width = -width, flag |= flag_minus;
             }
-            else
+            if (flag & flag_precision_arg)
             {
-                while ((*s >= '0') && (*s <= '9'))
-                    width = (width * 10) + *s++ - '0';
-            }
-            /* precision */
-            if (*s == '.')
-            {
-                ++s, precision = 0;
-                if (*s == '*')
-                {
-                    ++s, precision = va_arg(vlist, int);
-                    if (precision < 0)
-                        precision = -1;
-                }
-                else
-                {
-                    while ((*s >= '0') && (*s <= '9'))
-                        precision = (precision * 10) + *s++ - '0';
-                }
-            }
-            /* Options */
-            switch (*s)
-            {
-            case 'h':
-                if (*++s != 'h')
-                    flag |= flag_h1;
-                else
-                    ++s, flag |= flag_h2;
-                break;
-            case 'l':
-                if (*++s != 'l')
-                    flag |= flag_l1;
-                else
-                    ++s, flag |= flag_l2;
-                break;
+                precision = va_arg(vlist, int);
+                if (precision < 0)
+                    precision = -1;
             }
 
             /* type */
@@ -461,30 +524,40 @@ SDK_WEAK_SYMBOL int STD_TVSNPrintf(char *dst, size_t len, const char *fmt, va_li
                         }
                         break;
                     case 10:
-                        if ((val >> 32) == 0)
                         {
 #if defined(SDK_CW) || defined(SDK_RX) || defined(__MWERKS__)
 #pragma optimize_for_size off
 #endif
-                            u32     v = (u32)val;
-                            while (v != 0)
+                            u32     v;
+                            // Convert two digits per division.
+                            // Only the upper part of a 64-bit value needs the slow 64-bit division.
+                            while ((val >> 32) != 0)
+                            {
+                                u64     r = val / 100;
+                                int     d = (int)(val - (r * 100));
+                                val = r;
+                                buf[n_buf++] = digit_pairs[d * 2 + 1];
+                                buf[n_buf++] = digit_pairs[d * 2];
+                            }
+                            v = (u32)val;
+                            while (v >= 100)
                             {
                                 // If the operation is division of a u32 and a constant, the compiler automatically converts it to addition using magic numbers
-                                // 
-                                u32     r = v / 10;
-                                int     d = (int)(v - (r * 10));
+                                //
+                                u32     r = v / 100;
+                                int     d = (int)(v - (r * 100));
                                 v = r;
-                                buf[n_buf++] = (char)(d + '0');
+                                buf[n_buf++] = digit_pairs[d * 2 + 1];
+                                buf[n_buf++] = digit_pairs[d * 2];
                             }
-                        }
-                        else
-                        {
-                            while (val != 0)
+                            if (v >= 10)
                             {
-                                u64     r = val / 10;
-                                int     d = (int)(val - (r * 10));
-                                val = r;
-                                buf[n_buf++] = (char)(d + '0');
+                                buf[n_buf++] = digit_pairs[v * 2 + 1];
+                                buf[n_buf++] = digit_pairs[v * 2];
+                            }
+                            else if (v != 0)
+                            {
+                                buf[n_buf++] = (char)(v + '0');
                             }
                         }
                         break;
@@ -518,11 +591,9 @@ SDK_WEAK_SYMBOL int STD_TVSNPrintf(char *dst, size_t len, const char *fmt, va_li
                     width -= n_prefix + n_buf;
                     if (!(flag & flag_minus))
                         string_fill_char(&str, ' ', width);
-                    while (n_prefix > 0)
-                        string_put_char(&str, prefix[--n_prefix]);
+                    string_put_reversed(&str, prefix, n_prefix);
                     string_fill_char(&str, '0', n_pad);
-                    while (n_buf > 0)
-                        string_put_char(&str, buf[--n_buf]);
+                    string_put_reversed(&str, buf, n_buf);
                     if (flag & flag_minus)
                         string_fill_char(&str, ' ', width);
                     ++s;
@@ -542,3 +613,222 @@ SDK_WEAK_SYMBOL int STD_TVSNPrintf(char *dst, size_t len, const char *fmt, va_li
     }
     return str.cur - str.base;
 }
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_TSPrintf
+
+  Description:  With the exception of the format of the arguments, identical to STD_TVSNPrintf.
+
+  Arguments:    dst: The buffer that will store the result
+                fmt: Format control string
+
+  Returns:      Identical to STD_VSNPrintf.
+ *---------------------------------------------------------------------------*/
+SDK_WEAK_SYMBOL int STD_TSPrintf(char *dst, const char *fmt, ...)
+{
+    int     ret;
+    va_list vlist;
+    va_start(vlist, fmt);
+    ret = STD_TVSNPrintf(dst, 0x7FFFFFFF, fmt, vlist);
+    va_end(vlist);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_TVSPrintf
+
+  Description:  With the exception of the format of the arguments, identical to STD_TVSNPrintf.
+
+  Arguments:    dst: The buffer that will store the result
+                fmt: Format control string
+                vlist: Parameters
+
+  Returns:      Identical to STD_VSNPrintf.
+ *---------------------------------------------------------------------------*/
+SDK_WEAK_SYMBOL int STD_TVSPrintf(char *dst, const char *fmt, va_list vlist)
+{
+    return STD_TVSNPrintf(dst, 0x7FFFFFFF, fmt, vlist);
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_TSNPrintf
+
+  Description:  With the exception of the format of the arguments, identical to STD_TVSNPrintf.
+
+  Arguments:    dst: The buffer that will store the result
+                len: Buffer length
+                fmt: Format control string
+
+  Returns:      Identical to STD_VSNPrintf.
+ *---------------------------------------------------------------------------*/
+SDK_WEAK_SYMBOL int STD_TSNPrintf(char *dst, size_t len, const char *fmt, ...)
+{
+    int     ret;
+    va_list vlist;
+    va_start(vlist, fmt);
+    ret = STD_TVSNPrintf(dst, len, fmt, vlist);
+    va_end(vlist);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_TVSNPrintf
+
+  Description:  sprintf redone to save on size.
+                Supports basic format specifications.
+                %([-+# ]?)([0-9]*)(\.?)([0-9]*)([l|ll|h||hh]?)([diouxXpncs%])
+
+  Note:         To match the behavior of CodeWarrior's MSL sprintf(), '+' and '#' are disabled.
+
+                { // example
+                  char buf[5];
+                  sprintf(buf, "%-i\n", 45);  // "45"  (OK)
+                  sprintf(buf, "%0i\n", 45);  // "45"  (OK)
+                  sprintf(buf, "% i\n", 45);  // " 45" (OK)
+                  sprintf(buf, "%+i\n", 45);  // "%+i" ("+45" expected)
+                  sprintf(buf, "%#x\n", 45);  // "%#x" ("0x2d" expected)
+                  // but, this works correctly!
+                  sprintf(buf, "% +i\n", 45); // "+45" (OK)
+                }
+
+  Arguments:    dst: The buffer that will store the result
+                len: Buffer length
+                fmt: Format control string
+                vlist: Parameters
+
+  Returns:      Returns the number of characters (exclusive of '\0') when the format string is output correctly.
+                When the buffer size is sufficient, all text is output and a terminator is provided.
+                When the buffer size is not enough, termination occurs at dst[len-1].
+                Nothing happens when len is 0.
+
+ *---------------------------------------------------------------------------*/
+SDK_WEAK_SYMBOL int STD_TVSNPrintf(char *dst, size_t len, const char *fmt, va_list vlist)
+{
+    return STDi_VSNPrintfCore(dst, len, fmt, NULL, vlist);
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_CompileFormat
+
+  Description:  Parses a format control string in advance for STD_TVSNPrintfCompiled.
+                Formats that are output repeatedly, such as for a debug display updated every frame,
+                no longer need to be parsed each time.
+
+  Arguments:    compiled: The compiled format that will store the result
+                fmt: Format control string.
+                     It is referenced during output, so it must remain valid while compiled is used.
+                buffer: Array that will store the conversion specifications
+                max: Number of elements in buffer
+
+  Returns:      The number of elements required for buffer (the number of conversion specifications + 1).
+                If this is larger than max, nothing is stored in compiled.
+                Passing NULL and 0 for buffer and max obtains only the required number of elements.
+ *---------------------------------------------------------------------------*/
+int STD_CompileFormat(STDCompiledFormat *compiled, const char *fmt, STDFormatSpec *buffer, int max)
+{
+    int     n = 0;
+    const char *s = fmt;
+
+    SDK_NULL_ASSERT(fmt);
+
+    for (;;)
+    {
+        STDFormatSpec spec;
+        s = STDi_ScanFormatLiteral(s);
+        if (!*s)
+        {
+            spec.conv = spec.type = s;
+            spec.flag = spec.width = 0;
+            spec.precision = -1;
+        }
+        else
+        {
+            STDi_ParseFormatSpec(s, &spec);
+            /*
+             * Resume from the same position as STD_TVSNPrintf.
+             * The type character is output as a literal if the conversion is invalid.
+             * ('%c' with a precision is invalid, but 'c' cannot begin a conversion or a
+             *  Shift JIS character, so skipping it here gives the same literal runs.)
+             */
+            switch (*spec.type)
+            {
+            case 'd':
+            case 'i':
+            case 'o':
+            case 'u':
+            case 'X':
+            case 'x':
+            case 'p':
+            case 'c':
+            case 's':
+                s = spec.type + 1;
+                break;
+            case '%':
+                s = (spec.conv + 1 == spec.type) ? spec.type + 1 : spec.type;
+                break;
+            default:
+                s = spec.type;
+                break;
+            }
+        }
+        if (n < max)
+        {
+            buffer[n] = spec;
+        }
+        ++n;
+        if (!*spec.conv)
+        {
+            break;
+        }
+    }
+
+    if (n <= max)
+    {
+        SDK_NULL_ASSERT(compiled);
+        compiled->fmt = fmt;
+        compiled->spec = buffer;
+        compiled->count = n;
+    }
+    return n;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_TVSNPrintfCompiled
+
+  Description:  Identical to STD_TVSNPrintf, except that it uses a format that was
+                parsed in advance by STD_CompileFormat.
+                The output is exactly the same as STD_TVSNPrintf with the original format.
+
+  Arguments:    dst: The buffer that will store the result
+                len: Buffer length
+                compiled: Format compiled by STD_CompileFormat
+                vlist: Parameters
+
+  Returns:      Identical to STD_TVSNPrintf.
+ *---------------------------------------------------------------------------*/
+int STD_TVSNPrintfCompiled(char *dst, size_t len, const STDCompiledFormat *compiled, va_list vlist)
+{
+    SDK_NULL_ASSERT(compiled);
+    return STDi_VSNPrintfCore(dst, len, compiled->fmt, compiled->spec, vlist);
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_TSNPrintfCompiled
+
+  Description:  With the exception of the format of the arguments, identical to STD_TVSNPrintfCompiled.
+
+  Arguments:    dst: The buffer that will store the result
+                len: Buffer length
+                compiled: Format compiled by STD_CompileFormat
+
+  Returns:      Identical to STD_TVSNPrintf.
+ *---------------------------------------------------------------------------*/
+int STD_TSNPrintfCompiled(char *dst, size_t len, const STDCompiledFormat *compiled, ...)
+{
+    int     ret;
+    va_list vlist;
+    va_start(vlist, compiled);
+    ret = STD_TVSNPrintfCompiled(dst, len, compiled, vlist);
+    va_end(vlist);
+    return ret;
+}
@@ -0,0 +1,733 @@
+/*---------------------------------------------------------------------------*
+  Project:  TwlSDK - libraries - STD
+  File:     std_unicode_stream.c
+
+  Copyright 2006-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law. They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Date::            $
+  $Rev:$
+  $Author:$
+ *---------------------------------------------------------------------------*/
+#include <nitro.h>
+
+#include <nitro/std/unicode.h>
+
+
+#if defined(SDK_ARM9) || !defined(SDK_NITRO)
+// Because of memory restrictions, it is not possible to use the Unicode conversion feature with ARM7 in NITRO mode
+
+// Compact tables used only by the streaming converter.
+// They are separate from the tables of std_unicode.c so that programs that use only
+// STD_ConvertStream do not link the larger arrays.
+#include "unicode_compact.h"
+
+// Value returned by the decoder for malformed or unconvertible characters
+#define STDi_CHAR_INVALID       0xFFFFFFFFUL
+
+// Result of storing a single character
+#define STDi_PUT_SUCCESS        1
+#define STDi_PUT_FULL           0
+#define STDi_PUT_FAILED         (-1)
+
+
+/*****************************************************************************/
+/* Internal functions */
+
+// Conversion is always performed in ARM mode because of the loop-heavy processing
+#include <nitro/code32.h>
+
+/*---------------------------------------------------------------------------*
+  Name:         STDi_CountBits
+
+  Description:  Counts the number of bits that are set to 1.
+
+  Arguments:    x:                 Target value
+
+  Returns:      Number of 1 bits.
+ *---------------------------------------------------------------------------*/
+SDK_INLINE u32 STDi_CountBits(u32 x)
+{
+    x = x - ((x >> 1) & 0x55555555);
+    x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+    x = (x + (x >> 4)) & 0x0F0F0F0F;
+    return (x * 0x01010101) >> 24;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         STDi_LookupCompactTable
+
+  Description:  Searches one of the compact conversion tables.
+
+  Arguments:    page:              Page table
+                bitmap:            Block bitmap table
+                base:              Block base index table
+                value:             Value table
+                key:               16-bit key to search for
+
+  Returns:      The converted value, or 0 if the key is not mapped.
+ *---------------------------------------------------------------------------*/
+static u32 STDi_LookupCompactTable(const u16 *page, const u32 *bitmap,
+                                   const u16 *base, const u16 *value, u32 key)
+{
+    u32     block = page[key >> 8];
+    if (block != 0xFFFF)
+    {
+        u32     bits;
+        u32     mask;
+        block = block * 8 + ((key >> 5) & 7);
+        bits = bitmap[block];
+        mask = 1UL << (key & 31);
+        if ((bits & mask) != 0)
+        {
+            return value[base[block] + STDi_CountBits(bits & (mask - 1))];
+        }
+    }
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         STDi_DecodeChar
+
+  Description:  Decodes a single character.
+
+  Arguments:    encoding:          Encoding of the source
+                src:               Source bytes
+                len:               Number of valid bytes in src (1 or more)
+                c:                 Receives the Unicode value, or STDi_CHAR_INVALID
+                                  if the character is malformed or cannot be converted.
+
+  Returns:      Number of bytes consumed, or 0 if more bytes are needed.
+ *---------------------------------------------------------------------------*/
+static int STDi_DecodeChar(STDEncoding encoding, const u8 *src, int len, u32 *c)
+{
+    u32     c1 = src[0];
+    switch (encoding)
+    {
+    case STD_ENCODING_SJIS:
+        /* ASCII [00, 7F] */
+        if (c1 < 0x80)
+        {
+            *c = c1;
+            return 1;
+        }
+        /* Half-width kana [A1, DF] */
+        else if ((c1 >= 0xA1) && (c1 <= 0xDF))
+        {
+            *c = c1 + (0xFF61 - 0xA1);
+            return 1;
+        }
+        else if (STD_IsSjisLeadByte((int)c1))
+        {
+            u32     w;
+            if (len < 2)
+            {
+                return 0;
+            }
+            if (!STD_IsSjisTrailByte(src[1]))
+            {
+                *c = STDi_CHAR_INVALID;
+                return 1;
+            }
+            w = STDi_LookupCompactTable(sjis2unicode_page, sjis2unicode_bitmap,
+                                        sjis2unicode_base, sjis2unicode_value,
+                                        (c1 << 8) | src[1]);
+            *c = w ? w : STDi_CHAR_INVALID;
+            return 2;
+        }
+        *c = STDi_CHAR_INVALID;
+        return 1;
+
+    case STD_ENCODING_UTF16:
+        {
+            u32     w;
+            if (len < 2)
+            {
+                return 0;
+            }
+            w = c1 | (src[1] << 8);
+            /* High surrogate: must be followed by a low surrogate */
+            if ((w >= 0xD800) && (w < 0xDC00))
+            {
+                u32     w2;
+                if (len < 4)
+                {
+                    return 0;
+                }
+                w2 = src[2] | (src[3] << 8);
+                if ((w2 >= 0xDC00) && (w2 < 0xE000))
+                {
+                    *c = 0x10000 + ((w - 0xD800) << 10) + (w2 - 0xDC00);
+                    return 4;
+                }
+                *c = STDi_CHAR_INVALID;
+            }
+            /* A lone low surrogate is invalid */
+            else if ((w >= 0xDC00) && (w < 0xE000))
+            {
+                *c = STDi_CHAR_INVALID;
+            }
+            else
+            {
+                *c = w;
+            }
+            return 2;
+        }
+
+    case STD_ENCODING_UTF8:
+        {
+            int     n;
+            int     i;
+            u32     w;
+            u32     min;
+            if (c1 < 0x80)
+            {
+                *c = c1;
+                return 1;
+            }
+            else if ((c1 >= 0xC2) && (c1 < 0xE0))
+            {
+                n = 2, w = c1 & 0x1F, min = 0x80;
+            }
+            else if ((c1 >= 0xE0) && (c1 < 0xF0))
+            {
+                n = 3, w = c1 & 0x0F, min = 0x800;
+            }
+            else if ((c1 >= 0xF0) && (c1 < 0xF5))
+            {
+                n = 4, w = c1 & 0x07, min = 0x10000;
+            }
+            else
+            {
+                /* Continuation byte, overlong 2-byte lead, or out of range */
+                *c = STDi_CHAR_INVALID;
+                return 1;
+            }
+            /* Validate the continuation bytes that are already available */
+            for (i = 1; i < n; ++i)
+            {
+                if (i >= len)
+                {
+                    return 0;
+                }
+                if ((src[i] & 0xC0) != 0x80)
+                {
+                    /* Resynchronize at the byte that broke the sequence */
+                    *c = STDi_CHAR_INVALID;
+                    return i;
+                }
+                w = (w << 6) | (src[i] & 0x3F);
+            }
+            /* Reject overlong forms, surrogates, and values beyond U+10FFFF */
+            if ((w < min) || ((w >= 0xD800) && (w < 0xE000)) || (w > 0x10FFFF))
+            {
+                w = STDi_CHAR_INVALID;
+            }
+            *c = w;
+            return n;
+        }
+
+    default:
+        SDK_ASSERT(FALSE);
+        *c = STDi_CHAR_INVALID;
+        return 1;
+    }
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         STDi_EncodeChar
+
+  Description:  Encodes a single character.
+
+  Arguments:    encoding:          Encoding of the destination
+                dst:               Buffer of 4 bytes that receives the result
+                c:                 Unicode value
+
+  Returns:      Number of bytes stored, or 0 if the character cannot be expressed.
+ *---------------------------------------------------------------------------*/
+static int STDi_EncodeChar(STDEncoding encoding, u8 *dst, u32 c)
+{
+    switch (encoding)
+    {
+    case STD_ENCODING_SJIS:
+        if (c < 0x80)
+        {
+            dst[0] = (u8)c;
+            return 1;
+        }
+        /* Half-width kana */
+        else if ((c >= 0xFF61) && (c <= 0xFF9F))
+        {
+            dst[0] = (u8)(c - (0xFF61 - 0xA1));
+            return 1;
+        }
+        /* Extended characters (private region) */
+        else if ((c >= 0xE000) && (c < 0xF8FF))
+        {
+            const u32 sjis_page = 188UL;
+            const u32 offset = c - 0xE000;
+            u32     c1 = offset / sjis_page;
+            u32     c2 = offset - c1 * sjis_page;
+            dst[0] = (u8)(c1 + 0xF0);
+            dst[1] = (u8)(c2 + ((c2 < 0x3F) ? 0x40 : 0x41));
+            return 2;
+        }
+        else if (c < 0x10000)
+        {
+            u32     w = STDi_LookupCompactTable(unicode2sjis_page, unicode2sjis_bitmap,
+                                                unicode2sjis_base, unicode2sjis_value, c);
+            if (w != 0)
+            {
+                dst[0] = (u8)(w >> 8);
+                if ((w & 0xFF) == 0)
+                {
+                    return 1;
+                }
+                dst[1] = (u8)w;
+                return 2;
+            }
+        }
+        return 0;
+
+    case STD_ENCODING_UTF16:
+        if (c < 0x10000)
+        {
+            dst[0] = (u8)c;
+            dst[1] = (u8)(c >> 8);
+            return 2;
+        }
+        else
+        {
+            u32     hi = 0xD800 + ((c - 0x10000) >> 10);
+            u32     lo = 0xDC00 + (c & 0x3FF);
+            dst[0] = (u8)hi;
+            dst[1] = (u8)(hi >> 8);
+            dst[2] = (u8)lo;
+            dst[3] = (u8)(lo >> 8);
+            return 4;
+        }
+
+    case STD_ENCODING_UTF8:
+        if (c < 0x80)
+        {
+            dst[0] = (u8)c;
+            return 1;
+        }
+        else if (c < 0x800)
+        {
+            dst[0] = (u8)(0xC0 | (c >> 6));
+            dst[1] = (u8)(0x80 | (c & 0x3F));
+            return 2;
+        }
+        else if (c < 0x10000)
+        {
+            dst[0] = (u8)(0xE0 | (c >> 12));
+            dst[1] = (u8)(0x80 | ((c >> 6) & 0x3F));
+            dst[2] = (u8)(0x80 | (c & 0x3F));
+            return 3;
+        }
+        else
+        {
+            dst[0] = (u8)(0xF0 | (c >> 18));
+            dst[1] = (u8)(0x80 | ((c >> 12) & 0x3F));
+            dst[2] = (u8)(0x80 | ((c >> 6) & 0x3F));
+            dst[3] = (u8)(0x80 | (c & 0x3F));
+            return 4;
+        }
+
+    default:
+        SDK_ASSERT(FALSE);
+        return 0;
+    }
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         STDi_PutChar
+
+  Description:  Encodes a single decoded character and stores it in the destination.
+                The replacement character is used for characters that cannot be converted.
+
+  Arguments:    context:           Conversion context
+                dst:               Conversion destination buffer (NULL to only count)
+                dst_pos:           Current position in dst, updated on success
+                dst_max:           Size of dst
+                c:                 Unicode value, or STDi_CHAR_INVALID
+
+  Returns:      STDi_PUT_SUCCESS, STDi_PUT_FULL if there is no room in dst,
+                or STDi_PUT_FAILED if the character cannot be converted.
+ *---------------------------------------------------------------------------*/
+static int STDi_PutChar(const STDConvertContext *context,
+                        u8 *dst, int *dst_pos, int dst_max, u32 c)
+{
+    u8      tmp[4];
+    int     n = 0;
+    if (c != STDi_CHAR_INVALID)
+    {
+        n = STDi_EncodeChar(context->dst_encoding, tmp, c);
+    }
+    if ((n == 0) && (context->replacement != 0))
+    {
+        n = STDi_EncodeChar(context->dst_encoding, tmp, context->replacement);
+    }
+    if (n == 0)
+    {
+        return STDi_PUT_FAILED;
+    }
+    if (*dst_pos + n > dst_max)
+    {
+        return STDi_PUT_FULL;
+    }
+    if (dst)
+    {
+        int     i;
+        for (i = 0; i < n; ++i)
+        {
+            dst[*dst_pos + i] = tmp[i];
+        }
+    }
+    *dst_pos += n;
+    return STDi_PUT_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         STDi_ScanAsciiBytes
+
+  Description:  Counts the run of ASCII characters at the start of a byte string.
+                Aligned portions are checked a word at a time.
+
+  Arguments:    src:               Source bytes
+                max:               Maximum number of bytes to check
+
+  Returns:      Length of the run.
+ *---------------------------------------------------------------------------*/
+static int STDi_ScanAsciiBytes(const u8 *src, int max)
+{
+    int     n = 0;
+    while ((n < max) && ((((u32)src + n) & 3) != 0))
+    {
+        if (src[n] >= 0x80)
+        {
+            return n;
+        }
+        ++n;
+    }
+    while ((n + 4 <= max) && ((*(const u32 *)(src + n) & 0x80808080) == 0))
+    {
+        n += 4;
+    }
+    while ((n < max) && (src[n] < 0x80))
+    {
+        ++n;
+    }
+    return n;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         STDi_ConvertAsciiRun
+
+  Description:  Converts the run of ASCII characters at the start of the source in bulk.
+
+  Arguments:    context:           Conversion context
+                dst:               Conversion destination buffer (NULL to only count)
+                dst_room:          Free space in dst in bytes
+                src:               Source bytes
+                src_room:          Remaining source bytes
+                src_count:         Receives the number of source bytes consumed
+
+  Returns:      Number of bytes stored in dst.
+ *---------------------------------------------------------------------------*/
+static int STDi_ConvertAsciiRun(const STDConvertContext *context,
+                                u8 *dst, int dst_room, const u8 *src, int src_room,
+                                int *src_count)
+{
+    int     n;
+    if (context->src_encoding != STD_ENCODING_UTF16)
+    {
+        if (context->dst_encoding != STD_ENCODING_UTF16)
+        {
+            /* Byte to byte: the run is copied as is */
+            n = STDi_ScanAsciiBytes(src, MATH_MIN(src_room, dst_room));
+            if (dst && (n > 0))
+            {
+                MI_CpuCopy8(src, dst, (u32)n);
+            }
+            *src_count = n;
+            return n;
+        }
+        else
+        {
+            /* Byte to UTF-16: zero-extend each character */
+            int     i;
+            n = STDi_ScanAsciiBytes(src, MATH_MIN(src_room, dst_room / 2));
+            if (dst)
+            {
+                for (i = 0; i < n; ++i)
+                {
+                    dst[i * 2 + 0] = src[i];
+                    dst[i * 2 + 1] = 0;
+                }
+            }
+            *src_count = n;
+            return n * 2;
+        }
+    }
+    else if (context->dst_encoding != STD_ENCODING_UTF16)
+    {
+        /* UTF-16 to byte: drop the upper byte while it is zero */
+        int     max = MATH_MIN(src_room / 2, dst_room);
+        for (n = 0; n < max; ++n)
+        {
+            if ((src[n * 2 + 0] >= 0x80) || (src[n * 2 + 1] != 0))
+            {
+                break;
+            }
+        }
+        if (dst && (n > 0))
+        {
+            int     i;
+            for (i = 0; i < n; ++i)
+            {
+                dst[i] = src[i * 2];
+            }
+        }
+        *src_count = n * 2;
+        return n;
+    }
+    *src_count = 0;
+    return 0;
+}
+
+#include <nitro/codereset.h>
+
+
+/*****************************************************************************/
+/* Functions */
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_InitConvertContext
+
+  Description:  Initializes a context for streaming character encoding conversion.
+
+  Arguments:    context:           Conversion context
+                src_encoding:      Conversion source encoding
+                dst_encoding:      Conversion destination encoding
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void STD_InitConvertContext(STDConvertContext *context,
+                            STDEncoding src_encoding, STDEncoding dst_encoding)
+{
+    SDK_NULL_ASSERT(context);
+    SDK_ASSERT((src_encoding >= 0) && (src_encoding < STD_ENCODING_MAX));
+    SDK_ASSERT((dst_encoding >= 0) && (dst_encoding < STD_ENCODING_MAX));
+
+    context->src_encoding = src_encoding;
+    context->dst_encoding = dst_encoding;
+    context->replacement = 0;
+    context->pending_len = 0;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_ConvertStream
+
+  Description:  Converts a character string between ShiftJIS, UTF-16 and UTF-8.
+                Input can be passed in arbitrary pieces: a character that is split at the end of
+                src is kept in the context and completed by the next call.
+                Runs of ASCII characters are converted in bulk.
+                Unlike STD_ConvertStringSjisToUnicode, '\0' is converted as an ordinary character.
+
+  Arguments:    context:           Conversion context
+                dst:               Conversion destination buffer
+                                  The storage process is ignored if NULL is specified.
+                dst_len:           Pointer which stores and passes the size of the conversion destination
+                                  buffer in bytes, then receives the number of bytes actually stored.
+                                  Ignored when NULL is given.
+                src:               Conversion source buffer
+                src_len:           Pointer which stores and passes the size of the conversion source
+                                  in bytes, then receives the number of bytes actually consumed.
+                                  If this is smaller than the value passed, the destination buffer is full
+                                  or conversion failed, and the rest should be passed again.
+
+  Returns:      Result of the conversion process.
+ *---------------------------------------------------------------------------*/
+STDResult STD_ConvertStream(STDConvertContext *context,
+                            void *dst, int *dst_len, const void *src, int *src_len)
+{
+    STDResult retval = STD_RESULT_SUCCESS;
+    const u8 *s = (const u8 *)src;
+    u8     *d = (u8 *)dst;
+    int     src_pos = 0;
+    int     dst_pos = 0;
+    int     src_max;
+    int     dst_max;
+
+    if (!context || !src_len || (*src_len < 0) || (!src && (*src_len > 0)))
+    {
+        return STD_RESULT_INVALID_PARAM;
+    }
+    src_max = *src_len;
+    dst_max = (dst && dst_len && (*dst_len >= 0)) ? *dst_len : 0x7FFFFFFF;
+
+    /* First complete the character carried over from the previous call */
+    while (context->pending_len > 0)
+    {
+        u8      tmp[4];
+        int     old_len = context->pending_len;
+        int     add = MATH_MIN(src_max - src_pos, (int)sizeof(tmp) - old_len);
+        int     n;
+        int     i;
+        u32     c;
+
+        for (i = 0; i < old_len; ++i)
+        {
+            tmp[i] = context->pending[i];
+        }
+        for (i = 0; i < add; ++i)
+        {
+            tmp[old_len + i] = s[src_pos + i];
+        }
+        n = STDi_DecodeChar(context->src_encoding, tmp, old_len + add, &c);
+        if (n == 0)
+        {
+            /* Still incomplete; all remaining input is kept for the next call */
+            for (i = 0; i < add; ++i)
+            {
+                context->pending[old_len + i] = tmp[old_len + i];
+            }
+            context->pending_len = old_len + add;
+            src_pos += add;
+            break;
+        }
+        i = STDi_PutChar(context, d, &dst_pos, dst_max, c);
+        if (i != STDi_PUT_SUCCESS)
+        {
+            retval = (i == STDi_PUT_FAILED) ? STD_RESULT_CONVERSION_FAILED : STD_RESULT_SUCCESS;
+            goto end;
+        }
+        if (n >= old_len)
+        {
+            src_pos += n - old_len;
+            context->pending_len = 0;
+        }
+        else
+        {
+            /* A malformed sequence; the rest of the carried bytes are decoded again */
+            for (i = n; i < old_len; ++i)
+            {
+                context->pending[i - n] = context->pending[i];
+            }
+            context->pending_len = old_len - n;
+        }
+    }
+
+    while (src_pos < src_max)
+    {
+        int     n;
+        int     put;
+        u32     c;
+
+        /* Runs of ASCII characters are converted without decoding */
+        if (s[src_pos] < 0x80)
+        {
+            int     count;
+            dst_pos += STDi_ConvertAsciiRun(context, d ? d + dst_pos : NULL, dst_max - dst_pos,
+                                            s + src_pos, src_max - src_pos, &count);
+            src_pos += count;
+            if (src_pos >= src_max)
+            {
+                break;
+            }
+        }
+
+        n = STDi_DecodeChar(context->src_encoding, s + src_pos, src_max - src_pos, &c);
+        if (n == 0)
+        {
+            /* Keep the incomplete character at the end for the next call */
+            int     i;
+            for (i = 0; src_pos < src_max; ++i, ++src_pos)
+            {
+                context->pending[i] = s[src_pos];
+            }
+            context->pending_len = i;
+            break;
+        }
+        put = STDi_PutChar(context, d, &dst_pos, dst_max, c);
+        if (put != STDi_PUT_SUCCESS)
+        {
+            retval = (put == STDi_PUT_FAILED) ? STD_RESULT_CONVERSION_FAILED : STD_RESULT_SUCCESS;
+            break;
+        }
+        src_pos += n;
+    }
+
+  end:
+    /* Returns the number of converted bytes */
+    *src_len = src_pos;
+    if (dst_len)
+    {
+        *dst_len = dst_pos;
+    }
+    return retval;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_FlushConvertStream
+
+  Description:  Ends a stream converted with STD_ConvertStream.
+                If an incomplete character remains in the context, the replacement character
+                is output, or STD_RESULT_CONVERSION_FAILED is returned if none is set.
+                STD_RESULT_ERROR is returned if dst is too small, and the flush can be retried.
+                The context can be used again for a new stream afterwards.
+
+  Arguments:    context:           Conversion context
+                dst:               Conversion destination buffer
+                                  The storage process is ignored if NULL is specified.
+                dst_len:           Pointer which stores and passes the size of the conversion destination
+                                  buffer in bytes, then receives the number of bytes actually stored.
+                                  Ignored when NULL is given.
+
+  Returns:      Result of the conversion process.
+ *---------------------------------------------------------------------------*/
+STDResult STD_FlushConvertStream(STDConvertContext *context, void *dst, int *dst_len)
+{
+    STDResult retval = STD_RESULT_SUCCESS;
+    int     dst_pos = 0;
+    int     dst_max;
+
+    if (!context)
+    {
+        return STD_RESULT_INVALID_PARAM;
+    }
+    dst_max = (dst && dst_len && (*dst_len >= 0)) ? *dst_len : 0x7FFFFFFF;
+
+    if (context->pending_len > 0)
+    {
+        int     put = STDi_PutChar(context, (u8 *)dst, &dst_pos, dst_max, STDi_CHAR_INVALID);
+        if (put == STDi_PUT_FAILED)
+        {
+            retval = STD_RESULT_CONVERSION_FAILED;
+        }
+        else if (put == STDi_PUT_FULL)
+        {
+            /* Leave the context as is so that the flush can be retried */
+            retval = STD_RESULT_ERROR;
+        }
+        if (put != STDi_PUT_FULL)
+        {
+            context->pending_len = 0;
+        }
+    }
+    if (dst_len)
+    {
+        *dst_len = dst_pos;
+    }
+    return retval;
+}
+
+
+#endif // defined(SDK_ARM9) || !defined(SDK_NITRO)
@@ -62,6 +62,11 @@ fx32    FX_GetSqrtResult(void);
 s32     FX_DivS32(s32 a, s32 b);
 s32     FX_ModS32(s32 a, s32 b);
 
+void    FX_DivSqrtArray(const fx32 *numer, const fx32 *denom, fx32 *quot, u32 divNum,
+                        const fx32 *src, fx32 *sqrtDst, u32 sqrtNum);
+SDK_DECL_INLINE void FX_DivArray(const fx32 *numer, const fx32 *denom, fx32 *quot, u32 num);
+SDK_DECL_INLINE void FX_SqrtArray(const fx32 *src, fx32 *dst, u32 num);
+
 #define FX_DIVISION_BY_ZERO(a, b) \
     SDK_WARNING(b != 0, "Division by zero(%d / %d)", a, b)
 
@@ -154,6 +159,41 @@ SDK_INLINE fx32 FX_Mod(fx32 numer, fx32 denom)
     return (fx32)FX_ModS32(numer, denom);
 }
 
+/*---------------------------------------------------------------------------*
+  Name:         FX_DivArray
+
+  Description:  Divides each element of 'numer' by 'denom'.
+                Faster than calling FX_Div for each element, with identical results.
+
+  Arguments:    numer        an array of numerators in fx32 format
+                denom        an array of denominators in fx32 format
+                quot         an array that receives the quotients in fx32 format
+                num          number of elements
+
+  Returns:      none
+ *---------------------------------------------------------------------------*/
+SDK_INLINE void FX_DivArray(const fx32 *numer, const fx32 *denom, fx32 *quot, u32 num)
+{
+    FX_DivSqrtArray(numer, denom, quot, num, NULL, NULL, 0);
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         FX_SqrtArray
+
+  Description:  Returns the square root of each element of 'src'.
+                Faster than calling FX_Sqrt for each element, with identical results.
+
+  Arguments:    src          an array of values in fx32 format
+                dst          an array that receives the results in fx32 format
+                num          number of elements
+
+  Returns:      none
+ *---------------------------------------------------------------------------*/
+SDK_INLINE void FX_SqrtArray(const fx32 *src, fx32 *dst, u32 num)
+{
+    FX_DivSqrtArray(NULL, NULL, NULL, 0, src, dst, num);
+}
+
 #ifdef __cplusplus
 }/* extern "C" */
 #endif
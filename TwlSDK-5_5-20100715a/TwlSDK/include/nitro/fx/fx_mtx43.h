@@ -49,6 +49,8 @@ int     MTX_Inverse43(const MtxFx43 *pSrc, MtxFx43 *pDst);
 void    MTX_Concat43(const MtxFx43 *a, const MtxFx43 *b, MtxFx43 *ab);
 void    MTX_MultVec43(const VecFx32 *vec, const MtxFx43 *m, VecFx32 *dst);
 void    MTX_LookAt(const VecFx32 *camPos, const VecFx32 *camUp, const VecFx32 *target, MtxFx43 *mtx);
+SDK_DECL_INLINE void MTX_MultVec43Array(const VecFx32 *vec, const MtxFx43 *m, VecFx32 *dst, u32 num);
+SDK_DECL_INLINE void MTX_Concat43Array(const MtxFx43 *a, const MtxFx43 *b, MtxFx43 *ab, u32 num);
 
 void    MTX_Identity43_(register MtxFx43 *pDst);
 void    MTX_Copy43To44_(register const MtxFx43 *pSrc, register MtxFx44 *pDst);
@@ -57,6 +59,10 @@ void    MTX_Scale43_(register MtxFx43 *pDst, register fx32 x, register fx32 y, r
 void    MTX_RotX43_(register MtxFx43 *pDst, register fx32 sinVal, register fx32 cosVal);
 void    MTX_RotY43_(register MtxFx43 *pDst, register fx32 sinVal, register fx32 cosVal);
 void    MTX_RotZ43_(register MtxFx43 *pDst, register fx32 sinVal, register fx32 cosVal);
+void    MTX_MultVec43Array_(register const VecFx32 *vec, register const MtxFx43 *m,
+                            register VecFx32 *dst, register u32 num);
+void    MTX_Concat43Array_(register const MtxFx43 *a, register const MtxFx43 *b,
+                           register MtxFx43 *ab, register u32 num);
 
 //----------------------------------------------------------------------------
 // Implementation of inline function
@@ -217,6 +223,50 @@ SDK_INLINE void MTX_RotZ43(MtxFx43 *pDst, fx32 sinVal, fx32 cosVal)
     MTX_RotZ43_(pDst, sinVal, cosVal);
 }
 
+/*---------------------------------------------------------------------------*
+  Name:         MTX_MultVec43Array
+
+  Description:  Multiplies an array of vectors by a 4x3 matrix.
+                vec[i] x m = dst[i]
+                Faster than calling MTX_MultVec43 for each vector, with identical results.
+
+  Arguments:    vec          a pointer to the source vectors
+                m            a pointer to a 4x3 matrix
+                dst          a pointer to the result vectors
+                             OK if dst == vec.
+                num          number of vectors
+  
+  Returns:      none
+ *---------------------------------------------------------------------------*/
+SDK_INLINE void MTX_MultVec43Array(const VecFx32 *vec, const MtxFx43 *m, VecFx32 *dst, u32 num)
+{
+    SDK_NULL_ASSERT(m);
+    SDK_ASSERT(num == 0 || (vec != NULL && dst != NULL));
+    MTX_MultVec43Array_(vec, m, dst, num);
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         MTX_Concat43Array
+
+  Description:  Concatenates pairs of 4x3 matrices.
+                a[i] x b[i] = ab[i]
+                Faster than calling MTX_Concat43 for each pair, with identical results.
+
+  Arguments:    a            a pointer to the array of left-hand matrices
+                b            a pointer to the array of right-hand matrices
+                ab           a pointer to the array of resultant matrices
+                             OK if ab == a. ab must not overlap b.
+                num          number of matrix pairs
+  
+  Returns:      none
+ *---------------------------------------------------------------------------*/
+SDK_INLINE void MTX_Concat43Array(const MtxFx43 *a, const MtxFx43 *b, MtxFx43 *ab, u32 num)
+{
+    SDK_ASSERT(num == 0 || (a != NULL && b != NULL && ab != NULL));
+    SDK_ASSERT(num == 0 || ab + num <= b || b + num <= ab);
+    MTX_Concat43Array_(a, b, ab, num);
+}
+
 
 #ifdef __cplusplus
 }/* extern "C" */
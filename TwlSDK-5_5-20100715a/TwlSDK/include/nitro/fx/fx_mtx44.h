@@ -46,6 +46,7 @@ SDK_DECL_INLINE void MTX_RotY44(MtxFx44 *pDst, fx32 sinVal, fx32 cosVal);
 SDK_DECL_INLINE void MTX_RotZ44(MtxFx44 *pDst, fx32 sinVal, fx32 cosVal);
 void    MTX_RotAxis44(MtxFx44 *pDst, const VecFx32 *vec, fx32 sinVal, fx32 cosVal);
 void    MTX_Concat44(const MtxFx44 *a, const MtxFx44 *b, MtxFx44 *ab);
+SDK_DECL_INLINE void MTX_Concat44Array(const MtxFx44 *a, const MtxFx44 *b, MtxFx44 *ab, u32 num);
 void    MTX_FrustumW(fx32 t, fx32 b, fx32 l, fx32 r, fx32 n, fx32 f, fx32 scaleW, MtxFx44 *mtx);
 void    MTX_PerspectiveW(fx32 fovySin, fx32 fovyCos, fx32 aspect, fx32 n, fx32 f, fx32 scaleW, MtxFx44 *mtx);
 void    MTX_OrthoW(fx32 t, fx32 b, fx32 l, fx32 r, fx32 n, fx32 f, fx32 scaleW, MtxFx44 *mtx);
@@ -58,6 +59,8 @@ void    MTX_Scale44_(register MtxFx44 *pDst, register fx32 x, register fx32 y, r
 void    MTX_RotX44_(register MtxFx44 *pDst, register fx32 sinVal, register fx32 cosVal);
 void    MTX_RotY44_(register MtxFx44 *pDst, register fx32 sinVal, register fx32 cosVal);
 void    MTX_RotZ44_(register MtxFx44 *pDst, register fx32 sinVal, register fx32 cosVal);
+void    MTX_Concat44Array_(register const MtxFx44 *a, register const MtxFx44 *b,
+                           register MtxFx44 *ab, register u32 num);
 
 
 
@@ -225,6 +228,28 @@ SDK_INLINE void MTX_RotZ44(MtxFx44 *pDst, fx32 sinVal, fx32 cosVal)
     MTX_RotZ44_(pDst, sinVal, cosVal);
 }
 
+/*---------------------------------------------------------------------------*
+  Name:         MTX_Concat44Array
+
+  Description:  Concatenates pairs of 4x4 matrices.
+                a[i] x b[i] = ab[i]
+                Faster than calling MTX_Concat44 for each pair, with identical results.
+
+  Arguments:    a            a pointer to the array of left-hand matrices
+                b            a pointer to the array of right-hand matrices
+                ab           a pointer to the array of resultant matrices
+                             OK if ab == a. ab must not overlap b.
+                num          number of matrix pairs
+  
+  Returns:      none
+ *---------------------------------------------------------------------------*/
+SDK_INLINE void MTX_Concat44Array(const MtxFx44 *a, const MtxFx44 *b, MtxFx44 *ab, u32 num)
+{
+    SDK_ASSERT(num == 0 || (a != NULL && b != NULL && ab != NULL));
+    SDK_ASSERT(num == 0 || ab + num <= b || b + num <= ab);
+    MTX_Concat44Array_(a, b, ab, num);
+}
+
 
 /*---------------------------------------------------------------------------*
   Name:         MTX_Frustum
@@ -41,6 +41,7 @@ fx32    VEC_Distance(const VecFx32 *v1, const VecFx32 *v2);
 void    VEC_Normalize(const VecFx32 *pSrc, VecFx32 *pDst);
 void    VEC_MultAdd(fx32 a, const VecFx32 *v1, const VecFx32 *v2, VecFx32 *pDest);
 void    VEC_MultSubtract(fx32 a, const VecFx32 *v1, const VecFx32 *v2, VecFx32 *pDest);
+void    VEC_NormalizeArray(const VecFx32 *pSrc, VecFx32 *pDst, u32 num);
 
 
 void    VEC_Fx16Add(const VecFx16 *a, const VecFx16 *b, VecFx16 *ab);
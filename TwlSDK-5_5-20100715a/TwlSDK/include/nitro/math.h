@@ -21,6 +21,7 @@
 #include <nitro/math/math.h>
 #include <nitro/math/rand.h>
 #include <nitro/math/qsort.h>
+#include <nitro/math/sort.h>
 #include <nitro/math/fft.h>
 
 #include <nitro/math/checksum.h>
@@ -0,0 +1,147 @@
+/*---------------------------------------------------------------------------*
+  Project:  TwlSDK - include
+  File:     sort.h
+
+  Copyright 2003-2008 Nintendo. All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law. They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Date::            $
+  $Rev:$
+  $Author:$
+ *---------------------------------------------------------------------------*/
+
+#ifndef NITRO_MATH_SORT_H_
+#define NITRO_MATH_SORT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <nitro/misc.h>
+#include <nitro/types.h>
+
+/*
+ * Type-specialized sorts.
+ *
+ * Unlike MATH_QSort, these functions do not call a comparison function for each element.
+ * They sort an array of (key, value) pairs by key in ascending order, where the value is an arbitrary payload
+ * such as an index or a pointer to the sprite or polygon that should be drawn.
+ */
+
+/* Element to sort */
+typedef struct MATHSortItem
+{
+    u32     key;                       // Sort key (compared as unsigned)
+    u32     value;                     // Payload carried along with the key
+}
+MATHSortItem;
+
+/* Insertion sort is used for ranges with this many elements or fewer */
+#define MATH_SORT_INSERTION_THRESHOLD   16
+
+/* Size of the count table used by one radix pass */
+#define MATH_RADIX_SORT_BUCKET_NUM      256
+
+/*---------------------------------------------------------------------------*
+  Name:         MATH_SortKeyFromS32
+
+  Description:  Converts a signed value into a key that keeps its ordering when compared as unsigned.
+                Use this to sort values such as fx32 depths that may be negative.
+
+  Arguments:    x:        Signed value
+
+  Returns:      Sort key.
+ *---------------------------------------------------------------------------*/
+static inline u32 MATH_SortKeyFromS32(s32 x)
+{
+    return (u32)x ^ 0x80000000;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         MATH_RadixSortBufferSize
+
+  Description:  Calculates the necessary work buffer size for MATH_RadixSort16 and MATH_RadixSort32.
+
+  Arguments:    num:      Number of data items to sort
+
+  Returns:      Necessary buffer size.
+ *---------------------------------------------------------------------------*/
+static inline u32 MATH_RadixSortBufferSize(u32 num)
+{
+    return (u32)(num * sizeof(MATHSortItem) + MATH_RADIX_SORT_BUCKET_NUM * sizeof(u32));
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         MATH_RadixSort16
+
+  Description:  Sorts by the lower 16 bits of the key with an LSD radix sort.
+                The sort is stable, and processing time is proportional to num.
+                The upper 16 bits of the key are ignored.
+
+  Arguments:    items:    Pointer to the data to sort
+                num:      Number of data items to sort
+                workBuf:  Work buffer of MATH_RadixSortBufferSize(num) bytes. Must be 4-byte aligned.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void    MATH_RadixSort16(MATHSortItem *items, u32 num, void *workBuf);
+
+/*---------------------------------------------------------------------------*
+  Name:         MATH_RadixSort32
+
+  Description:  Sorts by the whole 32-bit key with an LSD radix sort.
+                The sort is stable, and processing time is proportional to num.
+                Passes over bytes that are identical in every key are skipped.
+
+  Arguments:    items:    Pointer to the data to sort
+                num:      Number of data items to sort
+                workBuf:  Work buffer of MATH_RadixSortBufferSize(num) bytes. Must be 4-byte aligned.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void    MATH_RadixSort32(MATHSortItem *items, u32 num, void *workBuf);
+
+/*---------------------------------------------------------------------------*
+  Name:         MATH_IntroSort
+
+  Description:  Sorts by key with an introsort.
+                Quicksort with a median-of-three pivot is used, and ranges that recurse too deeply
+                switch to heapsort, so the worst case is O(n log n).
+                Small ranges are finished with an insertion sort.
+                No work buffer is required. The sort is not stable.
+
+  Arguments:    items:    Pointer to the data to sort
+                num:      Number of data items to sort
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void    MATH_IntroSort(MATHSortItem *items, u32 num);
+
+/*---------------------------------------------------------------------------*
+  Name:         MATH_PartialSort
+
+  Description:  Moves the k items with the smallest keys to the start of the array in ascending order.
+                The order of the remaining items is undefined.
+                Processing time is O(n log k), so this is faster than a full sort when only the
+                first few entries (for example, the nearest objects) are needed.
+
+  Arguments:    items:    Pointer to the data to sort
+                num:      Number of data items
+                k:        Number of items to obtain. If larger than num, all items are sorted.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void    MATH_PartialSort(MATHSortItem *items, u32 num, u32 k);
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+/* NITRO_MATH_SORT_H_ */
+#endif
@@ -313,6 +313,74 @@ extern int STD_TSNPrintf(char *dst, size_t len, const char *fmt, ...);
  *---------------------------------------------------------------------------*/
 extern int STD_TVSNPrintf(char *dst, size_t len, const char *fmt, va_list vlist);
 
+/* One conversion specification parsed by STD_CompileFormat */
+typedef struct STDFormatSpec
+{
+    const char *conv;                  // Position of '%' ('\0' for the terminator)
+    const char *type;                  // Position of the conversion type character
+    int     flag;                      // Internal flags
+    int     width;                     // Minimum field width
+    int     precision;                 // Precision (-1 if not specified)
+}
+STDFormatSpec;
+
+/* Format control string parsed in advance */
+typedef struct STDCompiledFormat
+{
+    const char *fmt;                   // Original format control string
+    const STDFormatSpec *spec;         // Conversion specifications (terminated by an entry whose conv is '\0')
+    int     count;                     // Number of elements in spec
+}
+STDCompiledFormat;
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_CompileFormat
+
+  Description:  Parses a format control string in advance for STD_TVSNPrintfCompiled.
+                Formats that are output repeatedly, such as for a debug display updated every frame,
+                no longer need to be parsed each time.
+
+  Arguments:    compiled      The compiled format that will store the result
+                fmt           Format control string.
+                              It is referenced during output, so it must remain valid while compiled is used.
+                buffer        Array that will store the conversion specifications
+                max           Number of elements in buffer
+
+  Returns:      The number of elements required for buffer (the number of conversion specifications + 1).
+                If this is larger than max, nothing is stored in compiled.
+                Passing NULL and 0 for buffer and max obtains only the required number of elements.
+ *---------------------------------------------------------------------------*/
+extern int STD_CompileFormat(STDCompiledFormat *compiled, const char *fmt, STDFormatSpec *buffer, int max);
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_TSNPrintfCompiled
+
+  Description:  With the exception of the format of the arguments, identical to STD_TVSNPrintfCompiled.
+
+  Arguments:    dst           The buffer that will store the result
+                len           Buffer length
+                compiled      Format compiled by STD_CompileFormat
+
+  Returns:      Identical to STD_TVSNPrintf.
+ *---------------------------------------------------------------------------*/
+extern int STD_TSNPrintfCompiled(char *dst, size_t len, const STDCompiledFormat *compiled, ...);
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_TVSNPrintfCompiled
+
+  Description:  Identical to STD_TVSNPrintf, except that it uses a format that was
+                parsed in advance by STD_CompileFormat.
+                The output is exactly the same as STD_TVSNPrintf with the original format.
+
+  Arguments:    dst           The buffer that will store the result
+                len           Buffer length
+                compiled      Format compiled by STD_CompileFormat
+                vlist         Parameters
+
+  Returns:      Identical to STD_TVSNPrintf.
+ *---------------------------------------------------------------------------*/
+extern int STD_TVSNPrintfCompiled(char *dst, size_t len, const STDCompiledFormat *compiled, va_list vlist);
+
 
 static inline void* STD_CopyMemory(void *destp, const void *srcp, u32 size)
 {
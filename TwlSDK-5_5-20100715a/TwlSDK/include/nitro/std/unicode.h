@@ -43,6 +43,27 @@ typedef STDResult(*STDConvertUnicodeCallback) (u16 *dst, int *dst_len, const cha
                                                int *src_len);
 typedef STDResult(*STDConvertSjisCallback) (char *dst, int *dst_len, const u16 *src, int *src_len);
 
+//---- Character encodings for STD_ConvertStream
+typedef enum STDEncoding
+{
+    STD_ENCODING_SJIS,                 // ShiftJIS
+    STD_ENCODING_UTF16,                // UTF-16 (little endian)
+    STD_ENCODING_UTF8,                 // UTF-8
+    STD_ENCODING_MAX
+}
+STDEncoding;
+
+//---- Streaming conversion context
+typedef struct STDConvertContext
+{
+    STDEncoding src_encoding;          // Conversion source encoding
+    STDEncoding dst_encoding;          // Conversion destination encoding
+    u32     replacement;               // Character output in place of unconvertible characters (0 if none)
+    u8      pending[4];                // Incomplete character carried over to the next call
+    int     pending_len;               // Number of valid bytes in pending
+}
+STDConvertContext;
+
 
 /*****************************************************************************/
 /* Functions */
@@ -180,6 +201,84 @@ SDK_INLINE int STD_ConvertCharUnicodeToSjis(char *dst, u16 src)
     return (ret == STD_RESULT_SUCCESS) ? dst_len : -1;
 }
 
+/*---------------------------------------------------------------------------*
+  Name:         STD_InitConvertContext
+
+  Description:  Initializes a context for streaming character encoding conversion.
+
+  Arguments:    context:           Conversion context
+                src_encoding:      Conversion source encoding
+                dst_encoding:      Conversion destination encoding
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void    STD_InitConvertContext(STDConvertContext *context,
+                               STDEncoding src_encoding, STDEncoding dst_encoding);
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_SetConvertReplacementChar
+
+  Description:  Sets the character that is output in place of characters that cannot be
+                converted or are malformed.
+
+  Arguments:    context:           Conversion context
+                c:                 Unicode value of the replacement character.
+                                  When 0 is specified (the default), the conversion process ends at
+                                  the position of the character that cannot be converted.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+SDK_INLINE void STD_SetConvertReplacementChar(STDConvertContext *context, u32 c)
+{
+    context->replacement = c;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_ConvertStream
+
+  Description:  Converts a character string between ShiftJIS, UTF-16 and UTF-8.
+                Input can be passed in arbitrary pieces: a character that is split at the end of
+                src is kept in the context and completed by the next call.
+                Runs of ASCII characters are converted in bulk.
+                Unlike STD_ConvertStringSjisToUnicode, '\0' is converted as an ordinary character.
+
+  Arguments:    context:           Conversion context
+                dst:               Conversion destination buffer
+                                  The storage process is ignored if NULL is specified.
+                dst_len:           Pointer which stores and passes the size of the conversion destination
+                                  buffer in bytes, then receives the number of bytes actually stored.
+                                  Ignored when NULL is given.
+                src:               Conversion source buffer
+                src_len:           Pointer which stores and passes the size of the conversion source
+                                  in bytes, then receives the number of bytes actually consumed.
+                                  If this is smaller than the value passed, the destination buffer is full
+                                  or conversion failed, and the rest should be passed again.
+
+  Returns:      Result of the conversion process.
+ *---------------------------------------------------------------------------*/
+STDResult STD_ConvertStream(STDConvertContext *context,
+                            void *dst, int *dst_len, const void *src, int *src_len);
+
+/*---------------------------------------------------------------------------*
+  Name:         STD_FlushConvertStream
+
+  Description:  Ends a stream converted with STD_ConvertStream.
+                If an incomplete character remains in the context, the replacement character
+                is output, or STD_RESULT_CONVERSION_FAILED is returned if none is set.
+                STD_RESULT_ERROR is returned if dst is too small, and the flush can be retried.
+                The context can be used again for a new stream afterwards.
+
+  Arguments:    context:           Conversion context
+                dst:               Conversion destination buffer
+                                  The storage process is ignored if NULL is specified.
+                dst_len:           Pointer which stores and passes the size of the conversion destination
+                                  buffer in bytes, then receives the number of bytes actually stored.
+                                  Ignored when NULL is given.
+
+  Returns:      Result of the conversion process.
+ *---------------------------------------------------------------------------*/
+STDResult STD_FlushConvertStream(STDConvertContext *context, void *dst, int *dst_len);
+
 /*---------------------------------------------------------------------------*
   Name:         STDi_GetUnicodeConversionTable
 
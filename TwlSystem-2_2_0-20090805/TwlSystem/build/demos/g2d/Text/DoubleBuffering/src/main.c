@@ -18,14 +18,18 @@
 //      Displays character strings with double buffering ON or OFF.
 //      It always takes time to render a character string, so the display will flicker unless double buffering is used.
 //      
+//      In the TextLayout mode, a string is displayed one character at a time with
+//      NNSG2dTextLayout. Only the characters of the CharCanvas that changed are
+//      rendered again and transferred to VRAM.
 //
 //  Using the Demo
-//      A: Switches between double buffering ON/OFF.
+//      A: Switches between double buffering OFF/ON/TextLayout.
 // ============================================================================
 
 
 #include <nnsys/g2d/g2d_TextCanvas.h>
 #include <nnsys/g2d/g2d_CharCanvas.h>
+#include <nnsys/g2d/g2d_TextLayout.h>
 #include "g2d_textdemolib.h"
 
 
@@ -40,6 +44,20 @@
 
 #define CHARACTER_OFFSET    1       // Starting address for the string to use
 
+#define LAYOUT_MAX_GLYPH    512     // Maximum number of characters placed by the TextLayout
+#define LAYOUT_WAIT         60      // Number of frames the whole string stays displayed
+
+
+// Display modes
+typedef enum DrawMode
+{
+    DRAWMODE_ONSCREEN,      // Renders to VRAM during the VBlank
+    DRAWMODE_OFFSCREEN,     // Renders all the string offscreen and transfers the whole buffer
+    DRAWMODE_TEXTLAYOUT,    // Renders the changed characters offscreen and transfers them
+    DRAWMODE_MAX
+}
+DrawMode;
+
 
 //------------------------------------------------------------------------------
 // Global Variables
@@ -49,7 +67,7 @@ NNSG2dCharCanvas        gOnCanvas;
 NNSG2dTextCanvas        gOnTextCanvas;
 
 // For offscreen display
-#define TRANS_TASK_NUM  1
+#define TRANS_TASK_NUM  32
 NNSG2dCharCanvas        gOffCanvas;
 NNSG2dTextCanvas        gOffTextCanvas;
 
@@ -58,6 +76,9 @@ NNSG2dTextCanvas        gOffTextCanvas;
 GXCharFmt16             gOffBuffer[CANVAS_HEIGHT][CANVAS_WIDTH];
 NNSGfdVramTransferTask  gTrasTask[TRANS_TASK_NUM];
 
+// For TextLayout display
+NNSG2dTextLayout        gTextLayout;
+
 // Shared
 NNSG2dFont              gFont;
 
@@ -184,6 +205,47 @@ static void InitOffScreenCanvas(void)
 
 
 
+/*---------------------------------------------------------------------------*
+  Name:         InitTextLayout
+
+  Description:  Initializes the TextLayout on the offscreen canvas.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void InitTextLayout(void)
+{
+    void* pWork = TXT_Alloc(NNS_G2dTextLayoutGetWorkSize(&gOffTextCanvas, LAYOUT_MAX_GLYPH));
+
+    NNS_G2dTextLayoutInit(
+        &gTextLayout,
+        &gOffTextCanvas,
+        TXT_COLOR_NULL,
+        pWork,
+        LAYOUT_MAX_GLYPH
+    );
+
+    // The line breaks and the character positions are calculated only here.
+    (void)NNS_G2dTextLayoutSetText(
+        &gTextLayout,
+        0, 0,
+        TXT_COLOR_BLACK,
+        CANVAS_WIDTH * 8,
+        "NNSG2dTextLayout keeps the position of each character. "
+        "When the string or the number of visible characters changes, "
+        "only the characters of the CharCanvas under the changed characters "
+        "are cleared and rendered again, and only they are transferred "
+        "to VRAM.\n\n"
+        "abcdefghijklmnopqrstuvwxyz\n"
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ\n"
+        "0123456789"
+    );
+    NNS_G2dTextLayoutSetVisibleCount(&gTextLayout, 0);
+}
+
+
+
 /*---------------------------------------------------------------------------*
   Name:         SampleInit
 
@@ -203,6 +265,9 @@ static void SampleInit(void)
 
     // Initialization for offscreen display
     InitOffScreenCanvas();
+
+    // Initialization for TextLayout display
+    InitTextLayout();
 }
 
 
@@ -252,6 +317,39 @@ static void SampleDraw(NNSG2dTextCanvas *pTextCanvas)
 
 
 
+/*---------------------------------------------------------------------------*
+  Name:         SampleDrawLayout
+
+  Description:  Displays 1 more character of the TextLayout, renders the changed
+                characters and registers their transfer tasks.
+
+  Arguments:    None.
+
+  Returns:      Number of characters of the CharCanvas rendered.
+ *---------------------------------------------------------------------------*/
+static int SampleDrawLayout(void)
+{
+    static int count = 0;
+    const int numGlyph = NNS_G2dTextLayoutGetNumGlyph(&gTextLayout);
+
+    // 1 more character, and all the characters are removed after a while.
+    count++;
+    if( count > numGlyph + LAYOUT_WAIT )
+    {
+        count = 0;
+    }
+    NNS_G2dTextLayoutSetVisibleCount(&gTextLayout, (u16)MATH_IMin(count, numGlyph));
+
+    return NNS_G2dTextLayoutDraw(
+        &gTextLayout,
+        NNS_GfdRegisterNewVramTransferTask,
+        NNS_GFD_DST_2D_BG1_CHAR_MAIN,
+        sizeof(GXCharFmt16) * CHARACTER_OFFSET
+    );
+}
+
+
+
 
 
 //****************************************************************************
@@ -269,7 +367,7 @@ static void SampleDraw(NNSG2dTextCanvas *pTextCanvas)
  *---------------------------------------------------------------------------*/
 void NitroMain(void)
 {
-    BOOL bDoubleBuffering = FALSE;
+    DrawMode mode = DRAWMODE_ONSCREEN;
 
     // Initializing App.
     {
@@ -297,23 +395,43 @@ void NitroMain(void)
         CMN_ReadGamePad();
 
         {
-            // Switches rendering on and off.
+            static const char* const modeName[DRAWMODE_MAX] =
+            {
+                "DoubleBuffering: OFF",
+                "DoubleBuffering: ON",
+                "DoubleBuffering: TextLayout",
+            };
+
+            // Switches the display mode.
             if( CMN_IsTrigger(PAD_BUTTON_A) )
             {
-                bDoubleBuffering = ! bDoubleBuffering;
+                mode = (DrawMode)((mode + 1) % DRAWMODE_MAX);
+
+                // The other modes have overwritten the offscreen buffer and VRAM.
+                if( mode == DRAWMODE_TEXTLAYOUT )
+                {
+                    NNS_G2dTextLayoutInvalidate(&gTextLayout);
+                }
             }
             DTX_PrintLine(
                 "Double Buffering Sample\n"
                 "operation\n"
-                "  A    on/off double buffering\n"
+                "  A    off/on/TextLayout double buffering\n"
             );
-            DTX_PrintLine(bDoubleBuffering ? "DoubleBuffering: ON": "DoubleBuffering: OFF");
+            DTX_PrintLine(modeName[mode]);
         }
 
     //----------------------------------
     // During the LCD display period
 
-        if( bDoubleBuffering )
+        if( mode == DRAWMODE_TEXTLAYOUT )
+        {
+            // Only the changed characters are rendered and transferred.
+            const int numChar = SampleDrawLayout();
+
+            DTX_PrintLine("rendered characters: %3d / %d", numChar, CANVAS_WIDTH * CANVAS_HEIGHT);
+        }
+        else if( mode == DRAWMODE_OFFSCREEN )
         {
             // Rendering is always possible with offscreen display as long as there is no transmission taking place.
             SampleDraw( &gOffTextCanvas );
@@ -340,7 +458,7 @@ void NitroMain(void)
     //----------------------------------
     // During the VBlank period
 
-        if( bDoubleBuffering )
+        if( mode != DRAWMODE_ONSCREEN )
         {
             // The rendered image is transmitted to VRAM during the VBlank with offscreen display.
             NNS_GfdDoVramTransfer();
@@ -0,0 +1,375 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g2d - Text - GlyphCache
+  File:     main.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+// ============================================================================
+//  Explanation of the demo:
+//      This is a sample of the glyph cache of the font and of the glyph raster
+//      cache of the CharCanvas.
+//      The time to measure a ShiftJIS string with and without the glyph cache,
+//      and the time to render it with and without the glyph raster cache,
+//      are displayed on the lower screen.
+//
+//  Using the Demo
+//      None.
+// ============================================================================
+
+
+#include <nnsys/g2d/g2d_TextCanvas.h>
+#include <nnsys/g2d/g2d_CharCanvas.h>
+#include "g2d_textdemolib.h"
+
+
+#define CANVAS_WIDTH        22      // Width of character rendering area (in character units)
+#define CANVAS_HEIGHT       16      // Height of character rendering area (in character units)
+#define CANVAS_LEFT         5       // X position of character drawing area (in characters)
+#define CANVAS_TOP          4       // Y position of character rendering area (in character units)
+
+#define TEXT_HSPACE         1       // Amount of space between characters when rendering strings (in pixels)
+#define TEXT_VSPACE         1       // Line spacing when rendering strings (in pixels)
+
+#define CHARACTER_OFFSET    1       // Starting address for the string to use
+
+#define GLYPH_CACHE_SIZE    64      // Number of glyph cache entries (power of 2)
+#define MEASURE_LOOP        100     // Number of measurements for the benchmark
+#define RASTER_CACHE_SIZE   64      // Number of glyph raster cache entries (power of 2)
+#define DRAW_LOOP           10      // Number of renderings for the benchmark
+
+
+//------------------------------------------------------------------------------
+// Global Variables
+
+NNSG2dFont              gFont;          // Font
+NNSG2dCharCanvas        gCanvas;        // CharCanvas
+NNSG2dTextCanvas        gTextCanvas;    // TextCanvas
+
+NNSG2dGlyphCache        gGlyphCache;                        // Glyph cache
+NNSG2dGlyphCacheEntry   gGlyphCacheEntry[GLYPH_CACHE_SIZE]; // Glyph cache entries
+NNSG2dGlyphRasterCache  gRasterCache;                       // Glyph raster cache
+
+static const char sSampleText[] =
+    "Shift_JIS\n"
+    "0123456789\n"                                              // <- Numerals
+    "abcdefg ABCDEFG\n"                                         // <- Alphabet
+    "\x85\x75\x85\x76\x85\x77\x85\x78\x85\x79\x85\x7A\n"        // <- Western European characters JIS X 0213
+    "\x82\xA0\x82\xA2\x82\xA4\x82\xA6\x82\xA8\x8A\xBF\x8E\x9A";  // <- Japanese characters
+
+
+
+//****************************************************************************
+// Initialize etc.
+//****************************************************************************
+
+/*---------------------------------------------------------------------------*
+  Name:         InitScreen
+
+  Description:  Configures the BG screen.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void InitScreen(void)
+{
+    // Configure BG 1
+    G2_SetBG1Control(
+        GX_BG_SCRSIZE_TEXT_256x256,     // screen size: 256x256
+        GX_BG_COLORMODE_16,             // 16-color color mode
+        GX_BG_SCRBASE_0x0000,           // screen base
+        GX_BG_CHARBASE_0x00000,         // character base
+        GX_BG_EXTPLTT_01                // extended palette slot
+    );
+
+    // Make BG 1 visible
+    CMN_SetPlaneVisible( GX_PLANEMASK_BG1 );
+
+    // Configure color palette
+    GX_LoadBGPltt(TXTColorPalette, 0, sizeof(TXTColorPalette));
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         InitCanvas
+
+  Description:  Initializes the character string render.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void InitCanvas(void)
+{
+    GXCharFmt16* pCharBase = (GXCharFmt16*)G2_GetBG1CharPtr();
+    int cOffset = CHARACTER_OFFSET;
+
+    // Loads the font
+    {
+        void* pFontFile;
+        u32 size;
+
+        size = TXT_LoadFile( &pFontFile, TXT_SJIS_FONTRESOURCE_NAME );
+        NNS_G2D_ASSERT( size > 0 );
+
+        NNS_G2dFontInitShiftJIS(&gFont, pFontFile);
+    }
+
+    // CharCanvas initialization
+    NNS_G2dCharCanvasInitForBG(
+        &gCanvas,
+        pCharBase + cOffset,
+        CANVAS_WIDTH,
+        CANVAS_HEIGHT,
+        NNS_G2D_CHARA_COLORMODE_16
+    );
+
+    // TextCanvas initialization
+    NNS_G2dTextCanvasInit(
+        &gTextCanvas,
+        &gCanvas,
+        &gFont,
+        TEXT_HSPACE,
+        TEXT_VSPACE
+    );
+
+    // Set the screen
+    NNS_G2dMapScrToCharText(
+        G2_GetBG1ScrPtr(),
+        CANVAS_WIDTH,
+        CANVAS_HEIGHT,
+        CANVAS_LEFT,
+        CANVAS_TOP,
+        NNS_G2D_TEXT_BG_WIDTH_256,
+        CHARACTER_OFFSET,
+        TXT_CPALETTE_MAIN
+    );
+}
+
+
+
+//****************************************************************************
+// Benchmark
+//****************************************************************************
+
+/*---------------------------------------------------------------------------*
+  Name:         MeasureText
+
+  Description:  Measures the time to get the size of the sample string.
+
+  Arguments:    None.
+
+  Returns:      Time for MEASURE_LOOP measurements.
+ *---------------------------------------------------------------------------*/
+static OSTick MeasureText(void)
+{
+    OSTick start;
+    int i;
+
+    start = OS_GetTick();
+    for( i = 0; i < MEASURE_LOOP; i++ )
+    {
+        (void)NNSi_G2dFontGetTextRect(&gFont, TEXT_HSPACE, TEXT_VSPACE, sSampleText);
+    }
+
+    return OS_GetTick() - start;
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         DrawSampleText
+
+  Description:  Renders the sample string to the CharCanvas.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void DrawSampleText(void)
+{
+    NNS_G2dCharCanvasClear(&gCanvas, TXT_COLOR_WHITE);
+    NNS_G2dTextCanvasDrawText(&gTextCanvas, 0, 0,
+        TXT_COLOR_BLACK, TXT_DRAWTEXT_FLAG_DEFAULT,
+        sSampleText
+    );
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         MeasureDraw
+
+  Description:  Measures the time to render the sample string.
+
+  Arguments:    None.
+
+  Returns:      Time for DRAW_LOOP renderings.
+ *---------------------------------------------------------------------------*/
+static OSTick MeasureDraw(void)
+{
+    OSTick start;
+    int i;
+
+    start = OS_GetTick();
+    for( i = 0; i < DRAW_LOOP; i++ )
+    {
+        DrawSampleText();
+    }
+
+    return OS_GetTick() - start;
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         PrintGlyphCacheBenchmark
+
+  Description:  Compares the time to get the size of the sample string
+                with and without the glyph cache.
+                The glyph cache is left attached to the font.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void PrintGlyphCacheBenchmark(void)
+{
+    OSTick timeNoCache;
+    OSTick timeCache;
+
+    NNS_G2dFontSetGlyphCache(&gFont, NULL);
+    timeNoCache = MeasureText();
+
+    NNS_G2dGlyphCacheInit(&gGlyphCache, gGlyphCacheEntry, GLYPH_CACHE_SIZE);
+    NNS_G2dFontSetGlyphCache(&gFont, &gGlyphCache);
+    timeCache = MeasureText();
+
+    DTX_PrintLine("NNS_G2dFontGetTextRect x %d", MEASURE_LOOP);
+    DTX_PrintLine("  no cache:    %6ld usec", OS_TicksToMicroSeconds(timeNoCache));
+    DTX_PrintLine("  glyph cache: %6ld usec", OS_TicksToMicroSeconds(timeCache));
+    DTX_PrintLine("  hit: %ld  miss: %ld", gGlyphCache.numHit, gGlyphCache.numMiss);
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         PrintRasterCacheBenchmark
+
+  Description:  Compares the time to render the sample string
+                with and without the glyph raster cache.
+                The glyph raster cache is left attached to the CharCanvas.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void PrintRasterCacheBenchmark(void)
+{
+    OSTick timeDraw;
+    OSTick timeDrawRaster;
+
+    NNS_G2dCharCanvasSetGlyphRasterCache(&gCanvas, NULL);
+    timeDraw = MeasureDraw();
+
+    {
+        void* pBuffer = TXT_Alloc(NNS_G2dGlyphRasterCacheGetBufferSize(&gFont, RASTER_CACHE_SIZE));
+        NNS_G2D_POINTER_ASSERT( pBuffer );
+
+        NNS_G2dGlyphRasterCacheInit(&gRasterCache, &gFont, pBuffer, RASTER_CACHE_SIZE);
+        NNS_G2dCharCanvasSetGlyphRasterCache(&gCanvas, &gRasterCache);
+    }
+    timeDrawRaster = MeasureDraw();
+
+    DTX_PrintLine("");
+    DTX_PrintLine("NNS_G2dTextCanvasDrawText x %d", DRAW_LOOP);
+    DTX_PrintLine("  no cache:     %6ld usec", OS_TicksToMicroSeconds(timeDraw));
+    DTX_PrintLine("  raster cache: %6ld usec", OS_TicksToMicroSeconds(timeDrawRaster));
+    DTX_PrintLine("  hit: %ld  miss: %ld", gRasterCache.numHit, gRasterCache.numMiss);
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         SampleMain
+
+  Description:  Main processing of sample.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void SampleMain(void)
+{
+    InitScreen();
+    InitCanvas();
+
+    if( ! OS_IsTickAvailable() )
+    {
+        OS_InitTick();
+    }
+
+    PrintGlyphCacheBenchmark();
+    PrintRasterCacheBenchmark();
+}
+
+
+
+
+//****************************************************************************
+// Main
+//****************************************************************************
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NitroMain
+
+  Description:  Main function.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NitroMain(void)
+{
+    // Initializing App.
+    {
+        // Initialization of SDK and demo library
+        OS_Init();
+        TXT_Init();
+
+        // Configure the background
+        TXT_SetupBackground();
+
+        // Main process of sample
+        SampleMain();
+    }
+
+    // start display
+    {
+        CMN_WaitVBlankIntr();
+        GX_DispOn();
+        GXS_DispOn();
+    }
+
+    // Main loop
+    while( TRUE )
+    {
+        CMN_ReadGamePad();
+
+        CMN_WaitVBlankIntr();
+
+        // Display the information output
+        DTX_Reflect();
+    }
+}
@@ -0,0 +1,331 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g2d - samples - CellAnimScheduler
+  File:     main.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+// ============================================================================
+//  Explanation of the demo:
+//      Compares the time to update many cell animations
+//          - by calling NNS_G2dTickCellAnimation for each of them, and
+//          - with the cell animation scheduler, which processes only the cell
+//            animations whose animation frame changes.
+//
+//  Using the Demo
+//      None.
+//  Description
+//      Two sets of NUM_OF_CELLANIM cell animations with the same initial state
+//      are updated every frame, one set with each method. Which method runs first
+//      alternates every frame. The average time over AVERAGE_FRAME frames and
+//      the number of cell animations whose animation frame changed are displayed,
+//      and the animation frames of the two sets are compared.
+//      The cell animations are not displayed.
+//
+// ============================================================================
+
+
+#include <nitro.h>
+#include <nnsys/g2d.h>
+
+#include "g2d_demolib.h"
+
+
+//------------------------------------------------------------------------------
+// Constants
+#define NUM_OF_CELLANIM         512                     // Number of cell animations of each set
+#define NUM_OF_SLOT             64                      // Number of wheel slots of the cell animation scheduler
+#define AVERAGE_FRAME           60                      // Number of frames the times are averaged over
+
+//------------------------------------------------------------------------------
+// Global members
+
+// Cell animations updated one by one
+static NNSG2dCellAnimation*     spEachCellAnim = NULL;
+
+// Cell animations updated with the scheduler
+static NNSG2dCellAnimation*     spSchedCellAnim = NULL;
+static NNSG2dCellAnimScheduler  sScheduler;
+
+// Number of cell animations whose animation frame changed in the frame
+static int                      numChangedEach  = 0;
+static int                      numChangedSched = 0;
+
+
+/*---------------------------------------------------------------------------*
+  Name:         CallBackScheduler
+
+  Description:  This function is called back from the cell animation scheduler
+                once per frame with the cell animations whose animation frame changed.
+
+  Arguments:    ppChanged:      Cell animations whose animation frame changed.
+                numChanged:     Number of cell animations.
+                param:          The user parameter specified when the callback function was registered.
+
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void CallBackScheduler( NNSG2dCellAnimation* const* ppChanged, u16 numChanged, u32 param )
+{
+#pragma unused( ppChanged )
+#pragma unused( param )
+
+    numChangedSched += numChanged;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         InitCellAnimSet
+
+  Description:  Initializes a set of cell animations.
+                The animation frames are shifted so that the cell animations
+                do not change at the same time.
+
+  Arguments:    pCellAnim:      Cell animations (NUM_OF_CELLANIM elements).
+                pAnimBank:      Pointer to the cell animation data.
+                pCellBank:      Pointer to the cell data.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void InitCellAnimSet
+(
+    NNSG2dCellAnimation*        pCellAnim,
+    const NNSG2dAnimBankData*   pAnimBank,
+    const NNSG2dCellDataBank*   pCellBank
+)
+{
+    const u16   numSequence = NNS_G2dGetNumAnimSequence( pAnimBank );
+    int         i;
+
+    for( i = 0; i < NUM_OF_CELLANIM; i++ )
+    {
+        const NNSG2dAnimSequence* pSeq = NNS_G2dGetAnimSequenceByIdx( pAnimBank, (u16)(i % numSequence) );
+        SDK_NULL_ASSERT( pSeq );
+
+        NNS_G2dInitCellAnimation( &pCellAnim[i], pSeq, pCellBank );
+
+        NNS_G2dSetCellAnimationCurrentFrame( &pCellAnim[i], (u16)(i % pSeq->numFrames) );
+        NNS_G2dSetAnimCtrlCurrentTime( NNS_G2dGetCellAnimationAnimCtrl( &pCellAnim[i] ),
+                                       (fx32)(i * FX32_ONE / 3) % FX32_ONE );
+    }
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         LoadResources
+
+  Description:  Loads the cell data and the cell animation data, and initializes
+                the two sets of cell animations and the cell animation scheduler.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void LoadResources( void )
+{
+    NNSG2dCellDataBank*     pCellBank = NULL;
+    NNSG2dAnimBankData*     pAnimBank = NULL;
+    void*                   pBuf;
+    int                     i;
+
+    // These pBuf pointers are not deallocated because the data is used until the end.
+    pBuf = G2DDemo_LoadNCER( &pCellBank, "data/CellAnimation.NCER" );
+    SDK_NULL_ASSERT( pBuf );
+    pBuf = G2DDemo_LoadNANR( &pAnimBank, "data/CellAnimation.NANR" );
+    SDK_NULL_ASSERT( pBuf );
+
+    spEachCellAnim  = G2DDemo_Alloc( sizeof( NNSG2dCellAnimation ) * NUM_OF_CELLANIM );
+    spSchedCellAnim = G2DDemo_Alloc( sizeof( NNSG2dCellAnimation ) * NUM_OF_CELLANIM );
+    SDK_NULL_ASSERT( spEachCellAnim );
+    SDK_NULL_ASSERT( spSchedCellAnim );
+
+    InitCellAnimSet( spEachCellAnim,  pAnimBank, pCellBank );
+    InitCellAnimSet( spSchedCellAnim, pAnimBank, pCellBank );
+
+    pBuf = G2DDemo_Alloc( NNS_G2dGetCellAnimSchedulerWorkSize( NUM_OF_CELLANIM, NUM_OF_SLOT ) );
+    SDK_NULL_ASSERT( pBuf );
+
+    NNS_G2dInitCellAnimScheduler( &sScheduler, pBuf, NUM_OF_CELLANIM, NUM_OF_SLOT, FX32_ONE );
+    NNS_G2dSetCellAnimSchedulerCallBack( &sScheduler, CallBackScheduler, 0 );
+
+    for( i = 0; i < NUM_OF_CELLANIM; i++ )
+    {
+        const u16 handle = NNS_G2dAddCellAnimScheduler( &sScheduler, &spSchedCellAnim[i] );
+        SDK_ASSERT( handle != NNS_G2D_CELLANIMSCHEDULER_INVALID_HANDLE );
+    }
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         TickEach
+
+  Description:  Updates the cell animations one by one.
+
+  Arguments:    None.
+
+  Returns:      Time required for the update.
+ *---------------------------------------------------------------------------*/
+static OSTick TickEach( void )
+{
+    OSTick  time = OS_GetTick();
+    int     i;
+
+    numChangedEach = 0;
+    for( i = 0; i < NUM_OF_CELLANIM; i++ )
+    {
+        const NNSG2dAnimFrame* pOldFrame = spEachCellAnim[i].animCtrl.pCurrent;
+
+        NNS_G2dTickCellAnimation( &spEachCellAnim[i], FX32_ONE );
+
+        if( spEachCellAnim[i].animCtrl.pCurrent != pOldFrame )
+        {
+            numChangedEach++;
+        }
+    }
+    return OS_GetTick() - time;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         TickScheduler
+
+  Description:  Updates the cell animations with the cell animation scheduler.
+
+  Arguments:    None.
+
+  Returns:      Time required for the update.
+ *---------------------------------------------------------------------------*/
+static OSTick TickScheduler( void )
+{
+    OSTick  time = OS_GetTick();
+
+    numChangedSched = 0;
+    (void)NNS_G2dTickCellAnimScheduler( &sScheduler );
+
+    return OS_GetTick() - time;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         IsSameFrames
+
+  Description:  Compares the animation frames of the two sets of cell animations.
+
+  Arguments:    None.
+
+  Returns:      TRUE if all the cell animations are at the same animation frame.
+ *---------------------------------------------------------------------------*/
+static BOOL IsSameFrames( void )
+{
+    int i;
+
+    for( i = 0; i < NUM_OF_CELLANIM; i++ )
+    {
+        if( spEachCellAnim[i].animCtrl.pCurrent != spSchedCellAnim[i].animCtrl.pCurrent )
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NitroMain
+
+  Description:  Main function.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NitroMain()
+{
+    // Initialize App.
+    {
+        G2DDemo_CommonInit();
+        G2DDemo_PrintInit();
+        LoadResources();
+
+        // start display
+        SVC_WaitVBlankIntr();
+        GX_DispOn();
+        GXS_DispOn();
+    }
+
+    //----------------------------------------------------
+    // Main loop
+    while( TRUE )
+    {
+        static u32      frame         = 0;      // Frame count
+        static OSTick   sumEach       = 0;      // Total time of the one-by-one updates
+        static OSTick   sumSched      = 0;      // Total time of the scheduler updates
+        static OSTick   aveEach       = 0;      // Average time of the one-by-one updates
+        static OSTick   aveSched      = 0;      // Average time of the scheduler updates
+        static BOOL     bSame         = TRUE;   // Are the two sets at the same animation frames?
+
+        //-------------------------------------------------
+        // Updates the animations.
+        // Alternates the order so that neither method always runs with a cold cache.
+        //
+        {
+            if( frame & 1 )
+            {
+                sumSched += TickScheduler();
+                sumEach  += TickEach();
+            }else{
+                sumEach  += TickEach();
+                sumSched += TickScheduler();
+            }
+
+            bSame = bSame && IsSameFrames();
+            frame++;
+
+            if( frame % AVERAGE_FRAME == 0 )
+            {
+                aveEach  = sumEach  / AVERAGE_FRAME;
+                aveSched = sumSched / AVERAGE_FRAME;
+                sumEach  = 0;
+                sumSched = 0;
+            }
+        }
+
+        //-------------------------------------------------
+        // Debug character string drawing
+        //
+        {
+            G2DDemo_PrintOutf(0, 0, "cell animations: %4d", NUM_OF_CELLANIM);
+            G2DDemo_PrintOutf(0, 2, "each      %3d:%5ld usec",
+                numChangedEach, OS_TicksToMicroSeconds(aveEach) );
+            G2DDemo_PrintOutf(0, 3, "scheduler %3d:%5ld usec",
+                numChangedSched, OS_TicksToMicroSeconds(aveSched) );
+            G2DDemo_PrintOutf(0, 5, "same frames: %s", bSame ? "yes": " no");
+        }
+
+        //-------------------------------------------------
+        // Wait for V-Blank
+        SVC_WaitVBlankIntr();
+
+        //-------------------------------------------------
+        // Writes the debug character string to HW.
+        //
+        G2DDemo_PrintApplyToHW();
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+  Name:         VBlankIntr
+
+  Description:  Handles VBlank interrupts.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void VBlankIntr(void)
+{
+    OS_SetIrqCheckFlag( OS_IE_V_BLANK );                   // Checking VBlank interrupt
+}
@@ -0,0 +1,318 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g2d - samples - OamAffineCache
+  File:     main.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+
+
+// ============================================================================
+//  Explanation of the demo:
+//      Using the affine cache of the OAM manager,
+//      - The OBJs rotated by the same matrix share one affine parameter.
+//        Every OBJ requests its own affine parameter, and the OAM manager returns
+//        the affine index already registered in the frame for the same matrix.
+//      - The number of requests, the number of shared affine parameters and the
+//        number of requests made while the affine parameters were full are displayed.
+//
+//  Using the Demo
+//      A: Increases the number of rotation speeds (different matrices).
+//      B: Decreases the number of rotation speeds.
+//      X: Switches the behavior when the affine parameters are full.
+//         FAIL:    The OBJ is displayed without rotation.
+//         NEAREST: The OBJ uses the registered affine parameter nearest to its matrix.
+// ============================================================================
+
+#include <nitro.h>
+#include <nnsys/g2d.h>
+
+#include "g2d_demolib.h"
+
+// Size of screen
+#define SCREEN_WIDTH            256
+#define SCREEN_HEIGHT           192
+
+#define HW_OAM_USE              128     // Number of HW OAMs to use
+#define HW_AFFINE_USE           32      // Number of HW affine parameters to use
+
+// OBJs arranged on the whole screen
+#define OBJ_SIZE                16
+#define OBJ_INTERVAL            32
+#define NUM_OBJ_X               (SCREEN_WIDTH / OBJ_INTERVAL)
+#define NUM_OBJ_Y               (SCREEN_HEIGHT / OBJ_INTERVAL)
+#define NUM_OBJ                 (NUM_OBJ_X * NUM_OBJ_Y)
+
+#define INIT_NUM_SPEED          8       // Initial number of rotation speeds
+#define ROT_STEP                0x100   // Rotation per frame of the slowest OBJ
+
+// Load address offset for resource
+#define CHARA_BASE              0x0000
+#define PLTT_BASE               0x0000
+
+
+
+//-----------------------------------------------------------------------------
+// Global Variables
+
+static NNSG2dOamManagerInstance     sOamManager;
+static NNSG2dOamAffineCache         sAffineCache;
+
+
+
+//-----------------------------------------------------------------------------
+// Prototype Declarations
+
+static void InitOamManager( void );
+static void SetAffineCache( NNSG2dOamAffineOverflowMode overflowMode );
+static void LoadResources( void );
+void NitroMain( void );
+void VBlankIntr( void );
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         InitOamManager
+
+  Description:  Initializes the OAM manager instance.
+                HW_OAM_USE OBJs are managed with HW_AFFINE_USE affine parameters.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void InitOamManager( void )
+{
+    BOOL bSuccess;
+
+    NNS_G2dInitOamManagerModule();
+
+    bSuccess = NNS_G2dGetNewOamManagerInstanceAsFastTransferMode(
+                    &sOamManager, 0, HW_OAM_USE, NNS_G2D_OAMTYPE_MAIN );
+    SDK_ASSERT( bSuccess );
+    SDK_ASSERT( NNS_G2dGetOamManagerAffineCapacity( &sOamManager ) == HW_AFFINE_USE );
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         SetAffineCache
+
+  Description:  Initializes the affine cache and sets it to the OAM manager instance.
+                Call this between frames.
+
+  Arguments:    overflowMode:   Behavior when the affine parameters are full.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void SetAffineCache( NNSG2dOamAffineOverflowMode overflowMode )
+{
+    // Matrices are compared as the s7.8 affine parameters of the hardware.
+    NNS_G2dInitOamAffineCache( &sAffineCache, 0, overflowMode );
+    NNS_G2dSetOamManagerAffineCache( &sOamManager, &sAffineCache );
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         LoadResources
+
+  Description:  Creates the character and palette data and loads it to the VRAM.
+                The upper half of the OBJ is color 1 and the lower half is color 2,
+                so that the rotation can be seen.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void LoadResources( void )
+{
+    //-------------------------------------------------------------------------
+    // Character data: 16x16 OBJ (2D mapping mode)
+    {
+        static u32  charData[ 8 * 32 * 2 ];     // 2 rows of 32 characters
+
+        MI_CpuFill32( &charData[ 0 ],       0x11111111, sizeof( charData ) / 2 );
+        MI_CpuFill32( &charData[ 8 * 32 ],  0x22222222, sizeof( charData ) / 2 );
+
+        DC_FlushRange( charData, sizeof( charData ) );
+        GX_LoadOBJ( charData, CHARA_BASE, sizeof( charData ) );
+    }
+
+    //-------------------------------------------------------------------------
+    // Palette data
+    {
+        static GXRgb    plttData[ 16 ];
+
+        MI_CpuClear16( plttData, sizeof( plttData ) );
+        plttData[ 1 ] = GX_RGB( 31, 24, 8 );
+        plttData[ 2 ] = GX_RGB( 8, 16, 31 );
+
+        DC_FlushRange( plttData, sizeof( plttData ) );
+        GX_LoadOBJPltt( plttData, PLTT_BASE, sizeof( plttData ) );
+    }
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NitroMain
+
+  Description:  Main function.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NitroMain( void )
+{
+    // Initialize App.
+    {
+        G2DDemo_CommonInit();
+        G2DDemo_PrintInit();
+        LoadResources();
+        InitOamManager();
+        SetAffineCache( NNS_G2D_OAMAFFINE_OVERFLOW_NEAREST );
+    }
+
+    // start display
+    {
+        SVC_WaitVBlankIntr();
+        GX_DispOn();
+        GXS_DispOn();
+    }
+
+
+    // Main loop
+    while( TRUE )
+    {
+        static int      numSpeed        = INIT_NUM_SPEED;
+        static BOOL     bNearest        = TRUE;
+        static u16      rotate          = 0;
+        static OSTick   timeForEntry;
+
+        // Input process
+        {
+            G2DDemo_ReadGamePad();
+
+            if( G2DDEMO_IS_TRIGGER( PAD_BUTTON_A ) && numSpeed < NUM_OBJ )
+            {
+                numSpeed++;
+            }
+            if( G2DDEMO_IS_TRIGGER( PAD_BUTTON_B ) && numSpeed > 1 )
+            {
+                numSpeed--;
+            }
+            if( G2DDEMO_IS_TRIGGER( PAD_BUTTON_X ) )
+            {
+                bNearest = ! bNearest;
+                SetAffineCache( bNearest ? NNS_G2D_OAMAFFINE_OVERFLOW_NEAREST
+                                         : NNS_G2D_OAMAFFINE_OVERFLOW_FAIL );
+            }
+        }
+
+
+        //
+        // Register with OAM manager
+        //
+        {
+            GXOamAttr   oam;
+            BOOL        bSuccess;
+            int         i;
+
+            timeForEntry = OS_GetTick();
+
+            for( i = 0; i < NUM_OBJ; i++ )
+            {
+                const int   speed   = i % numSpeed + 1;
+                const u16   angle   = (u16)( rotate * speed );
+                MtxFx22     mtx;
+                u16         affineIdx;
+
+                MTX_Rot22( &mtx, FX_SinIdx( angle ), FX_CosIdx( angle ) );
+
+                // Each OBJ requests an affine parameter.
+                // The same matrix returns the same affine index.
+                affineIdx = NNS_G2dEntryOamManagerAffine( &sOamManager, &mtx );
+
+                G2_SetOBJAttr( &oam,
+                               ( i % NUM_OBJ_X ) * OBJ_INTERVAL + ( OBJ_INTERVAL - OBJ_SIZE ) / 2,
+                               ( i / NUM_OBJ_X ) * OBJ_INTERVAL + ( OBJ_INTERVAL - OBJ_SIZE ) / 2,
+                               0,
+                               GX_OAM_MODE_NORMAL,
+                               FALSE,
+                               ( affineIdx != NNS_G2D_OAM_AFFINE_IDX_NONE ) ?
+                                    GX_OAM_EFFECT_AFFINE : GX_OAM_EFFECT_NONE,
+                               GX_OAM_SHAPE_16x16,
+                               GX_OAM_COLORMODE_16,
+                               0,
+                               0,
+                               0 );
+
+                bSuccess = NNS_G2dEntryOamManagerOamWithAffineIdx( &sOamManager, &oam, affineIdx );
+                SDK_ASSERT( bSuccess );
+            }
+
+            timeForEntry = OS_GetTick() - timeForEntry;
+        }
+
+
+        // Output display information (statistics of the previous frame)
+        {
+            const NNSG2dOamAffineCacheStats* pStats = NNS_G2dGetOamManagerAffineCacheStats( &sOamManager );
+
+            G2DDemo_PrintOutf( 0, 0, "Rotation speeds:  %4d", numSpeed );
+            G2DDemo_PrintOutf( 0, 1, "When full:       %s", bNearest ? "NEAREST" : "FAIL   " );
+            G2DDemo_PrintOutf( 0, 2, "Requested affine: %4d", pStats->numRequest );
+            G2DDemo_PrintOutf( 0, 3, "Shared affine:    %4d", pStats->numShared );
+            G2DDemo_PrintOutf( 0, 4, "Used affine:      %4d", pStats->numRequest - pStats->numShared
+                                                             - pStats->numOverflow );
+            G2DDemo_PrintOutf( 0, 5, "Overflow:         %4d", pStats->numOverflow );
+            G2DDemo_PrintOutf( 0, 6, "Nearest given:    %4d", pStats->numFallback );
+            G2DDemo_PrintOutf( 0, 7, "Entry:%06ld usec", OS_TicksToMicroSeconds( timeForEntry ) );
+        }
+
+
+        // Wait for V-Blank
+        SVC_WaitVBlankIntr();
+
+
+        //
+        // Write buffer contents to HW
+        //
+        {
+            // Write display information
+            G2DDemo_PrintApplyToHW();
+
+            // Write OBJ and affine parameters
+            // The reset also empties the affine cache for the next frame.
+            NNS_G2dApplyAndResetOamManagerBuffer( &sOamManager );
+        }
+
+        rotate += ROT_STEP;
+    }
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         VBlankIntr
+
+  Description:  Handles VBlank interrupts.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void VBlankIntr( void )
+{
+    OS_SetIrqCheckFlag( OS_IE_V_BLANK );    // Checking VBlank interrupt
+}
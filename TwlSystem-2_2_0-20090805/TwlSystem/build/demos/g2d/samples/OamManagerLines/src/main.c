@@ -0,0 +1,408 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g2d - samples - OamManagerLines
+  File:     main.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+
+
+// ============================================================================
+//  Explanation of the demo:
+//      Using the sort buffer of the OAM manager,
+//      - More than 128 OBJs are displayed by dividing the screen into line ranges.
+//        The first range is applied in the V-Blank and the other ranges
+//        in V-count interrupts.
+//      - The cursor OBJ is registered last, but is displayed in front of the
+//        tiles because it has a smaller sort key.
+//
+//  The main loop resets the OAM manager and registers the OBJs of the next frame
+//  while the ranges of the current frame are still being applied from the interrupt.
+//  The ranges read the snapshot of the sort buffer taken by the first range.
+//
+//  Using the Demo
+//      +Control Pad: Moves the cursor.
+//      A: Increases the number of tile rows.
+//      B: Decreases the number of tile rows.
+//      X: Switches between the line range apply and the apply of all lines.
+//         With the apply of all lines, only 128 OBJs are displayed.
+// ============================================================================
+
+#include <nitro.h>
+#include <nnsys/g2d.h>
+
+#include "g2d_demolib.h"
+
+// Size of screen
+#define SCREEN_WIDTH            256
+#define SCREEN_HEIGHT           192
+
+#define HW_OAM_USE              128     // Number of HW OAMs to use
+
+// Tiles arranged on the whole screen
+#define TILE_SIZE               16
+#define NUM_TILE_X              (SCREEN_WIDTH / TILE_SIZE)
+#define NUM_TILE_Y              (SCREEN_HEIGHT / TILE_SIZE)
+#define INIT_NUM_TILE_Y         NUM_TILE_Y
+
+// Number of OAM attributes that can be registered (tiles and cursor)
+#define NUM_SORT_ENTRY          (NUM_TILE_X * NUM_TILE_Y + 1)
+
+// Sort keys (a smaller key is displayed in front)
+#define SORT_KEY_CURSOR         0
+#define SORT_KEY_TILE           1
+#define NUM_SORT_KEY            2
+
+// Line ranges
+// The OBJs of a range must fit in the manage area (HW_OAM_USE).
+#define NUM_BAND                3
+#define BAND_HEIGHT             (SCREEN_HEIGHT / NUM_BAND)
+
+// Load address offset for resource
+#define CHARA_BASE              0x0000
+#define PLTT_BASE               0x0000
+
+
+
+//-----------------------------------------------------------------------------
+// Global Variables
+
+static NNSG2dOamManagerInstance     sOamManager;
+static NNSG2dOamSortBuffer          sSortBuffer;
+
+// Work memory of the sort buffer
+static u32  sSortBufferWork[
+    ( NUM_SORT_ENTRY * ( sizeof( GXOamAttr ) * 2 + sizeof( u16 ) * 2 )
+      + sizeof( u16 ) * ( NUM_SORT_KEY + 2 ) ) / sizeof( u32 ) + 1 ];
+
+// Next line range applied in the V-count interrupt (NUM_BAND if none)
+static volatile int sNextBand = NUM_BAND;
+
+
+
+//-----------------------------------------------------------------------------
+// Prototype Declarations
+
+static void InitOamManager( void );
+static void LoadResources( void );
+static void ApplyBand( int band );
+static void VCountIntr( void );
+void NitroMain( void );
+void VBlankIntr( void );
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         InitOamManager
+
+  Description:  Initializes the OAM manager instance and sets the sort buffer.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void InitOamManager( void )
+{
+    BOOL bSuccess;
+
+    SDK_ASSERT( NNS_G2dGetOamSortBufferWorkSize( NUM_SORT_ENTRY, NUM_SORT_KEY )
+                <= sizeof( sSortBufferWork ) );
+
+    NNS_G2dInitOamManagerModule();
+
+    bSuccess = NNS_G2dGetNewOamManagerInstanceAsFastTransferMode(
+                    &sOamManager, 0, HW_OAM_USE, NNS_G2D_OAMTYPE_MAIN );
+    SDK_ASSERT( bSuccess );
+
+    // The sort buffer holds more OAM attributes than the manage area.
+    NNS_G2dInitOamSortBuffer( &sSortBuffer, sSortBufferWork, NUM_SORT_ENTRY, NUM_SORT_KEY );
+    NNS_G2dSetOamManagerSortBuffer( &sOamManager, &sSortBuffer );
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         LoadResources
+
+  Description:  Creates the character and palette data and loads it to the VRAM.
+                All tiles use the same solid character with a different palette.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void LoadResources( void )
+{
+    //-------------------------------------------------------------------------
+    // Character data: 16x16 solid OBJ of color 1 (2D mapping mode)
+    {
+        static u32  charData[ 8 * 32 * 2 ];     // 2 rows of 32 characters
+
+        MI_CpuFill32( charData, 0x11111111, sizeof( charData ) );
+
+        DC_FlushRange( charData, sizeof( charData ) );
+        GX_LoadOBJ( charData, CHARA_BASE, sizeof( charData ) );
+    }
+
+    //-------------------------------------------------------------------------
+    // Palette data: color 1 of each palette
+    {
+        static GXRgb    plttData[ 16 * 16 ];
+        int             i;
+
+        MI_CpuClear16( plttData, sizeof( plttData ) );
+        for( i = 0; i < 15; i++ )
+        {
+            plttData[ i * 16 + 1 ] = GX_RGB( 8 + ( i & 0x3 ) * 7, 8 + ( i >> 2 ) * 7, 31 - i * 2 );
+        }
+        plttData[ 15 * 16 + 1 ] = GX_RGB( 31, 31, 31 );    // For the cursor
+
+        DC_FlushRange( plttData, sizeof( plttData ) );
+        GX_LoadOBJPltt( plttData, PLTT_BASE, sizeof( plttData ) );
+    }
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         ApplyBand
+
+  Description:  Applies the OBJs of a line range to the HW OAM.
+
+  Arguments:    band:   Number of the line range.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void ApplyBand( int band )
+{
+    NNS_G2dApplyOamManagerToHWForLines( &sOamManager,
+                                        band * BAND_HEIGHT,
+                                        ( band + 1 ) * BAND_HEIGHT - 1 );
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         VCountIntr
+
+  Description:  Handles V-count interrupts.
+                Applies the next line range on the line before it.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void VCountIntr( void )
+{
+    if( sNextBand < NUM_BAND )
+    {
+        ApplyBand( sNextBand );
+        sNextBand++;
+
+        if( sNextBand < NUM_BAND )
+        {
+            GX_SetVCountEqVal( sNextBand * BAND_HEIGHT - 1 );
+        }
+    }
+
+    OS_SetIrqCheckFlag( OS_IE_V_COUNT );
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NitroMain
+
+  Description:  Main function.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NitroMain( void )
+{
+    // Initialize App.
+    {
+        G2DDemo_CommonInit();
+        G2DDemo_PrintInit();
+        LoadResources();
+        InitOamManager();
+
+        OS_SetIrqFunction( OS_IE_V_COUNT, VCountIntr );
+        (void)OS_EnableIrqMask( OS_IE_V_COUNT );
+        GX_VCountEqIntr( TRUE );
+    }
+
+    // start display
+    {
+        SVC_WaitVBlankIntr();
+        GX_DispOn();
+        GXS_DispOn();
+    }
+
+
+    // Main loop
+    while( TRUE )
+    {
+        static int      cursorX     = SCREEN_WIDTH / 2;
+        static int      cursorY     = SCREEN_HEIGHT / 2;
+        static int      numTileY    = INIT_NUM_TILE_Y;
+        static BOOL     bLines      = TRUE;
+        static u32      frame       = 0;
+        static OSTick   timeForEntry, timeForApply;
+
+        // Input process
+        {
+            G2DDemo_ReadGamePad();
+
+            if( G2DDEMO_IS_PRESS( PAD_KEY_LEFT ) )  cursorX--;
+            if( G2DDEMO_IS_PRESS( PAD_KEY_RIGHT ) ) cursorX++;
+            if( G2DDEMO_IS_PRESS( PAD_KEY_UP ) )    cursorY--;
+            if( G2DDEMO_IS_PRESS( PAD_KEY_DOWN ) )  cursorY++;
+
+            if( G2DDEMO_IS_TRIGGER( PAD_BUTTON_A ) && numTileY < NUM_TILE_Y )
+            {
+                numTileY++;
+            }
+            if( G2DDEMO_IS_TRIGGER( PAD_BUTTON_B ) && numTileY > 0 )
+            {
+                numTileY--;
+            }
+            if( G2DDEMO_IS_TRIGGER( PAD_BUTTON_X ) )
+            {
+                bLines = ! bLines;
+            }
+
+            cursorX = MATH_CLAMP( cursorX, 0, SCREEN_WIDTH - TILE_SIZE );
+            cursorY = MATH_CLAMP( cursorY, 0, SCREEN_HEIGHT - TILE_SIZE );
+        }
+
+
+        //
+        // Register with OAM manager
+        // The ranges of the previous frame may still be applied from the V-count interrupt.
+        //
+        {
+            GXOamAttr   oam;
+            BOOL        bSuccess;
+            int         x, y;
+
+            timeForEntry = OS_GetTick();
+
+            // Tiles
+            for( y = 0; y < numTileY; y++ )
+            {
+                for( x = 0; x < NUM_TILE_X; x++ )
+                {
+                    G2_SetOBJAttr( &oam,
+                                   x * TILE_SIZE,
+                                   y * TILE_SIZE,
+                                   0,
+                                   GX_OAM_MODE_NORMAL,
+                                   FALSE,
+                                   GX_OAM_EFFECT_NONE,
+                                   GX_OAM_SHAPE_16x16,
+                                   GX_OAM_COLORMODE_16,
+                                   0,
+                                   (int)( ( x + y + ( frame >> 3 ) ) % 15 ),
+                                   0 );
+
+                    bSuccess = NNS_G2dEntryOamManagerOamWithSortKey(
+                                    &sOamManager, &oam, NNS_G2D_OAM_AFFINE_IDX_NONE, SORT_KEY_TILE );
+                    SDK_ASSERT( bSuccess );
+                }
+            }
+
+            // The cursor is registered last, and displayed in front by the sort key.
+            G2_SetOBJAttr( &oam,
+                           cursorX,
+                           cursorY,
+                           0,
+                           GX_OAM_MODE_NORMAL,
+                           FALSE,
+                           GX_OAM_EFFECT_NONE,
+                           GX_OAM_SHAPE_16x16,
+                           GX_OAM_COLORMODE_16,
+                           0,
+                           15,
+                           0 );
+            bSuccess = NNS_G2dEntryOamManagerOamWithSortKey(
+                            &sOamManager, &oam, NNS_G2D_OAM_AFFINE_IDX_NONE, SORT_KEY_CURSOR );
+            SDK_ASSERT( bSuccess );
+
+            timeForEntry = OS_GetTick() - timeForEntry;
+        }
+
+
+        // Output display information (statistics of the previous frame)
+        {
+            const NNSG2dOamSortStats* pStats = NNS_G2dGetOamManagerSortStats( &sOamManager );
+
+            G2DDemo_PrintOutf( 0, 0, "Apply:          %s", bLines ? "lines" : "all  " );
+            G2DDemo_PrintOutf( 0, 1, "Number of OBJ:  %4d", pStats->numEntry );
+            G2DDemo_PrintOutf( 0, 2, "Max OBJ/apply:  %4d", pStats->maxApplyOBJ );
+            G2DDemo_PrintOutf( 0, 3, "Not displayed:  %4d", pStats->numApplyOverflow );
+            G2DDemo_PrintOutf( 0, 4, "Entry:%06ld usec", OS_TicksToMicroSeconds( timeForEntry ) );
+            G2DDemo_PrintOutf( 0, 5, "Apply:%06ld usec", OS_TicksToMicroSeconds( timeForApply ) );
+        }
+
+
+        // Wait for V-Blank
+        SVC_WaitVBlankIntr();
+
+
+        //
+        // Write buffer contents to HW
+        //
+        {
+            // Write display information
+            G2DDemo_PrintApplyToHW();
+
+            timeForApply = OS_GetTick();
+            if( bLines )
+            {
+                // The first range takes the snapshot of the sort buffer.
+                // The other ranges are applied in the V-count interrupts.
+                ApplyBand( 0 );
+
+                sNextBand = 1;
+                GX_SetVCountEqVal( BAND_HEIGHT - 1 );
+            }
+            else
+            {
+                sNextBand = NUM_BAND;
+                NNS_G2dApplyOamManagerToHW( &sOamManager );
+            }
+            timeForApply = OS_GetTick() - timeForApply;
+
+            // The ranges of this frame still read the snapshot after the reset.
+            NNS_G2dResetOamManagerBuffer( &sOamManager );
+        }
+
+        frame++;
+    }
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         VBlankIntr
+
+  Description:  Handles VBlank interrupts.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void VBlankIntr( void )
+{
+    OS_SetIrqCheckFlag( OS_IE_V_BLANK );    // Checking VBlank interrupt
+}
@@ -18,10 +18,15 @@
 //      This sample performs dual-screen display (the upper screen and the touch screen) using the renderer module.
 //
 //      A visibility culling function is set for the renderer in order to avoid unnecessary rendering of cells outside of each screen.
+//      The number of cells rendered and culled is displayed.
+//
+//      The cells can also be rendered at once with NNS_G2dDrawCellAnimationBatch().
 //
 //  Using the Demo
 //      START Button: Switches the cell output method between the object and the software sprite.
 //                      
+//      SELECT Button: Switches between NNS_G2dDrawCellAnimation() and NNS_G2dDrawCellAnimationBatch().
+//                      
 //      X Button: Resets the cell and surface positions.
 //      +Control Pad: Moves the cell.
 //      Y Button + Control Pad: Moves the main surface.
@@ -57,6 +62,8 @@
 static const NNSG2dFVec2 CELL_B_POS = {100 << FX32_SHIFT, 120 << FX32_SHIFT};
 static const NNSG2dFVec2 CELL_C_POS = {100 << FX32_SHIFT, 300 << FX32_SHIFT};
 
+#define NUM_OF_CELL                 3                   // Number of cells rendered
+
 
 //------------------------------------------------------------------------------
 // Structure definitions
@@ -588,6 +595,7 @@ void NitroMain(void)
     while( TRUE )
     {
         static NNSG2dFVec2 cellAPos = CELL_A_INIT_POS;  // Cell A drawing position
+        static BOOL        bBatch   = FALSE;            // Render with NNS_G2dDrawCellAnimationBatch?
 
 
         // Read input and update cell and surface positions and main screen output method.
@@ -597,12 +605,32 @@ void NitroMain(void)
                 &(mainSurface.type),
                 &(mainSurface.viewRect.posTopLeft),
                 &(subSurface.viewRect.posTopLeft));
+            
+            if( G2DDEMO_IS_TRIGGER(PAD_BUTTON_SELECT) )
+            {
+                bBatch = !bBatch;
+            }
         }
 
         // Render
         //
         // Render cell using Renderer module
         //
+        if( bBatch )
+        {
+            // Cell A, B, C: Rendered to each surface at once.
+            const NNSG2dCellAnimation*  cellAnims[NUM_OF_CELL];
+            NNSG2dFVec2                 cellPos[NUM_OF_CELL];
+            
+            cellAnims[0] = spCellAnim;  cellPos[0] = cellAPos;
+            cellAnims[1] = spCellAnim;  cellPos[1] = CELL_B_POS;
+            cellAnims[2] = spCellAnim;  cellPos[2] = CELL_C_POS;
+            
+            NNS_G2dBeginRendering( &render );
+                NNS_G2dDrawCellAnimationBatch( cellAnims, cellPos, NUM_OF_CELL );
+            NNS_G2dEndRendering();
+        }
+        else
         {
             NNS_G2dBeginRendering( &render );
                 // Cell A: Default displays in main screen. Can be moved using key.
@@ -627,6 +655,8 @@ void NitroMain(void)
 
         // Output display information
         {
+            const NNSG2dRendererCullingStats* pStats = NNS_G2dGetRendererCullingStats( &render );
+
             G2DDemo_PrintOutf(0, 0, "cell pos: (%3d, %3d)",
                 cellAPos.x >> FX32_SHIFT, cellAPos.y >> FX32_SHIFT);
             G2DDemo_PrintOut(0, 1, "main surface:");
@@ -634,6 +664,9 @@ void NitroMain(void)
             G2DDemo_PrintOut(0, 3, "sub surface:");
             PrintSurfaceRect(1, 4, &subSurface);
 
+            G2DDemo_PrintOutf(0, 21, "drawn:%2ld culled:%2ld",
+                pStats->numCellDrawn, pStats->numCellCulled);
+            G2DDemo_PrintOut(0, 22, bBatch ? "Batch ": "Single");
             G2DDemo_PrintOut(0, 23, (mainSurface.type == NNS_G2D_SURFACETYPE_MAIN2D) ?
                    "OBJ           ": "SoftwareSprite");
         }
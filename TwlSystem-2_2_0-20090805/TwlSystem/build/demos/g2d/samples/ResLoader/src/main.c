@@ -0,0 +1,404 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g2d - samples - ResLoader
+  File:     main.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+// ============================================================================
+//  Explanation of the demo:
+//      Compares the time to load a set of resource files
+//          - one by one: each file is read from the ROM and then unpacked, and
+//          - with the resource loader (NNSG2dResLoader): the next file is read
+//            from the ROM on a worker thread while the current one is unpacked.
+//
+//  Using the Demo
+//      None.
+//  Description
+//      The resource files of the MultiCellAnimation sample are loaded once with
+//      each method every frame. Which method runs first alternates every frame.
+//      Both methods load into a new frame heap created over the same arena and
+//      unpack with the same NNS_G2dGetUnpacked* functions, so only the overlap
+//      of the ROM reads and the unpacking differs.
+//      The average times over AVERAGE_FRAME frames are displayed.
+//
+// ============================================================================
+
+
+#include <nitro.h>
+#include <nnsys/g2d.h>
+
+#include "g2d_demolib.h"
+
+
+//------------------------------------------------------------------------------
+// Constants
+#define NUM_OF_LOAD_FILE        6                   // Number of resource files loaded
+#define LOADER_STACK_SIZE       2048                // Stack size of the resource loader thread
+#define LOADER_THREAD_PRIO      (OS_THREAD_LAUNCHER_PRIORITY + 4) // Lower than the main thread
+#define LOADER_ARENA_SIZE       (64 * 1024)         // Size of the arena the files are loaded into
+#define AVERAGE_FRAME           16                  // Number of frames the times are averaged over
+
+//------------------------------------------------------------------------------
+// Types
+
+//
+// Statistics of one load
+//
+typedef struct LoadStats
+{
+    OSTick      tickTotal;      // Time to load all the files
+    OSTick      tickRead;       // Time spent waiting for ROM reads
+    OSTick      tickUnpack;     // Time spent unpacking
+    u32         szTotal;        // Bytes read
+
+}LoadStats;
+
+//------------------------------------------------------------------------------
+// Global members
+
+static const char* loadFileName[NUM_OF_LOAD_FILE] =
+{
+    "data/MultiCellAnimation.NCER",
+    "data/MultiCellAnimation.NANR",
+    "data/MultiCellAnimation.NMCR",
+    "data/MultiCellAnimation.NMAR",
+    "data/MultiCellAnimation.NCGR",
+    "data/MultiCellAnimation.NCLR"
+};
+
+static const NNSG2dResType loadResType[NUM_OF_LOAD_FILE] =
+{
+    NNS_G2D_RESTYPE_CELLBANK,
+    NNS_G2D_RESTYPE_ANIMBANK,
+    NNS_G2D_RESTYPE_MULTICELLBANK,
+    NNS_G2D_RESTYPE_MCANIMBANK,
+    NNS_G2D_RESTYPE_CHARACTER,
+    NNS_G2D_RESTYPE_PALETTE
+};
+
+static void*                    pArena = NULL;                          // Arena the files are loaded into
+static NNSG2dResLoader          resLoader;                              // Resource loader
+static u64                      resLoaderStack[LOADER_STACK_SIZE / sizeof(u64)];
+
+
+/*---------------------------------------------------------------------------*
+  Name:         UnpackRes
+
+  Description:  Unpacks a file image with the NNS_G2dGetUnpacked* function
+                of its resource type.
+
+  Arguments:    pFile:          File image.
+                type:           Resource type.
+
+  Returns:      TRUE if the file was unpacked successfully.
+ *---------------------------------------------------------------------------*/
+static BOOL UnpackRes( void* pFile, NNSG2dResType type )
+{
+    switch( type )
+    {
+    case NNS_G2D_RESTYPE_CHARACTER:
+        {
+            NNSG2dCharacterData* pRes;
+            return NNS_G2dGetUnpackedCharacterData( pFile, &pRes );
+        }
+    case NNS_G2D_RESTYPE_PALETTE:
+        {
+            NNSG2dPaletteData* pRes;
+            return NNS_G2dGetUnpackedPaletteData( pFile, &pRes );
+        }
+    case NNS_G2D_RESTYPE_CELLBANK:
+        {
+            NNSG2dCellDataBank* pRes;
+            return NNS_G2dGetUnpackedCellBank( pFile, &pRes );
+        }
+    case NNS_G2D_RESTYPE_ANIMBANK:
+        {
+            NNSG2dCellAnimBankData* pRes;
+            return NNS_G2dGetUnpackedAnimBank( pFile, &pRes );
+        }
+    case NNS_G2D_RESTYPE_MULTICELLBANK:
+        {
+            NNSG2dMultiCellDataBank* pRes;
+            return NNS_G2dGetUnpackedMultiCellBank( pFile, &pRes );
+        }
+    case NNS_G2D_RESTYPE_MCANIMBANK:
+        {
+            NNSG2dMultiCellAnimBankData* pRes;
+            return NNS_G2dGetUnpackedMCAnimBank( pFile, &pRes );
+        }
+    default:
+        SDK_ASSERTMSG( FALSE, "Unsupported resource type." );
+        return FALSE;
+    }
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         LoadSerial
+
+  Description:  Loads the resource files one by one: each file is read from
+                the ROM and then unpacked.
+
+  Arguments:    pAllocator:     Arena the files are loaded into.
+                pStats:         [OUT] Statistics of the load.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void LoadSerial( NNSFndAllocator* pAllocator, LoadStats* pStats )
+{
+    const OSTick    tickStart = OS_GetTick();
+    FSFile          file;
+    int             i;
+
+    pStats->tickRead    = 0;
+    pStats->tickUnpack  = 0;
+    pStats->szTotal     = 0;
+
+    for( i = 0; i < NUM_OF_LOAD_FILE; i++ )
+    {
+        OSTick  tick;
+        u32     szFile;
+        void*   pBuf;
+        BOOL    bSuccess;
+
+        tick = OS_GetTick();
+        FS_InitFile( &file );
+        bSuccess = FS_OpenFile( &file, loadFileName[i] );
+        SDK_ASSERT( bSuccess );
+
+        szFile  = FS_GetLength( &file );
+        pBuf    = NNS_FndAllocFromAllocator( pAllocator, szFile );
+        SDK_NULL_ASSERT( pBuf );
+
+        bSuccess = ( FS_ReadFile( &file, pBuf, (s32)szFile ) == (s32)szFile );
+        SDK_ASSERT( bSuccess );
+        (void)FS_CloseFile( &file );
+        pStats->tickRead += OS_GetTick() - tick;
+        pStats->szTotal  += szFile;
+
+        tick = OS_GetTick();
+        bSuccess = UnpackRes( pBuf, loadResType[i] );
+        SDK_ASSERT( bSuccess );
+        pStats->tickUnpack += OS_GetTick() - tick;
+    }
+
+    pStats->tickTotal = OS_GetTick() - tickStart;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         LoadBatch
+
+  Description:  Loads the resource files in a batch with the resource loader.
+
+  Arguments:    pAllocator:     Arena the files are loaded into.
+                pStats:         [OUT] Statistics of the load.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void LoadBatch( NNSFndAllocator* pAllocator, LoadStats* pStats )
+{
+    NNSG2dResLoadEntry      entry[NUM_OF_LOAD_FILE];
+    BOOL                    bSuccess;
+    int                     i;
+
+    for( i = 0; i < NUM_OF_LOAD_FILE; i++ )
+    {
+        entry[i].pFname = loadFileName[i];
+        entry[i].type   = loadResType[i];
+    }
+
+    NNS_G2dStartResLoader( &resLoader, entry, NUM_OF_LOAD_FILE, pAllocator );
+
+    // The main thread sleeps until the loader thread finishes.
+    // In a game, the main thread goes on and checks NNS_G2dIsResLoaderBusy.
+    bSuccess = NNS_G2dWaitResLoader( &resLoader );
+    SDK_ASSERT( bSuccess );
+
+    pStats->tickTotal   = resLoader.tickTotal;
+    pStats->tickRead    = resLoader.tickWaitRead;
+    pStats->tickUnpack  = resLoader.tickUnpack;
+    pStats->szTotal     = resLoader.szTotal;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         MeasureLoad
+
+  Description:  Creates a frame heap over the arena, loads the resource files
+                into it with the specified method and frees them at once
+                by destroying the frame heap.
+
+  Arguments:    pLoadFunc:      Load method (LoadSerial or LoadBatch).
+                pSum:           [IN/OUT] Statistics the result is added to.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void MeasureLoad
+(
+    void                (*pLoadFunc)( NNSFndAllocator*, LoadStats* ),
+    LoadStats*          pSum
+)
+{
+    NNSFndHeapHandle    hFrmHeap;
+    NNSFndAllocator     allocator;
+    LoadStats           stats;
+
+    // 32-byte alignment for faster ROM reads
+    hFrmHeap = NNS_FndCreateFrmHeap( pArena, LOADER_ARENA_SIZE );
+    SDK_ASSERT( hFrmHeap != NNS_FND_HEAP_INVALID_HANDLE );
+    NNS_FndInitAllocatorForFrmHeap( &allocator, hFrmHeap, 32 );
+
+    (*pLoadFunc)( &allocator, &stats );
+
+    NNS_FndDestroyFrmHeap( hFrmHeap );
+
+    pSum->tickTotal     += stats.tickTotal;
+    pSum->tickRead      += stats.tickRead;
+    pSum->tickUnpack    += stats.tickUnpack;
+    pSum->szTotal        = stats.szTotal;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         AverageStats
+
+  Description:  Averages the statistics summed over AVERAGE_FRAME frames
+                and clears the sum.
+
+  Arguments:    pAve:           [OUT] Average.
+                pSum:           [IN/OUT] Sum.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void AverageStats( LoadStats* pAve, LoadStats* pSum )
+{
+    pAve->tickTotal     = pSum->tickTotal  / AVERAGE_FRAME;
+    pAve->tickRead      = pSum->tickRead   / AVERAGE_FRAME;
+    pAve->tickUnpack    = pSum->tickUnpack / AVERAGE_FRAME;
+    pAve->szTotal       = pSum->szTotal;
+
+    MI_CpuClear32( pSum, sizeof( LoadStats ) );
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         PrintStats
+
+  Description:  Displays the statistics of a load method.
+
+  Arguments:    y:              Display line.
+                pName:          Name of the load method.
+                pStats:         Statistics.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void PrintStats( int y, const char* pName, const LoadStats* pStats )
+{
+    G2DDemo_PrintOutf( 0, y,     "%s", pName );
+    G2DDemo_PrintOutf( 0, y + 1, " Total  :%06ld usec", OS_TicksToMicroSeconds(pStats->tickTotal) );
+    G2DDemo_PrintOutf( 0, y + 2, " Read   :%06ld usec", OS_TicksToMicroSeconds(pStats->tickRead) );
+    G2DDemo_PrintOutf( 0, y + 3, " Unpack :%06ld usec", OS_TicksToMicroSeconds(pStats->tickUnpack) );
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NitroMain
+
+  Description:  Main function.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NitroMain()
+{
+    // Initialize App.
+    {
+        G2DDemo_CommonInit();
+        G2DDemo_PrintInit();
+
+        pArena = G2DDemo_Alloc( LOADER_ARENA_SIZE );
+        SDK_NULL_ASSERT( pArena );
+
+        NNS_G2dInitResLoader( &resLoader,
+                              resLoaderStack,
+                              sizeof(resLoaderStack),
+                              LOADER_THREAD_PRIO );
+
+        // start display
+        SVC_WaitVBlankIntr();
+        GX_DispOn();
+        GXS_DispOn();
+    }
+
+    //----------------------------------------------------
+    // Main loop
+    while( TRUE )
+    {
+        static u32          frame   = 0;        // Frame count
+        static LoadStats    sumSerial;          // Total of the one-by-one loads
+        static LoadStats    sumBatch;           // Total of the batch loads
+        static LoadStats    aveSerial;          // Average of the one-by-one loads
+        static LoadStats    aveBatch;           // Average of the batch loads
+
+        //-------------------------------------------------
+        // Loads the resource files.
+        // Alternates the order so that neither method always runs first.
+        //
+        {
+            if( frame & 1 )
+            {
+                MeasureLoad( LoadBatch,  &sumBatch );
+                MeasureLoad( LoadSerial, &sumSerial );
+            }else{
+                MeasureLoad( LoadSerial, &sumSerial );
+                MeasureLoad( LoadBatch,  &sumBatch );
+            }
+
+            frame++;
+
+            if( frame % AVERAGE_FRAME == 0 )
+            {
+                AverageStats( &aveSerial, &sumSerial );
+                AverageStats( &aveBatch,  &sumBatch );
+            }
+        }
+
+        //-------------------------------------------------
+        // Debug character string drawing
+        //
+        {
+            G2DDemo_PrintOutf( 0, 0, "files: %d  size: %06ld byte", NUM_OF_LOAD_FILE, aveBatch.szTotal );
+            PrintStats( 2, "one by one", &aveSerial );
+            PrintStats( 7, "resource loader", &aveBatch );
+        }
+
+        //-------------------------------------------------
+        // Wait for V-Blank
+        SVC_WaitVBlankIntr();
+
+        //-------------------------------------------------
+        // Writes the debug character string to HW.
+        //
+        G2DDemo_PrintApplyToHW();
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+  Name:         VBlankIntr
+
+  Description:  Handles VBlank interrupts.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void VBlankIntr(void)
+{
+    OS_SetIrqCheckFlag( OS_IE_V_BLANK );                   // Checking VBlank interrupt
+}
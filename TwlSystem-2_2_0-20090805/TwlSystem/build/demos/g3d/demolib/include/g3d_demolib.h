@@ -42,6 +42,7 @@ extern "C" {
 #include "g3d_demolib/graphics.h"
 #include "g3d_demolib/print.h"
 #include "g3d_demolib/font.h"
+#include "g3d_demolib/sample.h"
 
 #ifdef __cplusplus
 }/* extern "C" */
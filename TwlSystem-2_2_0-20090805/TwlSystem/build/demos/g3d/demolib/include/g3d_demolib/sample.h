@@ -0,0 +1,61 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g3d - demolib - include - g3d_demolib
+  File:     sample.h
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#ifndef NNS_G3DDEMO_SAMPLE_H_
+#define NNS_G3DDEMO_SAMPLE_H_
+
+#include <nitro.h>
+#include <nnsys/fnd.h>
+#include <nnsys/g3d.h>
+
+#include "g3d_demolib/camera.h"
+#include "g3d_demolib/graphics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*---------------------------------------------------------------------------*
+	Setup shared by the samples
+
+	The samples load their models from the shared data directory
+	(build/demos/g3d/samples/data), which is the data directory of the ROM.
+ *---------------------------------------------------------------------------*/
+
+void G3DDemo_InitSample(NNSFndAllocator* allocator);
+void G3DDemo_InitFrmVramManager(void);
+
+NNSG3dResFileHeader* G3DDemo_LoadG3DFile(const char* path);
+NNSG3dResMdl*        G3DDemo_LoadG3DModel(const char* path);
+void*                G3DDemo_LoadG3DAnm(const char* path);
+
+
+/*---------------------------------------------------------------------------*
+	Rendering
+
+ *---------------------------------------------------------------------------*/
+
+void G3DDemo_SetCamera(const G3DDemoCamera* camera);
+void G3DDemo_BeginScene(G3DDemoCamera* camera);
+void G3DDemo_DrawSceneGround(G3DDemoGround* ground);
+
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif
+
+// NNS_G3DDEMO_SAMPLE_H_
+#endif
@@ -0,0 +1,209 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g3d - demolib
+  File:     sample.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#include "g3d_demolib/sample.h"
+#include "g3d_demolib/system.h"
+
+
+/*---------------------------------------------------------------------------*
+  Name:         G3DDemo_InitSample
+
+  Description:  Initializes the system, the memory, the VRAM, the G3D library
+                and the display, and creates an allocator with 4-byte alignment
+                from the application heap.
+
+  Arguments:    allocator:  Allocator to initialize.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void
+G3DDemo_InitSample(NNSFndAllocator* allocator)
+{
+    SDK_NULL_ASSERT(allocator);
+
+    G3DDemo_InitSystem();
+    G3DDemo_InitMemory();
+    G3DDemo_InitVRAM();
+
+    // Performs default initialization of G3D.
+    NNS_G3dInit();
+    G3DDemo_InitDisplay();
+
+    NNS_FndInitAllocatorForExpHeap(allocator, G3DDemo_AppHeap, 4);
+}
+
+
+/*---------------------------------------------------------------------------*
+  Name:         G3DDemo_InitFrmVramManager
+
+  Description:  Sets frame VRAM managers as the default managers:
+                4 slots of texture image and 32 KB of palettes.
+
+  Arguments:    None.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void
+G3DDemo_InitFrmVramManager(void)
+{
+    NNS_GfdInitFrmTexVramManager(4, TRUE);
+    NNS_GfdInitFrmPlttVramManager(0x8000, TRUE);
+}
+
+
+/*---------------------------------------------------------------------------*
+  Name:         G3DDemo_LoadG3DFile
+
+  Description:  Loads a G3D resource file, without loading the textures to VRAM.
+
+  Arguments:    path:       Path name of the file.
+
+  Returns:      Pointer to the file.
+ *---------------------------------------------------------------------------*/
+NNSG3dResFileHeader*
+G3DDemo_LoadG3DFile(const char* path)
+{
+    NNSG3dResFileHeader* resFile = G3DDemo_LoadFile(path);
+    SDK_ASSERTMSG(resFile, "load failed");
+
+    // To use DMA transfers within functions like NNS_G3dResDefaultSetup and NNS_G3dDraw,
+    // all model resources have to be stored in memory before calling those functions.
+    DC_StoreRange(resFile, resFile->fileSize);
+
+    return resFile;
+}
+
+
+/*---------------------------------------------------------------------------*
+  Name:         G3DDemo_LoadG3DModel
+
+  Description:  Loads model data from file and loads its textures to VRAM
+                with the default VRAM managers.
+
+  Arguments:    path:       Model data path name.
+
+  Returns:      Pointer to the first model of the file.
+ *---------------------------------------------------------------------------*/
+NNSG3dResMdl*
+G3DDemo_LoadG3DModel(const char* path)
+{
+    NNSG3dResFileHeader* resFile = G3DDemo_LoadG3DFile(path);
+    NNSG3dResMdl*        model;
+    BOOL                 status;
+
+    status = NNS_G3dResDefaultSetup(resFile);
+    NNS_G3D_ASSERTMSG(status, "NNS_G3dResDefaultSetup failed");
+
+    model = NNS_G3dGetMdlByIdx(NNS_G3dGetMdlSet(resFile), 0);
+    SDK_ASSERTMSG(model, "load failed");
+
+    return model;
+}
+
+
+/*---------------------------------------------------------------------------*
+  Name:         G3DDemo_LoadG3DAnm
+
+  Description:  Loads animation data from file.
+
+  Arguments:    path:       Animation data path name.
+
+  Returns:      Pointer to the first animation of the file.
+ *---------------------------------------------------------------------------*/
+void*
+G3DDemo_LoadG3DAnm(const char* path)
+{
+    void*     pAnmRes;
+    const u8* pFile = G3DDemo_LoadFile(path);
+    SDK_ASSERTMSG(pFile, "anm load failed");
+
+    pAnmRes = NNS_G3dGetAnmByIdx(pFile, 0);
+    SDK_NULL_ASSERT(pAnmRes);
+
+    return pAnmRes;
+}
+
+
+/*---------------------------------------------------------------------------*
+  Name:         G3DDemo_SetCamera
+
+  Description:  Sets camera matrix and projection matrix in G3D global state.
+
+  Arguments:    camera:     Pointer to the G3DDemoCamera structure.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void
+G3DDemo_SetCamera(const G3DDemoCamera* camera)
+{
+    const G3DDemoLookAt* lookat = &camera->lookat;
+    const G3DDemoPersp*  persp  = &camera->persp;
+
+    NNS_G3dGlbPerspective(persp->fovySin, persp->fovyCos, persp->aspect, persp->nearClip, persp->farClip);
+    NNS_G3dGlbLookAt(&lookat->camPos, &lookat->camUp, &lookat->target);
+}
+
+
+/*---------------------------------------------------------------------------*
+  Name:         G3DDemo_BeginScene
+
+  Description:  Moves the camera with the GamePad, resets the geometry engine
+                and sets the camera in G3D global state.
+                Call it after G3DDemo_ReadGamePad.
+
+  Arguments:    camera:     Pointer to the G3DDemoCamera structure.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void
+G3DDemo_BeginScene(G3DDemoCamera* camera)
+{
+    G3DDemo_MoveCamera(camera);
+    G3DDemo_CalcCamera(camera);
+
+    G3X_Reset();
+    G3X_ResetMtxStack();
+
+    G3DDemo_SetCamera(camera);
+}
+
+
+/*---------------------------------------------------------------------------*
+  Name:         G3DDemo_DrawSceneGround
+
+  Description:  Resets the base scale and translation of G3D global state
+                and draws the ground.
+
+  Arguments:    ground:     Pointer to the G3DDemoGround structure.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void
+G3DDemo_DrawSceneGround(G3DDemoGround* ground)
+{
+    VecFx32 scale = {FX32_ONE, FX32_ONE, FX32_ONE};
+    VecFx32 trans = {0, 0, 0};
+
+    NNS_G3dGlbSetBaseScale(&scale);
+    NNS_G3dGlbSetBaseTrans(&trans);
+
+    //
+    // The ground is drawn with the G3_XXX functions.
+    // The G3D global state and the geometry command buffer have to be flushed before them.
+    //
+    NNS_G3dGlbFlushP();
+    NNS_G3dGeFlushBuffer();
+    G3DDemo_DrawGround(ground);
+}
@@ -0,0 +1,289 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g3d - samples - BatchJointAnm
+  File:     main.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+//---------------------------------------------------------------------------
+//
+// This sample evaluates the joint animation of a crowd of characters in batches.
+//
+// Normally, the joint animation is decoded one joint at a time from the NODEDESC command of the SBC.
+// When NNSG3dJntAnmBatch is set on the animation object, all the joints of the frame are decoded at once,
+// and the SBC only reads the results.
+// Animation objects that play the same frame of the same resource can share one NNSG3dJntAnmBatch,
+// in which case the joints are decoded only once for the whole crowd.
+//
+// Every frame, the calculation of the joints of NUM_CROWD characters is measured with and without the batch,
+// and the results recorded in the joint calculation result buffers are compared.
+// Only one character is actually rendered.
+//
+// Sample Operation
+// The joint animation is played with looped repeat.
+// Pressing the A Button toggles between a crowd moving in sync and a crowd with shifted frames.
+//
+// HOWTO:
+// 1: Allocate NNS_G3D_JNTANM_BATCH_BUFFER_SIZE(number of joints) bytes and initialize NNSG3dJntAnmBatch with NNS_G3dJntAnmBatchInit.
+//
+// 2: Set it on the animation object with NNS_G3dAnmObjSetJntAnmBatch.
+//    Specifying NULL returns to the evaluation for each joint.
+// 3: Render with NNS_G3dDraw as usual.
+//    The joints are decoded when the first joint of the frame is needed.
+//    The joints can also be decoded in advance by calling NNS_G3dJntAnmBatchCalc.
+//
+//---------------------------------------------------------------------------
+
+#include "g3d_demolib.h"
+
+#define NUM_CROWD   30      // Number of characters in the crowd
+#define FRAME_SHIFT 2       // Frame offset between characters when they are not in sync
+
+G3DDemoCamera gCamera;        // Camera structure.
+G3DDemoGround gGround;        // Ground structure.
+
+static NNSG3dRenderObj     sObject[NUM_CROWD];
+static NNSG3dAnmObj*       sAnmObj[NUM_CROWD];
+static NNSG3dJntAnmResult* sRecJnt[NUM_CROWD];
+static NNSG3dJntAnmBatch   sBatch[NUM_CROWD];
+
+static void          SetBatch(BOOL isBatch, BOOL isSync);
+static OSTick        CalcCrowd(u32 size);
+
+
+/* -------------------------------------------------------------------------
+  Name:         NitroMain
+
+  Description:  Sample main.
+
+  Arguments:    None.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+void
+NitroMain(void)
+{
+    NNSG3dResMdl*   pModel;
+    void*           pAnmRes;
+    NNSFndAllocator allocator;
+    void*           pCmpBuf;
+    u32             recSize;
+    fx32            frame = 0;
+    BOOL            isSync = TRUE;
+    int             i;
+
+    G3DDemo_InitSample(&allocator);
+    G3DDemo_InitFrmVramManager();
+
+    pModel = G3DDemo_LoadG3DModel("data/human_run_t.nsbmd");
+    pAnmRes = G3DDemo_LoadG3DAnm("data/human_run_t.nsbca");
+
+    //
+    // Each character of the crowd has its own rendering object and animation object.
+    // The joint calculation results are recorded in sRecJnt so that they can be compared.
+    //
+    recSize = NNS_G3D_RENDEROBJ_JNTBUFFER_SIZE(pModel->info.numNode);
+    pCmpBuf = NNS_FndAllocFromAllocator(&allocator, recSize * NUM_CROWD);
+    SDK_NULL_ASSERT(pCmpBuf);
+
+    for (i = 0; i < NUM_CROWD; ++i)
+    {
+        NNSG3dJntAnmBatchResult* pBatchBuf;
+
+        NNS_G3dRenderObjInit(&sObject[i], pModel);
+
+        sAnmObj[i] = NNS_G3dAllocAnmObj(&allocator, pAnmRes, pModel);
+        SDK_NULL_ASSERT(sAnmObj[i]);
+        NNS_G3dAnmObjInit(sAnmObj[i], pAnmRes, pModel, NULL);
+        NNS_G3dRenderObjAddAnmObj(&sObject[i], sAnmObj[i]);
+
+        sRecJnt[i] = NNS_G3dAllocRecBufferJnt(&allocator, pModel);
+        SDK_NULL_ASSERT(sRecJnt[i]);
+
+        //
+        // Allocate the region for the results of all the joints and initialize the batch.
+        //
+        pBatchBuf = (NNSG3dJntAnmBatchResult*)
+            NNS_FndAllocFromAllocator(&allocator,
+                                      NNS_G3D_JNTANM_BATCH_BUFFER_SIZE(pModel->info.numNode));
+        SDK_NULL_ASSERT(pBatchBuf);
+        NNS_G3dJntAnmBatchInit(&sBatch[i], pBatchBuf, pModel->info.numNode);
+    }
+
+    //
+    // Demo Common Initialization
+    //
+    G3DDemo_InitCamera(&gCamera, 10*FX32_ONE, 16*FX32_ONE);
+    G3DDemo_InitGround(&gGround, (fx32)(1.5*FX32_ONE));
+
+    G3DDemo_InitConsole();
+    G3DDemo_Print(0,0, G3DDEMO_COLOR_YELLOW, "BatchJointAnm");
+
+    for(;;)
+    {
+        OSTick timeJoint;
+        OSTick timeBatch;
+        BOOL   isSame;
+
+        SVC_WaitVBlankIntr();
+
+        G3DDemo_PrintApplyToHW();
+        G3DDemo_ReadGamePad();
+
+        G3DDemo_BeginScene(&gCamera);
+
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_A))
+        {
+            isSync = !isSync;
+        }
+
+        //
+        // Update the animation frame.
+        //
+        frame += FX32_ONE;
+        if (frame >= NNS_G3dAnmObjGetNumFrame(sAnmObj[0]))
+        {
+            frame = 0;
+        }
+        for (i = 0; i < NUM_CROWD; ++i)
+        {
+            fx32 f = isSync ? frame : frame + i * FRAME_SHIFT * FX32_ONE;
+            sAnmObj[i]->frame = f % NNS_G3dAnmObjGetNumFrame(sAnmObj[i]);
+        }
+
+        //
+        // Calculate the crowd with the evaluation for each joint and then with the batch,
+        // and compare the recorded results.
+        //
+        NNS_G3dGlbFlushP();
+
+        SetBatch(FALSE, isSync);
+        timeJoint = CalcCrowd(recSize);
+        for (i = 0; i < NUM_CROWD; ++i)
+        {
+            MI_CpuCopy32(sRecJnt[i], (u8*)pCmpBuf + recSize * i, recSize);
+        }
+
+        SetBatch(TRUE, isSync);
+        timeBatch = CalcCrowd(recSize);
+        isSame = TRUE;
+        for (i = 0; i < NUM_CROWD; ++i)
+        {
+            const u32* p0 = (const u32*)((u8*)pCmpBuf + recSize * i);
+            const u32* p1 = (const u32*)sRecJnt[i];
+            u32 j;
+            for (j = 0; j < recSize / sizeof(u32); ++j)
+            {
+                if (p0[j] != p1[j])
+                {
+                    isSame = FALSE;
+                }
+            }
+        }
+
+        {
+            VecFx32 scale = { FX32_ONE>>2, FX32_ONE>>2, FX32_ONE>>2 };
+            NNS_G3dGlbSetBaseScale(&scale);
+            NNS_G3dGlbFlushP();
+
+            //
+            // Render only the first character.
+            // The joints were already decoded by the batch for this frame, so they are only read.
+            //
+            NNS_G3dDraw(&sObject[0]);
+        }
+
+        G3DDemo_DrawSceneGround(&gGround);
+
+        /* Swap memory relating to geometry and rendering engine */
+        G3_SwapBuffers(GX_SORTMODE_AUTO, GX_BUFFERMODE_W);
+
+        G3DDemo_Printf(0, 1, G3DDEMO_COLOR_GREEN, "%d characters (%s) ", NUM_CROWD,
+                       isSync ? "in sync" : "shifted");
+        G3DDemo_Printf(0, 2, G3DDEMO_COLOR_WHITE, "per joint:%06ld usec",
+                       OS_TicksToMicroSeconds(timeJoint));
+        G3DDemo_Printf(0, 3, G3DDEMO_COLOR_WHITE, "batch    :%06ld usec",
+                       OS_TicksToMicroSeconds(timeBatch));
+        G3DDemo_Printf(0, 4, isSame ? G3DDEMO_COLOR_GREEN : G3DDEMO_COLOR_RED,
+                       isSame ? "results match    " : "results DIFFER   ");
+        G3DDemo_Printf(0, 5, G3DDEMO_COLOR_GREEN, "Press A to change.");
+    }
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         SetBatch
+
+  Description:  Switches the joint animation evaluation of the crowd.
+
+  Arguments:    isBatch: TRUE to evaluate in batches.
+                isSync:  TRUE when all the characters play the same frame.
+                         In that case, all of them share one batch.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+static void
+SetBatch(BOOL isBatch, BOOL isSync)
+{
+    int i;
+
+    for (i = 0; i < NUM_CROWD; ++i)
+    {
+        NNSG3dJntAnmBatch* pBatch = NULL;
+
+        if (isBatch)
+        {
+            pBatch = isSync ? &sBatch[0] : &sBatch[i];
+        }
+        NNS_G3dAnmObjSetJntAnmBatch(sAnmObj[i], pBatch);
+    }
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         CalcCrowd
+
+  Description:  Calculates the joints of the whole crowd without sending commands to the geometry engine,
+                and records the results in sRecJnt.
+
+  Arguments:    size: Size of each buffer of sRecJnt.
+
+  Returns:      Time taken.
+   ------------------------------------------------------------------------- */
+static OSTick
+CalcCrowd(u32 size)
+{
+    OSTick time;
+    int i;
+
+    for (i = 0; i < NUM_CROWD; ++i)
+    {
+        // Clear so that the unwritten members also match when comparing.
+        MI_CpuClearFast(sRecJnt[i], size);
+        NNS_G3dRenderObjSetJntAnmBuffer(&sObject[i], sRecJnt[i]);
+    }
+
+    time = OS_GetTick();
+    for (i = 0; i < NUM_CROWD; ++i)
+    {
+        NNS_G3dRenderObjSetFlag(&sObject[i], NNS_G3D_RENDEROBJ_FLAG_NOGECMD);
+        NNS_G3dRenderObjSetFlag(&sObject[i], NNS_G3D_RENDEROBJ_FLAG_RECORD);
+        NNS_G3dDraw(&sObject[i]);
+        NNS_G3dRenderObjResetFlag(&sObject[i], NNS_G3D_RENDEROBJ_FLAG_NOGECMD);
+    }
+    time = OS_GetTick() - time;
+
+    for (i = 0; i < NUM_CROWD; ++i)
+    {
+        (void)NNS_G3dRenderObjReleaseJntAnmBuffer(&sObject[i]);
+    }
+    return time;
+}
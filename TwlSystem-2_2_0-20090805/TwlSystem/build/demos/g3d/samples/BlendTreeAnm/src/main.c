@@ -0,0 +1,321 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g3d - samples - BlendTreeAnm
+  File:     main.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+//---------------------------------------------------------------------------
+//
+// This sample blends several joint animations with NNSG3dJntBlendTree
+// and compares it with the blending of NNSi_G3dAnmBlendJnt.
+//
+// The front row of characters blends the clips with NNSi_G3dAnmBlendJnt
+// (animation objects with the same ratio added to the render object).
+// The back row blends the same clips with a tree of NNS_G3D_JNTBLEND_LERP layers.
+// The clips are the same motion played with different frame offsets.
+// The time taken by each row is displayed.
+//
+// Sample Operation
+// The joint animations are played with looped repeat.
+// Up/Down on +Control Pad: Changes the number of blended clips (2 to MAX_CLIP).
+// B Button: Toggles an upper-body layer of the tree (masked with the subtree of "spin1").
+//
+// HOWTO:
+// 1: Set a batch (NNS_G3dAnmObjSetJntAnmBatch) in the animation object of each clip.
+// 2: Initialize NNSG3dJntBlendTree with NNS_G3dJntBlendTreeInit
+//    and add the clips with NNS_G3dJntBlendTreeAddLayer.
+//    To blend N clips evenly with LERP layers, set the weight of the i-th layer to 1/(i+1).
+// 3: Add pTree->pAnmObj to the render object with NNS_G3dRenderObjAddAnmObj.
+// 4: Call NNS_G3dJntBlendTreeCalc every frame before NNS_G3dDraw.
+//
+//---------------------------------------------------------------------------
+
+#include "g3d_demolib.h"
+
+#define NUM_CROWD   4       // Number of characters in a row
+#define MAX_CLIP    6       // Maximum number of blended clips
+#define FRAME_SHIFT 7       // Frame offset between clips
+#define UPPER_SHIFT 20      // Frame offset of the upper-body layer
+
+G3DDemoCamera gCamera;        // Camera structure.
+G3DDemoGround gGround;        // Ground structure.
+
+static NNSG3dRenderObj     sObject[NUM_CROWD];              // Blended by NNSi_G3dAnmBlendJnt
+static NNSG3dAnmObj*       sAnmObj[NUM_CROWD][MAX_CLIP];
+static NNSG3dRenderObj     sTreeObject[NUM_CROWD];          // Blended by NNSG3dJntBlendTree
+static NNSG3dAnmObj*       sTreeAnmObj[NUM_CROWD][MAX_CLIP + 1];
+static NNSG3dJntAnmBatch   sBatch[NUM_CROWD][MAX_CLIP + 1];
+static NNSG3dJntBlendTree  sTree[NUM_CROWD];
+static u32                 sUpperMask[NNS_G3D_SIZE_JNT_MAX / 32];
+
+static void          SetClips(int numClip, BOOL isUpper);
+static OSTick        DrawRow(NNSG3dRenderObj* pObj, fx32 z);
+
+
+/* -------------------------------------------------------------------------
+  Name:         NitroMain
+
+  Description:  Sample main.
+
+  Arguments:    None.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+void
+NitroMain(void)
+{
+    NNSG3dResMdl*   pModel;
+    void*           pAnmRes;
+    NNSFndAllocator allocator;
+    fx32            frame = 0;
+    int             numClip = 2;
+    BOOL            isUpper = FALSE;
+    int             i, j;
+
+    G3DDemo_InitSample(&allocator);
+    G3DDemo_InitFrmVramManager();
+
+    pModel = G3DDemo_LoadG3DModel("data/human_run_t.nsbmd");
+    pAnmRes = G3DDemo_LoadG3DAnm("data/human_run_t.nsbca");
+
+    //
+    // The mask of the upper-body layer is the subtree of "spin1".
+    //
+    {
+        NNS_G3D_DEFRESNAME(nodeName, "spin1");
+        int idxNode = NNS_G3dGetNodeIdxByName(&pModel->nodeInfo, &nodeName.resName);
+        SDK_ASSERT(idxNode >= 0);
+
+        MI_CpuClear32(sUpperMask, sizeof(sUpperMask));
+        NNS_G3dJntBlendMaskAddSubtree(sUpperMask, pModel, (u32)idxNode);
+    }
+
+    for (i = 0; i < NUM_CROWD; ++i)
+    {
+        void* pTreeBuf;
+
+        //
+        // Front row: all the clips are added to the render object.
+        //
+        NNS_G3dRenderObjInit(&sObject[i], pModel);
+        for (j = 0; j < MAX_CLIP; ++j)
+        {
+            sAnmObj[i][j] = NNS_G3dAllocAnmObj(&allocator, pAnmRes, pModel);
+            SDK_NULL_ASSERT(sAnmObj[i][j]);
+            NNS_G3dAnmObjInit(sAnmObj[i][j], pAnmRes, pModel, NULL);
+            NNS_G3dRenderObjAddAnmObj(&sObject[i], sAnmObj[i][j]);
+        }
+
+        //
+        // Back row: the clips are the layers of the tree,
+        // and only the animation object of the tree is added to the render object.
+        //
+        pTreeBuf = NNS_FndAllocFromAllocator(&allocator,
+                                             NNS_G3D_JNTBLENDTREE_BUFFER_SIZE(pModel->info.numNode));
+        SDK_NULL_ASSERT(pTreeBuf);
+        NNS_G3dJntBlendTreeInit(&sTree[i],
+                                pTreeBuf,
+                                NNS_G3D_JNTBLENDTREE_BUFFER_SIZE(pModel->info.numNode),
+                                pModel);
+
+        for (j = 0; j < MAX_CLIP + 1; ++j)
+        {
+            NNSG3dJntAnmBatchResult* pBatchBuf;
+
+            sTreeAnmObj[i][j] = NNS_G3dAllocAnmObj(&allocator, pAnmRes, pModel);
+            SDK_NULL_ASSERT(sTreeAnmObj[i][j]);
+            NNS_G3dAnmObjInit(sTreeAnmObj[i][j], pAnmRes, pModel, NULL);
+
+            pBatchBuf = (NNSG3dJntAnmBatchResult*)NNS_FndAllocFromAllocator(&allocator,
+                            NNS_G3D_JNTANM_BATCH_BUFFER_SIZE(pModel->info.numNode));
+            SDK_NULL_ASSERT(pBatchBuf);
+            NNS_G3dJntAnmBatchInit(&sBatch[i][j], pBatchBuf, pModel->info.numNode);
+            NNS_G3dAnmObjSetJntAnmBatch(sTreeAnmObj[i][j], &sBatch[i][j]);
+
+            if (j < MAX_CLIP)
+            {
+                (void)NNS_G3dJntBlendTreeAddLayer(&sTree[i], sTreeAnmObj[i][j],
+                                                  NNS_G3D_JNTBLEND_LERP, 0, NULL);
+            }
+            else
+            {
+                (void)NNS_G3dJntBlendTreeAddLayer(&sTree[i], sTreeAnmObj[i][j],
+                                                  NNS_G3D_JNTBLEND_LERP, 0, sUpperMask);
+            }
+        }
+
+        NNS_G3dRenderObjInit(&sTreeObject[i], pModel);
+        NNS_G3dRenderObjAddAnmObj(&sTreeObject[i], sTree[i].pAnmObj);
+    }
+    SetClips(numClip, isUpper);
+
+    //
+    // Demo Common Initialization
+    //
+    G3DDemo_InitCamera(&gCamera, 10*FX32_ONE, 16*FX32_ONE);
+    G3DDemo_InitGround(&gGround, (fx32)(1.5*FX32_ONE));
+
+    G3DDemo_InitConsole();
+    G3DDemo_Print(0,0, G3DDEMO_COLOR_YELLOW, "BlendTreeAnm");
+
+    for(;;)
+    {
+        OSTick timeBlend;
+        OSTick timeTree;
+        OSTick timeCalc;
+        fx32   numFrame;
+
+        SVC_WaitVBlankIntr();
+
+        G3DDemo_PrintApplyToHW();
+        G3DDemo_ReadGamePad();
+
+        G3DDemo_BeginScene(&gCamera);
+
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_KEY_UP) && numClip < MAX_CLIP)
+        {
+            SetClips(++numClip, isUpper);
+        }
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_KEY_DOWN) && numClip > 2)
+        {
+            SetClips(--numClip, isUpper);
+        }
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_B))
+        {
+            isUpper = !isUpper;
+            SetClips(numClip, isUpper);
+        }
+
+        //
+        // Update the animation frames. Clip j plays j * FRAME_SHIFT frames ahead.
+        //
+        numFrame = NNS_G3dAnmObjGetNumFrame(sAnmObj[0][0]);
+        frame += FX32_ONE;
+        if (frame >= numFrame)
+        {
+            frame = 0;
+        }
+        for (i = 0; i < NUM_CROWD; ++i)
+        {
+            for (j = 0; j < MAX_CLIP; ++j)
+            {
+                fx32 f = (frame + j * FRAME_SHIFT * FX32_ONE) % numFrame;
+                sAnmObj[i][j]->frame     = f;
+                sTreeAnmObj[i][j]->frame = f;
+            }
+            sTreeAnmObj[i][MAX_CLIP]->frame = (frame + UPPER_SHIFT * FX32_ONE) % numFrame;
+        }
+
+        //
+        // The tree is evaluated before rendering.
+        //
+        timeCalc = OS_GetTick();
+        for (i = 0; i < NUM_CROWD; ++i)
+        {
+            NNS_G3dJntBlendTreeCalc(&sTree[i]);
+        }
+        timeCalc = OS_GetTick() - timeCalc;
+
+        timeBlend = DrawRow(&sObject[0], 2 * FX32_ONE);
+        timeTree  = DrawRow(&sTreeObject[0], -2 * FX32_ONE) + timeCalc;
+
+        G3DDemo_DrawSceneGround(&gGround);
+
+        /* Swap memory relating to geometry and rendering engine */
+        G3_SwapBuffers(GX_SORTMODE_AUTO, GX_BUFFERMODE_W);
+
+        G3DDemo_Printf(0, 1, G3DDEMO_COLOR_GREEN, "%d characters x %d clips ",
+                       NUM_CROWD, numClip);
+        G3DDemo_Printf(0, 2, G3DDEMO_COLOR_WHITE, "BlendJnt (front):%06ld usec",
+                       OS_TicksToMicroSeconds(timeBlend));
+        G3DDemo_Printf(0, 3, G3DDEMO_COLOR_WHITE, "tree     (back) :%06ld usec",
+                       OS_TicksToMicroSeconds(timeTree));
+        G3DDemo_Printf(0, 4, G3DDEMO_COLOR_WHITE, "  calc:%06ld usec joints:%4d",
+                       OS_TicksToMicroSeconds(timeCalc), sTree[0].numEval);
+        G3DDemo_Printf(0, 5, G3DDEMO_COLOR_WHITE, "upper-body layer:%s",
+                       isUpper ? "ON " : "OFF");
+        G3DDemo_Printf(0, 6, G3DDEMO_COLOR_GREEN, "UP/DOWN:clips B:upper");
+    }
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         SetClips
+
+  Description:  Sets the ratios and the weights so that numClip clips are blended evenly.
+
+  Arguments:    numClip: Number of blended clips.
+                isUpper: TRUE to enable the upper-body layer of the tree.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+static void
+SetClips(int numClip, BOOL isUpper)
+{
+    int i, j;
+
+    for (i = 0; i < NUM_CROWD; ++i)
+    {
+        for (j = 0; j < MAX_CLIP; ++j)
+        {
+            //
+            // NNSi_G3dAnmBlendJnt normalizes the ratios by their sum.
+            //
+            sAnmObj[i][j]->ratio = (j < numClip) ? FX32_ONE : 0;
+
+            //
+            // A chain of LERP layers blends the i-th clip with a weight of 1/(i+1).
+            //
+            NNS_G3dJntBlendTreeSetWeight(&sTree[i], j,
+                                         (j < numClip) ? FX32_ONE / (j + 1) : 0);
+        }
+        NNS_G3dJntBlendTreeSetWeight(&sTree[i], MAX_CLIP, isUpper ? FX32_ONE : 0);
+    }
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         DrawRow
+
+  Description:  Renders a row of characters.
+
+  Arguments:    pObj:   Array of NUM_CROWD render objects.
+                z:      Z coordinate of the row.
+
+  Returns:      Time taken.
+   ------------------------------------------------------------------------- */
+static OSTick
+DrawRow(NNSG3dRenderObj* pObj, fx32 z)
+{
+    VecFx32 scale = { FX32_ONE>>2, FX32_ONE>>2, FX32_ONE>>2 };
+    OSTick  time;
+    int     x;
+
+    NNS_G3dGlbSetBaseScale(&scale);
+
+    time = OS_GetTick();
+    for (x = 0; x < NUM_CROWD; ++x)
+    {
+        VecFx32 trans;
+
+        trans.x = (x * 2 - (NUM_CROWD - 1)) * FX32_ONE;
+        trans.y = 0;
+        trans.z = z;
+
+        NNS_G3dGlbSetBaseTrans(&trans);
+        NNS_G3dGlbFlushP();
+        NNS_G3dDraw(&pObj[x]);
+    }
+    time = OS_GetTick() - time;
+
+    return time;
+}
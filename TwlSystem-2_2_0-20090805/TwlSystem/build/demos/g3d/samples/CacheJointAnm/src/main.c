@@ -0,0 +1,220 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g3d - samples - CacheJointAnm
+  File:     main.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+//---------------------------------------------------------------------------
+//
+// This sample shares the joint calculation results between instances of a model.
+//
+// When several characters play the same frame of the same joint animation,
+// their joint calculation results are identical and only their positions differ.
+// NNS_G3dJntAnmCacheDraw records the results of the first character in NNSG3dJntAnmCache,
+// and plays them back for the other characters instead of calculating them again.
+//
+// NUM_CROWD characters are rendered every frame, and the time taken is displayed
+// together with the hit rate and the memory used by the cache.
+//
+// Sample Operation
+// The joint animation is played with looped repeat.
+// A Button: Toggles between a crowd moving in sync and a crowd split into NUM_GROUP groups playing different frames.
+// B Button: Toggles the cache on and off.
+//
+// HOWTO:
+// 1: Allocate NNS_G3D_JNTANMCACHE_BUFFER_SIZE(number of entries, number of joints) bytes
+//    and initialize NNSG3dJntAnmCache with NNS_G3dJntAnmCacheInit.
+//    Allocate at least as many entries as the number of different frames played in a frame.
+// 2: Render with NNS_G3dJntAnmCacheDraw instead of NNS_G3dDraw.
+// 3: Call NNS_G3dJntAnmCacheClear when the resources are rewritten.
+//
+//---------------------------------------------------------------------------
+
+#include "g3d_demolib.h"
+
+#define NUM_CROWD_X 4
+#define NUM_CROWD_Z 3
+#define NUM_CROWD   (NUM_CROWD_X * NUM_CROWD_Z)     // Number of characters in the crowd
+#define NUM_GROUP   3                               // Number of groups when they are not in sync
+#define FRAME_SHIFT 5                               // Frame offset between groups
+#define NUM_ENTRY   4                               // Number of cache entries
+
+G3DDemoCamera gCamera;        // Camera structure.
+G3DDemoGround gGround;        // Ground structure.
+
+static NNSG3dRenderObj   sObject[NUM_CROWD];
+static NNSG3dAnmObj*     sAnmObj[NUM_CROWD];
+static NNSG3dJntAnmCache sCache;
+
+static OSTick        DrawCrowd(BOOL isCache);
+
+
+/* -------------------------------------------------------------------------
+  Name:         NitroMain
+
+  Description:  Sample main.
+
+  Arguments:    None.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+void
+NitroMain(void)
+{
+    NNSG3dResMdl*   pModel;
+    void*           pAnmRes;
+    NNSFndAllocator allocator;
+    void*           pCacheBuf;
+    u32             cacheSize;
+    fx32            frame = 0;
+    BOOL            isSync = TRUE;
+    BOOL            isCache = TRUE;
+    int             i;
+
+    G3DDemo_InitSample(&allocator);
+    G3DDemo_InitFrmVramManager();
+
+    pModel = G3DDemo_LoadG3DModel("data/human_run_t.nsbmd");
+    pAnmRes = G3DDemo_LoadG3DAnm("data/human_run_t.nsbca");
+
+    for (i = 0; i < NUM_CROWD; ++i)
+    {
+        NNS_G3dRenderObjInit(&sObject[i], pModel);
+
+        sAnmObj[i] = NNS_G3dAllocAnmObj(&allocator, pAnmRes, pModel);
+        SDK_NULL_ASSERT(sAnmObj[i]);
+        NNS_G3dAnmObjInit(sAnmObj[i], pAnmRes, pModel, NULL);
+        NNS_G3dRenderObjAddAnmObj(&sObject[i], sAnmObj[i]);
+    }
+
+    //
+    // Allocate the region for the cache and initialize it.
+    //
+    cacheSize = NNS_G3D_JNTANMCACHE_BUFFER_SIZE(NUM_ENTRY, pModel->info.numNode);
+    pCacheBuf = NNS_FndAllocFromAllocator(&allocator, cacheSize);
+    SDK_NULL_ASSERT(pCacheBuf);
+    NNS_G3dJntAnmCacheInit(&sCache, pCacheBuf, NUM_ENTRY, pModel->info.numNode);
+
+    //
+    // Demo Common Initialization
+    //
+    G3DDemo_InitCamera(&gCamera, 10*FX32_ONE, 16*FX32_ONE);
+    G3DDemo_InitGround(&gGround, (fx32)(1.5*FX32_ONE));
+
+    G3DDemo_InitConsole();
+    G3DDemo_Print(0,0, G3DDEMO_COLOR_YELLOW, "CacheJointAnm");
+
+    for(;;)
+    {
+        OSTick time;
+
+        SVC_WaitVBlankIntr();
+
+        G3DDemo_PrintApplyToHW();
+        G3DDemo_ReadGamePad();
+
+        G3DDemo_BeginScene(&gCamera);
+
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_A))
+        {
+            isSync = !isSync;
+        }
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_B))
+        {
+            isCache = !isCache;
+        }
+
+        //
+        // Update the animation frame.
+        //
+        frame += FX32_ONE;
+        if (frame >= NNS_G3dAnmObjGetNumFrame(sAnmObj[0]))
+        {
+            frame = 0;
+        }
+        for (i = 0; i < NUM_CROWD; ++i)
+        {
+            fx32 f = isSync ? frame : frame + (i % NUM_GROUP) * FRAME_SHIFT * FX32_ONE;
+            sAnmObj[i]->frame = f % NNS_G3dAnmObjGetNumFrame(sAnmObj[i]);
+        }
+
+        NNS_G3dJntAnmCacheResetStats(&sCache);
+        time = DrawCrowd(isCache);
+
+        G3DDemo_DrawSceneGround(&gGround);
+
+        /* Swap memory relating to geometry and rendering engine */
+        G3_SwapBuffers(GX_SORTMODE_AUTO, GX_BUFFERMODE_W);
+
+        G3DDemo_Printf(0, 1, G3DDEMO_COLOR_GREEN, "%d characters (%s) ", NUM_CROWD,
+                       isSync ? "in sync" : "grouped");
+        G3DDemo_Printf(0, 2, G3DDEMO_COLOR_WHITE, "cache:%s draw:%06ld usec",
+                       isCache ? "ON " : "OFF", OS_TicksToMicroSeconds(time));
+        G3DDemo_Printf(0, 3, G3DDEMO_COLOR_WHITE, "hit:%2d miss:%2d rate:%3d%%",
+                       sCache.numHit, sCache.numMiss, NNS_G3dJntAnmCacheGetHitRate(&sCache));
+        G3DDemo_Printf(0, 4, G3DDEMO_COLOR_WHITE, "memory:%5d/%5d bytes",
+                       NNS_G3dJntAnmCacheGetUsedSize(&sCache), cacheSize);
+        G3DDemo_Printf(0, 5, G3DDEMO_COLOR_GREEN, "A:sync B:cache");
+    }
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         DrawCrowd
+
+  Description:  Renders the whole crowd side by side.
+
+  Arguments:    isCache: TRUE to render through the cache.
+
+  Returns:      Time taken.
+   ------------------------------------------------------------------------- */
+static OSTick
+DrawCrowd(BOOL isCache)
+{
+    VecFx32 scale = { FX32_ONE>>2, FX32_ONE>>2, FX32_ONE>>2 };
+    OSTick  time;
+    int     x, z;
+
+    NNS_G3dGlbSetBaseScale(&scale);
+
+    time = OS_GetTick();
+    for (z = 0; z < NUM_CROWD_Z; ++z)
+    {
+        for (x = 0; x < NUM_CROWD_X; ++x)
+        {
+            NNSG3dRenderObj* pObj = &sObject[z * NUM_CROWD_X + x];
+            VecFx32 trans;
+
+            trans.x = (x * 2 - (NUM_CROWD_X - 1)) * FX32_ONE;
+            trans.y = 0;
+            trans.z = (z * 2 - (NUM_CROWD_Z - 1)) * FX32_ONE;
+
+            //
+            // Only the base matrix differs between the characters.
+            //
+            NNS_G3dGlbSetBaseTrans(&trans);
+            NNS_G3dGlbFlushP();
+
+            if (isCache)
+            {
+                (void)NNS_G3dJntAnmCacheDraw(&sCache, pObj);
+            }
+            else
+            {
+                NNS_G3dDraw(pObj);
+            }
+        }
+    }
+    time = OS_GetTick() - time;
+
+    return time;
+}
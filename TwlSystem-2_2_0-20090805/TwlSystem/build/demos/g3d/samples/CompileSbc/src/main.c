@@ -0,0 +1,286 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g3d - samples - CompileSbc
+  File:     main.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+//---------------------------------------------------------------------------
+//
+// This sample compares the CPU time of NNS_G3dDraw and of a compiled SBC.
+//
+// NNS_G3dCompileSbc converts the SBC of a render object into a command list
+// specialized for the animations bound to it. The SBC commands whose geometry commands
+// do not change are executed once at compile time, so only the animated parts
+// are interpreted when rendering.
+//
+// The selected model is rendered with NNS_G3dDraw on the left and with
+// NNS_G3dDrawCompiledSbc on the right, and the time taken by each is displayed.
+//
+// Sample Operation
+// A Button: Switches the model.
+// B Button: Binds and unbinds the animation of the model, and compiles again.
+// X Button: Toggles NNS_G3D_SBCCOMP_FLAG_COPY_DL, and compiles again.
+//
+// HOWTO:
+// 1: Bind the animations to NNSG3dRenderObj.
+// 2: Call NNS_G3dCompileSbc with a NULL buffer to get the size of the command list.
+// 3: Allocate the buffer and call NNS_G3dCompileSbc again.
+// 4: Render with NNS_G3dDrawCompiledSbc instead of NNS_G3dDraw.
+//    NNS_G3dDraw is used instead when the render object is no longer in the compiled state.
+// 5: Compile again after changing the animation bindings.
+//
+//---------------------------------------------------------------------------
+
+#include "g3d_demolib.h"
+
+#define NUM_MODEL 3
+
+G3DDemoCamera gCamera;        // Camera structure.
+G3DDemoGround gGround;        // Ground structure.
+
+typedef struct
+{
+    const char*       name;
+    const char*       pathMdl;
+    const char*       pathAnm;
+    fx32              scale;
+    NNSG3dRenderObj   object;
+    NNSG3dAnmObj*     pAnmObj;
+    NNSG3dCompiledSbc comp;
+    void*             pCodeBuf;
+    BOOL              isAnmBound;
+}
+SampleModel;
+
+static SampleModel sModel[NUM_MODEL] =
+{
+    { "human_run_t",      "data/human_run_t.nsbmd",      "data/human_run_t.nsbca",      FX32_ONE >> 2 },
+    { "robot_t",          "data/robot_t.nsbmd",          "data/robot_t.nsbca",          FX32_ONE >> 2 },
+    { "several_material", "data/several_material.nsbmd", "data/several_material.nsbma", FX32_ONE }
+};
+
+static NNSFndAllocator sAllocator;
+static u32             sCompFlag = 0;
+
+static void          CompileModel(SampleModel* pModel);
+static OSTick        DrawModel(SampleModel* pModel, fx32 x, BOOL isCompiled);
+
+
+/* -------------------------------------------------------------------------
+  Name:         NitroMain
+
+  Description:  Sample main.
+
+  Arguments:    None.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+void
+NitroMain(void)
+{
+    int i;
+    int cur = 0;
+
+    G3DDemo_InitSample(&sAllocator);
+    G3DDemo_InitFrmVramManager();
+
+    for (i = 0; i < NUM_MODEL; ++i)
+    {
+        SampleModel*  p = &sModel[i];
+        NNSG3dResMdl* pMdl;
+        void*         pAnmRes;
+
+        pMdl    = G3DDemo_LoadG3DModel(p->pathMdl);
+        pAnmRes = G3DDemo_LoadG3DAnm(p->pathAnm);
+
+        NNS_G3dRenderObjInit(&p->object, pMdl);
+
+        p->pAnmObj = NNS_G3dAllocAnmObj(&sAllocator, pAnmRes, pMdl);
+        SDK_NULL_ASSERT(p->pAnmObj);
+        NNS_G3dAnmObjInit(p->pAnmObj, pAnmRes, pMdl, NULL);
+        NNS_G3dRenderObjAddAnmObj(&p->object, p->pAnmObj);
+        p->isAnmBound = TRUE;
+
+        //
+        // Compile the SBC for the bound animation.
+        //
+        p->pCodeBuf = NULL;
+        CompileModel(p);
+    }
+
+    //
+    // Demo Common Initialization
+    //
+    G3DDemo_InitCamera(&gCamera, 2*FX32_ONE, 16*FX32_ONE);
+    G3DDemo_InitGround(&gGround, (fx32)(1.5*FX32_ONE));
+
+    G3DDemo_InitConsole();
+    G3DDemo_Print(0,0, G3DDEMO_COLOR_YELLOW, "CompileSbc");
+
+    for(;;)
+    {
+        SampleModel* p = &sModel[cur];
+        OSTick       timeInterp;
+        OSTick       timeComp;
+
+        SVC_WaitVBlankIntr();
+
+        G3DDemo_PrintApplyToHW();
+        G3DDemo_ReadGamePad();
+
+        G3DDemo_BeginScene(&gCamera);
+
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_A))
+        {
+            cur = (cur + 1) % NUM_MODEL;
+            p = &sModel[cur];
+        }
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_B))
+        {
+            //
+            // The compiled SBC is no longer valid after changing the animation bindings.
+            // NNS_G3dDrawCompiledSbc would render with NNS_G3dDraw until it is compiled again.
+            //
+            if (p->isAnmBound)
+            {
+                NNS_G3dRenderObjRemoveAnmObj(&p->object, p->pAnmObj);
+            }
+            else
+            {
+                NNS_G3dRenderObjAddAnmObj(&p->object, p->pAnmObj);
+            }
+            p->isAnmBound = !p->isAnmBound;
+            CompileModel(p);
+        }
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_X))
+        {
+            sCompFlag ^= NNS_G3D_SBCCOMP_FLAG_COPY_DL;
+            for (i = 0; i < NUM_MODEL; ++i)
+            {
+                CompileModel(&sModel[i]);
+            }
+        }
+
+        //
+        // Update the animation frame.
+        //
+        p->pAnmObj->frame += FX32_ONE;
+        if (p->pAnmObj->frame >= NNS_G3dAnmObjGetNumFrame(p->pAnmObj))
+        {
+            p->pAnmObj->frame = 0;
+        }
+
+        timeInterp = DrawModel(p, -2 * FX32_ONE, FALSE);
+        timeComp   = DrawModel(p,  2 * FX32_ONE, TRUE);
+
+        G3DDemo_DrawSceneGround(&gGround);
+
+        /* Swap memory relating to geometry and rendering engine */
+        G3_SwapBuffers(GX_SORTMODE_AUTO, GX_BUFFERMODE_W);
+
+        G3DDemo_Printf(0, 1, G3DDEMO_COLOR_GREEN, "%-16s anm:%s    ", p->name,
+                       p->isAnmBound ? "ON " : "OFF");
+        G3DDemo_Printf(0, 2, G3DDEMO_COLOR_WHITE, "NNS_G3dDraw: %06ld usec",
+                       OS_TicksToMicroSeconds(timeInterp));
+        G3DDemo_Printf(0, 3, G3DDEMO_COLOR_WHITE, "compiled:    %06ld usec",
+                       OS_TicksToMicroSeconds(timeComp));
+        G3DDemo_Printf(0, 4, G3DDEMO_COLOR_WHITE, "status:%s copyDL:%s",
+                       NNS_G3dCompiledSbcIsValid(&p->comp, &p->object) ? "compiled" : "fallback",
+                       (sCompFlag & NNS_G3D_SBCCOMP_FLAG_COPY_DL) ? "ON " : "OFF");
+        G3DDemo_Printf(0, 5, G3DDEMO_COLOR_WHITE, "interpreted:%3d/%3d cmds",
+                       p->comp.numInterpCmd, p->comp.numCmd);
+        G3DDemo_Printf(0, 6, G3DDEMO_COLOR_WHITE, "code:%6d bytes", p->comp.szCode);
+        G3DDemo_Printf(0, 7, G3DDEMO_COLOR_GREEN, "A:model B:anm X:copyDL");
+    }
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         CompileModel
+
+  Description:  Compiles the SBC of the model for its current animation bindings.
+
+  Arguments:    pModel: Model to compile.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+static void
+CompileModel(SampleModel* pModel)
+{
+    u32 size;
+
+    if (pModel->pCodeBuf)
+    {
+        NNS_FndFreeToAllocator(&sAllocator, pModel->pCodeBuf);
+        pModel->pCodeBuf = NULL;
+    }
+
+    //
+    // Get the size of the command list first.
+    //
+    size = NNS_G3dCompileSbc(&pModel->comp, NULL, 0, &pModel->object, sCompFlag);
+    if (size == 0)
+    {
+        // Cannot be compiled. NNS_G3dDrawCompiledSbc renders with NNS_G3dDraw.
+        OS_Printf("%s: cannot be compiled\n", pModel->name);
+        return;
+    }
+
+    pModel->pCodeBuf = NNS_FndAllocFromAllocator(&sAllocator, size);
+    SDK_NULL_ASSERT(pModel->pCodeBuf);
+
+    (void)NNS_G3dCompileSbc(&pModel->comp, pModel->pCodeBuf, size, &pModel->object, sCompFlag);
+    OS_Printf("%s: %d bytes, %d/%d commands interpreted\n", pModel->name,
+              size, pModel->comp.numInterpCmd, pModel->comp.numCmd);
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         DrawModel
+
+  Description:  Renders the model at the specified position.
+
+  Arguments:    pModel:     Model to render.
+                x:          X coordinate of the model.
+                isCompiled: TRUE to render with the compiled SBC.
+
+  Returns:      Time taken.
+   ------------------------------------------------------------------------- */
+static OSTick
+DrawModel(SampleModel* pModel, fx32 x, BOOL isCompiled)
+{
+    VecFx32 scale;
+    VecFx32 trans;
+    OSTick  time;
+
+    scale.x = scale.y = scale.z = pModel->scale;
+    trans.x = x;
+    trans.y = 0;
+    trans.z = 0;
+
+    NNS_G3dGlbSetBaseScale(&scale);
+    NNS_G3dGlbSetBaseTrans(&trans);
+    NNS_G3dGlbFlushP();
+
+    time = OS_GetTick();
+    if (isCompiled)
+    {
+        (void)NNS_G3dDrawCompiledSbc(&pModel->object, &pModel->comp);
+    }
+    else
+    {
+        NNS_G3dDraw(&pModel->object);
+    }
+    time = OS_GetTick() - time;
+
+    return time;
+}
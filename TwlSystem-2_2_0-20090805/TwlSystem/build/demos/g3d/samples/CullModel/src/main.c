@@ -0,0 +1,201 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g3d - samples - CullModel
+  File:     main.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+//---------------------------------------------------------------------------
+//
+// This sample skips the rendering of the models outside of the view volume.
+//
+// NNS_G3dCullerSetFrustum calculates the view volume from the camera and the projection
+// set in NNS_G3dGlb. NNS_G3dCullerDraw tests the bounding box of the model
+// placed with the base matrix and calls NNS_G3dDraw only when the box is visible.
+//
+// NUM_CROWD characters are placed on a wide grid so that most of them are outside of the screen.
+// The time taken, the numbers of drawn and culled characters
+// and the estimated CPU time saved by the culling are displayed.
+//
+// Sample Operation
+// The joint animation is played with looped repeat.
+// A Button: Toggles the culling on and off.
+// +Control Pad (and the other demo camera operations): Moves the camera.
+//
+// HOWTO:
+// 1: Initialize NNSG3dCuller with NNS_G3dCullerInit.
+// 2: Call NNS_G3dCullerSetFrustum every frame after the camera and the projection are set.
+// 3: Render with NNS_G3dCullerDraw instead of NNS_G3dDraw.
+//    To skip NNS_G3dGlbFlushP of the culled models too,
+//    test with NNS_G3dCullerTestMdl before the flush and render with NNS_G3dDraw.
+//
+//---------------------------------------------------------------------------
+
+#include "g3d_demolib.h"
+
+#define NUM_CROWD_X 8
+#define NUM_CROWD_Z 8
+#define NUM_CROWD   (NUM_CROWD_X * NUM_CROWD_Z)     // Number of characters in the crowd
+#define CROWD_SPACE (3 * FX32_ONE)                  // Distance between characters
+
+G3DDemoCamera gCamera;        // Camera structure.
+G3DDemoGround gGround;        // Ground structure.
+
+static NNSG3dRenderObj   sObject[NUM_CROWD];
+static NNSG3dAnmObj*     sAnmObj[NUM_CROWD];
+static NNSG3dCuller      sCuller;
+
+static OSTick        DrawCrowd(BOOL isCull);
+
+
+/* -------------------------------------------------------------------------
+  Name:         NitroMain
+
+  Description:  Sample main.
+
+  Arguments:    None.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+void
+NitroMain(void)
+{
+    NNSG3dResMdl*   pModel;
+    void*           pAnmRes;
+    NNSFndAllocator allocator;
+    BOOL            isCull = TRUE;
+    int             i;
+
+    G3DDemo_InitSample(&allocator);
+    G3DDemo_InitFrmVramManager();
+
+    pModel = G3DDemo_LoadG3DModel("data/human_run_t.nsbmd");
+    pAnmRes = G3DDemo_LoadG3DAnm("data/human_run_t.nsbca");
+
+    for (i = 0; i < NUM_CROWD; ++i)
+    {
+        NNS_G3dRenderObjInit(&sObject[i], pModel);
+
+        sAnmObj[i] = NNS_G3dAllocAnmObj(&allocator, pAnmRes, pModel);
+        SDK_NULL_ASSERT(sAnmObj[i]);
+        NNS_G3dAnmObjInit(sAnmObj[i], pAnmRes, pModel, NULL);
+        NNS_G3dRenderObjAddAnmObj(&sObject[i], sAnmObj[i]);
+    }
+
+    NNS_G3dCullerInit(&sCuller);
+
+    //
+    // Demo Common Initialization
+    //
+    G3DDemo_InitCamera(&gCamera, 10*FX32_ONE, 16*FX32_ONE);
+    G3DDemo_InitGround(&gGround, (fx32)(1.5*FX32_ONE));
+
+    G3DDemo_InitConsole();
+    G3DDemo_Print(0,0, G3DDEMO_COLOR_YELLOW, "CullModel");
+
+    for(;;)
+    {
+        OSTick time;
+
+        SVC_WaitVBlankIntr();
+
+        G3DDemo_PrintApplyToHW();
+        G3DDemo_ReadGamePad();
+
+        G3DDemo_BeginScene(&gCamera);
+
+        //
+        // Calculate the view volume after the camera and the projection are set.
+        //
+        NNS_G3dCullerSetFrustum(&sCuller);
+
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_A))
+        {
+            isCull = !isCull;
+        }
+
+        for (i = 0; i < NUM_CROWD; ++i)
+        {
+            sAnmObj[i]->frame += FX32_ONE;
+            if (sAnmObj[i]->frame >= NNS_G3dAnmObjGetNumFrame(sAnmObj[i]))
+            {
+                sAnmObj[i]->frame = 0;
+            }
+        }
+
+        NNS_G3dCullerResetStats(&sCuller);
+        time = DrawCrowd(isCull);
+
+        G3DDemo_DrawSceneGround(&gGround);
+
+        /* Swap memory relating to geometry and rendering engine */
+        G3_SwapBuffers(GX_SORTMODE_AUTO, GX_BUFFERMODE_W);
+
+        G3DDemo_Printf(0, 1, G3DDEMO_COLOR_GREEN, "%d characters", NUM_CROWD);
+        G3DDemo_Printf(0, 2, G3DDEMO_COLOR_WHITE, "cull:%s draw:%06ld usec",
+                       isCull ? "ON " : "OFF", OS_TicksToMicroSeconds(time));
+        G3DDemo_Printf(0, 3, G3DDEMO_COLOR_WHITE, "drawn:%2d culled:%2d test:%04ld usec",
+                       isCull ? sCuller.numDrawn : NUM_CROWD, sCuller.numCulled,
+                       OS_TicksToMicroSeconds(sCuller.tickTest));
+        G3DDemo_Printf(0, 4, G3DDEMO_COLOR_WHITE, "saved:%06ld usec",
+                       OS_TicksToMicroSeconds(NNS_G3dCullerGetSavedTick(&sCuller)));
+        G3DDemo_Printf(0, 5, G3DDEMO_COLOR_GREEN, "A:cull");
+    }
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         DrawCrowd
+
+  Description:  Renders the whole crowd on a grid.
+
+  Arguments:    isCull: TRUE to skip the characters outside of the view volume.
+
+  Returns:      Time taken.
+   ------------------------------------------------------------------------- */
+static OSTick
+DrawCrowd(BOOL isCull)
+{
+    VecFx32 scale = { FX32_ONE>>2, FX32_ONE>>2, FX32_ONE>>2 };
+    OSTick  time;
+    int     x, z;
+
+    NNS_G3dGlbSetBaseScale(&scale);
+
+    time = OS_GetTick();
+    for (z = 0; z < NUM_CROWD_Z; ++z)
+    {
+        for (x = 0; x < NUM_CROWD_X; ++x)
+        {
+            NNSG3dRenderObj* pObj = &sObject[z * NUM_CROWD_X + x];
+            VecFx32 trans;
+
+            trans.x = (x * 2 - (NUM_CROWD_X - 1)) * CROWD_SPACE / 2;
+            trans.y = 0;
+            trans.z = (z * 2 - (NUM_CROWD_Z - 1)) * CROWD_SPACE / 2;
+
+            NNS_G3dGlbSetBaseTrans(&trans);
+            NNS_G3dGlbFlushP();
+
+            if (isCull)
+            {
+                (void)NNS_G3dCullerDraw(&sCuller, pObj);
+            }
+            else
+            {
+                NNS_G3dDraw(pObj);
+            }
+        }
+    }
+    time = OS_GetTick() - time;
+
+    return time;
+}
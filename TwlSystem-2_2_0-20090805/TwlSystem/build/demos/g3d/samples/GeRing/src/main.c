@@ -0,0 +1,246 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g3d - samples - GeRing
+  File:     main.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+//---------------------------------------------------------------------------
+//
+// This sample sends the geometry commands through a ring of command buffers.
+//
+// Without the ring, the CPU writes the geometry commands to the geometry FIFO itself,
+// and waits whenever the FIFO is full.
+// With the ring set by NNS_G3dGeSetRing, the CPU writes the commands to one buffer
+// while the previous buffers are sent by DMA. The commands of the frame are queued
+// with NNS_G3dGeKickRing, and they are sent while the CPU waits for the V-Blank.
+//
+// The time taken to render NUM_CROWD characters and the statistics of the ring are displayed.
+//
+// Sample Operation
+// A Button: Toggles the ring on and off.
+// X Button: Changes the number of buffers of the ring.
+//
+// HOWTO:
+// 1: Allocate NNSG3dGeBuffer buffers in main memory (not in DTCM).
+// 2: Call NNS_G3dGeSetRing.
+// 3: Call NNS_G3dGeKickRing after the commands of a frame.
+//    NNS_G3dGeFlushBuffer waits until all the queued commands are sent.
+// 4: Read the statistics in NNSG3dGeRing, and reset them with NNS_G3dGeResetRingStats.
+//
+//---------------------------------------------------------------------------
+
+#include "g3d_demolib.h"
+
+#define NUM_CROWD_X 4
+#define NUM_CROWD_Z 3
+#define NUM_CROWD   (NUM_CROWD_X * NUM_CROWD_Z)     // Number of characters in the crowd
+#define MAX_RING_BUF 8                              // Maximum number of buffers of the ring
+
+G3DDemoCamera gCamera;        // Camera structure.
+G3DDemoGround gGround;        // Ground structure.
+
+static NNSG3dRenderObj sObject[NUM_CROWD];
+static NNSG3dAnmObj*   sAnmObj[NUM_CROWD];
+
+// Read by DMA, so they are placed in main memory.
+static NNSG3dGeBuffer  sRingBuf[MAX_RING_BUF];
+static NNSG3dGeRing    sRing;
+
+static OSTick        DrawCrowd(void);
+
+
+/* -------------------------------------------------------------------------
+  Name:         NitroMain
+
+  Description:  Sample main.
+
+  Arguments:    None.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+void
+NitroMain(void)
+{
+    NNSG3dResMdl*   pModel;
+    void*           pAnmRes;
+    NNSFndAllocator allocator;
+    BOOL            isRing = TRUE;
+    u32             numRingBuf = 4;
+    int             i;
+
+    G3DDemo_InitSample(&allocator);
+    G3DDemo_InitFrmVramManager();
+
+    pModel = G3DDemo_LoadG3DModel("data/human_run_t.nsbmd");
+    pAnmRes = G3DDemo_LoadG3DAnm("data/human_run_t.nsbca");
+
+    for (i = 0; i < NUM_CROWD; ++i)
+    {
+        NNS_G3dRenderObjInit(&sObject[i], pModel);
+
+        sAnmObj[i] = NNS_G3dAllocAnmObj(&allocator, pAnmRes, pModel);
+        SDK_NULL_ASSERT(sAnmObj[i]);
+        NNS_G3dAnmObjInit(sAnmObj[i], pAnmRes, pModel, NULL);
+        NNS_G3dRenderObjAddAnmObj(&sObject[i], sAnmObj[i]);
+
+        // Each character plays a different frame.
+        sAnmObj[i]->frame = (i * 3 * FX32_ONE) % NNS_G3dAnmObjGetNumFrame(sAnmObj[i]);
+    }
+
+    //
+    // Set the ring of geometry command buffers.
+    //
+    NNS_G3dGeSetRing(&sRing, &sRingBuf[0], numRingBuf);
+
+    //
+    // Demo Common Initialization
+    //
+    G3DDemo_InitCamera(&gCamera, 10*FX32_ONE, 16*FX32_ONE);
+    G3DDemo_InitGround(&gGround, (fx32)(1.5*FX32_ONE));
+
+    G3DDemo_InitConsole();
+    G3DDemo_Print(0,0, G3DDEMO_COLOR_YELLOW, "GeRing");
+
+    for(;;)
+    {
+        OSTick time;
+        OSTick tickFlush;
+
+        SVC_WaitVBlankIntr();
+
+        //
+        // The commands of the previous frame may still be in the ring.
+        // Wait for them before accessing the geometry engine directly.
+        //
+        NNS_G3dGeFlushBuffer();
+        tickFlush = isRing ? sRing.tickFlush : 0;
+
+        G3DDemo_PrintApplyToHW();
+        G3DDemo_ReadGamePad();
+
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_A))
+        {
+            if (isRing)
+            {
+                (void)NNS_G3dGeReleaseRing();
+            }
+            else
+            {
+                NNS_G3dGeSetRing(&sRing, &sRingBuf[0], numRingBuf);
+            }
+            isRing = !isRing;
+        }
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_X))
+        {
+            numRingBuf = (numRingBuf < MAX_RING_BUF) ? numRingBuf * 2 : 2;
+            if (isRing)
+            {
+                (void)NNS_G3dGeReleaseRing();
+                NNS_G3dGeSetRing(&sRing, &sRingBuf[0], numRingBuf);
+            }
+        }
+
+        G3DDemo_BeginScene(&gCamera);
+
+        //
+        // Update the animation frames.
+        //
+        for (i = 0; i < NUM_CROWD; ++i)
+        {
+            sAnmObj[i]->frame += FX32_ONE;
+            if (sAnmObj[i]->frame >= NNS_G3dAnmObjGetNumFrame(sAnmObj[i]))
+            {
+                sAnmObj[i]->frame = 0;
+            }
+        }
+
+        G3DDemo_DrawSceneGround(&gGround);
+
+        if (isRing)
+        {
+            NNS_G3dGeResetRingStats(&sRing);
+        }
+
+        time = DrawCrowd();
+
+        //
+        // Swap memory relating to geometry and rendering engine.
+        // The command goes through the ring after the commands of the crowd,
+        // and the ring is sent while the CPU waits for the V-Blank.
+        //
+        {
+            u32 param = GX_PACK_SWAPBUFFERS_PARAM(GX_SORTMODE_AUTO, GX_BUFFERMODE_W);
+            NNS_G3dGeBufferOP_N(G3OP_SWAP_BUFFERS, &param, G3OP_SWAP_BUFFERS_NPARAMS);
+        }
+        NNS_G3dGeKickRing();
+
+        G3DDemo_Printf(0, 1, G3DDEMO_COLOR_GREEN, "%d characters ring:%s (%d) ", NUM_CROWD,
+                       isRing ? "ON " : "OFF", numRingBuf);
+        G3DDemo_Printf(0, 2, G3DDEMO_COLOR_WHITE, "draw:  %06ld usec", OS_TicksToMicroSeconds(time));
+        if (isRing)
+        {
+            G3DDemo_Printf(0, 3, G3DDEMO_COLOR_WHITE, "stall: %06ld usec (%3d)",
+                           OS_TicksToMicroSeconds(sRing.tickStall), sRing.numStall);
+            G3DDemo_Printf(0, 4, G3DDEMO_COLOR_WHITE, "flush: %06ld usec",
+                           OS_TicksToMicroSeconds(tickFlush));
+            G3DDemo_Printf(0, 5, G3DDEMO_COLOR_WHITE, "submit:%4d high-water:%2d",
+                           sRing.numSubmit, sRing.highWater);
+        }
+        else
+        {
+            G3DDemo_Printf(0, 3, G3DDEMO_COLOR_WHITE, "                        ");
+            G3DDemo_Printf(0, 4, G3DDEMO_COLOR_WHITE, "                        ");
+            G3DDemo_Printf(0, 5, G3DDEMO_COLOR_WHITE, "                        ");
+        }
+        G3DDemo_Printf(0, 6, G3DDEMO_COLOR_GREEN, "A:ring X:buffers");
+    }
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         DrawCrowd
+
+  Description:  Renders the whole crowd side by side.
+
+  Arguments:    None.
+
+  Returns:      Time taken.
+   ------------------------------------------------------------------------- */
+static OSTick
+DrawCrowd(void)
+{
+    VecFx32 scale = { FX32_ONE>>2, FX32_ONE>>2, FX32_ONE>>2 };
+    OSTick  time;
+    int     x, z;
+
+    NNS_G3dGlbSetBaseScale(&scale);
+
+    time = OS_GetTick();
+    for (z = 0; z < NUM_CROWD_Z; ++z)
+    {
+        for (x = 0; x < NUM_CROWD_X; ++x)
+        {
+            VecFx32 trans;
+
+            trans.x = (x * 2 - (NUM_CROWD_X - 1)) * FX32_ONE;
+            trans.y = 0;
+            trans.z = (z * 2 - (NUM_CROWD_Z - 1)) * FX32_ONE;
+
+            NNS_G3dGlbSetBaseTrans(&trans);
+            NNS_G3dGlbFlushP();
+            NNS_G3dDraw(&sObject[z * NUM_CROWD_X + x]);
+        }
+    }
+    time = OS_GetTick() - time;
+
+    return time;
+}
@@ -0,0 +1,288 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g3d - samples - LodModel
+  File:     main.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+//---------------------------------------------------------------------------
+//
+// This sample selects the model and the animation rate of each character by its size on the screen.
+//
+// NNS_G3dLodMgrDraw measures the size of the character on the screen.
+// Characters smaller than LEVEL_SIZE pixels are drawn with the coarse model (robot),
+// and characters smaller than ANMRATE_SIZE0 and ANMRATE_SIZE1 pixels calculate their joint animation
+// every 2 and 4 frames. The frames in between are interpolated.
+//
+// NUM_CROWD characters are placed in rows going away from the camera.
+// The time taken, the number of characters drawn with each level and the numbers of poses
+// calculated and interpolated are displayed.
+//
+// Sample Operation
+// The joint animations are played with looped repeat.
+// A Button: Toggles the LOD on and off (off: every character is drawn with the detailed model at full rate).
+// B Button: Toggles the budgets of vertices and joints per frame.
+// X Button: Toggles the dirty tracking of NNS_G3dGlbFlushP (the words sent and skipped per frame are displayed).
+// +Control Pad (and the other demo camera operations): Moves the camera.
+//
+// HOWTO:
+// 1: Create one NNSG3dRenderObj per level and add the animations to each of them.
+//    When the levels are the models of one .nsbmd file, NNS_G3dLodObjSetMdlSet initializes them.
+// 2: Initialize NNSG3dLodObj with NNS_G3dLodObjInit and add the levels with NNS_G3dLodObjAddLevel.
+// 3: Initialize NNSG3dLodMgr and set the thresholds (and the budgets).
+// 4: Every frame, call NNS_G3dLodMgrBeginFrame and draw with NNS_G3dLodMgrDraw instead of NNS_G3dDraw.
+//
+//---------------------------------------------------------------------------
+
+#include "g3d_demolib.h"
+
+#define NUM_CROWD_X   4
+#define NUM_CROWD_Z   8
+#define NUM_CROWD     (NUM_CROWD_X * NUM_CROWD_Z)   // Number of characters in the crowd
+#define CROWD_SPACE   (3 * FX32_ONE)                // Distance between characters
+#define NUM_LEVEL     2
+
+#define LEVEL_SIZE    40    // Smallest size (pixels) drawn with the detailed model
+#define ANMRATE_SIZE0 48    // Smaller characters animate at 1/2 rate
+#define ANMRATE_SIZE1 24    // Smaller characters animate at 1/4 rate
+#define HYSTERESIS    4
+
+#define BUDGET_NUM_DETAIL 8 // Vertex budget in number of detailed models
+
+G3DDemoCamera gCamera;        // Camera structure.
+G3DDemoGround gGround;        // Ground structure.
+
+static NNSG3dRenderObj sObject[NUM_CROWD][NUM_LEVEL];
+static NNSG3dAnmObj*   sAnmObj[NUM_CROWD][NUM_LEVEL];
+static NNSG3dLodObj    sLodObj[NUM_CROWD];
+static NNSG3dLodMgr    sLodMgr;
+
+static OSTick        DrawCrowd(BOOL isLod);
+
+
+/* -------------------------------------------------------------------------
+  Name:         NitroMain
+
+  Description:  Sample main.
+
+  Arguments:    None.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+void
+NitroMain(void)
+{
+    NNSG3dResMdl*   pModel[NUM_LEVEL];
+    void*           pAnmRes[NUM_LEVEL];
+    NNSFndAllocator allocator;
+    BOOL            isLod = TRUE;
+    BOOL            isBudget = FALSE;
+    BOOL            isTracking = TRUE;
+    u32             maxJnt;
+    u32             maxVtx;
+    int             i, j;
+
+    G3DDemo_InitSample(&allocator);
+    G3DDemo_InitFrmVramManager();
+
+    //
+    // Level 0 is the detailed model and level 1 the coarse model.
+    //
+    pModel[0] = G3DDemo_LoadG3DModel("data/human_run_t.nsbmd");
+    pModel[1] = G3DDemo_LoadG3DModel("data/robot_t.nsbmd");
+    pAnmRes[0] = G3DDemo_LoadG3DAnm("data/human_run_t.nsbca");
+    pAnmRes[1] = G3DDemo_LoadG3DAnm("data/robot_t.nsbca");
+
+    maxJnt = MATH_MAX(pModel[0]->info.numNode, pModel[1]->info.numNode);
+    maxVtx = (u32)pModel[0]->info.numVertex * BUDGET_NUM_DETAIL;
+
+    for (i = 0; i < NUM_CROWD; ++i)
+    {
+        void* pBuf = NNS_FndAllocFromAllocator(&allocator, NNS_G3D_LODOBJ_BUFFER_SIZE(maxJnt));
+        SDK_NULL_ASSERT(pBuf);
+
+        NNS_G3dLodObjInit(&sLodObj[i], pBuf, maxJnt);
+
+        for (j = 0; j < NUM_LEVEL; ++j)
+        {
+            NNS_G3dRenderObjInit(&sObject[i][j], pModel[j]);
+
+            sAnmObj[i][j] = NNS_G3dAllocAnmObj(&allocator, pAnmRes[j], pModel[j]);
+            SDK_NULL_ASSERT(sAnmObj[i][j]);
+            NNS_G3dAnmObjInit(sAnmObj[i][j], pAnmRes[j], pModel[j], NULL);
+            NNS_G3dRenderObjAddAnmObj(&sObject[i][j], sAnmObj[i][j]);
+
+            (void)NNS_G3dLodObjAddLevel(&sLodObj[i], &sObject[i][j]);
+        }
+    }
+
+    NNS_G3dLodMgrInit(&sLodMgr);
+    NNS_G3dLodMgrSetLevelSize(&sLodMgr, 0, LEVEL_SIZE);
+    NNS_G3dLodMgrSetAnmRateSize(&sLodMgr, 0, ANMRATE_SIZE0);
+    NNS_G3dLodMgrSetAnmRateSize(&sLodMgr, 1, ANMRATE_SIZE1);
+    sLodMgr.hysteresis = HYSTERESIS;
+
+    //
+    // Each character calls NNS_G3dGlbFlushP: send only the state changed since the last flush.
+    //
+    NNS_G3dGlbSetDirtyTracking(isTracking);
+
+    //
+    // Demo Common Initialization
+    //
+    G3DDemo_InitCamera(&gCamera, 10*FX32_ONE, 16*FX32_ONE);
+    G3DDemo_InitGround(&gGround, (fx32)(1.5*FX32_ONE));
+
+    G3DDemo_InitConsole();
+    G3DDemo_Print(0,0, G3DDEMO_COLOR_YELLOW, "LodModel");
+
+    for(;;)
+    {
+        OSTick time;
+
+        SVC_WaitVBlankIntr();
+
+        G3DDemo_PrintApplyToHW();
+        G3DDemo_ReadGamePad();
+
+        G3DDemo_BeginScene(&gCamera);
+
+        // G3X_Reset in G3DDemo_BeginScene changes the state of the geometry engine.
+        NNS_G3dGlbInvalidate();
+        NNS_G3dGlbResetFlushStats();
+
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_A))
+        {
+            isLod = !isLod;
+        }
+
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_B))
+        {
+            isBudget = !isBudget;
+            if (isBudget)
+            {
+                NNS_G3dLodMgrSetBudget(&sLodMgr, maxVtx, maxJnt * NUM_CROWD / 4);
+            }
+            else
+            {
+                NNS_G3dLodMgrSetBudget(&sLodMgr, NNS_G3D_LOD_BUDGET_NONE, NNS_G3D_LOD_BUDGET_NONE);
+            }
+        }
+
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_X))
+        {
+            isTracking = !isTracking;
+            NNS_G3dGlbSetDirtyTracking(isTracking);
+        }
+
+        //
+        // Keep the animations of all the levels at the same frame.
+        //
+        for (i = 0; i < NUM_CROWD; ++i)
+        {
+            for (j = 0; j < NUM_LEVEL; ++j)
+            {
+                sAnmObj[i][j]->frame += FX32_ONE;
+                if (sAnmObj[i][j]->frame >= NNS_G3dAnmObjGetNumFrame(sAnmObj[i][j]))
+                {
+                    sAnmObj[i][j]->frame = 0;
+                }
+            }
+        }
+
+        NNS_G3dLodMgrBeginFrame(&sLodMgr);
+        time = DrawCrowd(isLod);
+
+        G3DDemo_DrawSceneGround(&gGround);
+
+        /* Swap memory relating to geometry and rendering engine */
+        G3_SwapBuffers(GX_SORTMODE_AUTO, GX_BUFFERMODE_W);
+
+        G3DDemo_Printf(0, 1, G3DDEMO_COLOR_GREEN, "%d characters", NUM_CROWD);
+        G3DDemo_Printf(0, 2, G3DDEMO_COLOR_WHITE, "lod:%s budget:%s",
+                       isLod ? "ON " : "OFF", isBudget ? "ON " : "OFF");
+        G3DDemo_Printf(0, 3, G3DDEMO_COLOR_WHITE, "draw:%06ld usec", OS_TicksToMicroSeconds(time));
+        if (isLod)
+        {
+            G3DDemo_Printf(0, 4, G3DDEMO_COLOR_WHITE, "level0:%2d level1:%2d skip:%2d",
+                           sLodMgr.numDraw[0], sLodMgr.numDraw[1], sLodMgr.numSkip);
+            G3DDemo_Printf(0, 5, G3DDEMO_COLOR_WHITE, "calc:%2d interp:%2d defer:%2d",
+                           sLodMgr.numAnmCalc, sLodMgr.numAnmInterp, sLodMgr.numAnmDefer);
+            G3DDemo_Printf(0, 6, G3DDEMO_COLOR_WHITE, "vtx:%5d jnt:%4d",
+                           sLodMgr.numVtx, sLodMgr.numJnt);
+        }
+        else
+        {
+            G3DDemo_Printf(0, 4, G3DDEMO_COLOR_WHITE, "level0:%2d level1:%2d skip:%2d",
+                           NUM_CROWD, 0, 0);
+            G3DDemo_Printf(0, 5, G3DDEMO_COLOR_WHITE, "calc:%2d interp:%2d defer:%2d",
+                           NUM_CROWD, 0, 0);
+            G3DDemo_Printf(0, 6, G3DDEMO_COLOR_WHITE, "vtx:%5d jnt:%4d",
+                           pModel[0]->info.numVertex * NUM_CROWD,
+                           pModel[0]->info.numNode * NUM_CROWD);
+        }
+        G3DDemo_Printf(0, 7, G3DDEMO_COLOR_WHITE, "flush:%5d skip:%5d words",
+                       NNS_G3dGlb.numFlushWord, NNS_G3dGlb.numSkipWord);
+        G3DDemo_Printf(0, 8, G3DDEMO_COLOR_GREEN, "A:lod B:budget X:dirty(%s)",
+                       isTracking ? "ON " : "OFF");
+    }
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         DrawCrowd
+
+  Description:  Renders the whole crowd, rows going away from the camera.
+
+  Arguments:    isLod: TRUE to select the level and the animation rate by the size.
+
+  Returns:      Time taken.
+   ------------------------------------------------------------------------- */
+static OSTick
+DrawCrowd(BOOL isLod)
+{
+    VecFx32 scale = { FX32_ONE>>2, FX32_ONE>>2, FX32_ONE>>2 };
+    OSTick  time;
+    int     x, z;
+
+    NNS_G3dGlbSetBaseScale(&scale);
+
+    time = OS_GetTick();
+
+    // Draw from the front row so that the budgets are used by the nearest characters first.
+    for (z = 0; z < NUM_CROWD_Z; ++z)
+    {
+        for (x = 0; x < NUM_CROWD_X; ++x)
+        {
+            int idx = z * NUM_CROWD_X + x;
+            VecFx32 trans;
+
+            trans.x = (x * 2 - (NUM_CROWD_X - 1)) * CROWD_SPACE / 2;
+            trans.y = 0;
+            trans.z = -z * CROWD_SPACE * 2;
+
+            NNS_G3dGlbSetBaseTrans(&trans);
+            NNS_G3dGlbFlushP();
+
+            if (isLod)
+            {
+                (void)NNS_G3dLodMgrDraw(&sLodMgr, &sLodObj[idx]);
+            }
+            else
+            {
+                NNS_G3dDraw(&sObject[idx][0]);
+            }
+        }
+    }
+    time = OS_GetTick() - time;
+
+    return time;
+}
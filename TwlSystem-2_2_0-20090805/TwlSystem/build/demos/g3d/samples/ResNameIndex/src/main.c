@@ -0,0 +1,479 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g3d - samples - ResNameIndex
+  File:     main.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+//---------------------------------------------------------------------------
+//
+// This sample looks up the names of the resource dictionaries with NNSG3dResNameIndex
+// and checks that the results are the same as the usual search.
+//
+// While NNSG3dResNameIndex is registered, NNS_G3dGetResDictIdxByName (and all the XXXByName
+// functions) look up the dictionaries of the file in a hash table instead of comparing
+// the names one by one or walking the Patricia tree.
+//
+// Every name of every dictionary of the loaded files is looked up in every dictionary:
+// - in its own dictionary (found),
+// - in the other dictionaries, which can have the same name at another index,
+// - and changed by one character, which must not be found
+//   even when the hash value lands on the slots of the original name.
+// The results with the index registered are compared with the results without it.
+// The index is built in the size returned by NNS_G3dResNameIndexGetBufferSize,
+// then in 1/2 and 1/4 of it. In the smaller regions the table is full, so the names collide
+// in the same slots, and the dictionaries that do not fit are searched as usual.
+// The number of slots compared for one lookup is displayed for each size.
+//
+// Every frame, the time taken to look up all the names with and without the index is displayed.
+//
+// Sample Operation
+// A Button: Checks the lookups again.
+//
+// HOWTO:
+// 1: Allocate NNS_G3dResNameIndexGetBufferSize(file) bytes.
+// 2: Build the hash table with NNS_G3dResNameIndexInit.
+// 3: Call NNS_G3dResNameIndexRegister. The XXXByName functions use it from then on.
+// 4: Call NNS_G3dResNameIndexUnregister before discarding the file.
+//
+//---------------------------------------------------------------------------
+
+#include "g3d_demolib.h"
+
+#define NUM_FILE      4
+#define MAX_DICT      32
+#define NUM_BUF_SIZE  3     // Index buffer sizes checked: 1/1, 1/2 and 1/4
+#define NUM_VARIANT   4     // Changed names made from each name
+
+G3DDemoCamera gCamera;        // Camera structure.
+G3DDemoGround gGround;        // Ground structure.
+
+typedef struct SampleFile_
+{
+    const char*          path;
+    NNSG3dResFileHeader* pFile;
+    NNSG3dResNameIndex   index;
+    void*                pIndexBuf;
+    u32                  szIndexBuf;
+}
+SampleFile;
+
+static SampleFile sFile[NUM_FILE] =
+{
+    { "data/human_run_t.nsbmd" },
+    { "data/robot_t.nsbmd" },
+    { "data/several_material.nsbmd" },
+    { "data/several_material.nsbma" }
+};
+
+static const NNSG3dResDict* sDict[MAX_DICT];
+static int                  sNumDict = 0;
+
+static NNSG3dResName*       sName;          // Names to look up
+static int                  sNumName = 0;
+static int                  sNumHit  = 0;   // The first sNumHit names are in the dictionaries
+static s16*                 sExpected;      // Results without the index [dict][name]
+
+typedef struct CheckResult_
+{
+    u32  numSlot;
+    u32  numUsed;
+    u32  numLookup;
+    u32  numProbe;
+    int  numError;
+}
+CheckResult;
+
+static CheckResult sResult[NUM_BUF_SIZE];
+
+static void   AddDict(const NNSG3dResDict* dict);
+static void   CollectDicts(const NNSG3dResFileHeader* pFile);
+static void   CollectNames(NNSFndAllocator* pAllocator);
+static void   BuildIndices(u32 shift);
+static void   RegisterIndices(BOOL isRegister);
+static void   CheckLookups(void);
+static OSTick LookupAll(void);
+
+
+/* -------------------------------------------------------------------------
+  Name:         NitroMain
+
+  Description:  Sample main.
+
+  Arguments:    None.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+void
+NitroMain(void)
+{
+    NNSFndAllocator allocator;
+    int             i;
+
+    G3DDemo_InitSample(&allocator);
+
+    //
+    // The dictionaries are used as they are in the files: the files are not set up.
+    //
+    for (i = 0; i < NUM_FILE; ++i)
+    {
+        SampleFile* p = &sFile[i];
+
+        p->pFile = G3DDemo_LoadG3DFile(p->path);
+        CollectDicts(p->pFile);
+
+        //
+        // The size of the region for all the dictionaries of the file.
+        //
+        p->szIndexBuf = NNS_G3dResNameIndexGetBufferSize(p->pFile);
+        p->pIndexBuf  = NNS_FndAllocFromAllocator(&allocator, p->szIndexBuf);
+        SDK_ASSERT(p->pIndexBuf || p->szIndexBuf == 0);
+    }
+
+    CollectNames(&allocator);
+    CheckLookups();
+
+    //
+    // Demo Common Initialization
+    //
+    G3DDemo_InitCamera(&gCamera, 10*FX32_ONE, 16*FX32_ONE);
+    G3DDemo_InitGround(&gGround, (fx32)(1.5*FX32_ONE));
+
+    G3DDemo_InitConsole();
+    G3DDemo_Print(0,0, G3DDEMO_COLOR_YELLOW, "ResNameIndex");
+
+    for(;;)
+    {
+        OSTick timeSearch;
+        OSTick timeIndex;
+
+        SVC_WaitVBlankIntr();
+
+        G3DDemo_PrintApplyToHW();
+        G3DDemo_ReadGamePad();
+
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_A))
+        {
+            CheckLookups();
+        }
+
+        G3DDemo_BeginScene(&gCamera);
+
+        //
+        // Look up all the names without the index and then with the index.
+        //
+        RegisterIndices(FALSE);
+        timeSearch = LookupAll();
+
+        RegisterIndices(TRUE);
+        timeIndex = LookupAll();
+        RegisterIndices(FALSE);
+
+        G3DDemo_DrawSceneGround(&gGround);
+
+        /* Swap memory relating to geometry and rendering engine */
+        G3_SwapBuffers(GX_SORTMODE_AUTO, GX_BUFFERMODE_W);
+
+        G3DDemo_Printf(0, 1, G3DDEMO_COLOR_GREEN, "dict:%2d name:%3d miss:%4d",
+                       sNumDict, sNumHit, sNumName - sNumHit);
+        for (i = 0; i < NUM_BUF_SIZE; ++i)
+        {
+            const CheckResult* r = &sResult[i];
+
+            // Average number of the slots compared for one lookup (x100)
+            u32 probe = r->numLookup ? r->numProbe * 100 / r->numLookup : 0;
+
+            G3DDemo_Printf(0, 2 + i, (r->numError == 0) ? G3DDEMO_COLOR_WHITE : G3DDEMO_COLOR_RED,
+                           "1/%d %4d/%4d probe%2d.%02d %s",
+                           1 << i, r->numUsed, r->numSlot, probe / 100, probe % 100,
+                           (r->numError == 0) ? "OK" : "NG");
+        }
+        G3DDemo_Printf(0, 6, G3DDEMO_COLOR_WHITE, "search:%06ld usec",
+                       OS_TicksToMicroSeconds(timeSearch));
+        G3DDemo_Printf(0, 7, G3DDEMO_COLOR_WHITE, "index :%06ld usec",
+                       OS_TicksToMicroSeconds(timeIndex));
+        G3DDemo_Printf(0, 8, G3DDEMO_COLOR_GREEN, "A:check again");
+    }
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         AddDict
+
+  Description:  Adds a dictionary to the dictionaries to look up.
+
+  Arguments:    dict: Dictionary.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+static void
+AddDict(const NNSG3dResDict* dict)
+{
+    SDK_ASSERT(sNumDict < MAX_DICT);
+    sDict[sNumDict++] = dict;
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         CollectDicts
+
+  Description:  Adds all the dictionaries of the file that NNSG3dResNameIndex indexes.
+
+  Arguments:    pFile: Resource file.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+static void
+CollectDicts(const NNSG3dResFileHeader* pFile)
+{
+    u32 i, j;
+
+    for (i = 0; i < pFile->dataBlocks; ++i)
+    {
+        const NNSG3dResDataBlockHeader* blk = NNS_G3dGetDataBlockHeaderByIdx(pFile, i);
+
+        if (blk->kind == NNS_G3D_DATABLK_MDLSET)
+        {
+            const NNSG3dResMdlSet* mdlSet = (const NNSG3dResMdlSet*)blk;
+
+            AddDict(&mdlSet->dict);
+            for (j = 0; j < mdlSet->dict.numEntry; ++j)
+            {
+                const NNSG3dResMdl* mdl = NNS_G3dGetMdlByIdx(mdlSet, j);
+                const NNSG3dResMat* mat = NNS_G3dGetMat(mdl);
+
+                AddDict(&NNS_G3dGetNodeInfo(mdl)->dict);
+                AddDict(&mat->dict);
+                AddDict((const NNSG3dResDict*)((u8*)mat + mat->ofsDictTexToMatList));
+                AddDict((const NNSG3dResDict*)((u8*)mat + mat->ofsDictPlttToMatList));
+                AddDict(&NNS_G3dGetShp(mdl)->dict);
+            }
+        }
+        else if (blk->kind == NNS_G3D_DATABLK_TEX)
+        {
+            const NNSG3dResTex* tex = (const NNSG3dResTex*)blk;
+
+            AddDict(&tex->dict);
+            if (tex->plttInfo.ofsDict != 0)
+            {
+                AddDict((const NNSG3dResDict*)((u8*)tex + tex->plttInfo.ofsDict));
+            }
+        }
+        else if (blk->kind == NNS_G3D_DATABLK_MATC_ANM)
+        {
+            const NNSG3dResAnmSet* anmSet = (const NNSG3dResAnmSet*)blk;
+
+            AddDict(&anmSet->dict);
+            for (j = 0; j < anmSet->dict.numEntry; ++j)
+            {
+                const NNSG3dResDictAnmSetData* data =
+                    (const NNSG3dResDictAnmSetData*)NNS_G3dGetResDataByIdx(&anmSet->dict, j);
+
+                AddDict(&((const NNSG3dResMatCAnm*)((u8*)anmSet + data->offset))->dict);
+            }
+        }
+    }
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         CollectNames
+
+  Description:  Makes the names to look up and the results without the index.
+                The names of all the dictionaries come first,
+                followed by the names changed by one character.
+                Resource names are ASCII, so the changed names are in no dictionary.
+
+  Arguments:    pAllocator: Allocator of the names and the results.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+static void
+CollectNames(NNSFndAllocator* pAllocator)
+{
+    int i, j, k;
+
+    for (i = 0; i < sNumDict; ++i)
+    {
+        sNumHit += sDict[i]->numEntry;
+    }
+    sNumName = sNumHit * (1 + NUM_VARIANT);
+
+    sName     = (NNSG3dResName*)NNS_FndAllocFromAllocator(pAllocator,
+                                                          sizeof(NNSG3dResName) * sNumName);
+    sExpected = (s16*)NNS_FndAllocFromAllocator(pAllocator,
+                                                sizeof(s16) * sNumName * sNumDict);
+    SDK_NULL_ASSERT(sName);
+    SDK_NULL_ASSERT(sExpected);
+
+    k = 0;
+    for (i = 0; i < sNumDict; ++i)
+    {
+        for (j = 0; j < sDict[i]->numEntry; ++j)
+        {
+            sName[k++] = *NNS_G3dGetResNameByIdx(sDict[i], (u32)j);
+        }
+    }
+
+    for (i = 0; i < sNumHit; ++i)
+    {
+        for (j = 0; j < NUM_VARIANT; ++j)
+        {
+            // Sets the top bit of the last character of the j-th word.
+            sName[k] = sName[i];
+            sName[k].val[j] ^= 0x80000000;
+            ++k;
+        }
+    }
+
+    //
+    // The results of the usual search.
+    //
+    RegisterIndices(FALSE);
+    for (i = 0; i < sNumDict; ++i)
+    {
+        for (k = 0; k < sNumName; ++k)
+        {
+            sExpected[i * sNumName + k] = (s16)NNS_G3dGetResDictIdxByName(sDict[i], &sName[k]);
+        }
+    }
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         BuildIndices
+
+  Description:  Builds the indices of all the files.
+
+  Arguments:    shift: The size of the region used is szIndexBuf >> shift.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+static void
+BuildIndices(u32 shift)
+{
+    int i;
+
+    for (i = 0; i < NUM_FILE; ++i)
+    {
+        SampleFile* p = &sFile[i];
+        NNS_G3dResNameIndexInit(&p->index, p->pIndexBuf, p->szIndexBuf >> shift, p->pFile);
+    }
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         RegisterIndices
+
+  Description:  Registers or unregisters the indices of all the files.
+
+  Arguments:    isRegister: TRUE to register.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+static void
+RegisterIndices(BOOL isRegister)
+{
+    int i;
+
+    for (i = 0; i < NUM_FILE; ++i)
+    {
+        // Unregistering an index that is not registered does nothing.
+        NNS_G3dResNameIndexUnregister(&sFile[i].index);
+        if (isRegister)
+        {
+            NNS_G3dResNameIndexRegister(&sFile[i].index);
+        }
+    }
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         CheckLookups
+
+  Description:  Compares the lookups with the indices with the usual search,
+                for each size of the index region.
+                The indices are left built in the full size.
+
+  Arguments:    None.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+static void
+CheckLookups(void)
+{
+    int s, i, k;
+
+    for (s = NUM_BUF_SIZE - 1; s >= 0; --s)
+    {
+        CheckResult* r = &sResult[s];
+
+        MI_CpuClear8(r, sizeof(CheckResult));
+
+        RegisterIndices(FALSE);
+        BuildIndices((u32)s);
+        RegisterIndices(TRUE);
+
+        for (i = 0; i < sNumDict; ++i)
+        {
+            for (k = 0; k < sNumName; ++k)
+            {
+                int idx = NNS_G3dGetResDictIdxByName(sDict[i], &sName[k]);
+                if (idx != sExpected[i * sNumName + k])
+                {
+                    OS_Printf("NG: dict %d name %d: %d (expected %d)\n",
+                              i, k, idx, sExpected[i * sNumName + k]);
+                    ++r->numError;
+                }
+            }
+        }
+
+        for (i = 0; i < NUM_FILE; ++i)
+        {
+            const NNSG3dResNameIndex* pIndex = &sFile[i].index;
+
+            r->numSlot   += pIndex->pEntry ? pIndex->mask + 1 : 0;
+            r->numUsed   += pIndex->numUsed;
+            r->numLookup += pIndex->numLookup;
+            r->numProbe  += pIndex->numProbe;
+        }
+    }
+    RegisterIndices(FALSE);
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         LookupAll
+
+  Description:  Looks up all the names in all the dictionaries.
+
+  Arguments:    None.
+
+  Returns:      Time taken.
+   ------------------------------------------------------------------------- */
+static OSTick
+LookupAll(void)
+{
+    OSTick time;
+    int    i, k;
+
+    time = OS_GetTick();
+    for (i = 0; i < sNumDict; ++i)
+    {
+        for (k = 0; k < sNumName; ++k)
+        {
+            (void)NNS_G3dGetResDictIdxByName(sDict[i], &sName[k]);
+        }
+    }
+    time = OS_GetTick() - time;
+
+    return time;
+}
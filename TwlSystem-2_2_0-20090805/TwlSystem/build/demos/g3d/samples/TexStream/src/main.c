@@ -0,0 +1,275 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - demos - g3d - samples - TexStream
+  File:     main.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+//---------------------------------------------------------------------------
+//
+// This sample keeps in VRAM only the textures of the characters displayed.
+//
+// NUM_CHARA characters are loaded, each with its own texture block,
+// but the texture VRAM manager only has room for about TEX_VRAM_NUM_CHARA of them.
+// NUM_VISIBLE characters are displayed at a time, and the window slides to the next character
+// every SLIDE_INTERVAL frames. NNSG3dTexStream loads the textures of the characters that appear,
+// at most TRANSFER_BUDGET bytes per frame, and releases the textures least recently used.
+// A character is not drawn until its textures are in VRAM.
+//
+// The number of textures in VRAM, the bytes transferred and the statistics of the streaming are displayed.
+//
+// Sample Operation
+// The joint animations are played with looped repeat.
+// A Button: Stops and restarts the sliding.
+// B Button: Slides to the next character.
+// +Control Pad (and the other demo camera operations): Moves the camera.
+//
+// HOWTO:
+// 1: Load the files without NNS_G3dResDefaultSetup (the keys of the texture blocks must not be set).
+// 2: Initialize the VRAM managers (able to free regions) and the VRAM transfer manager of GFD.
+// 3: Initialize NNSG3dTexStream, add the texture blocks with NNS_G3dTexStreamAddTex
+//    and their models with NNS_G3dTexStreamAddMdl.
+// 4: Every frame, draw the models for which NNS_G3dTexStreamUse returns TRUE,
+//    call NNS_G3dTexStreamUpdate after drawing and NNS_GfdDoVramTransfer at VBlank.
+//
+//---------------------------------------------------------------------------
+
+#include "g3d_demolib.h"
+
+#define NUM_CHARA          16                    // Number of characters (texture blocks)
+#define NUM_VISIBLE        5                     // Number of characters displayed at a time
+#define CHARA_SPACE        (2 * FX32_ONE)        // Distance between characters
+#define SLIDE_INTERVAL     60                    // Frames between the slides
+
+#define TEX_VRAM_NUM_CHARA 6                     // Room of the texture VRAM in number of characters
+#define TRANSFER_BUDGET    0x1000                // Bytes transferred per frame
+#define NUM_TRANSFER_TASK  32
+#define NUM_VRAMMAN_MEMBLK 32
+
+G3DDemoCamera gCamera;        // Camera structure.
+G3DDemoGround gGround;        // Ground structure.
+
+static NNSG3dRenderObj        sObject[NUM_CHARA];
+static NNSG3dAnmObj*          sAnmObj[NUM_CHARA];
+static int                    sEntryIdx[NUM_CHARA];
+static NNSG3dTexStreamEntry   sEntry[NUM_CHARA];
+static NNSG3dTexStream        sStream;
+static NNSGfdVramTransferTask sTransferTask[NUM_TRANSFER_TASK];
+
+static void InitVramManager(NNSFndAllocator* pAllocator, u32 szTex, u32 szPltt);
+static int  DrawCharas(int first);
+
+
+/* -------------------------------------------------------------------------
+  Name:         NitroMain
+
+  Description:  Sample main.
+
+  Arguments:    None.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+void
+NitroMain(void)
+{
+    NNSG3dResFileHeader* pFile;
+    NNSG3dResMdl*   pModel;
+    NNSG3dResTex*   pTex;
+    void*           pAnmRes;
+    NNSFndAllocator allocator;
+    BOOL            isSlide = TRUE;
+    int             first = 0;
+    int             count = 0;
+    int             i;
+
+    G3DDemo_InitSample(&allocator);
+
+    //
+    // Each character has its own copy of the file, and then its own texture block.
+    //
+    pAnmRes = G3DDemo_LoadG3DAnm("data/human_run_t.nsbca");
+
+    NNS_G3dTexStreamInit(&sStream, &sEntry[0], NUM_CHARA, TRANSFER_BUDGET);
+
+    for (i = 0; i < NUM_CHARA; ++i)
+    {
+        pFile  = G3DDemo_LoadG3DFile("data/human_run_t.nsbmd");
+        pModel = NNS_G3dGetMdlByIdx(NNS_G3dGetMdlSet(pFile), 0);
+        pTex   = NNS_G3dGetTex(pFile);
+        SDK_NULL_ASSERT(pModel);
+        SDK_NULL_ASSERT(pTex);
+
+        sEntryIdx[i] = NNS_G3dTexStreamAddTex(&sStream, pTex);
+        SDK_ASSERT(sEntryIdx[i] >= 0);
+        (void)NNS_G3dTexStreamAddMdl(&sStream, sEntryIdx[i], pModel);
+
+        NNS_G3dRenderObjInit(&sObject[i], pModel);
+
+        sAnmObj[i] = NNS_G3dAllocAnmObj(&allocator, pAnmRes, pModel);
+        SDK_NULL_ASSERT(sAnmObj[i]);
+        NNS_G3dAnmObjInit(sAnmObj[i], pAnmRes, pModel, NULL);
+        NNS_G3dRenderObjAddAnmObj(&sObject[i], sAnmObj[i]);
+
+        // Shift the animations of the characters.
+        sAnmObj[i]->frame = (i * 5 * FX32_ONE) % NNS_G3dAnmObjGetNumFrame(sAnmObj[i]);
+
+        if (i == 0)
+        {
+            // The VRAM has room only for TEX_VRAM_NUM_CHARA characters.
+            InitVramManager(&allocator,
+                            (NNS_G3dTexGetRequiredSize(pTex) +
+                             NNS_G3dTex4x4GetRequiredSize(pTex)) * TEX_VRAM_NUM_CHARA,
+                            NNS_G3dPlttGetRequiredSize(pTex) * TEX_VRAM_NUM_CHARA);
+        }
+    }
+
+    NNS_GfdInitVramTransferManager(sTransferTask, NUM_TRANSFER_TASK);
+
+    //
+    // Demo Common Initialization
+    //
+    G3DDemo_InitCamera(&gCamera, 2*FX32_ONE, 10*FX32_ONE);
+    G3DDemo_InitGround(&gGround, (fx32)(1.5*FX32_ONE));
+
+    G3DDemo_InitConsole();
+    G3DDemo_Print(0,0, G3DDEMO_COLOR_YELLOW, "TexStream");
+
+    for(;;)
+    {
+        int numDraw;
+
+        SVC_WaitVBlankIntr();
+
+        // Transfer the data registered by NNS_G3dTexStreamUpdate in the last frame.
+        NNS_GfdDoVramTransfer();
+
+        G3DDemo_PrintApplyToHW();
+        G3DDemo_ReadGamePad();
+
+        G3DDemo_BeginScene(&gCamera);
+
+        if (G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_A))
+        {
+            isSlide = !isSlide;
+        }
+
+        if ((isSlide && ++count >= SLIDE_INTERVAL) ||
+            G3DDEMO_IS_PAD_TRIGGER(PAD_BUTTON_B))
+        {
+            count = 0;
+            first = (first + 1) % NUM_CHARA;
+        }
+
+        for (i = 0; i < NUM_CHARA; ++i)
+        {
+            sAnmObj[i]->frame += FX32_ONE;
+            if (sAnmObj[i]->frame >= NNS_G3dAnmObjGetNumFrame(sAnmObj[i]))
+            {
+                sAnmObj[i]->frame = 0;
+            }
+        }
+
+        numDraw = DrawCharas(first);
+
+        G3DDemo_DrawSceneGround(&gGround);
+
+        /* Swap memory relating to geometry and rendering engine */
+        G3_SwapBuffers(GX_SORTMODE_AUTO, GX_BUFFERMODE_W);
+
+        // Allocate VRAM and register the transfers for the characters that were not drawn.
+        NNS_G3dTexStreamUpdate(&sStream);
+
+        G3DDemo_Printf(0, 1, G3DDEMO_COLOR_GREEN, "chara:%2d-%2d drawn:%d/%d",
+                       first, (first + NUM_VISIBLE - 1) % NUM_CHARA, numDraw, NUM_VISIBLE);
+        G3DDemo_Printf(0, 2, G3DDEMO_COLOR_WHITE, "vram:%06d sent:%05d",
+                       sStream.szResident, sStream.szSent);
+        G3DDemo_Printf(0, 3, G3DDEMO_COLOR_WHITE, "use:%06d miss:%05d",
+                       sStream.numUse, sStream.numMiss);
+        G3DDemo_Printf(0, 4, G3DDEMO_COLOR_WHITE, "load:%04d evict:%04d full:%04d",
+                       sStream.numLoad, sStream.numEvict, sStream.numFull);
+        G3DDemo_Printf(0, 5, G3DDEMO_COLOR_GREEN, "A:%s B:next", isSlide ? "stop " : "start");
+    }
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         DrawCharas
+
+  Description:  Renders the NUM_VISIBLE characters from first
+                whose textures are in VRAM.
+
+  Arguments:    first: Index of the first character displayed.
+
+  Returns:      Number of characters drawn.
+   ------------------------------------------------------------------------- */
+static int
+DrawCharas(int first)
+{
+    VecFx32 scale = { FX32_ONE>>2, FX32_ONE>>2, FX32_ONE>>2 };
+    int     numDraw = 0;
+    int     i;
+
+    NNS_G3dGlbSetBaseScale(&scale);
+
+    for (i = 0; i < NUM_VISIBLE; ++i)
+    {
+        int idx = (first + i) % NUM_CHARA;
+        VecFx32 trans;
+
+        // Not drawn until the textures are loaded.
+        if (!NNS_G3dTexStreamUse(&sStream, sEntryIdx[idx]))
+        {
+            continue;
+        }
+
+        trans.x = (i * 2 - (NUM_VISIBLE - 1)) * CHARA_SPACE / 2;
+        trans.y = 0;
+        trans.z = 0;
+
+        NNS_G3dGlbSetBaseTrans(&trans);
+        NNS_G3dGlbFlushP();
+        NNS_G3dDraw(&sObject[idx]);
+        ++numDraw;
+    }
+
+    return numDraw;
+}
+
+
+/* -------------------------------------------------------------------------
+  Name:         InitVramManager
+
+  Description:  Initializes the linked list VRAM managers, which can free regions,
+                and sets them as the default managers.
+
+  Arguments:    pAllocator: Allocator of the work memory.
+                szTex:      Bytes of the texture image VRAM managed.
+                szPltt:     Bytes of the palette VRAM managed.
+
+  Returns:      None.
+   ------------------------------------------------------------------------- */
+static void
+InitVramManager(NNSFndAllocator* pAllocator, u32 szTex, u32 szPltt)
+{
+    u32   szWork;
+    void* pWork;
+
+    // No region for the 4x4 textures: the characters do not use them.
+    szWork = NNS_GfdGetLnkTexVramManagerWorkSize(NUM_VRAMMAN_MEMBLK);
+    pWork  = NNS_FndAllocFromAllocator(pAllocator, szWork);
+    SDK_NULL_ASSERT(pWork);
+    NNS_GfdInitLnkTexVramManager(MATH_ROUNDUP(szTex, 0x10), 0, pWork, szWork, TRUE);
+
+    szWork = NNS_GfdGetLnkPlttVramManagerWorkSize(NUM_VRAMMAN_MEMBLK);
+    pWork  = NNS_FndAllocFromAllocator(pAllocator, szWork);
+    SDK_NULL_ASSERT(pWork);
+    NNS_GfdInitLnkPlttVramManager(MATH_ROUNDUP(szPltt, 0x10), pWork, szWork, TRUE);
+}
@@ -43,6 +43,16 @@
 #define VRAM_SLOT_SIZE    0x20000
 
 
+//
+// Fragmentation stress test parameters
+//
+#define NUM_STRESS_MEMBLK       256         // Number of managed blocks
+#define NUM_STRESS_TEX          128         // Number of textures allocated at the same time (at most)
+#define NUM_STRESS_CYCLE        4000        // Number of allocations and deallocations
+#define STRESS_ALLOC_UNIT       0x200       // Unit of the allocation size
+#define STRESS_ALLOC_MAX_UNIT   32          // Maximum allocation size (in units)
+
+
 #define TEX4X4_ENABLE           TRUE
 #define TEX4X4_DISABLE          FALSE
 #define PLTT4_TRUE              TRUE
@@ -451,6 +461,205 @@ static void PlttAllocateTest_()
     GfDDemo_Free( pMgrWork );
 }
 
+//
+// Free block statistics computed with NNS_GfdDumpLnkTexVramManagerEx()
+//
+typedef struct FreeBlockInfo
+{
+    u32     numBlk;     // number of free blocks
+    u32     szTotal;    // total size of free blocks
+    u32     szLargest;  // size of the largest free block
+
+}FreeBlockInfo;
+
+// Source image of the textures moved by defragmentation
+static u8                       stressTexImage_[STRESS_ALLOC_UNIT * STRESS_ALLOC_MAX_UNIT] ATTRIBUTE_ALIGN(32);
+// VRAM transfer tasks used by defragmentation
+static NNSGfdVramTransferTask   stressTransferTask_[NUM_STRESS_TEX];
+
+/*---------------------------------------------------------------------------*
+  Name:         GetFreeBlockInfoCallBack_
+
+  Description:  Debug output function that accumulates the free block statistics.
+                
+  Arguments:    addr            Free block address
+                szByte          Free block size
+                pUserData       FreeBlockInfo
+                
+  Returns:      None.
+  
+ *---------------------------------------------------------------------------*/
+static void GetFreeBlockInfoCallBack_( u32 addr, u32 szByte, void* pUserData )
+{
+#pragma unused(addr)
+    FreeBlockInfo*  pInfo = (FreeBlockInfo*)pUserData;
+    
+    pInfo->numBlk++;
+    pInfo->szTotal += szByte;
+    if( szByte > pInfo->szLargest )
+    {
+        pInfo->szLargest = szByte;
+    }
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         PrintFreeBlockInfo_
+
+  Description:  Outputs the free block statistics of the standard textures.
+                
+  Arguments:    pTitle          Title of the output line
+                
+  Returns:      Free block statistics.
+  
+ *---------------------------------------------------------------------------*/
+static FreeBlockInfo PrintFreeBlockInfo_( const char* pTitle )
+{
+    FreeBlockInfo   info = { 0, 0, 0 };
+    
+    NNS_GfdDumpLnkTexVramManagerEx( GetFreeBlockInfoCallBack_, NULL, &info );
+    OS_Printf( "%-16s free blocks = %3d, free total = 0x%05x, largest = 0x%05x\n", 
+        pTitle, info.numBlk, info.szTotal, info.szLargest );
+    
+    return info;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         TexFragmentationTest_
+
+  Description:  Stress test of fragmentation.
+                Textures of random sizes are allocated and freed repeatedly,
+                and then the remaining textures are moved by defragmentation.
+                The number of allocation failures, the free block statistics
+                and the processing time are output.
+                The transfers of the moved textures are not deferred by the
+                transfer budget.
+                
+  Arguments:    None.
+                
+  Returns:      None.
+  
+ *---------------------------------------------------------------------------*/
+static void TexFragmentationTest_()
+{
+    const u32 szWork = NNS_GfdGetLnkTexVramManagerWorkSize( NUM_STRESS_MEMBLK );
+    void* pMgrWork   = GfDDemo_Allock( szWork );
+    
+    NNSGfdTexKey                texKey[NUM_STRESS_TEX];
+    NNSGfdLnkTexDefragEntry     entry[NUM_STRESS_TEX];
+    u32                         seed = 1;
+    u32                         numAlloc = 0;
+    u32                         numFail  = 0;
+    u32                         numEntry = 0;
+    u32                         numMoved;
+    u32                         fence;
+    OSTick                      tick;
+    FreeBlockInfo               info;
+    int                         i;
+    
+    NNS_GFD_NULL_ASSERT( pMgrWork );
+    
+    //
+    // Initializes manager.
+    //
+    NNS_GfdInitLnkTexVramManager( SIZE_VRAMMAN,
+                                  0,
+                                  pMgrWork,
+                                  szWork,
+                                  TRUE );
+    
+    for( i = 0; i < NUM_STRESS_TEX; i++ )
+    {
+        texKey[i] = NNS_GFD_ALLOC_ERROR_TEXKEY;
+    }
+    
+    //
+    // Allocates and frees textures of random sizes.
+    //
+    tick = OS_GetTick();
+    for( i = 0; i < NUM_STRESS_CYCLE; i++ )
+    {
+        NNSGfdTexKey*   pKey;
+        
+        seed = seed * 1664525 + 1013904223;
+        pKey = &texKey[ (seed >> 8) % NUM_STRESS_TEX ];
+        
+        if( *pKey == NNS_GFD_ALLOC_ERROR_TEXKEY )
+        {
+            const u32 szByte = STRESS_ALLOC_UNIT * ( (seed >> 20) % STRESS_ALLOC_MAX_UNIT + 1 );
+            
+            *pKey = NNS_GfdAllocLnkTexVram( szByte, TEX4X4_DISABLE, 0 );
+            numAlloc++;
+            if( *pKey == NNS_GFD_ALLOC_ERROR_TEXKEY )
+            {
+                numFail++;
+            }
+        }else{
+            if( NNS_GfdFreeLnkTexVram( *pKey ) != 0 )
+            {
+                NNS_GFD_WARNING("failure in Vram Free.");
+            }
+            *pKey = NNS_GFD_ALLOC_ERROR_TEXKEY;
+        }
+    }
+    tick = OS_GetTick() - tick;
+    
+    OS_Printf( "allocations = %d, failures = %d, %d us\n", 
+        numAlloc, numFail, (u32)OS_TicksToMicroSeconds( tick ) );
+    (void)PrintFreeBlockInfo_( "before defrag:" );
+    
+    //
+    // Moves the remaining textures to lower addresses.
+    //
+    GX_SetBankForTex( GX_VRAM_TEX_0123_ABCD );
+    NNS_GfdInitVramTransferManager( stressTransferTask_, NUM_STRESS_TEX );
+    NNS_GfdSetVramTransferBudget( STRESS_ALLOC_UNIT, 0 );
+    
+    for( i = 0; i < NUM_STRESS_TEX; i++ )
+    {
+        if( texKey[i] != NNS_GFD_ALLOC_ERROR_TEXKEY )
+        {
+            entry[numEntry].pKey = &texKey[i];
+            entry[numEntry].pSrc = stressTexImage_;
+            numEntry++;
+        }
+    }
+    
+    tick = OS_GetTick();
+    numMoved = NNS_GfdDefragLnkTexVram( entry, numEntry );
+    tick = OS_GetTick() - tick;
+    
+    //
+    // All the moved textures are transferred at the next V-Blank despite the budget.
+    // (The models bound to them would be bound again here, before drawing.)
+    //
+    fence = NNS_GfdGetVramTransferFence();
+    NNS_GfdDoVramTransfer();
+    NNS_GFD_ASSERT( NNS_GfdIsVramTransferFenceDone( fence ) );
+    NNS_GfdSetVramTransferBudget( 0, 0 );
+    
+    OS_Printf( "defrag: moved = %d / %d, %d us\n", 
+        numMoved, numEntry, (u32)OS_TicksToMicroSeconds( tick ) );
+    info = PrintFreeBlockInfo_( "after defrag:" );
+    
+    // All the free regions are gathered in one block.
+    NNS_GFD_ASSERT( info.numBlk <= 1 );
+    
+    for( i = 0; i < NUM_STRESS_TEX; i++ )
+    {
+        if( texKey[i] != NNS_GFD_ALLOC_ERROR_TEXKEY )
+        {
+            if( NNS_GfdFreeLnkTexVram( texKey[i] ) != 0 )
+            {
+                NNS_GFD_WARNING("failure in Vram Free.");
+            }
+        }
+    }
+    (void)PrintFreeBlockInfo_( "after free:" );
+    
+    GX_DisableBankForTex();
+    GfDDemo_Free( pMgrWork );
+}
+
 /*---------------------------------------------------------------------------*
   Name:         NitroMain
 
@@ -473,6 +682,7 @@ void NitroMain()
             TexManInitTest_();
             TexAllocateTest_();
             PlttAllocateTest_();
+            TexFragmentationTest_();
             
         OS_Printf( "----- All tests finish.\n -----" );
     }
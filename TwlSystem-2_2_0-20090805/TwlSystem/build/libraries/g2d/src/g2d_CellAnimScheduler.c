@@ -0,0 +1,467 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - libraries - g2d
+  File:     g2d_CellAnimScheduler.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#include <nitro.h>
+#include <nnsys/g2d/g2d_CellAnimScheduler.h>
+#include <stdlib.h>
+
+#include "g2d_Internal.h"
+
+
+//------------------------------------------------------------------------------
+// Private Functions
+
+
+//------------------------------------------------------------------------------
+static NNS_G2D_INLINE NNSG2dCellAnimSchedulerEntry* GetEntry_
+(
+    NNSG2dCellAnimScheduler*    pSched,
+    u16                         handle
+)
+{
+    NNS_G2D_NULL_ASSERT( pSched );
+    NNS_G2D_MINMAX_ASSERT( handle, 0, pSched->numEntryMax - 1 );
+    NNS_G2D_NULL_ASSERT( pSched->pEntry[handle].pCellAnim );
+
+    return &pSched->pEntry[handle];
+}
+
+//------------------------------------------------------------------------------
+// Time added to animCtrl.currentTime by a tick.
+// Same as the time added by NNS_G2dTickAnimCtrl( pAnimCtrl, pSched->frames ).
+static NNS_G2D_INLINE fx32 GetTimePerTick_
+(
+    const NNSG2dCellAnimScheduler*  pSched,
+    const NNSG2dAnimController*     pAnimCtrl
+)
+{
+    return abs( FX_Mul( pAnimCtrl->speed, pSched->frames ) );
+}
+
+//------------------------------------------------------------------------------
+// Removes the entry from its wheel slot.
+static void UnlinkEntry_( NNSG2dCellAnimScheduler* pSched, u16 handle )
+{
+    NNSG2dCellAnimSchedulerEntry* pEntry = &pSched->pEntry[handle];
+
+    if( pEntry->slot == NNS_G2D_CELLANIMSCHEDULER_NONE )
+    {
+        return;
+    }
+
+    if( pEntry->prev != NNS_G2D_CELLANIMSCHEDULER_NONE )
+    {
+        pSched->pEntry[pEntry->prev].next = pEntry->next;
+    }else{
+        pSched->pWheel[pEntry->slot] = pEntry->next;
+    }
+
+    if( pEntry->next != NNS_G2D_CELLANIMSCHEDULER_NONE )
+    {
+        pSched->pEntry[pEntry->next].prev = pEntry->prev;
+    }
+
+    pEntry->slot = NNS_G2D_CELLANIMSCHEDULER_NONE;
+}
+
+//------------------------------------------------------------------------------
+// Advances animCtrl.currentTime to the current tick.
+// The animation frame never changes here, since the entry wakes up
+// at the tick of the change.
+static void SyncEntry_( NNSG2dCellAnimScheduler* pSched, u16 handle )
+{
+    NNSG2dCellAnimSchedulerEntry*   pEntry      = &pSched->pEntry[handle];
+    NNSG2dAnimController*           pAnimCtrl   = &pEntry->pCellAnim->animCtrl;
+
+    if( pEntry->slot != NNS_G2D_CELLANIMSCHEDULER_NONE )
+    {
+        const u32 numTick = pSched->currentTick - pEntry->baseTick;
+
+        pAnimCtrl->currentTime += (fx32)numTick * GetTimePerTick_( pSched, pAnimCtrl );
+    }
+    pEntry->baseTick = pSched->currentTick;
+}
+
+//------------------------------------------------------------------------------
+// Puts the entry in the wheel slot of the tick at which its animation frame changes.
+// animCtrl.currentTime must be advanced to the current tick.
+//
+// Cell animations whose animation frame never changes (stopped, or speed of 0)
+// are not put in the wheel.
+static void ScheduleEntry_( NNSG2dCellAnimScheduler* pSched, u16 handle )
+{
+    NNSG2dCellAnimSchedulerEntry*   pEntry      = &pSched->pEntry[handle];
+    const NNSG2dAnimController*     pAnimCtrl   = &pEntry->pCellAnim->animCtrl;
+    const fx32                      timePerTick = GetTimePerTick_( pSched, pAnimCtrl );
+
+    NNS_G2D_ASSERT( pEntry->slot == NNS_G2D_CELLANIMSCHEDULER_NONE );
+    NNS_G2D_ASSERT( pEntry->baseTick == pSched->currentTick );
+
+    if( pAnimCtrl->bActive )
+    {
+        const fx32  remain  = FX32_ONE * (int)pAnimCtrl->pCurrent->frames - pAnimCtrl->currentTime;
+        u32         numTick = 1;
+        u16         slot;
+
+        //
+        // An animation frame with a display time already reached (such as a 
+        // frame with 0 display frames) changes at the next tick even at speed 0.
+        //
+        if( remain > 0 )
+        {
+            if( timePerTick == 0 )
+            {
+                return;
+            }
+            numTick = ( (u32)remain + (u32)timePerTick - 1 ) / (u32)timePerTick;
+        }
+
+        pEntry->wakeTick = pSched->currentTick + numTick;
+
+        slot = (u16)( pEntry->wakeTick & ( pSched->numSlot - 1 ) );
+
+        pEntry->slot = slot;
+        pEntry->prev = NNS_G2D_CELLANIMSCHEDULER_NONE;
+        pEntry->next = pSched->pWheel[slot];
+        if( pEntry->next != NNS_G2D_CELLANIMSCHEDULER_NONE )
+        {
+            pSched->pEntry[pEntry->next].prev = handle;
+        }
+        pSched->pWheel[slot] = handle;
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGetCellAnimSchedulerWorkSize
+
+  Description:  Gets the size of the work memory used by the cell animation scheduler.
+
+  Arguments:    numEntryMax:        [IN] maximum number of cell animations registered
+                numSlot:            [IN] number of wheel slots (power of 2)
+
+  Returns:      Size of the work memory (in bytes)
+
+ *---------------------------------------------------------------------------*/
+u32 NNS_G2dGetCellAnimSchedulerWorkSize( u16 numEntryMax, u16 numSlot )
+{
+    return sizeof( NNSG2dCellAnimSchedulerEntry ) * numEntryMax
+         + sizeof( NNSG2dCellAnimation* ) * numEntryMax
+         + sizeof( u16 ) * numSlot;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dInitCellAnimScheduler
+
+  Description:  Initializes the cell animation scheduler.
+
+                A tick of the scheduler advances each registered cell animation
+                the same as NNS_G2dTickCellAnimation( pCellAnim, frames ), but only the
+                cell animations whose animation frame changes are accessed.
+
+                Set numSlot to at least the number of ticks for which an animation
+                frame is usually displayed. Cell animations that wake up later than
+                numSlot ticks are only examined once per numSlot ticks.
+
+  Arguments:    pSched:             [OUT] cell animation scheduler
+                pWork:              [IN]  work memory (4-byte aligned,
+                                          size given by NNS_G2dGetCellAnimSchedulerWorkSize())
+                numEntryMax:        [IN]  maximum number of cell animations registered
+                numSlot:            [IN]  number of wheel slots (power of 2)
+                frames:             [IN]  time advanced by a tick (in frames)
+
+  Returns:      None.
+
+ *---------------------------------------------------------------------------*/
+void NNS_G2dInitCellAnimScheduler
+(
+    NNSG2dCellAnimScheduler*    pSched,
+    void*                       pWork,
+    u16                         numEntryMax,
+    u16                         numSlot,
+    fx32                        frames
+)
+{
+    u16 i;
+
+    NNS_G2D_NULL_ASSERT( pSched );
+    NNS_G2D_NULL_ASSERT( pWork );
+    NNS_G2D_ASSERT( ((u32)pWork & 0x3) == 0 );
+    NNS_G2D_NON_ZERO_ASSERT( numEntryMax );
+    NNS_G2D_ASSERT( numEntryMax < NNS_G2D_CELLANIMSCHEDULER_NONE );
+    NNS_G2D_NON_ZERO_ASSERT( numSlot );
+    NNS_G2D_ASSERT( ( numSlot & ( numSlot - 1 ) ) == 0 );
+    NNS_G2D_ASSERTMSG( frames >= 0, "frames must be Greater than zero" );
+
+    pSched->pEntry      = (NNSG2dCellAnimSchedulerEntry*)pWork;
+    pSched->pChanged    = (NNSG2dCellAnimation**)( pSched->pEntry + numEntryMax );
+    pSched->pWheel      = (u16*)( pSched->pChanged + numEntryMax );
+
+    pSched->numEntryMax = numEntryMax;
+    pSched->numSlot     = numSlot;
+    pSched->numEntry    = 0;
+    pSched->freeIdx     = 0;
+
+    pSched->currentTick = 0;
+    pSched->frames      = frames;
+
+    pSched->pCallBack       = NULL;
+    pSched->callBackParam   = 0;
+
+    pSched->numChanged  = 0;
+    pSched->numVisited  = 0;
+
+    for( i = 0; i < numEntryMax; i++ )
+    {
+        pSched->pEntry[i].pCellAnim = NULL;
+        pSched->pEntry[i].slot      = NNS_G2D_CELLANIMSCHEDULER_NONE;
+        pSched->pEntry[i].next      = (u16)( ( i + 1 < numEntryMax ) ? i + 1 : NNS_G2D_CELLANIMSCHEDULER_NONE );
+    }
+
+    MI_CpuFill16( pSched->pWheel, NNS_G2D_CELLANIMSCHEDULER_NONE, sizeof( u16 ) * numSlot );
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dSetCellAnimSchedulerCallBack
+
+  Description:  Sets the callback called at the end of each tick with the cell
+                animations whose animation frame changed in the tick.
+                The callback is not called when no animation frame changed.
+
+  Arguments:    pSched:             [OUT] cell animation scheduler
+                pCallBack:          [IN]  callback (NULL if not used)
+                param:              [IN]  parameter passed to the callback
+
+  Returns:      None.
+
+ *---------------------------------------------------------------------------*/
+void NNS_G2dSetCellAnimSchedulerCallBack
+(
+    NNSG2dCellAnimScheduler*            pSched,
+    NNSG2dCellAnimSchedulerCallBack     pCallBack,
+    u32                                 param
+)
+{
+    NNS_G2D_NULL_ASSERT( pSched );
+
+    pSched->pCallBack       = pCallBack;
+    pSched->callBackParam   = param;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dAddCellAnimScheduler
+
+  Description:  Registers a cell animation to the scheduler.
+                From then on, the cell animation must be advanced only by
+                NNS_G2dTickCellAnimScheduler().
+
+  Arguments:    pSched:             [OUT] cell animation scheduler
+                pCellAnim:          [IN]  cell animation
+
+  Returns:      Handle of the registered cell animation
+                (NNS_G2D_CELLANIMSCHEDULER_INVALID_HANDLE if there is no free entry)
+
+ *---------------------------------------------------------------------------*/
+u16 NNS_G2dAddCellAnimScheduler
+(
+    NNSG2dCellAnimScheduler*    pSched,
+    NNSG2dCellAnimation*        pCellAnim
+)
+{
+    u16 handle;
+
+    NNS_G2D_NULL_ASSERT( pSched );
+    NNS_G2D_NULL_ASSERT( pCellAnim );
+    NNS_G2D_NULL_ASSERT( pCellAnim->animCtrl.pCurrent );
+
+    handle = pSched->freeIdx;
+    if( handle == NNS_G2D_CELLANIMSCHEDULER_NONE )
+    {
+        NNSI_G2D_DEBUGMSG0( "The CellAnimScheduler has no free entry." );
+        return NNS_G2D_CELLANIMSCHEDULER_INVALID_HANDLE;
+    }
+
+    {
+        NNSG2dCellAnimSchedulerEntry* pEntry = &pSched->pEntry[handle];
+
+        pSched->freeIdx = pEntry->next;
+        pSched->numEntry++;
+
+        pEntry->pCellAnim   = pCellAnim;
+        pEntry->baseTick    = pSched->currentTick;
+        pEntry->slot        = NNS_G2D_CELLANIMSCHEDULER_NONE;
+
+        ScheduleEntry_( pSched, handle );
+    }
+    return handle;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dRemoveCellAnimScheduler
+
+  Description:  Removes a cell animation from the scheduler.
+                The current time of the cell animation is advanced to the current tick.
+
+  Arguments:    pSched:             [OUT] cell animation scheduler
+                handle:             [IN]  handle of the cell animation
+
+  Returns:      None.
+
+ *---------------------------------------------------------------------------*/
+void NNS_G2dRemoveCellAnimScheduler
+(
+    NNSG2dCellAnimScheduler*    pSched,
+    u16                         handle
+)
+{
+    NNSG2dCellAnimSchedulerEntry* pEntry = GetEntry_( pSched, handle );
+
+    SyncEntry_( pSched, handle );
+    UnlinkEntry_( pSched, handle );
+
+    pEntry->pCellAnim   = NULL;
+    pEntry->next        = pSched->freeIdx;
+    pSched->freeIdx     = handle;
+    pSched->numEntry--;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dSyncCellAnimScheduler
+
+  Description:  Advances the current time of a registered cell animation to the
+                current tick.
+
+                The scheduler does not update the current time of a cell animation
+                until its animation frame changes. Call this before reading the
+                current time, and before changing the state of the cell animation
+                (speed, animation sequence, animation frame, start/stop, and so on).
+                Call NNS_G2dRescheduleCellAnimScheduler() after the change.
+
+  Arguments:    pSched:             [OUT] cell animation scheduler
+                handle:             [IN]  handle of the cell animation
+
+  Returns:      None.
+
+ *---------------------------------------------------------------------------*/
+void NNS_G2dSyncCellAnimScheduler
+(
+    NNSG2dCellAnimScheduler*    pSched,
+    u16                         handle
+)
+{
+    (void)GetEntry_( pSched, handle );
+
+    SyncEntry_( pSched, handle );
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dRescheduleCellAnimScheduler
+
+  Description:  Schedules a registered cell animation again after its state was
+                changed. Call NNS_G2dSyncCellAnimScheduler() before the change.
+
+  Arguments:    pSched:             [OUT] cell animation scheduler
+                handle:             [IN]  handle of the cell animation
+
+  Returns:      None.
+
+ *---------------------------------------------------------------------------*/
+void NNS_G2dRescheduleCellAnimScheduler
+(
+    NNSG2dCellAnimScheduler*    pSched,
+    u16                         handle
+)
+{
+    NNSG2dCellAnimSchedulerEntry* pEntry = GetEntry_( pSched, handle );
+
+    NNS_G2D_ASSERTMSG( pEntry->baseTick == pSched->currentTick,
+        "Call NNS_G2dSyncCellAnimScheduler() before changing the cell animation." );
+
+    UnlinkEntry_( pSched, handle );
+    pEntry->baseTick = pSched->currentTick;
+    ScheduleEntry_( pSched, handle );
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dTickCellAnimScheduler
+
+  Description:  Advances the registered cell animations by a tick.
+
+                NNS_G2dTickCellAnimation() is called only for the cell animations
+                whose animation frame changes in this tick. The animation callbacks
+                of those cell animations are called from it, and then the callback
+                of the scheduler is called once with all of them.
+
+                Do not add or remove cell animations from the animation callbacks.
+                Use the callback of the scheduler instead.
+
+  Arguments:    pSched:             [OUT] cell animation scheduler
+
+  Returns:      Number of cell animations whose animation frame changed
+
+ *---------------------------------------------------------------------------*/
+u16 NNS_G2dTickCellAnimScheduler( NNSG2dCellAnimScheduler* pSched )
+{
+    u16 handle;
+
+    NNS_G2D_NULL_ASSERT( pSched );
+
+    pSched->currentTick++;
+    pSched->numChanged  = 0;
+    pSched->numVisited  = 0;
+
+    handle = pSched->pWheel[pSched->currentTick & ( pSched->numSlot - 1 )];
+
+    while( handle != NNS_G2D_CELLANIMSCHEDULER_NONE )
+    {
+        NNSG2dCellAnimSchedulerEntry*   pEntry  = &pSched->pEntry[handle];
+        const u16                       next    = pEntry->next;
+
+        pSched->numVisited++;
+
+        //
+        // Entries that wake up in a later round of the wheel stay in the slot.
+        //
+        if( pEntry->wakeTick == pSched->currentTick )
+        {
+            NNSG2dCellAnimation*    pCellAnim = pEntry->pCellAnim;
+            NNSG2dAnimController*   pAnimCtrl = &pCellAnim->animCtrl;
+
+            UnlinkEntry_( pSched, handle );
+
+            //
+            // Advance to the previous tick, and let NNS_G2dTickCellAnimation
+            // process the tick in which the animation frame changes.
+            //
+            pAnimCtrl->currentTime += (fx32)( pSched->currentTick - 1 - pEntry->baseTick )
+                                        * GetTimePerTick_( pSched, pAnimCtrl );
+            NNS_G2dTickCellAnimation( pCellAnim, pSched->frames );
+
+            pEntry->baseTick = pSched->currentTick;
+            ScheduleEntry_( pSched, handle );
+
+            pSched->pChanged[pSched->numChanged] = pCellAnim;
+            pSched->numChanged++;
+        }
+        handle = next;
+    }
+
+    if( pSched->pCallBack != NULL && pSched->numChanged > 0 )
+    {
+        (*pSched->pCallBack)( pSched->pChanged, pSched->numChanged, pSched->callBackParam );
+    }
+
+    return pSched->numChanged;
+}
@@ -38,6 +38,10 @@
 #define MAX_OBJ1D_CHARACTER         8192
 #define MAX_OBJ2DRECT_HEIGHT        32
 
+// glyphs of these bpp are rendered a line at a time with the expansion table
+#define IS_EXPANDABLE_BPP( bpp )    ((bpp) == 1 || (bpp) == 2 || (bpp) == 4)
+#define EXPAND_TABLE_INDEX( bpp )   ((bpp) >> 1)
+
 
 /*---------------------------------------------------------------------------*
   Name:         LC_INFO
@@ -56,6 +60,9 @@ typedef struct LC_INFO
     int srcBpp;     // number of bits in 1 dot of the glyph image
     int dstBpp;     // number of bits in 1 dot of the render target character
     u32 cl;         // color number
+    const u32* expand;  // expansion table for srcBpp (NULL if srcBpp cannot be expanded)
+    const u32* raster;  // expanded glyph image in the glyph raster cache (NULL if none)
+    int rasterPitch;    // number of u32 in 1 line of raster
 }
 LC_INFO;
 
@@ -111,6 +118,11 @@ static const NNSiG2dCharCanvasVTable VTABLE_OBJ1D =
 static const NNSiG2dCharCanvasVTable VTABLE_OBJ2DRECT =
     { DrawGlyphLine, ClearLine, ClearAreaLine };
 
+// Expansion tables of 1, 2 and 4 bpp glyph images.
+// Each entry is the pixels of a glyph image byte, 4 bits per pixel, the first pixel in the lowest bits.
+static u32  sExpandTable[3][256];
+static BOOL sbExpandTableReady[3];
+
 
 
 
@@ -206,6 +218,160 @@ static NNS_G2D_INLINE const ObjectSize* GetMaxObjectSize(int w, int h)
 
 
 
+/*---------------------------------------------------------------------------*
+  Name:         GetExpandTable
+
+  Description:  Gets the expansion table of the glyph image bpp.
+                The table is built at the first use.
+
+  Arguments:    srcBpp: number of bits in 1 dot of the glyph image
+
+  Returns:      Pointer to the expansion table.
+                NULL if the glyph image of srcBpp cannot be expanded.
+ *---------------------------------------------------------------------------*/
+static NNS_G2D_INLINE const u32* GetExpandTable(int srcBpp)
+{
+    u32* pTable;
+
+    if( ! IS_EXPANDABLE_BPP(srcBpp) )
+    {
+        return NULL;
+    }
+
+    pTable = sExpandTable[EXPAND_TABLE_INDEX(srcBpp)];
+
+    if( ! sbExpandTableReady[EXPAND_TABLE_INDEX(srcBpp)] )
+    {
+        const u32 numPixel = 8 / (u32)srcBpp;
+        const u32 pixelMask = (1u << srcBpp) - 1;
+        u32 b;
+        u32 p;
+
+        for( b = 0; b < 256; b++ )
+        {
+            u32 val = 0;
+
+            // the glyph image is stored from the upper bits
+            for( p = 0; p < numPixel; p++ )
+            {
+                val |= ((b >> (8 - (p + 1) * srcBpp)) & pixelMask) << (p * 4);
+            }
+            pTable[b] = val;
+        }
+
+        sbExpandTableReady[EXPAND_TABLE_INDEX(srcBpp)] = TRUE;
+    }
+
+    return pTable;
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         ExpandGlyphBits
+
+  Description:  Expands up to 8 pixels of the glyph image to 4 bits per pixel.
+
+  Arguments:    pTable: expansion table for srcBpp
+                pSrc:   pointer to the glyph image
+                offset: position of the first pixel in bits from pSrc
+                nBits:  number of bits to expand (1 to 32)
+                srcBpp: number of bits in 1 dot of the glyph image
+
+  Returns:      The pixels, the first pixel in the lowest 4 bits.
+ *---------------------------------------------------------------------------*/
+static NNS_G2D_INLINE u32 ExpandGlyphBits(
+    const u32* pTable,
+    const u8* pSrc,
+    u32 offset,
+    u32 nBits,
+    int srcBpp
+)
+{
+    const u8* p = pSrc + offset / 8;
+    const u32 shift = offset % 8;
+    const u32 nBytes = (shift + nBits + 7) / 8;
+    const u32 step = 32 / (u32)srcBpp;
+    u32 bits = 0;
+    u32 val = 0;
+    u32 j;
+
+    NNS_G2D_MINMAX_ASSERT( nBits, 1, 32 );
+
+    // Load the bits left-justified. Only the bytes holding the pixels are read.
+    for( j = 0; j < nBytes && j < 4; j++ )
+    {
+        bits |= (u32)p[j] << (24 - j * 8);
+    }
+    bits <<= shift;
+    if( nBytes > 4 )
+    {
+        bits |= (u32)p[4] >> (8 - shift);
+    }
+    bits &= (u32)(~0) << (32 - nBits);
+
+    for( j = 0; j < (nBits + 7) / 8; j++ )
+    {
+        val |= pTable[(bits >> (24 - j * 8)) & 0xFF] << (j * step);
+    }
+
+    return val;
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         SpreadNibble
+
+  Description:  Spreads 4 pixels of 4 bits to 8 bits per pixel.
+
+  Arguments:    val:    4 pixels in the lower 16 bits
+
+  Returns:      The 4 pixels, 8 bits per pixel.
+ *---------------------------------------------------------------------------*/
+static NNS_G2D_INLINE u32 SpreadNibble(u32 val)
+{
+    val = (val | (val << 8)) & 0x00FF00FF;
+    val = (val | (val << 4)) & 0x0F0F0F0F;
+    return val;
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         MergeLine4 / MergeLine8
+
+  Description:  Writes the non-zero pixels of the expanded glyph to
+                a 32-bit word of the character, with the color number added.
+
+  Arguments:    pDst:   pointer to the word of the character
+                val:    glyph pixels at their position in the word
+                cl:     color number repeated for each pixel of the word
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static NNS_G2D_INLINE void MergeLine4(u32* pDst, u32 val, u32 cl)
+{
+    u32 mask = val | (val >> 1);
+
+    mask |= mask >> 2;
+    mask = (mask & 0x11111111) * 0xF;
+
+    *pDst = (*pDst & ~mask) | ((val + cl) & mask);
+}
+
+static NNS_G2D_INLINE void MergeLine8(u32* pDst, u32 val, u32 cl)
+{
+    u32 mask = val | (val >> 1);
+
+    mask |= mask >> 2;
+    mask = (mask & 0x01010101) * 0xFF;
+
+    *pDst = (*pDst & ~mask) | ((val + cl) & mask);
+}
+
+
+
 
 
 //****************************************************************************
@@ -487,6 +653,107 @@ static void ClearChar(void* pChar, int x, int y, int w, int h, u32 cl8, int bpp)
 
 
 
+/*---------------------------------------------------------------------------*
+  Name:         LetterCharWord
+
+  Description:  Renders a single character worth of the character rendering.
+                The pixels of each line are expanded with the expansion table,
+                or taken from the glyph raster cache, and written a word at a time.
+                This is for 1, 2 and 4 bpp glyph images.
+
+  Arguments:    i:      pointer to the render information structure
+                x_st:   begin character rendering X coordinate
+                x_ed:   character rendering end X coordinate
+                y_st:   begin character rendering Y coordinate
+                y_ed:   character rendering end Y coordinate
+                src_x:  glyph image X coordinate rendered at x_st
+                src_y:  glyph image Y coordinate rendered at y_st
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void LetterCharWord(
+    const LC_INFO* i,
+    u32 x_st,
+    u32 x_ed,
+    u32 y_st,
+    u32 y_ed,
+    u32 src_x,
+    u32 src_y
+)
+{
+    const u32 nPixel = x_ed - x_st;
+    const u32 pixelMask = (nPixel >= 8) ? (u32)(~0): ((1u << (nPixel * 4)) - 1);
+    const int srcBpp = i->srcBpp;
+    u32 offset = src_y * i->dsrc + src_x * srcBpp;
+    const u32* pRaster = NULL;
+    u32 rasterShift = 0;
+    u32 y;
+
+    NNS_G2D_ASSERT( IS_EXPANDABLE_BPP(srcBpp) );
+
+    if( i->raster != NULL )
+    {
+        pRaster = i->raster + src_y * i->rasterPitch + src_x / 8;
+        rasterShift = (src_x % 8) * 4;
+    }
+
+    for( y = y_st; y < y_ed; y++ )
+    {
+        u32 val;
+
+        // pixels of the line, the first pixel in the lowest 4 bits
+        if( pRaster != NULL )
+        {
+            val = pRaster[0] >> rasterShift;
+            if( rasterShift != 0 )
+            {
+                val |= pRaster[1] << (32 - rasterShift);
+            }
+            val &= pixelMask;
+
+            pRaster += i->rasterPitch;
+        }
+        else
+        {
+            val = ExpandGlyphBits(i->expand, i->src, offset, nPixel * srcBpp, srcBpp);
+            offset += i->dsrc;
+        }
+
+        if( val == 0 )
+        {
+            continue;
+        }
+
+        if( i->dstBpp == 4 )
+        {
+            MergeLine4((u32*)i->dst + y, val << (x_st * 4), i->cl * 0x11111111);
+        }
+        else
+        {
+            const u32 shift = x_st * 8;
+            u32* pDst = (u32*)( (u64*)i->dst + y );
+            u32 val_0 = SpreadNibble(val & 0xFFFF);
+            u32 val_1 = SpreadNibble(val >> 16);
+
+            if( shift >= 32 )
+            {
+                val_1 = val_0 << (shift - 32);
+                val_0 = 0;
+            }
+            else if( shift > 0 )
+            {
+                val_1 = (val_1 << shift) | (val_0 >> (32 - shift));
+                val_0 <<= shift;
+            }
+
+            MergeLine8(pDst,     val_0, i->cl * 0x01010101);
+            MergeLine8(pDst + 1, val_1, i->cl * 0x01010101);
+        }
+    }
+}
+
+
+
 /*---------------------------------------------------------------------------*
   Name:         LetterChar
 
@@ -542,6 +809,13 @@ static void LetterChar(LC_INFO* i)
     NNS_G2D_ASSERT( x_ed <= CHARACTER_WIDTH );
     NNS_G2D_ASSERT( y_ed <= CHARACTER_HEIGHT );
 
+    if( i->expand != NULL )
+    {
+        LetterCharWord(i, x_st, x_ed, y_st, y_ed,
+            (u32)- MATH_IMin(i->ofs_x, 0), (u32)- MATH_IMin(i->ofs_y, 0));
+        return;
+    }
+
     // begin character rendering
     {
         u32 x;           //
@@ -628,6 +902,70 @@ static void LetterChar(LC_INFO* i)
 
 
 
+/*---------------------------------------------------------------------------*
+  Name:         GetGlyphRaster
+
+  Description:  Gets the expanded glyph image from the glyph raster cache.
+                The glyph image is expanded into the cache if it is not found.
+
+  Arguments:    pCache: Pointer to the glyph raster cache.
+                pFont:  Pointer to the font of the glyph.
+                image:  Pointer to the glyph image.
+
+  Returns:      Pointer to the expanded glyph image.
+ *---------------------------------------------------------------------------*/
+static const u32* GetGlyphRaster(
+    NNSG2dGlyphRasterCache* pCache,
+    const NNSG2dFont* pFont,
+    const u8* image
+)
+{
+    const u32 iEntry = ((u32)image / pCache->cellSize) & pCache->mask;
+    u32* const pRaster = pCache->pRaster + iEntry * pCache->entryWords;
+
+    NNS_G2D_ASSERTMSG(
+        NNS_G2dFontGetBpp(pFont) == pCache->bpp
+        && NNS_G2dFontGetCellWidth(pFont) == pCache->cellWidth
+        && NNS_G2dFontGetCellHeight(pFont) == pCache->cellHeight,
+        "The glyph raster cache is not for this font." );
+
+    if( pCache->pTag[iEntry] == image )
+    {
+        pCache->numHit++;
+        return pRaster;
+    }
+
+    // expand the glyph image
+    {
+        const u32* pTable = GetExpandTable(pCache->bpp);
+        const u32 bpp = pCache->bpp;
+        const u32 dsrc = pCache->cellWidth * bpp;
+        u32* pDst = pRaster;
+        u32 y;
+        u32 x;
+
+        for( y = 0; y < pCache->cellHeight; y++ )
+        {
+            for( x = 0; x < pCache->cellWidth; x += 8 )
+            {
+                const u32 nPixel = (u32)MATH_IMin(8, (int)(pCache->cellWidth - x));
+
+                *pDst++ = ExpandGlyphBits(pTable, image, y * dsrc + x * bpp, nPixel * bpp, (int)bpp);
+            }
+
+            // padding
+            *pDst++ = 0;
+        }
+    }
+
+    pCache->pTag[iEntry] = image;
+    pCache->numMiss++;
+
+    return pRaster;
+}
+
+
+
 /*---------------------------------------------------------------------------*
   Name:         DrawGlyphLine
 
@@ -754,6 +1092,16 @@ static void DrawGlyphLine(
         i.srcBpp    = NNS_G2dFontGetBpp(pFont);
         i.dstBpp    = pCC->dstBpp;
         i.dsrc      = NNS_G2dFontGetCellWidth(pFont) * i.srcBpp;
+        i.raster    = NULL;
+
+        // Color number 0 renders (pixel - 1) and is left to the bit by bit rendering.
+        i.expand    = (cl > 0) ? GetExpandTable(i.srcBpp): NULL;
+
+        if( i.expand != NULL && pCC->pRasterCache != NULL )
+        {
+            i.raster      = GetGlyphRaster(pCC->pRasterCache, pFont, pGlyph->image);
+            i.rasterPitch = pCC->pRasterCache->rowWords;
+        }
 
         for( ; ofs_y > ofs_y_end; ofs_y -= CHARACTER_HEIGHT )
         {
@@ -897,6 +1245,16 @@ static void DrawGlyph1D(
         i.srcBpp    = NNS_G2dFontGetBpp(pFont);
         i.dstBpp    = pCC->dstBpp;
         i.dsrc      = NNS_G2dFontGetCellWidth(pFont) * i.srcBpp;
+        i.raster    = NULL;
+
+        // Color number 0 renders (pixel - 1) and is left to the bit by bit rendering.
+        i.expand    = (cl > 0) ? GetExpandTable(i.srcBpp): NULL;
+
+        if( i.expand != NULL && pCC->pRasterCache != NULL )
+        {
+            i.raster      = GetGlyphRaster(pCC->pRasterCache, pFont, pGlyph->image);
+            i.rasterPitch = pCC->pRasterCache->rowWords;
+        }
 
         p.packed = pCC->param;
 
@@ -1206,6 +1564,7 @@ static void InitCharCanvas(
     pCC->charBase   = charBase;
     pCC->vtable     = vtable;
     pCC->param      = param;
+    pCC->pRasterCache = NULL;
 }
 
 /*---------------------------------------------------------------------------*
@@ -1551,6 +1910,144 @@ void NNS_G2dCharCanvasInitForOBJ2DRect(
 
 
 
+/*---------------------------------------------------------------------------*
+  Name:         NNSi_G2dCharCanvasGetCharPtr
+
+  Description:  Gets the pointer to the character at the specified position in CharCanvas.
+
+  Arguments:    pCC:    Pointer to CharCanvas.
+                cx:     X position of the character (in character units)
+                cy:     Y position of the character (in character units)
+
+  Returns:      Pointer to the character.
+ *---------------------------------------------------------------------------*/
+u8* NNSi_G2dCharCanvasGetCharPtr(
+    const NNSG2dCharCanvas* pCC,
+    int cx,
+    int cy
+)
+{
+    u32 iChar;
+
+    NNS_G2D_CHARCANVAS_ASSERT( pCC );
+    NNS_G2D_MINMAX_ASSERT( cx, 0, pCC->areaWidth - 1 );
+    NNS_G2D_MINMAX_ASSERT( cy, 0, pCC->areaHeight - 1 );
+
+    if( pCC->vtable == &VTABLE_OBJ1D )
+    {
+        OBJ1DParam p;
+
+        p.packed = pCC->param;
+        iChar = GetCharIndex1D( (u32)cx, (u32)cy,
+                    (u32)pCC->areaWidth, (u32)pCC->areaHeight,
+                    p.baseWidthShift, p.baseHeightShift );
+    }
+    else
+    {
+        // pCC->param == number of characters in one line
+        iChar = pCC->param * cy + cx;
+    }
+
+    return pCC->charBase + iChar * GetCharacterSize(pCC);
+}
+
+
+
+//----------------------------------------------------------------------------
+// Glyph Raster Cache
+//----------------------------------------------------------------------------
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGlyphRasterCacheGetBufferSize
+
+  Description:  Calculates the size of the buffer required by a glyph raster cache.
+
+  Arguments:    pFont:      Pointer to the font to cache.
+                numEntry:   Number of glyphs in the cache.
+
+  Returns:      Required buffer size in bytes.
+ *---------------------------------------------------------------------------*/
+u32 NNS_G2dGlyphRasterCacheGetBufferSize(
+    const NNSG2dFont* pFont,
+    u32 numEntry
+)
+{
+    u32 rowWords;
+
+    NNS_G2D_FONT_ASSERT( pFont );
+    NNS_G2D_ASSERT( IS_EXPANDABLE_BPP(NNS_G2dFontGetBpp(pFont)) );
+
+    rowWords = (u32)(NNS_G2dFontGetCellWidth(pFont) + 7) / 8 + 1;
+
+    return numEntry * ( sizeof(const u8*)
+                        + rowWords * NNS_G2dFontGetCellHeight(pFont) * sizeof(u32) );
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGlyphRasterCacheInit
+
+  Description:  Initializes the glyph raster cache.
+
+  Arguments:    pCache:     Pointer to the glyph raster cache.
+                pFont:      Pointer to the font to cache.
+                pBuffer:    Pointer to the buffer of the cache.
+                numEntry:   Number of glyphs in the cache. Must be a power of 2.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dGlyphRasterCacheInit(
+    NNSG2dGlyphRasterCache* pCache,
+    const NNSG2dFont* pFont,
+    void* pBuffer,
+    u32 numEntry
+)
+{
+    NNS_G2D_POINTER_ASSERT( pCache );
+    NNS_G2D_FONT_ASSERT( pFont );
+    NNS_G2D_POINTER_ASSERT( pBuffer );
+    NNS_G2D_ALIGN_ASSERT( pBuffer, 4 );
+    NNS_G2D_ASSERT( IS_EXPANDABLE_BPP(NNS_G2dFontGetBpp(pFont)) );
+    NNS_G2D_ASSERTMSG( numEntry > 0 && (numEntry & (numEntry - 1)) == 0,
+                       "numEntry must be a power of 2" );
+
+    pCache->cellWidth   = NNS_G2dFontGetCellWidth(pFont);
+    pCache->cellHeight  = NNS_G2dFontGetCellHeight(pFont);
+    pCache->bpp         = NNS_G2dFontGetBpp(pFont);
+    pCache->cellSize    = (u32)NNSi_G2dFontGetGlyphDataSize(pFont);
+    pCache->rowWords    = (u16)((pCache->cellWidth + 7) / 8 + 1);
+    pCache->entryWords  = (u16)(pCache->rowWords * pCache->cellHeight);
+    pCache->mask        = numEntry - 1;
+    pCache->pTag        = (const u8**)pBuffer;
+    pCache->pRaster     = (u32*)(pCache->pTag + numEntry);
+
+    NNS_G2dGlyphRasterCacheClear( pCache );
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGlyphRasterCacheClear
+
+  Description:  Empties the glyph raster cache.
+
+  Arguments:    pCache:     Pointer to the glyph raster cache.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dGlyphRasterCacheClear( NNSG2dGlyphRasterCache* pCache )
+{
+    NNS_G2D_POINTER_ASSERT( pCache );
+
+    MI_CpuClear32( pCache->pTag, sizeof(const u8*) * (pCache->mask + 1) );
+    pCache->numHit  = 0;
+    pCache->numMiss = 0;
+}
+
+
+
+
 
 //****************************************************************************
 // BG Screen Structure Functions
@@ -33,3 +33,56 @@ BOOL NNS_G2dIsInViewCircle( const NNSG2dFVec2* pTopLeft, const NNSG2dFVec2* pSiz
     return TRUE;
 }
 
+//------------------------------------------------------------------------------
+BOOL NNS_G2dIsCellInViewRect
+(
+    const NNSG2dCellData*   pCell,
+    const MtxFx32*          pMtx,
+    const NNSG2dViewRect*   pViewRect
+)
+{
+    fx32    cx, cy;     // center of the bounding rectangle (cell local)
+    fx32    hx, hy;     // half size of the bounding rectangle (cell local)
+    fx32    px, py;     // center of the enclosing rectangle (view)
+    fx32    ex, ey;     // half size of the enclosing rectangle (view)
+    
+    NNS_G2D_NULL_ASSERT( pCell );
+    NNS_G2D_NULL_ASSERT( pMtx );
+    NNS_G2D_NULL_ASSERT( pViewRect );
+    
+    if( NNS_G2dCellHasBR( pCell ) )
+    {
+        const NNSG2dCellBoundingRectS16* pBR = NNS_G2dGetCellBoundingRect( pCell );
+        
+        cx = ( pBR->minX + pBR->maxX ) << ( FX32_SHIFT - 1 );
+        cy = ( pBR->minY + pBR->maxY ) << ( FX32_SHIFT - 1 );
+        hx = ( pBR->maxX - pBR->minX ) << ( FX32_SHIFT - 1 );
+        hy = ( pBR->maxY - pBR->minY ) << ( FX32_SHIFT - 1 );
+    }else{
+        const fx32 R = NNS_G2dGetCellBoundingSphereR( pCell ) << FX32_SHIFT;
+        
+        // no bounding information: cannot be culled
+        if( R == 0 )
+        {
+            return TRUE;
+        }
+        cx = cy = 0;
+        hx = hy = R;
+    }
+    
+    //
+    // transform the bounding rectangle
+    //
+    px = FX_Mul( cx, pMtx->_00 ) + FX_Mul( cy, pMtx->_10 ) + pMtx->_20 - pViewRect->posTopLeft.x;
+    py = FX_Mul( cx, pMtx->_01 ) + FX_Mul( cy, pMtx->_11 ) + pMtx->_21 - pViewRect->posTopLeft.y;
+    ex = FX_Mul( hx, MATH_ABS( pMtx->_00 ) ) + FX_Mul( hy, MATH_ABS( pMtx->_10 ) );
+    ey = FX_Mul( hx, MATH_ABS( pMtx->_01 ) ) + FX_Mul( hy, MATH_ABS( pMtx->_11 ) );
+    
+    if( px + ex <= 0 || px - ex >= pViewRect->sizeView.x )
+        return FALSE;
+    
+    if( py + ey <= 0 || py - ey >= pViewRect->sizeView.y )
+        return FALSE;
+    
+    return TRUE;
+}
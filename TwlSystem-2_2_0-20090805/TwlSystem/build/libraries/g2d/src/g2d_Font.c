@@ -127,6 +127,77 @@ static NNS_G2D_INLINE const NNSG2dCharWidths* GetCharWidthsFromIndex( const NNSG
 
 
 
+/*---------------------------------------------------------------------------*
+  Name:         SearchGlyphIndex
+
+  Description:  Searches the character code map block list of the font
+                for the glyph index that corresponds to c.
+
+  Arguments:    pRes:   Pointer to the expanded font resource.
+                c:      character code
+
+  Returns:      Glyph index that corresponds to c.
+                Returns NNS_G2D_GLYPH_INDEX_NOT_FOUND if one does not exist.
+ *---------------------------------------------------------------------------*/
+static u16 SearchGlyphIndex( const NNSG2dFontInformation* pRes, u16 c )
+{
+    const NNSG2dFontCodeMap* pMap = pRes->pMap;
+
+    // linear search for the CMAP block list
+    while( pMap != NULL )
+    {
+        if( (pMap->ccodeBegin <= c) && (c <= pMap->ccodeEnd) )
+        {
+            return GetGlyphIndex(pMap, c);
+        }
+
+        pMap = pMap->pNext;
+    }
+
+    // not found
+    return NNS_G2D_GLYPH_INDEX_NOT_FOUND;
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         LookupGlyphCache
+
+  Description:  Gets the glyph cache entry of c.
+                On a miss, the entry is overwritten with the result of the search in the font.
+
+  Arguments:    pFont:  Pointer to the font with a glyph cache.
+                c:      character code
+
+  Returns:      Pointer to the glyph cache entry of c.
+ *---------------------------------------------------------------------------*/
+static const NNSG2dGlyphCacheEntry* LookupGlyphCache( const NNSG2dFont* pFont, u16 c )
+{
+    NNSG2dGlyphCache* const pCache = pFont->pCache;
+    NNSG2dGlyphCacheEntry* const pEntry
+        = &pCache->pEntry[NNSi_G2D_GLYPH_CACHE_HASH(c) & pCache->mask];
+
+    if( pEntry->pWidths != NULL && pEntry->ccode == c )
+    {
+        pCache->numHit++;
+        return pEntry;
+    }
+
+    pCache->numMiss++;
+    pEntry->ccode = c;
+    pEntry->index = SearchGlyphIndex(pFont->pRes, c);
+
+    // Characters without glyph only record that they are not found.
+    // Their width depends on the alternate character, which can be changed.
+    pEntry->pWidths = (pEntry->index != NNS_G2D_GLYPH_INDEX_NOT_FOUND) ?
+                            NNS_G2dFontGetCharWidthsFromIndex(pFont, pEntry->index):
+                            &(pFont->pRes->defaultWidth);
+
+    return pEntry;
+}
+
+
+
 
 
 //*******************************************************************************
@@ -165,6 +236,7 @@ void NNS_G2dFontInitAuto(NNSG2dFont* pFont, void* pNftrFile)
     NNS_G2D_MINMAX_ASSERT( encoding, 0, NNS_G2D_NUM_OF_ENCODING - 1 );
 
     pFont->cbCharSpliter = spliterTable[encoding];
+    pFont->pCache        = NULL;
 }
 
 
@@ -181,6 +253,7 @@ void NNS_G2dFontInitAuto(NNSG2dFont* pFont, void* pNftrFile)
                                     == NNS_G2D_FONT_ENCODING_##enc );       \
                                                                             \
         pFont->cbCharSpliter = NNSi_G2dSplitChar##spliter;                  \
+        pFont->pCache        = NULL;                                        \
     }
 
 NNS_G2D_DEFINE_FONT_INIT(UTF8, UTF8, UTF8)
@@ -203,25 +276,14 @@ NNS_G2D_DEFINE_FONT_INIT(CP1252, CP1252, 1Byte)
  *---------------------------------------------------------------------------*/
 u16 NNS_G2dFontFindGlyphIndex( const NNSG2dFont* pFont, u16 c )
 {
-    const NNSG2dFontCodeMap* pMap;
-
     NNS_G2D_FONT_ASSERT(pFont);
 
-    pMap = pFont->pRes->pMap;
-
-    // linear search for the CMAP block list
-    while( pMap != NULL )
+    if( pFont->pCache != NULL )
     {
-        if( (pMap->ccodeBegin <= c) && (c <= pMap->ccodeEnd) )
-        {
-            return GetGlyphIndex(pMap, c);
-        }
-
-        pMap = pMap->pNext;
+        return LookupGlyphCache(pFont, c)->index;
     }
 
-    // not found
-    return NNS_G2D_GLYPH_INDEX_NOT_FOUND;
+    return SearchGlyphIndex(pFont->pRes, c);
 }
 
 
@@ -264,6 +326,113 @@ const NNSG2dCharWidths* NNS_G2dFontGetCharWidthsFromIndex( const NNSG2dFont* pFo
 
 
 
+/*---------------------------------------------------------------------------*
+  Name:         NNSi_G2dFontGetCachedCharWidths
+
+  Description:  Gets the character width information from the character code
+                through the glyph cache of the font.
+
+  Arguments:    pFont:  Pointer to the font. A glyph cache must be attached.
+                c:      character code
+
+  Returns:      Pointer to the character width information.
+ *---------------------------------------------------------------------------*/
+const NNSG2dCharWidths* NNSi_G2dFontGetCachedCharWidths( const NNSG2dFont* pFont, u16 c )
+{
+    const NNSG2dGlyphCacheEntry* pEntry;
+
+    NNS_G2D_FONT_ASSERT(pFont);
+    NNS_G2D_POINTER_ASSERT(pFont->pCache);
+
+    pEntry = LookupGlyphCache(pFont, c);
+
+    if( pEntry->index != NNS_G2D_GLYPH_INDEX_NOT_FOUND )
+    {
+        return pEntry->pWidths;
+    }
+
+    return NNS_G2dFontGetCharWidthsFromIndex(pFont, pFont->pRes->alterCharIndex);
+}
+
+
+
+//----------------------------------------------------------------------------
+// Glyph cache
+//----------------------------------------------------------------------------
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGlyphCacheInit
+
+  Description:  Initializes the glyph cache.
+
+  Arguments:    pCache:     Pointer to the glyph cache.
+                pEntry:     Pointer to the entry array.
+                numEntry:   Number of entries in pEntry. Must be a power of 2.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dGlyphCacheInit(
+    NNSG2dGlyphCache*       pCache,
+    NNSG2dGlyphCacheEntry*  pEntry,
+    u32                     numEntry
+)
+{
+    NNS_G2D_POINTER_ASSERT( pCache );
+    NNS_G2D_POINTER_ASSERT( pEntry );
+    NNS_G2D_ASSERTMSG( numEntry > 0 && (numEntry & (numEntry - 1)) == 0,
+                       "numEntry must be a power of 2" );
+
+    pCache->pEntry = pEntry;
+    pCache->mask   = numEntry - 1;
+
+    NNS_G2dGlyphCacheClear( pCache );
+    NNS_G2dGlyphCacheResetStats( pCache );
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGlyphCacheClear
+
+  Description:  Empties all the entries of the glyph cache.
+
+  Arguments:    pCache:     Pointer to the glyph cache.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dGlyphCacheClear( NNSG2dGlyphCache* pCache )
+{
+    NNS_G2D_POINTER_ASSERT( pCache );
+
+    // An entry is empty when pWidths is NULL.
+    MI_CpuClearFast( pCache->pEntry, sizeof(NNSG2dGlyphCacheEntry) * (pCache->mask + 1) );
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dFontSetGlyphCache
+
+  Description:  Attaches the glyph cache to the font.
+
+  Arguments:    pFont:      Pointer to the font.
+                pCache:     Pointer to the glyph cache. NULL to stop using the cache.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dFontSetGlyphCache( NNSG2dFont* pFont, NNSG2dGlyphCache* pCache )
+{
+    NNS_G2D_FONT_ASSERT(pFont);
+
+    if( pCache != NULL )
+    {
+        NNS_G2dGlyphCacheClear( pCache );
+    }
+    pFont->pCache = pCache;
+}
+
+
+
 
 
 
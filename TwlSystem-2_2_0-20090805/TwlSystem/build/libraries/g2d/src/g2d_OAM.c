@@ -75,7 +75,8 @@ typedef struct OamAttributeCache
 // 
 typedef struct OamAffineCache
 {
-    u16             reservationTable[NUM_HW_OAM_AFFINE]; // AffineParameter reservation table
+    u16                     reservationTable[NUM_HW_OAM_AFFINE]; // AffineParameter reservation table
+    NNSG2dOamAffineCache*   pSharingList;   // Affine caches set to the instances of this OAM type
     
 }OamAffineCache;
 
@@ -647,6 +648,420 @@ static NNS_G2D_INLINE void ResetAffine_( NNSG2dOamType type, u16 fromIdx, u16 to
     }
 }
 
+//------------------------------------------------------------------------------
+// Registers the OAM attribute to the sort buffer.
+// The affine index is set in the same way as NNS_G2dEntryOamManagerOamWithAffineIdx().
+static NNS_G2D_INLINE void EntrySortBuffer_
+( 
+    NNSG2dOamSortBuffer*    pSortBuffer, 
+    const GXOamAttr*        pOam, 
+    u16                     affineIdx, 
+    u16                     sortKey 
+)
+{
+    GXOamAttr* pOamAttr = &pSortBuffer->pAttr[pSortBuffer->numUsed];
+    
+    NNS_G2D_ASSERT( pSortBuffer->numUsed < pSortBuffer->numEntry );
+    NNS_G2D_MINMAX_ASSERT( sortKey, 0, pSortBuffer->numKey - 1 );
+    
+    pOamAttr->attr0 = pOam->attr0;
+    pOamAttr->attr1 = pOam->attr1;
+    pOamAttr->attr2 = pOam->attr2;
+    
+    if( NNS_G2D_OAM_AFFINE_IDX_NONE != affineIdx && ( pOamAttr->rsMode & 0x1 ) )
+    {
+        pOamAttr->rsParam = affineIdx;
+    }
+    
+    pSortBuffer->pKey[pSortBuffer->numUsed] = sortKey;
+    pSortBuffer->numUsed++;
+    pSortBuffer->bSnapshot = FALSE;
+    
+    pSortBuffer->stats.numEntry++;
+}
+
+//------------------------------------------------------------------------------
+// Sorts the registration numbers in the sort buffer by sort key.
+// 
+// Bucket sort in O( number of OAM attributes + number of sort keys ).
+// OAM attributes with the same sort key keep their registration order.
+// 
+static void SortOamSortBuffer_( NNSG2dOamSortBuffer* pSortBuffer )
+{
+    u16* const          pBucket = pSortBuffer->pBucket;
+    const u16* const    pKey    = pSortBuffer->pKey;
+    u32                 i;
+    
+    // Counts the OAM attributes for each sort key.
+    MI_CpuClear16( pBucket, sizeof( u16 ) * ( pSortBuffer->numKey + 1 ) );
+    for( i = 0; i < pSortBuffer->numUsed; i++ )
+    {
+        pBucket[pKey[i] + 1]++;
+    }
+    
+    // pBucket[key] = position of the first OAM attribute with the sort key
+    for( i = 1; i <= pSortBuffer->numKey; i++ )
+    {
+        pBucket[i] = (u16)( pBucket[i] + pBucket[i - 1] );
+    }
+    
+    for( i = 0; i < pSortBuffer->numUsed; i++ )
+    {
+        pSortBuffer->pOrder[pBucket[pKey[i]]++] = (u16)i;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Takes the snapshot of the sort buffer.
+// 
+// Copies the registered OAM attributes to pDispAttr in sorted order, and the affine 
+// parameters of the manage area to dispAffine.
+// The applies read only the snapshot, so the registered OAM attributes and affine parameters 
+// can be reset and registered again for the next frame while the line ranges are being applied.
+// The statistics of the applies of the snapshot are counted in the statistics of the current frame.
+// 
+static void TakeSortBufferSnapshot_( NNSG2dOamManagerInstance* pMan )
+{
+    NNSG2dOamSortBuffer* const pSortBuffer = pMan->pSortBuffer;
+    u16 i;
+    
+    SortOamSortBuffer_( pSortBuffer );
+    
+    for( i = 0; i < pSortBuffer->numUsed; i++ )
+    {
+        const GXOamAttr* pSrc = &pSortBuffer->pAttr[pSortBuffer->pOrder[i]];
+        
+        pSortBuffer->pDispAttr[i].attr0 = pSrc->attr0;
+        pSortBuffer->pDispAttr[i].attr1 = pSrc->attr1;
+        pSortBuffer->pDispAttr[i].attr2 = pSrc->attr2;
+    }
+    
+    pSortBuffer->numDisp    = pSortBuffer->numUsed;
+    pSortBuffer->bSnapshot  = TRUE;
+    pSortBuffer->bDispLast  = FALSE;
+    
+    pSortBuffer->numDispAffine = 0;
+    if( IsManageAreaValid_( &pMan->managedAffineArea ) )
+    {
+        const GXOamAffine* pAff = GetAffineBufferPtr_( pMan->type, pMan->managedAffineArea.fromIdx );
+        
+        pSortBuffer->dispAffineFrom = pMan->managedAffineArea.fromIdx;
+        pSortBuffer->numDispAffine  = (u16)( pMan->managedAffineArea.toIdx 
+                                           - pMan->managedAffineArea.fromIdx + 1 );
+        NNS_G2D_ASSERT( pSortBuffer->numDispAffine <= NNS_G2D_OAMSORT_NUM_AFFINE );
+        
+        for( i = 0; i < pSortBuffer->numDispAffine; i++ )
+        {
+            pSortBuffer->dispAffine[i][0] = pAff[i].PA;
+            pSortBuffer->dispAffine[i][1] = pAff[i].PB;
+            pSortBuffer->dispAffine[i][2] = pAff[i].PC;
+            pSortBuffer->dispAffine[i][3] = pAff[i].PD;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Exchanges the affine parameters of the snapshot with those of the OAM buffer.
+// 
+// Called before and after loading a line range, so the range is loaded with the 
+// affine parameters of its frame and the affine parameters of the next frame 
+// registered in the meantime are kept.
+// 
+static void ExchangeDispAffine_( NNSG2dOamManagerInstance* pMan )
+{
+    NNSG2dOamSortBuffer* const pSortBuffer = pMan->pSortBuffer;
+    GXOamAffine*    pAff;
+    s16             tmp;
+    u16             i;
+    
+    if( pSortBuffer->numDispAffine == 0 )
+    {
+        return;
+    }
+    
+    pAff = GetAffineBufferPtr_( pMan->type, pSortBuffer->dispAffineFrom );
+    for( i = 0; i < pSortBuffer->numDispAffine; i++ )
+    {
+        tmp = pAff[i].PA; pAff[i].PA = pSortBuffer->dispAffine[i][0]; pSortBuffer->dispAffine[i][0] = tmp;
+        tmp = pAff[i].PB; pAff[i].PB = pSortBuffer->dispAffine[i][1]; pSortBuffer->dispAffine[i][1] = tmp;
+        tmp = pAff[i].PC; pAff[i].PC = pSortBuffer->dispAffine[i][2]; pSortBuffer->dispAffine[i][2] = tmp;
+        tmp = pAff[i].PD; pAff[i].PD = pSortBuffer->dispAffine[i][3]; pSortBuffer->dispAffine[i][3] = tmp;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Determines whether the OBJ is displayed on a line from fromLine to toLine.
+static NNS_G2D_INLINE BOOL IsOamOnLines_( const GXOamAttr* pOam, int fromLine, int toLine )
+{
+    if( NNSi_G2dIsVisible( pOam ) )
+    {
+        const GXOamShape    shape   = NNS_G2dGetOAMSize( pOam );
+        const int           top     = NNSi_G2dRepeatYinScreenArea( NNSi_G2dGetOamY( pOam ) );
+        int                 height  = NNS_G2dGetOamSizeY( &shape );
+        
+        // The double size affine OBJ
+        if( pOam->rsMode == 0x3 )
+        {
+            height *= 2;
+        }
+        
+        return (BOOL)( top <= toLine && top + height > fromLine );
+    }
+    return FALSE;
+}
+
+//------------------------------------------------------------------------------
+// Writes the OAM attributes of the sort buffer to the manage area of the OAM buffer in sorted order.
+// 
+// If bLimitLines is TRUE, only the OBJs displayed on a line from fromLine to toLine are written.
+// The OAM attributes that do not fit in the manage area are counted in the statistics.
+// 
+// The snapshot is taken again only by the first apply of a frame: an apply of all lines, or 
+// a line range that does not follow the previous range. The following ranges of the frame 
+// use the same snapshot even if the sort buffer has been reset in the meantime, and 
+// count their statistics in lastStats in that case.
+// 
+static void ApplySortBuffer_
+( 
+    NNSG2dOamManagerInstance*   pMan, 
+    BOOL                        bLimitLines, 
+    int                         fromLine, 
+    int                         toLine 
+)
+{
+    NNSG2dOamSortBuffer* const  pSortBuffer = pMan->pSortBuffer;
+    GXOamAttr* const            pDst        = GetOamFromPtr_( pMan );
+    const u16                   numArea     = (u16)( pMan->managedAttrArea.toIdx 
+                                                   - pMan->managedAttrArea.fromIdx + 1 );
+    u16                         numApply    = 0;
+    u16                         numRequest  = 0;
+    NNSG2dOamSortStats*         pStats;
+    u16                         i;
+    
+    NNS_G2D_NULL_ASSERT( pSortBuffer );
+    
+    if( ! pSortBuffer->bSnapshot )
+    {
+        if( ! bLimitLines 
+            || pSortBuffer->prevToLine < 0 
+            || fromLine <= pSortBuffer->prevToLine )
+        {
+            TakeSortBufferSnapshot_( pMan );
+        }
+    }
+    pSortBuffer->prevToLine = (s16)( bLimitLines ? toLine : -1 );
+    
+    for( i = 0; i < pSortBuffer->numDisp; i++ )
+    {
+        const GXOamAttr* pOam = &pSortBuffer->pDispAttr[i];
+        
+        if( bLimitLines && ! IsOamOnLines_( pOam, fromLine, toLine ) )
+        {
+            continue;
+        }
+        
+        numRequest++;
+        if( numApply < numArea )
+        {
+            //
+            // Copies only the OAM attributes portion so affine parameters are not overwritten.
+            //
+            pDst[numApply].attr0 = pOam->attr0;
+            pDst[numApply].attr1 = pOam->attr1;
+            pDst[numApply].attr2 = pOam->attr2;
+            numApply++;
+        }
+    }
+    
+    // Hides the rest of the manage area.
+    for( i = numApply; i < numArea; i++ )
+    {
+        pDst[i].attr0 = OAM_SETTING_INVISIBLE;
+    }
+    
+    pMan->managedAttrArea.currentIdx = (u16)( pMan->managedAttrArea.fromIdx + numApply );
+    
+    pStats = pSortBuffer->bDispLast ? &pSortBuffer->lastStats : &pSortBuffer->stats;
+    pStats->numApplyOverflow = (u16)( pStats->numApplyOverflow + ( numRequest - numApply ) );
+    if( numRequest > pStats->maxApplyOBJ )
+    {
+        pStats->maxApplyOBJ = numRequest;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Loads the manage area of the OAM buffer to the 2D Graphics Engine OAM.
+static void LoadManageArea_( NNSG2dOamManagerInstance* pMan )
+{
+    //
+    // Is high speed transfer (batch OAMAttr and affine parameter transfer) possible?
+    //
+    if( pMan->bFastTransferEnable )
+    {
+        LoadOamAndAffineFast_( pMan->type,
+                               pMan->managedAttrArea.fromIdx, 
+                               pMan->managedAttrArea.toIdx );
+    }else{
+        // OAM Attr
+        LoadOam_    ( pMan->type, 
+                      pMan->managedAttrArea.fromIdx, 
+                      pMan->managedAttrArea.toIdx );
+        // affine params
+        if( IsManageAreaValid_( &pMan->managedAffineArea ) )
+        {    
+            LoadAffine_ ( pMan->type, 
+                          pMan->managedAffineArea.fromIdx, 
+                          pMan->managedAffineArea.toIdx );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Gets the key of the affine cache from the affine transformation matrix.
+// The key is the affine parameter of the hardware (s7.8) with the low bits ignored.
+static NNS_G2D_INLINE void GetAffineCacheKey_( const MtxFx22* mtx, u16 quantizeShift, s32* pKey )
+{
+    const int shift = 4 + quantizeShift;
+    
+    pKey[0] = mtx->_00 >> shift;
+    pKey[1] = mtx->_01 >> shift;
+    pKey[2] = mtx->_10 >> shift;
+    pKey[3] = mtx->_11 >> shift;
+}
+
+//------------------------------------------------------------------------------
+// Gets the position in the hash table of the affine cache.
+static NNS_G2D_INLINE u32 GetAffineCacheHash_( const s32* pKey )
+{
+    u32 h = (u32)( pKey[0] + pKey[1] * 31 + pKey[2] * 961 + pKey[3] * 29791 );
+    
+    h ^= h >> 16;
+    h ^= h >> 6;
+    return h & ( NNS_G2D_OAMAFFINE_CACHE_NUM_HASH - 1 );
+}
+
+//------------------------------------------------------------------------------
+// Searches the affine cache for the affine parameter.
+// 
+// Returns the position in the hash table where the key is registered,
+// or where it must be registered if it is not found.
+// 
+static NNS_G2D_INLINE u32 FindAffineCache_( const NNSG2dOamAffineCache* pAffineCache, const s32* pKey )
+{
+    u32 h = GetAffineCacheHash_( pKey );
+    
+    // There are fewer entries than hash table positions, so the search always ends.
+    while( pAffineCache->hashTbl[h] != 0 )
+    {
+        const s32* pEntryKey = pAffineCache->key[pAffineCache->hashTbl[h] - 1];
+        
+        if( pEntryKey[0] == pKey[0] && pEntryKey[1] == pKey[1] &&
+            pEntryKey[2] == pKey[2] && pEntryKey[3] == pKey[3] )
+        {
+            break;
+        }
+        h = ( h + 1 ) & ( NNS_G2D_OAMAFFINE_CACHE_NUM_HASH - 1 );
+    }
+    return h;
+}
+
+//------------------------------------------------------------------------------
+// Gets the affine index of the registered affine parameter nearest to the key.
+static u16 GetNearestAffineIdx_( const NNSG2dOamAffineCache* pAffineCache, const s32* pKey )
+{
+    u16     nearestIdx  = NNS_G2D_OAM_AFFINE_IDX_NONE;
+    s32     minDiff     = 0x7FFFFFFF;
+    u16     i;
+    
+    for( i = 0; i < pAffineCache->numUsed; i++ )
+    {
+        const s32*  pEntryKey   = pAffineCache->key[i];
+        const s32   diff        = MATH_ABS( pEntryKey[0] - pKey[0] ) + MATH_ABS( pEntryKey[1] - pKey[1] )
+                                + MATH_ABS( pEntryKey[2] - pKey[2] ) + MATH_ABS( pEntryKey[3] - pKey[3] );
+        if( diff < minDiff )
+        {
+            minDiff     = diff;
+            nearestIdx  = pAffineCache->affineIdx[i];
+        }
+    }
+    return nearestIdx;
+}
+
+//------------------------------------------------------------------------------
+// Rebuilds the hash table of the affine cache from the registered keys.
+// If several entries have the same key, the first one is shared.
+static void RebuildAffineCacheHash_( NNSG2dOamAffineCache* pAffineCache )
+{
+    u16 i;
+    
+    MI_CpuClear8( pAffineCache->hashTbl, sizeof( pAffineCache->hashTbl ) );
+    for( i = 0; i < pAffineCache->numUsed; i++ )
+    {
+        const u32 h = FindAffineCache_( pAffineCache, pAffineCache->key[i] );
+        
+        if( pAffineCache->hashTbl[h] == 0 )
+        {
+            pAffineCache->hashTbl[h] = (u8)( i + 1 );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Updates the affine caches of the OAM type after the affine parameter idx was 
+// overwritten with mtx, so they do not share the old parameter anymore.
+static void UpdateAffineCachesOfType_( NNSG2dOamType type, const MtxFx22* mtx, u16 idx )
+{
+    NNSG2dOamAffineCache* pAffineCache = GetOamCachePtr_( type )->affineCache.pSharingList;
+    
+    for( ; pAffineCache != NULL; pAffineCache = pAffineCache->pNext )
+    {
+        BOOL    bUpdated = FALSE;
+        u16     i;
+        
+        for( i = 0; i < pAffineCache->numUsed; i++ )
+        {
+            if( pAffineCache->affineIdx[i] == idx )
+            {
+                GetAffineCacheKey_( mtx, pAffineCache->quantizeShift, pAffineCache->key[i] );
+                bUpdated = TRUE;
+            }
+        }
+        
+        if( bUpdated )
+        {
+            RebuildAffineCacheHash_( pAffineCache );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Removes the affine cache from the list of the OAM type.
+static void RemoveAffineCacheFromList_( NNSG2dOamType type, NNSG2dOamAffineCache* pAffineCache )
+{
+    NNSG2dOamAffineCache** ppCache = &GetOamCachePtr_( type )->affineCache.pSharingList;
+    
+    while( *ppCache != NULL )
+    {
+        if( *ppCache == pAffineCache )
+        {
+            *ppCache = pAffineCache->pNext;
+            break;
+        }
+        ppCache = &(*ppCache)->pNext;
+    }
+    pAffineCache->pNext = NULL;
+}
+
+//------------------------------------------------------------------------------
+// Empties the affine cache and keeps the statistics of the frame.
+static NNS_G2D_INLINE void ResetAffineCache_( NNSG2dOamAffineCache* pAffineCache )
+{
+    pAffineCache->lastStats = pAffineCache->stats;
+    pAffineCache->numUsed   = 0;
+    MI_CpuClear8( pAffineCache->hashTbl, sizeof( pAffineCache->hashTbl ) );
+    MI_CpuClear16( &pAffineCache->stats, sizeof( NNSG2dOamAffineCacheStats ) );
+}
+
 //------------------------------------------------------------------------------
 // Library Internal Release
 //------------------------------------------------------------------------------
@@ -703,6 +1118,11 @@ void NNS_G2dInitOamManagerModule()
     SetAffineReservationTblNotUsed_( NNS_G2D_OAMTYPE_SUB );
     SetAffineReservationTblNotUsed_( NNS_G2D_OAMTYPE_SOFTWAREEMULATION );
     
+    // affine caches
+    GetOamCachePtr_( NNS_G2D_OAMTYPE_MAIN )->affineCache.pSharingList                = NULL;
+    GetOamCachePtr_( NNS_G2D_OAMTYPE_SUB )->affineCache.pSharingList                 = NULL;
+    GetOamCachePtr_( NNS_G2D_OAMTYPE_SOFTWAREEMULATION )->affineCache.pSharingList   = NULL;
+    
     NNSI_G2D_DEBUGMSG0("Initialize Oam affine reservation table ... done.\n");
         
     
@@ -769,6 +1189,8 @@ BOOL NNS_G2dGetNewManagerInstance
             
             pMan->type                          = type;
             pMan->bFastTransferEnable           = FALSE;
+            pMan->pSortBuffer                   = NULL;
+            pMan->pAffineCache                  = NULL;
             
             DoReserveArea_( pReserveTbl, from, to, pMan->GUID );
             
@@ -945,6 +1367,8 @@ BOOL NNS_G2dGetNewOamManagerInstance
     
     pMan->bFastTransferEnable           = FALSE;
     pMan->type                          = type;
+    pMan->pSortBuffer                   = NULL;
+    pMan->pAffineCache                  = NULL;
     
     //
     // initialization completed smoothly
@@ -1051,6 +1475,8 @@ BOOL NNS_G2dGetNewOamManagerInstanceAsFastTransferMode
     //
     pMan->bFastTransferEnable           = TRUE;
     pMan->type                          = type;
+    pMan->pSortBuffer                   = NULL;
+    pMan->pAffineCache                  = NULL;
     
     //
     // initialization completed smoothly
@@ -1083,6 +1509,27 @@ BOOL NNS_G2dEntryOamManagerOam
     NNS_G2D_NULL_ASSERT( pOam );
     NNS_G2D_ASSERT( num != 0 );
     
+    //
+    // If the sort buffer is used, registers with sort key 0.
+    //
+    if( pMan->pSortBuffer != NULL )
+    {
+        NNSG2dOamSortBuffer* pSortBuffer = pMan->pSortBuffer;
+        
+        if( pSortBuffer->numEntry - pSortBuffer->numUsed >= num )
+        {
+            u16 i;
+            for( i = 0; i < num; i++ )
+            {
+                EntrySortBuffer_( pSortBuffer, &pOam[i], NNS_G2D_OAM_AFFINE_IDX_NONE, 0 );
+            }
+            return TRUE;
+        }else{
+            pSortBuffer->stats.numEntryOverflow = (u16)( pSortBuffer->stats.numEntryOverflow + num );
+            return FALSE;
+        }
+    }
+    
     //
     // if there is enough capacity...
     //
@@ -1144,6 +1591,13 @@ BOOL NNS_G2dEntryOamManagerOamWithAffineIdx
     NNS_G2D_NULL_ASSERT( pMan );
     NNS_G2D_NULL_ASSERT( pOam );
    
+    //
+    // If the sort buffer is used, registers with sort key 0.
+    //
+    if( pMan->pSortBuffer != NULL )
+    {
+        return NNS_G2dEntryOamManagerOamWithSortKey( pMan, pOam, affineIdx, 0 );
+    }
     
     //
     // if there is enough capacity...
@@ -1190,6 +1644,55 @@ BOOL NNS_G2dEntryOamManagerOamWithAffineIdx
 }
 
 
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dEntryOamManagerOamWithSortKey
+
+  Description:  Specifies the affine index and the sort key and registers OAM attribute parameters.
+                The sort buffer must be set with NNS_G2dSetOamManagerSortBuffer().
+                
+                When applied, OAM attributes are placed in ascending order of the sort key.
+                OAM attributes with a smaller sort key are displayed in front.
+                OAM attributes with the same sort key keep their registration order.
+                
+                When the sort buffer is full, nothing happens and FALSE is returned.
+                
+  Arguments:    pMan:       [OUT] manager instance
+                pOam:       [IN] OAM attributes to be registered 
+                affineIdx:  [IN] Affine index that the OBJ references 
+                sortKey:    [IN] sort key (0 to the number of sort keys - 1)
+                
+  Returns:      registration success or failure
+  
+ *---------------------------------------------------------------------------*/
+BOOL NNS_G2dEntryOamManagerOamWithSortKey
+( 
+    NNSG2dOamManagerInstance*   pMan, 
+    const GXOamAttr*            pOam, 
+    u16                         affineIdx,
+    u16                         sortKey 
+)
+{
+    NNS_G2D_NULL_ASSERT( pMan );
+    NNS_G2D_NULL_ASSERT( pOam );
+    NNS_G2D_ASSERTMSG( pMan->pSortBuffer != NULL, 
+        "Set the sort buffer with NNS_G2dSetOamManagerSortBuffer() first." );
+    
+    {
+        NNSG2dOamSortBuffer* pSortBuffer = pMan->pSortBuffer;
+        
+        if( pSortBuffer->numUsed < pSortBuffer->numEntry )
+        {
+            EntrySortBuffer_( pSortBuffer, pOam, affineIdx, sortKey );
+            return TRUE;
+        }else{
+            NNSI_G2D_DEBUGMSG0("The sort buffer has no capacity enough to store new Oam.");
+            pSortBuffer->stats.numEntryOverflow++;
+            return FALSE;
+        }
+    }
+}
+
+
 /*---------------------------------------------------------------------------*
   Name:         NNS_G2dSetOamManagerAffine
 
@@ -1198,6 +1701,9 @@ BOOL NNS_G2dEntryOamManagerOamWithAffineIdx
                 
                 If the affine parameter management area has been written to, a warning is displayed.
                 
+                The affine caches of the OAM type that share the affine parameter idx 
+                are updated to the new affine transformation matrix.
+                
   Arguments:    type:      [OUT] OAM type
                 mtx:       [IN] Affine Matrix to be registered 
                 idx:       [IN] index for the affine to register 
@@ -1222,6 +1728,7 @@ void NNS_G2dSetOamManagerAffine
 
     
     SetAffineParams_( type, mtx, idx );
+    UpdateAffineCachesOfType_( type, mtx, idx );
 }
 
 /*---------------------------------------------------------------------------*
@@ -1246,6 +1753,60 @@ u16 NNS_G2dEntryOamManagerAffine( NNSG2dOamManagerInstance* pMan, const MtxFx22*
     NNS_G2D_NULL_ASSERT( mtx );
     NNS_G2D_ASSERT( IsManageAreaValid_( &pMan->managedAffineArea ) );
     
+    //
+    // If the affine cache is used, shares the registered affine parameter.
+    //
+    if( pMan->pAffineCache != NULL )
+    {
+        NNSG2dOamAffineCache* pAffineCache = pMan->pAffineCache;
+        s32                   key[4];
+        u32                   h;
+        
+        GetAffineCacheKey_( mtx, pAffineCache->quantizeShift, key );
+        h = FindAffineCache_( pAffineCache, key );
+        
+        pAffineCache->stats.numRequest++;
+        
+        if( pAffineCache->hashTbl[h] != 0 )
+        {
+            pAffineCache->stats.numShared++;
+            return pAffineCache->affineIdx[pAffineCache->hashTbl[h] - 1];
+        }
+        
+        if( HasEnoughCapacity_( &pMan->managedAffineArea, 1 ) )
+        {
+            const u16 currentAffineIdx  = pMan->managedAffineArea.currentIdx;
+            const u16 entry             = pAffineCache->numUsed;
+            
+            NNS_G2D_ASSERT( entry < NNS_G2D_OAMAFFINE_CACHE_NUM_ENTRY );
+            
+            SetAffineParams_( pMan->type, mtx, currentAffineIdx );
+            pMan->managedAffineArea.currentIdx++;
+            
+            pAffineCache->key[entry][0]     = key[0];
+            pAffineCache->key[entry][1]     = key[1];
+            pAffineCache->key[entry][2]     = key[2];
+            pAffineCache->key[entry][3]     = key[3];
+            pAffineCache->affineIdx[entry]  = currentAffineIdx;
+            pAffineCache->hashTbl[h]        = (u8)( entry + 1 );
+            pAffineCache->numUsed++;
+            
+            return currentAffineIdx;
+        }
+        
+        pAffineCache->stats.numOverflow++;
+        
+        if( pAffineCache->overflowMode == NNS_G2D_OAMAFFINE_OVERFLOW_NEAREST &&
+            pAffineCache->numUsed > 0 )
+        {
+            pAffineCache->stats.numFallback++;
+            return GetNearestAffineIdx_( pAffineCache, key );
+        }
+        
+        NNSI_G2D_DEBUGMSG0("The OamBuffer has no capacity enough to store new Affine Paramater.");
+        return NNS_G2D_OAM_AFFINE_IDX_NONE;
+    }
+    
     //
     // if there is enough capacity...
     //
@@ -1270,6 +1831,9 @@ u16 NNS_G2dEntryOamManagerAffine( NNSG2dOamManagerInstance* pMan, const MtxFx22*
   Description:  Applies the OamManager internal buffer to HW OAM.
                 To complete the reflection without affecting the screen being rendered, it must be run in render blank.
                 
+                If the sort buffer is used, the registered OAM attributes are sorted by sort key 
+                and applied up to the size of the manage area.
+                
                 
   Arguments:    pMan:                [OUT] manager instance
                 
@@ -1283,29 +1847,67 @@ void NNS_G2dApplyOamManagerToHW( NNSG2dOamManagerInstance* pMan )
     NNS_G2D_NULL_ASSERT( pMan );
     NNS_G2D_ASSERTMSG( pMan->type != NNS_G2D_OAMTYPE_SOFTWAREEMULATION, 
                     " For the NNS_G2D_OAMTYPE_SOFTWAREEMULATION type Manager, Use NNS_G2dApplyOamManagerToHWSprite() instead." );
+    
+    if( pMan->pSortBuffer != NULL )
     {
-        //
-        // Is high speed transfer (batch OAMAttr and affine parameter transfer) possible?
-        //
-        if( pMan->bFastTransferEnable )
-        {
-            LoadOamAndAffineFast_( pMan->type,
-                                   pMan->managedAttrArea.fromIdx, 
-                                   pMan->managedAttrArea.toIdx );
-        }else{
-            // OAM Attr
-            LoadOam_    ( pMan->type, 
-                          pMan->managedAttrArea.fromIdx, 
-                          pMan->managedAttrArea.toIdx );
-            // affine params
-            if( IsManageAreaValid_( &pMan->managedAffineArea ) )
-            {    
-                LoadAffine_ ( pMan->type, 
-                              pMan->managedAffineArea.fromIdx, 
-                              pMan->managedAffineArea.toIdx );
-            }
-        }
+        ApplySortBuffer_( pMan, FALSE, 0, 0 );
     }
+    
+    LoadManageArea_( pMan );
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dApplyOamManagerToHWForLines
+
+  Description:  Applies to HW OAM only the OBJs of the sort buffer that are displayed 
+                on a line from fromLine to toLine.
+                
+                This is used to display more OBJs than the manage area by dividing the screen 
+                into line ranges. Apply the first range in the V-Blank, and each next range 
+                in the V-count interrupt of a line before the range 
+                (the OBJs of a line are prepared while the line before it is displayed).
+                An OBJ that straddles ranges is applied in each of them.
+                
+                Apply the ranges of a frame in ascending order of lines. The first range of 
+                a frame (a range that does not follow the previous range) takes a snapshot 
+                of the sort buffer and of the affine parameters of the manage area, and the 
+                following ranges are loaded from that snapshot. 
+                NNS_G2dResetOamManagerBuffer() and the registration of the next frame 
+                (OAM attributes and affine parameters) can therefore run while the following 
+                ranges are applied from the interrupt; their statistics are then counted in 
+                the lastStats of the sort buffer.
+                The registration of a frame must be finished before its first range is applied.
+                The OBJs that do not fit in the manage area are not displayed, and are counted 
+                in the numApplyOverflow of the statistics.
+                
+                The sort buffer must be set with NNS_G2dSetOamManagerSortBuffer().
+                
+  Arguments:    pMan:       [OUT] manager instance
+                fromLine:   [IN] first line of the range
+                toLine:     [IN] last line of the range
+                
+  Returns:      None.
+  
+ *---------------------------------------------------------------------------*/
+void NNS_G2dApplyOamManagerToHWForLines
+( 
+    NNSG2dOamManagerInstance*   pMan, 
+    int                         fromLine, 
+    int                         toLine 
+)
+{
+    NNS_G2D_NULL_ASSERT( pMan );
+    NNS_G2D_ASSERT( 0 <= fromLine && fromLine <= toLine );
+    NNS_G2D_ASSERTMSG( pMan->type != NNS_G2D_OAMTYPE_SOFTWAREEMULATION, 
+                    " For the NNS_G2D_OAMTYPE_SOFTWAREEMULATION type Manager, Use NNS_G2dApplyOamManagerToHWSprite() instead." );
+    NNS_G2D_ASSERTMSG( pMan->pSortBuffer != NULL, 
+        "Set the sort buffer with NNS_G2dSetOamManagerSortBuffer() first." );
+    
+    ApplySortBuffer_( pMan, TRUE, fromLine, toLine );
+    
+    ExchangeDispAffine_( pMan );
+    LoadManageArea_( pMan );
+    ExchangeDispAffine_( pMan );
 }
 
 /*---------------------------------------------------------------------------*
@@ -1337,6 +1939,11 @@ void NNS_G2dApplyOamManagerToHWSprite
     NNS_G2D_ASSERTMSG( pMan->type == NNS_G2D_OAMTYPE_SOFTWAREEMULATION, 
         " For the NNS_G2D_OAMTYPE_MAIN SUB type Manager, Use NNS_G2dApplyOamManagerToHW() instead." );
     
+    if( pMan->pSortBuffer != NULL )
+    {
+        ApplySortBuffer_( pMan, FALSE, 0, 0 );
+    }
+    
     if( pMan->spriteZoffsetStep != 0 )
     {
         fx32 step = NNSi_G2dGetOamSoftEmuAutoZOffsetStep();
@@ -1437,6 +2044,24 @@ void NNS_G2dResetOamManagerBuffer( NNSG2dOamManagerInstance* pMan )
         pMan->managedAttrArea.currentIdx    = pMan->managedAttrArea.fromIdx;
         pMan->managedAffineArea.currentIdx  = pMan->managedAffineArea.fromIdx;
     }
+    
+    // Reset the sort buffer and keep the statistics of the frame.
+    if( pMan->pSortBuffer != NULL )
+    {
+        NNSG2dOamSortBuffer* pSortBuffer = pMan->pSortBuffer;
+        
+        pSortBuffer->lastStats  = pSortBuffer->stats;
+        pSortBuffer->numUsed    = 0;
+        pSortBuffer->bSnapshot  = FALSE;
+        pSortBuffer->bDispLast  = TRUE;
+        MI_CpuClear16( &pSortBuffer->stats, sizeof( NNSG2dOamSortStats ) );
+    }
+    
+    // Empty the affine cache.
+    if( pMan->pAffineCache != NULL )
+    {
+        ResetAffineCache_( pMan->pAffineCache );
+    }
 }
 
 
@@ -1478,6 +2103,11 @@ void NNS_G2dApplyAndResetOamManagerBuffer( NNSG2dOamManagerInstance* pMan )
 u16     NNS_G2dGetOamManagerOamCapacity( NNSG2dOamManagerInstance* pMan )
 {
     NNS_G2D_NULL_ASSERT( pMan );
+    
+    if( pMan->pSortBuffer != NULL )
+    {
+        return (u16)( pMan->pSortBuffer->numEntry - pMan->pSortBuffer->numUsed );
+    }
     return GetCapacity_( &pMan->managedAttrArea );
 }
 
@@ -1504,5 +2134,206 @@ GXOamAttr* NNS_G2dGetOamBuffer( NNSG2dOamType type )
     return GetOamBufferPtr_( type, 0 );    
 }
 
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGetOamSortBufferWorkSize
+
+  Description:  Gets the size of the work memory required by the sort buffer.
+                
+  Arguments:    numEntry:            [IN] number of OAM attributes that can be registered
+                numKey:              [IN] number of sort keys
+                
+                
+  Returns:      size of the work memory (bytes)
+  
+ *---------------------------------------------------------------------------*/
+u32 NNS_G2dGetOamSortBufferWorkSize( u16 numEntry, u16 numKey )
+{
+    return (u32)( GX_OAMATTR_SIZE * numEntry            // pAttr
+                + sizeof( u16 ) * numEntry              // pKey
+                + sizeof( u16 ) * numEntry              // pOrder
+                + sizeof( u16 ) * MATH_ROUNDUP( numKey + 1, 2 ) // pBucket (keeps pDispAttr 4-byte aligned)
+                + GX_OAMATTR_SIZE * numEntry );         // pDispAttr
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dInitOamSortBuffer
+
+  Description:  Initializes the sort buffer.
+                
+                More OAM attributes than the manage area of the OamManager instance can be 
+                registered. Use NNS_G2dApplyOamManagerToHWForLines() to display them.
+                
+  Arguments:    pSortBuffer:         [OUT] sort buffer
+                pWork:               [IN] work memory (4-byte aligned)
+                                          The size is given by NNS_G2dGetOamSortBufferWorkSize().
+                numEntry:            [IN] number of OAM attributes that can be registered
+                numKey:              [IN] number of sort keys (non-zero value)
+                
+                
+  Returns:      None.
+  
+ *---------------------------------------------------------------------------*/
+void NNS_G2dInitOamSortBuffer
+( 
+    NNSG2dOamSortBuffer*        pSortBuffer, 
+    void*                       pWork, 
+    u16                         numEntry, 
+    u16                         numKey 
+)
+{
+    NNS_G2D_NULL_ASSERT( pSortBuffer );
+    NNS_G2D_NULL_ASSERT( pWork );
+    NNS_G2D_ASSERT( ( (u32)pWork & 0x3 ) == 0 );
+    NNS_G2D_NON_ZERO_ASSERT( numKey );
+    
+    pSortBuffer->pAttr      = (GXOamAttr*)pWork;
+    pSortBuffer->pKey       = (u16*)( pSortBuffer->pAttr + numEntry );
+    pSortBuffer->pOrder     = pSortBuffer->pKey + numEntry;
+    pSortBuffer->pBucket    = pSortBuffer->pOrder + numEntry;
+    pSortBuffer->pDispAttr  = (GXOamAttr*)( pSortBuffer->pBucket 
+                                          + MATH_ROUNDUP( numKey + 1, 2 ) );
+    
+    pSortBuffer->numEntry   = numEntry;
+    pSortBuffer->numKey     = numKey;
+    pSortBuffer->numUsed    = 0;
+    pSortBuffer->bSnapshot  = FALSE;
+    pSortBuffer->numDisp    = 0;
+    pSortBuffer->prevToLine = -1;
+    pSortBuffer->numDispAffine  = 0;
+    pSortBuffer->bDispLast      = FALSE;
+    
+    MI_CpuClear16( &pSortBuffer->stats, sizeof( NNSG2dOamSortStats ) );
+    MI_CpuClear16( &pSortBuffer->lastStats, sizeof( NNSG2dOamSortStats ) );
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dSetOamManagerSortBuffer
+
+  Description:  Sets the sort buffer of the OamManager instance.
+                
+                While the sort buffer is set, registered OAM attributes are stored in the 
+                sort buffer and written to the internal buffer in sorted order when applied.
+                OAM attributes registered without a sort key use sort key 0.
+                Specify NULL to apply OAM attributes in registration order again.
+                
+                Call this between frames (after NNS_G2dResetOamManagerBuffer()).
+                A sort buffer can be set to only one OamManager instance.
+                
+  Arguments:    pMan:                [OUT] manager instance
+                pSortBuffer:         [IN] sort buffer (NULL if not used)
+                
+                
+  Returns:      None.
+  
+ *---------------------------------------------------------------------------*/
+void NNS_G2dSetOamManagerSortBuffer
+( 
+    NNSG2dOamManagerInstance*   pMan, 
+    NNSG2dOamSortBuffer*        pSortBuffer 
+)
+{
+    NNS_G2D_NULL_ASSERT( pMan );
+    NNS_G2D_ASSERT( pMan->managedAttrArea.currentIdx == pMan->managedAttrArea.fromIdx );
+    
+    if( pSortBuffer != NULL )
+    {
+        pSortBuffer->numUsed    = 0;
+        pSortBuffer->bSnapshot  = FALSE;
+        pSortBuffer->numDisp    = 0;
+        pSortBuffer->prevToLine = -1;
+        pSortBuffer->numDispAffine  = 0;
+        pSortBuffer->bDispLast      = FALSE;
+    }
+    
+    pMan->pSortBuffer = pSortBuffer;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dInitOamAffineCache
+
+  Description:  Initializes the affine cache.
+                
+                Affine transformation matrices are compared as the s7.8 affine parameters 
+                of the hardware. With quantizeShift, matrices that differ only in the 
+                low bits of the affine parameters also share an affine parameter.
+                
+  Arguments:    pAffineCache:        [OUT] affine cache
+                quantizeShift:       [IN] number of low bits of the affine parameters ignored (0 to 8)
+                overflowMode:        [IN] behavior when the affine parameter manage area is full
+                
+                
+  Returns:      None.
+  
+ *---------------------------------------------------------------------------*/
+void NNS_G2dInitOamAffineCache
+( 
+    NNSG2dOamAffineCache*       pAffineCache, 
+    u16                         quantizeShift, 
+    NNSG2dOamAffineOverflowMode overflowMode 
+)
+{
+    NNS_G2D_NULL_ASSERT( pAffineCache );
+    NNS_G2D_MINMAX_ASSERT( quantizeShift, 0, 8 );
+    NNS_G2D_ASSERT( overflowMode == NNS_G2D_OAMAFFINE_OVERFLOW_FAIL ||
+                    overflowMode == NNS_G2D_OAMAFFINE_OVERFLOW_NEAREST );
+    
+    pAffineCache->quantizeShift = quantizeShift;
+    pAffineCache->overflowMode  = overflowMode;
+    
+    ResetAffineCache_( pAffineCache );
+    MI_CpuClear16( &pAffineCache->lastStats, sizeof( NNSG2dOamAffineCacheStats ) );
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dSetOamManagerAffineCache
+
+  Description:  Sets the affine cache of the OamManager instance.
+                
+                While the affine cache is set, NNS_G2dEntryOamManagerAffine() returns the 
+                affine index already registered in the frame for the same affine 
+                transformation matrix instead of using a new affine parameter.
+                The affine cache is emptied by NNS_G2dResetOamManagerBuffer().
+                Specify NULL to stop sharing affine parameters.
+                
+                Call this between frames (after NNS_G2dResetOamManagerBuffer()).
+                An affine cache can be set to only one OamManager instance.
+                
+  Arguments:    pMan:                [OUT] manager instance
+                pAffineCache:        [IN] affine cache (NULL if not used)
+                
+                
+  Returns:      None.
+  
+ *---------------------------------------------------------------------------*/
+void NNS_G2dSetOamManagerAffineCache
+( 
+    NNSG2dOamManagerInstance*   pMan, 
+    NNSG2dOamAffineCache*       pAffineCache 
+)
+{
+    NNS_G2D_NULL_ASSERT( pMan );
+    NNS_G2D_ASSERT( pMan->managedAffineArea.currentIdx == pMan->managedAffineArea.fromIdx );
+    
+    if( pMan->pAffineCache != NULL )
+    {
+        RemoveAffineCacheFromList_( pMan->type, pMan->pAffineCache );
+    }
+    
+    if( pAffineCache != NULL )
+    {
+        OamAffineCache* pTypeCache = &GetOamCachePtr_( pMan->type )->affineCache;
+        
+        pAffineCache->numUsed = 0;
+        MI_CpuClear8( pAffineCache->hashTbl, sizeof( pAffineCache->hashTbl ) );
+        
+        // Listed so that NNS_G2dSetOamManagerAffine() can update it.
+        pAffineCache->pNext         = pTypeCache->pSharingList;
+        pTypeCache->pSharingList    = pAffineCache;
+    }
+    
+    pMan->pAffineCache = pAffineCache;
+}
+
+
 
 
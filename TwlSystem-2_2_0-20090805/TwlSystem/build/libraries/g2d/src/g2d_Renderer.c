@@ -202,40 +202,21 @@ static NNS_G2D_INLINE u32 GetCurrentVramTransfereHandle_()
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 // callback before cell rendering
-// * culling process
-// * loading of current matrix to 2D matrix cache
 // * callback call before cell rendering of renderer module
 //
+// The culling process is done in DrawCellImpl_() before the renderer core is set up for the surface.
+//
 static void RndCoreCBFuncBeforeCell_
 (
     struct NNSG2dRndCoreInstance*   pRend,
     const NNSG2dCellData*           pCell
 )    
 {   
+#pragma unused( pRend )
     NNS_G2D_NULL_ASSERT( pCurrentInstance_ );
     NNS_G2D_NULL_ASSERT( pCurrentInstance_->pCurrentSurface );
     {
        NNSG2dRenderSurface* pCurrentSurface = pCurrentInstance_->pCurrentSurface;
-        
-       //
-       // culling process
-       //
-       if( pCurrentSurface->pFuncVisibilityCulling != NULL )
-       { 
-            
-           if( !(*pCurrentSurface->pFuncVisibilityCulling)( pCell, 
-                                                     NNSi_G2dGetCurrentMtx() , 
-                                                     &pCurrentSurface->coreSurface.viewRect ) )
-           {
-              // 
-              // configure to skip render in pRend
-              // 
-              pRend->bDrawEnable = FALSE;
-              return;
-           }else{
-              pRend->bDrawEnable = TRUE;
-           }
-       }
        
        //
        // existing callback call
@@ -567,6 +548,67 @@ static NNS_G2D_INLINE void DoRenderByRndCore3D_
     }
 }
 
+//------------------------------------------------------------------------------
+// Gets the matrix passed to the visibility culling function.
+// The flip of the renderer is applied to the cell local axes, in the same way as the renderer core does to the OBJ positions.
+// 
+static NNS_G2D_INLINE const MtxFx32* GetCullingMtx_( MtxFx32* pMtxWork )
+{
+    const NNSG2dRndCoreInstance*    pRndCore = &pCurrentInstance_->rendererCore;
+    const MtxFx32*                  pMtx     = NNSi_G2dGetCurrentMtx();
+    
+    if( pRndCore->flipFlag == NNS_G2D_RENDERERFLIP_NONE )
+    {
+        return pMtx;
+    }
+    
+    *pMtxWork = *pMtx;
+    if( NNS_G2dIsRndCoreFlipH( pRndCore ) )
+    {
+        pMtxWork->_00 = -pMtxWork->_00;
+        pMtxWork->_01 = -pMtxWork->_01;
+    }
+    if( NNS_G2dIsRndCoreFlipV( pRndCore ) )
+    {
+        pMtxWork->_10 = -pMtxWork->_10;
+        pMtxWork->_11 = -pMtxWork->_11;
+    }
+    return pMtxWork;
+}
+
+//------------------------------------------------------------------------------
+// Culling process of the cell for a surface.
+// Called before the renderer core is set up for the surface, so that culled cells do not cost the set up of the surface nor a matrix cache.
+// 
+// Counts the cell as rendered or culled.
+static BOOL IsCellVisibleInSurface_
+( 
+    const NNSG2dRenderSurface*  pSurface, 
+    const NNSG2dCellData*       pCell 
+)
+{
+    NNSG2dRendererCullingStats* pStats = &pCurrentInstance_->cullingStats;
+    
+    NNS_G2D_NULL_ASSERT( pSurface );
+    NNS_G2D_NULL_ASSERT( pCell );
+    
+    if( pSurface->pFuncVisibilityCulling != NULL )
+    {
+        MtxFx32     mtxWork;
+        
+        if( !(*pSurface->pFuncVisibilityCulling)( pCell, 
+                                                  GetCullingMtx_( &mtxWork ), 
+                                                  &pSurface->coreSurface.viewRect ) )
+        {
+            pStats->numCellCulled++;
+            return FALSE;
+        }
+    }
+    
+    pStats->numCellDrawn++;
+    return TRUE;
+}
+
 //------------------------------------------------------------------------------
 // Renders cell.
 static void DrawCellImpl_( const NNSG2dCellData* pCell )
@@ -589,6 +631,10 @@ static void DrawCellImpl_( const NNSG2dCellData* pCell )
            // Calls to the BeginRndCoreRenderingXX_ and EndRndCoreRendering_ functions for each rendering function are not made. 
            // This speeds up the operation.
            // 
+           if( !pSurface->bActive || !IsCellVisibleInSurface_( pSurface, pCell ) )
+           {
+              return;
+           }
            //
            // if rendering for a 2D surface...
            //       
@@ -608,7 +654,7 @@ static void DrawCellImpl_( const NNSG2dCellData* pCell )
            // for each render surface...     
            while( pSurface )
            {
-              if( pSurface->bActive )
+              if( pSurface->bActive && IsCellVisibleInSurface_( pSurface, pCell ) )
               {                
                   //
                   // if rendering for a 2D surface...
@@ -686,6 +732,154 @@ static void DrawCellAnimationImpl_( const NNSG2dCellAnimation* pCellAnim )
     }
 }
 
+//------------------------------------------------------------------------------
+// Renders the cell animations of a batch to the surface the renderer core is set up for.
+//
+// The matrix of each cell animation is built again for each surface.
+// The matrix cache is shared between the surfaces through mcRenderState_ in the same way as the cell animations of a multicell.
+// 
+static void DrawCellAnimationBatchToSurface_
+( 
+    const NNSG2dRenderSurface*          pSurface,
+    const NNSG2dCellAnimation* const*   ppCellAnim, 
+    const NNSG2dFVec2*                  pPosArray, 
+    u16                                 numCellAnim 
+)
+{
+    NNSG2dRndCoreInstance*   pRndCore   = &pCurrentInstance_->rendererCore;
+    u16                      i;
+    
+    for( i = 0; i < numCellAnim; i++ )
+    {
+        const NNSG2dCellAnimation*  pCellAnim = ppCellAnim[i];
+        const NNSG2dCellData*       pCell     = NULL;
+        BOOL                        bSRT;
+        
+        NNS_G2D_NULL_ASSERT( pCellAnim );
+        pCell = NNS_G2dGetCellAnimationCurrentCell( pCellAnim );
+        NNS_G2D_NULL_ASSERT( pCell );
+        
+        bSRT = (BOOL)( pCellAnim->srtCtrl.srtData.SRT_EnableFlag != NNS_G2D_AFFINEENABLE_NONE );
+        mcRenderState_.currentCellAnimIdx = i;
+        
+        //
+        // When neither the position nor the SRT animation is used, avoids useless PushPop.
+        //
+        if( pPosArray != NULL || bSRT )
+        {
+            NNS_G2dPushMtx();
+            if( pPosArray != NULL )
+            {
+                NNS_G2dTranslate( pPosArray[i].x, pPosArray[i].y, 0 );
+            }
+            if( bSRT )
+            {
+                SetSrtControlToMtxStack_( &pCellAnim->srtCtrl );
+            }
+        }
+        
+        if( IsCellVisibleInSurface_( pSurface, pCell ) )
+        {
+            const BOOL bVramTransfer = NNSi_G2dIsCellAnimVramTransferHandleValid( pCellAnim );
+            
+            if( bVramTransfer )
+            {
+                BeginDrawVramTransferedCell_( NNSi_G2dGetCellAnimVramTransferHandle( pCellAnim ) );
+            }
+            
+            if( pSurface->type != NNS_G2D_SURFACETYPE_MAIN3D )
+            {
+                DoRenderByRndCore2D_( pCell, pRndCore );
+            }else{
+                DoRenderByRndCore3D_( pCell, pRndCore );
+            }
+            
+            if( bVramTransfer )
+            {
+                EndDrawVramTransferedCell_();
+            }
+        }
+        
+        if( pPosArray != NULL || bSRT )
+        {
+            NNS_G2dPopMtx(1);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Renders the cell animations of a batch.
+// The renderer core is set up once for each surface, instead of once for each cell and surface.
+// 
+static void DrawCellAnimationBatchImpl_
+( 
+    const NNSG2dCellAnimation* const*   ppCellAnim, 
+    const NNSG2dFVec2*                  pPosArray, 
+    u16                                 numCellAnim 
+)
+{
+    const u16   numTbl = (u16)( sizeof( mcRenderState_.cellAnimMtxCacheTbl ) 
+                              / sizeof( mcRenderState_.cellAnimMtxCacheTbl[0] ) );
+    u16         numDone = 0;
+    
+    NNS_G2D_ASSERT( !mcRenderState_.bDrawMC );
+    
+    //
+    // The matrix cache table holds numTbl cell animations at a time.
+    //
+    while( numDone < numCellAnim )
+    {
+        const u16               num      = (u16)MATH_MIN( numCellAnim - numDone, numTbl );
+        NNSG2dRenderSurface*    pSurface = pCurrentInstance_->pTargetSurfaceList;
+        u16                     i;
+        
+        for( i = 0; i < num; i++ )
+        {
+            mcRenderState_.cellAnimMtxCacheTbl[i] = NULL;
+        }
+        mcRenderState_.bDrawMC = TRUE;
+        
+        if( pCurrentInstance_->opzHint & NNS_G2D_RDR_OPZHINT_LOCK_PARAMS )
+        {
+            //
+            // The renderer core is already set up for the surface.
+            //
+            if( pSurface->bActive )
+            {
+                DrawCellAnimationBatchToSurface_( pSurface, 
+                                                  &ppCellAnim[numDone], 
+                                                  ( pPosArray != NULL ) ? &pPosArray[numDone] : NULL, 
+                                                  num );
+            }
+        }else{
+            // for each render surface...
+            while( pSurface )
+            {
+                if( pSurface->bActive )
+                {
+                    if( pSurface->type != NNS_G2D_SURFACETYPE_MAIN3D )
+                    {
+                        BeginRndCoreRendering2D_( pCurrentInstance_, pSurface );
+                    }else{
+                        BeginRndCoreRendering3D_( pCurrentInstance_, pSurface );
+                    }
+                    
+                    DrawCellAnimationBatchToSurface_( pSurface, 
+                                                      &ppCellAnim[numDone], 
+                                                      ( pPosArray != NULL ) ? &pPosArray[numDone] : NULL, 
+                                                      num );
+                    EndRndCoreRendering_();
+                }
+                // next surface ... 
+                pSurface = pSurface->pNextSurface;
+            }
+        }
+        
+        mcRenderState_.bDrawMC = FALSE;
+        numDone += num;
+    }
+}
+
 
 //------------------------------------------------------------------------------
 // Renders Node.
@@ -785,6 +979,9 @@ void NNS_G2dInitRenderer( NNSG2dRendererInstance* pRend )
     pRend->overwriteMosaicFlag = FALSE;
     pRend->overwritePlttNoOffset = 0;
     
+    pRend->cullingStats.numCellDrawn  = 0;
+    pRend->cullingStats.numCellCulled = 0;
+    
     //
     // initialization of matrix cache
     //
@@ -868,6 +1065,8 @@ void NNS_G2dInitRenderSurface( NNSG2dRenderSurface* pSurface )
                 Call before calling the rendering method of the renderer.
                 Do not call from within Begin End Rendering.
                 
+                The culling statistics of the renderer (NNS_G2dGetRendererCullingStats) are reset.
+                
                 Also, the NNS_G2dBeginRenderingEx() function is provided, which can specify hint flags for rendering optimization, and fulfill a role similar to this function.
                 
                 
@@ -886,6 +1085,9 @@ void NNS_G2dBeginRendering( NNSG2dRendererInstance* pRendererInstance )
     
     pCurrentInstance_ = pRendererInstance;
     
+    pRendererInstance->cullingStats.numCellDrawn  = 0;
+    pRendererInstance->cullingStats.numCellCulled = 0;
+    
     NNSi_G2dMCMCleanupMtxCache();
     
     G3_PushMtx();            
@@ -1291,6 +1493,54 @@ void NNS_G2dDrawEntity( NNSG2dEntity* pEntity )
     }
 }
 
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dDrawCellAnimationBatch
+
+  Description:  Renders multiple cell animations.
+                
+                The result is the same as rendering each cell animation with
+                NNS_G2dDrawCellAnimation() after translating the current matrix
+                by its position, but the renderer core is set up only once for each
+                surface instead of once for each cell animation and surface.
+                The cell animations are rendered to the first surface, and then to the next surface.
+                
+                The cells outside the surface are culled by the visibility culling function of the surface
+                (NNS_G2dIsCellInViewRect, for example) before the renderer core is set up.
+                
+                
+  Arguments:    ppCellAnim:  [IN]  cell animations to render
+                pPosArray:   [IN]  position of each cell animation (NULL if not translated)
+                numCellAnim: [IN]  number of cell animations
+                
+  Returns:      None.
+  
+ *---------------------------------------------------------------------------*/
+void NNS_G2dDrawCellAnimationBatch
+( 
+    const NNSG2dCellAnimation* const*   ppCellAnim, 
+    const NNSG2dFVec2*                  pPosArray, 
+    u16                                 numCellAnim 
+)
+{
+    NNS_G2D_RND_BETWEEN_BEGINEND_ASSERT( pCurrentInstance_ );
+    NNS_G2D_NULL_ASSERT( ppCellAnim );
+    
+    if( IsAutoZoffsetEnable_() )
+    {
+        const fx32 offset = NNSi_G2dGetOamSoftEmuAutoZOffsetStep();
+        NNSi_G2dSetOamSoftEmuAutoZOffsetFlag( TRUE );
+        NNSi_G2dSetOamSoftEmuAutoZOffsetStep( pCurrentInstance_->spriteZoffsetStep );
+        
+        DrawCellAnimationBatchImpl_( ppCellAnim, pPosArray, numCellAnim );
+        
+        NNSi_G2dSetOamSoftEmuAutoZOffsetFlag( FALSE );
+        NNSi_G2dSetOamSoftEmuAutoZOffsetStep( offset );
+        NNSi_G2dResetOamSoftEmuAutoZOffset();
+    }else{
+        DrawCellAnimationBatchImpl_( ppCellAnim, pPosArray, numCellAnim );
+    }
+}
+
 
 
 
@@ -0,0 +1,709 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - libraries - g2d
+  File:     g2d_TextLayout.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#include <nitro.h>
+
+#undef NNS_G2D_UNICODE
+#include <nnsys/g2d/g2d_TextLayout.h>
+
+
+#define CHARACTER_WIDTH     8
+#define CHARACTER_HEIGHT    8
+
+
+/*---------------------------------------------------------------------------*
+  Name:         CharRect
+
+  Description:  Range of the characters of the CharCanvas (in character units, inclusive).
+ *---------------------------------------------------------------------------*/
+typedef struct CharRect
+{
+    int left;
+    int top;
+    int right;
+    int bottom;
+}
+CharRect;
+
+
+
+
+//****************************************************************************
+// static inline functions
+//****************************************************************************
+
+/*---------------------------------------------------------------------------*
+  Name:         GetNumChar
+
+  Description:  Gets the number of characters of the CharCanvas of the TextLayout.
+
+  Arguments:    pCC:    Pointer to CharCanvas.
+
+  Returns:      Number of characters.
+ *---------------------------------------------------------------------------*/
+static NNS_G2D_INLINE int GetNumChar(const NNSG2dCharCanvas* pCC)
+{
+    return pCC->areaWidth * pCC->areaHeight;
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         IsDirty
+
+  Description:  Determines whether a character of the CharCanvas must be rendered again.
+
+  Arguments:    pLayout:    Pointer to the TextLayout.
+                iChar:      Index of the character (y * areaWidth + x).
+
+  Returns:      TRUE if the character must be rendered again.
+ *---------------------------------------------------------------------------*/
+static NNS_G2D_INLINE BOOL IsDirty(const NNSG2dTextLayout* pLayout, int iChar)
+{
+    return (BOOL)((pLayout->pDirty[iChar >> 5] & (1u << (iChar & 31))) != 0);
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         IsSameGlyph
+
+  Description:  Determines whether 2 placed characters render the same image.
+
+  Arguments:    a:  Pointer to the placed character.
+                b:  Pointer to the placed character.
+
+  Returns:      TRUE if they render the same image.
+ *---------------------------------------------------------------------------*/
+static NNS_G2D_INLINE BOOL IsSameGlyph(
+    const NNSG2dTextLayoutGlyph* a,
+    const NNSG2dTextLayoutGlyph* b
+)
+{
+    return (BOOL)( a->x == b->x
+                && a->y == b->y
+                && a->ccode == b->ccode
+                && a->cl == b->cl );
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         InitCharCanvasForChar
+
+  Description:  Initializes a CharCanvas made of 1 character of another CharCanvas.
+                Rendering to it is clipped to that character.
+
+  Arguments:    pSub:   Pointer to the CharCanvas to initialize.
+                pCC:    Pointer to the original CharCanvas.
+                cx:     X position of the character (in character units)
+                cy:     Y position of the character (in character units)
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static NNS_G2D_INLINE void InitCharCanvasForChar(
+    NNSG2dCharCanvas* pSub,
+    const NNSG2dCharCanvas* pCC,
+    int cx,
+    int cy
+)
+{
+    NNS_G2dCharCanvasInitForBG(
+        pSub,
+        NNSi_G2dCharCanvasGetCharPtr(pCC, cx, cy),
+        1,
+        1,
+        (NNSG2dCharaColorMode)pCC->dstBpp
+    );
+    NNS_G2dCharCanvasSetGlyphRasterCache(pSub, pCC->pRasterCache);
+}
+
+
+
+
+
+//****************************************************************************
+// Static Functions
+//****************************************************************************
+
+/*---------------------------------------------------------------------------*
+  Name:         GetGlyphCharRect
+
+  Description:  Gets the characters of the CharCanvas on which a placed character is rendered.
+
+  Arguments:    pLayout:    Pointer to the TextLayout.
+                pGlyph:     Pointer to the placed character.
+                pRect:      Pointer to the buffer that stores the range of characters.
+
+  Returns:      FALSE if nothing is rendered on the CharCanvas.
+ *---------------------------------------------------------------------------*/
+static BOOL GetGlyphCharRect(
+    const NNSG2dTextLayout* pLayout,
+    const NNSG2dTextLayoutGlyph* pGlyph,
+    CharRect* pRect
+)
+{
+    const NNSG2dCharCanvas* pCC = pLayout->pTxn->pCanvas;
+    const int x0 = pGlyph->x + pGlyph->left;
+    const int y0 = pGlyph->y;
+    const int x1 = x0 + pGlyph->glyphWidth;
+    const int y1 = y0 + NNS_G2dFontGetCellHeight(pLayout->pTxn->pFont);
+
+    if( (pGlyph->glyphWidth == 0)
+        || (x1 <= 0) || (y1 <= 0)
+        || (x0 >= pCC->areaWidth * CHARACTER_WIDTH)
+        || (y0 >= pCC->areaHeight * CHARACTER_HEIGHT) )
+    {
+        return FALSE;
+    }
+
+    pRect->left   = MATH_IMax(x0, 0) / CHARACTER_WIDTH;
+    pRect->top    = MATH_IMax(y0, 0) / CHARACTER_HEIGHT;
+    pRect->right  = MATH_IMin((x1 - 1) / CHARACTER_WIDTH,  pCC->areaWidth - 1);
+    pRect->bottom = MATH_IMin((y1 - 1) / CHARACTER_HEIGHT, pCC->areaHeight - 1);
+
+    return TRUE;
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         MarkGlyph
+
+  Description:  Marks the characters of the CharCanvas under a placed character
+                to be rendered again.
+
+  Arguments:    pLayout:    Pointer to the TextLayout.
+                pGlyph:     Pointer to the placed character.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void MarkGlyph(NNSG2dTextLayout* pLayout, const NNSG2dTextLayoutGlyph* pGlyph)
+{
+    CharRect rect;
+    const int areaWidth = pLayout->pTxn->pCanvas->areaWidth;
+    int cx, cy;
+
+    if( ! GetGlyphCharRect(pLayout, pGlyph, &rect) )
+    {
+        return;
+    }
+
+    for( cy = rect.top; cy <= rect.bottom; cy++ )
+    {
+        for( cx = rect.left; cx <= rect.right; cx++ )
+        {
+            const int iChar = cy * areaWidth + cx;
+
+            if( ! IsDirty(pLayout, iChar) )
+            {
+                pLayout->pDirty[iChar >> 5] |= 1u << (iChar & 31);
+                pLayout->numDirty++;
+            }
+        }
+    }
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         MarkGlyphRange
+
+  Description:  Marks the characters of the CharCanvas under the placed characters
+                of a range to be rendered again.
+
+  Arguments:    pLayout:    Pointer to the TextLayout.
+                pGlyph:     Pointer to the placed character array.
+                begin:      First placed character of the range.
+                end:        Placed character after the range.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void MarkGlyphRange(
+    NNSG2dTextLayout* pLayout,
+    const NNSG2dTextLayoutGlyph* pGlyph,
+    int begin,
+    int end
+)
+{
+    int i;
+
+    for( i = begin; i < end; i++ )
+    {
+        MarkGlyph(pLayout, &pGlyph[i]);
+    }
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         RegisterTransfer
+
+  Description:  Registers VRAM transfer tasks for the characters of the CharCanvas
+                rendered again. Successive characters are registered as 1 task.
+                The characters registered are no longer marked.
+
+  Arguments:    pLayout:        Pointer to the TextLayout.
+                pRegisterFunc:  VRAM transfer task register function.
+                type:           Transfer destination type.
+                dstAddr:        Transfer destination address of the CharCanvas top.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+static void RegisterTransfer(
+    NNSG2dTextLayout* pLayout,
+    VramTransferTaskRegisterFuncPtr pRegisterFunc,
+    NNS_GFD_DST_TYPE type,
+    u32 dstAddr
+)
+{
+    const NNSG2dCharCanvas* pCC = pLayout->pTxn->pCanvas;
+    const u32 charSize = (u32)(CHARACTER_WIDTH * CHARACTER_HEIGHT * pCC->dstBpp / 8);
+    const int numChar = GetNumChar(pCC);
+    u8* pRun = NULL;        // first character of the run
+    u32 szRun = 0;          // bytes of the run
+    int iRun = 0;           // index of the first character of the run
+    int iChar;
+
+    // The character after the last one flushes the last run.
+    for( iChar = 0; iChar <= numChar; iChar++ )
+    {
+        u8* pChar = NULL;
+
+        if( iChar < numChar && IsDirty(pLayout, iChar) )
+        {
+            pChar = NNSi_G2dCharCanvasGetCharPtr(pCC,
+                        iChar % pCC->areaWidth, iChar / pCC->areaWidth);
+
+            if( pChar == pRun + szRun )
+            {
+                szRun += charSize;
+                continue;
+            }
+        }
+
+        if( szRun > 0 )
+        {
+            const u32 offset = (u32)(pRun - pCC->charBase);
+
+            if( ! (*pRegisterFunc)(type, dstAddr + offset, pRun, szRun) )
+            {
+                // The task queue is full.
+                // The remaining characters stay marked and are transferred next time.
+                return;
+            }
+            pLayout->numTransfer++;
+
+            // the characters of the run are no longer marked
+            {
+                int i;
+
+                for( i = iRun; i < iChar; i++ )
+                {
+                    if( IsDirty(pLayout, i) )
+                    {
+                        pLayout->pDirty[i >> 5] &= ~(1u << (i & 31));
+                        pLayout->numDirty--;
+                    }
+                }
+            }
+            szRun = 0;
+        }
+
+        if( pChar != NULL )
+        {
+            pRun  = pChar;
+            szRun = charSize;
+            iRun  = iChar;
+        }
+    }
+}
+
+
+
+
+
+//****************************************************************************
+// global functions
+//****************************************************************************
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dTextLayoutGetWorkSize
+
+  Description:  Calculates the size of the work buffer required by a TextLayout.
+
+  Arguments:    pTxn:       Pointer to the TextCanvas used by the TextLayout.
+                maxGlyph:   Maximum number of characters placed.
+
+  Returns:      Size of the work buffer in bytes.
+ *---------------------------------------------------------------------------*/
+u32 NNS_G2dTextLayoutGetWorkSize(
+    const NNSG2dTextCanvas* pTxn,
+    u16 maxGlyph
+)
+{
+    NNS_G2D_TEXTCANVAS_ASSERT( pTxn );
+
+    return (u32)( (GetNumChar(pTxn->pCanvas) + 31) / 32 * sizeof(u32)
+                  + 2 * maxGlyph * sizeof(NNSG2dTextLayoutGlyph) );
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dTextLayoutInit
+
+  Description:  Initializes the TextLayout.
+
+  Arguments:    pLayout:    Pointer to the TextLayout to initialize.
+                pTxn:       Pointer to the TextCanvas used for layout and rendering.
+                bgColor:    Color number of the background.
+                pWork:      Pointer to the work buffer.
+                maxGlyph:   Maximum number of characters placed.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dTextLayoutInit(
+    NNSG2dTextLayout* pLayout,
+    const NNSG2dTextCanvas* pTxn,
+    int bgColor,
+    void* pWork,
+    u16 maxGlyph
+)
+{
+    const u32 szDirty = (u32)(GetNumChar(pTxn->pCanvas) + 31) / 32 * sizeof(u32);
+
+    NNS_G2D_POINTER_ASSERT( pLayout );
+    NNS_G2D_TEXTCANVAS_ASSERT( pTxn );
+    NNS_G2D_POINTER_ASSERT( pWork );
+    NNS_G2D_ALIGN_ASSERT( pWork, 4 );
+    NNS_G2D_MINMAX_ASSERT( bgColor, 0, (1 << pTxn->pCanvas->dstBpp) - 1 );
+#ifdef NNS_G2D_FONT_ENABLE_DIRECTION_SUPPORT
+    NNS_G2D_ASSERTMSG( NNSi_G2dGetTextDirection(pTxn->pFont).x == 1,
+        "NNSG2dTextLayout supports only the fonts written from left to right." );
+#endif
+
+    pLayout->pTxn       = pTxn;
+    pLayout->bgColor    = bgColor;
+    pLayout->maxGlyph   = maxGlyph;
+    pLayout->numGlyph   = 0;
+    pLayout->numVisible = NNS_G2D_TEXTLAYOUT_VISIBLE_ALL;
+    pLayout->pDirty     = (u32*)pWork;
+    pLayout->pGlyph[0]  = (NNSG2dTextLayoutGlyph*)((u8*)pWork + szDirty);
+    pLayout->pGlyph[1]  = pLayout->pGlyph[0] + maxGlyph;
+
+    pLayout->numDrawChar    = 0;
+    pLayout->numDrawGlyph   = 0;
+    pLayout->numTransfer    = 0;
+
+    NNS_G2dTextLayoutInvalidate( pLayout );
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNSi_G2dTextLayoutSetText
+
+  Description:  Places a multi-line string and replaces the characters placed before.
+
+  Arguments:    pLayout:    Pointer to the TextLayout.
+                x:          Upper left coordinate of the string.
+                y:          Upper left coordinate of the string.
+                cl:         Color number of character color.
+                wrapWidth:  Width after which a line is broken automatically.
+                txt:        String to be placed.
+
+  Returns:      Number of characters placed.
+ *---------------------------------------------------------------------------*/
+int NNSi_G2dTextLayoutSetText(
+    NNSG2dTextLayout* pLayout,
+    int x,
+    int y,
+    int cl,
+    int wrapWidth,
+    const void* txt
+)
+{
+    const NNSG2dFont* pFont;
+    NNSG2dTextLayoutGlyph* pNew;
+    NNSiG2dSplitCharCallback getNextChar;
+    const void* pos;
+    int linefeed;
+    int charSpace;
+    int px, py;
+    int num = 0;
+    u16 c;
+
+    NNS_G2D_TEXTLAYOUT_ASSERT( pLayout );
+    NNS_G2D_POINTER_ASSERT( txt );
+    NNS_G2D_MINMAX_ASSERT( cl, 0,
+        (1 << pLayout->pTxn->pCanvas->dstBpp)
+        - (1 << NNS_G2dFontGetBpp(pLayout->pTxn->pFont)) + 1 );
+
+    pFont       = pLayout->pTxn->pFont;
+    charSpace   = pLayout->pTxn->hSpace;
+    linefeed    = NNS_G2dFontGetLineFeed(pFont) + pLayout->pTxn->vSpace;
+    getNextChar = NNSi_G2dFontGetSpliter(pFont);
+    pNew        = pLayout->pGlyph[1];
+    pos         = txt;
+    px          = x;
+    py          = y;
+
+    // place the characters
+    while( (c = getNextChar((const void**)&pos)) != 0 )
+    {
+        const NNSG2dCharWidths* pWidths;
+
+        if( c == '\n' )
+        {
+            px = x;
+            py += linefeed;
+            continue;
+        }
+        if( c < ' ' )
+        {
+            continue;
+        }
+        if( num >= pLayout->maxGlyph )
+        {
+            break;
+        }
+
+        pWidths = NNS_G2dFontGetCharWidths(pFont, c);
+
+        if( (wrapWidth > 0) && (px > x) && (px - x + pWidths->charWidth > wrapWidth) )
+        {
+            px = x;
+            py += linefeed;
+        }
+
+        pNew[num].x          = (s16)px;
+        pNew[num].y          = (s16)py;
+        pNew[num].ccode      = c;
+        pNew[num].cl         = (u8)cl;
+        pNew[num].left       = pWidths->left;
+        pNew[num].glyphWidth = pWidths->glyphWidth;
+        pNew[num].reserved   = 0;
+        num++;
+
+        px += pWidths->charWidth + charSpace;
+    }
+
+    // mark the characters of the CharCanvas where the placed characters differ
+    {
+        const NNSG2dTextLayoutGlyph* pOld = pLayout->pGlyph[0];
+        const int oldVisible = MATH_IMin(pLayout->numGlyph, pLayout->numVisible);
+        const int newVisible = MATH_IMin(num, pLayout->numVisible);
+        const int numCommon  = MATH_IMin(oldVisible, newVisible);
+        int i;
+
+        for( i = 0; i < numCommon; i++ )
+        {
+            if( ! IsSameGlyph(&pOld[i], &pNew[i]) )
+            {
+                MarkGlyph(pLayout, &pOld[i]);
+                MarkGlyph(pLayout, &pNew[i]);
+            }
+        }
+        MarkGlyphRange(pLayout, pOld, numCommon, oldVisible);
+        MarkGlyphRange(pLayout, pNew, numCommon, newVisible);
+    }
+
+    pLayout->pGlyph[1] = pLayout->pGlyph[0];
+    pLayout->pGlyph[0] = pNew;
+    pLayout->numGlyph  = (u16)num;
+
+    return num;
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dTextLayoutSetVisibleCount
+
+  Description:  Configures the number of placed characters that are rendered.
+
+  Arguments:    pLayout:    Pointer to the TextLayout.
+                numVisible: Number of characters rendered from the first character.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dTextLayoutSetVisibleCount(
+    NNSG2dTextLayout* pLayout,
+    u16 numVisible
+)
+{
+    NNS_G2D_TEXTLAYOUT_ASSERT( pLayout );
+
+    {
+        const int oldVisible = MATH_IMin(pLayout->numGlyph, pLayout->numVisible);
+        const int newVisible = MATH_IMin(pLayout->numGlyph, numVisible);
+
+        MarkGlyphRange(pLayout, pLayout->pGlyph[0],
+            MATH_IMin(oldVisible, newVisible), MATH_IMax(oldVisible, newVisible));
+    }
+
+    pLayout->numVisible = numVisible;
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dTextLayoutInvalidate
+
+  Description:  Renders all the characters of the CharCanvas at the next NNS_G2dTextLayoutDraw.
+
+  Arguments:    pLayout:    Pointer to the TextLayout.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dTextLayoutInvalidate( NNSG2dTextLayout* pLayout )
+{
+    const NNSG2dCharCanvas* pCC;
+    int numChar;
+
+    NNS_G2D_TEXTLAYOUT_ASSERT( pLayout );
+
+    pCC = pLayout->pTxn->pCanvas;
+    numChar = GetNumChar(pCC);
+
+    MI_CpuFill32(pLayout->pDirty, 0xFFFFFFFF, (u32)(numChar + 31) / 32 * sizeof(u32));
+
+    // the bits after the last character are not used
+    if( (numChar & 31) != 0 )
+    {
+        pLayout->pDirty[numChar >> 5] = (1u << (numChar & 31)) - 1;
+    }
+
+    pLayout->numDirty = (u16)numChar;
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dTextLayoutDraw
+
+  Description:  Renders the characters of the CharCanvas changed since the last call.
+
+  Arguments:    pLayout:        Pointer to the TextLayout.
+                pRegisterFunc:  VRAM transfer task register function. NULL if not used.
+                type:           Transfer destination type.
+                dstAddr:        Transfer destination address of the CharCanvas top.
+
+  Returns:      Number of characters of the CharCanvas rendered.
+ *---------------------------------------------------------------------------*/
+int NNS_G2dTextLayoutDraw(
+    NNSG2dTextLayout* pLayout,
+    VramTransferTaskRegisterFuncPtr pRegisterFunc,
+    NNS_GFD_DST_TYPE type,
+    u32 dstAddr
+)
+{
+    const NNSG2dCharCanvas* pCC;
+    const NNSG2dFont* pFont;
+    NNSG2dCharCanvas sub;
+    int numChar;
+    int iChar;
+
+    NNS_G2D_TEXTLAYOUT_ASSERT( pLayout );
+
+    pLayout->numDrawChar    = 0;
+    pLayout->numDrawGlyph   = 0;
+    pLayout->numTransfer    = 0;
+
+    if( pLayout->numDirty == 0 )
+    {
+        return 0;
+    }
+
+    pCC     = pLayout->pTxn->pCanvas;
+    pFont   = pLayout->pTxn->pFont;
+    numChar = GetNumChar(pCC);
+
+    // fill the characters with the background color
+    for( iChar = 0; iChar < numChar; iChar++ )
+    {
+        if( pLayout->pDirty[iChar >> 5] == 0 )
+        {
+            // skip 32 characters
+            iChar |= 31;
+            continue;
+        }
+
+        if( IsDirty(pLayout, iChar) )
+        {
+            InitCharCanvasForChar(&sub, pCC, iChar % pCC->areaWidth, iChar / pCC->areaWidth);
+            NNS_G2dCharCanvasClear(&sub, pLayout->bgColor);
+            pLayout->numDrawChar++;
+        }
+    }
+
+    // render the placed characters clipped to the filled characters, in the placed order
+    {
+        const NNSG2dTextLayoutGlyph* pGlyph = pLayout->pGlyph[0];
+        const int numVisible = MATH_IMin(pLayout->numGlyph, pLayout->numVisible);
+        int i;
+
+        for( i = 0; i < numVisible; i++ )
+        {
+            CharRect rect;
+            NNSG2dGlyph glyph;
+            BOOL bGlyphReady = FALSE;
+            int cx, cy;
+
+            if( ! GetGlyphCharRect(pLayout, &pGlyph[i], &rect) )
+            {
+                continue;
+            }
+
+            for( cy = rect.top; cy <= rect.bottom; cy++ )
+            {
+                for( cx = rect.left; cx <= rect.right; cx++ )
+                {
+                    if( ! IsDirty(pLayout, cy * pCC->areaWidth + cx) )
+                    {
+                        continue;
+                    }
+
+                    if( ! bGlyphReady )
+                    {
+                        NNS_G2dFontGetGlyph(&glyph, pFont, pGlyph[i].ccode);
+                        bGlyphReady = TRUE;
+                    }
+
+                    InitCharCanvasForChar(&sub, pCC, cx, cy);
+                    NNS_G2dCharCanvasDrawGlyph(&sub, pFont,
+                        pGlyph[i].x + pGlyph[i].left - cx * CHARACTER_WIDTH,
+                        pGlyph[i].y - cy * CHARACTER_HEIGHT,
+                        pGlyph[i].cl, &glyph);
+                    pLayout->numDrawGlyph++;
+                }
+            }
+        }
+    }
+
+    // transfer the rendered characters
+    if( pRegisterFunc != NULL )
+    {
+        RegisterTransfer(pLayout, pRegisterFunc, type, dstAddr);
+    }
+    else
+    {
+        MI_CpuClear32(pLayout->pDirty, (u32)(numChar + 31) / 32 * sizeof(u32));
+        pLayout->numDirty = 0;
+    }
+
+    return (int)pLayout->numDrawChar;
+}
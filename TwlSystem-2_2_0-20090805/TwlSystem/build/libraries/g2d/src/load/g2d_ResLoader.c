@@ -0,0 +1,366 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - libraries - g2d - src - load
+  File:     g2d_ResLoader.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#include <nitro.h>
+#include <nnsys/g2d/load/g2d_ResLoader.h>
+#include <nnsys/g2d/g2d_Load.h>
+#include "g2di_Debug.h"
+
+
+//------------------------------------------------------------------------------
+// Opens the resource file and starts reading it into the arena.
+static BOOL StartReadFile_( NNSG2dResLoader* pLoader, u16 idx )
+{
+    NNSG2dResLoadEntry* pEntry  = &pLoader->pEntry[idx];
+    FSFile*             pFile   = &pLoader->file[idx & 1];
+
+    NNS_G2D_NULL_ASSERT( pEntry->pFname );
+
+    pEntry->pRes    = NULL;
+    pEntry->pFile   = NULL;
+
+    FS_InitFile( pFile );
+    if( !FS_OpenFile( pFile, pEntry->pFname ) )
+    {
+        NNS_G2D_WARNING( FALSE, "Can't find the file : %s", pEntry->pFname );
+        return FALSE;
+    }
+
+    {
+        const u32   szFile  = FS_GetLength( pFile );
+        void*       pBuf    = NNS_FndAllocFromAllocator( pLoader->pAllocator, szFile );
+
+        if( pBuf == NULL )
+        {
+            NNS_G2D_WARNING( FALSE, "Failed to allocate the file image : %s", pEntry->pFname );
+            (void)FS_CloseFile( pFile );
+            return FALSE;
+        }
+
+        if( FS_ReadFileAsync( pFile, pBuf, (s32)szFile ) < 0 )
+        {
+            (void)FS_CloseFile( pFile );
+            return FALSE;
+        }
+
+        pEntry->pFile = pBuf;
+        return TRUE;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Waits for the end of the read started by StartReadFile_ and closes the file.
+static BOOL FinishReadFile_( NNSG2dResLoader* pLoader, u16 idx )
+{
+    FSFile*         pFile   = &pLoader->file[idx & 1];
+    const OSTick    tick    = OS_GetTick();
+    u32             szFile;
+    BOOL            bSuccess;
+
+    bSuccess = FS_WaitAsync( pFile );
+    pLoader->tickWaitRead += OS_GetTick() - tick;
+
+    szFile = FS_GetLength( pFile );
+    (void)FS_CloseFile( pFile );
+
+    if( bSuccess )
+    {
+        pLoader->szTotal += szFile;
+    }
+    return bSuccess;
+}
+
+//------------------------------------------------------------------------------
+// Relocates the offsets of the file image and sets the resource to the entry.
+static BOOL UnpackRes_( NNSG2dResLoadEntry* pEntry )
+{
+    void*   pFile = pEntry->pFile;
+    BOOL    bSuccess;
+
+    switch( pEntry->type )
+    {
+    case NNS_G2D_RESTYPE_CHARACTER:
+        {
+            NNSG2dCharacterData* pRes;
+            bSuccess = NNS_G2dGetUnpackedCharacterData( pFile, &pRes );
+            pEntry->pRes = pRes;
+        }
+        break;
+    case NNS_G2D_RESTYPE_BGCHARACTER:
+        {
+            NNSG2dCharacterData* pRes;
+            bSuccess = NNS_G2dGetUnpackedBGCharacterData( pFile, &pRes );
+            pEntry->pRes = pRes;
+        }
+        break;
+    case NNS_G2D_RESTYPE_PALETTE:
+        {
+            NNSG2dPaletteData* pRes;
+            bSuccess = NNS_G2dGetUnpackedPaletteData( pFile, &pRes );
+            pEntry->pRes = pRes;
+        }
+        break;
+    case NNS_G2D_RESTYPE_CELLBANK:
+        {
+            NNSG2dCellDataBank* pRes;
+            bSuccess = NNS_G2dGetUnpackedCellBank( pFile, &pRes );
+            pEntry->pRes = pRes;
+        }
+        break;
+    case NNS_G2D_RESTYPE_ANIMBANK:
+        {
+            NNSG2dAnimBankData* pRes;
+            bSuccess = NNS_G2dGetUnpackedAnimBank( pFile, &pRes );
+            pEntry->pRes = pRes;
+        }
+        break;
+    case NNS_G2D_RESTYPE_MULTICELLBANK:
+        {
+            NNSG2dMultiCellDataBank* pRes;
+            bSuccess = NNS_G2dGetUnpackedMultiCellBank( pFile, &pRes );
+            pEntry->pRes = pRes;
+        }
+        break;
+    case NNS_G2D_RESTYPE_MCANIMBANK:
+        {
+            NNSG2dAnimBankData* pRes;
+            bSuccess = NNS_G2dGetUnpackedMCAnimBank( pFile, &pRes );
+            pEntry->pRes = pRes;
+        }
+        break;
+    case NNS_G2D_RESTYPE_SCREEN:
+        {
+            NNSG2dScreenData* pRes;
+            bSuccess = NNS_G2dGetUnpackedScreenData( pFile, &pRes );
+            pEntry->pRes = pRes;
+        }
+        break;
+    default:
+        NNS_G2D_ASSERTMSG( FALSE, "Unknown resource type." );
+        bSuccess = FALSE;
+        break;
+    }
+
+    if( !bSuccess )
+    {
+        pEntry->pRes = NULL;
+    }
+    return bSuccess;
+}
+
+//------------------------------------------------------------------------------
+// Worker thread
+//
+// The read of the next resource file is started before the current one is
+// unpacked, so that the ROM read goes on while the CPU unpacks.
+// numDone is updated last for each entry, so that the main thread can use
+// the entries processed so far.
+static void ResLoaderThread_( void* arg )
+{
+    NNSG2dResLoader*    pLoader     = (NNSG2dResLoader*)arg;
+    const OSTick        tickStart   = OS_GetTick();
+    BOOL                bReading;
+    u16                 i;
+
+    bReading = StartReadFile_( pLoader, 0 );
+
+    for( i = 0; i < pLoader->numEntry; i++ )
+    {
+        BOOL    bSuccess    = FALSE;
+        BOOL    bNextReading = FALSE;
+
+        if( bReading )
+        {
+            bSuccess = FinishReadFile_( pLoader, i );
+        }
+
+        if( i + 1 < pLoader->numEntry )
+        {
+            bNextReading = StartReadFile_( pLoader, (u16)(i + 1) );
+        }
+
+        if( bSuccess )
+        {
+            const OSTick tick = OS_GetTick();
+
+            bSuccess = UnpackRes_( &pLoader->pEntry[i] );
+            pLoader->tickUnpack += OS_GetTick() - tick;
+        }
+
+        if( !bSuccess )
+        {
+            pLoader->pEntry[i].pRes = NULL;
+            pLoader->numFailed++;
+        }
+
+        if( i + 1 == pLoader->numEntry )
+        {
+            pLoader->tickTotal = OS_GetTick() - tickStart;
+        }
+        pLoader->numDone = (u16)(i + 1);
+
+        bReading = bNextReading;
+    }
+
+    NNSI_G2D_DEBUGMSG0( "Loading %d resource files is finished.\n", pLoader->numEntry );
+}
+
+
+//------------------------------------------------------------------------------
+// Public Functions
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dInitResLoader
+
+  Description:  Initializes the resource loader.
+
+                The worker thread should have a lower priority (larger value) than
+                the main thread. It then loads while the main thread waits, for the
+                V-Blank for example, and sleeps while the ROM is read.
+
+  Arguments:    pLoader:            [OUT] resource loader
+                pStack:             [IN]  stack memory of the worker thread (4-byte aligned)
+                stackSize:          [IN]  stack size (multiple of 4)
+                threadPrio:         [IN]  priority of the worker thread
+
+  Returns:      None.
+
+ *---------------------------------------------------------------------------*/
+void NNS_G2dInitResLoader
+(
+    NNSG2dResLoader*        pLoader,
+    void*                   pStack,
+    u32                     stackSize,
+    u32                     threadPrio
+)
+{
+    NNS_G2D_NULL_ASSERT( pLoader );
+    NNS_G2D_NULL_ASSERT( pStack );
+    NNS_G2D_ASSERT( ((u32)pStack & 0x3) == 0 );
+    NNS_G2D_ASSERT( stackSize > 0 && ( stackSize & 0x3 ) == 0 );
+    NNS_G2D_ASSERT( threadPrio <= OS_THREAD_PRIORITY_MAX );
+
+    pLoader->pStackBottom   = (u8*)pStack + stackSize;
+    pLoader->stackSize      = stackSize;
+    pLoader->threadPrio     = threadPrio;
+    pLoader->bStarted       = FALSE;
+
+    pLoader->pAllocator     = NULL;
+    pLoader->pEntry         = NULL;
+    pLoader->numEntry       = 0;
+    pLoader->numDone        = 0;
+    pLoader->numFailed      = 0;
+
+    pLoader->szTotal        = 0;
+    pLoader->tickTotal      = 0;
+    pLoader->tickWaitRead   = 0;
+    pLoader->tickUnpack     = 0;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dStartResLoader
+
+  Description:  Starts loading a batch of resource files on the worker thread.
+
+                Each file image is allocated from pAllocator and unpacked there,
+                and pRes of the entry is set to the unpacked resource.
+                A frame heap is suited to the arena: all the resources of the batch
+                are freed at once by freeing the frame heap.
+                Use an alignment of 32 bytes for faster ROM reads.
+
+                The entries and the arena must not be accessed by other threads
+                until the entries are processed (see NNS_G2dGetResLoaderNumDone).
+                The previous batch must be finished.
+
+  Arguments:    pLoader:            [IN]  resource loader
+                pEntry:             [IN]  resource files (pRes and pFile are set)
+                numEntry:           [IN]  number of resource files
+                pAllocator:         [IN]  arena for the file images
+
+  Returns:      None.
+
+ *---------------------------------------------------------------------------*/
+void NNS_G2dStartResLoader
+(
+    NNSG2dResLoader*        pLoader,
+    NNSG2dResLoadEntry*     pEntry,
+    u16                     numEntry,
+    NNSFndAllocator*        pAllocator
+)
+{
+    NNS_G2D_NULL_ASSERT( pLoader );
+    NNS_G2D_NULL_ASSERT( pEntry );
+    NNS_G2D_NULL_ASSERT( pAllocator );
+    NNS_G2D_ASSERTMSG( !NNS_G2dIsResLoaderBusy( pLoader ), "The previous batch is being loaded." );
+
+    //
+    // The worker thread of the previous batch may still be running its last lines.
+    //
+    if( pLoader->bStarted )
+    {
+        OS_JoinThread( &pLoader->thread );
+    }
+
+    pLoader->pAllocator     = pAllocator;
+    pLoader->pEntry         = pEntry;
+    pLoader->numEntry       = numEntry;
+    pLoader->numDone        = 0;
+    pLoader->numFailed      = 0;
+
+    pLoader->szTotal        = 0;
+    pLoader->tickTotal      = 0;
+    pLoader->tickWaitRead   = 0;
+    pLoader->tickUnpack     = 0;
+
+    if( numEntry == 0 )
+    {
+        pLoader->bStarted = FALSE;
+        return;
+    }
+
+    OS_CreateThread( &pLoader->thread,
+                     ResLoaderThread_,
+                     pLoader,
+                     pLoader->pStackBottom,
+                     pLoader->stackSize,
+                     pLoader->threadPrio );
+    pLoader->bStarted = TRUE;
+
+    OS_WakeupThreadDirect( &pLoader->thread );
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dWaitResLoader
+
+  Description:  Waits until all the resource files of the batch are processed.
+
+  Arguments:    pLoader:            [IN]  resource loader
+
+  Returns:      TRUE if all the resource files are loaded successfully.
+
+ *---------------------------------------------------------------------------*/
+BOOL NNS_G2dWaitResLoader( NNSG2dResLoader* pLoader )
+{
+    NNS_G2D_NULL_ASSERT( pLoader );
+
+    if( pLoader->bStarted )
+    {
+        OS_JoinThread( &pLoader->thread );
+    }
+
+    NNS_G2D_ASSERT( pLoader->numDone == pLoader->numEntry );
+    return (BOOL)( pLoader->numFailed == 0 );
+}
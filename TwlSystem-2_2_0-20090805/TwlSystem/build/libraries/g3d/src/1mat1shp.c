@@ -20,6 +20,7 @@
 #include <nnsys/g3d/1mat1shp.h>
 #include <nnsys/g3d/binres/res_struct_accessor.h>
 #include <nnsys/g3d/gecom.h>
+#include <nnsys/g3d/glbstate.h>
 #include <nnsys/g3d/cgtool.h>
 
 
@@ -73,6 +74,9 @@ NNS_G3dDraw1Mat1Shp(const NNSG3dResMdl* pResMdl,
             if (!(mat->polyAttr & REG_G3_POLYGON_ATTR_ALPHA_MASK))
                 return;
 
+            // The material of NNS_G3dGlb is no longer in the geometry engine.
+            NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_GE_MATERIAL_UPTODATE;
+
             // G3_MaterialColorDiffAmb(mat->diffAmb);
             // G3_MaterialColorSpecEmi(mat->specEmi);
             // G3_PolygonAttr(...);
@@ -121,6 +121,23 @@ getRotDataByIdx_(MtxFx33* pRot,
                  NNSG3dJntAnmRIdx info);
 
 
+/*---------------------------------------------------------------------------*
+    getAnmFrame_
+
+    Returns Frame clamped to the range of frames of the joint animation resource.
+ *---------------------------------------------------------------------------*/
+static NNS_G3D_INLINE fx32
+getAnmFrame_(const NNSG3dResJntAnm* pJntAnm, fx32 Frame)
+{
+    if (Frame >= (pJntAnm->numFrame << FX32_SHIFT))
+        return (pJntAnm->numFrame << FX32_SHIFT) - 1;
+    else if (Frame < 0)
+        return 0;
+    else
+        return Frame;
+}
+
+
 /*---------------------------------------------------------------------------*
     NNSi_G3dAnmCalcNsBca
 
@@ -170,15 +187,8 @@ void NNSi_G3dAnmCalcNsBca(NNSG3dJntAnmResult* pResult,
     // 
     
     {
-        fx32 frame;
         NNSG3dResJntAnm* anm = (NNSG3dResJntAnm*)(pAnmObj->resAnm);
-
-        if (pAnmObj->frame >= (anm->numFrame << FX32_SHIFT))
-            frame = (anm->numFrame << FX32_SHIFT) - 1;
-        else if (pAnmObj->frame < 0)
-            frame = 0;
-        else
-            frame = pAnmObj->frame;
+        fx32 frame = getAnmFrame_(anm, pAnmObj->frame);
         
         //
         // Insert the results from the frame # resource for the dataIdx # joint animation resource, pAnm, into result.
@@ -417,57 +427,73 @@ getMdlRot_(NNSG3dJntAnmResult* pResult)
 
 
 /*---------------------------------------------------------------------------*
-    getJntSRTAnmResult_
+    getJntBaseFlag_
 
-    Sets the rotation, translation, and flag in pResult.
-    Sets the scale and the scale reciprocal in pS_invS.
+    Returns the channels of tag that reference the SRT of the model as NNSG3dJntAnmBatchBaseFlag.
  *---------------------------------------------------------------------------*/
-static void
-getJntSRTAnmResult_(const NNSG3dResJntAnm* pJntAnm, 
-                    u32                    dataIdx, 
-                    fx32                   Frame,
-                    NNSG3dJntAnmResult*    pResult)
+static NNS_G3D_INLINE u32
+getJntBaseFlag_(NNSG3dJntAnmSRTTag tag)
 {
-    NNSG3dResJntAnmSRTTag* pAnmSRTTag;
-    NNSG3dJntAnmSRTTag     tag;
-    const u32*             pData;
-    BOOL                   IsDecimalFrame;
-    fx32                   pS_invS[6]; // changed pointer argument to local array
+    u32 baseFlag = 0;
 
-    // check the input
-    NNS_G3D_NULL_ASSERT(pJntAnm);
-    NNS_G3D_NULL_ASSERT(pResult);
-    NNS_G3D_ASSERT(dataIdx < pJntAnm->numNode);
-    NNS_G3D_ASSERT(Frame < (pJntAnm->numFrame << FX32_SHIFT));
-    NNS_G3D_ASSERT(pJntAnm->anmHeader.category0 == 'J' &&
-                   pJntAnm->anmHeader.category1 == 'CA');
+    if (tag & NNS_G3D_JNTANM_SRTINFO_IDENTITY)
+        return 0;
 
-    {
-        const u16* ofsTag = (const u16*)((u8*) pJntAnm + sizeof(NNSG3dResJntAnm));
-        // get the SRT tag of the dataIdx-th data inside the animation resource
-        pAnmSRTTag = (NNSG3dResJntAnmSRTTag*)((u8*) pJntAnm + ofsTag[dataIdx]);
+    if ((tag & (NNS_G3D_JNTANM_SRTINFO_IDENTITY_T | NNS_G3D_JNTANM_SRTINFO_BASE_T)) ==
+            NNS_G3D_JNTANM_SRTINFO_BASE_T)
+        baseFlag |= NNS_G3D_JNTANM_BATCH_BASE_T;
 
-        tag = (NNSG3dJntAnmSRTTag)pAnmSRTTag->tag;
-    }
+    if ((tag & (NNS_G3D_JNTANM_SRTINFO_IDENTITY_R | NNS_G3D_JNTANM_SRTINFO_BASE_R)) ==
+            NNS_G3D_JNTANM_SRTINFO_BASE_R)
+        baseFlag |= NNS_G3D_JNTANM_BATCH_BASE_R;
+
+    if ((tag & (NNS_G3D_JNTANM_SRTINFO_IDENTITY_S | NNS_G3D_JNTANM_SRTINFO_BASE_S)) ==
+            NNS_G3D_JNTANM_SRTINFO_BASE_S)
+        baseFlag |= NNS_G3D_JNTANM_BATCH_BASE_S;
+
+    return baseFlag;
+}
+
+
+/*---------------------------------------------------------------------------*
+    getJntSRTAnmData_
+
+    Decodes the SRT animation data of pAnmSRTTag at Frame.
+    Sets the rotation in pRot, the translation in pTrans, and the scale and the scale reciprocal in pS_invS.
+    Returns the value of NNSG3dJntAnmResultFlag.
+
+    Since NNS_G3dRS is not referenced, this can also be called outside of the SBC.
+    Channels that reference the SRT of the model (see getJntBaseFlag_) are left to the caller.
+ *---------------------------------------------------------------------------*/
+static u32
+getJntSRTAnmData_(const NNSG3dResJntAnm*       pJntAnm,
+                  const NNSG3dResJntAnmSRTTag* pAnmSRTTag,
+                  fx32                         Frame,
+                  BOOL                         IsDecimalFrame,
+                  MtxFx33*                     pRot,
+                  VecFx32*                     pTrans,
+                  fx32*                        pS_invS)
+{
+    NNSG3dJntAnmSRTTag tag;
+    const u32*         pData;
+    u32                flag;
+
+    tag = (NNSG3dJntAnmSRTTag)pAnmSRTTag->tag;
 
     // check if no animation exists
     if (tag & NNS_G3D_JNTANM_SRTINFO_IDENTITY)
     {
-        pResult->flag = (NNSG3dJntAnmResultFlag)(NNS_G3D_JNTANM_RESULTFLAG_SCALE_ONE |
-                                                 NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO  |
-                                                 NNS_G3D_JNTANM_RESULTFLAG_TRANS_ZERO);
-        goto GET_JOINTSCALE;
+        return NNS_G3D_JNTANM_RESULTFLAG_SCALE_ONE |
+               NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO  |
+               NNS_G3D_JNTANM_RESULTFLAG_TRANS_ZERO;
     }
 
+    // reset first
+    flag = 0;
+
     // The variable-length data in accordance with the pAnmSRTTag value is stored in the region following pAnmSRTTag.
     pData = (const u32*)((const u8*)pAnmSRTTag + sizeof(NNSG3dResJntAnmSRTTag));
 
-    IsDecimalFrame = (BOOL)((Frame & (FX32_ONE - 1)) &&
-                            (pJntAnm->flag & NNS_G3D_JNTANM_OPTION_INTERPOLATION));
-
-    // reset first
-    pResult->flag = (NNSG3dJntAnmResultFlag) 0;
-
     //
     // Refer to the comments about NNSG3dResJntAnmSRT in res_struct.h.
     //
@@ -484,14 +510,14 @@ getJntSRTAnmResult_(const NNSG3dResJntAnm* pJntAnm,
             // The data offset will be from pAnmSRTTag.
             if (IsDecimalFrame)
             {
-                getTransDataEx_(&pResult->trans.x,
+                getTransDataEx_(&pTrans->x,
                                 Frame,
                                 pData,
                                 pJntAnm);
             }
             else
             {
-                getTransData_(&pResult->trans.x,
+                getTransData_(&pTrans->x,
                               Frame,
                               pData,
                               pJntAnm);
@@ -502,7 +528,7 @@ getJntSRTAnmResult_(const NNSG3dResJntAnm* pJntAnm,
         }
         else
         {
-            pResult->trans.x = *(fx32*)pData;
+            pTrans->x = *(fx32*)pData;
 
             // portion with constant data
             pData += 1;
@@ -515,14 +541,14 @@ getJntSRTAnmResult_(const NNSG3dResJntAnm* pJntAnm,
             // The data offset will be from pAnmSRTTag.
             if (IsDecimalFrame)
             {
-                getTransDataEx_(&pResult->trans.y,
+                getTransDataEx_(&pTrans->y,
                                 Frame,
                                 pData,
                                 pJntAnm);
             }
             else
             {
-                getTransData_(&pResult->trans.y,
+                getTransData_(&pTrans->y,
                               Frame,
                               pData,
                               pJntAnm);
@@ -533,7 +559,7 @@ getJntSRTAnmResult_(const NNSG3dResJntAnm* pJntAnm,
         }
         else
         {
-            pResult->trans.y = *(fx32*)pData;
+            pTrans->y = *(fx32*)pData;
 
             // portion with constant data
             pData += 1;
@@ -546,14 +572,14 @@ getJntSRTAnmResult_(const NNSG3dResJntAnm* pJntAnm,
             // The data offset will be from pAnmSRTTag.
             if (IsDecimalFrame)
             {
-                getTransDataEx_(&pResult->trans.z,
+                getTransDataEx_(&pTrans->z,
                                 Frame,
                                 pData,
                                 pJntAnm);
             }
             else
             {
-                getTransData_(&pResult->trans.z,
+                getTransData_(&pTrans->z,
                               Frame,
                               pData,
                               pJntAnm);
@@ -564,7 +590,7 @@ getJntSRTAnmResult_(const NNSG3dResJntAnm* pJntAnm,
         }
         else
         {
-            pResult->trans.z = *(fx32*)pData;
+            pTrans->z = *(fx32*)pData;
 
             // portion with constant data
             pData += 1;
@@ -575,15 +601,11 @@ getJntSRTAnmResult_(const NNSG3dResJntAnm* pJntAnm,
         if (tag & NNS_G3D_JNTANM_SRTINFO_IDENTITY_T)
         {
             // Trans = (0, 0, 0)
-            pResult->flag |= NNS_G3D_JNTANM_RESULTFLAG_TRANS_ZERO;
+            flag |= NNS_G3D_JNTANM_RESULTFLAG_TRANS_ZERO;
 
             // pData does not need to be advanced because there is no succeeding data
         }
-        else
-        {
-            // get the Trans of the model
-            getMdlTrans_(pResult);
-        }
+        // When NNS_G3D_JNTANM_SRTINFO_BASE_T is ON, the caller gets the Trans of the model.
     }
 
     //
@@ -598,14 +620,14 @@ getJntSRTAnmResult_(const NNSG3dResJntAnm* pJntAnm,
             // 
             if (IsDecimalFrame)
             {
-                getRotDataEx_(&pResult->rot,
+                getRotDataEx_(pRot,
                               Frame,
                               pData,
                               pJntAnm);
             }
             else
             {
-                getRotData_(&pResult->rot,
+                getRotData_(pRot,
                             Frame,
                             pData,
                             pJntAnm);
@@ -617,14 +639,14 @@ getJntSRTAnmResult_(const NNSG3dResJntAnm* pJntAnm,
         else
         {
             // This code extracts the R of the const.
-            if (getRotDataByIdx_(&pResult->rot,
+            if (getRotDataByIdx_(pRot,
                                  (void*)((u8*)pJntAnm + pJntAnm->ofsRot3),
                                  (void*)((u8*)pJntAnm + pJntAnm->ofsRot5),
                                  (NNSG3dJntAnmRIdx)*pData))
             {
-                vecCross_((const VecFx32*)&pResult->rot._00,
-                          (const VecFx32*)&pResult->rot._10,
-                          (VecFx32*)&pResult->rot._20);
+                vecCross_((const VecFx32*)&pRot->_00,
+                          (const VecFx32*)&pRot->_10,
+                          (VecFx32*)&pRot->_20);
             }
 
             // portion with constant data
@@ -636,15 +658,11 @@ getJntSRTAnmResult_(const NNSG3dResJntAnm* pJntAnm,
         if (tag & NNS_G3D_JNTANM_SRTINFO_IDENTITY_R)
         {
             // Rot = Identity
-            pResult->flag |= NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO;
+            flag |= NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO;
 
             // pData does not need to be advanced because there is no subsequent data
         }
-        else
-        {
-            // get the Rot of the model
-            getMdlRot_(pResult);
-        }
+        // When NNS_G3D_JNTANM_SRTINFO_BASE_R is ON, the caller gets the Rot of the model.
     }
 
     //
@@ -757,11 +775,75 @@ getJntSRTAnmResult_(const NNSG3dResJntAnm* pJntAnm,
         if (tag & NNS_G3D_JNTANM_SRTINFO_IDENTITY_S)
         {
             // Scale = (1, 1, 1)
-            pResult->flag |= NNS_G3D_JNTANM_RESULTFLAG_SCALE_ONE;
+            flag |= NNS_G3D_JNTANM_RESULTFLAG_SCALE_ONE;
 
             // pData does not need to be advanced because there is no subsequent data
         }
-        else
+        // When NNS_G3D_JNTANM_SRTINFO_BASE_S is ON, the caller gets the Scale of the model.
+    }
+
+    return flag;
+}
+
+
+/*---------------------------------------------------------------------------*
+    getJntSRTAnmResult_
+
+    Sets the rotation, translation, and flag in pResult.
+    Sets the scale and the scale reciprocal in pS_invS.
+ *---------------------------------------------------------------------------*/
+static void
+getJntSRTAnmResult_(const NNSG3dResJntAnm* pJntAnm, 
+                    u32                    dataIdx, 
+                    fx32                   Frame,
+                    NNSG3dJntAnmResult*    pResult)
+{
+    NNSG3dResJntAnmSRTTag* pAnmSRTTag;
+    u32                    baseFlag;
+    BOOL                   IsDecimalFrame;
+    fx32                   pS_invS[6]; // changed pointer argument to local array
+
+    // check the input
+    NNS_G3D_NULL_ASSERT(pJntAnm);
+    NNS_G3D_NULL_ASSERT(pResult);
+    NNS_G3D_ASSERT(dataIdx < pJntAnm->numNode);
+    NNS_G3D_ASSERT(Frame < (pJntAnm->numFrame << FX32_SHIFT));
+    NNS_G3D_ASSERT(pJntAnm->anmHeader.category0 == 'J' &&
+                   pJntAnm->anmHeader.category1 == 'CA');
+
+    {
+        const u16* ofsTag = (const u16*)((u8*) pJntAnm + sizeof(NNSG3dResJntAnm));
+        // get the SRT tag of the dataIdx-th data inside the animation resource
+        pAnmSRTTag = (NNSG3dResJntAnmSRTTag*)((u8*) pJntAnm + ofsTag[dataIdx]);
+    }
+
+    IsDecimalFrame = (BOOL)((Frame & (FX32_ONE - 1)) &&
+                            (pJntAnm->flag & NNS_G3D_JNTANM_OPTION_INTERPOLATION));
+
+    pResult->flag = (NNSG3dJntAnmResultFlag)getJntSRTAnmData_(pJntAnm,
+                                                              pAnmSRTTag,
+                                                              Frame,
+                                                              IsDecimalFrame,
+                                                              &pResult->rot,
+                                                              &pResult->trans,
+                                                              &pS_invS[0]);
+
+    baseFlag = getJntBaseFlag_((NNSG3dJntAnmSRTTag)pAnmSRTTag->tag);
+    if (baseFlag)
+    {
+        if (baseFlag & NNS_G3D_JNTANM_BATCH_BASE_T)
+        {
+            // get the Trans of the model
+            getMdlTrans_(pResult);
+        }
+
+        if (baseFlag & NNS_G3D_JNTANM_BATCH_BASE_R)
+        {
+            // get the Rot of the model
+            getMdlRot_(pResult);
+        }
+
+        if (baseFlag & NNS_G3D_JNTANM_BATCH_BASE_S)
         {
             // get the Scale of the model
             getMdlScale_(pResult);
@@ -771,7 +853,7 @@ getJntSRTAnmResult_(const NNSG3dResJntAnm* pJntAnm,
             return;
         }
     }
-GET_JOINTSCALE:
+
     //
     // set the NNSG3dJntAnmResult scaling info
     //
@@ -1924,4 +2006,201 @@ getRotDataByIdx_(MtxFx33* pRot,
     }
 }
 
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dJntAnmBatchInit
+
+    Initializes NNSG3dJntAnmBatch.
+    pResult is the array of numResult elements where the results of the joints are stored.
+    It should have at least as many elements as the number of joints in the animation resource.
+    The size in bytes can be found with NNS_G3D_JNTANM_BATCH_BUFFER_SIZE.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dJntAnmBatchInit(NNSG3dJntAnmBatch* pBatch,
+                       NNSG3dJntAnmBatchResult* pResult,
+                       u32 numResult)
+{
+    NNS_G3D_NULL_ASSERT(pBatch);
+    NNS_G3D_NULL_ASSERT(pResult);
+
+    pBatch->resAnm    = NULL;
+    pBatch->frame     = 0;
+    pBatch->numResult = numResult;
+    pBatch->pResult   = pResult;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dAnmObjSetJntAnmBatch
+
+    Makes the .nsbca animation object pAnmObj use pBatch.
+    From then on, the joint animation of pAnmObj is evaluated for all the joints at once and stored in pBatch,
+    and the SBC reads the results from pBatch.
+    Specifying NULL for pBatch returns to the evaluation for each joint.
+
+    pBatch can be shared among animation objects that play the same frame of the same resource
+    (for example, a crowd of characters playing the same motion in sync).
+    In this case, the joints are decoded only once for all the animation objects.
+    When the frames differ, prepare a pBatch for each animation object.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dAnmObjSetJntAnmBatch(NNSG3dAnmObj* pAnmObj, NNSG3dJntAnmBatch* pBatch)
+{
+    NNS_G3D_NULL_ASSERT(pAnmObj);
+    NNS_G3D_ASSERT(((NNSG3dResAnmHeader*)pAnmObj->resAnm)->category0 == 'J' &&
+                   ((NNSG3dResAnmHeader*)pAnmObj->resAnm)->category1 == 'CA');
+
+    pAnmObj->jntAnmBatch = pBatch;
+    if (pBatch)
+    {
+        pAnmObj->funcAnm = (void*) &NNSi_G3dAnmCalcNsBcaBatch;
+    }
+    else
+    {
+        pAnmObj->funcAnm = (void*) NNS_G3dFuncAnmJntNsBcaDefault;
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dJntAnmBatchCalc
+
+    Evaluates the joint animation of pAnmObj for all the joints at the current frame and stores the results in pBatch.
+    Nothing is done when pBatch already holds the results of the same resource and frame.
+    Returns TRUE when the joints were evaluated.
+
+    This is called from the SBC by the first joint that requires the animation,
+    but it can also be called in advance (for example, while waiting for the V-Blank).
+    Scale compensation that depends on the parent joints and the SRT values taken from the model
+    are calculated when the SBC reads the results, so this can be called outside of the SBC.
+ *---------------------------------------------------------------------------*/
+BOOL
+NNS_G3dJntAnmBatchCalc(NNSG3dJntAnmBatch* pBatch, const NNSG3dAnmObj* pAnmObj)
+{
+    const NNSG3dResJntAnm*   anm;
+    const u16*               ofsTag;
+    NNSG3dJntAnmBatchResult* pDst;
+    fx32                     frame;
+    BOOL                     IsDecimalFrame;
+    u32                      i;
+
+    NNS_G3D_NULL_ASSERT(pBatch);
+    NNS_G3D_NULL_ASSERT(pAnmObj);
+
+    anm = (const NNSG3dResJntAnm*)pAnmObj->resAnm;
+    frame = getAnmFrame_(anm, pAnmObj->frame);
+
+    if (pBatch->resAnm == anm && pBatch->frame == frame)
+    {
+        // already evaluated
+        return FALSE;
+    }
+
+    NNS_G3D_ASSERT(anm->anmHeader.category0 == 'J' &&
+                   anm->anmHeader.category1 == 'CA');
+    NNS_G3D_ASSERT(anm->numNode <= pBatch->numResult);
+
+    // The values common to all the joints are calculated only once.
+    ofsTag = (const u16*)((const u8*)anm + sizeof(NNSG3dResJntAnm));
+    IsDecimalFrame = (BOOL)((frame & (FX32_ONE - 1)) &&
+                            (anm->flag & NNS_G3D_JNTANM_OPTION_INTERPOLATION));
+    pDst = pBatch->pResult;
+
+    for (i = 0; i < anm->numNode; ++i, ++pDst)
+    {
+        const NNSG3dResJntAnmSRTTag* pAnmSRTTag =
+            (const NNSG3dResJntAnmSRTTag*)((const u8*)anm + ofsTag[i]);
+
+        pDst->flag = (u16)getJntSRTAnmData_(anm,
+                                            pAnmSRTTag,
+                                            frame,
+                                            IsDecimalFrame,
+                                            &pDst->rot,
+                                            &pDst->trans,
+                                            &pDst->s_invs[0]);
+        pDst->baseFlag = (u16)getJntBaseFlag_((NNSG3dJntAnmSRTTag)pAnmSRTTag->tag);
+    }
+
+    pBatch->resAnm = anm;
+    pBatch->frame  = frame;
+    return TRUE;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNSi_G3dAnmCalcNsBcaBatch
+
+    Joint animation calculation function used by the animation objects set with NNS_G3dAnmObjSetJntAnmBatch.
+    Produces the same results as NNSi_G3dAnmCalcNsBca from the results stored in pAnmObj->jntAnmBatch.
+
+    pResult: stores the result of the joint animation
+    pAnmObj:
+    dataIdx: Index that indicates the storage location for the data in the resource.
+ *---------------------------------------------------------------------------*/
+void NNSi_G3dAnmCalcNsBcaBatch(NNSG3dJntAnmResult* pResult,
+                               const NNSG3dAnmObj* pAnmObj,
+                               u32 dataIdx)
+{
+    NNSG3dJntAnmBatch* pBatch;
+    const NNSG3dJntAnmBatchResult* pSrc;
+
+    NNS_G3D_NULL_ASSERT(pResult);
+    NNS_G3D_NULL_ASSERT(pAnmObj);
+    NNS_G3D_NULL_ASSERT(pAnmObj->jntAnmBatch);
+
+    pBatch = pAnmObj->jntAnmBatch;
+
+    // Only the first call of the frame evaluates the joints.
+    (void)NNS_G3dJntAnmBatchCalc(pBatch, pAnmObj);
+
+    NNS_G3D_ASSERT(dataIdx < pBatch->numResult);
+    pSrc = &pBatch->pResult[dataIdx];
+
+    pResult->flag = (NNSG3dJntAnmResultFlag)pSrc->flag;
+
+    //
+    // Translation
+    //
+    if (pSrc->baseFlag & NNS_G3D_JNTANM_BATCH_BASE_T)
+    {
+        getMdlTrans_(pResult);
+    }
+    else if (!(pSrc->flag & NNS_G3D_JNTANM_RESULTFLAG_TRANS_ZERO))
+    {
+        pResult->trans = pSrc->trans;
+    }
+
+    //
+    // Rotation
+    //
+    if (pSrc->baseFlag & NNS_G3D_JNTANM_BATCH_BASE_R)
+    {
+        getMdlRot_(pResult);
+    }
+    else if (!(pSrc->flag & NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO))
+    {
+        MI_Copy36B(&pSrc->rot, &pResult->rot);
+    }
+
+    //
+    // Scale
+    //
+    if (pSrc->baseFlag & NNS_G3D_JNTANM_BATCH_BASE_S)
+    {
+        getMdlScale_(pResult);
+    }
+    else
+    {
+        (*NNS_G3dRS->funcJntScale)(
+            pResult, 
+            &pSrc->s_invs[0],
+            NNS_G3dRS->c,
+            ((pSrc->flag & NNS_G3D_JNTANM_RESULTFLAG_SCALE_ONE) ?
+                    (u32)NNS_G3D_SRTFLAG_SCALE_ONE :
+                    0)
+        );
+    }
+}
+
+
 #endif // NNS_G3D_NSBCA_DISABLE
@@ -0,0 +1,754 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - libraries - g3d
+  File:     anmblend.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#include <nnsys/g3d/anmblend.h>
+#include <nnsys/g3d/sbc.h>
+#include <nnsys/g3d/util.h>
+#include <nnsys/g3d/binres/res_struct_accessor.h>
+
+#define POSE_FLAG_MASK (NNS_G3D_JNTANM_RESULTFLAG_TRANS_ZERO | \
+                        NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO   | \
+                        NNS_G3D_JNTANM_RESULTFLAG_SCALE_ONE)
+
+// Get the data from Rot3.
+// The first index in the array storing the positions of non-zero, non-pivot elements will be the pivot position.
+//
+static const u8 pivotUtil_[9][4] =
+{
+    {4, 5, 7, 8},
+    {3, 5, 6, 8},
+    {3, 4, 6, 7},
+
+    {1, 2, 7, 8},
+    {0, 2, 6, 8},
+    {0, 1, 6, 7},
+
+    {1, 2, 4, 5},
+    {0, 2, 3, 5},
+    {0, 1, 3, 4}
+};
+
+
+/*---------------------------------------------------------------------------*
+    quatIdentity_
+
+    Sets the identity quaternion.
+ *---------------------------------------------------------------------------*/
+static void
+quatIdentity_(fx32* q)
+{
+    q[0] = q[1] = q[2] = 0;
+    q[3] = FX32_ONE;
+}
+
+
+/*---------------------------------------------------------------------------*
+    quatFromMtx_
+
+    Converts the rotation matrix to a quaternion.
+    MtxFx33 is for row vectors, so m->m[j][i] is the element (i, j) of the rotation.
+ *---------------------------------------------------------------------------*/
+#include <nitro/code32.h>
+static void
+quatFromMtx_(fx32* q, const MtxFx33* m)
+{
+    fx32 trace = m->_00 + m->_11 + m->_22;
+    fx32 s;
+    fx32 inv;
+
+    if (trace > 0)
+    {
+        s = FX_Sqrt(trace + FX32_ONE) << 1;     // 4w
+        inv = FX_Inv(s);
+        q[3] = s >> 2;
+        q[0] = FX_Mul(m->_12 - m->_21, inv);
+        q[1] = FX_Mul(m->_20 - m->_02, inv);
+        q[2] = FX_Mul(m->_01 - m->_10, inv);
+    }
+    else if (m->_00 > m->_11 && m->_00 > m->_22)
+    {
+        s = FX_Sqrt(FX32_ONE + m->_00 - m->_11 - m->_22) << 1;  // 4x
+        inv = FX_Inv(s);
+        q[0] = s >> 2;
+        q[3] = FX_Mul(m->_12 - m->_21, inv);
+        q[1] = FX_Mul(m->_10 + m->_01, inv);
+        q[2] = FX_Mul(m->_20 + m->_02, inv);
+    }
+    else if (m->_11 > m->_22)
+    {
+        s = FX_Sqrt(FX32_ONE + m->_11 - m->_00 - m->_22) << 1;  // 4y
+        inv = FX_Inv(s);
+        q[1] = s >> 2;
+        q[3] = FX_Mul(m->_20 - m->_02, inv);
+        q[0] = FX_Mul(m->_10 + m->_01, inv);
+        q[2] = FX_Mul(m->_21 + m->_12, inv);
+    }
+    else
+    {
+        s = FX_Sqrt(FX32_ONE + m->_22 - m->_00 - m->_11) << 1;  // 4z
+        inv = FX_Inv(s);
+        q[2] = s >> 2;
+        q[3] = FX_Mul(m->_01 - m->_10, inv);
+        q[0] = FX_Mul(m->_20 + m->_02, inv);
+        q[1] = FX_Mul(m->_21 + m->_12, inv);
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    mtxFromQuat_
+
+    Converts the unit quaternion to a rotation matrix (for row vectors).
+ *---------------------------------------------------------------------------*/
+static void
+mtxFromQuat_(MtxFx33* m, const fx32* q)
+{
+    fx32 xx = FX_Mul(q[0], q[0]) << 1;
+    fx32 yy = FX_Mul(q[1], q[1]) << 1;
+    fx32 zz = FX_Mul(q[2], q[2]) << 1;
+    fx32 xy = FX_Mul(q[0], q[1]) << 1;
+    fx32 xz = FX_Mul(q[0], q[2]) << 1;
+    fx32 yz = FX_Mul(q[1], q[2]) << 1;
+    fx32 wx = FX_Mul(q[3], q[0]) << 1;
+    fx32 wy = FX_Mul(q[3], q[1]) << 1;
+    fx32 wz = FX_Mul(q[3], q[2]) << 1;
+
+    m->_00 = FX32_ONE - yy - zz;
+    m->_01 = xy + wz;
+    m->_02 = xz - wy;
+    m->_10 = xy - wz;
+    m->_11 = FX32_ONE - xx - zz;
+    m->_12 = yz + wx;
+    m->_20 = xz + wy;
+    m->_21 = yz - wx;
+    m->_22 = FX32_ONE - xx - yy;
+}
+
+
+/*---------------------------------------------------------------------------*
+    quatMul_
+
+    dst = a * b (dst may be a or b)
+ *---------------------------------------------------------------------------*/
+static void
+quatMul_(fx32* dst, const fx32* a, const fx32* b)
+{
+    fx32 x = (fx32)(((fx64)a[3] * b[0] + (fx64)a[0] * b[3] +
+                     (fx64)a[1] * b[2] - (fx64)a[2] * b[1]) >> FX32_SHIFT);
+    fx32 y = (fx32)(((fx64)a[3] * b[1] - (fx64)a[0] * b[2] +
+                     (fx64)a[1] * b[3] + (fx64)a[2] * b[0]) >> FX32_SHIFT);
+    fx32 z = (fx32)(((fx64)a[3] * b[2] + (fx64)a[0] * b[1] -
+                     (fx64)a[1] * b[0] + (fx64)a[2] * b[3]) >> FX32_SHIFT);
+    fx32 w = (fx32)(((fx64)a[3] * b[3] - (fx64)a[0] * b[0] -
+                     (fx64)a[1] * b[1] - (fx64)a[2] * b[2]) >> FX32_SHIFT);
+    dst[0] = x;
+    dst[1] = y;
+    dst[2] = z;
+    dst[3] = w;
+}
+
+
+/*---------------------------------------------------------------------------*
+    quatNlerp_
+
+    dst = normalize(a + (b - a) * ratio), taking the shorter arc.
+ *---------------------------------------------------------------------------*/
+static void
+quatNlerp_(fx32* dst, const fx32* a, const fx32* b, fx32 ratio)
+{
+    fx64 dot = (fx64)a[0] * b[0] + (fx64)a[1] * b[1] +
+               (fx64)a[2] * b[2] + (fx64)a[3] * b[3];
+    fx64 len2;
+    fx32 inv;
+    fx32 r[4];
+    int i;
+
+    for (i = 0; i < 4; ++i)
+    {
+        fx32 bi = (dot < 0) ? -b[i] : b[i];
+        r[i] = a[i] + FX_Mul(bi - a[i], ratio);
+    }
+
+    len2 = (fx64)r[0] * r[0] + (fx64)r[1] * r[1] +
+           (fx64)r[2] * r[2] + (fx64)r[3] * r[3];
+    if (len2 == 0)
+    {
+        quatIdentity_(dst);
+        return;
+    }
+
+    inv = FX_InvSqrt((fx32)(len2 >> FX32_SHIFT));
+    for (i = 0; i < 4; ++i)
+    {
+        dst[i] = FX_Mul(r[i], inv);
+    }
+}
+#include <nitro/codereset.h>
+
+
+/*---------------------------------------------------------------------------*
+    getMdlPose_
+
+    Gets the SRT of the node of the model as a pose.
+ *---------------------------------------------------------------------------*/
+static void
+getMdlPose_(NNSG3dJntBlendPose* pPose, const NNSG3dResNodeData* pNd)
+{
+    const u8* p = (const u8*)pNd + sizeof(NNSG3dResNodeData);
+
+    pPose->flag = 0;
+
+    //
+    // Translation
+    //
+    if (pNd->flag & NNS_G3D_SRTFLAG_TRANS_ZERO)
+    {
+        pPose->flag |= NNS_G3D_JNTANM_RESULTFLAG_TRANS_ZERO;
+        pPose->trans.x = pPose->trans.y = pPose->trans.z = 0;
+    }
+    else
+    {
+        const fx32* p_fx32 = (const fx32*)p;
+
+        pPose->trans.x = *(p_fx32 + 0);
+        pPose->trans.y = *(p_fx32 + 1);
+        pPose->trans.z = *(p_fx32 + 2);
+        p += 3 * sizeof(fx32);
+    }
+
+    //
+    // Rotation
+    //
+    if (pNd->flag & NNS_G3D_SRTFLAG_ROT_ZERO)
+    {
+        pPose->flag |= NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO;
+        quatIdentity_(&pPose->quat[0]);
+    }
+    else
+    {
+        MtxFx33 rot;
+
+        if (pNd->flag & NNS_G3D_SRTFLAG_PIVOT_EXIST)
+        {
+            fx32 A = *(fx16*)(p + 0);
+            fx32 B = *(fx16*)(p + 2);
+            u32 idxPivot = (u32)( (pNd->flag & NNS_G3D_SRTFLAG_IDXPIVOT_MASK) >>
+                                            NNS_G3D_SRTFLAG_IDXPIVOT_SHIFT );
+            MI_Zero36B(&rot);
+
+            rot.a[idxPivot] =
+                (pNd->flag & NNS_G3D_SRTFLAG_PIVOT_MINUS) ?
+                    -FX32_ONE :
+                    FX32_ONE;
+
+            rot.a[pivotUtil_[idxPivot][0]] = A;
+            rot.a[pivotUtil_[idxPivot][1]] = B;
+
+            rot.a[pivotUtil_[idxPivot][2]] =
+                (pNd->flag & NNS_G3D_SRTFLAG_SIGN_REVC) ? -B : B;
+
+            rot.a[pivotUtil_[idxPivot][3]] =
+                (pNd->flag & NNS_G3D_SRTFLAG_SIGN_REVD) ? -A : A;
+
+            p += 2 * sizeof(fx16);
+        }
+        else
+        {
+            // NOTICE:
+            // do not replace in the memory copy API
+            // this is because of the implicit casting from fx16 to fx32
+
+            const fx16* pp = (const fx16*)p;
+            rot.a[0] = pNd->_00;
+            rot.a[1] = *(pp + 0);
+            rot.a[2] = *(pp + 1);
+            rot.a[3] = *(pp + 2);
+            rot.a[4] = *(pp + 3);
+            rot.a[5] = *(pp + 4);
+            rot.a[6] = *(pp + 5);
+            rot.a[7] = *(pp + 6);
+            rot.a[8] = *(pp + 7);
+
+            p += 8 * sizeof(fx16);
+        }
+        quatFromMtx_(&pPose->quat[0], &rot);
+    }
+
+    //
+    // Scale
+    //
+    if (pNd->flag & NNS_G3D_SRTFLAG_SCALE_ONE)
+    {
+        pPose->flag |= NNS_G3D_JNTANM_RESULTFLAG_SCALE_ONE;
+        pPose->s_invs[0] = pPose->s_invs[1] = pPose->s_invs[2] = FX32_ONE;
+        pPose->s_invs[3] = pPose->s_invs[4] = pPose->s_invs[5] = FX32_ONE;
+    }
+    else
+    {
+        MI_CpuCopy32(p, &pPose->s_invs[0], sizeof(pPose->s_invs));
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    getClipPose_
+
+    Converts the result of the batched evaluation to a pose.
+    The channels that take the SRT of the model are taken from pRest.
+ *---------------------------------------------------------------------------*/
+static void
+getClipPose_(NNSG3dJntBlendPose* pPose,
+             const NNSG3dJntAnmBatchResult* pSrc,
+             const NNSG3dJntBlendPose* pRest)
+{
+    pPose->flag = pSrc->flag & POSE_FLAG_MASK;
+
+    if (pSrc->baseFlag & NNS_G3D_JNTANM_BATCH_BASE_T)
+    {
+        pPose->flag = (pPose->flag & ~NNS_G3D_JNTANM_RESULTFLAG_TRANS_ZERO) |
+                      (pRest->flag & NNS_G3D_JNTANM_RESULTFLAG_TRANS_ZERO);
+        pPose->trans = pRest->trans;
+    }
+    else if (pSrc->flag & NNS_G3D_JNTANM_RESULTFLAG_TRANS_ZERO)
+    {
+        pPose->trans.x = pPose->trans.y = pPose->trans.z = 0;
+    }
+    else
+    {
+        pPose->trans = pSrc->trans;
+    }
+
+    if (pSrc->baseFlag & NNS_G3D_JNTANM_BATCH_BASE_R)
+    {
+        pPose->flag = (pPose->flag & ~NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO) |
+                      (pRest->flag & NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO);
+        MI_CpuCopy32(&pRest->quat[0], &pPose->quat[0], sizeof(pPose->quat));
+    }
+    else if (pSrc->flag & NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO)
+    {
+        quatIdentity_(&pPose->quat[0]);
+    }
+    else
+    {
+        quatFromMtx_(&pPose->quat[0], &pSrc->rot);
+    }
+
+    if (pSrc->baseFlag & NNS_G3D_JNTANM_BATCH_BASE_S)
+    {
+        pPose->flag = (pPose->flag & ~NNS_G3D_JNTANM_RESULTFLAG_SCALE_ONE) |
+                      (pRest->flag & NNS_G3D_JNTANM_RESULTFLAG_SCALE_ONE);
+        pPose->s_invs[0] = pRest->s_invs[0];
+        pPose->s_invs[1] = pRest->s_invs[1];
+        pPose->s_invs[2] = pRest->s_invs[2];
+    }
+    else if (pSrc->flag & NNS_G3D_JNTANM_RESULTFLAG_SCALE_ONE)
+    {
+        pPose->s_invs[0] = pPose->s_invs[1] = pPose->s_invs[2] = FX32_ONE;
+    }
+    else
+    {
+        pPose->s_invs[0] = pSrc->s_invs[0];
+        pPose->s_invs[1] = pSrc->s_invs[1];
+        pPose->s_invs[2] = pSrc->s_invs[2];
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    blendLerp_
+
+    pPose = pPose * (1 - weight) + pClip * weight
+ *---------------------------------------------------------------------------*/
+static void
+blendLerp_(NNSG3dJntBlendPose* pPose, const NNSG3dJntBlendPose* pClip, fx32 weight)
+{
+    int i;
+
+    if (weight >= FX32_ONE)
+    {
+        pPose->flag  = pClip->flag;
+        pPose->trans = pClip->trans;
+        MI_CpuCopy32(&pClip->quat[0], &pPose->quat[0], sizeof(pPose->quat));
+        pPose->s_invs[0] = pClip->s_invs[0];
+        pPose->s_invs[1] = pClip->s_invs[1];
+        pPose->s_invs[2] = pClip->s_invs[2];
+        return;
+    }
+
+    if (!(pPose->flag & pClip->flag & NNS_G3D_JNTANM_RESULTFLAG_TRANS_ZERO))
+    {
+        pPose->trans.x += FX_Mul(pClip->trans.x - pPose->trans.x, weight);
+        pPose->trans.y += FX_Mul(pClip->trans.y - pPose->trans.y, weight);
+        pPose->trans.z += FX_Mul(pClip->trans.z - pPose->trans.z, weight);
+    }
+
+    if (!(pPose->flag & pClip->flag & NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO))
+    {
+        quatNlerp_(&pPose->quat[0], &pPose->quat[0], &pClip->quat[0], weight);
+    }
+
+    if (!(pPose->flag & pClip->flag & NNS_G3D_JNTANM_RESULTFLAG_SCALE_ONE))
+    {
+        for (i = 0; i < 3; ++i)
+        {
+            pPose->s_invs[i] += FX_Mul(pClip->s_invs[i] - pPose->s_invs[i], weight);
+        }
+    }
+
+    pPose->flag &= pClip->flag;
+}
+
+
+/*---------------------------------------------------------------------------*
+    blendAdditive_
+
+    pPose = pPose + (pClip - pRest) * weight
+    The rotation is pPose * (inverse(pRest) * pClip) ^ weight.
+ *---------------------------------------------------------------------------*/
+static void
+blendAdditive_(NNSG3dJntBlendPose* pPose,
+               const NNSG3dJntBlendPose* pClip,
+               const NNSG3dJntBlendPose* pRest,
+               fx32 weight)
+{
+    u32 same = pClip->flag & pRest->flag;
+    int i;
+
+    if (!(same & NNS_G3D_JNTANM_RESULTFLAG_TRANS_ZERO))
+    {
+        pPose->trans.x += FX_Mul(pClip->trans.x - pRest->trans.x, weight);
+        pPose->trans.y += FX_Mul(pClip->trans.y - pRest->trans.y, weight);
+        pPose->trans.z += FX_Mul(pClip->trans.z - pRest->trans.z, weight);
+    }
+
+    if (!(same & NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO))
+    {
+        fx32 delta[4];
+        fx32 identity[4];
+
+        // inverse(pRest) * pClip
+        delta[0] = -pRest->quat[0];
+        delta[1] = -pRest->quat[1];
+        delta[2] = -pRest->quat[2];
+        delta[3] =  pRest->quat[3];
+        quatMul_(&delta[0], &delta[0], &pClip->quat[0]);
+
+        if (weight < FX32_ONE)
+        {
+            quatIdentity_(&identity[0]);
+            quatNlerp_(&delta[0], &identity[0], &delta[0], weight);
+        }
+        quatMul_(&pPose->quat[0], &pPose->quat[0], &delta[0]);
+    }
+
+    if (!(same & NNS_G3D_JNTANM_RESULTFLAG_SCALE_ONE))
+    {
+        for (i = 0; i < 3; ++i)
+        {
+            pPose->s_invs[i] += FX_Mul(pClip->s_invs[i] - pRest->s_invs[i], weight);
+        }
+    }
+
+    pPose->flag &= same;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dJntBlendTreeInit
+
+    Initializes the tree for the model pResMdl.
+    pBuf must be NNS_G3D_JNTBLENDTREE_BUFFER_SIZE(pResMdl->info.numNode) bytes (4-byte aligned).
+    Add pTree->pAnmObj to the render objects of pResMdl with NNS_G3dRenderObjAddAnmObj.
+    The layers must not be added to the render objects themselves.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dJntBlendTreeInit(NNSG3dJntBlendTree* pTree,
+                        void* pBuf,
+                        u32 szBuf,
+                        const NNSG3dResMdl* pResMdl)
+{
+    NNSG3dAnmObj* pAnmObj;
+    u32 numNode;
+    u32 i;
+
+    NNS_G3D_NULL_ASSERT(pTree);
+    NNS_G3D_NULL_ASSERT(pBuf);
+    NNS_G3D_NULL_ASSERT(pResMdl);
+    NNS_G3D_ASSERT(((u32)pBuf & 3) == 0);
+
+    numNode = pResMdl->info.numNode;
+    NNS_G3D_ASSERT(szBuf >= NNS_G3D_JNTBLENDTREE_BUFFER_SIZE(numNode));
+    (void)szBuf;
+
+    MI_CpuClear32(pTree, sizeof(NNSG3dJntBlendTree));
+    pTree->anmHeader.category0 = 'J';
+    pTree->anmHeader.category1 = NNS_G3D_JNTBLENDTREE_CATEGORY1;
+    pTree->resMdl  = pResMdl;
+    pTree->numNode = numNode;
+    pTree->pPose   = (NNSG3dJntBlendPose*)pBuf;
+    pTree->pRest   = pTree->pPose + numNode;
+
+    for (i = 0; i < numNode; ++i)
+    {
+        getMdlPose_(&pTree->pRest[i], NNS_G3dGetNodeDataByIdx(&pResMdl->nodeInfo, i));
+    }
+    MI_CpuCopy32(pTree->pRest, pTree->pPose, sizeof(NNSG3dJntBlendPose) * numNode);
+
+    //
+    // The animation object maps every node to the pose of the same index.
+    //
+    pAnmObj = (NNSG3dAnmObj*)(pTree->pRest + numNode);
+    MI_CpuClear32(pAnmObj, (sizeof(NNSG3dAnmObj) + sizeof(u16) * numNode + 3) & ~3);
+    pAnmObj->ratio      = FX32_ONE;
+    pAnmObj->resAnm     = pTree;
+    pAnmObj->funcAnm    = (void*) &NNSi_G3dAnmCalcJntBlendTree;
+    pAnmObj->priority   = 127;
+    pAnmObj->numMapData = (u8)numNode;
+    for (i = 0; i < numNode; ++i)
+    {
+        pAnmObj->mapData[i] = (u16)(NNS_G3D_ANMOBJ_MAPDATA_EXIST | i);
+    }
+    pTree->pAnmObj = pAnmObj;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dJntBlendTreeAddLayer
+
+    Adds a layer on top of the tree and returns its index.
+    pAnmObj must be a .nsbca animation object set with NNS_G3dAnmObjSetJntAnmBatch.
+    Layers that share a batch are evaluated only once.
+    pMask is referenced while the layer is used; NULL applies the layer to all the joints.
+ *---------------------------------------------------------------------------*/
+int
+NNS_G3dJntBlendTreeAddLayer(NNSG3dJntBlendTree* pTree,
+                            NNSG3dAnmObj* pAnmObj,
+                            NNSG3dJntBlendMode mode,
+                            fx32 weight,
+                            const u32* pMask)
+{
+    NNSG3dJntBlendLayer* pLayer;
+
+    NNS_G3D_NULL_ASSERT(pTree);
+    NNS_G3D_NULL_ASSERT(pAnmObj);
+    NNS_G3D_NULL_ASSERT(pAnmObj->jntAnmBatch);
+    NNS_G3D_ASSERT(pTree->numLayer < NNS_G3D_JNTBLEND_MAX_LAYER);
+    NNS_G3D_ASSERT(weight >= 0 && weight <= FX32_ONE);
+
+    pLayer = &pTree->layer[pTree->numLayer];
+    pLayer->pAnmObj = pAnmObj;
+    pLayer->pMask   = pMask;
+    pLayer->weight  = weight;
+    pLayer->mode    = (u32)mode;
+
+    return (int)pTree->numLayer++;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dJntBlendTreeSetWeight
+
+    Changes the weight of the layer idxLayer. A layer with a weight of 0 is not evaluated.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dJntBlendTreeSetWeight(NNSG3dJntBlendTree* pTree, int idxLayer, fx32 weight)
+{
+    NNS_G3D_NULL_ASSERT(pTree);
+    NNS_G3D_ASSERT(idxLayer >= 0 && idxLayer < (int)pTree->numLayer);
+    NNS_G3D_ASSERT(weight >= 0 && weight <= FX32_ONE);
+
+    pTree->layer[idxLayer].weight = weight;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dJntBlendTreeCalc
+
+    Evaluates the layers at the current frames of their animation objects and blends the pose.
+    Call it once per frame after updating the frames and the weights and before NNS_G3dDraw.
+    pTree->revision is advanced each time
+    so that NNSG3dJntAnmCache does not reuse the results of a previous pose.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dJntBlendTreeCalc(NNSG3dJntBlendTree* pTree)
+{
+    OSTick t;
+    u32 numEval = 0;
+    u32 i, n;
+
+    NNS_G3D_NULL_ASSERT(pTree);
+
+    t = OS_GetTick();
+
+    MI_CpuCopy32(pTree->pRest, pTree->pPose, sizeof(NNSG3dJntBlendPose) * pTree->numNode);
+
+    for (i = 0; i < pTree->numLayer; ++i)
+    {
+        const NNSG3dJntBlendLayer* pLayer = &pTree->layer[i];
+        const NNSG3dAnmObj* pAnmObj = pLayer->pAnmObj;
+        const NNSG3dJntAnmBatch* pBatch = pAnmObj->jntAnmBatch;
+        u32 numNode;
+
+        if (pLayer->weight <= 0)
+        {
+            continue;
+        }
+
+        // All the joints of the clip are decoded at once.
+        NNS_G3D_NULL_ASSERT(pBatch);
+        (void)NNS_G3dJntAnmBatchCalc(pAnmObj->jntAnmBatch, pAnmObj);
+
+        numNode = MATH_MIN(pTree->numNode, pAnmObj->numMapData);
+        for (n = 0; n < numNode; ++n)
+        {
+            NNSG3dJntBlendPose clip;
+            u32 dataIdx = pAnmObj->mapData[n];
+
+            if ((dataIdx & (NNS_G3D_ANMOBJ_MAPDATA_EXIST |
+                            NNS_G3D_ANMOBJ_MAPDATA_DISABLED)) !=
+                    NNS_G3D_ANMOBJ_MAPDATA_EXIST)
+            {
+                continue;
+            }
+            if (pLayer->pMask && !NNSi_G3dBitVecCheck(pLayer->pMask, n))
+            {
+                continue;
+            }
+
+            dataIdx &= NNS_G3D_ANMOBJ_MAPDATA_DATAFIELD;
+            NNS_G3D_ASSERT(dataIdx < pBatch->numResult);
+            getClipPose_(&clip, &pBatch->pResult[dataIdx], &pTree->pRest[n]);
+
+            if (pLayer->mode == NNS_G3D_JNTBLEND_ADDITIVE)
+            {
+                blendAdditive_(&pTree->pPose[n], &clip, &pTree->pRest[n], pLayer->weight);
+            }
+            else
+            {
+                blendLerp_(&pTree->pPose[n], &clip, pLayer->weight);
+            }
+            ++numEval;
+        }
+    }
+
+    // The reciprocals of the scales are calculated only once for the blended pose.
+    for (n = 0; n < pTree->numNode; ++n)
+    {
+        NNSG3dJntBlendPose* pPose = &pTree->pPose[n];
+        if (!(pPose->flag & NNS_G3D_JNTANM_RESULTFLAG_SCALE_ONE))
+        {
+            pPose->s_invs[3] = FX_Inv(pPose->s_invs[0]);
+            pPose->s_invs[4] = FX_Inv(pPose->s_invs[1]);
+            pPose->s_invs[5] = FX_Inv(pPose->s_invs[2]);
+        }
+    }
+
+    ++pTree->revision;
+    pTree->numEval  = numEval;
+    pTree->tickCalc = OS_GetTick() - t;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dJntBlendMaskAddSubtree
+
+    Sets in pMask (NNS_G3D_SIZE_JNT_MAX bits) the bits of nodeID and all its descendants.
+    The parents must be described before their children in the SBC of the model,
+    which is the case for the output of the converter.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dJntBlendMaskAddSubtree(u32* pMask, const NNSG3dResMdl* pResMdl, u32 nodeID)
+{
+    u32 subtree[NNS_G3D_SIZE_JNT_MAX / 32];
+    const u8* c;
+    u32 i;
+
+    NNS_G3D_NULL_ASSERT(pMask);
+    NNS_G3D_NULL_ASSERT(pResMdl);
+    NNS_G3D_ASSERT(nodeID < pResMdl->info.numNode);
+
+    MI_CpuClear32(&subtree[0], sizeof(subtree));
+    NNSi_G3dBitVecSet(&subtree[0], nodeID);
+
+    c = NNS_G3dGetSbc(pResMdl);
+    while((c = NNS_G3dSearchSbcCmd(c, NNS_G3D_SBC_NODEDESC)) != NULL)
+    {
+        u32 idxNode   = *(c + 1);
+        u32 idxParent = *(c + 2);
+
+        if (idxNode != idxParent && NNSi_G3dBitVecCheck(&subtree[0], idxParent))
+        {
+            NNSi_G3dBitVecSet(&subtree[0], idxNode);
+        }
+        c += NNS_G3dGetSbcCmdLen(c);
+    }
+
+    for (i = 0; i < NNS_G3D_SIZE_JNT_MAX / 32; ++i)
+    {
+        pMask[i] |= subtree[i];
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNSi_G3dAnmCalcJntBlendTree
+
+    Joint animation calculation function of the animation object of NNSG3dJntBlendTree.
+    Builds the result from the blended pose. The matrix is built here only once per joint,
+    and the scale compensation of the CG tool is applied to the blended scale.
+
+    pResult: stores the result of the joint animation
+    pAnmObj:
+    dataIdx: node ID
+ *---------------------------------------------------------------------------*/
+void
+NNSi_G3dAnmCalcJntBlendTree(NNSG3dJntAnmResult* pResult,
+                            const NNSG3dAnmObj* pAnmObj,
+                            u32 dataIdx)
+{
+    const NNSG3dJntBlendTree* pTree;
+    const NNSG3dJntBlendPose* pPose;
+
+    NNS_G3D_NULL_ASSERT(pResult);
+    NNS_G3D_NULL_ASSERT(pAnmObj);
+    NNS_G3D_NULL_ASSERT(NNS_G3dRS);
+
+    pTree = (const NNSG3dJntBlendTree*)pAnmObj->resAnm;
+    NNS_G3D_ASSERT(dataIdx < pTree->numNode);
+    pPose = &pTree->pPose[dataIdx];
+
+    pResult->flag = (NNSG3dJntAnmResultFlag)(pPose->flag &
+                                             (NNS_G3D_JNTANM_RESULTFLAG_TRANS_ZERO |
+                                              NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO));
+
+    if (!(pPose->flag & NNS_G3D_JNTANM_RESULTFLAG_TRANS_ZERO))
+    {
+        pResult->trans = pPose->trans;
+    }
+
+    if (!(pPose->flag & NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO))
+    {
+        mtxFromQuat_(&pResult->rot, &pPose->quat[0]);
+    }
+
+    (*NNS_G3dRS->funcJntScale)(
+        pResult,
+        &pPose->s_invs[0],
+        NNS_G3dRS->c,
+        ((pPose->flag & NNS_G3D_JNTANM_RESULTFLAG_SCALE_ONE) ?
+                (u32)NNS_G3D_SRTFLAG_SCALE_ONE :
+                0)
+    );
+}
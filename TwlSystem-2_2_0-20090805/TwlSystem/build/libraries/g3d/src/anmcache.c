@@ -0,0 +1,334 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - libraries - g3d
+  File:     anmcache.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#include <nnsys/g3d/anmcache.h>
+#include <nnsys/g3d/anmblend.h>
+#include <nnsys/g3d/sbc.h>
+
+
+/*---------------------------------------------------------------------------*
+    getAnmRevision_
+
+    Returns the revision of the results of the animation object.
+    Only the pose of a joint blend tree changes without its frame.
+ *---------------------------------------------------------------------------*/
+static u32
+getAnmRevision_(const NNSG3dAnmObj* pAnmObj)
+{
+    const NNSG3dResAnmHeader* pHeader = (const NNSG3dResAnmHeader*)pAnmObj->resAnm;
+
+    if (pHeader->category1 == NNS_G3D_JNTBLENDTREE_CATEGORY1)
+    {
+        return ((const NNSG3dJntBlendTree*)pAnmObj->resAnm)->revision;
+    }
+    return 0;
+}
+
+
+/*---------------------------------------------------------------------------*
+    makeKey_
+
+    Creates the key of pRenderObj in pKey.
+    Returns FALSE when the render object cannot use the cache.
+ *---------------------------------------------------------------------------*/
+static BOOL
+makeKey_(NNSG3dJntAnmCacheKey* pKey, const NNSG3dRenderObj* pRenderObj)
+{
+    const NNSG3dAnmObj* p;
+    u32 n = 0;
+
+    // Clear so that the unused elements also match when comparing.
+    MI_CpuClearFast(pKey, sizeof(NNSG3dJntAnmCacheKey));
+
+    pKey->resMdl       = pRenderObj->resMdl;
+    pKey->funcBlendJnt = pRenderObj->funcBlendJnt;
+
+    for (p = pRenderObj->anmJnt; p; p = p->next)
+    {
+        if (n >= NNS_G3D_JNTANMCACHE_MAX_ANM)
+        {
+            return FALSE;
+        }
+        pKey->anm[n].resAnm  = p->resAnm;
+        pKey->anm[n].funcAnm = p->funcAnm;
+        pKey->anm[n].frame   = p->frame;
+        pKey->anm[n].ratio   = p->ratio;
+        pKey->anm[n].revision = getAnmRevision_(p);
+        ++n;
+    }
+    pKey->numAnm = n;
+
+    return TRUE;
+}
+
+
+/*---------------------------------------------------------------------------*
+    hashKey_
+
+    Returns the hash value of pKey (FNV-1).
+ *---------------------------------------------------------------------------*/
+static u32
+hashKey_(const NNSG3dJntAnmCacheKey* pKey)
+{
+    const u32* p = (const u32*)pKey;
+    u32 h = 2166136261U;
+    u32 i;
+
+    for (i = 0; i < sizeof(NNSG3dJntAnmCacheKey) / sizeof(u32); ++i)
+    {
+        h = (h * 16777619U) ^ p[i];
+    }
+    return h;
+}
+
+
+/*---------------------------------------------------------------------------*
+    isSameKey_
+
+    Returns TRUE when both keys are identical.
+ *---------------------------------------------------------------------------*/
+static BOOL
+isSameKey_(const NNSG3dJntAnmCacheKey* pKey0, const NNSG3dJntAnmCacheKey* pKey1)
+{
+    const u32* p0 = (const u32*)pKey0;
+    const u32* p1 = (const u32*)pKey1;
+    u32 i;
+
+    for (i = 0; i < sizeof(NNSG3dJntAnmCacheKey) / sizeof(u32); ++i)
+    {
+        if (p0[i] != p1[i])
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dJntAnmCacheInit
+
+    Initializes NNSG3dJntAnmCache.
+    pBuf is the region of NNS_G3D_JNTANMCACHE_BUFFER_SIZE(numEntry, maxJnt) bytes used by the cache.
+    numEntry is the number of keys that can be held at the same time,
+    and maxJnt is the maximum number of joints of the models drawn through the cache.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dJntAnmCacheInit(NNSG3dJntAnmCache* pCache,
+                       void* pBuf,
+                       u32 numEntry,
+                       u32 maxJnt)
+{
+    NNSG3dJntAnmResult* pResult;
+    u32 i;
+
+    NNS_G3D_NULL_ASSERT(pCache);
+    NNS_G3D_NULL_ASSERT(pBuf);
+    NNS_G3D_ASSERT(numEntry > 0);
+    NNS_G3D_ASSERT(maxJnt <= NNS_G3D_SIZE_JNT_MAX);
+
+    pCache->pEntry   = (NNSG3dJntAnmCacheEntry*)pBuf;
+    pCache->numEntry = numEntry;
+    pCache->maxJnt   = maxJnt;
+
+    // The results are placed after the array of entries.
+    pResult = (NNSG3dJntAnmResult*)&pCache->pEntry[numEntry];
+    for (i = 0; i < numEntry; ++i)
+    {
+        pCache->pEntry[i].pResult = pResult;
+        pResult += maxJnt;
+    }
+
+    NNS_G3dJntAnmCacheClear(pCache);
+    NNS_G3dJntAnmCacheResetStats(pCache);
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dJntAnmCacheClear
+
+    Discards all the results held by the cache.
+    Call this after rewriting the model or animation resources.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dJntAnmCacheClear(NNSG3dJntAnmCache* pCache)
+{
+    u32 i;
+    NNS_G3D_NULL_ASSERT(pCache);
+
+    for (i = 0; i < pCache->numEntry; ++i)
+    {
+        pCache->pEntry[i].key.resMdl = NULL;
+        pCache->pEntry[i].stamp = 0;
+    }
+    pCache->stamp = 0;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dJntAnmCacheDraw
+
+    Draws pRenderObj with NNS_G3dDraw, using the cache for the joint calculation results.
+    When the results of the same key are in the cache, they are played back instead of being calculated.
+    Otherwise, they are calculated and recorded in the least recently used entry.
+    Returns TRUE when the results were played back.
+
+    recJntAnm and NNS_G3D_RENDEROBJ_FLAG_RECORD of pRenderObj are restored after drawing.
+    Do not set recMatAnm on render objects drawn through the cache.
+ *---------------------------------------------------------------------------*/
+BOOL
+NNS_G3dJntAnmCacheDraw(NNSG3dJntAnmCache* pCache,
+                       NNSG3dRenderObj* pRenderObj)
+{
+    NNSG3dJntAnmCacheKey    key;
+    NNSG3dJntAnmCacheEntry* pEntry;
+    NNSG3dJntAnmResult*     recJntAnm;
+    u32                     flagRecord;
+    u32                     hash;
+    BOOL                    isHit;
+    u32                     i;
+
+    NNS_G3D_NULL_ASSERT(pCache);
+    NNS_G3D_NULL_ASSERT(pRenderObj);
+    NNS_G3D_NULL_ASSERT(pRenderObj->resMdl);
+
+    if (pRenderObj->resMdl->info.numNode > pCache->maxJnt ||
+        !makeKey_(&key, pRenderObj))
+    {
+        ++pCache->numBypass;
+        NNS_G3dDraw(pRenderObj);
+        return FALSE;
+    }
+
+    hash = hashKey_(&key);
+    pEntry = NULL;
+    isHit = FALSE;
+
+    for (i = 0; i < pCache->numEntry; ++i)
+    {
+        NNSG3dJntAnmCacheEntry* p = &pCache->pEntry[i];
+
+        if (p->hash == hash && p->key.resMdl && isSameKey_(&p->key, &key))
+        {
+            pEntry = p;
+            isHit = TRUE;
+            break;
+        }
+
+        // Use an unused entry or the least recently used entry for the results.
+        if (!pEntry || (pEntry->key.resMdl && (!p->key.resMdl || p->stamp < pEntry->stamp)))
+        {
+            pEntry = p;
+        }
+    }
+
+    if (!isHit)
+    {
+        if (pEntry->key.resMdl)
+        {
+            ++pCache->numEvict;
+        }
+        pEntry->key  = key;
+        pEntry->hash = hash;
+    }
+    pEntry->stamp = ++pCache->stamp;
+
+    recJntAnm  = pRenderObj->recJntAnm;
+    flagRecord = pRenderObj->flag & NNS_G3D_RENDEROBJ_FLAG_RECORD;
+
+    pRenderObj->recJntAnm = pEntry->pResult;
+    if (isHit)
+    {
+        // play back the results in the cache
+        ++pCache->numHit;
+        pRenderObj->flag &= ~NNS_G3D_RENDEROBJ_FLAG_RECORD;
+    }
+    else
+    {
+        // record the results in the cache
+        ++pCache->numMiss;
+        pRenderObj->flag |= NNS_G3D_RENDEROBJ_FLAG_RECORD;
+    }
+
+    NNS_G3dDraw(pRenderObj);
+
+    pRenderObj->recJntAnm = recJntAnm;
+    pRenderObj->flag = (pRenderObj->flag & ~NNS_G3D_RENDEROBJ_FLAG_RECORD) | flagRecord;
+
+    return isHit;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dJntAnmCacheResetStats
+
+    Resets the statistics of the cache.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dJntAnmCacheResetStats(NNSG3dJntAnmCache* pCache)
+{
+    NNS_G3D_NULL_ASSERT(pCache);
+
+    pCache->numHit    = 0;
+    pCache->numMiss   = 0;
+    pCache->numBypass = 0;
+    pCache->numEvict  = 0;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dJntAnmCacheGetHitRate
+
+    Returns the percentage of the draws that played back the results.
+ *---------------------------------------------------------------------------*/
+u32
+NNS_G3dJntAnmCacheGetHitRate(const NNSG3dJntAnmCache* pCache)
+{
+    u32 total;
+    NNS_G3D_NULL_ASSERT(pCache);
+
+    total = pCache->numHit + pCache->numMiss + pCache->numBypass;
+    if (total == 0)
+    {
+        return 0;
+    }
+    return pCache->numHit * 100 / total;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dJntAnmCacheGetUsedSize
+
+    Returns the size in bytes of the results currently held by the cache.
+    The whole region used by the cache is NNS_G3D_JNTANMCACHE_BUFFER_SIZE(numEntry, maxJnt) bytes.
+ *---------------------------------------------------------------------------*/
+u32
+NNS_G3dJntAnmCacheGetUsedSize(const NNSG3dJntAnmCache* pCache)
+{
+    u32 size = 0;
+    u32 i;
+    NNS_G3D_NULL_ASSERT(pCache);
+
+    for (i = 0; i < pCache->numEntry; ++i)
+    {
+        const NNSG3dResMdl* resMdl = pCache->pEntry[i].key.resMdl;
+        if (resMdl)
+        {
+            size += sizeof(NNSG3dJntAnmCacheEntry) +
+                    sizeof(NNSG3dJntAnmResult) * resMdl->info.numNode;
+        }
+    }
+    return size;
+}
@@ -0,0 +1,404 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - libraries - g3d - src - binres
+  File:     res_name_index.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#include <nnsys/g3d/binres/res_name_index.h>
+#include <nnsys/g3d/binres/res_struct_accessor.h>
+
+// Index part of NNSG3dResNameIndexEntry::hashIdx of the entry that marks an indexed dictionary.
+// The index of a dictionary entry is 254 at most.
+#define NNS_G3D_RESNAMEINDEX_IDX_DICT 0xff
+#define NNS_G3D_RESNAMEINDEX_IDX_MASK 0xff
+
+NNSG3dResNameIndex* NNSi_G3dResNameIndexList = NULL;
+
+typedef void (*NNSi_G3dResNameIndexDictFunc)(NNSG3dResNameIndex*, const NNSG3dResDict*);
+
+
+/*---------------------------------------------------------------------------*
+    hash_
+
+    Returns the hash value of the name in the dictionary.
+    When name is NULL, returns the hash value of the dictionary itself.
+ *---------------------------------------------------------------------------*/
+static u32
+hash_(const NNSG3dResDict* dict, const NNSG3dResName* name)
+{
+    u32 h = 2166136261U;
+
+    h = (h * 16777619U) ^ (u32)dict;
+    if (name)
+    {
+        h = (h * 16777619U) ^ name->val[0];
+        h = (h * 16777619U) ^ name->val[1];
+        h = (h * 16777619U) ^ name->val[2];
+        h = (h * 16777619U) ^ name->val[3];
+    }
+
+    // The slot is taken from the upper bits, so mix the lower bits into them.
+    h ^= h >> 13;
+    h *= 0x5bd1e995;
+    h ^= h >> 15;
+    return h;
+}
+
+
+/*---------------------------------------------------------------------------*
+    insert_
+
+    Puts dict and hashIdx in an empty slot.
+ *---------------------------------------------------------------------------*/
+static void
+insert_(NNSG3dResNameIndex* pIndex, const NNSG3dResDict* dict, u32 hashIdx)
+{
+    u32 slot = (hashIdx >> 8) & pIndex->mask;
+
+    while(pIndex->pEntry[slot].dict)
+    {
+        slot = (slot + 1) & pIndex->mask;
+    }
+    pIndex->pEntry[slot].dict    = dict;
+    pIndex->pEntry[slot].hashIdx = hashIdx;
+    ++pIndex->numUsed;
+}
+
+
+/*---------------------------------------------------------------------------*
+    countDict_
+
+    Counts the slots used by dict.
+ *---------------------------------------------------------------------------*/
+static void
+countDict_(NNSG3dResNameIndex* pIndex, const NNSG3dResDict* dict)
+{
+    if (dict->numEntry >= NNS_G3D_RESNAMEINDEX_MIN_ENTRY)
+    {
+        // The names and the entry that marks the dictionary as indexed
+        pIndex->numUsed += dict->numEntry + 1U;
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    addDict_
+
+    Puts all the names of dict in the hash table.
+    When the hash table does not have enough room, dict is not indexed
+    and it is searched as usual.
+ *---------------------------------------------------------------------------*/
+static void
+addDict_(NNSG3dResNameIndex* pIndex, const NNSG3dResDict* dict)
+{
+    u32 idx;
+
+    if (dict->numEntry < NNS_G3D_RESNAMEINDEX_MIN_ENTRY)
+        return;
+
+    // Always leave an empty slot so that probing terminates.
+    if (pIndex->numUsed + dict->numEntry + 1 >= pIndex->mask + 1)
+        return;
+
+    for (idx = 0; idx < dict->numEntry; ++idx)
+    {
+        u32 h = hash_(dict, NNS_G3dGetResNameByIdx(dict, idx));
+        insert_(pIndex, dict, (h & ~NNS_G3D_RESNAMEINDEX_IDX_MASK) | idx);
+    }
+
+    insert_(pIndex, dict,
+            (hash_(dict, NULL) & ~NNS_G3D_RESNAMEINDEX_IDX_MASK) | NNS_G3D_RESNAMEINDEX_IDX_DICT);
+}
+
+
+/*---------------------------------------------------------------------------*
+    forEachDict_
+
+    Calls func for each dictionary in the resource file.
+    Blocks of unknown kinds are skipped.
+ *---------------------------------------------------------------------------*/
+static void
+forEachDict_(const NNSG3dResFileHeader* pResFile,
+             NNSi_G3dResNameIndexDictFunc func,
+             NNSG3dResNameIndex* pIndex)
+{
+    u32 i, j;
+
+    for (i = 0; i < pResFile->dataBlocks; ++i)
+    {
+        const NNSG3dResDataBlockHeader* blk = NNS_G3dGetDataBlockHeaderByIdx(pResFile, i);
+
+        switch(blk->kind)
+        {
+        case NNS_G3D_DATABLK_MDLSET:
+            {
+                const NNSG3dResMdlSet* mdlSet = (const NNSG3dResMdlSet*)blk;
+
+                (*func)(pIndex, &mdlSet->dict);
+                for (j = 0; j < mdlSet->dict.numEntry; ++j)
+                {
+                    const NNSG3dResMdl* mdl = NNS_G3dGetMdlByIdx(mdlSet, j);
+                    const NNSG3dResMat* mat = NNS_G3dGetMat(mdl);
+
+                    (*func)(pIndex, &NNS_G3dGetNodeInfo(mdl)->dict);
+                    (*func)(pIndex, &mat->dict);
+                    (*func)(pIndex, (const NNSG3dResDict*)((u8*)mat + mat->ofsDictTexToMatList));
+                    (*func)(pIndex, (const NNSG3dResDict*)((u8*)mat + mat->ofsDictPlttToMatList));
+                    (*func)(pIndex, &NNS_G3dGetShp(mdl)->dict);
+                }
+            }
+            break;
+        case NNS_G3D_DATABLK_TEX:
+            {
+                const NNSG3dResTex* tex = (const NNSG3dResTex*)blk;
+
+                (*func)(pIndex, &tex->dict);
+                if (tex->plttInfo.ofsDict != 0)
+                {
+                    (*func)(pIndex, (const NNSG3dResDict*)((u8*)tex + tex->plttInfo.ofsDict));
+                }
+            }
+            break;
+        case NNS_G3D_DATABLK_JNT_ANM:
+        case NNS_G3D_DATABLK_VIS_ANM:
+        case NNS_G3D_DATABLK_MATC_ANM:
+        case NNS_G3D_DATABLK_TEXPAT_ANM:
+        case NNS_G3D_DATABLK_TEXSRT_ANM:
+            {
+                const NNSG3dResAnmSet* anmSet = (const NNSG3dResAnmSet*)blk;
+
+                (*func)(pIndex, &anmSet->dict);
+                for (j = 0; j < anmSet->dict.numEntry; ++j)
+                {
+                    const NNSG3dResDictAnmSetData* data =
+                        (const NNSG3dResDictAnmSetData*)NNS_G3dGetResDataByIdx(&anmSet->dict, j);
+                    const NNSG3dResAnmHeader* hdr =
+                        (const NNSG3dResAnmHeader*)((u8*)anmSet + data->offset);
+
+                    // The joint and visibility animations do not have a dictionary.
+                    if (hdr->category1 == 'MA')
+                    {
+                        (*func)(pIndex, &((const NNSG3dResMatCAnm*)hdr)->dict);
+                    }
+                    else if (hdr->category1 == 'TP')
+                    {
+                        (*func)(pIndex, &((const NNSG3dResTexPatAnm*)hdr)->dict);
+                    }
+                    else if (hdr->category1 == 'TA')
+                    {
+                        (*func)(pIndex, &((const NNSG3dResTexSRTAnm*)hdr)->dict);
+                    }
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dResNameIndexGetBufferSize
+
+    Returns the size of the region that NNS_G3dResNameIndexInit needs for pResFile.
+    The hash table is made at most half full.
+ *---------------------------------------------------------------------------*/
+u32
+NNS_G3dResNameIndexGetBufferSize(const NNSG3dResFileHeader* pResFile)
+{
+    NNSG3dResNameIndex tmp;
+    u32 numSlot;
+
+    NNS_G3D_NULL_ASSERT(pResFile);
+
+    tmp.numUsed = 0;
+    forEachDict_(pResFile, &countDict_, &tmp);
+
+    if (tmp.numUsed == 0)
+        return 0;
+
+    numSlot = 1;
+    while(numSlot < tmp.numUsed * 2)
+    {
+        numSlot <<= 1;
+    }
+    return numSlot * sizeof(NNSG3dResNameIndexEntry);
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dResNameIndexInit
+
+    Builds the hash table of the dictionaries of pResFile in pBuf (szBuf bytes).
+    The size returned by NNS_G3dResNameIndexGetBufferSize is enough for all the dictionaries.
+    With a smaller region, the dictionaries that do not fit are searched as usual.
+
+    The index is not used until it is registered with NNS_G3dResNameIndexRegister.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dResNameIndexInit(NNSG3dResNameIndex* pIndex,
+                        void* pBuf,
+                        u32 szBuf,
+                        const NNSG3dResFileHeader* pResFile)
+{
+    u32 numSlot;
+
+    NNS_G3D_NULL_ASSERT(pIndex);
+    NNS_G3D_NULL_ASSERT(pResFile);
+    NNS_G3D_ASSERT(pBuf || szBuf == 0);
+
+    pIndex->next      = NULL;
+    pIndex->pBegin    = (const u8*)pResFile;
+    pIndex->pEnd      = (const u8*)pResFile + pResFile->fileSize;
+    pIndex->numUsed   = 0;
+    pIndex->numLookup = 0;
+    pIndex->numProbe  = 0;
+
+    // The number of slots is a power of two.
+    numSlot = 1;
+    while(numSlot * 2 * sizeof(NNSG3dResNameIndexEntry) <= szBuf)
+    {
+        numSlot <<= 1;
+    }
+
+    if (numSlot * sizeof(NNSG3dResNameIndexEntry) > szBuf)
+    {
+        pIndex->pEntry = NULL;
+        pIndex->mask   = 0;
+        return;
+    }
+
+    pIndex->pEntry = (NNSG3dResNameIndexEntry*)pBuf;
+    pIndex->mask   = numSlot - 1;
+    MI_CpuClearFast(pBuf, numSlot * sizeof(NNSG3dResNameIndexEntry));
+
+    forEachDict_(pResFile, &addDict_, pIndex);
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dResNameIndexRegister
+
+    Makes the dictionary lookups of the resource file use pIndex.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dResNameIndexRegister(NNSG3dResNameIndex* pIndex)
+{
+    NNS_G3D_NULL_ASSERT(pIndex);
+#ifdef SDK_DEBUG
+    {
+        const NNSG3dResNameIndex* p;
+        for (p = NNSi_G3dResNameIndexList; p; p = p->next)
+        {
+            NNS_G3D_ASSERTMSG(p != pIndex, "already registered");
+        }
+    }
+#endif
+
+    pIndex->next = NNSi_G3dResNameIndexList;
+    NNSi_G3dResNameIndexList = pIndex;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dResNameIndexUnregister
+
+    Stops using pIndex for the dictionary lookups.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dResNameIndexUnregister(NNSG3dResNameIndex* pIndex)
+{
+    NNSG3dResNameIndex** pp;
+    NNS_G3D_NULL_ASSERT(pIndex);
+
+    for (pp = &NNSi_G3dResNameIndexList; *pp; pp = &(*pp)->next)
+    {
+        if (*pp == pIndex)
+        {
+            *pp = pIndex->next;
+            pIndex->next = NULL;
+            return;
+        }
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNSi_G3dResNameIndexFind
+
+    Looks up name in dict with the registered indices.
+    Returns FALSE when dict is not indexed, and the caller must search the dictionary itself.
+    Otherwise, returns TRUE and stores the index of name (-1 if not found) in *pIdx.
+ *---------------------------------------------------------------------------*/
+BOOL
+NNSi_G3dResNameIndexFind(const NNSG3dResDict* dict,
+                         const NNSG3dResName* name,
+                         int* pIdx)
+{
+    NNSG3dResNameIndex* pIndex;
+    const NNSG3dResNameIndexEntry* e;
+    u32 h, slot;
+
+    if (dict->numEntry < NNS_G3D_RESNAMEINDEX_MIN_ENTRY)
+        return FALSE;
+
+    for (pIndex = NNSi_G3dResNameIndexList; pIndex; pIndex = pIndex->next)
+    {
+        if ((const u8*)dict >= pIndex->pBegin && (const u8*)dict < pIndex->pEnd)
+            break;
+    }
+
+    if (!pIndex || !pIndex->pEntry)
+        return FALSE;
+
+    ++pIndex->numLookup;
+
+    h = hash_(dict, name);
+    slot = (h >> 8) & pIndex->mask;
+    while((e = &pIndex->pEntry[slot])->dict != NULL)
+    {
+        ++pIndex->numProbe;
+        if (e->dict == dict &&
+            ((e->hashIdx ^ h) & ~NNS_G3D_RESNAMEINDEX_IDX_MASK) == 0 &&
+            (e->hashIdx & NNS_G3D_RESNAMEINDEX_IDX_MASK) != NNS_G3D_RESNAMEINDEX_IDX_DICT)
+        {
+            u32 idx = e->hashIdx & NNS_G3D_RESNAMEINDEX_IDX_MASK;
+            const NNSG3dResName* n = NNS_G3dGetResNameByIdx(dict, idx);
+
+            // The hash values can collide.
+            if (n->val[0] == name->val[0] &&
+                n->val[1] == name->val[1] &&
+                n->val[2] == name->val[2] &&
+                n->val[3] == name->val[3])
+            {
+                *pIdx = (int)idx;
+                return TRUE;
+            }
+        }
+        slot = (slot + 1) & pIndex->mask;
+    }
+
+    // Not found. It is only certain when the dictionary is in the hash table.
+    h = (hash_(dict, NULL) & ~NNS_G3D_RESNAMEINDEX_IDX_MASK) | NNS_G3D_RESNAMEINDEX_IDX_DICT;
+    slot = (h >> 8) & pIndex->mask;
+    while((e = &pIndex->pEntry[slot])->dict != NULL)
+    {
+        if (e->dict == dict && e->hashIdx == h)
+        {
+            *pIdx = -1;
+            return TRUE;
+        }
+        slot = (slot + 1) & pIndex->mask;
+    }
+    return FALSE;
+}
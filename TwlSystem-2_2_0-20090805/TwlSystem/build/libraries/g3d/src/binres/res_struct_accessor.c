@@ -41,6 +41,16 @@ NNS_G3dGetResDataByName(const NNSG3dResDict* dict, const NNSG3dResName* name)
     if (!name)
         return NULL;
 
+    if (NNSi_G3dResNameIndexList)
+    {
+        // Use the hash table when the dictionary is indexed.
+        int idx;
+        if (NNSi_G3dResNameIndexFind(dict, name, &idx))
+        {
+            return (idx >= 0) ? NNS_G3dGetResDataByIdx(dict, (u32)idx) : NULL;
+        }
+    }
+
     if (dict->numEntry < 16)
     {
         u32 idx;
@@ -112,6 +122,16 @@ NNS_G3dGetResDictIdxByName(const NNSG3dResDict* dict, const NNSG3dResName* name)
     if (!name)
         return -1;
 
+    if (NNSi_G3dResNameIndexList)
+    {
+        // Use the hash table when the dictionary is indexed.
+        int idx;
+        if (NNSi_G3dResNameIndexFind(dict, name, &idx))
+        {
+            return idx;
+        }
+    }
+
     if (dict->numEntry < 16)
     {
         u32 idx;
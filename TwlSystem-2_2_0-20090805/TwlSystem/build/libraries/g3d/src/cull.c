@@ -0,0 +1,503 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - libraries - g3d
+  File:     cull.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#include <nnsys/g3d/cull.h>
+#include <nnsys/g3d/glbstate.h>
+
+
+/*---------------------------------------------------------------------------*
+    setPlane_
+
+    Normalizes the plane a*x + b*y + c*z + d >= 0 and sets it in the idx-th plane.
+ *---------------------------------------------------------------------------*/
+static void
+setPlane_(NNSG3dCuller* pCuller, int idx, fx32 a, fx32 b, fx32 c, fx32 d)
+{
+    VecFx32* n = &pCuller->planeN[idx];
+    fx32 len;
+
+    n->x = a;
+    n->y = b;
+    n->z = c;
+    len = VEC_Mag(n);
+
+    if (len == 0)
+    {
+        // Degenerate plane. Nothing is outside of it.
+        n->x = n->y = n->z = 0;
+        pCuller->planeD[idx] = FX32_MAX;
+        return;
+    }
+
+    n->x = FX_Div(a, len);
+    n->y = FX_Div(b, len);
+    n->z = FX_Div(c, len);
+    pCuller->planeD[idx] = FX_Div(d, len);
+}
+
+
+/*---------------------------------------------------------------------------*
+    projRadius_
+
+    Returns the radius of pBox projected on the normal n.
+ *---------------------------------------------------------------------------*/
+static fx32
+projRadius_(const VecFx32* n, const NNSG3dCullBox* pBox)
+{
+    fx32 r0 = VEC_DotProduct(n, &pBox->axis[0]);
+    fx32 r1 = VEC_DotProduct(n, &pBox->axis[1]);
+    fx32 r2 = VEC_DotProduct(n, &pBox->axis[2]);
+
+    return MATH_ABS(r0) + MATH_ABS(r1) + MATH_ABS(r2);
+}
+
+
+/*---------------------------------------------------------------------------*
+    testSphere_
+
+    Tests the sphere against the planes. Does not count the statistics.
+ *---------------------------------------------------------------------------*/
+static NNSG3dCullResult
+testSphere_(const NNSG3dCuller* pCuller, const NNSG3dCullSphere* pSphere)
+{
+    NNSG3dCullResult result = NNS_G3D_CULL_INSIDE;
+    int i;
+
+    for (i = 0; i < 6; ++i)
+    {
+        fx32 dist = VEC_DotProduct(&pCuller->planeN[i], &pSphere->center) + pCuller->planeD[i];
+
+        if (dist < -pSphere->radius)
+        {
+            return NNS_G3D_CULL_OUTSIDE;
+        }
+        if (dist < pSphere->radius)
+        {
+            result = NNS_G3D_CULL_INTERSECT;
+        }
+    }
+    return result;
+}
+
+
+/*---------------------------------------------------------------------------*
+    testBox_
+
+    Tests the box against the planes. Does not count the statistics.
+ *---------------------------------------------------------------------------*/
+static NNSG3dCullResult
+testBox_(const NNSG3dCuller* pCuller, const NNSG3dCullBox* pBox)
+{
+    NNSG3dCullResult result = NNS_G3D_CULL_INSIDE;
+    int i;
+
+    for (i = 0; i < 6; ++i)
+    {
+        fx32 dist = VEC_DotProduct(&pCuller->planeN[i], &pBox->center) + pCuller->planeD[i];
+        fx32 r    = projRadius_(&pCuller->planeN[i], pBox);
+
+        if (dist < -r)
+        {
+            return NNS_G3D_CULL_OUTSIDE;
+        }
+        if (dist < r)
+        {
+            result = NNS_G3D_CULL_INTERSECT;
+        }
+    }
+    return result;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dCullerInit
+
+    Initializes the culler. All the planes are degenerate until
+    NNS_G3dCullerSetFrustum is called, so nothing is culled.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dCullerInit(NNSG3dCuller* pCuller)
+{
+    int i;
+    NNS_G3D_NULL_ASSERT(pCuller);
+
+    MI_CpuClear32(pCuller, sizeof(NNSG3dCuller));
+    for (i = 0; i < 6; ++i)
+    {
+        pCuller->planeD[i] = FX32_MAX;
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dCullerSetFrustum
+
+    Calculates the planes of the view volume from the camera matrix and
+    the projection matrix of NNS_G3dGlb.
+    Call it after the camera and the projection of the frame are set.
+
+    With row vectors, the clip coordinates are v * C * P, and a point is inside when
+    -w <= x, y, z <= w. Each plane is a sum of two columns of C * P.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dCullerSetFrustum(NNSG3dCuller* pCuller)
+{
+    MtxFx44 c;
+    MtxFx44 vp;
+    int i;
+    NNS_G3D_NULL_ASSERT(pCuller);
+
+    MTX_Copy43To44(&NNS_G3dGlb.cameraMtx, &c);
+    MTX_Concat44(&c, &NNS_G3dGlb.projMtx, &vp);
+
+    for (i = 0; i < 3; ++i)
+    {
+        // w + x >= 0 (left), w - x >= 0 (right) and the same for y and z
+        setPlane_(pCuller, i * 2,
+                  vp.m[0][3] + vp.m[0][i],
+                  vp.m[1][3] + vp.m[1][i],
+                  vp.m[2][3] + vp.m[2][i],
+                  vp.m[3][3] + vp.m[3][i]);
+        setPlane_(pCuller, i * 2 + 1,
+                  vp.m[0][3] - vp.m[0][i],
+                  vp.m[1][3] - vp.m[1][i],
+                  vp.m[2][3] - vp.m[2][i],
+                  vp.m[3][3] - vp.m[3][i]);
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dCullerResetStats
+
+    Clears the statistics of the culler.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dCullerResetStats(NNSG3dCuller* pCuller)
+{
+    NNS_G3D_NULL_ASSERT(pCuller);
+
+    pCuller->numTest       = 0;
+    pCuller->numCulled     = 0;
+    pCuller->numDrawn      = 0;
+    pCuller->numNodeCulled = 0;
+    pCuller->tickTest      = 0;
+    pCuller->tickDraw      = 0;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dCullerGetSavedTick
+
+    Returns the estimate of the CPU time saved by NNS_G3dCullerDraw:
+    the average time of the drawn models multiplied by the number of culled models,
+    minus the time taken by the tests.
+ *---------------------------------------------------------------------------*/
+OSTick
+NNS_G3dCullerGetSavedTick(const NNSG3dCuller* pCuller)
+{
+    OSTick saved;
+    NNS_G3D_NULL_ASSERT(pCuller);
+
+    if (pCuller->numDrawn == 0)
+    {
+        return 0;
+    }
+
+    saved = pCuller->tickDraw * pCuller->numCulled / pCuller->numDrawn;
+    return (saved > pCuller->tickTest) ? saved - pCuller->tickTest : 0;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dCullGetMdlBox
+
+    Sets in pBox the bounding box of the model in world coordinates,
+    transformed by the base matrix (scale, rotation and translation) of NNS_G3dGlb.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dCullGetMdlBox(NNSG3dCullBox* pBox, const NNSG3dResMdl* pResMdl)
+{
+    const NNSG3dResMdlInfo* info;
+    const MtxFx33* rot = &NNS_G3dGlb.prmBaseRot;
+    const VecFx32* scale = &NNS_G3dGlb.prmBaseScale;
+    VecFx32 half;
+    VecFx32 center;
+
+    NNS_G3D_NULL_ASSERT(pBox);
+    NNS_G3D_NULL_ASSERT(pResMdl);
+
+    info = &pResMdl->info;
+
+    // Half edges and center in model coordinates (scaled by the base scale)
+    half.x = FX_Mul(FX_Mul(info->boxW, info->boxPosScale) >> 1, scale->x);
+    half.y = FX_Mul(FX_Mul(info->boxH, info->boxPosScale) >> 1, scale->y);
+    half.z = FX_Mul(FX_Mul(info->boxD, info->boxPosScale) >> 1, scale->z);
+    center.x = FX_Mul(FX_Mul(info->boxX, info->boxPosScale), scale->x) + half.x;
+    center.y = FX_Mul(FX_Mul(info->boxY, info->boxPosScale), scale->y) + half.y;
+    center.z = FX_Mul(FX_Mul(info->boxZ, info->boxPosScale), scale->z) + half.z;
+
+    MTX_MultVec33(&center, rot, &pBox->center);
+    VEC_Add(&pBox->center, &NNS_G3dGlb.prmBaseTrans, &pBox->center);
+
+    // The rows of the rotation are the axes of the model in world coordinates.
+    pBox->axis[0].x = FX_Mul(rot->_00, half.x);
+    pBox->axis[0].y = FX_Mul(rot->_01, half.x);
+    pBox->axis[0].z = FX_Mul(rot->_02, half.x);
+    pBox->axis[1].x = FX_Mul(rot->_10, half.y);
+    pBox->axis[1].y = FX_Mul(rot->_11, half.y);
+    pBox->axis[1].z = FX_Mul(rot->_12, half.y);
+    pBox->axis[2].x = FX_Mul(rot->_20, half.z);
+    pBox->axis[2].y = FX_Mul(rot->_21, half.z);
+    pBox->axis[2].z = FX_Mul(rot->_22, half.z);
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dCullGetSphere
+
+    Transforms the sphere pLocal in model coordinates to world coordinates
+    with the base matrix of NNS_G3dGlb.
+    The radius is scaled by the largest element of the base scale.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dCullGetSphere(NNSG3dCullSphere* pWorld, const NNSG3dCullSphere* pLocal)
+{
+    const VecFx32* scale = &NNS_G3dGlb.prmBaseScale;
+    VecFx32 tmp;
+    fx32 s;
+
+    NNS_G3D_NULL_ASSERT(pWorld);
+    NNS_G3D_NULL_ASSERT(pLocal);
+
+    tmp.x = FX_Mul(pLocal->center.x, scale->x);
+    tmp.y = FX_Mul(pLocal->center.y, scale->y);
+    tmp.z = FX_Mul(pLocal->center.z, scale->z);
+    MTX_MultVec33(&tmp, &NNS_G3dGlb.prmBaseRot, &pWorld->center);
+    VEC_Add(&pWorld->center, &NNS_G3dGlb.prmBaseTrans, &pWorld->center);
+
+    s = MATH_MAX(MATH_ABS(scale->x), MATH_ABS(scale->y));
+    s = MATH_MAX(s, MATH_ABS(scale->z));
+    pWorld->radius = FX_Mul(pLocal->radius, s);
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dCullerTestSphere
+
+    Tests the sphere in world coordinates against the view volume.
+ *---------------------------------------------------------------------------*/
+NNSG3dCullResult
+NNS_G3dCullerTestSphere(NNSG3dCuller* pCuller, const NNSG3dCullSphere* pSphere)
+{
+    NNSG3dCullResult result;
+    OSTick t;
+    NNS_G3D_NULL_ASSERT(pCuller);
+    NNS_G3D_NULL_ASSERT(pSphere);
+
+    t = OS_GetTick();
+    result = testSphere_(pCuller, pSphere);
+    pCuller->tickTest += OS_GetTick() - t;
+    ++pCuller->numTest;
+
+    return result;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dCullerTestBox
+
+    Tests the box in world coordinates against the view volume.
+ *---------------------------------------------------------------------------*/
+NNSG3dCullResult
+NNS_G3dCullerTestBox(NNSG3dCuller* pCuller, const NNSG3dCullBox* pBox)
+{
+    NNSG3dCullResult result;
+    OSTick t;
+    NNS_G3D_NULL_ASSERT(pCuller);
+    NNS_G3D_NULL_ASSERT(pBox);
+
+    t = OS_GetTick();
+    result = testBox_(pCuller, pBox);
+    pCuller->tickTest += OS_GetTick() - t;
+    ++pCuller->numTest;
+
+    return result;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dCullerTestMdl
+
+    Tests the bounding box of the model placed with the base matrix of NNS_G3dGlb.
+    Call it before NNS_G3dGlbFlushP etc. so that the flush can also be skipped
+    when the model is outside.
+ *---------------------------------------------------------------------------*/
+NNSG3dCullResult
+NNS_G3dCullerTestMdl(NNSG3dCuller* pCuller, const NNSG3dResMdl* pResMdl)
+{
+    NNSG3dCullBox box;
+    NNSG3dCullResult result;
+    OSTick t;
+    NNS_G3D_NULL_ASSERT(pCuller);
+    NNS_G3D_NULL_ASSERT(pResMdl);
+
+    t = OS_GetTick();
+    NNS_G3dCullGetMdlBox(&box, pResMdl);
+    result = testBox_(pCuller, &box);
+    pCuller->tickTest += OS_GetTick() - t;
+    ++pCuller->numTest;
+
+    return result;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dCullerTestSphereArray
+
+    Tests num spheres in world coordinates and stores the results (NNSG3dCullResult) in pResult.
+    Returns the number of spheres that are not outside.
+ *---------------------------------------------------------------------------*/
+u32
+NNS_G3dCullerTestSphereArray(NNSG3dCuller* pCuller,
+                             const NNSG3dCullSphere* pSphere,
+                             u32 num,
+                             u8* pResult)
+{
+    u32 i;
+    u32 numVisible = 0;
+    OSTick t;
+    NNS_G3D_NULL_ASSERT(pCuller);
+    NNS_G3D_NULL_ASSERT(pSphere);
+    NNS_G3D_NULL_ASSERT(pResult);
+
+    t = OS_GetTick();
+    for (i = 0; i < num; ++i)
+    {
+        pResult[i] = (u8)testSphere_(pCuller, &pSphere[i]);
+        if (pResult[i] != NNS_G3D_CULL_OUTSIDE)
+        {
+            ++numVisible;
+        }
+    }
+    pCuller->tickTest += OS_GetTick() - t;
+    pCuller->numTest += num;
+
+    return numVisible;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dCullerTestBoxArray
+
+    Tests num boxes in world coordinates and stores the results (NNSG3dCullResult) in pResult.
+    Returns the number of boxes that are not outside.
+ *---------------------------------------------------------------------------*/
+u32
+NNS_G3dCullerTestBoxArray(NNSG3dCuller* pCuller,
+                          const NNSG3dCullBox* pBox,
+                          u32 num,
+                          u8* pResult)
+{
+    u32 i;
+    u32 numVisible = 0;
+    OSTick t;
+    NNS_G3D_NULL_ASSERT(pCuller);
+    NNS_G3D_NULL_ASSERT(pBox);
+    NNS_G3D_NULL_ASSERT(pResult);
+
+    t = OS_GetTick();
+    for (i = 0; i < num; ++i)
+    {
+        pResult[i] = (u8)testBox_(pCuller, &pBox[i]);
+        if (pResult[i] != NNS_G3D_CULL_OUTSIDE)
+        {
+            ++numVisible;
+        }
+    }
+    pCuller->tickTest += OS_GetTick() - t;
+    pCuller->numTest += num;
+
+    return numVisible;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dCullerDraw
+
+    Draws pRenderObj with NNS_G3dDraw unless its bounding box is outside of the view volume.
+    The global state must be flushed as for NNS_G3dDraw.
+    Returns TRUE if the model has been drawn.
+ *---------------------------------------------------------------------------*/
+BOOL
+NNS_G3dCullerDraw(NNSG3dCuller* pCuller, NNSG3dRenderObj* pRenderObj)
+{
+    OSTick t;
+    NNS_G3D_NULL_ASSERT(pCuller);
+    NNS_G3D_NULL_ASSERT(pRenderObj);
+
+    if (NNS_G3dCullerTestMdl(pCuller, pRenderObj->resMdl) == NNS_G3D_CULL_OUTSIDE)
+    {
+        ++pCuller->numCulled;
+        return FALSE;
+    }
+
+    t = OS_GetTick();
+    NNS_G3dDraw(pRenderObj);
+    pCuller->tickDraw += OS_GetTick() - t;
+    ++pCuller->numDrawn;
+
+    return TRUE;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dCullNodeCallBack
+
+    Callback of the NODE command (set with NNS_G3D_SBC_CALLBACK_TIMING_B).
+    Hides the node when its bounding sphere in NNSG3dCullNodeInfo
+    (set as the user pointer of the render object) is outside of the view volume.
+    Since only the visibility is changed, the matrices of the node are still calculated.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dCullNodeCallBack(NNSG3dRS* rs)
+{
+    const NNSG3dCullNodeInfo* info;
+    const NNSG3dCullSphere* pLocal;
+    NNSG3dCullSphere sphere;
+    NNS_G3D_NULL_ASSERT(rs);
+
+    info = (const NNSG3dCullNodeInfo*)rs->pRenderObj->ptrUser;
+    NNS_G3D_NULL_ASSERT(info);
+    NNS_G3D_NULL_ASSERT(info->pCuller);
+
+    if (rs->currentNode >= info->numNode || !rs->pVisAnmResult->isVisible)
+    {
+        return;
+    }
+
+    pLocal = &info->pSphere[rs->currentNode];
+    if (pLocal->radius == 0)
+    {
+        return;
+    }
+
+    NNS_G3dCullGetSphere(&sphere, pLocal);
+    if (NNS_G3dCullerTestSphere(info->pCuller, &sphere) == NNS_G3D_CULL_OUTSIDE)
+    {
+        rs->pVisAnmResult->isVisible = FALSE;
+        ++info->pCuller->numNodeCulled;
+    }
+}
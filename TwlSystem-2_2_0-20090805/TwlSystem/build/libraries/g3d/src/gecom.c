@@ -56,6 +56,44 @@ static volatile int NNS_G3dFlagGXDmaAsync  = 0;
 static NNSG3dGeBuffer* NNS_G3dGeBuffer = NULL;
 
 
+/*---------------------------------------------------------------------------*
+    NNS_G3dGeRing
+
+    Pointer to the ring of geometry command buffers set by NNS_G3dGeSetRing.
+    While it is not NULL, NNS_G3dGeBuffer is not used.
+ *---------------------------------------------------------------------------*/
+static NNSG3dGeRing* NNS_G3dGeRing = NULL;
+
+
+/*---------------------------------------------------------------------------*
+    NNSi_G3dGeRingFifo
+
+    Ring waiting for the GXFIFO interrupt, and the GXFIFO interrupt setting
+    of the application, restored when the interrupt occurs.
+ *---------------------------------------------------------------------------*/
+static struct
+{
+    NNSG3dGeRing*  pRing;
+    GXFifoIntrCond cond;
+    OSIrqFunction  func;
+    OSIrqMask      mask;
+}
+NNSi_G3dGeRingFifo;
+
+
+/*---------------------------------------------------------------------------*
+    NNSi_G3dGeRecorder
+
+    Pointer to the recorder set by NNSi_G3dGeBeginRecord.
+    While it is not NULL, geometry commands are recorded instead of being sent.
+ *---------------------------------------------------------------------------*/
+static NNSG3dGeRecorder* NNSi_G3dGeRecorder = NULL;
+
+static void ringOP_(NNSG3dGeRing* pRing, u32 op, const u32* args, u32 num);
+static void flushRing_(NNSG3dGeRing* pRing);
+static void ringStart_(NNSG3dGeRing* pRing);
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // APIs
@@ -83,7 +121,7 @@ NNS_G3dGeIsSendDLBusy(void)
 BOOL
 NNS_G3dGeIsBufferExist(void)
 {
-    return (NNS_G3dGeBuffer != NULL);
+    return (NNS_G3dGeBuffer != NULL || NNS_G3dGeRing != NULL);
 }
 
 
@@ -144,6 +182,12 @@ sendNB(const void* src, void* dst, u32 szByte)
 void
 NNS_G3dGeFlushBuffer(void)
 {
+    if (NNS_G3dGeRing)
+    {
+        flushRing_(NNS_G3dGeRing);
+        return;
+    }
+
     if (NNS_G3dFlagGXDmaAsync)
     {
         NNS_G3dGeWaitSendDL();
@@ -184,6 +228,11 @@ NNS_G3dGeWaitSendDL(void)
 BOOL
 NNS_G3dGeIsImmOK(void)
 {
+    if (NNS_G3dGeRing)
+    {
+        return NNS_G3dGeRing->pBuf[NNS_G3dGeRing->idxBuild].idx == 0 &&
+               !NNS_G3dGeIsSendDLBusy();
+    }
     return (NNS_G3dGeBuffer == NULL || NNS_G3dGeBuffer->idx == 0) &&
            !NNS_G3dGeIsSendDLBusy();
 }
@@ -194,15 +243,115 @@ NNS_G3dGeIsImmOK(void)
 
     Returns whether or not an amount of data equal to numWord can be added to the geometry command buffer.
     Returns TRUE if the data can be added.
+    With a ring, returns TRUE if the data can be added without waiting for the transfer of a buffer.
  *---------------------------------------------------------------------------*/
 BOOL
 NNS_G3dGeIsBufferOK(u32 numWord)
 {
+    if (NNS_G3dGeRing)
+    {
+        const NNSG3dGeRing* pRing = NNS_G3dGeRing;
+        u32 next;
+
+        if (pRing->pBuf[pRing->idxBuild].idx + numWord <= NNS_G3D_SIZE_COMBUFFER)
+        {
+            return TRUE;
+        }
+
+        // The buffer being written is queued and the next buffer is used.
+        next = pRing->idxBuild + 1;
+        if (next >= pRing->numBuf)
+        {
+            next = 0;
+        }
+        return (numWord <= NNS_G3D_SIZE_COMBUFFER) &&
+               (pRing->tail - pRing->head < NNS_G3D_GERING_QUEUE_SIZE) &&
+               !(pRing->busyMask & (1U << next));
+    }
     return (NNS_G3dGeBuffer != NULL) &&
            (NNS_G3dGeBuffer->idx + numWord <= NNS_G3D_SIZE_COMBUFFER);
 }
 
 
+/*---------------------------------------------------------------------------*
+    NNSi_G3dGeBeginRecord
+
+    Starts recording the geometry commands in p.
+    Until NNSi_G3dGeEndRecord is called, NNS_G3dGeBufferOP_N and NNS_G3dGeSendDL do not send anything.
+    The functions that write to the geometry engine directly (G3_XXX) cannot be recorded.
+ *---------------------------------------------------------------------------*/
+void
+NNSi_G3dGeBeginRecord(NNSG3dGeRecorder* p)
+{
+    NNS_G3D_NULL_ASSERT(p);
+    NNS_G3D_ASSERT(NNSi_G3dGeRecorder == NULL);
+
+    p->idxData = NNS_G3D_GEREC_NO_DATA;
+    NNSi_G3dGeRecorder = p;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNSi_G3dGeEndRecord
+
+    Stops recording the geometry commands.
+ *---------------------------------------------------------------------------*/
+void
+NNSi_G3dGeEndRecord(void)
+{
+    NNS_G3D_NULL_ASSERT(NNSi_G3dGeRecorder);
+
+    NNSi_G3dGeRecorder->idxData = NNS_G3D_GEREC_NO_DATA;
+    NNSi_G3dGeRecorder = NULL;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNSi_G3dGeRecordWord
+
+    Writes one word to the recorder.
+    When there is no space left, only the size is counted.
+ *---------------------------------------------------------------------------*/
+void
+NNSi_G3dGeRecordWord(NNSG3dGeRecorder* p, u32 data)
+{
+    if (p->pBuf && p->idx < p->szBuf)
+    {
+        p->pBuf[p->idx] = data;
+    }
+    ++p->idx;
+}
+
+
+/*---------------------------------------------------------------------------*
+    recordOP_
+
+    Appends a geometry command to the current NNS_G3D_GEREC_TAG_DATA entry of the recorder.
+ *---------------------------------------------------------------------------*/
+static void
+recordOP_(NNSG3dGeRecorder* p, u32 op, const u32* args, u32 num)
+{
+    u32 i;
+
+    if (p->idxData == NNS_G3D_GEREC_NO_DATA)
+    {
+        p->idxData = p->idx;
+        NNSi_G3dGeRecordWord(p, NNS_G3D_GEREC_TAG_DATA);
+    }
+
+    NNSi_G3dGeRecordWord(p, op);
+    for (i = 0; i < num; ++i)
+    {
+        NNSi_G3dGeRecordWord(p, args[i]);
+    }
+
+    if (p->pBuf && p->idxData < p->szBuf)
+    {
+        p->pBuf[p->idxData] += 1 + num;
+    }
+}
+
+
 //
 // Exclusively used by NNS_G3dGeSendDL
 //
@@ -235,105 +384,469 @@ NNS_G3dGeUseFastDma(BOOL cond)
 
 
 /*---------------------------------------------------------------------------*
-    NNS_G3dGeSendDL
+    startDma_
 
-    Safely writes the display list to the Geometry Engine.
+    Starts the DMA transfer of a display list to the geometry engine.
+    callback is called with arg from the DMA completion interrupt.
  *---------------------------------------------------------------------------*/
-void
-NNS_G3dGeSendDL(const void* src, u32 szByte)
+static void
+startDma_(const void* src, u32 szByte, MIDmaCallback callback, void* arg)
 {
-    NNS_G3D_NULL_ASSERT(src);
-    NNS_G3D_ASSERT(szByte >= 4);
-
-    // start transmission
-    if (szByte < 256 || GX_DMAID == GX_DMA_NOT_USE)
+    // When dmaNo is GX_DMA_NOT_USE, an assertion will occur within the MI_SendGXCommand* functions. This assertion is determined only due to DMA switching.
+    // 
+    if (NNS_G3dFlagUseFastDma)
     {
-        NNS_G3dGeBufferOP_N(*(const u32*)src,
-                            (const u32*)src + 1,
-                            (szByte >> 2) - 1);
-    }
-    else
-    {
-        // The command buffer must be flushed in advance.
-        NNS_G3dGeFlushBuffer();
-        NNS_G3dFlagGXDmaAsync = 1;
-
-        // When dmaNo is GX_DMA_NOT_USE, an assertion will occur within the MI_SendGXCommand* functions. This assertion is determined only due to DMA switching.
-        // 
-        if (NNS_G3dFlagUseFastDma)
+        if (OS_IsRunOnTwl())
         {
-            if (OS_IsRunOnTwl())
-            {
 #ifdef SDK_TWL
-                u32 dmaNo = GX_GetDefaultDMA();
-                if (dmaNo == GX_DMA_NOT_USE)
-                {
-                    dmaNo = GX_GetDefaultNDMA();
-                    MI_SendNDmaGXCommandAsyncFast(dmaNo,
-                                                  src,
-                                                  szByte,
-                                                  &simpleUnlock_,
-                                                  (void*)&NNS_G3dFlagGXDmaAsync);
-                }
-                else
-                {
-                    MI_SendGXCommandAsyncFast(dmaNo,
+            u32 dmaNo = GX_GetDefaultDMA();
+            if (dmaNo == GX_DMA_NOT_USE)
+            {
+                dmaNo = GX_GetDefaultNDMA();
+                MI_SendNDmaGXCommandAsyncFast(dmaNo,
                                               src,
                                               szByte,
-                                              &simpleUnlock_,
-                                              (void*)&NNS_G3dFlagGXDmaAsync);
-                }
-#endif
+                                              callback,
+                                              arg);
             }
             else
             {
-#ifndef SDK_TWLLTD
-                u32 dmaNo = GX_GetDefaultDMA();
                 MI_SendGXCommandAsyncFast(dmaNo,
                                           src,
                                           szByte,
-                                          &simpleUnlock_,
-                                          (void*)&NNS_G3dFlagGXDmaAsync);
-#endif
+                                          callback,
+                                          arg);
             }
+#endif
         }
         else
         {
-            if (OS_IsRunOnTwl())
-            {
+#ifndef SDK_TWLLTD
+            u32 dmaNo = GX_GetDefaultDMA();
+            MI_SendGXCommandAsyncFast(dmaNo,
+                                      src,
+                                      szByte,
+                                      callback,
+                                      arg);
+#endif
+        }
+    }
+    else
+    {
+        if (OS_IsRunOnTwl())
+        {
 #ifdef SDK_TWL
-                u32 dmaNo = GX_GetDefaultDMA();
-                if (dmaNo == GX_DMA_NOT_USE)
-                {
-                    dmaNo = GX_GetDefaultNDMA();
-                    MI_SendNDmaGXCommandAsync(dmaNo,
-                                              src,
-                                              szByte,
-                                              &simpleUnlock_,
-                                              (void*)&NNS_G3dFlagGXDmaAsync);
-                }
-                else
-                {
-                    MI_SendGXCommandAsync(dmaNo,
+            u32 dmaNo = GX_GetDefaultDMA();
+            if (dmaNo == GX_DMA_NOT_USE)
+            {
+                dmaNo = GX_GetDefaultNDMA();
+                MI_SendNDmaGXCommandAsync(dmaNo,
                                           src,
                                           szByte,
-                                          &simpleUnlock_,
-                                          (void*)&NNS_G3dFlagGXDmaAsync);
-                }
-#endif
+                                          callback,
+                                          arg);
             }
             else
             {
-#ifndef SDK_TWLLTD
-                u32 dmaNo = GX_GetDefaultDMA();
                 MI_SendGXCommandAsync(dmaNo,
                                       src,
                                       szByte,
-                                      &simpleUnlock_,
-                                      (void*)&NNS_G3dFlagGXDmaAsync);
-#endif
+                                      callback,
+                                      arg);
             }
+#endif
+        }
+        else
+        {
+#ifndef SDK_TWLLTD
+            u32 dmaNo = GX_GetDefaultDMA();
+            MI_SendGXCommandAsync(dmaNo,
+                                  src,
+                                  szByte,
+                                  callback,
+                                  arg);
+#endif
+        }
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    ringDone_
+
+    Called from the DMA completion interrupt when a request of the ring has been sent.
+    Releases its buffer and starts the next request.
+ *---------------------------------------------------------------------------*/
+static void
+ringDone_(void* arg)
+{
+    NNSG3dGeRing* pRing = (NNSG3dGeRing*)arg;
+    const NNSG3dGeRingReq* req = &pRing->queue[pRing->head & (NNS_G3D_GERING_QUEUE_SIZE - 1)];
+
+    if (req->idxBuf >= 0)
+    {
+        pRing->busyMask &= ~(1U << req->idxBuf);
+    }
+    ++pRing->head;
+
+    if (pRing->head != pRing->tail)
+    {
+        ringStart_(pRing);
+    }
+    else
+    {
+        NNS_G3dFlagGXDmaAsync = 0;
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    ringFifo_
+
+    Called from the GXFIFO interrupt when the geometry command FIFO is less than half full.
+    Restores the GXFIFO interrupt setting and starts the request waiting in ringStart_.
+ *---------------------------------------------------------------------------*/
+static void
+ringFifo_(void)
+{
+    NNSG3dGeRing* pRing = NNSi_G3dGeRingFifo.pRing;
+
+    NNSi_G3dGeRingFifo.pRing = NULL;
+    if (!(NNSi_G3dGeRingFifo.mask & OS_IE_GXFIFO))
+    {
+        (void)OS_DisableIrqMask(OS_IE_GXFIFO);
+    }
+    G3X_SetFifoIntrCond(NNSi_G3dGeRingFifo.cond);
+    OS_SetIrqFunction(OS_IE_GXFIFO, NNSi_G3dGeRingFifo.func);
+    (void)OS_ResetRequestIrqMask(OS_IE_GXFIFO);
+
+    NNS_G3D_NULL_ASSERT(pRing);
+    ringStart_(pRing);
+}
+
+
+/*---------------------------------------------------------------------------*
+    ringStart_
+
+    Starts the transfer of the request at the head of the queue.
+    Called with interrupts disabled, or from an interrupt.
+
+    MI_SendGXCommandAsync waits until the geometry command FIFO is less than half full.
+    So that no interrupt handler waits for the FIFO, the transfer is started
+    from the GXFIFO interrupt when the FIFO is not less than half full yet.
+    MI_SendGXCommandAsyncFast does not wait.
+ *---------------------------------------------------------------------------*/
+static void
+ringStart_(NNSG3dGeRing* pRing)
+{
+    if (NNS_G3dFlagUseFastDma ||
+        (G3X_GetCommandFifoStatus() & GX_FIFOSTAT_UNDERHALF))
+    {
+        const NNSG3dGeRingReq* req = &pRing->queue[pRing->head & (NNS_G3D_GERING_QUEUE_SIZE - 1)];
+        startDma_(req->src, req->szByte, &ringDone_, pRing);
+    }
+    else
+    {
+        NNS_G3D_ASSERT(NNSi_G3dGeRingFifo.pRing == NULL);
+
+        NNSi_G3dGeRingFifo.pRing = pRing;
+        NNSi_G3dGeRingFifo.cond  = (GXFifoIntrCond)((reg_G3X_GXSTAT & REG_G3X_GXSTAT_FI_MASK) >>
+                                                    REG_G3X_GXSTAT_FI_SHIFT);
+        NNSi_G3dGeRingFifo.func  = OS_GetIrqFunction(OS_IE_GXFIFO);
+
+        G3X_SetFifoIntrCond(GX_FIFOINTR_COND_UNDERHALF);
+        OS_SetIrqFunction(OS_IE_GXFIFO, ringFifo_);
+        NNSi_G3dGeRingFifo.mask  = OS_EnableIrqMask(OS_IE_GXFIFO);
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    ringEnqueue_
+
+    Queues the transfer of src (szByte bytes) after the requests already in the queue.
+    idxBuf is the index of the buffer of the ring, or -1 for a display list.
+ *---------------------------------------------------------------------------*/
+static void
+ringEnqueue_(NNSG3dGeRing* pRing, const void* src, u32 szByte, int idxBuf)
+{
+    NNSG3dGeRingReq* req;
+    OSIntrMode mode;
+    u32 num;
+
+    if (pRing->tail - pRing->head >= NNS_G3D_GERING_QUEUE_SIZE)
+    {
+        // back-pressure: wait for a queue entry
+        OSTick t = OS_GetTick();
+        ++pRing->numStall;
+        while(pRing->tail - pRing->head >= NNS_G3D_GERING_QUEUE_SIZE)
+            ;
+        pRing->tickStall += OS_GetTick() - t;
+    }
+
+    req = &pRing->queue[pRing->tail & (NNS_G3D_GERING_QUEUE_SIZE - 1)];
+    req->src    = src;
+    req->szByte = szByte;
+    req->idxBuf = idxBuf;
+
+    mode = OS_DisableInterrupts();
+    if (idxBuf >= 0)
+    {
+        pRing->busyMask |= 1U << idxBuf;
+    }
+    ++pRing->tail;
+
+    ++pRing->numSubmit;
+    num = pRing->tail - pRing->head;
+    if (num > pRing->highWater)
+    {
+        pRing->highWater = num;
+    }
+
+    if (!NNS_G3dFlagGXDmaAsync)
+    {
+        // The queue was empty.
+        NNS_G3dFlagGXDmaAsync = 1;
+        ringStart_(pRing);
+    }
+    (void)OS_RestoreInterrupts(mode);
+}
+
+
+/*---------------------------------------------------------------------------*
+    ringSubmit_
+
+    Queues the buffer being written and moves to the next buffer of the ring.
+    Waits when the next buffer has not been sent yet.
+ *---------------------------------------------------------------------------*/
+static void
+ringSubmit_(NNSG3dGeRing* pRing)
+{
+    NNSG3dGeBuffer* b = &pRing->pBuf[pRing->idxBuild];
+    u32 next;
+
+    if (b->idx == 0)
+        return;
+
+    // The buffer is read by DMA.
+    DC_StoreRange(&b->data[0], b->idx << 2);
+    ringEnqueue_(pRing, &b->data[0], b->idx << 2, (int)pRing->idxBuild);
+
+    next = pRing->idxBuild + 1;
+    if (next >= pRing->numBuf)
+    {
+        next = 0;
+    }
+
+    if (pRing->busyMask & (1U << next))
+    {
+        // back-pressure: wait for the next buffer
+        OSTick t = OS_GetTick();
+        ++pRing->numStall;
+        while(pRing->busyMask & (1U << next))
+            ;
+        pRing->tickStall += OS_GetTick() - t;
+    }
+
+    pRing->pBuf[next].idx = 0;
+    pRing->idxBuild = next;
+}
+
+
+/*---------------------------------------------------------------------------*
+    ringOP_
+
+    Writes a geometry command to the buffer being written.
+ *---------------------------------------------------------------------------*/
+static void
+ringOP_(NNSG3dGeRing* pRing, u32 op, const u32* args, u32 num)
+{
+    NNSG3dGeBuffer* b = &pRing->pBuf[pRing->idxBuild];
+    NNS_G3D_ASSERT(1 + num <= NNS_G3D_SIZE_COMBUFFER);
+
+    if (b->idx + 1 + num > NNS_G3D_SIZE_COMBUFFER)
+    {
+        ringSubmit_(pRing);
+        b = &pRing->pBuf[pRing->idxBuild];
+    }
+
+    b->data[b->idx++] = op;
+    if (num > 0)
+    {
+        MI_CpuCopyFast(args, &b->data[b->idx], num << 2);
+        b->idx += num;
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    flushRing_
+
+    Queues the buffer being written and waits until the queue is empty.
+ *---------------------------------------------------------------------------*/
+static void
+flushRing_(NNSG3dGeRing* pRing)
+{
+    ringSubmit_(pRing);
+
+    if (NNS_G3dFlagGXDmaAsync)
+    {
+        OSTick t = OS_GetTick();
+        NNS_G3dGeWaitSendDL();
+        pRing->tickFlush += OS_GetTick() - t;
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dGeSetRing
+
+    Sets pRing, made of numBuf buffers starting at pBuf, as the geometry command buffer of G3D.
+    The commands already buffered are sent first.
+    While the ring is set, the buffer set by NNS_G3dGeSetBuffer is not used.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dGeSetRing(NNSG3dGeRing* pRing, NNSG3dGeBuffer* pBuf, u32 numBuf)
+{
+    u32 i;
+
+    NNS_G3D_NULL_ASSERT(pRing);
+    NNS_G3D_NULL_ASSERT(pBuf);
+    NNS_G3D_ASSERT(numBuf >= 2 && numBuf <= NNS_G3D_GERING_MAX_BUFFER);
+    NNS_G3D_ASSERTMSG(NNS_G3dGeRing == NULL, "a ring is already set");
+    NNS_G3D_ASSERTMSG(GX_DMAID != GX_DMA_NOT_USE, "the ring needs GX DMA");
+
+    NNS_G3dGeFlushBuffer();
+
+    pRing->pBuf     = pBuf;
+    pRing->numBuf   = numBuf;
+    pRing->idxBuild = 0;
+    pRing->busyMask = 0;
+    pRing->head     = 0;
+    pRing->tail     = 0;
+    for (i = 0; i < numBuf; ++i)
+    {
+        pBuf[i].idx = 0;
+    }
+    NNS_G3dGeResetRingStats(pRing);
+
+    NNS_G3dGeRing = pRing;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dGeReleaseRing
+
+    Sends everything in the ring and stops using it.
+    The return value is a pointer to the removed ring.
+ *---------------------------------------------------------------------------*/
+NNSG3dGeRing*
+NNS_G3dGeReleaseRing(void)
+{
+    NNSG3dGeRing* p;
+
+    NNS_G3dGeFlushBuffer();
+
+    p = NNS_G3dGeRing;
+    NNS_G3dGeRing = NULL;
+    return p;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dGeKickRing
+
+    Queues the buffer being written without waiting for the transfer.
+    For example, call this after the commands of a frame (and G3OP_SWAP_BUFFERS)
+    so that they are sent while the CPU prepares the next frame.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dGeKickRing(void)
+{
+    if (NNS_G3dGeRing)
+    {
+        ringSubmit_(NNS_G3dGeRing);
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dGeResetRingStats
+
+    Resets the statistics of the ring.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dGeResetRingStats(NNSG3dGeRing* pRing)
+{
+    NNS_G3D_NULL_ASSERT(pRing);
+
+    pRing->numSubmit = 0;
+    pRing->numStall  = 0;
+    pRing->tickStall = 0;
+    pRing->tickFlush = 0;
+    pRing->highWater = 0;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dGeSendDL
+
+    Safely writes the display list to the Geometry Engine.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dGeSendDL(const void* src, u32 szByte)
+{
+    NNS_G3D_NULL_ASSERT(src);
+    NNS_G3D_ASSERT(szByte >= 4);
+
+    if (NNSi_G3dGeRecorder)
+    {
+        NNSG3dGeRecorder* p = NNSi_G3dGeRecorder;
+
+        if (p->isCopyDL)
+        {
+            recordOP_(p, *(const u32*)src, (const u32*)src + 1, (szByte >> 2) - 1);
+        }
+        else
+        {
+            // Record only the reference to the display list.
+            p->idxData = NNS_G3D_GEREC_NO_DATA;
+            NNSi_G3dGeRecordWord(p, NNS_G3D_GEREC_TAG_DL);
+            NNSi_G3dGeRecordWord(p, (u32)src);
+            NNSi_G3dGeRecordWord(p, szByte);
+        }
+        return;
+    }
+
+    if (NNS_G3dGeRing)
+    {
+        if (szByte < 256)
+        {
+            ringOP_(NNS_G3dGeRing, *(const u32*)src, (const u32*)src + 1, (szByte >> 2) - 1);
+        }
+        else
+        {
+            // Queued after the commands written so far
+            ringSubmit_(NNS_G3dGeRing);
+            ringEnqueue_(NNS_G3dGeRing, src, szByte, -1);
         }
+        return;
+    }
+
+    // start transmission
+    if (szByte < 256 || GX_DMAID == GX_DMA_NOT_USE)
+    {
+        NNS_G3dGeBufferOP_N(*(const u32*)src,
+                            (const u32*)src + 1,
+                            (szByte >> 2) - 1);
+    }
+    else
+    {
+        // The command buffer must be flushed in advance.
+        NNS_G3dGeFlushBuffer();
+        NNS_G3dFlagGXDmaAsync = 1;
+
+        startDma_(src, szByte, &simpleUnlock_, (void*)&NNS_G3dFlagGXDmaAsync);
     }
 }
 
@@ -346,6 +859,18 @@ NNS_G3dGeSendDL(const void* src, u32 szByte)
 void
 NNS_G3dGeBufferOP_N(u32 op, const u32* args, u32 num)
 {
+    if (NNSi_G3dGeRecorder)
+    {
+        recordOP_(NNSi_G3dGeRecorder, op, args, num);
+        return;
+    }
+
+    if (NNS_G3dGeRing)
+    {
+        ringOP_(NNS_G3dGeRing, op, args, num);
+        return;
+    }
+
     if (NNS_G3dGeBuffer)
     {
         if (NNS_G3dFlagGXDmaAsync)
@@ -93,6 +93,8 @@ NNS_G3dGlbInit(void)
     NNS_G3dGlb.prmTexImageParam = 0;
 
     NNS_G3dGlb.flag = (NNSG3dGlbFlag) 0;
+    NNS_G3dGlb.numFlushWord = 0;
+    NNS_G3dGlb.numSkipWord  = 0;
 
     NNS_G3dGlb.camPos.x = NNS_G3dGlb.camPos.y = NNS_G3dGlb.camPos.z = 0;
     NNS_G3dGlb.camUp.x = NNS_G3dGlb.camUp.z = 0;
@@ -103,38 +105,32 @@ NNS_G3dGlbInit(void)
 
 
 /*---------------------------------------------------------------------------*
-    NNS_G3dGlbFlushP
+    Sizes (in words) of the command blocks of NNSG3dGlb
+ *---------------------------------------------------------------------------*/
+#define GLB_SZ_PROJ_      ((sizeof(NNS_G3dGlb.mtxmode_proj) + sizeof(NNS_G3dGlb.projMtx)) / 4)
+#define GLB_SZ_CAMERA_    ((sizeof(NNS_G3dGlb.mtxmode_posvec) + sizeof(NNS_G3dGlb.cameraMtx)) / 4)
+#define GLB_SZ_LIGHTVEC_  ((sizeof(NNS_G3dGlb.cmd1) + sizeof(NNS_G3dGlb.lightVec)) / 4)
+#define GLB_SZ_MATERIAL_  ((sizeof(NNS_G3dGlb.cmd2)           +       \
+                            sizeof(NNS_G3dGlb.prmMatColor0)   +       \
+                            sizeof(NNS_G3dGlb.prmMatColor1)   +       \
+                            sizeof(NNS_G3dGlb.prmPolygonAttr) +       \
+                            sizeof(NNS_G3dGlb.prmViewPort)) / 4)
+#define GLB_SZ_LIGHTCOLOR_ ((sizeof(NNS_G3dGlb.cmd3) + sizeof(NNS_G3dGlb.lightColor)) / 4)
+#define GLB_SZ_BASE_      ((sizeof(NNS_G3dGlb.cmd4)             +     \
+                            sizeof(NNS_G3dGlb.prmBaseRot)       +     \
+                            sizeof(NNS_G3dGlb.prmBaseTrans)     +     \
+                            sizeof(NNS_G3dGlb.prmBaseScale)     +     \
+                            sizeof(NNS_G3dGlb.prmTexImageParam)) / 4)
 
-    Reflect content of NNSG3dGlb in the geometry engine.
-    Projection transform matrix is set in current projection matrix.
-    In current position coordinate matrix, thing combining camera matrix and world transform matrix are set.
 
-    Color, etc., is sent in case a Sbc SHP command comes unexpectedly.
-    After processing the command, mode is POSITION/VECTOR.
+/*---------------------------------------------------------------------------*
+    assertGlbCmd_
+
+    Checks the command words of NNSG3dGlb.
  *---------------------------------------------------------------------------*/
-void
-NNS_G3dGlbFlushP(void)
+static NNS_G3D_INLINE void
+assertGlbCmd_(void)
 {
-    static const u32 sz = (sizeof(NNS_G3dGlb.cmd0)              +
-                           sizeof(NNS_G3dGlb.mtxmode_proj)      +
-                           sizeof(NNS_G3dGlb.projMtx)           +
-                           sizeof(NNS_G3dGlb.mtxmode_posvec)    +
-                           sizeof(NNS_G3dGlb.cameraMtx)         +
-                           sizeof(NNS_G3dGlb.cmd1)              +
-                           sizeof(NNS_G3dGlb.lightVec[0]) * 4   +
-                           sizeof(NNS_G3dGlb.cmd2)              +
-                           sizeof(NNS_G3dGlb.prmMatColor0)      +
-                           sizeof(NNS_G3dGlb.prmMatColor1)      +
-                           sizeof(NNS_G3dGlb.prmPolygonAttr)    +
-                           sizeof(NNS_G3dGlb.prmViewPort)       +
-                           sizeof(NNS_G3dGlb.cmd4)              +
-                           sizeof(NNS_G3dGlb.prmBaseTrans)      +
-                           sizeof(NNS_G3dGlb.prmBaseRot)        +
-                           sizeof(NNS_G3dGlb.prmBaseScale)      +
-                           sizeof(NNS_G3dGlb.prmTexImageParam)  +
-                           sizeof(NNS_G3dGlb.cmd3)              +
-                           sizeof(NNS_G3dGlb.lightColor[0]) * 4) / 4;
-
     NNS_G3D_ASSERT(NNS_G3dGlb.cmd0 == ((G3OP_MTX_MODE << 0)     |
                                        (G3OP_MTX_LOAD_4x4 << 8) |
                                        (G3OP_MTX_MODE << 16)    |
@@ -156,11 +152,130 @@ NNS_G3dGlbFlushP(void)
     NNS_G3D_ASSERT(NNS_G3dGlb.cmd4 == ((G3OP_MTX_MULT_4x3 << 0) |
                                        (G3OP_MTX_SCALE << 8)    |
                                        (G3OP_TEXIMAGE_PARAM << 16)));
+}
+
+
+/*---------------------------------------------------------------------------*
+    sendLightMaterial_
 
-    NNS_G3dGeBufferData_N((u32*)&NNS_G3dGlb.cmd0, sz);
+    Sends the light vectors, the material colors, PolygonAttr, ViewPort and the light colors
+    that are not up to date in the geometry engine.
+ *---------------------------------------------------------------------------*/
+static void
+sendLightMaterial_(u32 flag)
+{
+    if (!(flag & NNS_G3D_GLB_FLAG_GE_LIGHTVEC_UPTODATE))
+    {
+        NNS_G3dGeBufferData_N((u32*)&NNS_G3dGlb.cmd1, GLB_SZ_LIGHTVEC_);
+        NNS_G3dGlb.numFlushWord += GLB_SZ_LIGHTVEC_;
+    }
+    else
+    {
+        NNS_G3dGlb.numSkipWord += GLB_SZ_LIGHTVEC_;
+    }
+
+    if (!(flag & NNS_G3D_GLB_FLAG_GE_MATERIAL_UPTODATE))
+    {
+        NNS_G3dGeBufferData_N((u32*)&NNS_G3dGlb.cmd2, GLB_SZ_MATERIAL_);
+        NNS_G3dGlb.numFlushWord += GLB_SZ_MATERIAL_;
+    }
+    else
+    {
+        NNS_G3dGlb.numSkipWord += GLB_SZ_MATERIAL_;
+    }
+
+    if (!(flag & NNS_G3D_GLB_FLAG_GE_LIGHTCOLOR_UPTODATE))
+    {
+        NNS_G3dGeBufferData_N((u32*)&NNS_G3dGlb.cmd3, GLB_SZ_LIGHTCOLOR_);
+        NNS_G3dGlb.numFlushWord += GLB_SZ_LIGHTCOLOR_;
+    }
+    else
+    {
+        NNS_G3dGlb.numSkipWord += GLB_SZ_LIGHTCOLOR_;
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    getInvBaseRot_
+
+    Returns the inverse matrix of the base rotation matrix (calculated only when changed).
+ *---------------------------------------------------------------------------*/
+static const MtxFx43*
+getInvBaseRot_(void)
+{
+    if (!(NNS_G3dGlb.flag & NNS_G3D_GLB_FLAG_INVBASEROT_UPTODATE))
+    {
+        int result;
+        result = MTX_Inverse33(&NNS_G3dGlb.prmBaseRot, (MtxFx33*)&NNS_G3dGlb.invBaseRotMtx);
+        NNS_G3D_ASSERT(!result);
+        NNS_G3dGlb.invBaseRotMtx._30 = 0;
+        NNS_G3dGlb.invBaseRotMtx._31 = 0;
+        NNS_G3dGlb.invBaseRotMtx._32 = 0;
+        NNS_G3dGlb.flag |= NNS_G3D_GLB_FLAG_INVBASEROT_UPTODATE;
+    }
+    return &NNS_G3dGlb.invBaseRotMtx;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dGlbFlushP
+
+    Reflect content of NNSG3dGlb in the geometry engine.
+    Projection transform matrix is set in current projection matrix.
+    In current position coordinate matrix, thing combining camera matrix and world transform matrix are set.
+
+    Color, etc., is sent in case a Sbc SHP command comes unexpectedly.
+    After processing the command, mode is POSITION/VECTOR.
+
+    While the dirty tracking is enabled, the projection matrix, the lights and the material
+    are sent only when changed since the last flush.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dGlbFlushP(void)
+{
+    u32 flag;
+
+    assertGlbCmd_();
+
+    // The geometry engine has another projection matrix and light vectors after NNS_G3dGlbFlushVP/WVP.
+    if (NNS_G3dGlb.flag & (NNS_G3D_GLB_FLAG_FLUSH_WVP | NNS_G3D_GLB_FLAG_FLUSH_VP))
+    {
+        NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_GE_PROJ_UPTODATE |
+                             NNS_G3D_GLB_FLAG_GE_LIGHTVEC_UPTODATE);
+    }
+    flag = NNS_G3dGlb.flag;
+
+    if (!(flag & NNS_G3D_GLB_FLAG_GE_PROJ_UPTODATE))
+    {
+        // Projection matrix and camera matrix
+        NNS_G3dGeBufferData_N((u32*)&NNS_G3dGlb.cmd0,
+                              1 + GLB_SZ_PROJ_ + GLB_SZ_CAMERA_);
+        NNS_G3dGlb.numFlushWord += 1 + GLB_SZ_PROJ_ + GLB_SZ_CAMERA_;
+    }
+    else
+    {
+        // Camera matrix only (NNS_G3dDraw changes the current matrix)
+        NNS_G3dGeBufferOP_N(GX_PACK_OP(G3OP_MTX_MODE, G3OP_MTX_LOAD_4x3, G3OP_NOP, G3OP_NOP),
+                            (u32*)&NNS_G3dGlb.mtxmode_posvec,
+                            GLB_SZ_CAMERA_);
+        NNS_G3dGlb.numFlushWord += 1 + GLB_SZ_CAMERA_;
+        NNS_G3dGlb.numSkipWord  += GLB_SZ_PROJ_;
+    }
+
+    // The light vectors are converted by the camera matrix.
+    sendLightMaterial_(flag);
+
+    NNS_G3dGeBufferData_N((u32*)&NNS_G3dGlb.cmd4, GLB_SZ_BASE_);
+    NNS_G3dGlb.numFlushWord += GLB_SZ_BASE_;
 
     NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_FLUSH_WVP;
     NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_FLUSH_VP;
+
+    if (NNS_G3dGlb.flag & NNS_G3D_GLB_FLAG_DIRTY_TRACKING)
+    {
+        NNS_G3dGlb.flag |= NNS_G3D_GLB_FLAG_GE_UPTODATE_ALL;
+    }
     //
     // After processing the command, the mode is POSITION/VECTOR.
     //
@@ -176,63 +291,61 @@ NNS_G3dGlbFlushP(void)
 
     Color, etc., is sent in case a Sbc SHP command comes unexpectedly.
     After processing the command, mode is POSITION/VECTOR.
+
+    While the dirty tracking is enabled, the projection matrix, the lights and the material
+    are sent only when changed since the last flush.
  *---------------------------------------------------------------------------*/
 void
 NNS_G3dGlbFlushVP(void)
 {
-    static const u32 sz = (sizeof(NNS_G3dGlb.cmd1)              +
-                           sizeof(NNS_G3dGlb.lightVec[0]) * 4   +
-                           sizeof(NNS_G3dGlb.cmd2)              +
-                           sizeof(NNS_G3dGlb.prmMatColor0)      +
-                           sizeof(NNS_G3dGlb.prmMatColor1)      +
-                           sizeof(NNS_G3dGlb.prmPolygonAttr)    +
-                           sizeof(NNS_G3dGlb.prmViewPort)       +
-                           sizeof(NNS_G3dGlb.cmd3)              +
-                           sizeof(NNS_G3dGlb.lightColor[0]) * 4 +
-                           sizeof(NNS_G3dGlb.cmd4)              +
-                           sizeof(NNS_G3dGlb.prmBaseRot)        +
-                           sizeof(NNS_G3dGlb.prmBaseTrans)      +
-                           sizeof(NNS_G3dGlb.prmBaseScale)      +
-                           sizeof(NNS_G3dGlb.prmTexImageParam)) / 4;
+    u32 flag;
 
-    NNS_G3D_ASSERT(NNS_G3dGlb.cmd0 == ((G3OP_MTX_MODE << 0)     |
-                                       (G3OP_MTX_LOAD_4x4 << 8) |
-                                       (G3OP_MTX_MODE << 16)    |
-                                       (G3OP_MTX_LOAD_4x3 << 24)));
-    NNS_G3D_ASSERT(NNS_G3dGlb.mtxmode_proj == GX_MTXMODE_PROJECTION);
-    NNS_G3D_ASSERT(NNS_G3dGlb.mtxmode_posvec == GX_MTXMODE_POSITION_VECTOR);
-    NNS_G3D_ASSERT(NNS_G3dGlb.cmd1 == ((G3OP_LIGHT_VECTOR << 0)  |
-                                       (G3OP_LIGHT_VECTOR << 8)  |
-                                       (G3OP_LIGHT_VECTOR << 16) |
-                                       (G3OP_LIGHT_VECTOR << 24)));
-    NNS_G3D_ASSERT(NNS_G3dGlb.cmd2 == ((G3OP_DIF_AMB << 0)       |
-                                       (G3OP_SPE_EMI << 8)       |
-                                       (G3OP_POLYGON_ATTR << 16) |
-                                       (G3OP_VIEWPORT << 24)));
-    NNS_G3D_ASSERT(NNS_G3dGlb.cmd3 == ((G3OP_LIGHT_COLOR << 0)  |
-                                       (G3OP_LIGHT_COLOR << 8)  |
-                                       (G3OP_LIGHT_COLOR << 16) |
-                                       (G3OP_LIGHT_COLOR << 24)));
-    NNS_G3D_ASSERT(NNS_G3dGlb.cmd4 == ((G3OP_MTX_MULT_4x3 << 0) |
-                                       (G3OP_MTX_SCALE << 8)    |
-                                       (G3OP_TEXIMAGE_PARAM << 16)));
+    assertGlbCmd_();
 
-    // Switch to projection matrix mode and set projection matrix.
-    NNS_G3dGeBufferOP_N(GX_PACK_OP(G3OP_MTX_MODE, G3OP_MTX_LOAD_4x4, G3OP_NOP, G3OP_NOP),
-                        (u32*)&NNS_G3dGlb.mtxmode_proj,
-                        (sizeof(NNS_G3dGlb.mtxmode_proj) +
-                         sizeof(NNS_G3dGlb.projMtx)) / 4);    
+    // The geometry engine has another projection matrix and light vectors after NNS_G3dGlbFlushP/WVP.
+    if (!(NNS_G3dGlb.flag & NNS_G3D_GLB_FLAG_FLUSH_VP))
+    {
+        NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_GE_PROJ_UPTODATE |
+                             NNS_G3D_GLB_FLAG_GE_LIGHTVEC_UPTODATE);
+    }
+    flag = NNS_G3dGlb.flag;
 
-    // multiply the camera matrix by the projection matrix
-    NNS_G3dGeBufferOP_N((G3OP_MTX_MULT_4x3 << 0),
-                        (u32*)&NNS_G3dGlb.cameraMtx,
-                        sizeof(NNS_G3dGlb.cameraMtx) / 4);
+    if (!(flag & NNS_G3D_GLB_FLAG_GE_PROJ_UPTODATE))
+    {
+        // Switch to projection matrix mode and set projection matrix.
+        NNS_G3dGeBufferOP_N(GX_PACK_OP(G3OP_MTX_MODE, G3OP_MTX_LOAD_4x4, G3OP_NOP, G3OP_NOP),
+                            (u32*)&NNS_G3dGlb.mtxmode_proj,
+                            GLB_SZ_PROJ_);
+
+        // multiply the camera matrix by the projection matrix
+        NNS_G3dGeBufferOP_N((G3OP_MTX_MULT_4x3 << 0),
+                            (u32*)&NNS_G3dGlb.cameraMtx,
+                            sizeof(NNS_G3dGlb.cameraMtx) / 4);
+
+        NNS_G3dGlb.numFlushWord += 1 + GLB_SZ_PROJ_ + 1 + sizeof(NNS_G3dGlb.cameraMtx) / 4;
+    }
+    else
+    {
+        NNS_G3dGlb.numSkipWord  += 1 + GLB_SZ_PROJ_ + 1 + sizeof(NNS_G3dGlb.cameraMtx) / 4;
+    }
 
     NNS_G3dGeMtxMode(GX_MTXMODE_POSITION_VECTOR);
-    NNS_G3dGeBufferOP_N(G3OP_MTX_IDENTITY, (u32*)&NNS_G3dGlb.cmd1, sz);
+    NNS_G3dGeIdentity();
+    NNS_G3dGlb.numFlushWord += 3;
+
+    // The light vectors are in the world coordinates.
+    sendLightMaterial_(flag);
+
+    NNS_G3dGeBufferData_N((u32*)&NNS_G3dGlb.cmd4, GLB_SZ_BASE_);
+    NNS_G3dGlb.numFlushWord += GLB_SZ_BASE_;
 
     NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_FLUSH_WVP;
     NNS_G3dGlb.flag |=  NNS_G3D_GLB_FLAG_FLUSH_VP;
+
+    if (NNS_G3dGlb.flag & NNS_G3D_GLB_FLAG_DIRTY_TRACKING)
+    {
+        NNS_G3dGlb.flag |= NNS_G3D_GLB_FLAG_GE_UPTODATE_ALL;
+    }
 }
 
 
@@ -245,48 +358,29 @@ NNS_G3dGlbFlushVP(void)
 
     Color, etc., is sent in case a Sbc SHP command comes unexpectedly.
     After processing the command, mode is POSITION/VECTOR.
+
+    While the dirty tracking is enabled, the lights and the material
+    are sent only when changed since the last flush.
+    The projection matrix depends on the world transform matrix and is always sent.
  *---------------------------------------------------------------------------*/
 void
 NNS_G3dGlbFlushWVP(void)
 {
-    static const u32 sz = (sizeof(NNS_G3dGlb.cmd1)              +
-                           sizeof(NNS_G3dGlb.lightVec[0]) * 4   +
-                           sizeof(NNS_G3dGlb.cmd2)              +
-                           sizeof(NNS_G3dGlb.prmMatColor0)      +
-                           sizeof(NNS_G3dGlb.prmMatColor1)      +
-                           sizeof(NNS_G3dGlb.prmPolygonAttr)    +
-                           sizeof(NNS_G3dGlb.prmViewPort)       +
-                           sizeof(NNS_G3dGlb.cmd3)              +
-                           sizeof(NNS_G3dGlb.lightColor[0]) * 4) / 4;
+    u32 flag;
 
-    NNS_G3D_ASSERT(NNS_G3dGlb.cmd0 == ((G3OP_MTX_MODE << 0)     |
-                                       (G3OP_MTX_LOAD_4x4 << 8) |
-                                       (G3OP_MTX_MODE << 16)    |
-                                       (G3OP_MTX_LOAD_4x3 << 24)));
-    NNS_G3D_ASSERT(NNS_G3dGlb.mtxmode_proj == GX_MTXMODE_PROJECTION);
-    NNS_G3D_ASSERT(NNS_G3dGlb.mtxmode_posvec == GX_MTXMODE_POSITION_VECTOR);
-    NNS_G3D_ASSERT(NNS_G3dGlb.cmd1 == ((G3OP_LIGHT_VECTOR << 0)  |
-                                       (G3OP_LIGHT_VECTOR << 8)  |
-                                       (G3OP_LIGHT_VECTOR << 16) |
-                                       (G3OP_LIGHT_VECTOR << 24)));
-    NNS_G3D_ASSERT(NNS_G3dGlb.cmd2 == ((G3OP_DIF_AMB << 0)       |
-                                       (G3OP_SPE_EMI << 8)       |
-                                       (G3OP_POLYGON_ATTR << 16) |
-                                       (G3OP_VIEWPORT << 24)));
-    NNS_G3D_ASSERT(NNS_G3dGlb.cmd3 == ((G3OP_LIGHT_COLOR << 0)  |
-                                       (G3OP_LIGHT_COLOR << 8)  |
-                                       (G3OP_LIGHT_COLOR << 16) |
-                                       (G3OP_LIGHT_COLOR << 24)));
-    NNS_G3D_ASSERT(NNS_G3dGlb.cmd4 == ((G3OP_MTX_MULT_4x3 << 0) |
-                                       (G3OP_MTX_SCALE << 8)    |
-                                       (G3OP_TEXIMAGE_PARAM << 16)));
+    assertGlbCmd_();
 
+    // The geometry engine has other light vectors after NNS_G3dGlbFlushP/VP.
+    if (!(NNS_G3dGlb.flag & NNS_G3D_GLB_FLAG_FLUSH_WVP))
+    {
+        NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_GE_LIGHTVEC_UPTODATE;
+    }
+    flag = NNS_G3dGlb.flag;
 
     // Switch to projection matrix mode and set projection matrix.
     NNS_G3dGeBufferOP_N(GX_PACK_OP(G3OP_MTX_MODE, G3OP_MTX_LOAD_4x4, G3OP_NOP, G3OP_NOP),
                         (u32*)&NNS_G3dGlb.mtxmode_proj,
-                        (sizeof(NNS_G3dGlb.mtxmode_proj) +
-                         sizeof(NNS_G3dGlb.projMtx)) / 4);
+                        GLB_SZ_PROJ_);
 
     // Multiply the camera matrix by the projection matrix
     NNS_G3dGeBufferOP_N((G3OP_MTX_MULT_4x3 << 0),
@@ -301,31 +395,97 @@ NNS_G3dGlbFlushWVP(void)
                          sizeof(NNS_G3dGlb.prmBaseScale)) / 4);
 
     NNS_G3dGeMtxMode(GX_MTXMODE_POSITION_VECTOR);
+    NNS_G3dGlb.numFlushWord += 1 + GLB_SZ_PROJ_                             +
+                               1 + sizeof(NNS_G3dGlb.cameraMtx) / 4         +
+                               1 + (sizeof(NNS_G3dGlb.prmBaseRot)   +
+                                    sizeof(NNS_G3dGlb.prmBaseTrans) +
+                                    sizeof(NNS_G3dGlb.prmBaseScale)) / 4 +
+                               2;
 
     // Apply inverse matrix of base rotation matrix to light vector (change from world to local)
+    if (!(flag & NNS_G3D_GLB_FLAG_GE_LIGHTVEC_UPTODATE))
     {
-        MtxFx43 inv;
-        int result;
-        result = MTX_Inverse33(&NNS_G3dGlb.prmBaseRot ,(MtxFx33*)&inv);
-        NNS_G3D_ASSERT(!result);
-        NNS_G3dGeLoadMtx43(&inv);
+        NNS_G3dGeLoadMtx43(getInvBaseRot_());
+        NNS_G3dGlb.numFlushWord += 1 + sizeof(MtxFx43) / 4;
+    }
+    else
+    {
+        NNS_G3dGlb.numSkipWord += 1 + sizeof(MtxFx43) / 4;
     }
 
-    NNS_G3dGeBufferData_N((u32*)&NNS_G3dGlb.cmd1, sz);
+    sendLightMaterial_(flag);
 
     NNS_G3dGeIdentity();
 
     NNS_G3dGeBufferOP_N(G3OP_TEXIMAGE_PARAM, &NNS_G3dGlb.prmTexImageParam, 1);
+    NNS_G3dGlb.numFlushWord += 1 + 2;
 
     NNS_G3dGlb.flag |= NNS_G3D_GLB_FLAG_FLUSH_WVP;
     NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_FLUSH_VP;
 
+    if (NNS_G3dGlb.flag & NNS_G3D_GLB_FLAG_DIRTY_TRACKING)
+    {
+        NNS_G3dGlb.flag |= (NNS_G3D_GLB_FLAG_GE_LIGHTVEC_UPTODATE |
+                            NNS_G3D_GLB_FLAG_GE_MATERIAL_UPTODATE |
+                            NNS_G3D_GLB_FLAG_GE_LIGHTCOLOR_UPTODATE);
+    }
+    NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_GE_PROJ_UPTODATE;
+
     //
     // After processing the command, the mode is POSITION/VECTOR.
     //
 }
 
 
+/*---------------------------------------------------------------------------*
+    NNS_G3dGlbSetDirtyTracking
+
+    Enables or disables the dirty tracking of the flushes.
+    While enabled, NNS_G3dGlbFlushP/VP/WVP do not send the projection matrix, the lights
+    and the material that the geometry engine already holds since the last flush.
+    Call NNS_G3dGlbInvalidate after changing them without G3D
+    (G3X_Reset, G3_PolygonAttr, G3_MtxMode(GX_MTXMODE_PROJECTION), etc.).
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dGlbSetDirtyTracking(BOOL isEnable)
+{
+    if (isEnable)
+    {
+        NNS_G3dGlb.flag |= NNS_G3D_GLB_FLAG_DIRTY_TRACKING;
+    }
+    else
+    {
+        NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_DIRTY_TRACKING |
+                             NNS_G3D_GLB_FLAG_GE_UPTODATE_ALL);
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dGlbInvalidate
+
+    Makes the next flush send all the state of NNS_G3dGlb to the geometry engine.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dGlbInvalidate(void)
+{
+    NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_GE_UPTODATE_ALL;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dGlbResetFlushStats
+
+    Resets the number of words sent and skipped by the flushes.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dGlbResetFlushStats(void)
+{
+    NNS_G3dGlb.numFlushWord = 0;
+    NNS_G3dGlb.numSkipWord  = 0;
+}
+
+
 /*---------------------------------------------------------------------------*
     NNS_G3dGlbSetBaseTrans
 
@@ -360,8 +520,8 @@ NNS_G3dGlbSetBaseScale(const VecFx32* pScale)
     {
         NNS_G3dGlb.prmBaseScale = *pScale;
         NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVBASE_UPTODATE      |
-                            NNS_G3D_GLB_FLAG_INVBASECAMERA_UPTODATE |
-                            NNS_G3D_GLB_FLAG_BASECAMERA_UPTODATE);
+                             NNS_G3D_GLB_FLAG_INVBASECAMERA_UPTODATE |
+                             NNS_G3D_GLB_FLAG_BASECAMERA_UPTODATE);
     }
 }
 
@@ -385,6 +545,7 @@ NNS_G3dGlbLightVector(GXLightId lightID,
     NNS_G3D_ASSERT(z >= -FX16_ONE && z < FX16_ONE);
 
     NNS_G3dGlb.lightVec[lightID] = GX_PACK_LIGHTVECTOR_PARAM(lightID, x, y, z);
+    NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_GE_LIGHTVEC_UPTODATE;
 }
 
 
@@ -400,6 +561,7 @@ NNS_G3dGlbLightColor(GXLightId lightID, GXRgb rgb)
     GXRGB_ASSERT(rgb);
 
     NNS_G3dGlb.lightColor[lightID] = GX_PACK_LIGHTCOLOR_PARAM(lightID, rgb);
+    NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_GE_LIGHTCOLOR_UPTODATE;
 }
 
 
@@ -417,6 +579,7 @@ NNS_G3dGlbMaterialColorDiffAmb(GXRgb diffuse,
     GXRGB_ASSERT(ambient);
 
     NNS_G3dGlb.prmMatColor0 = GX_PACK_DIFFAMB_PARAM(diffuse, ambient, IsSetVtxColor);
+    NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_GE_MATERIAL_UPTODATE;
 }
 
 
@@ -434,6 +597,7 @@ NNS_G3dGlbMaterialColorSpecEmi(GXRgb specular,
     GXRGB_ASSERT(emission);
 
     NNS_G3dGlb.prmMatColor1 = GX_PACK_SPECEMI_PARAM(specular, emission, IsShininess);
+    NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_GE_MATERIAL_UPTODATE;
 }
 
 
@@ -463,6 +627,7 @@ NNS_G3dGlbPolygonAttr(int light,
                                                           polygonID,
                                                           alpha,
                                                           misc);
+    NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_GE_MATERIAL_UPTODATE;
 }
 
 
@@ -91,6 +91,7 @@ NNS_G3dAnmObjInit(NNSG3dAnmObj* pAnmObj,
     pAnmObj->priority = 127;
     pAnmObj->ratio = FX32_ONE;
     pAnmObj->resTex = pResTex;
+    pAnmObj->jntAnmBatch = NULL;
     pAnmObj->numMapData = 0; // for supporting the animation disable macro (NNS_G3D_NS***_DISABLE)
     pAnmObj->funcAnm = NULL; // for supporting the animation disable macro (NNS_G3D_NS***_DISABLE)
 
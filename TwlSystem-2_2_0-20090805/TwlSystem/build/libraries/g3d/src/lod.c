@@ -0,0 +1,588 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - libraries - g3d
+  File:     lod.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#include <nnsys/g3d/lod.h>
+#include <nnsys/g3d/cull.h>
+#include <nnsys/g3d/glbstate.h>
+#include <nnsys/g3d/util.h>
+#include <nnsys/g3d/sbc.h>
+#include <nnsys/g3d/binres/res_struct_accessor.h>
+
+// Flags of the render object changed while calculating the pose
+#define LOD_CALC_FLAG_ (NNS_G3D_RENDEROBJ_FLAG_RECORD  |                  \
+                        NNS_G3D_RENDEROBJ_FLAG_NOGECMD |                  \
+                        NNS_G3D_RENDEROBJ_FLAG_SKIP_SBC_DRAW)
+
+// Size returned when the bounding sphere contains the camera
+#define LOD_SIZE_MAX_ 0x7fff
+
+static const VecFx32 vecOne_  = { FX32_ONE, FX32_ONE, FX32_ONE };
+static const VecFx32 vecZero_ = { 0, 0, 0 };
+static const MtxFx33 mtxIdentity_ =
+{
+    FX32_ONE, 0, 0,
+    0, FX32_ONE, 0,
+    0, 0, FX32_ONE
+};
+
+
+/*---------------------------------------------------------------------------*
+    lerpVec_
+
+    dst = a + (b - a) * t
+ *---------------------------------------------------------------------------*/
+static void
+lerpVec_(VecFx32* dst, const VecFx32* a, const VecFx32* b, fx32 t)
+{
+    dst->x = a->x + FX_Mul(b->x - a->x, t);
+    dst->y = a->y + FX_Mul(b->y - a->y, t);
+    dst->z = a->z + FX_Mul(b->z - a->z, t);
+}
+
+
+/*---------------------------------------------------------------------------*
+    lerpChannel_
+
+    Interpolates one vector of the joint results.
+    When the flag (the vector is def) is set in both results, only the flag is set in pDst.
+ *---------------------------------------------------------------------------*/
+static void
+lerpChannel_(NNSG3dJntAnmResult* pDst,
+             VecFx32* dst,
+             const NNSG3dJntAnmResult* pA,
+             const VecFx32* a,
+             const NNSG3dJntAnmResult* pB,
+             const VecFx32* b,
+             u32 flag,
+             const VecFx32* def,
+             fx32 t)
+{
+    if ((pA->flag & flag) && (pB->flag & flag))
+    {
+        pDst->flag |= flag;
+    }
+    else
+    {
+        lerpVec_(dst,
+                 (pA->flag & flag) ? def : a,
+                 (pB->flag & flag) ? def : b,
+                 t);
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    interpJnt_
+
+    Interpolates the joint results pA and pB (pDst = pA at t = 0, pB at t = FX32_ONE).
+    The rotation is interpolated the same way as NNSi_G3dAnmBlendJnt:
+    the X and Y axes are interpolated and the matrix is orthonormalized again.
+ *---------------------------------------------------------------------------*/
+static void
+interpJnt_(NNSG3dJntAnmResult* pDst,
+           const NNSG3dJntAnmResult* pA,
+           const NNSG3dJntAnmResult* pB,
+           fx32 t)
+{
+    pDst->flag = (NNSG3dJntAnmResultFlag)(pB->flag & NNS_G3D_JNTANM_RESULTFLAG_MAYA_SSC);
+
+    lerpChannel_(pDst, &pDst->scale, pA, &pA->scale, pB, &pB->scale,
+                 NNS_G3D_JNTANM_RESULTFLAG_SCALE_ONE, &vecOne_, t);
+    lerpChannel_(pDst, &pDst->scaleEx0, pA, &pA->scaleEx0, pB, &pB->scaleEx0,
+                 NNS_G3D_JNTANM_RESULTFLAG_SCALEEX0_ONE, &vecOne_, t);
+    lerpChannel_(pDst, &pDst->scaleEx1, pA, &pA->scaleEx1, pB, &pB->scaleEx1,
+                 NNS_G3D_JNTANM_RESULTFLAG_SCALEEX1_ONE, &vecOne_, t);
+    lerpChannel_(pDst, &pDst->trans, pA, &pA->trans, pB, &pB->trans,
+                 NNS_G3D_JNTANM_RESULTFLAG_TRANS_ZERO, &vecZero_, t);
+
+    if ((pA->flag & NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO) &&
+        (pB->flag & NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO))
+    {
+        pDst->flag |= NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO;
+    }
+    else
+    {
+        const MtxFx33* a = (pA->flag & NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO) ? &mtxIdentity_ : &pA->rot;
+        const MtxFx33* b = (pB->flag & NNS_G3D_JNTANM_RESULTFLAG_ROT_ZERO) ? &mtxIdentity_ : &pB->rot;
+        VecFx32* axisX = (VecFx32*)&pDst->rot._00;
+        VecFx32* axisY = (VecFx32*)&pDst->rot._10;
+        VecFx32* axisZ = (VecFx32*)&pDst->rot._20;
+
+        lerpVec_(axisX, (const VecFx32*)&a->_00, (const VecFx32*)&b->_00, t);
+        lerpVec_(axisY, (const VecFx32*)&a->_10, (const VecFx32*)&b->_10, t);
+        VEC_CrossProduct(axisX, axisY, axisZ);
+
+        if (axisX->x == 0 && axisX->y == 0 && axisX->z == 0)
+        {
+            // The axes were opposite. Use the newer pose.
+            MI_CpuCopy32(&b->_00, axisX, sizeof(VecFx32));
+        }
+        else
+        {
+            VEC_Normalize(axisX, axisX);
+        }
+
+        if (axisZ->x == 0 && axisZ->y == 0 && axisZ->z == 0)
+        {
+            MI_CpuCopy32(&b->_20, axisZ, sizeof(VecFx32));
+        }
+        else
+        {
+            VEC_Normalize(axisZ, axisZ);
+        }
+
+        VEC_CrossProduct(axisZ, axisX, axisY);
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    selectLevel_
+
+    Returns the level selected by the size on the screen.
+ *---------------------------------------------------------------------------*/
+static u32
+selectLevel_(const NNSG3dLodMgr* pMgr, const NNSG3dLodObj* pObj, int size)
+{
+    u32 level = 0;
+
+    while (level + 1 < pObj->numLevel && pMgr->levelSize[level] > 0)
+    {
+        int threshold = pMgr->levelSize[level];
+
+        // Going back to a more detailed level needs a margin, so that the level does not flicker.
+        if (level < pObj->level)
+        {
+            threshold += pMgr->hysteresis;
+        }
+
+        if (size >= threshold)
+        {
+            break;
+        }
+        ++level;
+    }
+    return level;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dLodObjInit
+
+    Initializes NNSG3dLodObj.
+    pBuf is the region of NNS_G3D_LODOBJ_BUFFER_SIZE(maxJnt) bytes for the poses,
+    and maxJnt is the maximum number of joints of the models of the levels.
+    Add the levels with NNS_G3dLodObjAddLevel or NNS_G3dLodObjSetMdlSet.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dLodObjInit(NNSG3dLodObj* pObj, void* pBuf, u32 maxJnt)
+{
+    NNS_G3D_NULL_ASSERT(pObj);
+    NNS_G3D_NULL_ASSERT(pBuf);
+    NNS_G3D_ASSERT(maxJnt > 0 && maxJnt <= NNS_G3D_SIZE_JNT_MAX);
+
+    MI_CpuClear32(pObj, sizeof(NNSG3dLodObj));
+
+    pObj->maxJnt = maxJnt;
+    pObj->pPrev  = (NNSG3dJntAnmResult*)pBuf;
+    pObj->pCur   = pObj->pPrev + maxJnt;
+    pObj->pOut   = pObj->pCur + maxJnt;
+
+    NNS_G3dLodObjReset(pObj);
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dLodObjAddLevel
+
+    Adds pRenderObj as the next (coarser) level and returns its level.
+    Set the animations of each level to the same frame.
+    Do not set recJntAnm on the render objects.
+ *---------------------------------------------------------------------------*/
+int
+NNS_G3dLodObjAddLevel(NNSG3dLodObj* pObj, NNSG3dRenderObj* pRenderObj)
+{
+    NNS_G3D_NULL_ASSERT(pObj);
+    NNS_G3D_NULL_ASSERT(pRenderObj);
+    NNS_G3D_NULL_ASSERT(pRenderObj->resMdl);
+    NNS_G3D_ASSERT(pObj->numLevel < NNS_G3D_LOD_MAX_LEVEL);
+    NNS_G3D_ASSERT(pRenderObj->resMdl->info.numNode <= pObj->maxJnt);
+
+    pObj->pRenderObj[pObj->numLevel] = pRenderObj;
+    return (int)pObj->numLevel++;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dLodObjSetMdlSet
+
+    Initializes pRenderObj[i] with the i-th model of pMdlSet and adds them as the levels.
+    The models of pMdlSet must be ordered from the most detailed.
+    pRenderObj must have as many elements as there are models (up to NNS_G3D_LOD_MAX_LEVEL).
+    Returns the number of levels added.
+ *---------------------------------------------------------------------------*/
+u32
+NNS_G3dLodObjSetMdlSet(NNSG3dLodObj* pObj,
+                       NNSG3dRenderObj* pRenderObj,
+                       const NNSG3dResMdlSet* pMdlSet)
+{
+    u32 i;
+    u32 num;
+
+    NNS_G3D_NULL_ASSERT(pObj);
+    NNS_G3D_NULL_ASSERT(pRenderObj);
+    NNS_G3D_NULL_ASSERT(pMdlSet);
+
+    num = pMdlSet->dict.numEntry;
+    if (num > NNS_G3D_LOD_MAX_LEVEL - pObj->numLevel)
+    {
+        num = NNS_G3D_LOD_MAX_LEVEL - pObj->numLevel;
+    }
+
+    for (i = 0; i < num; ++i)
+    {
+        NNS_G3dRenderObjInit(&pRenderObj[i], NNS_G3dGetMdlByIdx(pMdlSet, i));
+        (void)NNS_G3dLodObjAddLevel(pObj, &pRenderObj[i]);
+    }
+    return num;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dLodObjReset
+
+    Discards the poses kept for the interpolation.
+    The pose is calculated at the next draw.
+    Call this after changing the animations or their frames discontinuously.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dLodObjReset(NNSG3dLodObj* pObj)
+{
+    NNS_G3D_NULL_ASSERT(pObj);
+
+    pObj->isValid  = FALSE;
+    pObj->phase    = 0;
+    pObj->interval = 1;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dLodObjGetScrSize
+
+    Returns the size (diameter in pixels) on the screen of the bounding sphere
+    of the most detailed level, placed with the base matrix of NNS_G3dGlb.
+    The camera matrix, the projection matrix and the viewport must be set in NNS_G3dGlb.
+    Returns 0 when the model is behind the camera, and a large value
+    when the camera is inside the bounding sphere.
+ *---------------------------------------------------------------------------*/
+int
+NNS_G3dLodObjGetScrSize(const NNSG3dLodObj* pObj)
+{
+    NNSG3dCullBox  box;
+    const MtxFx43* camera;
+    VecFx32        vec;
+    VecFx32        edge;
+    fx32           radius;
+    int            x0, y0, x1, y1;
+    int            dx, dy;
+
+    NNS_G3D_NULL_ASSERT(pObj);
+    NNS_G3D_ASSERT(pObj->numLevel > 0);
+
+    NNS_G3dCullGetMdlBox(&box, pObj->pRenderObj[0]->resMdl);
+
+    // The axes of the box are orthogonal: the length of their sum is the radius.
+    VEC_Add(&box.axis[0], &box.axis[1], &vec);
+    VEC_Add(&vec, &box.axis[2], &vec);
+    radius = VEC_Mag(&vec);
+
+    camera = NNS_G3dGlbGetCameraMtx();
+
+    // Depth in camera coordinates (the camera looks toward -z)
+    MTX_MultVec43(&box.center, camera, &vec);
+    if (vec.z >= radius)
+    {
+        return 0;
+    }
+    if (vec.z > -radius)
+    {
+        return LOD_SIZE_MAX_;
+    }
+
+    // Offset the center by the radius along the X axis of the camera.
+    edge.x = box.center.x + FX_Mul(camera->_00, radius);
+    edge.y = box.center.y + FX_Mul(camera->_10, radius);
+    edge.z = box.center.z + FX_Mul(camera->_20, radius);
+
+    (void)NNS_G3dWorldPosToScrPos(&box.center, &x0, &y0);
+    (void)NNS_G3dWorldPosToScrPos(&edge, &x1, &y1);
+
+    dx = MATH_ABS(x1 - x0);
+    dy = MATH_ABS(y1 - y0);
+
+    return 2 * MATH_MAX(dx, dy);
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dLodMgrInit
+
+    Initializes NNSG3dLodMgr.
+    All the thresholds are 0 (only level 0 at the full animation rate) and there is no budget.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dLodMgrInit(NNSG3dLodMgr* pMgr)
+{
+    NNS_G3D_NULL_ASSERT(pMgr);
+
+    MI_CpuClear32(pMgr, sizeof(NNSG3dLodMgr));
+    pMgr->maxVtx = NNS_G3D_LOD_BUDGET_NONE;
+    pMgr->maxJnt = NNS_G3D_LOD_BUDGET_NONE;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dLodMgrSetLevelSize
+
+    Models smaller than size (pixels) are drawn with level + 1 or a coarser level.
+    The sizes must decrease as the level increases.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dLodMgrSetLevelSize(NNSG3dLodMgr* pMgr, int level, int size)
+{
+    NNS_G3D_NULL_ASSERT(pMgr);
+    NNS_G3D_ASSERT(level >= 0 && level < NNS_G3D_LOD_MAX_LEVEL - 1);
+    NNS_G3D_ASSERT(size >= 0);
+
+    pMgr->levelSize[level] = size;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dLodMgrSetAnmRateSize
+
+    Models smaller than size (pixels) calculate their pose every 2^(idx + 1) frames
+    (or less often if a smaller threshold also applies).
+    The sizes must decrease as idx increases.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dLodMgrSetAnmRateSize(NNSG3dLodMgr* pMgr, int idx, int size)
+{
+    NNS_G3D_NULL_ASSERT(pMgr);
+    NNS_G3D_ASSERT(idx >= 0 && idx < NNS_G3D_LOD_MAX_ANMRATE);
+    NNS_G3D_ASSERT(size >= 0);
+
+    pMgr->anmRateSize[idx] = size;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dLodMgrSetBudget
+
+    Sets the number of vertices drawn and the number of joints calculated
+    per frame (NNS_G3D_LOD_BUDGET_NONE for no limit).
+    The vertices are counted with NNSG3dResMdlInfo::numVertex
+    and the joints with NNSG3dResMdlInfo::numNode.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dLodMgrSetBudget(NNSG3dLodMgr* pMgr, u32 maxVtx, u32 maxJnt)
+{
+    NNS_G3D_NULL_ASSERT(pMgr);
+
+    pMgr->maxVtx = maxVtx;
+    pMgr->maxJnt = maxJnt;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dLodMgrBeginFrame
+
+    Resets the budgets and the statistics. Call this once at the start of every frame.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dLodMgrBeginFrame(NNSG3dLodMgr* pMgr)
+{
+    u32 i;
+    NNS_G3D_NULL_ASSERT(pMgr);
+
+    pMgr->numVtx = 0;
+    pMgr->numJnt = 0;
+
+    for (i = 0; i < NNS_G3D_LOD_MAX_LEVEL; ++i)
+    {
+        pMgr->numDraw[i] = 0;
+    }
+    pMgr->numSkip      = 0;
+    pMgr->numCoarse    = 0;
+    pMgr->numAnmCalc   = 0;
+    pMgr->numAnmInterp = 0;
+    pMgr->numAnmDefer  = 0;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dLodMgrDraw
+
+    Draws pObj with the level and the animation rate selected by its size on the screen.
+    As for NNS_G3dDraw, the base matrix of the model must be set and flushed in NNS_G3dGlb.
+    Returns FALSE when the model was not drawn because of the vertex budget.
+    The first pose of a level is always calculated, even over the joint budget.
+
+    The pose is calculated by drawing the render object once more
+    without the geometry commands (NNS_G3D_RENDEROBJ_FLAG_NOGECMD and SKIP_SBC_DRAW),
+    so the callbacks of the render object are also called in that pass.
+ *---------------------------------------------------------------------------*/
+BOOL
+NNS_G3dLodMgrDraw(NNSG3dLodMgr* pMgr, NNSG3dLodObj* pObj)
+{
+    NNSG3dRenderObj*    pRenderObj;
+    NNSG3dJntAnmResult* recJntAnm;
+    u32                 flag;
+    u32                 level;
+    u32                 interval;
+    u32                 numVtx;
+    u32                 numJnt;
+    int                 size;
+    int                 i;
+
+    NNS_G3D_NULL_ASSERT(pMgr);
+    NNS_G3D_NULL_ASSERT(pObj);
+    NNS_G3D_ASSERT(pObj->numLevel > 0);
+
+    size = NNS_G3dLodObjGetScrSize(pObj);
+    level = selectLevel_(pMgr, pObj, size);
+
+    // Use coarser levels until the model fits in the remaining vertices.
+    numVtx = pObj->pRenderObj[level]->resMdl->info.numVertex;
+    while (numVtx > pMgr->maxVtx - pMgr->numVtx)
+    {
+        if (level + 1 >= pObj->numLevel)
+        {
+            ++pMgr->numSkip;
+            return FALSE;
+        }
+        ++level;
+        ++pMgr->numCoarse;
+        numVtx = pObj->pRenderObj[level]->resMdl->info.numVertex;
+    }
+
+    interval = 1;
+    for (i = 0; i < NNS_G3D_LOD_MAX_ANMRATE; ++i)
+    {
+        if (size < pMgr->anmRateSize[i])
+        {
+            interval <<= 1;
+        }
+    }
+
+    // The poses of another level cannot be used (the joints are different).
+    if (level != pObj->level)
+    {
+        pObj->isValid = FALSE;
+    }
+
+    pObj->size  = size;
+    pObj->level = (u16)level;
+    pMgr->numVtx += numVtx;
+    ++pMgr->numDraw[level];
+
+    pRenderObj = pObj->pRenderObj[level];
+    numJnt = pRenderObj->resMdl->info.numNode;
+
+    if (interval == 1 || !pRenderObj->anmJnt)
+    {
+        // full rate
+        pObj->isValid  = FALSE;
+        pObj->interval = 1;
+        if (pRenderObj->anmJnt)
+        {
+            pMgr->numJnt += numJnt;
+            ++pMgr->numAnmCalc;
+        }
+        NNS_G3dDraw(pRenderObj);
+        return TRUE;
+    }
+
+    recJntAnm = pRenderObj->recJntAnm;
+    flag      = pRenderObj->flag & LOD_CALC_FLAG_;
+
+    pObj->interval = (u16)interval;
+    if (pObj->phase > interval)
+    {
+        pObj->phase = (u16)interval;
+    }
+
+    if (!pObj->isValid ||
+        (pObj->phase >= interval && numJnt <= pMgr->maxJnt - pMgr->numJnt))
+    {
+        NNSG3dJntAnmResult* tmp;
+
+        // Calculate the pose only (no geometry commands) and record it.
+        tmp = pObj->pPrev;
+        pObj->pPrev = pObj->pCur;
+        pObj->pCur = tmp;
+
+        pRenderObj->recJntAnm = pObj->pCur;
+        pRenderObj->flag |= LOD_CALC_FLAG_;
+        NNS_G3dDraw(pRenderObj);
+
+        if (!pObj->isValid)
+        {
+            MI_CpuCopy32(pObj->pCur, pObj->pPrev, sizeof(NNSG3dJntAnmResult) * numJnt);
+            pObj->isValid = TRUE;
+        }
+        pObj->phase = 0;
+
+        pMgr->numJnt += numJnt;
+        ++pMgr->numAnmCalc;
+    }
+    else if (pObj->phase >= interval)
+    {
+        // Keep the last pose until there are enough joints left in the budget.
+        ++pMgr->numAnmDefer;
+    }
+
+    if (pObj->phase < interval)
+    {
+        ++pObj->phase;
+    }
+
+    if (pObj->phase < interval)
+    {
+        fx32 t = (fx32)(pObj->phase * FX32_ONE / interval);
+        u32 jnt;
+
+        for (jnt = 0; jnt < numJnt; ++jnt)
+        {
+            interpJnt_(&pObj->pOut[jnt], &pObj->pPrev[jnt], &pObj->pCur[jnt], t);
+        }
+        pRenderObj->recJntAnm = pObj->pOut;
+        ++pMgr->numAnmInterp;
+    }
+    else
+    {
+        pRenderObj->recJntAnm = pObj->pCur;
+    }
+
+    // Draw with the pose in recJntAnm (played back).
+    pRenderObj->flag = (pRenderObj->flag & ~LOD_CALC_FLAG_) |
+                       (flag & ~NNS_G3D_RENDEROBJ_FLAG_RECORD);
+    NNS_G3dDraw(pRenderObj);
+
+    pRenderObj->recJntAnm = recJntAnm;
+    pRenderObj->flag = (pRenderObj->flag & ~LOD_CALC_FLAG_) | flag;
+
+    return TRUE;
+}
@@ -46,8 +46,14 @@ G3dDrawInternal_Loop_(NNSG3dRS* pRS)
 }
 
 
-static void
-G3dDrawInternal_(NNSG3dRS* pRS, NNSG3dRenderObj* pRenderObj)
+/*---------------------------------------------------------------------------*
+    NNSi_G3dRSSetup
+
+    Initializes pRS for rendering pRenderObj.
+    pRS->c points to the head of the SBC to be parsed.
+ *---------------------------------------------------------------------------*/
+void
+NNSi_G3dRSSetup(NNSG3dRS* pRS, NNSG3dRenderObj* pRenderObj)
 {
     NNS_G3D_NULL_ASSERT(pRS);
     NNS_G3D_NULL_ASSERT(pRenderObj);
@@ -130,6 +136,13 @@ G3dDrawInternal_(NNSG3dRS* pRS, NNSG3dRenderObj* pRenderObj)
     {
         pRS->flag |= NNS_G3D_RSFLAG_OPT_SKIP_SBCMTXCALC;
     }
+}
+
+
+static void
+G3dDrawInternal_(NNSG3dRS* pRS, NNSG3dRenderObj* pRenderObj)
+{
+    NNSi_G3dRSSetup(pRS, pRenderObj);
 
     if (pRenderObj->cbInitFunc)
     {
@@ -177,25 +190,13 @@ updateHintVec_(u32* pVec, const NNSG3dAnmObj* pAnmObj)
 
 
 /*---------------------------------------------------------------------------*
-    NNS_G3dDraw
+    NNSi_G3dRenderObjUpdateHint
 
-    Renders the model.
-    Settings for animation, etc., are configured ahead of time by pRenderObj operations.
+    Updates the bit vectors for "hint" when NNS_G3D_RENDEROBJ_FLAG_HINT_OBSOLETE is set.
  *---------------------------------------------------------------------------*/
 void
-NNS_G3dDraw(NNSG3dRenderObj* pRenderObj)
+NNSi_G3dRenderObjUpdateHint(NNSG3dRenderObj* pRenderObj)
 {
-    // NOTICE
-    // NOT REENTRANT
-    NNS_G3D_NULL_ASSERT(pRenderObj);
-    NNS_G3D_NULL_ASSERT(pRenderObj->resMdl);
-    NNS_G3D_ASSERTMSG(pRenderObj->resMdl->info.numMat <= NNS_G3D_SIZE_MAT_MAX,
-                      "numMaterial exceeds NNS_G3D_SIZE_MAT_MAX");
-    NNS_G3D_ASSERTMSG(pRenderObj->resMdl->info.numNode <= NNS_G3D_SIZE_JNT_MAX,
-                      "numNode exceeds NNS_G3D_SIZE_JNT_MAX");
-    NNS_G3D_ASSERTMSG(pRenderObj->resMdl->info.numShp <= NNS_G3D_SIZE_SHP_MAX,
-                      "numShape exceeds NNS_G3D_SIZE_SHP_MAX");
-
     if (NNS_G3dRenderObjTestFlag(pRenderObj, NNS_G3D_RENDEROBJ_FLAG_HINT_OBSOLETE))
     {
         // Update because the bit vector for "hint" is not correct.
@@ -212,6 +213,33 @@ NNS_G3dDraw(NNSG3dRenderObj* pRenderObj)
 
         NNS_G3dRenderObjResetFlag(pRenderObj, NNS_G3D_RENDEROBJ_FLAG_HINT_OBSOLETE);
     }
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dDraw
+
+    Renders the model.
+    Settings for animation, etc., are configured ahead of time by pRenderObj operations.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dDraw(NNSG3dRenderObj* pRenderObj)
+{
+    // NOTICE
+    // NOT REENTRANT
+    NNS_G3D_NULL_ASSERT(pRenderObj);
+    NNS_G3D_NULL_ASSERT(pRenderObj->resMdl);
+    NNS_G3D_ASSERTMSG(pRenderObj->resMdl->info.numMat <= NNS_G3D_SIZE_MAT_MAX,
+                      "numMaterial exceeds NNS_G3D_SIZE_MAT_MAX");
+    NNS_G3D_ASSERTMSG(pRenderObj->resMdl->info.numNode <= NNS_G3D_SIZE_JNT_MAX,
+                      "numNode exceeds NNS_G3D_SIZE_JNT_MAX");
+    NNS_G3D_ASSERTMSG(pRenderObj->resMdl->info.numShp <= NNS_G3D_SIZE_SHP_MAX,
+                      "numShape exceeds NNS_G3D_SIZE_SHP_MAX");
+
+    NNSi_G3dRenderObjUpdateHint(pRenderObj);
+
+    // The material commands overwrite the material of NNS_G3dGlb in the geometry engine.
+    NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_GE_MATERIAL_UPTODATE;
 
     if (NNS_G3dRS)
     {
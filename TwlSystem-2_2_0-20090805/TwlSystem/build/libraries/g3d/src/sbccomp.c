@@ -0,0 +1,642 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - libraries - g3d
+  File:     sbccomp.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#include <nnsys/g3d/sbccomp.h>
+
+#include <nnsys/g3d/sbc.h>
+#include <nnsys/g3d/glbstate.h>
+#include <nnsys/g3d/binres/res_struct_accessor.h>
+#include <nnsys/g3d/util.h>
+
+//
+// The command list is a sequence of entries that start with a header word.
+// NNS_G3D_GEREC_TAG_DATA and NNS_G3D_GEREC_TAG_DL entries are written by NNSG3dGeRecorder.
+//
+// NNS_G3D_SBCCOMP_TAG_SBC:
+//     Executes one SBC command with the interpreter.
+//     header:  bits 8-15 are the mask of NNSG3dRSFlag to set, bits 0-7 are their values
+//     word 1:  currentNode | (currentMat << 8)
+//     word 2:  offset of the SBC command from the head of the SBC
+// NNS_G3D_SBCCOMP_TAG_END:
+//     End of the command list.
+//
+#define NNS_G3D_SBCCOMP_TAG_END 0x00000000
+#define NNS_G3D_SBCCOMP_TAG_SBC 0x03000000
+
+// NNSG3dRSFlag set at the head of NNS_G3D_SBCCOMP_TAG_SBC
+#define NNS_G3D_SBCCOMP_RSFLAG_MASK (NNS_G3D_RSFLAG_NODE_VISIBLE       | \
+                                     NNS_G3D_RSFLAG_MAT_TRANSPARENT    | \
+                                     NNS_G3D_RSFLAG_CURRENT_NODE_VALID | \
+                                     NNS_G3D_RSFLAG_CURRENT_MAT_VALID)
+
+//
+// Default handlers of the SBC commands.
+// The SBC is not compiled when the handlers in NNS_G3dFuncSbcTable have been replaced.
+//
+static const NNSG3dFuncSbc sDefaultFuncSbc_[] =
+{
+    &NNSi_G3dFuncSbc_NOP,
+    &NNSi_G3dFuncSbc_RET,
+    &NNSi_G3dFuncSbc_NODE,
+    &NNSi_G3dFuncSbc_MTX,
+    &NNSi_G3dFuncSbc_MAT,
+    &NNSi_G3dFuncSbc_SHP,
+    &NNSi_G3dFuncSbc_NODEDESC,
+    &NNSi_G3dFuncSbc_BB,
+
+    &NNSi_G3dFuncSbc_BBY,
+    &NNSi_G3dFuncSbc_NODEMIX,
+    &NNSi_G3dFuncSbc_CALLDL,
+    &NNSi_G3dFuncSbc_POSSCALE,
+    &NNSi_G3dFuncSbc_ENVMAP,
+    &NNSi_G3dFuncSbc_PRJMAP
+};
+
+#define NNS_G3D_SBCCOMP_NUM_FUNCSBC (sizeof(sDefaultFuncSbc_) / sizeof(sDefaultFuncSbc_[0]))
+
+
+/*---------------------------------------------------------------------------*
+    getCmdLen_
+
+    Returns the length in bytes of the SBC command at c.
+    Returns 0 for an unknown command.
+ *---------------------------------------------------------------------------*/
+static u32
+getCmdLen_(const u8* c)
+{
+    u32 opt = NNS_G3D_GET_SBCFLG(*c);
+    u32 numMtxIdx = 0;
+
+    // idxMtxSrc and idxMtxDest of NODEDESC, BB and BBY
+    if (opt == NNS_G3D_SBCFLG_001 || opt == NNS_G3D_SBCFLG_011)
+    {
+        ++numMtxIdx;
+    }
+    if (opt == NNS_G3D_SBCFLG_010 || opt == NNS_G3D_SBCFLG_011)
+    {
+        ++numMtxIdx;
+    }
+
+    switch(NNS_G3D_GET_SBCCMD(*c))
+    {
+    case NNS_G3D_SBC_NOP:
+    case NNS_G3D_SBC_RET:
+    case NNS_G3D_SBC_POSSCALE:
+        return 1;
+    case NNS_G3D_SBC_MTX:
+    case NNS_G3D_SBC_MAT:
+    case NNS_G3D_SBC_SHP:
+        return 2;
+    case NNS_G3D_SBC_NODE:
+    case NNS_G3D_SBC_ENVMAP:
+    case NNS_G3D_SBC_PRJMAP:
+        return 3;
+    case NNS_G3D_SBC_NODEDESC:
+        return 4 + numMtxIdx;
+    case NNS_G3D_SBC_BB:
+    case NNS_G3D_SBC_BBY:
+        return 2 + numMtxIdx;
+    case NNS_G3D_SBC_NODEMIX:
+        return 3 + *(c + 2) * 3U;
+    case NNS_G3D_SBC_CALLDL:
+        return 1 + sizeof(u32) + sizeof(u32);
+    default:
+        return 0;
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    isCompilable_
+
+    Returns whether pRenderObj is in a state that can be rendered with a compiled SBC.
+ *---------------------------------------------------------------------------*/
+static BOOL
+isCompilable_(const NNSG3dRenderObj* pRenderObj)
+{
+    u32 i;
+
+    if ((pRenderObj->cbFunc && pRenderObj->cbCmd < NNS_G3D_SBC_COMMAND_NUM) ||
+        pRenderObj->cbInitFunc)
+    {
+        return FALSE;
+    }
+
+    if (pRenderObj->flag & (NNS_G3D_RENDEROBJ_FLAG_RECORD        |
+                            NNS_G3D_RENDEROBJ_FLAG_NOGECMD       |
+                            NNS_G3D_RENDEROBJ_FLAG_SKIP_SBC_DRAW |
+                            NNS_G3D_RENDEROBJ_FLAG_SKIP_SBC_MTXCALC))
+    {
+        return FALSE;
+    }
+
+    // Which nodes are visible must be known at the time of the compile.
+    if (pRenderObj->anmVis)
+    {
+        return FALSE;
+    }
+
+    for (i = 0; i < NNS_G3D_SBCCOMP_NUM_FUNCSBC; ++i)
+    {
+        if (NNS_G3dFuncSbcTable[i] != sDefaultFuncSbc_[i])
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+
+/*---------------------------------------------------------------------------*
+    isMatAnimated_
+
+    Returns whether the results of the MAT command of idxMat can change from frame to frame.
+ *---------------------------------------------------------------------------*/
+static BOOL
+isMatAnimated_(const NNSG3dRenderObj* pRenderObj, u32 idxMat)
+{
+    if (pRenderObj->recMatAnm)
+    {
+        return TRUE;
+    }
+
+    if (!pRenderObj->anmMat)
+    {
+        return FALSE;
+    }
+
+    return pRenderObj->funcBlendMat != &NNSi_G3dAnmBlendMat ||
+           NNSi_G3dBitVecCheck(&pRenderObj->hintMatAnmExist[0], idxMat);
+}
+
+
+/*---------------------------------------------------------------------------*
+    isJntAnimated_
+
+    Returns whether the results of the NODEDESC command of idxNode can change from frame to frame.
+    In the case of Maya SSC and Si3d, the results of a joint depend on its parent,
+    so all the joints are handled as animated.
+ *---------------------------------------------------------------------------*/
+static BOOL
+isJntAnimated_(const NNSG3dRenderObj* pRenderObj, u32 idxNode)
+{
+    if (pRenderObj->recJntAnm)
+    {
+        return TRUE;
+    }
+
+    if (!pRenderObj->anmJnt)
+    {
+        return FALSE;
+    }
+
+    return pRenderObj->funcBlendJnt != &NNSi_G3dAnmBlendJnt ||
+           pRenderObj->resMdl->info.scalingRule != NNS_G3D_SCALINGRULE_STANDARD ||
+           NNSi_G3dBitVecCheck(&pRenderObj->hintJntAnmExist[0], idxNode);
+}
+
+
+/*---------------------------------------------------------------------------*
+    recordSbc_
+
+    Records the NNS_G3D_SBCCOMP_TAG_SBC entry of the SBC command at rs->c.
+    isTransKnown is FALSE when NNS_G3D_RSFLAG_MAT_TRANSPARENT depends on an animated material.
+ *---------------------------------------------------------------------------*/
+static void
+recordSbc_(NNSG3dGeRecorder* pRec,
+           const NNSG3dRS* rs,
+           const u8* sbc,
+           BOOL isTransKnown)
+{
+    u32 mask = NNS_G3D_SBCCOMP_RSFLAG_MASK;
+    if (!isTransKnown)
+    {
+        mask &= ~NNS_G3D_RSFLAG_MAT_TRANSPARENT;
+    }
+
+    // Close the NNS_G3D_GEREC_TAG_DATA entry.
+    pRec->idxData = NNS_G3D_GEREC_NO_DATA;
+
+    NNSi_G3dGeRecordWord(pRec, NNS_G3D_SBCCOMP_TAG_SBC | (mask << 8) | (rs->flag & mask));
+    NNSi_G3dGeRecordWord(pRec, rs->currentNode | ((u32)rs->currentMat << 8));
+    NNSi_G3dGeRecordWord(pRec, (u32)(rs->c - sbc));
+}
+
+
+/*---------------------------------------------------------------------------*
+    compile_
+
+    Executes the SBC at rs->c while recording the geometry commands.
+    The SBC commands whose results can change from frame to frame are not executed, and are recorded as
+    NNS_G3D_SBCCOMP_TAG_SBC entries instead.
+    Returns FALSE when the SBC cannot be compiled.
+ *---------------------------------------------------------------------------*/
+static BOOL
+compile_(NNSG3dRS* rs, NNSG3dGeRecorder* pRec, NNSG3dCompiledSbc* pComp)
+{
+    const NNSG3dRenderObj* pRenderObj = rs->pRenderObj;
+    const u8* sbc = rs->c;
+    const u8* c;
+    BOOL isMatAnimatedAll = FALSE;
+    BOOL isTransKnown = TRUE;
+
+    pComp->numCmd = 0;
+    pComp->numInterpCmd = 0;
+
+    //
+    // ENVMAP and PRJMAP use the result of the previous MAT command,
+    // so the MAT commands must be executed at rendering time.
+    //
+    for (c = sbc; NNS_G3D_GET_SBCCMD(*c) != NNS_G3D_SBC_RET; c += getCmdLen_(c))
+    {
+        if (getCmdLen_(c) == 0)
+        {
+            return FALSE;
+        }
+
+        if (NNS_G3D_GET_SBCCMD(*c) == NNS_G3D_SBC_ENVMAP ||
+            NNS_G3D_GET_SBCCMD(*c) == NNS_G3D_SBC_PRJMAP)
+        {
+            isMatAnimatedAll = TRUE;
+        }
+    }
+
+    while(NNS_G3D_GET_SBCCMD(*rs->c) != NNS_G3D_SBC_RET)
+    {
+        u32  cmd = NNS_G3D_GET_SBCCMD(*rs->c);
+        u32  len = getCmdLen_(rs->c);
+        BOOL isInterp = FALSE;
+
+        ++pComp->numCmd;
+
+        switch(cmd)
+        {
+        case NNS_G3D_SBC_MAT:
+            {
+                u32 idxMat = *(rs->c + 1);
+                const NNSG3dResMatData* mat = NNS_G3dGetMatDataByIdx(rs->pResMat, idxMat);
+
+                if (NNS_G3dFuncSbcMatTable[mat->itemTag] != &NNSi_G3dFuncSbc_MAT_InternalDefault)
+                {
+                    return FALSE;
+                }
+
+                // Same condition as NNSi_G3dFuncSbc_MAT
+                if ((rs->flag & NNS_G3D_RSFLAG_NODE_VISIBLE) ||
+                    !((rs->flag & NNS_G3D_RSFLAG_CURRENT_MAT_VALID) &&
+                    (idxMat == rs->currentMat)))
+                {
+                    if (isMatAnimatedAll || isMatAnimated_(pRenderObj, idxMat))
+                    {
+                        recordSbc_(pRec, rs, sbc, isTransKnown);
+                        rs->currentMat = (u8)idxMat;
+                        rs->flag |= NNS_G3D_RSFLAG_CURRENT_MAT_VALID;
+
+                        // Whether the material is transparent is only known at rendering time.
+                        isTransKnown = FALSE;
+                        isInterp = TRUE;
+                    }
+                    else
+                    {
+                        isTransKnown = TRUE;
+                    }
+                }
+            }
+            break;
+
+        case NNS_G3D_SBC_SHP:
+            {
+                const NNSG3dResShpData* shp =
+                    NNS_G3dGetShpDataByIdx(rs->pResShp, *(rs->c + 1));
+
+                if (NNS_G3dFuncSbcShpTable[shp->itemTag] != &NNSi_G3dFuncSbc_SHP_InternalDefault)
+                {
+                    return FALSE;
+                }
+
+                if (!isTransKnown && (rs->flag & NNS_G3D_RSFLAG_NODE_VISIBLE))
+                {
+                    recordSbc_(pRec, rs, sbc, isTransKnown);
+                    isInterp = TRUE;
+                }
+            }
+            break;
+
+        case NNS_G3D_SBC_NODEDESC:
+            if (isJntAnimated_(pRenderObj, *(rs->c + 1)))
+            {
+                recordSbc_(pRec, rs, sbc, isTransKnown);
+                rs->currentNodeDesc = *(rs->c + 1);
+                rs->flag |= NNS_G3D_RSFLAG_CURRENT_NODEDESC_VALID;
+                isInterp = TRUE;
+            }
+            break;
+
+        case NNS_G3D_SBC_BB:
+        case NNS_G3D_SBC_BBY:
+        case NNS_G3D_SBC_NODEMIX:
+        case NNS_G3D_SBC_ENVMAP:
+        case NNS_G3D_SBC_PRJMAP:
+            // These commands read the matrices in the geometry engine.
+            recordSbc_(pRec, rs, sbc, isTransKnown);
+            isInterp = TRUE;
+            break;
+
+        default:
+            // NOP, NODE, MTX, CALLDL, POSSCALE
+            break;
+        }
+
+        if (isInterp)
+        {
+            ++pComp->numInterpCmd;
+            rs->c += len;
+        }
+        else
+        {
+            // Execute and record the geometry commands.
+            rs->flag &= ~NNS_G3D_RSFLAG_SKIP;
+            (*NNS_G3dFuncSbcTable[cmd])(rs, NNS_G3D_GET_SBCFLG(*rs->c));
+        }
+    }
+
+    return TRUE;
+}
+
+
+/*---------------------------------------------------------------------------*
+    drawCode_
+
+    Sends the command list of pComp.
+    rs is only used when the command list has NNS_G3D_SBCCOMP_TAG_SBC entries.
+ *---------------------------------------------------------------------------*/
+static void
+drawCode_(NNSG3dRS* rs, const NNSG3dCompiledSbc* pComp)
+{
+    const u32* p = pComp->pCode;
+
+    for (;;)
+    {
+        u32 header = *p;
+
+        switch(header & NNS_G3D_GEREC_TAG_MASK)
+        {
+        case NNS_G3D_GEREC_TAG_DATA:
+            NNS_G3dGeSendDL(p + 1, (header & NNS_G3D_GEREC_SIZE_MASK) << 2);
+            p += 1 + (header & NNS_G3D_GEREC_SIZE_MASK);
+            break;
+
+        case NNS_G3D_GEREC_TAG_DL:
+            NNS_G3dGeSendDL((const void*)*(p + 1), *(p + 2));
+            p += 3;
+            break;
+
+        case NNS_G3D_SBCCOMP_TAG_SBC:
+            {
+                u32 mask = (header >> 8) & 0xff;
+
+                NNS_G3D_NULL_ASSERT(rs);
+                rs->flag = (rs->flag & ~(mask | NNS_G3D_RSFLAG_SKIP)) | (header & mask);
+                rs->currentNode = (u8)*(p + 1);
+                rs->currentMat  = (u8)(*(p + 1) >> 8);
+                rs->c = (u8*)pComp->sbc + *(p + 2);
+
+                (*NNS_G3dFuncSbcTable[NNS_G3D_GET_SBCCMD(*rs->c)])
+                                        (rs, NNS_G3D_GET_SBCFLG(*rs->c));
+                p += 3;
+            }
+            break;
+
+        default:
+            // NNS_G3D_SBCCOMP_TAG_END
+            return;
+        }
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dCompileSbc
+
+    Compiles the SBC of pRenderObj into a command list specialized for its current animation bindings,
+    and sets it in pComp.
+    The command list is written to pBuf (szBuf bytes).
+    The buffer is read by DMA, so do not allocate it in DTCM.
+
+    Returns the size in bytes of the command list.
+    When pBuf is NULL or smaller than the return value, nothing is set in pComp,
+    so allocate a buffer of the returned size and call the function again.
+    Returns 0 when pRenderObj cannot be compiled. In that case, render with NNS_G3dDraw.
+
+    The SBC is not compiled in the following cases:
+    - Callbacks are set on pRenderObj.
+    - NNS_G3D_RENDEROBJ_FLAG_RECORD, NOGECMD, SKIP_SBC_DRAW or SKIP_SBC_MTXCALC is set on pRenderObj.
+    - A visibility animation is bound to pRenderObj.
+    - The SBC command handlers have been replaced.
+
+    Do not call this function while rendering.
+ *---------------------------------------------------------------------------*/
+u32
+NNS_G3dCompileSbc(NNSG3dCompiledSbc* pComp,
+                  void* pBuf,
+                  u32 szBuf,
+                  NNSG3dRenderObj* pRenderObj,
+                  u32 flag)
+{
+    NNSG3dRS         rs;
+    NNSG3dRS*        pRSOld;
+    NNSG3dGeRecorder rec;
+    BOOL             isOK;
+    u32              szCode;
+
+    NNS_G3D_NULL_ASSERT(pComp);
+    NNS_G3D_NULL_ASSERT(pRenderObj);
+    NNS_G3D_NULL_ASSERT(pRenderObj->resMdl);
+
+    pComp->pCode  = NULL;
+    pComp->szCode = 0;
+
+    if (!isCompilable_(pRenderObj))
+    {
+        return 0;
+    }
+
+    NNSi_G3dRenderObjUpdateHint(pRenderObj);
+
+    rec.pBuf     = (u32*)pBuf;
+    rec.szBuf    = szBuf / sizeof(u32);
+    rec.idx      = 0;
+    rec.isCopyDL = (flag & NNS_G3D_SBCCOMP_FLAG_COPY_DL) ? TRUE : FALSE;
+
+    // The functions called from the SBC commands refer to NNS_G3dRS.
+    pRSOld = NNS_G3dRS;
+    NNS_G3dRS = &rs;
+    NNSi_G3dRSSetup(&rs, pRenderObj);
+    pComp->sbc = rs.c;
+
+    NNSi_G3dGeBeginRecord(&rec);
+    isOK = compile_(&rs, &rec, pComp);
+    NNSi_G3dGeEndRecord();
+    NNSi_G3dGeRecordWord(&rec, NNS_G3D_SBCCOMP_TAG_END);
+
+    NNS_G3dRS = pRSOld;
+
+    if (!isOK)
+    {
+        return 0;
+    }
+
+    szCode = rec.idx * sizeof(u32);
+    if (pBuf && szCode <= szBuf)
+    {
+        pComp->pCode  = (const u32*)pBuf;
+        pComp->szCode = szCode;
+        pComp->resMdl = pRenderObj->resMdl;
+
+        pComp->anmMat       = pRenderObj->anmMat;
+        pComp->anmJnt       = pRenderObj->anmJnt;
+        pComp->funcBlendMat = pRenderObj->funcBlendMat;
+        pComp->funcBlendJnt = pRenderObj->funcBlendJnt;
+        pComp->recMatAnm    = pRenderObj->recMatAnm;
+        pComp->recJntAnm    = pRenderObj->recJntAnm;
+        MI_CpuCopy32(&pRenderObj->hintMatAnmExist[0],
+                     &pComp->hintMatAnmExist[0],
+                     sizeof(pComp->hintMatAnmExist));
+        MI_CpuCopy32(&pRenderObj->hintJntAnmExist[0],
+                     &pComp->hintJntAnmExist[0],
+                     sizeof(pComp->hintJntAnmExist));
+
+        pComp->prmMatColor0   = NNS_G3dGlb.prmMatColor0;
+        pComp->prmMatColor1   = NNS_G3dGlb.prmMatColor1;
+        pComp->prmPolygonAttr = NNS_G3dGlb.prmPolygonAttr;
+
+        // The command list is sent by DMA.
+        DC_StoreRange(pBuf, szCode);
+    }
+    return szCode;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dCompiledSbcIsValid
+
+    Returns whether pRenderObj can be rendered with pComp.
+    Returns FALSE when pRenderObj is not in the state it was in when pComp was compiled.
+ *---------------------------------------------------------------------------*/
+BOOL
+NNS_G3dCompiledSbcIsValid(const NNSG3dCompiledSbc* pComp,
+                          NNSG3dRenderObj* pRenderObj)
+{
+    const u8* sbc;
+    u32 i;
+
+    NNS_G3D_NULL_ASSERT(pComp);
+    NNS_G3D_NULL_ASSERT(pRenderObj);
+
+    if (!pComp->pCode ||
+        pComp->resMdl != pRenderObj->resMdl ||
+        !isCompilable_(pRenderObj))
+    {
+        return FALSE;
+    }
+
+    sbc = pRenderObj->ptrUserSbc ?
+              pRenderObj->ptrUserSbc :
+              (const u8*)pRenderObj->resMdl + pRenderObj->resMdl->ofsSbc;
+
+    if (sbc != pComp->sbc                                      ||
+        !pComp->anmMat    != !pRenderObj->anmMat               ||
+        !pComp->anmJnt    != !pRenderObj->anmJnt               ||
+        !pComp->recMatAnm != !pRenderObj->recMatAnm            ||
+        !pComp->recJntAnm != !pRenderObj->recJntAnm            ||
+        pComp->funcBlendMat != pRenderObj->funcBlendMat        ||
+        pComp->funcBlendJnt != pRenderObj->funcBlendJnt        ||
+        pComp->prmMatColor0 != NNS_G3dGlb.prmMatColor0         ||
+        pComp->prmMatColor1 != NNS_G3dGlb.prmMatColor1         ||
+        pComp->prmPolygonAttr != NNS_G3dGlb.prmPolygonAttr)
+    {
+        return FALSE;
+    }
+
+    NNSi_G3dRenderObjUpdateHint(pRenderObj);
+
+    for (i = 0; i < NNS_G3D_SIZE_MAT_MAX / 32; ++i)
+    {
+        if (pComp->hintMatAnmExist[i] != pRenderObj->hintMatAnmExist[i])
+        {
+            return FALSE;
+        }
+    }
+
+    for (i = 0; i < NNS_G3D_SIZE_JNT_MAX / 32; ++i)
+    {
+        if (pComp->hintJntAnmExist[i] != pRenderObj->hintJntAnmExist[i])
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dDrawCompiledSbc
+
+    Renders pRenderObj with the command list of pComp.
+    When pComp cannot be used for pRenderObj, renders with NNS_G3dDraw instead.
+    Returns TRUE when the command list was used.
+ *---------------------------------------------------------------------------*/
+BOOL
+NNS_G3dDrawCompiledSbc(NNSG3dRenderObj* pRenderObj,
+                       const NNSG3dCompiledSbc* pComp)
+{
+    // NOTICE
+    // NOT REENTRANT
+    NNS_G3D_NULL_ASSERT(pRenderObj);
+    NNS_G3D_NULL_ASSERT(pComp);
+
+    if (!NNS_G3dCompiledSbcIsValid(pComp, pRenderObj))
+    {
+        NNS_G3dDraw(pRenderObj);
+        return FALSE;
+    }
+
+    // The material commands overwrite the material of NNS_G3dGlb in the geometry engine.
+    NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_GE_MATERIAL_UPTODATE;
+
+    if (pComp->numInterpCmd == 0)
+    {
+        // The interpreter is not used.
+        drawCode_(NULL, pComp);
+    }
+    else if (NNS_G3dRS)
+    {
+        NNSi_G3dRSSetup(NNS_G3dRS, pRenderObj);
+        drawCode_(NNS_G3dRS, pComp);
+    }
+    else
+    {
+        // Take onto local stack if SBC runtime structure region has not been secured.
+        NNSG3dRS rs;
+        NNS_G3dRS = &rs;
+        NNSi_G3dRSSetup(&rs, pRenderObj);
+        drawCode_(&rs, pComp);
+        NNS_G3dRS = NULL;
+    }
+
+    return TRUE;
+}
@@ -0,0 +1,589 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - libraries - g3d
+  File:     texstream.c
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#include <nnsys/g3d/texstream.h>
+#include <nnsys/gfd.h>
+#include <nnsys/g3d/binres/res_struct_accessor.h>
+
+// Number of the data transferred per entry (texture, 4x4 texture, palette index, palette)
+#define TEXSTREAM_NUM_SEG_ 4
+
+
+/*---------------------------------------------------------------------------*
+    getSeg_
+
+    Gets the destination, the source and the size of the idxSeg-th data of pTex.
+    The size is 0 when pTex does not have the data.
+ *---------------------------------------------------------------------------*/
+static void
+getSeg_(const NNSG3dResTex* pTex,
+        u32 idxSeg,
+        NNS_GFD_DST_TYPE* pType,
+        u32* pDstAddr,
+        const u8** ppSrc,
+        u32* pSize)
+{
+    switch(idxSeg)
+    {
+    case 0:
+        *pType    = NNS_GFD_DST_3D_TEX_VRAM;
+        *pSize    = (u32)pTex->texInfo.sizeTex << 3;
+        *pDstAddr = NNS_GfdGetTexKeyAddr(pTex->texInfo.vramKey);
+        *ppSrc    = (const u8*)NNS_G3dGetTexData(pTex);
+        break;
+    case 1:
+        *pType    = NNS_GFD_DST_3D_TEX_VRAM;
+        *pSize    = (u32)pTex->tex4x4Info.sizeTex << 3;
+        *pDstAddr = NNS_GfdGetTexKeyAddr(pTex->tex4x4Info.vramKey);
+        *ppSrc    = (const u8*)NNS_G3dGetTex4x4Data(pTex);
+        break;
+    case 2:
+        *pType    = NNS_GFD_DST_3D_TEX_VRAM;
+        *pSize    = (u32)pTex->tex4x4Info.sizeTex << 2;
+        *pDstAddr = GX_COMP4x4_PLTT_IDX(NNS_GfdGetTexKeyAddr(pTex->tex4x4Info.vramKey));
+        *ppSrc    = (const u8*)NNS_G3dGetTex4x4PlttIdxData(pTex);
+        break;
+    default:
+        *pType    = NNS_GFD_DST_3D_TEX_PLTT;
+        *pSize    = (u32)pTex->plttInfo.sizePltt << 3;
+        *pDstAddr = NNS_GfdGetPlttKeyAddr(pTex->plttInfo.vramKey);
+        *ppSrc    = (const u8*)NNS_G3dGetPlttData(pTex);
+        break;
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    bindEntry_
+
+    Binds the textures and the palettes of the entry to its models by name,
+    so that a model can use the textures of several entries.
+ *---------------------------------------------------------------------------*/
+static void
+bindEntry_(NNSG3dTexStreamEntry* pEntry)
+{
+    NNSG3dResTex* pTex = pEntry->pTex;
+    u32 numPltt;
+    u32 i, j;
+
+    numPltt = (pTex->plttInfo.ofsDict != 0) ?
+              ((const NNSG3dResDict*)((u8*)pTex + pTex->plttInfo.ofsDict))->numEntry : 0;
+
+    for (i = 0; i < pEntry->numMdl; ++i)
+    {
+        for (j = 0; j < pTex->dict.numEntry; ++j)
+        {
+            (void)NNS_G3dBindMdlTexEx(pEntry->pMdl[i], pTex, NNS_G3dGetTexNameByIdx(pTex, j));
+        }
+        for (j = 0; j < numPltt; ++j)
+        {
+            (void)NNS_G3dBindMdlPlttEx(pEntry->pMdl[i], pTex, NNS_G3dGetPlttNameByIdx(pTex, j));
+        }
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    releaseEntry_
+
+    Releases the bindings of the models and the VRAM of the entry.
+ *---------------------------------------------------------------------------*/
+static void
+releaseEntry_(NNSG3dTexStream* pStream, NNSG3dTexStreamEntry* pEntry)
+{
+    NNSG3dResTex* pTex = pEntry->pTex;
+    NNSG3dTexKey  texKey, tex4x4Key;
+    NNSG3dPlttKey plttKey;
+    int status;
+    u32 numPltt;
+    u32 i, j;
+
+    if (pEntry->state == NNS_G3D_TEXSTREAM_STATE_NONE)
+    {
+        return;
+    }
+
+    if (pEntry->state == NNS_G3D_TEXSTREAM_STATE_RESIDENT)
+    {
+        numPltt = (pTex->plttInfo.ofsDict != 0) ?
+                  ((const NNSG3dResDict*)((u8*)pTex + pTex->plttInfo.ofsDict))->numEntry : 0;
+
+        for (i = 0; i < pEntry->numMdl; ++i)
+        {
+            for (j = 0; j < pTex->dict.numEntry; ++j)
+            {
+                (void)NNS_G3dReleaseMdlTexEx(pEntry->pMdl[i], NNS_G3dGetTexNameByIdx(pTex, j));
+            }
+            for (j = 0; j < numPltt; ++j)
+            {
+                (void)NNS_G3dReleaseMdlPlttEx(pEntry->pMdl[i], NNS_G3dGetPlttNameByIdx(pTex, j));
+            }
+        }
+    }
+
+    plttKey = NNS_G3dPlttReleasePlttKey(pTex);
+    NNS_G3dTexReleaseTexKey(pTex, &texKey, &tex4x4Key);
+
+    if (plttKey > 0)
+    {
+        status = NNS_GfdFreePlttVram(plttKey);
+        NNS_G3D_ASSERTMSG(!status, "NNS_GfdFreePlttVram failed");
+    }
+
+    if (tex4x4Key > 0)
+    {
+        status = NNS_GfdFreeTexVram(tex4x4Key);
+        NNS_G3D_ASSERTMSG(!status, "NNS_GfdFreeTexVram failed");
+    }
+
+    if (texKey > 0)
+    {
+        status = NNS_GfdFreeTexVram(texKey);
+        NNS_G3D_ASSERTMSG(!status, "NNS_GfdFreeTexVram failed");
+    }
+
+    pStream->szResident -= pEntry->size;
+    pEntry->state = NNS_G3D_TEXSTREAM_STATE_NONE;
+}
+
+
+/*---------------------------------------------------------------------------*
+    allocEntry_
+
+    Allocates VRAM for the texture block of the entry and sets the keys.
+    Returns FALSE (nothing allocated) when the VRAM managers fail.
+ *---------------------------------------------------------------------------*/
+static BOOL
+allocEntry_(NNSG3dTexStream* pStream, NNSG3dTexStreamEntry* pEntry)
+{
+    NNSG3dResTex* pTex = pEntry->pTex;
+    u32 szTex, szTex4x4, szPltt;
+    NNSG3dTexKey  keyTex    = 0;
+    NNSG3dTexKey  keyTex4x4 = 0;
+    NNSG3dPlttKey keyPltt   = 0;
+    BOOL sucTex    = TRUE;
+    BOOL sucTex4x4 = TRUE;
+    BOOL sucPltt   = TRUE;
+
+    szTex    = NNS_G3dTexGetRequiredSize(pTex);
+    szTex4x4 = NNS_G3dTex4x4GetRequiredSize(pTex);
+    szPltt   = NNS_G3dPlttGetRequiredSize(pTex);
+
+    if (szTex > 0)
+    {
+        keyTex = NNS_GfdAllocTexVram(szTex, FALSE, 0);
+        sucTex = (keyTex != NNS_GFD_ALLOC_ERROR_TEXKEY);
+    }
+
+    if (szTex4x4 > 0)
+    {
+        keyTex4x4 = NNS_GfdAllocTexVram(szTex4x4, TRUE, 0);
+        sucTex4x4 = (keyTex4x4 != NNS_GFD_ALLOC_ERROR_TEXKEY);
+    }
+
+    if (szPltt > 0)
+    {
+        keyPltt = NNS_GfdAllocPlttVram(szPltt,
+                                       pTex->tex4x4Info.flag & NNS_G3D_RESPLTT_USEPLTT4,
+                                       0);
+        sucPltt = (keyPltt != NNS_GFD_ALLOC_ERROR_PLTTKEY);
+    }
+
+    if (!sucTex || !sucTex4x4 || !sucPltt)
+    {
+        // Rollback process when fails
+        int status;
+
+        if (sucPltt && keyPltt > 0)
+        {
+            status = NNS_GfdFreePlttVram(keyPltt);
+            NNS_G3D_ASSERTMSG(!status, "NNS_GfdFreePlttVram failed");
+        }
+
+        if (sucTex4x4 && keyTex4x4 > 0)
+        {
+            status = NNS_GfdFreeTexVram(keyTex4x4);
+            NNS_G3D_ASSERTMSG(!status, "NNS_GfdFreeTexVram failed");
+        }
+
+        if (sucTex && keyTex > 0)
+        {
+            status = NNS_GfdFreeTexVram(keyTex);
+            NNS_G3D_ASSERTMSG(!status, "NNS_GfdFreeTexVram failed");
+        }
+
+        return FALSE;
+    }
+
+    NNS_G3dTexSetTexKey(pTex, keyTex, keyTex4x4);
+    NNS_G3dPlttSetPlttKey(pTex, keyPltt);
+
+    pEntry->size = szTex + szTex4x4 + (szTex4x4 >> 1) + szPltt;
+    pStream->szResident += pEntry->size;
+    return TRUE;
+}
+
+
+/*---------------------------------------------------------------------------*
+    evictLru_
+
+    Releases the entry in VRAM least recently used, except the entries used
+    in this frame and the last one (the rendering engine may still read them).
+    Returns FALSE when there is no entry to release.
+ *---------------------------------------------------------------------------*/
+static BOOL
+evictLru_(NNSG3dTexStream* pStream)
+{
+    NNSG3dTexStreamEntry* pLru = NULL;
+    u32 i;
+
+    for (i = 0; i < pStream->numEntry; ++i)
+    {
+        NNSG3dTexStreamEntry* p = &pStream->pEntry[i];
+
+        if (p->state == NNS_G3D_TEXSTREAM_STATE_RESIDENT &&
+            p->frameUsed + 1 < pStream->frame &&
+            (!pLru || p->frameUsed < pLru->frameUsed))
+        {
+            pLru = p;
+        }
+    }
+
+    if (!pLru)
+    {
+        return FALSE;
+    }
+
+    releaseEntry_(pStream, pLru);
+    ++pStream->numEvict;
+    return TRUE;
+}
+
+
+/*---------------------------------------------------------------------------*
+    sendEntry_
+
+    Registers the data of the entry in the VRAM transfer manager,
+    up to *pRemain bytes (decremented).
+    The state becomes NNS_G3D_TEXSTREAM_STATE_TRANSFER after the last data.
+    Returns FALSE when the task queue of the transfer manager is full.
+ *---------------------------------------------------------------------------*/
+static BOOL
+sendEntry_(NNSG3dTexStream* pStream, NNSG3dTexStreamEntry* pEntry, u32* pRemain)
+{
+    while (pEntry->idxSeg < TEXSTREAM_NUM_SEG_)
+    {
+        NNS_GFD_DST_TYPE type;
+        u32 dstAddr;
+        const u8* pSrc;
+        u32 size;
+        u32 sz;
+
+        getSeg_(pEntry->pTex, pEntry->idxSeg, &type, &dstAddr, &pSrc, &size);
+
+        if (pEntry->ofsSeg < size)
+        {
+            sz = size - pEntry->ofsSeg;
+            if (sz > *pRemain)
+            {
+                // The data is 8 byte aligned: split on 8 bytes.
+                sz = *pRemain & ~7;
+                if (sz == 0)
+                {
+                    return TRUE;
+                }
+            }
+
+            if (!NNS_GfdRegisterNewVramTransferTask(type,
+                                                    dstAddr + pEntry->ofsSeg,
+                                                    (void*)(pSrc + pEntry->ofsSeg),
+                                                    sz))
+            {
+                return FALSE;
+            }
+
+            pEntry->ofsSeg += sz;
+            pEntry->fence = NNS_GfdGetVramTransferFence();
+            *pRemain -= sz;
+            pStream->szSent += sz;
+
+            if (pEntry->ofsSeg < size)
+            {
+                return TRUE;
+            }
+        }
+
+        ++pEntry->idxSeg;
+        pEntry->ofsSeg = 0;
+    }
+
+    pEntry->state = NNS_G3D_TEXSTREAM_STATE_TRANSFER;
+    return TRUE;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dTexStreamInit
+
+    Initializes NNSG3dTexStream.
+    pEntry is an array of maxEntry entries, and budget is the number of bytes
+    registered for the transfer per frame.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dTexStreamInit(NNSG3dTexStream* pStream,
+                     NNSG3dTexStreamEntry* pEntry,
+                     u32 maxEntry,
+                     u32 budget)
+{
+    NNS_G3D_NULL_ASSERT(pStream);
+    NNS_G3D_NULL_ASSERT(pEntry);
+    NNS_G3D_ASSERT(maxEntry > 0);
+    NNS_G3D_ASSERT(budget >= 8);
+
+    MI_CpuClear32(pStream, sizeof(NNSG3dTexStream));
+
+    pStream->pEntry   = pEntry;
+    pStream->maxEntry = maxEntry;
+    pStream->budget   = budget;
+
+    // Frame 0 is the frame of the entries never used.
+    pStream->frame    = 1;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dTexStreamAddTex
+
+    Adds the texture block pTex as an entry and returns the index of the entry (-1 when full).
+    The keys must not be set in pTex.
+ *---------------------------------------------------------------------------*/
+int
+NNS_G3dTexStreamAddTex(NNSG3dTexStream* pStream, NNSG3dResTex* pTex)
+{
+    NNSG3dTexStreamEntry* pEntry;
+
+    NNS_G3D_NULL_ASSERT(pStream);
+    NNS_G3D_NULL_ASSERT(pTex);
+    NNS_G3D_ASSERT(pTex->texInfo.vramKey == 0 &&
+                   pTex->tex4x4Info.vramKey == 0 &&
+                   pTex->plttInfo.vramKey == 0);
+
+    if (pStream->numEntry >= pStream->maxEntry)
+    {
+        return -1;
+    }
+
+    pEntry = &pStream->pEntry[pStream->numEntry];
+    MI_CpuClear32(pEntry, sizeof(NNSG3dTexStreamEntry));
+    pEntry->pTex = pTex;
+
+    return (int)pStream->numEntry++;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dTexStreamAddMdl
+
+    Adds pMdl to the models bound to the textures and the palettes of the entry idx.
+    Returns FALSE when the entry already has NNS_G3D_TEXSTREAM_MAX_MDL models.
+ *---------------------------------------------------------------------------*/
+BOOL
+NNS_G3dTexStreamAddMdl(NNSG3dTexStream* pStream, int idx, NNSG3dResMdl* pMdl)
+{
+    NNSG3dTexStreamEntry* pEntry;
+
+    NNS_G3D_NULL_ASSERT(pStream);
+    NNS_G3D_NULL_ASSERT(pMdl);
+    NNS_G3D_ASSERT(idx >= 0 && (u32)idx < pStream->numEntry);
+
+    pEntry = &pStream->pEntry[idx];
+    NNS_G3D_ASSERT(pEntry->state == NNS_G3D_TEXSTREAM_STATE_NONE);
+
+    if (pEntry->numMdl >= NNS_G3D_TEXSTREAM_MAX_MDL)
+    {
+        return FALSE;
+    }
+
+    pEntry->pMdl[pEntry->numMdl++] = pMdl;
+    return TRUE;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dTexStreamUse
+
+    Marks the entry idx as used in this frame.
+    Returns TRUE when its textures are in VRAM and bound to the models.
+    Otherwise, they are loaded by the next calls of NNS_G3dTexStreamUpdate
+    and the models must not be drawn (or drawn without textures).
+ *---------------------------------------------------------------------------*/
+BOOL
+NNS_G3dTexStreamUse(NNSG3dTexStream* pStream, int idx)
+{
+    NNSG3dTexStreamEntry* pEntry;
+
+    NNS_G3D_NULL_ASSERT(pStream);
+    NNS_G3D_ASSERT(idx >= 0 && (u32)idx < pStream->numEntry);
+
+    pEntry = &pStream->pEntry[idx];
+    pEntry->frameUsed = pStream->frame;
+    ++pStream->numUse;
+
+    // All the data registered has been transferred (possibly over several VBlanks).
+    if (pEntry->state == NNS_G3D_TEXSTREAM_STATE_TRANSFER &&
+        NNS_GfdIsVramTransferFenceDone(pEntry->fence))
+    {
+        bindEntry_(pEntry);
+        pEntry->state = NNS_G3D_TEXSTREAM_STATE_RESIDENT;
+        ++pStream->numLoad;
+    }
+
+    if (pEntry->state != NNS_G3D_TEXSTREAM_STATE_RESIDENT)
+    {
+        ++pStream->numMiss;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dTexStreamUpdate
+
+    Loads the entries used in this frame and not in VRAM, within the transfer budget.
+    Call this once per frame, after drawing.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dTexStreamUpdate(NNSG3dTexStream* pStream)
+{
+    u32  remain;
+    BOOL isFull = FALSE;
+    u32  i;
+
+    NNS_G3D_NULL_ASSERT(pStream);
+
+    remain = pStream->budget;
+    pStream->szSent = 0;
+
+    // Bind the entries whose data has been transferred.
+    for (i = 0; i < pStream->numEntry; ++i)
+    {
+        NNSG3dTexStreamEntry* p = &pStream->pEntry[i];
+
+        if (p->state == NNS_G3D_TEXSTREAM_STATE_TRANSFER &&
+            NNS_GfdIsVramTransferFenceDone(p->fence))
+        {
+            bindEntry_(p);
+            p->state = NNS_G3D_TEXSTREAM_STATE_RESIDENT;
+            ++pStream->numLoad;
+        }
+    }
+
+    // Continue the entries being loaded first.
+    for (i = 0; i < pStream->numEntry && remain > 0 && !isFull; ++i)
+    {
+        NNSG3dTexStreamEntry* p = &pStream->pEntry[i];
+
+        if (p->state == NNS_G3D_TEXSTREAM_STATE_LOADING)
+        {
+            isFull = !sendEntry_(pStream, p, &remain);
+        }
+    }
+
+    // Start the entries used in this frame and not in VRAM.
+    for (i = 0; i < pStream->numEntry && remain > 0 && !isFull; ++i)
+    {
+        NNSG3dTexStreamEntry* p = &pStream->pEntry[i];
+
+        if (p->state == NNS_G3D_TEXSTREAM_STATE_NONE &&
+            p->frameUsed == pStream->frame)
+        {
+            BOOL isAlloc;
+
+            while ((isAlloc = allocEntry_(pStream, p)) == FALSE && evictLru_(pStream))
+            {
+                ;
+            }
+
+            if (!isAlloc)
+            {
+                // Nothing more can be released in this frame.
+                ++pStream->numFull;
+                break;
+            }
+
+            p->state  = NNS_G3D_TEXSTREAM_STATE_LOADING;
+            p->idxSeg = 0;
+            p->ofsSeg = 0;
+
+            isFull = !sendEntry_(pStream, p, &remain);
+        }
+    }
+
+    ++pStream->frame;
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dTexStreamRelease
+
+    Releases the bindings and the VRAM of the entry idx.
+    Do not call this between the registration of the data of the entry
+    and its transfer (while the entry is loading or being transferred).
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dTexStreamRelease(NNSG3dTexStream* pStream, int idx)
+{
+    NNS_G3D_NULL_ASSERT(pStream);
+    NNS_G3D_ASSERT(idx >= 0 && (u32)idx < pStream->numEntry);
+
+    releaseEntry_(pStream, &pStream->pEntry[idx]);
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dTexStreamReleaseAll
+
+    Releases the bindings and the VRAM of all the entries.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dTexStreamReleaseAll(NNSG3dTexStream* pStream)
+{
+    u32 i;
+    NNS_G3D_NULL_ASSERT(pStream);
+
+    for (i = 0; i < pStream->numEntry; ++i)
+    {
+        releaseEntry_(pStream, &pStream->pEntry[i]);
+    }
+}
+
+
+/*---------------------------------------------------------------------------*
+    NNS_G3dTexStreamResetStats
+
+    Resets the statistics.
+ *---------------------------------------------------------------------------*/
+void
+NNS_G3dTexStreamResetStats(NNSG3dTexStream* pStream)
+{
+    NNS_G3D_NULL_ASSERT(pStream);
+
+    pStream->numUse   = 0;
+    pStream->numMiss  = 0;
+    pStream->numLoad  = 0;
+    pStream->numEvict = 0;
+    pStream->numFull  = 0;
+}
@@ -18,6 +18,12 @@
 
 #include <nnsys/gfd.h>
 
+//------------------------------------------------------------------------------
+// Number of size classes of the free blocks
+// (Size class n holds the free blocks of 2^n bytes or more and less than 2^(n+1) bytes.
+//  The last size class also holds the larger free blocks.)
+#define NNSi_GFD_LNK_NUM_SIZE_CLASS     20
+
 //------------------------------------------------------------------------------
 typedef struct NNSiGfdLnkVramBlock NNSiGfdLnkVramBlock;
 
@@ -32,8 +38,11 @@ struct NNSiGfdLnkVramBlock
     u32                         addr;       // Region start address
     u32                         szByte;     // Region size (zero may not be used)
     
-    NNSiGfdLnkVramBlock*        pBlkPrev;   // Previous region (No address-positional relation)
-    NNSiGfdLnkVramBlock*        pBlkNext;   // Next region (No address-positional relation)
+    NNSiGfdLnkVramBlock*        pBlkPrev;   // Previous region (Lower address in the free list)
+    NNSiGfdLnkVramBlock*        pBlkNext;   // Next region (Higher address in the free list)
+    
+    NNSiGfdLnkVramBlock*        pClassPrev; // Previous free region of the same size class
+    NNSiGfdLnkVramBlock*        pClassNext; // Next free region of the same size class
     
 };
 
@@ -61,11 +70,15 @@ typedef struct NNSiGfdLnkMemRegion
                 
                 When freeing, returns to the free area of the area used from the address and size.
                 
+                The free list is kept in ascending order of addresses, and freed regions are merged with the adjacent free blocks immediately.
+                The free blocks are also listed by size class so that allocation examines only the size classes that can satisfy the request.
                 
  *---------------------------------------------------------------------------*/
 typedef struct NNSiGfdLnkVramMan
 {
-    NNSiGfdLnkVramBlock*         pFreeList;         // Unused region block list
+    NNSiGfdLnkVramBlock*         pFreeList;         // Unused region block list (ascending order of addresses)
+    NNSiGfdLnkVramBlock*         pClassList[NNSi_GFD_LNK_NUM_SIZE_CLASS]; // Unused region block list of each size class
+    u32                          classMask;         // Size classes whose list is not empty (1 bit each)
       
 }NNSiGfdLnkVramMan;
 
@@ -127,6 +140,15 @@ NNSi_GfdAllocLnkVramAligned
     u32                     alignment
 );
 
+BOOL
+NNSi_GfdAllocLnkVramLowest
+( 
+    NNSiGfdLnkVramMan*      pMan, 
+    NNSiGfdLnkVramBlock**   ppBlockPoolList,
+    u32*                    pRetAddr,
+    u32                     szByte
+);
+
 void NNSi_GfdMergeAllFreeBlocks( 
     NNSiGfdLnkVramMan*      pMan, 
     NNSiGfdLnkVramBlock**   ppBlockPoolList
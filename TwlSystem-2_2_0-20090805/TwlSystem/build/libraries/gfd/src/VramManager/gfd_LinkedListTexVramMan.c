@@ -14,6 +14,7 @@
  *---------------------------------------------------------------------------*/
 #include <nnsys/gfd/gfd_common.h>
 #include <nnsys/gfd/VramManager/gfd_LinkedListTexVramMan.h>
+#include <nnsys/gfd/VramTransferMan/gfd_VramTransferManager.h>
 #include "gfdi_LinkedListVramMan_Common.h"
 
 #define GFD_SLOT_SIZE        0x20000
@@ -71,6 +72,25 @@ static u32 Dbg_GetVramManTotalFreeBlockSize_( const NNSiGfdLnkVramMan* pMgr )
     return total;
 }
 
+//------------------------------------------------------------------------------
+// Sorts the defragmentation entries in ascending order of the texture addresses. (insertion sort)
+static void SortDefragEntry_( NNSGfdLnkTexDefragEntry* pEntry, u32 numEntry )
+{
+    u32     i, j;
+    
+    for( i = 1; i < numEntry; i++ )
+    {
+        const NNSGfdLnkTexDefragEntry   entry   = pEntry[i];
+        const u32                       addr    = NNS_GfdGetTexKeyAddr( *entry.pKey );
+        
+        for( j = i; j > 0 && NNS_GfdGetTexKeyAddr( *pEntry[j - 1].pKey ) > addr; j-- )
+        {
+            pEntry[j] = pEntry[j - 1];
+        }
+        pEntry[j] = entry;
+    }
+}
+
 //------------------------------------------------------------------------------
 // Is the initialization size parameter valid?
 static BOOL Dbg_IsInitializeSizeParamsValid_( u32 szByte, u32 szByteFor4x4 )
@@ -501,3 +521,100 @@ void            NNS_GfdResetLnkTexVramState( void )
     NNSi_GfdMergeAllFreeBlocks( &mgr_.mgr4x4, &mgr_.pBlockPoolList );
 }
 
+/*---------------------------------------------------------------------------*
+  Name:         NNS_GfdDefragLnkTexVram
+
+  Description:  Moves the standard textures to lower addresses so that the free regions of VRAM are gathered.
+                In ascending order of addresses, each texture is moved to the free region with the lowest address that fits.
+                
+                For each moved texture, a task transferring the texture image to the new region is registered 
+                in the VRAM transfer manager, and the texture key of the entry is updated.
+                The tasks are transmitted by the next NNS_GfdDoVramTransfer regardless of its budget
+                (see NNS_GfdRequestVramTransferFlush).
+                
+                Call this before drawing a frame, and draw the frame with the updated keys:
+                the frame is rendered after the V-Blank in which the tasks are executed,
+                and the old regions may be overwritten by other moved textures.
+                The models bound to the moved textures must be bound again before drawing.
+                When pKey is the key of a texture block (&pTex->texInfo.vramKey), call
+                NNS_G3dReleaseMdlTex( pMdl ) and then NNS_G3dBindMdlTex( pMdl, pTex ) for each model
+                that uses the texture block (and bind again the other texture blocks of the model).
+                
+                4x4 compressed textures are not moved, since their index table region is bound to their address.
+                Moving stops when the task queue of the VRAM transfer manager is full.
+                
+  Arguments:    pEntry          : textures that can be moved (The array is sorted by address.)
+                numEntry        : number of entries
+                
+  Returns:      number of moved textures
+
+ *---------------------------------------------------------------------------*/
+u32             NNS_GfdDefragLnkTexVram( NNSGfdLnkTexDefragEntry* pEntry, u32 numEntry )
+{
+    u32     i;
+    u32     numMoved = 0;
+    
+    NNS_GFD_ASSERT( numEntry == 0 || pEntry != NULL );
+    
+    SortDefragEntry_( pEntry, numEntry );
+    
+    for( i = 0; i < numEntry; i++ )
+    {
+        const NNSGfdTexKey  key     = *pEntry[i].pKey;
+        const u32           addr    = NNS_GfdGetTexKeyAddr( key );
+        const u32           szByte  = NNS_GfdGetTexKeySize( key );
+        u32                 newAddr;
+        BOOL                result;
+        
+        if( key == NNS_GFD_ALLOC_ERROR_TEXKEY || szByte == 0 || NNS_GfdGetTexKey4x4Flag( key ) )
+        {
+            continue;
+        }
+        
+        NNS_GFD_NULL_ASSERT( pEntry[i].pSrc );
+        
+        //
+        // The transfer task must be registrable before the region is freed,
+        // so that the region never has to be restored.
+        //
+        if( NNS_GfdGetNumFreeVramTransferTasks() == 0 )
+        {
+            break;
+        }
+        
+        //
+        // Frees the region and allocates the free region with the lowest address.
+        // The freed region itself fits, so the allocation never fails.
+        //
+        if( !NNSi_GfdFreeLnkVram( &mgr_.mgrNrm, &mgr_.pBlockPoolList, addr, szByte ) )
+        {
+            NNS_GFD_WARNING("The management blocks are insufficient. : NNS_GfdDefragLnkTexVram()");
+            break;
+        }
+        result = NNSi_GfdAllocLnkVramLowest( &mgr_.mgrNrm, &mgr_.pBlockPoolList, &newAddr, szByte );
+        NNS_GFD_ASSERT( result && newAddr <= addr );
+        
+        if( newAddr != addr )
+        {
+            // The task queue has a free entry, so the registration never fails.
+            result = NNS_GfdRegisterNewVramTransferTask( NNS_GFD_DST_3D_TEX_VRAM, 
+                                                         newAddr, 
+                                                         pEntry[i].pSrc, 
+                                                         szByte );
+            NNS_GFD_ASSERT( result );
+            
+            *pEntry[i].pKey = NNS_GfdMakeTexKey( newAddr, szByte, FALSE );
+            numMoved++;
+        }
+    }
+    
+    //
+    // The textures must be in the new regions at the next V-Blank.
+    //
+    if( numMoved > 0 )
+    {
+        NNS_GfdRequestVramTransferFlush();
+    }
+    
+    return numMoved;
+}
@@ -50,6 +50,8 @@ static NNS_GFD_INLINE void InitBlockFromRegion_
     pBlk->szByte    = (u32)(pRegion->end - pRegion->start);
     pBlk->pBlkPrev  = NULL;
     pBlk->pBlkNext  = NULL;
+    pBlk->pClassPrev = NULL;
+    pBlk->pClassNext = NULL;
 }
 
 //------------------------------------------------------------------------------
@@ -68,6 +70,8 @@ static NNS_GFD_INLINE void InitBlockFromPrams_
     pBlk->szByte    = szByte;
     pBlk->pBlkPrev  = NULL;
     pBlk->pBlkNext  = NULL;
+    pBlk->pClassPrev = NULL;
+    pBlk->pClassNext = NULL;
 }
 
 //------------------------------------------------------------------------------
@@ -172,55 +176,188 @@ static void DefaultDumpCallBack_(
 }
 
 //------------------------------------------------------------------------------
-// Scan free blocks and merge regions.
-// Returns a Boolean value that indicates whether a merge was performed.
-static BOOL TryToMergeBlockRegion_( 
-    NNSiGfdLnkVramMan*      pMan, 
-    NNSiGfdLnkVramBlock**   ppBlockPoolList,
-    NNSiGfdLnkMemRegion*    pRegion )
+// Gets the size class of the region size.
+static NNS_GFD_INLINE u32 GetSizeClass_( u32 szByte )
 {
-    NNS_GFD_NULL_ASSERT( pMan );
-    NNS_GFD_NULL_ASSERT( ppBlockPoolList );
-    NNS_GFD_NULL_ASSERT( pRegion );
-            
+    NNS_GFD_NON_ZERO_ASSERT( szByte );
+    {
+        const u32 sizeClass = (u32)MATH_ILog2( szByte );
+        
+        return ( sizeClass < NNSi_GFD_LNK_NUM_SIZE_CLASS ) ? 
+                    sizeClass : NNSi_GFD_LNK_NUM_SIZE_CLASS - 1;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Inserts the free block in the beginning of the list of its size class.
+static NNS_GFD_INLINE void InsertBlockToClass_
+(
+    NNSiGfdLnkVramMan*      pMan,
+    NNSiGfdLnkVramBlock*    pBlk
+)
+{
+    const u32               sizeClass   = GetSizeClass_( pBlk->szByte );
+    NNSiGfdLnkVramBlock*    pHead       = pMan->pClassList[sizeClass];
+    
+    if( pHead != NULL )
     {
-        // search for free area next to the specified one
-        NNSiGfdLnkVramBlock*        pCursor         = pMan->pFreeList;
-        NNSiGfdLnkVramBlock*        pNext           = NULL;
-        BOOL                        bMerged         = FALSE;
+        pHead->pClassPrev   = pBlk;
+    }
+    
+    pBlk->pClassNext    = pHead;
+    pBlk->pClassPrev    = NULL;
+    
+    pMan->pClassList[sizeClass] = pBlk;
+    pMan->classMask             |= ( 1 << sizeClass );
+}
 
-        // the free list elements
-        while( pCursor )
+//------------------------------------------------------------------------------
+// Removes the free block from the list of its size class.
+static NNS_GFD_INLINE void RemoveBlockFromClass_
+(
+    NNSiGfdLnkVramMan*      pMan,
+    NNSiGfdLnkVramBlock*    pBlk
+)
+{
+    const u32   sizeClass = GetSizeClass_( pBlk->szByte );
+    
+    // previous reference link
+    if( pBlk->pClassPrev )
+    {
+        pBlk->pClassPrev->pClassNext = pBlk->pClassNext;
+    }else{
+        pMan->pClassList[sizeClass] = pBlk->pClassNext;
+        if( pMan->pClassList[sizeClass] == NULL )
         {
-            pNext = pCursor->pBlkNext;
-              
-            // Is the block adjacent to the end?
-            if( pCursor->addr == pRegion->end )   
-            {
-                // combine the available regions
-                pRegion->end = GetBlockEndAddr_( pCursor );
-                // Removes from the list and returns to pool.
-                RemoveBlock_( &pMan->pFreeList, pCursor );
-                InsertBlock_( ppBlockPoolList, pCursor );
-                bMerged |= TRUE;
-            }
-                            
-            // Is it a block that is next to the beginning?
-            if( GetBlockEndAddr_( pCursor ) == pRegion->start )
+            pMan->classMask &= ~( 1 << sizeClass );
+        }
+    }
+    
+    // next reference link
+    if( pBlk->pClassNext )
+    {
+        pBlk->pClassNext->pClassPrev = pBlk->pClassPrev;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Changes the region of the free block.
+// The block moves to the list of its new size class if necessary.
+static NNS_GFD_INLINE void SetFreeBlockRegion_
+(
+    NNSiGfdLnkVramMan*      pMan,
+    NNSiGfdLnkVramBlock*    pBlk,
+    u32                     addr,
+    u32                     szByte
+)
+{
+    NNS_GFD_NON_ZERO_ASSERT( szByte );
+    
+    if( GetSizeClass_( pBlk->szByte ) != GetSizeClass_( szByte ) )
+    {
+        RemoveBlockFromClass_( pMan, pBlk );
+        pBlk->addr      = addr;
+        pBlk->szByte    = szByte;
+        InsertBlockToClass_( pMan, pBlk );
+    }else{
+        pBlk->addr      = addr;
+        pBlk->szByte    = szByte;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Links the free block after pPrev in the free list (at the beginning if pPrev is NULL).
+static void LinkFreeBlock_
+(
+    NNSiGfdLnkVramMan*      pMan,
+    NNSiGfdLnkVramBlock*    pPrev,
+    NNSiGfdLnkVramBlock*    pBlk
+)
+{
+    NNSiGfdLnkVramBlock*    pNext = ( pPrev != NULL ) ? pPrev->pBlkNext : pMan->pFreeList;
+    
+    NNS_GFD_NULL_ASSERT( pBlk );
+    NNS_GFD_ASSERT( pPrev == NULL || GetBlockEndAddr_( pPrev ) <= pBlk->addr );
+    NNS_GFD_ASSERT( pNext == NULL || GetBlockEndAddr_( pBlk ) <= pNext->addr );
+    
+    pBlk->pBlkPrev  = pPrev;
+    pBlk->pBlkNext  = pNext;
+    
+    if( pPrev )
+    {
+        pPrev->pBlkNext = pBlk;
+    }else{
+        pMan->pFreeList = pBlk;
+    }
+    
+    if( pNext )
+    {
+        pNext->pBlkPrev = pBlk;
+    }
+    
+    InsertBlockToClass_( pMan, pBlk );
+}
+
+//------------------------------------------------------------------------------
+// Removes the free block from the free list and returns it to the pool.
+static void UnlinkFreeBlock_
+(
+    NNSiGfdLnkVramMan*      pMan,
+    NNSiGfdLnkVramBlock**   ppBlockPoolList,
+    NNSiGfdLnkVramBlock*    pBlk
+)
+{
+    RemoveBlockFromClass_( pMan, pBlk );
+    RemoveBlock_( &pMan->pFreeList, pBlk );
+    InsertBlock_( ppBlockPoolList, pBlk );
+}
+
+//------------------------------------------------------------------------------
+// Removes the region [addr, addr + szByte) from the free block that contains it.
+// The free block keeps the open area before the region,
+// and a new free block is registered for the open area after the region only when both remain.
+// Take note that if a management information block does not exist for the open area, the function fails.
+static BOOL CarveFreeBlock_
+(
+    NNSiGfdLnkVramMan*      pMan,
+    NNSiGfdLnkVramBlock**   ppBlockPoolList,
+    NNSiGfdLnkVramBlock*    pBlk,
+    u32                     addr,
+    u32                     szByte
+)
+{
+    const u32   blkStart    = pBlk->addr;
+    const u32   blkEnd      = GetBlockEndAddr_( pBlk );
+    const u32   endAddr     = addr + szByte;
+    
+    NNS_GFD_ASSERT( blkStart <= addr && endAddr <= blkEnd );
+    
+    if( addr == blkStart )
+    {
+        if( endAddr == blkEnd )
+        {
+            // perfect size
+            UnlinkFreeBlock_( pMan, ppBlockPoolList, pBlk );
+        }else{
+            // Allocates memory from front of block.
+            SetFreeBlockRegion_( pMan, pBlk, endAddr, blkEnd - endAddr );
+        }
+    }else{
+        if( endAddr != blkEnd )
+        {
+            NNSiGfdLnkVramBlock*        pNewFreeBlk = GetNewBlock_( ppBlockPoolList );
+            if( pNewFreeBlk == NULL )
             {
-                // combine the available regions
-                pRegion->start  = pCursor->addr;
-                // Removes from the list and returns to pool.
-                RemoveBlock_( &pMan->pFreeList, pCursor );
-                InsertBlock_( ppBlockPoolList, pCursor );
-                bMerged |= TRUE;
+                return FALSE;
             }
             
-            pCursor = pNext;
+            InitBlockFromPrams_( pNewFreeBlk, endAddr, blkEnd - endAddr );
+            LinkFreeBlock_( pMan, pBlk, pNewFreeBlk );
         }
-
-        return bMerged;
+        SetFreeBlockRegion_( pMan, pBlk, blkStart, addr - blkStart );
     }
+    
+    return TRUE;
 }
 
 
@@ -309,6 +446,8 @@ NNSi_GfdInitLnkVramMan( NNSiGfdLnkVramMan* pMgr )
 {
     NNS_GFD_NULL_ASSERT( pMgr );
     pMgr->pFreeList = NULL;
+    MI_CpuClear32( pMgr->pClassList, sizeof( pMgr->pClassList ) );
+    pMgr->classMask = 0;
 }
 
 
@@ -354,10 +493,10 @@ NNSi_GfdInitLnkVramBlockPool
 }
 
 /*---------------------------------------------------------------------------*
-  Name:         NNSi_GfdInitLnkVramMan
+  Name:         NNSi_GfdAddNewFreeBlock
 
   Description:  This function adds the blocks of newly freed areas to the manager.
-                
+                The area is merged with the adjacent free blocks.
                 
   Arguments:    pMan: Manager
                 ppBlockPoolList: common block management information
@@ -380,18 +519,7 @@ BOOL NNSi_GfdAddNewFreeBlock
     NNS_GFD_NON_ZERO_ASSERT( szByte );
     
     // Creates free blocks.
-    {
-        NNSiGfdLnkVramBlock*        pNew  = GetNewBlock_( ppBlockPoolList );
-        if( pNew )
-        {
-            InitBlockFromPrams_( pNew, baseAddr, szByte );
-            InsertBlock_( &pMan->pFreeList, pNew );
-            
-            return TRUE;
-        }else{
-            return FALSE;
-        }
-    }
+    return NNSi_GfdFreeLnkVram( pMan, ppBlockPoolList, baseAddr, szByte );
 }
 
 
@@ -426,7 +554,9 @@ NNSi_GfdAllocLnkVram
 
 //------------------------------------------------------------------------------
 // memory allocation with alignment that can be specified
-// Open areas that occurred during alignment are newly registered in the free list.
+// Allocates from the smallest free block that meets the requirements (best fit).
+// Only the size classes that can hold a large enough block are examined.
+// Open areas that occurred during alignment remain in the free list.
 // Take note that if a management information block does not exist for the open area, the memory allocation will fail.
 BOOL
 NNSi_GfdAllocLnkVramAligned
@@ -444,97 +574,121 @@ NNSi_GfdAllocLnkVramAligned
     NNS_GFD_NON_ZERO_ASSERT( szByte );
     {
         //
-        // Searches for blocks from the free list that meet the requirements.
+        // Searches for blocks from the size class lists that meet the requirements.
         //
         u32     alignedAddr;
-        u32     szNeeded;
-        u32     difference;
+        u32     addrFound   = 0;
+        u32     sizeClass   = GetSizeClass_( szByte );
+        // The size classes below that of the requested size have no block large enough.
+        u32     classMask   = pMan->classMask & ~( ( 1 << sizeClass ) - 1 );
         
         NNSiGfdLnkVramBlock* pBlkFound  = NULL;
-        NNSiGfdLnkVramBlock* pBlk       = pMan->pFreeList;
+        NNSiGfdLnkVramBlock* pBlk;
         
         
-        while( pBlk )
-        {
-            //
-            // If necessary, calculates the address rounded up to the align boundary.
-            //
-            if( alignment > 1 )
-            {
-                alignedAddr = (u32)(  (pBlk->addr + (alignment - 1)) & ~(alignment - 1) );
-                // Increased by rounded up portion only, which is the actual size needed.
-                difference  = ( alignedAddr - pBlk->addr );
-                szNeeded    = szByte + difference;
-            }else{
-                alignedAddr = pBlk->addr;
-                difference  = 0;
-                szNeeded    = szByte;
-            }
-            
-            
-            // Does the size satisfy the request?
-            if( pBlk->szByte >= szNeeded )
-            {
-                pBlkFound = pBlk;
-                break;
-            }
-            pBlk = pBlk->pBlkNext;
-        }
-        
         //
-        // If a block in requirements was found...
+        // The blocks of a size class are all smaller than those of the higher ones,
+        // so the search stops at the first size class that has a block in requirements.
         //
-        if ( pBlkFound ) 
+        while( classMask != 0 && pBlkFound == NULL )
         {
-            // The area that was moved as alignment is registered as a free block.
-            if( difference > 0 )
-            {    
-                NNSiGfdLnkVramBlock*        pNewFreeBlk = GetNewBlock_( ppBlockPoolList );
-                if( pNewFreeBlk )
+            sizeClass   = MATH_CountTrailingZeros( classMask );
+            classMask   &= ~( 1 << sizeClass );
+            
+            for( pBlk = pMan->pClassList[sizeClass]; pBlk != NULL; pBlk = pBlk->pClassNext )
+            {
+                //
+                // If necessary, calculates the address rounded up to the align boundary.
+                //
+                if( alignment > 1 )
                 {
-                    // registration
-                    InitBlockFromPrams_( pNewFreeBlk, pBlkFound->addr, difference );
-                    InsertBlock_( &pMan->pFreeList, pNewFreeBlk );
+                    alignedAddr = (u32)(  (pBlk->addr + (alignment - 1)) & ~(alignment - 1) );
                 }else{
-                    // allocation failed
-                    goto NG_CASE;
+                    alignedAddr = pBlk->addr;
                 }
-            }
-            
-            // Update information for found free block.
-            {
-                // Subtracts used area.
-                pBlkFound->szByte   -= szNeeded;
-                // Allocates memory from front of block.
-                pBlkFound->addr     += szNeeded; 
                 
-                // perfect size
-                if( pBlkFound->szByte == 0 )
+                // Does the size satisfy the request?
+                // (Increased by rounded up portion only, which is the actual size needed.)
+                if( pBlk->szByte >= szByte + ( alignedAddr - pBlk->addr ) )
                 {
-                    // removes from free list
-                    RemoveBlock_( &pMan->pFreeList, pBlkFound );
-                    InsertBlock_( ppBlockPoolList, pBlkFound );
+                    // Is it smaller than the block found so far? (The lower address is used for the same size.)
+                    if( pBlkFound == NULL                   || 
+                        pBlk->szByte < pBlkFound->szByte    ||
+                        ( pBlk->szByte == pBlkFound->szByte && pBlk->addr < pBlkFound->addr ) )
+                    {
+                        pBlkFound   = pBlk;
+                        addrFound   = alignedAddr;
+                    }
                 }
             }
-                    
-            *pRetAddr = alignedAddr;
+        }
+        
+        //
+        // If a block in requirements was found...
+        //
+        if( pBlkFound != NULL && 
+            CarveFreeBlock_( pMan, ppBlockPoolList, pBlkFound, addrFound, szByte ) ) 
+        {
+            *pRetAddr = addrFound;
             return TRUE;
         }
         
-NG_CASE:            
         //
         // Could not find a block that meets the requirements.
         //
         *pRetAddr = 0;
         return FALSE;
-        
     }
 }
 
+/*---------------------------------------------------------------------------*
+  Name:         NNSi_GfdAllocLnkVramLowest
+
+  Description:  This function allocates memory from the free block with the lowest address that meets the requirements.
+                It is used to gather the used regions in the lower addresses.
+                Since memory is allocated from front of block, allocation never fails when a block is large enough.
+                
+  Arguments:    pMan: Manager
+                ppBlockPoolList: common block management information
+                pRetAddr: pointer to allocation address
+                szByte: memory size to allocate
+                
+  Returns:      memory allocation success or failure
+  
+ *---------------------------------------------------------------------------*/
+BOOL
+NNSi_GfdAllocLnkVramLowest
+( 
+    NNSiGfdLnkVramMan*      pMan, 
+    NNSiGfdLnkVramBlock**   ppBlockPoolList,
+    u32*                    pRetAddr,
+    u32                     szByte
+)
+{
+    NNSiGfdLnkVramBlock*    pBlk;
+    
+    NNS_GFD_NULL_ASSERT( pMan );
+    NNS_GFD_NULL_ASSERT( pRetAddr );
+    NNS_GFD_NON_ZERO_ASSERT( szByte );
+    
+    for( pBlk = pMan->pFreeList; pBlk != NULL; pBlk = pBlk->pBlkNext )
+    {
+        if( pBlk->szByte >= szByte )
+        {
+            *pRetAddr = pBlk->addr;
+            return CarveFreeBlock_( pMan, ppBlockPoolList, pBlk, pBlk->addr, szByte );
+        }
+    }
+    
+    *pRetAddr = 0;
+    return FALSE;
+}
+
 /*---------------------------------------------------------------------------*
   Name:         NNSi_GfdMergeAllFreeBlocks
 
   Description:  Scans and merges free blocks.
+                Since free regions are merged when they are freed, the free list is normally merged already.
   
  *---------------------------------------------------------------------------*/
 void NNSi_GfdMergeAllFreeBlocks( 
@@ -542,29 +696,24 @@ void NNSi_GfdMergeAllFreeBlocks(
     NNSiGfdLnkVramBlock**   ppBlockPoolList
 )
 {
-    NNSiGfdLnkMemRegion         region;
-    
-    // the entire free list...
+    // the entire free list... (ascending order of addresses)
     NNSiGfdLnkVramBlock*        pCursor         = pMan->pFreeList;
-    while( pCursor )
+    NNSiGfdLnkVramBlock*        pNext;
+    
+    while( pCursor && pCursor->pBlkNext )
     {
-        region.start    = pCursor->addr;
-        region.end      = pCursor->addr + pCursor->szByte;
+        pNext = pCursor->pBlkNext;
         
-        // Check whether blocks can be merged.
-        // if merged...
-        if( TryToMergeBlockRegion_( pMan, ppBlockPoolList, &region ) )
+        // Is the next block adjacent to the end?
+        if( GetBlockEndAddr_( pCursor ) == pNext->addr )
         {
-            //
-            // Set the new size after an attempted merge.
-            //
-            pCursor->addr    = region.start;
-            pCursor->szByte  = region.end - region.start;       
+            // combine the available regions
+            const u32   endAddr = GetBlockEndAddr_( pNext );
             
-            // Rescan from the start of the list.
-            pCursor = pMan->pFreeList;
+            UnlinkFreeBlock_( pMan, ppBlockPoolList, pNext );
+            SetFreeBlockRegion_( pMan, pCursor, pCursor->addr, endAddr - pCursor->addr );
         }else{
-            pCursor = pCursor->pBlkNext;
+            pCursor = pNext;
         }
     }
 }
@@ -573,6 +722,7 @@ void NNSi_GfdMergeAllFreeBlocks(
   Name:         NNSi_GfdFreeLnkVram
 
   Description:  This function deallocates memory.
+                The region is merged with the adjacent free blocks immediately.
                 Take note that if the management blocks are insufficient the deallocation may fail.
                 (Failure occurs with generation of new free blocks.)
                 
@@ -594,46 +744,63 @@ BOOL NNSi_GfdFreeLnkVram
 )
 {
     NNS_GFD_NULL_ASSERT( pMan );
+    NNS_GFD_NULL_ASSERT( ppBlockPoolList );
     NNS_GFD_NON_ZERO_ASSERT( szByte );
     
     {
+        const u32               endAddr = addr + szByte;
+        NNSiGfdLnkVramBlock*    pPrev   = NULL;
+        NNSiGfdLnkVramBlock*    pNext   = pMan->pFreeList;
+        
+        //
+        // Searches for the free blocks before and after the region.
+        //
+        while( pNext && pNext->addr < addr )
+        {
+            pPrev = pNext;
+            pNext = pNext->pBlkNext;
+        }
+        
+        // The region must not overlap the free blocks.
+        NNS_GFD_ASSERT( pPrev == NULL || GetBlockEndAddr_( pPrev ) <= addr );
+        NNS_GFD_ASSERT( pNext == NULL || endAddr <= pNext->addr );
         
         //------------------------------------------------------------------------------
         // Incorporates an empty region into a free memory block.
         //      If it is adjacent to a free block, the free block is expanded.
-        //      When neither adjacent to a free block nor having enough size for a free block, used as an alignment value for used blocks adjacent to the end.
+        //      Otherwise, a new free block is registered.
         //      
-        //      If there is no used block adjacent to the end of the empty region, the function fails.
+        //      If there is no management block for the new free block, the function fails.
+        if( pPrev && GetBlockEndAddr_( pPrev ) == addr )
         {
-            NNSiGfdLnkMemRegion     region;
-        
-            region.start    = addr;
-            region.end      = addr + szByte;
-        
-            NNS_GFD_NULL_ASSERT( pMan );
-            NNS_GFD_NULL_ASSERT( ppBlockPoolList );
+            if( pNext && pNext->addr == endAddr )
             {
-                (void)TryToMergeBlockRegion_( pMan, ppBlockPoolList, &region );
-                                
-                //
-                // Registers new free blocks.
-                //
-                {
-                    NNSiGfdLnkVramBlock*        pNewFreeBlk = GetNewBlock_( ppBlockPoolList );
-                    if( pNewFreeBlk == NULL )
-                    {
-                        // The data for the management area is insufficient.
-                        // failed to deallocate
-                        return FALSE;
-                    }else{
-                    
-                        InitBlockFromRegion_( pNewFreeBlk, &region );
-                        InsertBlock_( &pMan->pFreeList, pNewFreeBlk );
-                    }
-                }
+                // fills the gap between two free blocks
+                const u32   nextEndAddr = GetBlockEndAddr_( pNext );
                 
-                return TRUE;
+                UnlinkFreeBlock_( pMan, ppBlockPoolList, pNext );
+                SetFreeBlockRegion_( pMan, pPrev, pPrev->addr, nextEndAddr - pPrev->addr );
+            }else{
+                SetFreeBlockRegion_( pMan, pPrev, pPrev->addr, endAddr - pPrev->addr );
             }
+        }else if( pNext && pNext->addr == endAddr ){
+            SetFreeBlockRegion_( pMan, pNext, addr, GetBlockEndAddr_( pNext ) - addr );
+        }else{
+            //
+            // Registers new free blocks.
+            //
+            NNSiGfdLnkVramBlock*        pNewFreeBlk = GetNewBlock_( ppBlockPoolList );
+            if( pNewFreeBlk == NULL )
+            {
+                // The data for the management area is insufficient.
+                // failed to deallocate
+                return FALSE;
+            }
+            
+            InitBlockFromPrams_( pNewFreeBlk, addr, szByte );
+            LinkFreeBlock_( pMan, pPrev, pNewFreeBlk );
         }
+        
+        return TRUE;
     }
 }
@@ -44,6 +44,42 @@ IsVramTransferTaskQueueEmpty_( const NNSGfdVramTransferTaskQueue* pQueue )
     return (pQueue->numTasks == 0) ? TRUE: FALSE;
 }
 
+//------------------------------------------------------------------------------
+// Can the task be transmitted in several parts?
+// (The clear image transmissions ignore the destination address.)
+static BOOL
+IsSplittableType_( NNS_GFD_DST_TYPE type )
+{
+    return ( type != NNS_GFD_DST_3D_CLRIMG_COLOR &&
+             type != NNS_GFD_DST_3D_CLRIMG_DEPTH ) ? TRUE: FALSE;
+}
+
+//------------------------------------------------------------------------------
+// Is the fence a the same as or earlier than the fence b?
+// (The fences wrap around.)
+static BOOL
+IsFenceNotAfter_( u32 a, u32 b )
+{
+    return ( (s32)( b - a ) >= 0 ) ? TRUE: FALSE;
+}
+
+//------------------------------------------------------------------------------
+// Is the registered task overwritten by a new task?
+// (The new task covers the whole destination of the registered task.)
+static BOOL
+IsCoveredTask_
+(
+    const NNSGfdVramTransferTask*   pTask,
+    NNS_GFD_DST_TYPE                type,
+    u32                             dstAddr,
+    u32                             szByte
+)
+{
+    return ( pTask->type == type &&
+             pTask->dstAddr >= dstAddr &&
+             pTask->dstAddr + pTask->szByte <= dstAddr + szByte ) ? TRUE: FALSE;
+}
+
 //------------------------------------------------------------------------------
 // transfer
 static void DoTransfer3dTex( const void* pSrc, u32 offset, u32 szByte )
@@ -246,7 +282,7 @@ static void DoTransfer2dObjCharSub( const void* pSrc, u32 offset, u32 szByte )
 
 
 static void
-DoTransfer_( const NNSGfdVramTransferTask* pTask )
+DoTransfer_( const NNSGfdVramTransferTask* pTask, u32 szByte )
 {
     const static TransferFunc transFunc[NNS_GFD_DST_MAX] = {
         DoTransfer3dTex,
@@ -294,8 +330,8 @@ DoTransfer_( const NNSGfdVramTransferTask* pTask )
 
     doTransfer = transFunc[pTask->type];
 
-    DC_FlushRange( pTask->pSrc, pTask->szByte );
-    doTransfer( pTask->pSrc, pTask->dstAddr, pTask->szByte );
+    DC_FlushRange( pTask->pSrc, szByte );
+    doTransfer( pTask->pSrc, pTask->dstAddr, szByte );
 }
 
 //------------------------------------------------------------------------------
@@ -309,6 +345,126 @@ static void ResetTaskQueue_( NNSGfdVramTransferTaskQueue* pQueue )
     pQueue->totalSize   = 0;
 }
 
+//------------------------------------------------------------------------------
+// queue operations
+// Gets the last registered task.
+static NNSGfdVramTransferTask*
+GetLastTask_( NNSGfdVramTransferTaskQueue* pQueue )
+{
+    NNS_GFD_ASSERT( !IsVramTransferTaskQueueEmpty_( pQueue ) );
+    
+    return &pQueue->pTaskArray[ ( pQueue->idxRear + pQueue->lengthOfArray - 1 ) % pQueue->lengthOfArray ];
+}
+
+//------------------------------------------------------------------------------
+// queue operations
+// Counts the registered tasks overwritten by a new task.
+static u16
+CountCoveredTasks_
+(
+    const NNSGfdVramTransferTaskQueue*  pQueue,
+    NNS_GFD_DST_TYPE                    type,
+    u32                                 dstAddr,
+    u32                                 szByte
+)
+{
+    u16     idx = pQueue->idxFront;
+    u16     num = 0;
+    u16     i;
+    
+    for( i = 0; i < pQueue->numTasks; i++ )
+    {
+        if( IsCoveredTask_( &pQueue->pTaskArray[idx], type, dstAddr, szByte ) )
+        {
+            num++;
+        }
+        idx = GetNextIndex_( pQueue, idx );
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+// queue operations
+// Removes the registered tasks overwritten by a new task,
+// and moves the following tasks forward to fill the slots.
+// Returns the earliest fence of fence and the fences of the removed tasks:
+// the new task takes over the fences, since it writes their destinations.
+// *pIsFlush is set to TRUE when a task to be flushed is removed.
+static u32
+DropCoveredTasks_
+(
+    NNSGfdVramTransferManager*  pMan,
+    NNS_GFD_DST_TYPE            type,
+    u32                         dstAddr,
+    u32                         szByte,
+    u32                         fence,
+    BOOL*                       pIsFlush
+)
+{
+    NNSGfdVramTransferTaskQueue*    pQueue      = &pMan->taskQueue;
+    const u16                       numTasks    = pQueue->numTasks;
+    u16                             idxSrc      = pQueue->idxFront;
+    u16                             idxDst      = pQueue->idxFront;
+    u16                             i;
+    
+    for( i = 0; i < numTasks; i++ )
+    {
+        NNSGfdVramTransferTask* pTask = &pQueue->pTaskArray[idxSrc];
+        
+        if( IsCoveredTask_( pTask, type, dstAddr, szByte ) )
+        {
+            if( IsFenceNotAfter_( pTask->fence, fence ) )
+            {
+                fence = pTask->fence;
+            }
+            if( i < pMan->numFlush )
+            {
+                *pIsFlush = TRUE;
+            }
+            pQueue->totalSize -= pTask->szByte;
+            pQueue->numTasks--;
+            pMan->stats.numDropped++;
+        }
+        else
+        {
+            if( idxDst != idxSrc )
+            {
+                pQueue->pTaskArray[idxDst] = *pTask;
+            }
+            idxDst = GetNextIndex_( pQueue, idxDst );
+        }
+        idxSrc = GetNextIndex_( pQueue, idxSrc );
+    }
+    
+    pQueue->idxRear = idxDst;
+    return fence;
+}
+
+//------------------------------------------------------------------------------
+// Updates the fence up to which the tasks are transmitted.
+// The tasks in the queue are not transmitted, so the fence is the one
+// just before the earliest fence of the tasks in the queue.
+static void
+UpdateFenceDone_( NNSGfdVramTransferManager* pMan )
+{
+    const NNSGfdVramTransferTaskQueue*  pQueue      = &pMan->taskQueue;
+    u32                                 fenceDone   = pMan->fenceRegistered;
+    u16                                 idx         = pQueue->idxFront;
+    u16                                 i;
+    
+    for( i = 0; i < pQueue->numTasks; i++ )
+    {
+        const u32 fence = pQueue->pTaskArray[idx].fence - 1;
+        
+        if( IsFenceNotAfter_( fence, fenceDone ) )
+        {
+            fenceDone = fence;
+        }
+        idx = GetNextIndex_( pQueue, idx );
+    }
+    pMan->fenceDone = fenceDone;
+}
+
 //------------------------------------------------------------------------------
 // queue operations
 BOOL
@@ -398,6 +554,14 @@ NNS_GfdInitVramTransferManager
         pMan->taskQueue.lengthOfArray   = lengthOfArray;
 
         ResetTaskQueue_( &pMan->taskQueue );
+        
+        pMan->szByteBudget  = 0;
+        pMan->tickBudget    = 0;
+        MI_CpuClear32( &pMan->stats, sizeof( NNSGfdVramTransferStats ) );
+        
+        pMan->fenceRegistered   = 0;
+        pMan->fenceDone         = 0;
+        pMan->numFlush          = 0;
     }
 }
 
@@ -405,6 +569,7 @@ NNS_GfdInitVramTransferManager
   Name:         NNS_GfdClearVramTransferManagerTask
 
   Description:  Clears internal VRAM transfer tasks for the VRAM transfer manager.
+                The fences of the cleared tasks are regarded as passed.
 
   Arguments:    None.
 
@@ -414,13 +579,27 @@ NNS_GfdInitVramTransferManager
 void 
 NNS_GfdClearVramTransferManagerTask( )
 {
+    OSIntrMode  intrMode = OS_DisableInterrupts();
+    
     ResetTaskQueue_( &s_VramTransferManager.taskQueue );
+    s_VramTransferManager.fenceDone = s_VramTransferManager.fenceRegistered;
+    s_VramTransferManager.numFlush  = 0;
+    
+    (void)OS_RestoreInterrupts( intrMode );
 }
 
 /*---------------------------------------------------------------------------*
   Name:         NNS_GfdDoVramTransfer
 
   Description:  Runs registered VRAM transfer tasks.
+                
+                When a budget is set by NNS_GfdSetVramTransferBudget,
+                the transmission stops when the budget is reached and
+                the remaining tasks are run by the next call.
+                A task larger than the remaining amount is transmitted in parts.
+                At least one task (or part) is transmitted per call.
+                The tasks requested by NNS_GfdRequestVramTransferFlush are
+                transmitted regardless of the budget.
 
   Arguments:    None.
 
@@ -431,25 +610,105 @@ NNS_GfdClearVramTransferManagerTask( )
 void
 NNS_GfdDoVramTransfer( )
 {
-    NNSGfdVramTransferManager* pMan = &s_VramTransferManager;
-    NNSGfdVramTransferTask* pTask
-        = NNSi_GfdGetFrontVramTransferTaskQueue( &pMan->taskQueue );
-
-    while( NNSi_GfdPopVramTransferTaskQueue( &pMan->taskQueue ) )
+    NNSGfdVramTransferManager*      pMan    = &s_VramTransferManager;
+    NNSGfdVramTransferTaskQueue*    pQueue  = &pMan->taskQueue;
+    NNSGfdVramTransferStats*        pStats  = &pMan->stats;
+    u32                             szRest  = ( pMan->szByteBudget > 0 ) ? pMan->szByteBudget : 0xffffffff;
+    OSTick                          tickStart = 0;
+    BOOL                            isOverrun = FALSE;
+    u32                             numFlush  = pMan->numFlush;
+    
+    pMan->numFlush = 0;
+    
+    if( pMan->tickBudget > 0 )
+    {
+        tickStart = OS_GetTick();
+    }
+    
+    pStats->szByte      = 0;
+    pStats->numTasks    = 0;
+    
+    while( !IsVramTransferTaskQueueEmpty_( pQueue ) )
     {
-        DoTransfer_( pTask );
+        NNSGfdVramTransferTask* pTask = NNSi_GfdGetFrontVramTransferTaskQueue( pQueue );
         
-        pMan->taskQueue.totalSize -= pTask->szByte;
+        // A task registered with no size is only removed.
+        if( pTask->szByte > 0 )
+        {
+            const BOOL isFirst  = ( pStats->numTasks == 0 ) ? TRUE: FALSE;
+            const BOOL isFlush  = ( numFlush > 0 ) ? TRUE: FALSE;
+            
+            if( !isFirst && !isFlush && pMan->tickBudget > 0 &&
+                OS_GetTick() - tickStart >= pMan->tickBudget )
+            {
+                isOverrun = TRUE;
+                break;
+            }
+            
+            if( pTask->szByte > szRest && !isFlush )
+            {
+                const u32 szPart = szRest & ~3;
+                
+                if( IsSplittableType_( pTask->type ) && szPart > 0 )
+                {
+                    // Transmit the first part and leave the rest in the task.
+                    DoTransfer_( pTask, szPart );
+                    
+                    pTask->pSrc     = (u8*)pTask->pSrc + szPart;
+                    pTask->dstAddr  += szPart;
+                    pTask->szByte   -= szPart;
+                    pQueue->totalSize -= szPart;
+                    
+                    pStats->szByte  += szPart;
+                    pStats->numTasks++;
+                    isOverrun = TRUE;
+                    break;
+                }
+                else if( !isFirst )
+                {
+                    isOverrun = TRUE;
+                    break;
+                }
+                // The first task is transmitted as a whole so that the queue progresses.
+            }
+            
+            DoTransfer_( pTask, pTask->szByte );
+            
+            szRest = ( pTask->szByte < szRest ) ? szRest - pTask->szByte : 0;
+            pStats->szByte += pTask->szByte;
+            pStats->numTasks++;
+        }
         
-        pTask = NNSi_GfdGetFrontVramTransferTaskQueue( &pMan->taskQueue );
-    }    
+        pQueue->totalSize -= pTask->szByte;
+        (void)NNSi_GfdPopVramTransferTaskQueue( pQueue );
+        
+        if( numFlush > 0 )
+        {
+            numFlush--;
+        }
+    }
+    
+    if( isOverrun )
+    {
+        pStats->numOverrun++;
+    }
+    pStats->szDeferred  = pQueue->totalSize;
+    pStats->tick        = ( pMan->tickBudget > 0 ) ? OS_GetTick() - tickStart : 0;
+    
+    UpdateFenceDone_( pMan );
 }
 
-
 /*---------------------------------------------------------------------------*
   Name:         NNS_GfdRegisterNewVramTransferTask
 
   Description:  Registers new VRAM transfer tasks.
+                
+                A task that continues the last registered task
+                (the same type, contiguous source and destination) is merged into it.
+                The registered tasks of the same type whose destination is included
+                in the new destination are dropped and their slots are reused.
+                When the new task can be neither merged nor registered,
+                nothing is changed and FALSE is returned.
 
   Arguments:    type:       The type of the transmission destination
                 dstAddr:       transmission destination address
@@ -469,26 +728,174 @@ NNS_GfdRegisterNewVramTransferTask
     u32                         szByte
 )
 {
-    NNSGfdVramTransferManager*  pMan = &s_VramTransferManager;
+    NNSGfdVramTransferManager*      pMan    = &s_VramTransferManager;
+    NNSGfdVramTransferTaskQueue*    pQueue  = &pMan->taskQueue;
+    BOOL                            result  = FALSE;
+    BOOL                            isMerge = FALSE;
+    BOOL                            isFlush = FALSE;
+    u16                             numDrop = 0;
+    u32                             fence;
+    OSIntrMode                      intrMode;
+    
+    // NNS_GfdDoVramTransfer may be called in the V-Blank interrupt.
+    intrMode = OS_DisableInterrupts();
+    
+    //
+    // Decides how the new task is registered before changing the queue.
+    //
+    if( !IsVramTransferTaskQueueEmpty_( pQueue ) && IsSplittableType_( type ) )
+    {
+        const NNSGfdVramTransferTask* pLast = GetLastTask_( pQueue );
+        
+        // The last task ends where the new task starts, so it is never dropped.
+        isMerge = ( pLast->type == type && pLast->szByte > 0 &&
+                    pLast->dstAddr + pLast->szByte == dstAddr &&
+                    (u8*)pLast->pSrc + pLast->szByte == (u8*)pSrc ) ? TRUE: FALSE;
+        numDrop = CountCoveredTasks_( pQueue, type, dstAddr, szByte );
+    }
+    
+    if( !isMerge && numDrop == 0 && IsVramTransferTaskQueueFull_( pQueue ) )
+    {
+        (void)OS_RestoreInterrupts( intrMode );
+        return FALSE;
+    }
     
-    if( !IsVramTransferTaskQueueFull_( &pMan->taskQueue ) )
+    fence = pMan->fenceRegistered + 1;
+    if( numDrop > 0 )
+    {
+        // Overwritten by the new task
+        fence = DropCoveredTasks_( pMan, type, dstAddr, szByte, fence, &isFlush );
+    }
+    
+    if( isMerge )
+    {
+        // Continues the last task
+        NNSGfdVramTransferTask* pLast = GetLastTask_( pQueue );
+        
+        if( IsFenceNotAfter_( fence, pLast->fence ) )
+        {
+            pLast->fence = fence;
+        }
+        pLast->szByte += szByte;
+        pQueue->totalSize += szByte;
+        pMan->stats.numMerged++;
+        result = TRUE;
+    }
+    else
     {
         NNSGfdVramTransferTask* pTask =
-            NNSi_GfdGetEndVramTransferTaskQueue( &pMan->taskQueue );
+            NNSi_GfdGetEndVramTransferTaskQueue( pQueue );
 
         pTask->type     = type;
         pTask->pSrc     = pSrc;
         pTask->dstAddr  = dstAddr;
         pTask->szByte   = szByte;
+        pTask->fence    = fence;
 
-        (void)NNSi_GfdPushVramTransferTaskQueue( &pMan->taskQueue );
+        (void)NNSi_GfdPushVramTransferTaskQueue( pQueue );
         
-        pMan->taskQueue.totalSize += pTask->szByte;
+        pQueue->totalSize += pTask->szByte;
 
-        return TRUE;
+        result = TRUE;
+    }
+    
+    if( isFlush )
+    {
+        // The new task writes the destination of a task to be flushed.
+        pMan->numFlush = pQueue->numTasks;
     }
+    
+    pMan->fenceRegistered++;
+    UpdateFenceDone_( pMan );
+    
+    (void)OS_RestoreInterrupts( intrMode );
 
-    return FALSE;
+    return result;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_GfdGetVramTransferFence
+
+  Description:  Gets the fence of the tasks registered so far.
+                When NNS_GfdIsVramTransferFenceDone returns TRUE for the fence,
+                the tasks registered so far have been transmitted.
+                
+                Use the fence to know when data registered for the transmission
+                is in VRAM, since the tasks beyond the budget are deferred.
+
+  Arguments:    None.
+
+  Returns:      fence of the tasks registered so far
+
+ *---------------------------------------------------------------------------*/
+u32 
+NNS_GfdGetVramTransferFence( void )
+{
+    return s_VramTransferManager.fenceRegistered;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_GfdIsVramTransferFenceDone
+
+  Description:  Determines whether the tasks registered before the fence
+                have been transmitted.
+                A task dropped because a later task overwrites its destination
+                is regarded as transmitted with the later task.
+
+  Arguments:    fence:      fence obtained with NNS_GfdGetVramTransferFence
+
+  Returns:      TRUE if the tasks have been transmitted
+
+ *---------------------------------------------------------------------------*/
+BOOL 
+NNS_GfdIsVramTransferFenceDone( u32 fence )
+{
+    return IsFenceNotAfter_( fence, s_VramTransferManager.fenceDone );
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_GfdRequestVramTransferFlush
+
+  Description:  Requests that the tasks registered so far be transmitted
+                by the next NNS_GfdDoVramTransfer regardless of the budget.
+                
+                Use this for data that must be in VRAM at the next V-Blank,
+                such as the textures moved by defragmentation.
+
+  Arguments:    None.
+
+  Returns:      None.
+
+ *---------------------------------------------------------------------------*/
+void 
+NNS_GfdRequestVramTransferFlush( void )
+{
+    OSIntrMode  intrMode = OS_DisableInterrupts();
+    
+    // The tasks dropped later only make the count larger than needed.
+    s_VramTransferManager.numFlush = s_VramTransferManager.taskQueue.numTasks;
+    
+    (void)OS_RestoreInterrupts( intrMode );
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_GfdGetNumFreeVramTransferTasks
+
+  Description:  Gets the number of tasks that can be registered.
+                NNS_GfdRegisterNewVramTransferTask never fails
+                while this number is not 0.
+
+  Arguments:    None.
+
+  Returns:      number of free entries of the task queue
+
+ *---------------------------------------------------------------------------*/
+u32 
+NNS_GfdGetNumFreeVramTransferTasks( void )
+{
+    const NNSGfdVramTransferTaskQueue* pQueue = &s_VramTransferManager.taskQueue;
+    
+    return pQueue->lengthOfArray - pQueue->numTasks;
 }
 
 /*---------------------------------------------------------------------------*
@@ -507,3 +914,61 @@ NNS_GfdGetVramTransferTaskTotalSize()
     return s_VramTransferManager.taskQueue.totalSize;
 }
 
+/*---------------------------------------------------------------------------*
+  Name:         NNS_GfdSetVramTransferBudget
+
+  Description:  Sets the budget of each call of NNS_GfdDoVramTransfer.
+                The tasks beyond the budget are transmitted by the next call.
+
+  Arguments:    szByte:     maximum amount transmitted per call (0: no limit)
+                tick:       maximum time of the transmission per call (0: no limit)
+                            The tick system must be initialized with OS_InitTick.
+
+  Returns:      None.
+
+ *---------------------------------------------------------------------------*/
+void 
+NNS_GfdSetVramTransferBudget
+(
+    u32                         szByte,
+    OSTick                      tick
+)
+{
+    s_VramTransferManager.szByteBudget  = szByte;
+    s_VramTransferManager.tickBudget    = tick;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_GfdGetVramTransferStats
+
+  Description:  Gets the transmission statistics.
+
+  Arguments:    pStats:     pointer to the statistics to be written
+
+  Returns:      None.
+
+ *---------------------------------------------------------------------------*/
+void 
+NNS_GfdGetVramTransferStats( NNSGfdVramTransferStats* pStats )
+{
+    NNS_GFD_NULL_ASSERT( pStats );
+    
+    *pStats = s_VramTransferManager.stats;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_GfdResetVramTransferStats
+
+  Description:  Resets the transmission statistics.
+
+  Arguments:    None.
+
+  Returns:      None.
+
+ *---------------------------------------------------------------------------*/
+void 
+NNS_GfdResetVramTransferStats( void )
+{
+    MI_CpuClear32( &s_VramTransferManager.stats, sizeof( NNSGfdVramTransferStats ) );
+}
+
@@ -22,6 +22,7 @@
 #include <nnsys/g2d/g2d_Animation.h>
 #include <nnsys/g2d/g2d_CellAnimation.h>
 #include <nnsys/g2d/g2d_MultiCellAnimation.h>
+#include <nnsys/g2d/g2d_CellAnimScheduler.h>
 #include <nnsys/g2d/g2d_Softsprite.h>
 #include <nnsys/g2d/g2d_OamSoftwareSpriteDraw.h>
 #include <nnsys/g2d/g2d_OAM.h>
@@ -43,6 +44,7 @@
 #include <nnsys/g2d/g2d_Font.h>
 #include <nnsys/g2d/g2d_CharCanvas.h>
 #include <nnsys/g2d/g2d_TextCanvas.h>
+#include <nnsys/g2d/g2d_TextLayout.h>
 
 
 #endif // NNS_G2D_H_
\ No newline at end of file
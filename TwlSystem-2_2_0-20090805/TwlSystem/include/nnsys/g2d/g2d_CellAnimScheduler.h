@@ -0,0 +1,198 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - include - nnsys - g2d
+  File:     g2d_CellAnimScheduler.h
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#ifndef NNS_G2D_CELLANIMSCHEDULER_H_
+#define NNS_G2D_CELLANIMSCHEDULER_H_
+
+#include <nitro.h>
+#include <nnsys/g2d/g2d_config.h>
+#include <nnsys/g2d/g2d_CellAnimation.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NNS_G2D_CELLANIMSCHEDULER_INVALID_HANDLE    0xFFFF  // Invalid scheduler handle
+#define NNS_G2D_CELLANIMSCHEDULER_NONE              0xFFFF  // Terminator of the entry lists
+
+/*---------------------------------------------------------------------------*
+  Name:         NNSG2dCellAnimSchedulerCallBack
+
+  Description:  Callback called once per tick with the cell animations
+                whose animation frame changed in the tick.
+
+ *---------------------------------------------------------------------------*/
+typedef void (*NNSG2dCellAnimSchedulerCallBack)
+(
+    NNSG2dCellAnimation* const*  ppChanged,
+    u16                          numChanged,
+    u32                          param
+);
+
+/*---------------------------------------------------------------------------*
+  Name:         NNSG2dCellAnimSchedulerEntry
+
+  Description:  Cell animation registered to the scheduler
+
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG2dCellAnimSchedulerEntry
+{
+    NNSG2dCellAnimation*    pCellAnim;      // Cell animation (NULL if the entry is free)
+    u32                     baseTick;       // Tick up to which animCtrl.currentTime is advanced
+    u32                     wakeTick;       // Tick at which the animation frame changes
+    u16                     next;           // Next entry in the wheel slot (or in the free list)
+    u16                     prev;           // Previous entry in the wheel slot
+    u16                     slot;           // Wheel slot (NNS_G2D_CELLANIMSCHEDULER_NONE if not scheduled)
+    u16                     pad16_;         // Padding
+
+}NNSG2dCellAnimSchedulerEntry;
+
+/*---------------------------------------------------------------------------*
+  Name:         NNSG2dCellAnimScheduler
+
+  Description:  Cell animation scheduler
+
+                Keeps the cell animations in a timing wheel indexed by the tick at
+                which their animation frame changes next, and touches only the cell
+                animations whose animation frame changes at each tick.
+
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG2dCellAnimScheduler
+{
+    NNSG2dCellAnimSchedulerEntry*   pEntry;         // Entries (numEntryMax)
+    NNSG2dCellAnimation**           pChanged;       // Cell animations changed in the last tick (numEntryMax)
+    u16*                            pWheel;         // First entry of each wheel slot (numSlot)
+
+    u16                             numEntryMax;    // Number of entries
+    u16                             numSlot;        // Number of wheel slots (power of 2)
+    u16                             numEntry;       // Number of registered cell animations
+    u16                             freeIdx;        // First free entry
+
+    u32                             currentTick;    // Number of ticks done
+    fx32                            frames;         // Time advanced by a tick (in frames)
+
+    NNSG2dCellAnimSchedulerCallBack pCallBack;      // Callback called with the changed cell animations
+    u32                             callBackParam;  // Parameter passed to the callback
+
+    // statistics of the last NNS_G2dTickCellAnimScheduler
+    u16                             numChanged;     // Cell animations whose animation frame changed
+    u16                             numVisited;     // Entries of the wheel slot examined
+
+}NNSG2dCellAnimScheduler;
+
+
+//------------------------------------------------------------------------------
+// Function Prototypes
+//------------------------------------------------------------------------------
+
+u32 NNS_G2dGetCellAnimSchedulerWorkSize( u16 numEntryMax, u16 numSlot );
+
+void NNS_G2dInitCellAnimScheduler
+(
+    NNSG2dCellAnimScheduler*    pSched,
+    void*                       pWork,
+    u16                         numEntryMax,
+    u16                         numSlot,
+    fx32                        frames
+);
+
+void NNS_G2dSetCellAnimSchedulerCallBack
+(
+    NNSG2dCellAnimScheduler*            pSched,
+    NNSG2dCellAnimSchedulerCallBack     pCallBack,
+    u32                                 param
+);
+
+u16 NNS_G2dAddCellAnimScheduler
+(
+    NNSG2dCellAnimScheduler*    pSched,
+    NNSG2dCellAnimation*        pCellAnim
+);
+
+void NNS_G2dRemoveCellAnimScheduler
+(
+    NNSG2dCellAnimScheduler*    pSched,
+    u16                         handle
+);
+
+void NNS_G2dSyncCellAnimScheduler
+(
+    NNSG2dCellAnimScheduler*    pSched,
+    u16                         handle
+);
+
+void NNS_G2dRescheduleCellAnimScheduler
+(
+    NNSG2dCellAnimScheduler*    pSched,
+    u16                         handle
+);
+
+u16 NNS_G2dTickCellAnimScheduler( NNSG2dCellAnimScheduler* pSched );
+
+
+//------------------------------------------------------------------------------
+// Inline functions
+//------------------------------------------------------------------------------
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGetCellAnimSchedulerChangedList
+
+  Description:  Gets the cell animations whose animation frame changed in the
+                last NNS_G2dTickCellAnimScheduler.
+
+  Arguments:    pSched:         [IN]  cell animation scheduler
+                pNumChanged:    [OUT] number of cell animations
+
+  Returns:      Array of the cell animations
+
+ *---------------------------------------------------------------------------*/
+NNS_G2D_INLINE NNSG2dCellAnimation* const* NNS_G2dGetCellAnimSchedulerChangedList
+(
+    const NNSG2dCellAnimScheduler*  pSched,
+    u16*                            pNumChanged
+)
+{
+    NNS_G2D_NULL_ASSERT( pSched );
+    NNS_G2D_NULL_ASSERT( pNumChanged );
+
+    *pNumChanged = pSched->numChanged;
+    return pSched->pChanged;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGetCellAnimSchedulerNumEntry
+
+  Description:  Gets the number of cell animations registered to the scheduler.
+
+  Arguments:    pSched:         [IN]  cell animation scheduler
+
+  Returns:      Number of registered cell animations
+
+ *---------------------------------------------------------------------------*/
+NNS_G2D_INLINE u16 NNS_G2dGetCellAnimSchedulerNumEntry
+(
+    const NNSG2dCellAnimScheduler*  pSched
+)
+{
+    NNS_G2D_NULL_ASSERT( pSched );
+    return pSched->numEntry;
+}
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif // NNS_G2D_CELLANIMSCHEDULER_H_
@@ -169,6 +169,25 @@ typedef struct NNSiG2dCharCanvasVTable
 }
 NNSiG2dCharCanvasVTable;
 
+// Glyph raster cache
+// Keeps the glyph images expanded to 4 bits per pixel, 8 pixels per u32.
+typedef struct NNSG2dGlyphRasterCache
+{
+    const u8**  pTag;           // glyph image of each entry (NULL if the entry is empty)
+    u32*        pRaster;        // expanded glyph images
+    u32         mask;           // number of entries - 1
+    u32         cellSize;       // bytes of a glyph image
+    u16         rowWords;       // u32 per line of an expanded glyph, including one for padding
+    u16         entryWords;     // u32 per expanded glyph
+    u8          cellWidth;      // glyph image width
+    u8          cellHeight;     // glyph image height
+    u8          bpp;            // number of bits in 1 dot of the glyph image
+    u8          reserved;
+    u32         numHit;         // number of glyphs found in the cache
+    u32         numMiss;        // number of glyphs expanded
+}
+NNSG2dGlyphRasterCache;
+
 // CharCanvas structure
 typedef struct NNSG2dCharCanvas
 {
@@ -179,6 +198,7 @@ typedef struct NNSG2dCharCanvas
     u8      reserved[3];
     u32     param;
     const NNSiG2dCharCanvasVTable* vtable;
+    NNSG2dGlyphRasterCache* pRasterCache;   // NULL if not used
 }
 NNSG2dCharCanvas;
 
@@ -577,6 +597,111 @@ void NNS_G2dCharCanvasInitForOBJ2DRect(
 
 
 
+/*---------------------------------------------------------------------------*
+  Name:         NNSi_G2dCharCanvasGetCharPtr
+
+  Description:  Gets the pointer to the character at the specified position in CharCanvas.
+
+  Arguments:    pCC:    Pointer to CharCanvas.
+                cx:     X position of the character (in character units)
+                cy:     Y position of the character (in character units)
+
+  Returns:      Pointer to the character.
+ *---------------------------------------------------------------------------*/
+u8* NNSi_G2dCharCanvasGetCharPtr(
+    const NNSG2dCharCanvas* pCC,
+    int cx,
+    int cy
+);
+
+
+
+//----------------------------------------------------------------------------
+// Glyph Raster Cache
+//----------------------------------------------------------------------------
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGlyphRasterCacheGetBufferSize
+
+  Description:  Calculates the size of the buffer required by a glyph raster cache.
+
+  Arguments:    pFont:      Pointer to the font to cache.
+                            The font must be 1, 2 or 4 bpp.
+                numEntry:   Number of glyphs in the cache. Must be a power of 2.
+
+  Returns:      Required buffer size in bytes.
+ *---------------------------------------------------------------------------*/
+u32 NNS_G2dGlyphRasterCacheGetBufferSize(
+    const NNSG2dFont* pFont,
+    u32 numEntry
+);
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGlyphRasterCacheInit
+
+  Description:  Initializes the glyph raster cache.
+                The glyph raster cache keeps the glyph images of the font already
+                expanded, so that a glyph drawn several times is read from the font only once.
+                The cache can only be used with the font specified here.
+
+  Arguments:    pCache:     Pointer to the glyph raster cache.
+                pFont:      Pointer to the font to cache.
+                            The font must be 1, 2 or 4 bpp.
+                pBuffer:    Pointer to the buffer of the cache. Must be 4-byte aligned.
+                            The size is given by NNS_G2dGlyphRasterCacheGetBufferSize.
+                numEntry:   Number of glyphs in the cache. Must be a power of 2.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dGlyphRasterCacheInit(
+    NNSG2dGlyphRasterCache* pCache,
+    const NNSG2dFont* pFont,
+    void* pBuffer,
+    u32 numEntry
+);
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGlyphRasterCacheClear
+
+  Description:  Empties the glyph raster cache.
+                Call this after changing the glyph images of the font.
+
+  Arguments:    pCache:     Pointer to the glyph raster cache.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dGlyphRasterCacheClear( NNSG2dGlyphRasterCache* pCache );
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dCharCanvasSetGlyphRasterCache
+
+  Description:  Configures the glyph raster cache used by CharCanvas.
+                Only glyphs of the font of the cache can be rendered while it is set.
+                Several CharCanvases can share a cache.
+
+  Arguments:    pCC:        Pointer to CharCanvas.
+                pCache:     Pointer to the glyph raster cache.
+                            Specify NULL to stop using the cache.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+NNS_G2D_INLINE void NNS_G2dCharCanvasSetGlyphRasterCache(
+    NNSG2dCharCanvas* pCC,
+    NNSG2dGlyphRasterCache* pCache
+)
+{
+    NNS_G2D_CHARCANVAS_ASSERT( pCC );
+    pCC->pRasterCache = pCache;
+}
+
+
+
 /*---------------------------------------------------------------------------*
   Name:         NNS_G2dCharCanvasMakeCell1D
 
@@ -24,6 +24,8 @@ extern "C" {
 
 #include <nitro.h>
 #include <nnsys/g2d/fmt/g2d_Vec_data.h>
+#include <nnsys/g2d/fmt/g2d_Cell_data.h>
+#include <nnsys/g2d/g2d_RendererCore.h>
 
 /*---------------------------------------------------------------------------*
   Name:         NNS_G2dIsInViewCircle
@@ -42,6 +44,32 @@ extern "C" {
  *---------------------------------------------------------------------------*/
 BOOL NNS_G2dIsInViewCircle( const NNSG2dFVec2* pvUL, const NNSG2dFVec2* pvSize, const NNSG2dFVec2* pos, fx32 boundingR );
 
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dIsCellInViewRect
+
+  Description:  Determines if a cell is in the visible area (rectangle).
+                The cell's bounding rectangle is transformed by the matrix and
+                its enclosing rectangle is tested against the visible area.
+                When the cell has no bounding rectangle, the square enclosing
+                the bounding sphere is used instead.
+                
+                This can be set as the visibility culling function of
+                NNSG2dRenderSurface (pFuncVisibilityCulling).
+                
+  Arguments:    pCell:           Cell data
+                pMtx:            Conversion matrix of the cell
+                pViewRect:       Visible area
+                
+  Returns:      In visible area?
+  
+ *---------------------------------------------------------------------------*/
+BOOL NNS_G2dIsCellInViewRect
+(
+    const NNSG2dCellData*   pCell,
+    const MtxFx32*          pMtx,
+    const NNSG2dViewRect*   pViewRect
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -52,6 +52,8 @@ extern "C" {
 
 #define NNS_G2D_GLYPH_INDEX_NOT_FOUND   0xFFFF
 
+#define NNSi_G2D_GLYPH_CACHE_HASH( c )  ((u32)((c) ^ ((c) >> 7)))
+
 
 
 
@@ -60,11 +62,35 @@ extern "C" {
 // Font Definitions
 //*****************************************************************************
 
+// glyph cache entry
+typedef struct NNSG2dGlyphCacheEntry
+{
+    u16 ccode;                          // character code
+    u16 index;                          // glyph index (NNS_G2D_GLYPH_INDEX_NOT_FOUND if none)
+    const NNSG2dCharWidths* pWidths;    // Pointer to the width information. NULL if the entry is empty.
+}
+NNSG2dGlyphCacheEntry;
+
+
+
+// glyph cache
+typedef struct NNSG2dGlyphCache
+{
+    NNSG2dGlyphCacheEntry*  pEntry;     // Entry array (the number of entries is a power of 2)
+    u32                     mask;       // Number of entries - 1
+    u32                     numHit;     // Number of lookups found in the cache
+    u32                     numMiss;    // Number of lookups that searched the font
+}
+NNSG2dGlyphCache;
+
+
+
 // Font
 typedef struct NNSG2dFont
 {
     NNSG2dFontInformation*   pRes;          // Pointer to the expanded font resource
     NNSiG2dSplitCharCallback cbCharSpliter; // Pointer to the string encoding process callback
+    NNSG2dGlyphCache*        pCache;        // Pointer to the glyph cache. NULL if not used.
 }
 NNSG2dFont;
 
@@ -116,6 +142,82 @@ void NNS_G2dFontInitCP1252(NNSG2dFont* pFont, void* pNftrFile);
 
 
 
+//*****************************************************************************
+// Glyph Cache
+//*****************************************************************************
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGlyphCacheInit
+
+  Description:  Initializes the glyph cache.
+                The glyph cache keeps the glyph index and the character width
+                information of the character codes looked up recently.
+                Each character code has a single slot (direct mapping).
+
+  Arguments:    pCache:     Pointer to the glyph cache.
+                pEntry:     Pointer to the entry array.
+                numEntry:   Number of entries in pEntry. Must be a power of 2.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dGlyphCacheInit(
+    NNSG2dGlyphCache*       pCache,
+    NNSG2dGlyphCacheEntry*  pEntry,
+    u32                     numEntry
+);
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGlyphCacheClear
+
+  Description:  Empties all the entries of the glyph cache.
+                Call this after changing the code map or the width blocks of the font.
+
+  Arguments:    pCache:     Pointer to the glyph cache.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dGlyphCacheClear( NNSG2dGlyphCache* pCache );
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dFontSetGlyphCache
+
+  Description:  Attaches the glyph cache to the font.
+                The cache is emptied. A glyph cache must not be shared by several fonts.
+
+  Arguments:    pFont:      Pointer to the font.
+                pCache:     Pointer to the glyph cache.
+                            Specify NULL to stop using the cache.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dFontSetGlyphCache( NNSG2dFont* pFont, NNSG2dGlyphCache* pCache );
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGlyphCacheResetStats
+
+  Description:  Resets the hit and miss counts of the glyph cache.
+
+  Arguments:    pCache:     Pointer to the glyph cache.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+NNS_G2D_INLINE void NNS_G2dGlyphCacheResetStats( NNSG2dGlyphCache* pCache )
+{
+    NNS_G2D_POINTER_ASSERT( pCache );
+    pCache->numHit  = 0;
+    pCache->numMiss = 0;
+}
+
+
+
+
+
 //*****************************************************************************
 // Font Operations
 //*****************************************************************************
@@ -150,6 +252,22 @@ const NNSG2dCharWidths* NNS_G2dFontGetCharWidthsFromIndex(
 
 
 
+/*---------------------------------------------------------------------------*
+  Name:         NNSi_G2dFontGetCachedCharWidths
+
+  Description:  Gets the character width information from the character code
+                through the glyph cache of the font.
+
+  Arguments:    pFont:  Pointer to the font. A glyph cache must be attached.
+                c:      character code
+
+  Returns:      Pointer to the character width information.
+ *---------------------------------------------------------------------------*/
+const NNSG2dCharWidths* NNSi_G2dFontGetCachedCharWidths(
+                                        const NNSG2dFont* pFont, u16 c );
+
+
+
 
 
 //*****************************************************************************
@@ -548,6 +666,11 @@ NNS_G2D_INLINE const NNSG2dCharWidths* NNS_G2dFontGetCharWidths(
 
     NNS_G2D_FONT_ASSERT( pFont );
 
+    if( pFont->pCache != NULL )
+    {
+        return NNSi_G2dFontGetCachedCharWidths( pFont, c );
+    }
+
     iGlyph = NNS_G2dFontGetGlyphIndex( pFont, c );
     return NNS_G2dFontGetCharWidthsFromIndex( pFont, iGlyph );
 }
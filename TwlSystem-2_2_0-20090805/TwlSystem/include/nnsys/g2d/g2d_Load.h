@@ -34,6 +34,7 @@ extern "C" {
 #include <nnsys/g2d/load/g2d_NCL_load.h>
 #include <nnsys/g2d/load/g2d_NSC_load.h>
 #include <nnsys/g2d/load/g2d_NFT_load.h>
+#include <nnsys/g2d/load/g2d_ResLoader.h>
 
 //------------------------------------------------------------------------------
 #define BIN_FILE_VERSION( EXT ) NNS_G2dMakeVersionData( NNS_G2D_##EXT##_MAJOR_VER, NNS_G2D_##EXT##_MINOR_VER )
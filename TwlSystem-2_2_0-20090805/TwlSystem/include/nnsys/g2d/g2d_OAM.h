@@ -88,6 +88,116 @@ typedef struct NNSG2dOAMManageArea
     u16     currentIdx;             // Currently registered location number
 }NNSG2dOAMManageArea;
 
+/*---------------------------------------------------------------------------*
+  Name:         NNSG2dOamSortStats
+
+  Description:  Statistics of the sort buffer for 1 frame
+                
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG2dOamSortStats
+{
+    u16     numEntry;           // Number of registered OAM attributes
+    u16     numEntryOverflow;   // Number of OAM attributes rejected because the sort buffer was full
+    u16     numApplyOverflow;   // Number of OAM attributes not applied because the manage area was full
+    u16     maxApplyOBJ;        // Maximum number of OBJs requested by one apply
+}NNSG2dOamSortStats;
+
+/*---------------------------------------------------------------------------*
+  Name:         NNSG2dOamSortBuffer
+
+  Description:  Sort buffer
+                Holds the OAM attributes registered to an OamManager instance
+                with their sort keys, and sorts them when they are applied.
+                
+                The first apply of a frame takes a snapshot of the registered OAM attributes 
+                in sorted order and of the affine parameters of the manage area, and the 
+                applies read only the snapshot. The OAM attributes and affine parameters 
+                of the next frame can be registered while the line ranges of the current 
+                frame are still being applied.
+                
+ *---------------------------------------------------------------------------*/
+#define NNS_G2D_OAMSORT_NUM_AFFINE  32  // Number of affine parameters the snapshot can hold
+
+typedef struct NNSG2dOamSortBuffer
+{
+    GXOamAttr*          pAttr;          // Registered OAM attributes (numEntry elements)
+    u16*                pKey;           // Sort key of each OAM attribute (numEntry elements)
+    u16*                pOrder;         // Registration numbers in sorted order (numEntry elements)
+    u16*                pBucket;        // Work for the bucket sort (numKey + 1 elements)
+    GXOamAttr*          pDispAttr;      // Snapshot: OAM attributes in sorted order (numEntry elements)
+    
+    u16                 numEntry;       // Number of OAM attributes that can be registered
+    u16                 numKey;         // Number of sort keys (0 to numKey - 1)
+    u16                 numUsed;        // Number of registered OAM attributes
+    u16                 bSnapshot;      // Whether the snapshot holds all registered OAM attributes
+    u16                 numDisp;        // Number of OAM attributes in the snapshot
+    s16                 prevToLine;     // Last line of the previous applied range (-1 if none)
+    u16                 dispAffineFrom; // First affine index in the snapshot
+    u16                 numDispAffine;  // Number of affine parameters in the snapshot
+    u16                 bDispLast;      // Whether the snapshot belongs to lastStats (reset after the snapshot)
+    u16                 pad16_;         // Padding
+    s16                 dispAffine[NNS_G2D_OAMSORT_NUM_AFFINE][4]; // Snapshot: affine parameters (PA, PB, PC, PD)
+    
+    NNSG2dOamSortStats  stats;          // Statistics of the current frame
+    NNSG2dOamSortStats  lastStats;      // Statistics of the previous frame
+    
+}NNSG2dOamSortBuffer;
+
+/*---------------------------------------------------------------------------*
+  Name:         NNSG2dOamAffineOverflowMode
+
+  Description:  Behavior of the affine cache when the affine parameter manage area is full
+                
+ *---------------------------------------------------------------------------*/
+typedef enum NNSG2dOamAffineOverflowMode
+{
+    NNS_G2D_OAMAFFINE_OVERFLOW_FAIL = 0,    // Returns NNS_G2D_OAM_AFFINE_IDX_NONE (same as without the cache)
+    NNS_G2D_OAMAFFINE_OVERFLOW_NEAREST      // Returns the registered affine parameter nearest to the requested one
+    
+}NNSG2dOamAffineOverflowMode;
+
+#define NNS_G2D_OAMAFFINE_CACHE_NUM_ENTRY   32  // Number of affine parameters of the affine cache
+#define NNS_G2D_OAMAFFINE_CACHE_NUM_HASH    64  // Size of the hash table of the affine cache
+
+/*---------------------------------------------------------------------------*
+  Name:         NNSG2dOamAffineCacheStats
+
+  Description:  Statistics of the affine cache for 1 frame
+                
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG2dOamAffineCacheStats
+{
+    u16     numRequest;     // Number of affine parameters requested
+    u16     numShared;      // Number of requests that shared a registered affine parameter (slots saved)
+    u16     numOverflow;    // Number of requests made while the manage area was full
+    u16     numFallback;    // Number of overflowed requests given the nearest affine parameter
+}NNSG2dOamAffineCacheStats;
+
+/*---------------------------------------------------------------------------*
+  Name:         NNSG2dOamAffineCache
+
+  Description:  Affine cache
+                Shares an affine parameter among the OBJs registered with the same 
+                affine transformation matrix during a frame.
+                
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG2dOamAffineCache
+{
+    s32                         key      [NNS_G2D_OAMAFFINE_CACHE_NUM_ENTRY][4];  // Quantized PA, PB, PC, PD
+    u16                         affineIdx[NNS_G2D_OAMAFFINE_CACHE_NUM_ENTRY];     // Affine index
+    u8                          hashTbl  [NNS_G2D_OAMAFFINE_CACHE_NUM_HASH];      // Entry number + 1 (0 if empty)
+    
+    u16                         numUsed;        // Number of registered affine parameters
+    u16                         quantizeShift;  // Number of low bits of the s7.8 parameters ignored
+    NNSG2dOamAffineOverflowMode overflowMode;   // Behavior when the manage area is full
+    
+    NNSG2dOamAffineCacheStats   stats;          // Statistics of the current frame
+    NNSG2dOamAffineCacheStats   lastStats;      // Statistics of the previous frame
+    
+    struct NNSG2dOamAffineCache* pNext;         // Next affine cache set to an instance of the same OAM type
+    
+}NNSG2dOamAffineCache;
+
 /*---------------------------------------------------------------------------*
   Name:         NNSG2dOamManagerInstance
 
@@ -105,6 +215,8 @@ typedef struct NNSG2dOamManagerInstance
     u16                   pad16_;              // Padding
     BOOL                  bFastTransferEnable; // Set during initialization. (User should not manipulate this.)
     fx32                  spriteZoffsetStep;   // The value of the automatic offset used when the sprite is rendered
+    NNSG2dOamSortBuffer*  pSortBuffer;         // Sort buffer (NULL if OAM attributes are applied in registration order)
+    NNSG2dOamAffineCache* pAffineCache;        // Affine cache (NULL if affine parameters are not shared)
     
 }NNSG2dOamManagerInstance;
 
@@ -162,6 +274,14 @@ BOOL NNS_G2dEntryOamManagerOamWithAffineIdx
     u16                         affineIdx 
 );
 
+BOOL NNS_G2dEntryOamManagerOamWithSortKey
+( 
+    NNSG2dOamManagerInstance*   pMan, 
+    const GXOamAttr*            pOam, 
+    u16                         affineIdx,
+    u16                         sortKey 
+);
+
 void NNS_G2dSetOamManagerAffine
 ( 
     NNSG2dOamType               type, 
@@ -174,6 +294,13 @@ u16  NNS_G2dEntryOamManagerAffine( NNSG2dOamManagerInstance* pMan, const MtxFx22
                         
 void NNS_G2dApplyOamManagerToHW( NNSG2dOamManagerInstance* pMan );
 
+void NNS_G2dApplyOamManagerToHWForLines
+( 
+    NNSG2dOamManagerInstance*   pMan, 
+    int                         fromLine, 
+    int                         toLine 
+);
+
 void NNS_G2dApplyOamManagerToHWSprite
 ( 
     NNSG2dOamManagerInstance*       pMan, 
@@ -191,6 +318,35 @@ u16  NNS_G2dGetOamManagerAffineCapacity( NNSG2dOamManagerInstance* pMan );
 
 GXOamAttr* NNS_G2dGetOamBuffer( NNSG2dOamType type );
 
+u32  NNS_G2dGetOamSortBufferWorkSize( u16 numEntry, u16 numKey );
+
+void NNS_G2dInitOamSortBuffer
+( 
+    NNSG2dOamSortBuffer*        pSortBuffer, 
+    void*                       pWork, 
+    u16                         numEntry, 
+    u16                         numKey 
+);
+
+void NNS_G2dSetOamManagerSortBuffer
+( 
+    NNSG2dOamManagerInstance*   pMan, 
+    NNSG2dOamSortBuffer*        pSortBuffer 
+);
+
+void NNS_G2dInitOamAffineCache
+( 
+    NNSG2dOamAffineCache*       pAffineCache, 
+    u16                         quantizeShift, 
+    NNSG2dOamAffineOverflowMode overflowMode 
+);
+
+void NNS_G2dSetOamManagerAffineCache
+( 
+    NNSG2dOamManagerInstance*   pMan, 
+    NNSG2dOamAffineCache*       pAffineCache 
+);
+
 //------------------------------------------------------------------------------
 // inline 
 //------------------------------------------------------------------------------
@@ -208,6 +364,28 @@ NNS_G2D_INLINE void NNS_G2dSetOamManagerSpriteZoffsetStep
     pMan->spriteZoffsetStep = zStep;
 }   
 
+NNS_G2D_INLINE const NNSG2dOamSortStats* NNS_G2dGetOamManagerSortStats
+( 
+    const NNSG2dOamManagerInstance*   pMan 
+)
+{
+    NNS_G2D_NULL_ASSERT( pMan );
+    NNS_G2D_NULL_ASSERT( pMan->pSortBuffer );
+    
+    return &pMan->pSortBuffer->lastStats;
+}
+
+NNS_G2D_INLINE const NNSG2dOamAffineCacheStats* NNS_G2dGetOamManagerAffineCacheStats
+( 
+    const NNSG2dOamManagerInstance*   pMan 
+)
+{
+    NNS_G2D_NULL_ASSERT( pMan );
+    NNS_G2D_NULL_ASSERT( pMan->pAffineCache );
+    
+    return &pMan->pAffineCache->lastStats;
+}
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
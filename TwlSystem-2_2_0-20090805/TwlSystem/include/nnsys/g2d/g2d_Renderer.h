@@ -54,6 +54,7 @@ extern "C" {
   
   Arguments:    pCell: Cell
                 pMtx: Conversion matrix
+                      (The flip of the renderer is applied to the cell local axes.)
                 pTrans: translation value
                
   Returns:      If visible, TRUE
@@ -218,6 +219,21 @@ typedef enum NNSG2dRendererOverwriteParam
 // OBJMode
 // mosaic ON/OFF
 
+/*---------------------------------------------------------------------------*
+  Name:         NNSG2dRendererCullingStats
+
+  Description:  This is the number of cells rendered and culled by the renderer.
+                A cell rendered to two surfaces is counted twice.
+                Reset by NNS_G2dBeginRendering().
+
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG2dRendererCullingStats
+{
+    u32         numCellDrawn;      // cells passed to the renderer core
+    u32         numCellCulled;     // cells culled by the visibility culling function
+
+}NNSG2dRendererCullingStats;
+
 /*---------------------------------------------------------------------------*
   Name:         NNSG2dRendererInstance
 
@@ -248,6 +264,8 @@ typedef struct NNSG2dRendererInstance
     
     u16                               overwritePlttNoOffset;// Palette number (add offset)
     u16                               pad16_;
+    
+    NNSG2dRendererCullingStats        cullingStats;        // cells rendered and culled since NNS_G2dBeginRendering
 }
 NNSG2dRendererInstance;
 
@@ -286,6 +304,13 @@ void NNS_G2dDrawMultiCellAnimation( const NNSG2dMultiCellAnimation* pMCAnim );
 
 void NNS_G2dDrawEntity         ( NNSG2dEntity* pEntity );
 
+void NNS_G2dDrawCellAnimationBatch
+( 
+    const NNSG2dCellAnimation* const*   ppCellAnim, 
+    const NNSG2dFVec2*                  pPosArray, 
+    u16                                 numCellAnim 
+);
+
 void NNS_G2dEndRendering   ( );
 
 //------------------------------------------------------------------------------
@@ -513,6 +538,18 @@ NNS_G2dIsRendererOverwriteEnable
 }
 
 
+//------------------------------------------------------------------------------
+// Accessor Culling Statistics
+NNS_G2D_INLINE const NNSG2dRendererCullingStats* NNS_G2dGetRendererCullingStats
+(
+    const NNSG2dRendererInstance* pRend
+)
+{
+    NNS_G2D_NULL_ASSERT( pRend );
+    return &pRend->cullingStats;
+}
+
+
 //------------------------------------------------------------------------------
 // Rendering Optimization Related Functions
 /*---------------------------------------------------------------------------*
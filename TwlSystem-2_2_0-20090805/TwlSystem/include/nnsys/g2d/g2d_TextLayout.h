@@ -0,0 +1,277 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - include - nnsys - g2d
+  File:     g2d_TextLayout.h
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+#ifndef G2D_TEXTLAYOUT_H_
+#define G2D_TEXTLAYOUT_H_
+
+#include <nnsys/g2d/g2d_TextCanvas.h>
+#include <nnsys/g2d/g2d_CellTransferManager.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//---------------------------------------------------------------------
+
+//---------------------------------------------------------------------
+// TextLayout Macros
+//---------------------------------------------------------------------
+#define NNS_G2D_TEXTLAYOUT_ASSERT( pLayout )                        \
+    NNS_G2D_ASSERTMSG(                                              \
+        NNS_G2D_IS_VALID_POINTER(pLayout)                           \
+            && NNS_G2D_IS_VALID_POINTER((pLayout)->pTxn)            \
+            && NNS_G2D_IS_VALID_POINTER((pLayout)->pGlyph[0])       \
+            && NNS_G2D_IS_VALID_POINTER((pLayout)->pGlyph[1])       \
+            && NNS_G2D_IS_VALID_POINTER((pLayout)->pDirty)          \
+        , "Illegal NNSG2dTextLayout." )
+
+// Number of visible characters when all the characters are visible
+#define NNS_G2D_TEXTLAYOUT_VISIBLE_ALL  0xFFFF
+
+
+
+//---------------------------------------------------------------------
+// TextLayout Definitions
+//---------------------------------------------------------------------
+
+// Character placed by the TextLayout
+typedef struct NNSG2dTextLayoutGlyph
+{
+    s16 x;              // render position (same as for NNS_G2dCharCanvasDrawChar)
+    s16 y;              // render position
+    u16 ccode;          // character code
+    u8  cl;             // color number
+    s8  left;           // left space width of the glyph
+    u8  glyphWidth;     // glyph width
+    u8  reserved;
+}
+NNSG2dTextLayoutGlyph;
+
+// TextLayout
+//
+// Keeps the characters placed on the CharCanvas, and renders again only
+// the characters of the CharCanvas changed since the last rendering.
+typedef struct NNSG2dTextLayout
+{
+    const NNSG2dTextCanvas* pTxn;       // TextCanvas used for layout and rendering
+    NNSG2dTextLayoutGlyph*  pGlyph[2];  // placed characters (current and work)
+    u16                     numGlyph;   // number of characters in pGlyph[0]
+    u16                     maxGlyph;   // number of elements in each pGlyph
+    u16                     numVisible; // number of visible characters
+    u16                     numDirty;   // number of characters of the CharCanvas to render again
+    u32*                    pDirty;     // characters of the CharCanvas to render again (1 bit each)
+    int                     bgColor;    // color number of the background
+
+    // statistics of the last NNS_G2dTextLayoutDraw
+    u32                     numDrawChar;    // characters of the CharCanvas rendered
+    u32                     numDrawGlyph;   // glyph renderings
+    u32                     numTransfer;    // transfer tasks registered
+}
+NNSG2dTextLayout;
+
+
+
+//---------------------------------------------------------------------
+// TextLayout Operations
+//---------------------------------------------------------------------
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dTextLayoutGetWorkSize
+
+  Description:  Calculates the size of the work buffer required by a TextLayout.
+
+  Arguments:    pTxn:       Pointer to the TextCanvas used by the TextLayout.
+                maxGlyph:   Maximum number of characters placed.
+
+  Returns:      Size of the work buffer in bytes.
+ *---------------------------------------------------------------------------*/
+u32 NNS_G2dTextLayoutGetWorkSize(
+    const NNSG2dTextCanvas* pTxn,
+    u16 maxGlyph
+);
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dTextLayoutInit
+
+  Description:  Initializes the TextLayout.
+                All the characters of the CharCanvas are rendered by the first
+                NNS_G2dTextLayoutDraw.
+
+  Arguments:    pLayout:    Pointer to the TextLayout to initialize.
+                pTxn:       Pointer to the TextCanvas used for layout and rendering.
+                            It must stay valid while the TextLayout is used.
+                            The font must be written horizontally from left to right.
+                bgColor:    Color number of the background.
+                pWork:      Pointer to the work buffer. Must be 4-byte aligned.
+                            The size is given by NNS_G2dTextLayoutGetWorkSize.
+                maxGlyph:   Maximum number of characters placed.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dTextLayoutInit(
+    NNSG2dTextLayout* pLayout,
+    const NNSG2dTextCanvas* pTxn,
+    int bgColor,
+    void* pWork,
+    u16 maxGlyph
+);
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNSi_G2dTextLayoutSetText
+
+  Description:  Places a multi-line string and replaces the characters placed before.
+                Only the characters of the CharCanvas where the placed characters
+                differ are rendered again by NNS_G2dTextLayoutDraw.
+                Control characters other than the line feed are ignored.
+                The characters that exceed maxGlyph are not placed.
+
+  Arguments:    pLayout:    Pointer to the TextLayout.
+                x:          Upper left coordinate of the string.
+                y:          Upper left coordinate of the string.
+                cl:         Color number of character color.
+                wrapWidth:  Width after which a line is broken automatically.
+                            Specify 0 to break lines only at line feed characters.
+                txt:        String to be placed.
+
+  Returns:      Number of characters placed.
+ *---------------------------------------------------------------------------*/
+int NNSi_G2dTextLayoutSetText(
+    NNSG2dTextLayout* pLayout,
+    int x,
+    int y,
+    int cl,
+    int wrapWidth,
+    const void* txt
+);
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dTextLayoutSetVisibleCount
+
+  Description:  Configures the number of placed characters that are rendered.
+                This is used to display the characters one by one.
+                The positions of the placed characters are not calculated again.
+
+  Arguments:    pLayout:    Pointer to the TextLayout.
+                numVisible: Number of characters rendered from the first character.
+                            NNS_G2D_TEXTLAYOUT_VISIBLE_ALL renders all the characters.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dTextLayoutSetVisibleCount(
+    NNSG2dTextLayout* pLayout,
+    u16 numVisible
+);
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dTextLayoutInvalidate
+
+  Description:  Renders all the characters of the CharCanvas at the next NNS_G2dTextLayoutDraw.
+                Call this after the CharCanvas is modified without the TextLayout.
+
+  Arguments:    pLayout:    Pointer to the TextLayout.
+
+  Returns:      None.
+ *---------------------------------------------------------------------------*/
+void NNS_G2dTextLayoutInvalidate( NNSG2dTextLayout* pLayout );
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dTextLayoutDraw
+
+  Description:  Renders the characters of the CharCanvas changed since the last call.
+                Each of them is filled with the background color and the placed
+                characters that overlap it are rendered again, clipped to it.
+
+                When pRegisterFunc is not NULL, a VRAM transfer task is registered
+                for each run of rendered characters successive in memory.
+                The task transfers from the CharCanvas to
+                dstAddr + (offset of the character from the CharCanvas top).
+
+  Arguments:    pLayout:        Pointer to the TextLayout.
+                pRegisterFunc:  VRAM transfer task register function
+                                (NNS_GfdRegisterNewVramTransferTask, for example).
+                                NULL when the CharCanvas is in VRAM.
+                type:           Transfer destination type.
+                dstAddr:        Transfer destination address of the CharCanvas top.
+
+  Returns:      Number of characters of the CharCanvas rendered.
+ *---------------------------------------------------------------------------*/
+int NNS_G2dTextLayoutDraw(
+    NNSG2dTextLayout* pLayout,
+    VramTransferTaskRegisterFuncPtr pRegisterFunc,
+    NNS_GFD_DST_TYPE type,
+    u32 dstAddr
+);
+
+
+
+//--------
+// getter
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dTextLayoutGetNumGlyph
+
+  Description:  Gets the number of placed characters.
+
+  Arguments:    pLayout:    Pointer to the TextLayout.
+
+  Returns:      Number of placed characters.
+ *---------------------------------------------------------------------------*/
+NNS_G2D_INLINE int NNS_G2dTextLayoutGetNumGlyph( const NNSG2dTextLayout* pLayout )
+{
+    NNS_G2D_TEXTLAYOUT_ASSERT( pLayout );
+    return pLayout->numGlyph;
+}
+
+
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dTextLayoutIsDirty
+
+  Description:  Determines whether characters of the CharCanvas must be rendered again.
+
+  Arguments:    pLayout:    Pointer to the TextLayout.
+
+  Returns:      TRUE if NNS_G2dTextLayoutDraw has characters to render.
+ *---------------------------------------------------------------------------*/
+NNS_G2D_INLINE BOOL NNS_G2dTextLayoutIsDirty( const NNSG2dTextLayout* pLayout )
+{
+    NNS_G2D_TEXTLAYOUT_ASSERT( pLayout );
+    return (BOOL)(pLayout->numDirty > 0);
+}
+
+
+
+//---------------------------------------------------------------------
+
+NNS_G2D_INLINE int NNS_G2dTextLayoutSetText(NNSG2dTextLayout* pLayout, int x, int y, int cl, int wrapWidth, const NNSG2dChar* txt)
+    { return NNSi_G2dTextLayoutSetText(pLayout, x, y, cl, wrapWidth, txt); }
+
+//---------------------------------------------------------------------
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif
+
+#endif // G2D_TEXTLAYOUT_H_
+
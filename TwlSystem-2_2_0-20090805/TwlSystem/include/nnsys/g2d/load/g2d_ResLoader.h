@@ -0,0 +1,172 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - include - nnsys - g2d - load
+  File:     g2d_ResLoader.h
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#ifndef NNS_G2D_RESLOADER_H_
+#define NNS_G2D_RESLOADER_H_
+
+#include <nitro.h>
+#include <nnsys/fnd/allocator.h>
+#include <nnsys/g2d/g2d_config.h>
+#include <nnsys/g2d/g2d_Data.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------*
+  Name:         NNSG2dResType
+
+  Description:  Type of the resource loaded by the resource loader
+                (type of NNSG2dResLoadEntry.pRes)
+
+ *---------------------------------------------------------------------------*/
+typedef enum NNSG2dResType
+{
+    NNS_G2D_RESTYPE_CHARACTER = 0,      // NCGR for OBJ     (NNSG2dCharacterData*)
+    NNS_G2D_RESTYPE_BGCHARACTER,        // NCGR for BG      (NNSG2dCharacterData*)
+    NNS_G2D_RESTYPE_PALETTE,            // NCLR             (NNSG2dPaletteData*)
+    NNS_G2D_RESTYPE_CELLBANK,           // NCER             (NNSG2dCellDataBank*)
+    NNS_G2D_RESTYPE_ANIMBANK,           // NANR             (NNSG2dAnimBankData*)
+    NNS_G2D_RESTYPE_MULTICELLBANK,      // NMCR             (NNSG2dMultiCellDataBank*)
+    NNS_G2D_RESTYPE_MCANIMBANK,         // NMAR             (NNSG2dAnimBankData*)
+    NNS_G2D_RESTYPE_SCREEN,             // NSCR             (NNSG2dScreenData*)
+    NNS_G2D_RESTYPE_MAX
+
+}NNSG2dResType;
+
+/*---------------------------------------------------------------------------*
+  Name:         NNSG2dResLoadEntry
+
+  Description:  Resource file loaded by the resource loader
+
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG2dResLoadEntry
+{
+    const char*         pFname;     // File name
+    NNSG2dResType       type;       // Resource type
+
+    void*               pRes;       // [OUT] Unpacked resource (NULL if loading failed)
+    void*               pFile;      // [OUT] File image in the arena (NULL if not allocated)
+
+}NNSG2dResLoadEntry;
+
+/*---------------------------------------------------------------------------*
+  Name:         NNSG2dResLoader
+
+  Description:  Resource loader
+
+                Reads a batch of resource files into an arena and unpacks them
+                on a worker thread. The next file is read from the ROM while the
+                current one is unpacked.
+
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG2dResLoader
+{
+    OSThread                thread;         // Worker thread
+    void*                   pStackBottom;   // Stack bottom of the worker thread
+    u32                     stackSize;      // Stack size of the worker thread
+    u32                     threadPrio;     // Priority of the worker thread
+    BOOL                    bStarted;       // Has the worker thread been created?
+
+    FSFile                  file[2];        // Files read alternately
+    NNSFndAllocator*        pAllocator;     // Arena for the file images
+    NNSG2dResLoadEntry*     pEntry;         // Resource files of the batch
+    u16                     numEntry;       // Number of resource files of the batch
+    volatile u16            numDone;        // Resource files processed (loaded or failed)
+    u16                     numFailed;      // Resource files that failed to load
+    u16                     pad16_;         // Padding
+
+    // statistics of the last batch (valid when all the resource files are processed)
+    u32                     szTotal;        // Bytes read
+    OSTick                  tickTotal;      // Time from the start to the end of the batch
+    OSTick                  tickWaitRead;   // Time the worker thread waited for ROM reads
+    OSTick                  tickUnpack;     // Time spent unpacking
+
+}NNSG2dResLoader;
+
+
+//------------------------------------------------------------------------------
+// Function Prototypes
+//------------------------------------------------------------------------------
+
+void NNS_G2dInitResLoader
+(
+    NNSG2dResLoader*        pLoader,
+    void*                   pStack,
+    u32                     stackSize,
+    u32                     threadPrio
+);
+
+void NNS_G2dStartResLoader
+(
+    NNSG2dResLoader*        pLoader,
+    NNSG2dResLoadEntry*     pEntry,
+    u16                     numEntry,
+    NNSFndAllocator*        pAllocator
+);
+
+BOOL NNS_G2dWaitResLoader( NNSG2dResLoader* pLoader );
+
+
+//------------------------------------------------------------------------------
+// Inline functions
+//------------------------------------------------------------------------------
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dGetResLoaderNumDone
+
+  Description:  Gets the number of resource files of the batch already processed.
+                The entries are processed in order, so the first entries of this
+                number can be used.
+
+  Arguments:    pLoader:        [IN]  resource loader
+
+  Returns:      Number of resource files processed (loaded or failed)
+
+ *---------------------------------------------------------------------------*/
+NNS_G2D_INLINE u16 NNS_G2dGetResLoaderNumDone
+(
+    const NNSG2dResLoader*  pLoader
+)
+{
+    NNS_G2D_NULL_ASSERT( pLoader );
+    return pLoader->numDone;
+}
+
+/*---------------------------------------------------------------------------*
+  Name:         NNS_G2dIsResLoaderBusy
+
+  Description:  Determines whether the resource files of the batch are being loaded.
+
+  Arguments:    pLoader:        [IN]  resource loader
+
+  Returns:      TRUE if some resource files are not processed yet
+
+ *---------------------------------------------------------------------------*/
+NNS_G2D_INLINE BOOL NNS_G2dIsResLoaderBusy
+(
+    const NNSG2dResLoader*  pLoader
+)
+{
+    NNS_G2D_NULL_ASSERT( pLoader );
+    return (BOOL)( pLoader->numDone < pLoader->numEntry );
+}
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif // NNS_G2D_RESLOADER_H_
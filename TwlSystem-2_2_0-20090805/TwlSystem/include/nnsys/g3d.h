@@ -41,5 +41,11 @@
 #include <nnsys/g3d/cgtool.h>
 #include <nnsys/g3d/mem.h>
 #include <nnsys/g3d/util.h>
+#include <nnsys/g3d/anmcache.h>
+#include <nnsys/g3d/sbccomp.h>
+#include <nnsys/g3d/cull.h>
+#include <nnsys/g3d/anmblend.h>
+#include <nnsys/g3d/lod.h>
+#include <nnsys/g3d/texstream.h>
 
 #endif
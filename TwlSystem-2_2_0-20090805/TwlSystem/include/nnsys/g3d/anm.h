@@ -159,6 +159,60 @@ typedef struct NNSG3dJntAnmResult_
 NNSG3dJntAnmResult;
 
 
+/*---------------------------------------------------------------------------*
+    NNSG3dJntAnmBatchBaseFlag
+
+    Flags indicating the channels of NNSG3dJntAnmBatchResult that use the SRT of the model.
+ *---------------------------------------------------------------------------*/
+typedef enum
+{
+    NNS_G3D_JNTANM_BATCH_BASE_T = 0x0001,
+    NNS_G3D_JNTANM_BATCH_BASE_R = 0x0002,
+    NNS_G3D_JNTANM_BATCH_BASE_S = 0x0004
+}
+NNSG3dJntAnmBatchBaseFlag;
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dJntAnmBatchResult
+
+    This is a structure for storing the joint animation of one joint evaluated by NNS_G3dJntAnmBatchCalc.
+    Since the scale calculation depends on the parent joints and the CG tool, only the scale and its reciprocal are held.
+    NNSG3dJntAnmResult is completed from this inside the NODEDESC command of SBC.
+    
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dJntAnmBatchResult_
+{
+    u16                    flag;      // NNSG3dJntAnmResultFlag
+    u16                    baseFlag;  // NNSG3dJntAnmBatchBaseFlag
+    fx32                   s_invs[6]; // Sx, Sy, Sz, 1/Sx, 1/Sy, 1/Sz
+    MtxFx33                rot;
+    VecFx32                trans;
+}
+NNSG3dJntAnmBatchResult;
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dJntAnmBatch
+
+    Holds the joint animation evaluated for all the joints of one resource and frame.
+    Use NNS_G3dAnmObjSetJntAnmBatch to associate it with NNSG3dAnmObj.
+    
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dJntAnmBatch_
+{
+    const void*              resAnm;    // Resource of the held results (NULL when not evaluated)
+    fx32                     frame;     // Frame of the held results
+    u32                      numResult; // Number of elements of pResult
+    NNSG3dJntAnmBatchResult* pResult;   // Results for each data index of the resource
+}
+NNSG3dJntAnmBatch;
+
+// Macro that calculates the size of the array passed to NNS_G3dJntAnmBatchInit
+#define NNS_G3D_JNTANM_BATCH_BUFFER_SIZE(numJnt) \
+    ((u32)(sizeof(NNSG3dJntAnmBatchResult) * (numJnt)))
+
+
 /*---------------------------------------------------------------------------*
     About the visibility animation operations
 
@@ -215,6 +269,18 @@ BOOL NNSi_G3dAnmBlendVis(NNSG3dVisAnmResult*,
                          const NNSG3dAnmObj*,
                          u32);
 
+//
+// Batched evaluation of joint animation (.nsbca)
+// Evaluates all the joints of a frame at once instead of one joint at a time from the SBC.
+//
+void NNS_G3dJntAnmBatchInit(NNSG3dJntAnmBatch* pBatch,
+                            NNSG3dJntAnmBatchResult* pResult,
+                            u32 numResult);
+void NNS_G3dAnmObjSetJntAnmBatch(NNSG3dAnmObj* pAnmObj,
+                                 NNSG3dJntAnmBatch* pBatch);
+BOOL NNS_G3dJntAnmBatchCalc(NNSG3dJntAnmBatch* pBatch,
+                            const NNSG3dAnmObj* pAnmObj);
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // Global Variables
@@ -37,6 +37,10 @@ void NNSi_G3dAnmObjInitNsBca(NNSG3dAnmObj* pAnmObj,
 void NNSi_G3dAnmCalcNsBca(NNSG3dJntAnmResult* pResult,
                           const NNSG3dAnmObj* pAnmObj,
                           u32 dataIdx);
+
+void NNSi_G3dAnmCalcNsBcaBatch(NNSG3dJntAnmResult* pResult,
+                               const NNSG3dAnmObj* pAnmObj,
+                               u32 dataIdx);
 #endif
 
 
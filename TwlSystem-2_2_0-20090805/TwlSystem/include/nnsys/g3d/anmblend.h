@@ -0,0 +1,161 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - include - nnsys - g3d
+  File:     anmblend.h
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#ifndef NNSG3D_ANMBLEND_H_
+#define NNSG3D_ANMBLEND_H_
+
+#include <nnsys/g3d/config.h>
+#include <nnsys/g3d/kernel.h>
+#include <nnsys/g3d/anm.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------*
+    Summary of the joint blend tree:
+
+    NNSG3dJntBlendTree blends the joint animations of several layers into one pose.
+    The layers are applied in order on the pose of the model:
+
+    NNS_G3D_JNTBLEND_LERP
+        pose = pose * (1 - weight) + clip * weight
+    NNS_G3D_JNTBLEND_ADDITIVE
+        pose = pose + (clip - pose of the model) * weight
+
+    Each layer can be restricted to a part of the joints with a mask (bit vector of node IDs).
+    The rotations are blended as quaternions and converted to matrices only once per joint,
+    and the scales are blended before the scale compensation of the CG tool.
+
+    NNS_G3dJntBlendTreeCalc evaluates every layer once for all the joints (through NNSG3dJntAnmBatch)
+    and blends them. The render object reads the results through the animation object
+    of the tree (NNSG3dJntBlendTree::pAnmObj) added with NNS_G3dRenderObjAddAnmObj,
+    so NNSi_G3dAnmBlendJnt does not evaluate or blend anything.
+ *---------------------------------------------------------------------------*/
+
+// Maximum number of layers of a tree
+#define NNS_G3D_JNTBLEND_MAX_LAYER 8
+
+// anmHeader.category1 of NNSG3dJntBlendTree
+#define NNS_G3D_JNTBLENDTREE_CATEGORY1 'BT'
+
+/*---------------------------------------------------------------------------*
+    NNSG3dJntBlendMode
+
+    How a layer is applied to the pose.
+ *---------------------------------------------------------------------------*/
+typedef enum
+{
+    NNS_G3D_JNTBLEND_LERP     = 0,
+    NNS_G3D_JNTBLEND_ADDITIVE = 1
+}
+NNSG3dJntBlendMode;
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dJntBlendLayer
+
+    One layer of the tree.
+    pAnmObj must be a .nsbca animation object set with NNS_G3dAnmObjSetJntAnmBatch.
+    pMask is a bit vector of node IDs (NNS_G3D_SIZE_JNT_MAX bits). All the joints when NULL.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dJntBlendLayer_
+{
+    NNSG3dAnmObj* pAnmObj;
+    const u32*    pMask;
+    fx32          weight;
+    u32           mode;     // NNSG3dJntBlendMode
+}
+NNSG3dJntBlendLayer;
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dJntBlendPose
+
+    Blended pose of one joint.
+    quat is (x, y, z, w). s_invs holds the scale and its reciprocal.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dJntBlendPose_
+{
+    u32     flag;           // NNSG3dJntAnmResultFlag
+    fx32    quat[4];
+    VecFx32 trans;
+    fx32    s_invs[6];
+}
+NNSG3dJntBlendPose;
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dJntBlendTree
+
+    Layers of joint animations and the blended pose.
+    anmHeader lets pAnmObj be handled as a joint animation ('J', 'BT') by the render object.
+    revision is advanced by each NNS_G3dJntBlendTreeCalc. NNSG3dJntAnmCache keys the pose
+    of the tree with it, since the frame of pAnmObj does not change.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dJntBlendTree_
+{
+    NNSG3dResAnmHeader   anmHeader;
+    const NNSG3dResMdl*  resMdl;
+    u32                  numNode;
+    u32                  numLayer;
+    NNSG3dJntBlendLayer  layer[NNS_G3D_JNTBLEND_MAX_LAYER];
+
+    NNSG3dJntBlendPose*  pPose;     // Blended pose (numNode)
+    NNSG3dJntBlendPose*  pRest;     // Pose of the model (numNode)
+    NNSG3dAnmObj*        pAnmObj;   // Add to the render object with NNS_G3dRenderObjAddAnmObj
+    u32                  revision;  // Number of NNS_G3dJntBlendTreeCalc calls
+
+    // statistics of the last NNS_G3dJntBlendTreeCalc
+    u32                  numEval;   // Number of the joints of the layers blended
+    OSTick               tickCalc;
+}
+NNSG3dJntBlendTree;
+
+// Macro that calculates the size of the region passed to NNS_G3dJntBlendTreeInit
+#define NNS_G3D_JNTBLENDTREE_BUFFER_SIZE(numJnt)                        \
+    ((u32)(sizeof(NNSG3dJntBlendPose) * (numJnt) * 2 +                  \
+           ((sizeof(NNSG3dAnmObj) + sizeof(u16) * (numJnt) + 3) & ~3)))
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Function Declarations
+//
+
+void NNS_G3dJntBlendTreeInit(NNSG3dJntBlendTree* pTree,
+                             void* pBuf,
+                             u32 szBuf,
+                             const NNSG3dResMdl* pResMdl);
+int NNS_G3dJntBlendTreeAddLayer(NNSG3dJntBlendTree* pTree,
+                                NNSG3dAnmObj* pAnmObj,
+                                NNSG3dJntBlendMode mode,
+                                fx32 weight,
+                                const u32* pMask);
+void NNS_G3dJntBlendTreeSetWeight(NNSG3dJntBlendTree* pTree, int idxLayer, fx32 weight);
+void NNS_G3dJntBlendTreeCalc(NNSG3dJntBlendTree* pTree);
+
+void NNS_G3dJntBlendMaskAddSubtree(u32* pMask, const NNSG3dResMdl* pResMdl, u32 nodeID);
+
+void NNSi_G3dAnmCalcJntBlendTree(NNSG3dJntAnmResult* pResult,
+                                 const NNSG3dAnmObj* pAnmObj,
+                                 u32 dataIdx);
+
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif
+
+#endif // NNSG3D_ANMBLEND_H_
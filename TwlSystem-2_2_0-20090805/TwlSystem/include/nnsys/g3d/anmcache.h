@@ -0,0 +1,133 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - include - nnsys - g3d
+  File:     anmcache.h
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#ifndef NNSG3D_ANMCACHE_H_
+#define NNSG3D_ANMCACHE_H_
+
+#include <nnsys/g3d/config.h>
+#include <nnsys/g3d/kernel.h>
+#include <nnsys/g3d/anm.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------*
+    Summary of the joint animation result cache:
+
+    When several NNSG3dRenderObj structures draw the same model with the same joint animation at the same frame,
+    the joint calculation results (NNSG3dJntAnmResult) of all of them are identical.
+    NNSG3dJntAnmCache keeps the results recorded by the first NNSG3dRenderObj, and plays them back for the others.
+    The position of each model is set with NNS_G3dGlbSetBaseTrans and the like as usual,
+    so only the matrices of the joints are sent again.
+
+    The key is made of the model resource, the blend function, and the resource, calculation function,
+    frame and blend ratio of each joint animation object (up to NNS_G3D_JNTANMCACHE_MAX_ANM).
+    The pose of a joint blend tree does not depend on the frame of its animation object,
+    so the revision of the tree (advanced by NNS_G3dJntBlendTreeCalc) is also part of the key.
+    Callbacks that modify the joint calculation results and NNS_G3dAnmObjDisableID are not part of the key.
+    Do not draw render objects that use them through the cache.
+ *---------------------------------------------------------------------------*/
+
+// Maximum number of joint animation objects that can be blended in a cacheable render object
+#define NNS_G3D_JNTANMCACHE_MAX_ANM 4
+
+/*---------------------------------------------------------------------------*
+    NNSG3dJntAnmCacheKey
+
+    Everything that determines the joint calculation results of a render object.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dJntAnmCacheKey_
+{
+    const NNSG3dResMdl*   resMdl;       // NULL when the entry is unused
+    NNSG3dFuncAnmBlendJnt funcBlendJnt;
+    u32                   numAnm;
+    struct
+    {
+        const void*       resAnm;
+        void*             funcAnm;
+        fx32              frame;
+        fx32              ratio;
+        u32               revision;     // NNSG3dJntBlendTree::revision (0 for other animations)
+    }
+    anm[NNS_G3D_JNTANMCACHE_MAX_ANM];
+}
+NNSG3dJntAnmCacheKey;
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dJntAnmCacheEntry
+
+    Joint calculation results of one key.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dJntAnmCacheEntry_
+{
+    NNSG3dJntAnmCacheKey key;
+    u32                  hash;
+    u32                  stamp;         // Value of NNSG3dJntAnmCache::stamp when last used
+    NNSG3dJntAnmResult*  pResult;       // maxJnt elements
+}
+NNSG3dJntAnmCacheEntry;
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dJntAnmCache
+
+    Cache of joint calculation results shared by several render objects.
+    The statistics are counted from NNS_G3dJntAnmCacheInit or NNS_G3dJntAnmCacheResetStats.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dJntAnmCache_
+{
+    NNSG3dJntAnmCacheEntry* pEntry;
+    u32                     numEntry;
+    u32                     maxJnt;     // Maximum number of joints of a cacheable model
+    u32                     stamp;
+
+    // statistics
+    u32                     numHit;     // Number of draws that played back the results
+    u32                     numMiss;    // Number of draws that recorded the results
+    u32                     numBypass;  // Number of draws that could not use the cache
+    u32                     numEvict;   // Number of entries replaced by another key
+}
+NNSG3dJntAnmCache;
+
+// Macro that calculates the size of the buffer passed to NNS_G3dJntAnmCacheInit
+#define NNS_G3D_JNTANMCACHE_BUFFER_SIZE(numEntry, maxJnt) \
+    ((u32)((sizeof(NNSG3dJntAnmCacheEntry) + sizeof(NNSG3dJntAnmResult) * (maxJnt)) * (numEntry)))
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Function Declarations
+//
+
+void NNS_G3dJntAnmCacheInit(NNSG3dJntAnmCache* pCache,
+                            void* pBuf,
+                            u32 numEntry,
+                            u32 maxJnt);
+void NNS_G3dJntAnmCacheClear(NNSG3dJntAnmCache* pCache);
+BOOL NNS_G3dJntAnmCacheDraw(NNSG3dJntAnmCache* pCache,
+                            NNSG3dRenderObj* pRenderObj);
+
+void NNS_G3dJntAnmCacheResetStats(NNSG3dJntAnmCache* pCache);
+u32 NNS_G3dJntAnmCacheGetHitRate(const NNSG3dJntAnmCache* pCache);
+u32 NNS_G3dJntAnmCacheGetUsedSize(const NNSG3dJntAnmCache* pCache);
+
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,110 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - include - nnsys - g3d - binres
+  File:     res_name_index.h
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#ifndef NNSG3D_BINRES_RES_NAME_INDEX_H_
+#define NNSG3D_BINRES_RES_NAME_INDEX_H_
+
+#include <nnsys/g3d/binres/res_struct.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------*
+    Summary of the resource name index:
+
+    NNSG3dResNameIndex is a hash table of all the names in the dictionaries of one resource file.
+    While it is registered with NNS_G3dResNameIndexRegister,
+    NNS_G3dGetResDictIdxByName and NNS_G3dGetResDataByName (and all the XXXByName functions that use them)
+    look up the dictionaries of the file in the hash table instead of comparing names
+    or walking the Patricia tree.
+
+    The hash table is an open addressing table placed in a region given by the caller.
+    It does not modify the resource file. Dictionaries with fewer than
+    NNS_G3D_RESNAMEINDEX_MIN_ENTRY entries are not indexed, since a linear search is faster.
+    Unregister the index before discarding the resource file.
+ *---------------------------------------------------------------------------*/
+
+// Minimum number of entries of an indexed dictionary
+#define NNS_G3D_RESNAMEINDEX_MIN_ENTRY 4
+
+/*---------------------------------------------------------------------------*
+    NNSG3dResNameIndexEntry
+
+    One slot of the hash table.
+    hashIdx holds the upper 24 bits of the hash value and the index in the dictionary.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dResNameIndexEntry_
+{
+    const NNSG3dResDict* dict;          // NULL when the slot is unused
+    u32                  hashIdx;
+}
+NNSG3dResNameIndexEntry;
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dResNameIndex
+
+    Hash table of the dictionaries of one resource file.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dResNameIndex_
+{
+    struct NNSG3dResNameIndex_* next;   // List of registered indices
+    const u8*                   pBegin; // Range of the resource file
+    const u8*                   pEnd;
+    NNSG3dResNameIndexEntry*    pEntry;
+    u32                         mask;   // Number of slots - 1
+    u32                         numUsed;
+
+    // statistics
+    u32                         numLookup;
+    u32                         numProbe;
+}
+NNSG3dResNameIndex;
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Function Declarations
+//
+
+u32 NNS_G3dResNameIndexGetBufferSize(const NNSG3dResFileHeader* pResFile);
+void NNS_G3dResNameIndexInit(NNSG3dResNameIndex* pIndex,
+                             void* pBuf,
+                             u32 szBuf,
+                             const NNSG3dResFileHeader* pResFile);
+
+void NNS_G3dResNameIndexRegister(NNSG3dResNameIndex* pIndex);
+void NNS_G3dResNameIndexUnregister(NNSG3dResNameIndex* pIndex);
+
+BOOL NNSi_G3dResNameIndexFind(const NNSG3dResDict* dict,
+                              const NNSG3dResName* name,
+                              int* pIdx);
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Global Variables
+//
+
+// List of the registered indices
+extern NNSG3dResNameIndex* NNSi_G3dResNameIndexList;
+
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif
+
+#endif // NNSG3D_BINRES_RES_NAME_INDEX_H_
@@ -23,6 +23,7 @@
 #include <nnsys/g3d/binres/res_struct.h>
 
 #include <nnsys/g3d/binres/res_struct_accessor_anm.h>
+#include <nnsys/g3d/binres/res_name_index.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -0,0 +1,159 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - include - nnsys - g3d
+  File:     cull.h
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#ifndef NNSG3D_CULL_H_
+#define NNSG3D_CULL_H_
+
+#include <nnsys/g3d/config.h>
+#include <nnsys/g3d/kernel.h>
+#include <nnsys/g3d/sbc.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------*
+    Summary of the culling:
+
+    NNSG3dCuller holds the six planes of the view volume in world coordinates.
+    They are calculated by NNS_G3dCullerSetFrustum from the camera matrix and the projection matrix
+    set in NNS_G3dGlb, so the tests are done by the CPU and do not read the geometry engine.
+
+    The bounding box of a model (NNSG3dResMdlInfo::boxX etc.) is transformed
+    by the base matrix of NNS_G3dGlb (NNS_G3dGlbSetBaseTrans etc.), so a model can be tested
+    right before it is drawn, without flushing the global state.
+    The box is the one output by the converter, so the parts moved outside of it by
+    joint animations are not taken into account.
+
+    Per-node culling is done by NNS_G3dCullNodeCallBack set as the callback of the NODE command.
+    It hides the nodes whose bounding spheres (in model coordinates) are outside of the view volume.
+ *---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*
+    NNSG3dCullResult
+
+    Result of a test.
+ *---------------------------------------------------------------------------*/
+typedef enum
+{
+    NNS_G3D_CULL_OUTSIDE   = 0,     // Completely outside of the view volume
+    NNS_G3D_CULL_INTERSECT = 1,     // Crosses a plane of the view volume
+    NNS_G3D_CULL_INSIDE    = 2      // Completely inside of the view volume
+}
+NNSG3dCullResult;
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dCullSphere
+
+    Bounding sphere.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dCullSphere_
+{
+    VecFx32 center;
+    fx32    radius;
+}
+NNSG3dCullSphere;
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dCullBox
+
+    Oriented bounding box in world coordinates.
+    axis[i] are the half edges of the box from the center.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dCullBox_
+{
+    VecFx32 center;
+    VecFx32 axis[3];
+}
+NNSG3dCullBox;
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dCuller
+
+    View volume and statistics of the culling.
+    The statistics are counted from NNS_G3dCullerInit or NNS_G3dCullerResetStats.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dCuller_
+{
+    VecFx32 planeN[6];          // Normals of the planes, facing the inside
+    fx32    planeD[6];
+
+    // statistics
+    u32     numTest;            // Number of bounding volumes tested
+    u32     numCulled;          // Number of models culled by NNS_G3dCullerDraw
+    u32     numDrawn;           // Number of models drawn by NNS_G3dCullerDraw
+    u32     numNodeCulled;      // Number of nodes hidden by NNS_G3dCullNodeCallBack
+    OSTick  tickTest;           // Time taken by the tests
+    OSTick  tickDraw;           // Time taken by NNS_G3dDraw in NNS_G3dCullerDraw
+}
+NNSG3dCuller;
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dCullNodeInfo
+
+    Set with NNS_G3dRenderObjSetUserPtr in the render objects that use NNS_G3dCullNodeCallBack.
+    pSphere[nodeID] is the bounding sphere of the node in model coordinates.
+    The nodes with a radius of 0 are never hidden.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dCullNodeInfo_
+{
+    NNSG3dCuller*           pCuller;
+    const NNSG3dCullSphere* pSphere;
+    u32                     numNode;
+}
+NNSG3dCullNodeInfo;
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Function Declarations
+//
+
+void NNS_G3dCullerInit(NNSG3dCuller* pCuller);
+void NNS_G3dCullerSetFrustum(NNSG3dCuller* pCuller);
+void NNS_G3dCullerResetStats(NNSG3dCuller* pCuller);
+OSTick NNS_G3dCullerGetSavedTick(const NNSG3dCuller* pCuller);
+
+void NNS_G3dCullGetMdlBox(NNSG3dCullBox* pBox, const NNSG3dResMdl* pResMdl);
+void NNS_G3dCullGetSphere(NNSG3dCullSphere* pWorld, const NNSG3dCullSphere* pLocal);
+
+NNSG3dCullResult NNS_G3dCullerTestSphere(NNSG3dCuller* pCuller,
+                                         const NNSG3dCullSphere* pSphere);
+NNSG3dCullResult NNS_G3dCullerTestBox(NNSG3dCuller* pCuller,
+                                      const NNSG3dCullBox* pBox);
+NNSG3dCullResult NNS_G3dCullerTestMdl(NNSG3dCuller* pCuller,
+                                      const NNSG3dResMdl* pResMdl);
+u32 NNS_G3dCullerTestSphereArray(NNSG3dCuller* pCuller,
+                                 const NNSG3dCullSphere* pSphere,
+                                 u32 num,
+                                 u8* pResult);
+u32 NNS_G3dCullerTestBoxArray(NNSG3dCuller* pCuller,
+                              const NNSG3dCullBox* pBox,
+                              u32 num,
+                              u8* pResult);
+
+BOOL NNS_G3dCullerDraw(NNSG3dCuller* pCuller, NNSG3dRenderObj* pRenderObj);
+void NNS_G3dCullNodeCallBack(NNSG3dRS* rs);
+
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif
+
+#endif // NNSG3D_CULL_H_
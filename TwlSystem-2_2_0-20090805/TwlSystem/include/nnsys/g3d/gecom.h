@@ -54,6 +54,83 @@ typedef struct NNSG3dGeBuffer_
 NNSG3dGeBuffer;
 
 
+/*---------------------------------------------------------------------------*
+    NNSG3dGeRecorder
+
+    While it is set with NNSi_G3dGeBeginRecord, the geometry commands given to NNS_G3dGeBufferOP_N and NNS_G3dGeSendDL
+    are written to pBuf instead of being sent to the geometry engine.
+    They are written as a sequence of entries that start with a header word:
+
+    NNS_G3D_GEREC_TAG_DATA: followed by (header & NNS_G3D_GEREC_SIZE_MASK) words of geometry commands
+    NNS_G3D_GEREC_TAG_DL:   followed by the address and the size in bytes of a display list
+
+    When pBuf is NULL or too small, only the size is counted in idx.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dGeRecorder_
+{
+    u32* pBuf;
+    u32  szBuf;         // Size of pBuf in words
+    u32  idx;           // Number of words recorded, including the ones that did not fit in pBuf
+    u32  idxData;       // Index of the header of the current NNS_G3D_GEREC_TAG_DATA entry
+    BOOL isCopyDL;      // If TRUE, display lists are copied into NNS_G3D_GEREC_TAG_DATA entries
+}
+NNSG3dGeRecorder;
+
+#define NNS_G3D_GEREC_TAG_MASK  0xff000000
+#define NNS_G3D_GEREC_SIZE_MASK 0x00ffffff
+#define NNS_G3D_GEREC_TAG_DATA  0x01000000
+#define NNS_G3D_GEREC_TAG_DL    0x02000000
+#define NNS_G3D_GEREC_NO_DATA   0xffffffff
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dGeRing
+
+    A ring of geometry command buffers set with NNS_G3dGeSetRing.
+    The CPU writes the geometry commands to one buffer while the buffers filled before it
+    (and the display lists given to NNS_G3dGeSendDL) are sent to the geometry engine by DMA
+    in the order they were queued.
+    The next transfer in the queue is started from the DMA completion interrupt,
+    so the queue keeps draining while the CPU does other work.
+    When the geometry command FIFO is not less than half full at that time, the transfer is
+    started from the GXFIFO interrupt instead (unless NNS_G3dGeUseFastDma(TRUE) is set):
+    the GXFIFO interrupt handler and condition are replaced until then and restored afterwards.
+
+    The buffers are read by DMA, so do not allocate them in DTCM.
+    The CPU waits only when the next buffer or the queue is still in use.
+    That time is accumulated in tickStall, and the time waited in NNS_G3dGeFlushBuffer in tickFlush.
+ *---------------------------------------------------------------------------*/
+#define NNS_G3D_GERING_QUEUE_SIZE 16    // Must be a power of two
+#define NNS_G3D_GERING_MAX_BUFFER 32
+
+typedef struct NNSG3dGeRingReq_
+{
+    const void* src;
+    u32         szByte;
+    int         idxBuf;         // Index of the buffer, or -1 for a display list
+}
+NNSG3dGeRingReq;
+
+typedef struct NNSG3dGeRing_
+{
+    NNSG3dGeBuffer*  pBuf;
+    u32              numBuf;
+    u32              idxBuild;      // Buffer being written by the CPU
+    volatile u32     busyMask;      // Bit i is set while buffer i is queued
+    NNSG3dGeRingReq  queue[NNS_G3D_GERING_QUEUE_SIZE];
+    volatile u32     head;          // Request being transferred (advanced by the DMA interrupt)
+    u32              tail;          // Next request to be queued
+
+    // statistics (reset with NNS_G3dGeResetRingStats)
+    u32              numSubmit;     // Number of requests queued
+    u32              numStall;      // Number of times the CPU waited for a buffer or a queue entry
+    OSTick           tickStall;     // Time the CPU waited for a buffer or a queue entry
+    OSTick           tickFlush;     // Time the CPU waited for the queue to drain in NNS_G3dGeFlushBuffer
+    u32              highWater;     // Maximum number of requests queued at the same time
+}
+NNSG3dGeRing;
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // Function Declarations
@@ -144,6 +221,15 @@ void NNS_G3dGeSendDL(const void* src, u32 szByte);
 void NNS_G3dGeBufferOP_N(u32 op, const u32* args, u32 num);
 void NNS_G3dGeUseFastDma(BOOL cond); // Undocumented
 
+void NNS_G3dGeSetRing(NNSG3dGeRing* pRing, NNSG3dGeBuffer* pBuf, u32 numBuf);
+NNSG3dGeRing* NNS_G3dGeReleaseRing(void);
+void NNS_G3dGeKickRing(void);
+void NNS_G3dGeResetRingStats(NNSG3dGeRing* pRing);
+
+void NNSi_G3dGeBeginRecord(NNSG3dGeRecorder* p);
+void NNSi_G3dGeEndRecord(void);
+void NNSi_G3dGeRecordWord(NNSG3dGeRecorder* p, u32 data);
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // Global Variables
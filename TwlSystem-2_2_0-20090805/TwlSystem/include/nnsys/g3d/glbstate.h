@@ -44,6 +44,18 @@ typedef enum
     NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE = 0x00000040,
 
     NNS_G3D_GLB_FLAG_BASECAMERA_UPTODATE    = 0x00000080,
+    NNS_G3D_GLB_FLAG_INVBASEROT_UPTODATE    = 0x00000100,
+
+    // ON when the geometry engine holds the state sent by the last flush
+    // (set only while the dirty tracking is enabled)
+    NNS_G3D_GLB_FLAG_GE_PROJ_UPTODATE       = 0x00001000,   // Projection matrix (P or VP)
+    NNS_G3D_GLB_FLAG_GE_LIGHTVEC_UPTODATE   = 0x00002000,   // Light vectors
+    NNS_G3D_GLB_FLAG_GE_MATERIAL_UPTODATE   = 0x00004000,   // Material colors, PolygonAttr and ViewPort
+    NNS_G3D_GLB_FLAG_GE_LIGHTCOLOR_UPTODATE = 0x00008000,   // Light colors
+    NNS_G3D_GLB_FLAG_GE_UPTODATE_ALL        = 0x0000f000,
+
+    // ON when NNS_G3dGlbSetDirtyTracking(TRUE) was used
+    NNS_G3D_GLB_FLAG_DIRTY_TRACKING         = 0x00010000,
 
     NNS_G3D_GLB_FLAG_SRTCAMERA_UPTODATE     = NNS_G3D_GLB_FLAG_BASECAMERA_UPTODATE,
     NNS_G3D_GLB_FLAG_FLUSH_ALT              = NNS_G3D_GLB_FLAG_FLUSH_WVP
@@ -97,6 +109,12 @@ typedef struct
     VecFx32 camPos;
     VecFx32 camUp;
     VecFx32 camTarget;
+
+    MtxFx43 invBaseRotMtx;
+
+    // Number of words sent and skipped by the flushes
+    u32     numFlushWord;
+    u32     numSkipWord;
 }
 NNSG3dGlb;
 
@@ -144,6 +162,9 @@ void NNS_G3dGlbInit(void);
 void NNS_G3dGlbFlushP(void);
 void NNS_G3dGlbFlushVP(void);
 void NNS_G3dGlbFlushWVP(void);
+void NNS_G3dGlbSetDirtyTracking(BOOL isEnable);
+void NNS_G3dGlbInvalidate(void);
+void NNS_G3dGlbResetFlushStats(void);
 void NNS_G3dGlbSetBaseTrans(const VecFx32* pTrans);
 void NNS_G3dGlbSetBaseScale(const VecFx32* pScale);
 void NNS_G3dGlbLightVector(GXLightId lightID, fx16 x, fx16 y, fx16 z);
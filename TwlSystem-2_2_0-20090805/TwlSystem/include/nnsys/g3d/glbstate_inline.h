@@ -44,7 +44,9 @@ NNS_G3dGlbLookAt(const VecFx32 * camPos,
     NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVCAMERA_UPTODATE     |
                          NNS_G3D_GLB_FLAG_BASECAMERA_UPTODATE    |
                          NNS_G3D_GLB_FLAG_INVBASECAMERA_UPTODATE |
-                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE);
+                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE |
+                         NNS_G3D_GLB_FLAG_GE_PROJ_UPTODATE       |
+                         NNS_G3D_GLB_FLAG_GE_LIGHTVEC_UPTODATE);
 
 
 }
@@ -70,8 +72,9 @@ NNS_G3dGlbFrustum(fx32 t,
                 f,
                 &NNS_G3dGlb.projMtx);
 
-    NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVPROJ_UPTODATE |
-                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE);
+    NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVPROJ_UPTODATE       |
+                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE |
+                         NNS_G3D_GLB_FLAG_GE_PROJ_UPTODATE);
 }
 
 /*---------------------------------------------------------------------------*
@@ -95,8 +98,9 @@ NNS_G3dGlbFrustumW(fx32 t,
                  f,
                  scaleW,
                  &NNS_G3dGlb.projMtx);
-    NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVPROJ_UPTODATE |
-                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE);
+    NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVPROJ_UPTODATE       |
+                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE |
+                         NNS_G3D_GLB_FLAG_GE_PROJ_UPTODATE);
 }
 
 
@@ -118,8 +122,9 @@ NNS_G3dGlbPerspective(fx32 fovySin,
                     n,
                     f,
                     &NNS_G3dGlb.projMtx);
-    NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVPROJ_UPTODATE |
-                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE);
+    NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVPROJ_UPTODATE       |
+                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE |
+                         NNS_G3D_GLB_FLAG_GE_PROJ_UPTODATE);
 }
 
 
@@ -142,8 +147,9 @@ NNS_G3dGlbPerspectiveW(fx32 fovySin,
                      f,
                      scaleW,
                      &NNS_G3dGlb.projMtx);
-    NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVPROJ_UPTODATE |
-                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE);
+    NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVPROJ_UPTODATE       |
+                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE |
+                         NNS_G3D_GLB_FLAG_GE_PROJ_UPTODATE);
 }
 
 
@@ -166,8 +172,9 @@ NNS_G3dGlbOrtho(fx32 t,
               n,
               f,
               &NNS_G3dGlb.projMtx);
-    NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVPROJ_UPTODATE |
-                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE);
+    NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVPROJ_UPTODATE       |
+                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE |
+                         NNS_G3D_GLB_FLAG_GE_PROJ_UPTODATE);
 }
 
 
@@ -192,8 +199,9 @@ NNS_G3dGlbOrthoW(fx32 t,
                f,
                scaleW,
                &NNS_G3dGlb.projMtx);
-    NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVPROJ_UPTODATE |
-                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE);
+    NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVPROJ_UPTODATE       |
+                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE |
+                         NNS_G3D_GLB_FLAG_GE_PROJ_UPTODATE);
 }
 
 
@@ -206,8 +214,9 @@ NNS_G3dGlbSetProjectionMtx(const MtxFx44* m)
 {
     NNS_G3D_NULL_ASSERT(m);
     MI_CpuCopyFast(m, &NNS_G3dGlb.projMtx, sizeof(MtxFx44));
-    NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVPROJ_UPTODATE |
-                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE);
+    NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_INVPROJ_UPTODATE       |
+                         NNS_G3D_GLB_FLAG_INVCAMERAPROJ_UPTODATE |
+                         NNS_G3D_GLB_FLAG_GE_PROJ_UPTODATE);
 }
 
 
@@ -225,7 +234,14 @@ NNS_G3dGlbSetBaseRot(const MtxFx33* pRot)
     MTX_Copy33(pRot, &NNS_G3dGlb.prmBaseRot);
     NNS_G3dGlb.flag &= ~(NNS_G3D_GLB_FLAG_BASECAMERA_UPTODATE |
                          NNS_G3D_GLB_FLAG_INVBASE_UPTODATE   |
-                         NNS_G3D_GLB_FLAG_INVBASECAMERA_UPTODATE);
+                         NNS_G3D_GLB_FLAG_INVBASECAMERA_UPTODATE |
+                         NNS_G3D_GLB_FLAG_INVBASEROT_UPTODATE);
+
+    // NNS_G3dGlbFlushWVP sends the light vectors in the local coordinates.
+    if (NNS_G3dGlb.flag & NNS_G3D_GLB_FLAG_FLUSH_WVP)
+    {
+        NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_GE_LIGHTVEC_UPTODATE;
+    }
 }
 
 
@@ -239,6 +255,7 @@ NNS_G3dGlbSetViewPort(int x1, int y1, int x2, int y2)
     GX_VIEWPORT_ASSERT(x1, y1, x2, y2);
 
     NNS_G3dGlb.prmViewPort = GX_PACK_VIEWPORT_PARAM(x1, y1, x2, y2);
+    NNS_G3dGlb.flag &= ~NNS_G3D_GLB_FLAG_GE_MATERIAL_UPTODATE;
 }
 
 /*---------------------------------------------------------------------------*
@@ -95,6 +95,7 @@ typedef struct NNSG3dAnmObj_
     void*                 funcAnm;    // Cast in the function pointer of each animation. Takes the default, but can be changed.
     struct NNSG3dAnmObj_* next;
     const NNSG3dResTex*   resTex;     // When the information about the texture  block is needed (the texture pattern animation only)
+    struct NNSG3dJntAnmBatch_* jntAnmBatch; // Results of the batched joint animation evaluation (joint animation only, normally NULL)
     u8                    priority;
     u8                    numMapData;
     u16                   mapData[1]; // Becomes numMapData array (NNSG3dAnmObjMapData)
@@ -0,0 +1,145 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - include - nnsys - g3d
+  File:     lod.h
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#ifndef NNSG3D_LOD_H_
+#define NNSG3D_LOD_H_
+
+#include <nnsys/g3d/config.h>
+#include <nnsys/g3d/kernel.h>
+#include <nnsys/g3d/anm.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------*
+    Summary of the level of detail:
+
+    NNSG3dLodObj holds one NNSG3dRenderObj per level of detail, from the most detailed model.
+    NNS_G3dLodMgrDraw measures the size of the model on the screen (in pixels)
+    with NNS_G3dWorldPosToScrPos, and draws the render object of the level selected by the size.
+
+    Small models also update their joint animations less often.
+    The pose is calculated every 'interval' frames (recorded with NNS_G3D_RENDEROBJ_FLAG_RECORD)
+    and the frames in between are drawn with the pose interpolated between the last two calculations.
+    The interpolated pose is therefore up to 'interval' frames behind the animation.
+    The material animations are calculated every frame.
+
+    NNSG3dLodMgr also limits the number of vertices drawn and the number of joints calculated per frame.
+    A model that does not fit in the remaining vertices is drawn with a coarser level (or not at all),
+    and a model that does not fit in the remaining joints keeps its last pose.
+    Draw the important models (near the camera) first.
+ *---------------------------------------------------------------------------*/
+
+// Maximum number of levels of an NNSG3dLodObj
+#define NNS_G3D_LOD_MAX_LEVEL   4
+
+// Number of size thresholds that halve the animation rate (1/2, 1/4, 1/8)
+#define NNS_G3D_LOD_MAX_ANMRATE 3
+
+// No budget
+#define NNS_G3D_LOD_BUDGET_NONE 0xffffffff
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dLodObj
+
+    Render objects of the levels of one model and the poses used to interpolate the animation.
+    pRenderObj[0] is the most detailed level.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dLodObj_
+{
+    NNSG3dRenderObj*    pRenderObj[NNS_G3D_LOD_MAX_LEVEL];
+    u32                 numLevel;
+    u32                 maxJnt;
+
+    NNSG3dJntAnmResult* pPrev;      // Pose of the calculation before the last one (maxJnt)
+    NNSG3dJntAnmResult* pCur;       // Pose of the last calculation (maxJnt)
+    NNSG3dJntAnmResult* pOut;       // Interpolated pose (maxJnt)
+
+    int                 size;       // Size on the screen in pixels at the last draw
+    u16                 level;      // Level of the last draw
+    u16                 interval;   // Number of frames between the calculations of the pose
+    u16                 phase;      // Number of frames drawn since the last calculation
+    u16                 isValid;    // pPrev and pCur hold poses of the render object of 'level'
+}
+NNSG3dLodObj;
+
+// Macro that calculates the size of the buffer passed to NNS_G3dLodObjInit
+#define NNS_G3D_LODOBJ_BUFFER_SIZE(maxJnt) \
+    ((u32)(sizeof(NNSG3dJntAnmResult) * (maxJnt) * 3))
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dLodMgr
+
+    Thresholds of the levels, budgets per frame and statistics.
+
+    levelSize[i] is the smallest size (pixels) drawn with level i or a more detailed level.
+    A model smaller than levelSize[i] is drawn with level i + 1 or a coarser level.
+    A model smaller than anmRateSize[i] halves its animation rate once more.
+    Thresholds set to 0 are not used.
+    A level becomes more detailed only when the size exceeds its threshold by 'hysteresis' pixels.
+
+    The budgets and statistics are counted from NNS_G3dLodMgrBeginFrame.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dLodMgr_
+{
+    int     levelSize[NNS_G3D_LOD_MAX_LEVEL - 1];
+    int     anmRateSize[NNS_G3D_LOD_MAX_ANMRATE];
+    int     hysteresis;
+
+    u32     maxVtx;         // Budget of vertices per frame
+    u32     maxJnt;         // Budget of joint calculations per frame
+    u32     numVtx;         // Vertices drawn in this frame
+    u32     numJnt;         // Joints calculated in this frame
+
+    // statistics
+    u32     numDraw[NNS_G3D_LOD_MAX_LEVEL];     // Models drawn per level
+    u32     numSkip;        // Models not drawn because of the vertex budget
+    u32     numCoarse;      // Models drawn with a coarser level because of the vertex budget
+    u32     numAnmCalc;     // Poses calculated
+    u32     numAnmInterp;   // Poses interpolated
+    u32     numAnmDefer;    // Calculations postponed because of the joint budget
+}
+NNSG3dLodMgr;
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Function Declarations
+//
+
+void NNS_G3dLodObjInit(NNSG3dLodObj* pObj, void* pBuf, u32 maxJnt);
+int NNS_G3dLodObjAddLevel(NNSG3dLodObj* pObj, NNSG3dRenderObj* pRenderObj);
+u32 NNS_G3dLodObjSetMdlSet(NNSG3dLodObj* pObj,
+                           NNSG3dRenderObj* pRenderObj,
+                           const NNSG3dResMdlSet* pMdlSet);
+void NNS_G3dLodObjReset(NNSG3dLodObj* pObj);
+int NNS_G3dLodObjGetScrSize(const NNSG3dLodObj* pObj);
+
+void NNS_G3dLodMgrInit(NNSG3dLodMgr* pMgr);
+void NNS_G3dLodMgrSetLevelSize(NNSG3dLodMgr* pMgr, int level, int size);
+void NNS_G3dLodMgrSetAnmRateSize(NNSG3dLodMgr* pMgr, int idx, int size);
+void NNS_G3dLodMgrSetBudget(NNSG3dLodMgr* pMgr, u32 maxVtx, u32 maxJnt);
+void NNS_G3dLodMgrBeginFrame(NNSG3dLodMgr* pMgr);
+BOOL NNS_G3dLodMgrDraw(NNSG3dLodMgr* pMgr, NNSG3dLodObj* pObj);
+
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif
+
+#endif // NNSG3D_LOD_H_
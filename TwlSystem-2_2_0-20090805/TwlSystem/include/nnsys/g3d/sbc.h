@@ -261,6 +261,8 @@ NNS_G3D_INLINE fx32 NNS_G3dRSGetInvPosScale(const NNSG3dRS* rs);
 // Render
 //
 void NNS_G3dDraw(struct NNSG3dRenderObj_* pRenderObj);
+void NNSi_G3dRSSetup(NNSG3dRS* pRS, NNSG3dRenderObj* pRenderObj);
+void NNSi_G3dRenderObjUpdateHint(NNSG3dRenderObj* pRenderObj);
 
 //
 // SBC instructions
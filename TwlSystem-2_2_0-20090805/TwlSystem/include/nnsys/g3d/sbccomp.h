@@ -0,0 +1,116 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - include - nnsys - g3d
+  File:     sbccomp.h
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#ifndef NNSG3D_SBCCOMP_H_
+#define NNSG3D_SBCCOMP_H_
+
+#include <nnsys/g3d/config.h>
+#include <nnsys/g3d/kernel.h>
+#include <nnsys/g3d/anm.h>
+#include <nnsys/g3d/gecom.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------*
+    Summary of the compiled SBC:
+
+    NNS_G3dCompileSbc converts the SBC of a render object into a flat command list
+    specialized for the animations bound to the render object at that time.
+    The SBC commands whose geometry commands do not change from frame to frame
+    (for example, the joints and materials without animation) are executed once
+    and the geometry commands they send are stored in the command list.
+    Only the other SBC commands (animated joints and materials, billboards, envelopes, etc.)
+    are left to the SBC interpreter.
+    For a model without animation, the whole model becomes one display list
+    when NNS_G3D_SBCCOMP_FLAG_COPY_DL is specified.
+
+    NNS_G3dDrawCompiledSbc renders with the command list.
+    When the render object is no longer in the state it was compiled in
+    (callbacks, different animation bindings, NNS_G3D_RENDEROBJ_FLAG_XXX, global material settings, etc.),
+    it renders with NNS_G3dDraw instead.
+
+    The texture and palette bindings and the contents of the NNS_G3dFuncSbcXXXTable tables are not checked.
+    Compile again after changing them.
+ *---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*
+    NNSG3dSbcCompFlag
+
+    Options given to NNS_G3dCompileSbc.
+ *---------------------------------------------------------------------------*/
+typedef enum
+{
+    NNS_G3D_SBCCOMP_FLAG_COPY_DL = 0x00000001   // Copies the display lists of the shapes into the command list
+}
+NNSG3dSbcCompFlag;
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dCompiledSbc
+
+    The compiled SBC and the state of the render object it was compiled for.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dCompiledSbc_
+{
+    const u32*            pCode;        // Command list (NULL when the compile failed)
+    u32                   szCode;       // Size of the command list in bytes
+    const NNSG3dResMdl*   resMdl;
+    const u8*             sbc;          // Compiled SBC
+
+    // Animation bindings at the time of the compile
+    const NNSG3dAnmObj*   anmMat;       // Only used as a flag
+    const NNSG3dAnmObj*   anmJnt;       // Only used as a flag
+    NNSG3dFuncAnmBlendMat funcBlendMat;
+    NNSG3dFuncAnmBlendJnt funcBlendJnt;
+    NNSG3dMatAnmResult*   recMatAnm;    // Only used as a flag
+    NNSG3dJntAnmResult*   recJntAnm;    // Only used as a flag
+    u32                   hintMatAnmExist[NNS_G3D_SIZE_MAT_MAX / 32];
+    u32                   hintJntAnmExist[NNS_G3D_SIZE_JNT_MAX / 32];
+
+    // Global material settings at the time of the compile
+    u32                   prmMatColor0;
+    u32                   prmMatColor1;
+    u32                   prmPolygonAttr;
+
+    // statistics
+    u16                   numCmd;       // Number of SBC commands
+    u16                   numInterpCmd; // Number of SBC commands left to the interpreter
+}
+NNSG3dCompiledSbc;
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Function Declarations
+//
+
+u32 NNS_G3dCompileSbc(NNSG3dCompiledSbc* pComp,
+                      void* pBuf,
+                      u32 szBuf,
+                      NNSG3dRenderObj* pRenderObj,
+                      u32 flag);
+BOOL NNS_G3dCompiledSbcIsValid(const NNSG3dCompiledSbc* pComp,
+                               NNSG3dRenderObj* pRenderObj);
+BOOL NNS_G3dDrawCompiledSbc(NNSG3dRenderObj* pRenderObj,
+                            const NNSG3dCompiledSbc* pComp);
+
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif
+
+#endif
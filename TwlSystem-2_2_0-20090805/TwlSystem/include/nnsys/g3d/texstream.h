@@ -0,0 +1,140 @@
+/*---------------------------------------------------------------------------*
+  Project:  TWL-System - include - nnsys - g3d
+  File:     texstream.h
+
+  Copyright 2004-2009 Nintendo.  All rights reserved.
+
+  These coded instructions, statements, and computer programs contain
+  proprietary information of Nintendo of America Inc. and/or Nintendo
+  Company Ltd., and are protected by Federal copyright law.  They may
+  not be disclosed to third parties or copied or duplicated in any form,
+  in whole or in part, without the prior written consent of Nintendo.
+
+  $Revision: 1155 $
+ *---------------------------------------------------------------------------*/
+
+#ifndef NNSG3D_TEXSTREAM_H_
+#define NNSG3D_TEXSTREAM_H_
+
+#include <nnsys/g3d/config.h>
+#include <nnsys/g3d/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------*
+    Summary of the texture streaming:
+
+    NNSG3dTexStream keeps in VRAM only the texture blocks (NNSG3dResTex) used recently.
+    Each entry is a texture block and the models that use its textures and palettes.
+
+    NNS_G3dTexStreamUse marks an entry as used in the current frame.
+    It returns TRUE when the textures are in VRAM and bound to the models.
+    NNS_G3dTexStreamUpdate, called once per frame after drawing:
+    - binds the entries whose data has been transferred (NNS_GfdIsVramTransferFenceDone),
+    - allocates VRAM for the entries used but not in VRAM, with the default VRAM managers of GFD
+      (NNS_GfdAllocTexVram and NNS_GfdAllocPlttVram). When VRAM is full, the entries
+      least recently used are released, except the entries used in this frame and the last one.
+    - registers the data in the VRAM transfer manager of GFD (NNS_GfdRegisterNewVramTransferTask),
+      at most 'budget' bytes per frame. A large texture block is transferred in several frames.
+
+    NNS_GfdDoVramTransfer must be called at every VBlank. When it has a budget
+    (NNS_GfdSetVramTransferBudget), the data may be transferred over several VBlanks.
+    The VRAM managers must be able to free regions (the linked list managers, for example).
+    The texture data must stay in main memory (written back from the cache with DC_StoreRange)
+    and the keys of the texture blocks must not be set by the application.
+ *---------------------------------------------------------------------------*/
+
+// Maximum number of models per entry
+#define NNS_G3D_TEXSTREAM_MAX_MDL 4
+
+/*---------------------------------------------------------------------------*
+    NNSG3dTexStreamState
+
+    State of an entry.
+ *---------------------------------------------------------------------------*/
+typedef enum
+{
+    NNS_G3D_TEXSTREAM_STATE_NONE     = 0,   // Not in VRAM
+    NNS_G3D_TEXSTREAM_STATE_LOADING  = 1,   // VRAM allocated, data being registered for the transfer
+    NNS_G3D_TEXSTREAM_STATE_TRANSFER = 2,   // All the data registered, waiting for the transfer
+    NNS_G3D_TEXSTREAM_STATE_RESIDENT = 3    // In VRAM and bound to the models
+}
+NNSG3dTexStreamState;
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dTexStreamEntry
+
+    A texture block and the models that use it.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dTexStreamEntry_
+{
+    NNSG3dResTex*   pTex;
+    NNSG3dResMdl*   pMdl[NNS_G3D_TEXSTREAM_MAX_MDL];
+    u32             numMdl;
+
+    u32             state;          // NNSG3dTexStreamState
+    u32             frameUsed;      // Frame when last used
+    u32             fence;          // Fence of the transfer of the last data registered
+    u32             size;           // Bytes in VRAM
+
+    // progress of the transfer
+    u16             idxSeg;         // Data being transferred (texture, 4x4 texture, palette index, palette)
+    u16             pad16_;
+    u32             ofsSeg;         // Bytes of the data already registered
+}
+NNSG3dTexStreamEntry;
+
+
+/*---------------------------------------------------------------------------*
+    NNSG3dTexStream
+
+    The entries and the state of the streaming.
+    The statistics are counted from NNS_G3dTexStreamInit or NNS_G3dTexStreamResetStats.
+ *---------------------------------------------------------------------------*/
+typedef struct NNSG3dTexStream_
+{
+    NNSG3dTexStreamEntry*   pEntry;
+    u32                     numEntry;
+    u32                     maxEntry;
+    u32                     frame;
+    u32                     budget;     // Bytes registered for the transfer per frame
+
+    u32                     szResident; // Bytes of VRAM used by the entries
+    u32                     szSent;     // Bytes registered in the last NNS_G3dTexStreamUpdate
+
+    // statistics
+    u32                     numUse;     // Calls of NNS_G3dTexStreamUse
+    u32                     numMiss;    // Calls of NNS_G3dTexStreamUse for entries not bound
+    u32                     numLoad;    // Entries loaded
+    u32                     numEvict;   // Entries released to make room
+    u32                     numFull;    // Allocations that failed with nothing to release
+}
+NNSG3dTexStream;
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Function Declarations
+//
+
+void NNS_G3dTexStreamInit(NNSG3dTexStream* pStream,
+                          NNSG3dTexStreamEntry* pEntry,
+                          u32 maxEntry,
+                          u32 budget);
+int NNS_G3dTexStreamAddTex(NNSG3dTexStream* pStream, NNSG3dResTex* pTex);
+BOOL NNS_G3dTexStreamAddMdl(NNSG3dTexStream* pStream, int idx, NNSG3dResMdl* pMdl);
+BOOL NNS_G3dTexStreamUse(NNSG3dTexStream* pStream, int idx);
+void NNS_G3dTexStreamUpdate(NNSG3dTexStream* pStream);
+void NNS_G3dTexStreamRelease(NNSG3dTexStream* pStream, int idx);
+void NNS_G3dTexStreamReleaseAll(NNSG3dTexStream* pStream);
+void NNS_G3dTexStreamResetStats(NNSG3dTexStream* pStream);
+
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif
+
+#endif // NNSG3D_TEXSTREAM_H_
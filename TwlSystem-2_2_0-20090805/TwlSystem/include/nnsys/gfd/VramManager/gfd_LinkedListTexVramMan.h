@@ -25,6 +25,20 @@ extern "C" {
 #include <nnsys/gfd/VramManager/gfd_LinkedListVramMan.h>
 
 
+//------------------------------------------------------------------------------
+// Declarations
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Texture that NNS_GfdDefragLnkTexVram can move
+typedef struct NNSGfdLnkTexDefragEntry
+{
+    NNSGfdTexKey*       pKey;   // Texture key (updated when the texture is moved)
+    void*               pSrc;   // Texture image in main memory (transferred to the new region)
+    
+}NNSGfdLnkTexDefragEntry;
+
+
 //------------------------------------------------------------------------------
 // Function Declarations
 //------------------------------------------------------------------------------
@@ -49,6 +63,8 @@ NNSGfdTexKey    NNS_GfdAllocLnkTexVram( u32 szByte, BOOL is4x4comp, u32 opt );
 int             NNS_GfdFreeLnkTexVram( NNSGfdTexKey memKey );
 void            NNS_GfdResetLnkTexVramState( void );
 
+u32             NNS_GfdDefragLnkTexVram( NNSGfdLnkTexDefragEntry* pEntry, u32 numEntry );
+
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -86,6 +86,7 @@ typedef struct NNSGfdVramTransferTask
     void*                   pSrc;       // The data address of the transmission source in main memory
     u32                     dstAddr;    // transmission destination address
     u32                     szByte;     // size of the transmission
+    u32                     fence;      // The fence passed when the task is transmitted
     
 }NNSGfdVramTransferTask;
 
@@ -107,6 +108,25 @@ typedef struct NNSGfdVramTransferTaskQueue
     
 }NNSGfdVramTransferTaskQueue;
 
+/*---------------------------------------------------------------------------*
+  Name:         NNSGfdVramTransferStats
+
+  Description:  The transmission statistics
+                (the first members are about the last NNS_GfdDoVramTransfer)
+ *---------------------------------------------------------------------------*/
+typedef struct NNSGfdVramTransferStats
+{
+    u32                         szByte;         // The amount transmitted
+    u32                         numTasks;       // The number of tasks (or parts of tasks) transmitted
+    u32                         szDeferred;     // The amount left for the next transmission
+    OSTick                      tick;           // The time taken (0 when there is no time budget)
+    
+    u32                         numOverrun;     // The number of transmissions that reached the budget
+    u32                         numMerged;      // The number of tasks merged into the previous task
+    u32                         numDropped;     // The number of tasks overwritten by a later task (and removed)
+    
+}NNSGfdVramTransferStats;
+
 /*---------------------------------------------------------------------------*
   Name:         NNSGfdVramTransferManager
 
@@ -115,6 +135,14 @@ typedef struct NNSGfdVramTransferTaskQueue
 typedef struct NNSGfdVramTransferManager
 {
     NNSGfdVramTransferTaskQueue         taskQueue; // The transmission task queue        
+    
+    u32                                 szByteBudget;   // The amount transmitted per call (0: no limit)
+    OSTick                              tickBudget;     // The time of the transmission per call (0: no limit)
+    NNSGfdVramTransferStats             stats;          // The transmission statistics
+    
+    u32                                 fenceRegistered; // The fence of the last registered task
+    volatile u32                        fenceDone;       // The fence up to which the tasks are transmitted
+    u32                                 numFlush;        // The number of tasks transmitted regardless of the budget
 
 }NNSGfdVramTransferManager;
 
@@ -192,10 +220,43 @@ NNS_GfdRegisterNewVramTransferTask
     u32                         szByte
 );
 //
+// Wait for the transmission of the registered tasks
+//
+u32 
+NNS_GfdGetVramTransferFence( void );
+BOOL 
+NNS_GfdIsVramTransferFenceDone( u32 fence );
+//
+// Transmit the registered tasks regardless of the budget
+//
+void 
+NNS_GfdRequestVramTransferFlush( void );
+//
+// Get the number of tasks that can be registered
+//
+u32 
+NNS_GfdGetNumFreeVramTransferTasks( void );
+//
 // Get the total amount of transmission
 //
 u32 
 NNS_GfdGetVramTransferTaskTotalSize( void );
+//
+// Set the budget of each transmission
+//
+void 
+NNS_GfdSetVramTransferBudget
+(
+    u32                         szByte,
+    OSTick                      tick
+);
+//
+// Get the transmission statistics
+//
+void 
+NNS_GfdGetVramTransferStats( NNSGfdVramTransferStats* pStats );
+void 
+NNS_GfdResetVramTransferStats( void );
 
 
 #ifdef __cplusplus